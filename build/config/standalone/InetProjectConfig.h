@@ -0,0 +1,40 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Weave::Inet project configuration for standalone builds on Linux and OS X.
+ *
+ */
+#ifndef INETPROJECTCONFIG_H
+#define INETPROJECTCONFIG_H
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+// Write the TCP send queue with one sendmsg() call per pass.
+#define INET_CONFIG_ENABLE_TCP_GATHERED_SEND 1
+
+#if defined(__linux__)
+// Move UDP datagrams in batches with recvmmsg() and sendmmsg().
+#define INET_CONFIG_ENABLE_UDP_BATCHED_IO 1
+
+// Send TCP writes of 4 KiB or more, such as bulk data transfer blocks, with MSG_ZEROCOPY.
+#define INET_CONFIG_TCP_ZEROCOPY_THRESHOLD 4096
+#endif
+#endif
+
+#endif /* INETPROJECTCONFIG_H */
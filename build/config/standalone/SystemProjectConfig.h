@@ -24,9 +24,20 @@
 #ifndef SYSTEMPROJECTCONFIG_H
 #define SYSTEMPROJECTCONFIG_H
 
+// Keep armed timers in a hashed timing wheel.
+#define WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL 1
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 // Uncomment this for larger buffers (e.g. to support a bigger WEAVE_CONFIG_TUNNEL_INTERFACE_MTU).
 //#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX 9050
+
+// Grow the timer and endpoint pools on demand.
+#define WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS 1
+
+#if defined(__linux__)
+// Wait for I/O with epoll rather than select.
+#define WEAVE_SYSTEM_CONFIG_USE_EPOLL 1
+#endif
 #endif
 
 #endif /* SYSTEMPROJECTCONFIG_H */
@@ -31,6 +31,14 @@
 
 #define WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS 2
 
+// Let threads stage events for logging outside the logging critical
+// section, so that event staging is exercised by the standalone tests.
+#define WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS 2
+
+// Back the event buffers with files, so that persistence and restoring
+// the log are exercised by the standalone tests.
+#define WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS 1
+
 
 #define WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE 300
 
@@ -57,4 +65,20 @@
 
 #define WEAVE_CONFIG_ENABLE_WDM_UPDATE 1
 
+// Cache the data elements encoded in a notification round, so that the
+// data element cache is exercised by the standalone tests.
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE 1024
+
+// Handle view requests, so that the publisher side of WDM views is
+// compiled and exercised by the standalone tests.
+#define WDM_PUBLISHER_ENABLE_VIEW 1
+
+// Run CASE and PASE public-key operations on crypto worker threads, so that
+// asynchronous session establishment is exercised by the standalone tests.
+#define WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS 2
+
+// Keep the expanded AES and HMAC key state with each message encryption
+// key, so that the cached key schedules are exercised by the standalone tests.
+#define WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES 1
+
 #endif /* WEAVEPROJECTCONFIG_H */
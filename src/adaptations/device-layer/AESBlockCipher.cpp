@@ -62,6 +62,19 @@ void AES128BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     esp_aes_free(&ctx);
 }
 
+void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    esp_aes_context ctx;
+
+    esp_aes_init(&ctx);
+    esp_aes_setkey(&ctx, mKey, kKeyLengthBits);
+    for (; numBlocks > 0; numBlocks--, inBlocks += kBlockLength, outBlocks += kBlockLength)
+    {
+        esp_aes_encrypt(&ctx, inBlocks, outBlocks);
+    }
+    esp_aes_free(&ctx);
+}
+
 void AES128BlockCipherDec::SetKey(const uint8_t *key)
 {
     memcpy(mKey, key, kKeyLength);
@@ -107,6 +120,19 @@ void AES256BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     esp_aes_free(&ctx);
 }
 
+void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    esp_aes_context ctx;
+
+    esp_aes_init(&ctx);
+    esp_aes_setkey(&ctx, mKey, kKeyLengthBits);
+    for (; numBlocks > 0; numBlocks--, inBlocks += kBlockLength, outBlocks += kBlockLength)
+    {
+        esp_aes_encrypt(&ctx, inBlocks, outBlocks);
+    }
+    esp_aes_free(&ctx);
+}
+
 void AES256BlockCipherDec::SetKey(const uint8_t *key)
 {
     memcpy(mKey, key, kKeyLength);
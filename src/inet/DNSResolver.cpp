@@ -49,7 +49,7 @@
 namespace nl {
 namespace Inet {
 
-Weave::System::ObjectPool<DNSResolver, INET_CONFIG_NUM_DNS_RESOLVERS> DNSResolver::sPool;
+Weave::System::LayerObjectPool<DNSResolver, INET_CONFIG_NUM_DNS_RESOLVERS> DNSResolver::sPool;
 
 /**
  *  This method revolves a host name into a list of IP addresses.
@@ -27,6 +27,14 @@
 
 #include <InetLayer/InetLayer.h>
 
+#include <Weave/Support/CodeUtils.h>
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 namespace nl {
 namespace Inet {
 
@@ -38,7 +46,158 @@ void EndPointBasis::InitEndPointBasis(InetLayer& aInetLayer, void* aAppState)
     mSocket = INET_INVALID_SOCKET_FD;
     mPendingIO.Clear();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_Unknown;
+    mReadyIO.Clear();
+    mEPollWatch.OnReady = HandleEPollReady;
+    mEPollWatch.AppState = this;
+    mNextReady = NULL;
+    mPrevReadyLink = NULL;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  Register a newly created socket with the event loop of the system layer.
+ *
+ *  With \c WEAVE_SYSTEM_CONFIG_USE_EPOLL, the socket is switched to non-blocking mode and added, edge-triggered, to the epoll
+ *  instance of the system layer. TCP sockets are watched for both read and write readiness; all other sockets only for read
+ *  readiness. Otherwise, this method does nothing, since select() is handed every socket on each pass through the event loop.
+ *
+ *  @return INET_NO_ERROR on success, else a corresponding INET mapped OS error.
+ */
+INET_ERROR EndPointBasis::WatchSocket(void)
+{
+    INET_ERROR lReturn = INET_NO_ERROR;
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    uint32_t lEvents = EPOLLIN;
+    int lFlags;
+
+    lFlags = fcntl(mSocket, F_GETFL, 0);
+    VerifyOrExit(lFlags != -1 && fcntl(mSocket, F_SETFL, lFlags | O_NONBLOCK) == 0,
+                 lReturn = Weave::System::MapErrorPOSIX(errno));
+
+    if (mSocketsEndPointType == kSocketsEndPointType_TCP)
+        lEvents |= EPOLLOUT | EPOLLRDHUP;
+
+    mReadyIO.Clear();
+    lReturn = SystemLayer().AddEPollWatch(mSocket, lEvents, mEPollWatch);
+
+exit:
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+    return lReturn;
+}
+
+/**
+ *  Remove the socket from the event loop of the system layer. This must be called before the socket is closed.
+ */
+void EndPointBasis::UnwatchSocket(void)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (mSocket != INET_INVALID_SOCKET_FD)
+        SystemLayer().RemoveEPollWatch(mSocket);
+
+    UnlinkReady();
+    mReadyIO.Clear();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+}
+
+/**
+ *  Notify the event loop that the set of I/O events the endpoint is interested in may have grown, e.g. because the application
+ *  enabled receiving or queued data for sending.
+ *
+ *  With \c WEAVE_SYSTEM_CONFIG_USE_EPOLL, readiness that was reported while the endpoint was not interested in it is not reported
+ *  again, so an endpoint holding such readiness is put back on the ready list of the Inet layer and the thread waiting for I/O is
+ *  woken. Otherwise, the thread calling select is woken so that it recomputes its file descriptor sets.
+ */
+void EndPointBasis::RefreshIO(void)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (!mReadyIO.IsSet() || mPrevReadyLink != NULL)
+        return;
+
+    LinkReady();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+    SystemLayer().WakeSelect();
+}
+
+/**
+ *  Notify the event loop that the state of the socket has changed such that any readiness reported for it beforehand no longer
+ *  applies, e.g. because a connection is being initiated or the socket has started listening.
+ *
+ *  With \c WEAVE_SYSTEM_CONFIG_USE_EPOLL, the readiness held by the endpoint is discarded; the kernel reports the readiness of the
+ *  socket in its new state. Otherwise, the thread calling select is woken so that it recomputes its file descriptor sets.
+ */
+void EndPointBasis::ResetIO(void)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UnlinkReady();
+    mReadyIO.Clear();
+#else // !WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    SystemLayer().WakeSelect();
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EPOLL
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+void EndPointBasis::LinkReady(void)
+{
+    if (mPrevReadyLink == NULL)
+    {
+        InetLayer& lInetLayer = Layer();
+
+        mNextReady = lInetLayer.mReadyEndPoints;
+        if (mNextReady != NULL)
+            mNextReady->mPrevReadyLink = &mNextReady;
+        mPrevReadyLink = &lInetLayer.mReadyEndPoints;
+        lInetLayer.mReadyEndPoints = this;
+    }
+}
+
+void EndPointBasis::UnlinkReady(void)
+{
+    if (mPrevReadyLink != NULL)
+    {
+        *mPrevReadyLink = mNextReady;
+        if (mNextReady != NULL)
+            mNextReady->mPrevReadyLink = mPrevReadyLink;
+        mNextReady = NULL;
+        mPrevReadyLink = NULL;
+    }
+}
+
+void EndPointBasis::HandleEPollReady(Weave::System::EPollWatch& aWatch, uint32_t aEvents)
+{
+    EndPointBasis* lEndPoint = static_cast<EndPointBasis*>(aWatch.AppState);
+
+    // Ignore readiness reported for a socket that has since been closed.
+    if (lEndPoint->mSocket == INET_INVALID_SOCKET_FD)
+        return;
+
+    if (aEvents & EPOLLIN)
+        lEndPoint->mReadyIO.SetRead();
+
+    if (aEvents & EPOLLOUT)
+        lEndPoint->mReadyIO.SetWrite();
+
+    // Errors and hang-ups are discovered by the endpoint when it next reads or writes the socket.
+    if (aEvents & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+    {
+        lEndPoint->mReadyIO.SetRead();
+        lEndPoint->mReadyIO.SetWrite();
+    }
+
+    lEndPoint->LinkReady();
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 } // namespace Inet
 } // namespace nl
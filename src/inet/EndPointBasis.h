@@ -34,6 +34,10 @@
 
 #include <Weave/Support/NLDLLUtil.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <SystemLayer/SystemLayer.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 //--- Declaration of LWIP protocol control buffer structure names
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
@@ -84,8 +88,38 @@ protected:
     int mSocket;                    /**< Encapsulated socket descriptor. */
     IPAddressType mAddrType;        /**< Protocol family, i.e. IPv4 or IPv6. */
     SocketEvents mPendingIO;        /**< Socket event masks */
+
+    INET_ERROR WatchSocket(void);
+    void UnwatchSocket(void);
+    void RefreshIO(void);
+    void ResetIO(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    /** Concrete endpoint class, used to dispatch epoll readiness without scanning the endpoint pools */
+    enum
+    {
+        kSocketsEndPointType_Unknown    = 0,
+        kSocketsEndPointType_Raw        = 1,
+        kSocketsEndPointType_UDP        = 2,
+        kSocketsEndPointType_TCP        = 3,
+        kSocketsEndPointType_Tun        = 4
+    };
+
+    uint8_t mSocketsEndPointType;               /**< One of the kSocketsEndPointType_* values. */
+    SocketEvents mReadyIO;                      /**< Edge-triggered readiness not yet consumed by the endpoint. */
+    Weave::System::EPollWatch mEPollWatch;      /**< Registration of the socket with the system layer epoll instance. */
+    EndPointBasis* mNextReady;                  /**< Next endpoint in the InetLayer ready list. */
+    EndPointBasis** mPrevReadyLink;             /**< Link pointing at this endpoint in the ready list, or NULL if not listed. */
+
+    void LinkReady(void);
+    void UnlinkReady(void);
+
+    static void HandleEPollReady(Weave::System::EPollWatch& aWatch, uint32_t aEvents);
+
+    friend class InetLayer;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     /** Encapsulated LwIP protocol control block */
     union
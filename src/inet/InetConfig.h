@@ -686,6 +686,215 @@
 #ifndef INET_CONFIG_IP_MULTICAST_HOP_LIMIT
 #define INET_CONFIG_IP_MULTICAST_HOP_LIMIT                 (64)
 #endif // INET_CONFIG_IP_MULTICAST_HOP_LIMIT
+
+/**
+ *  @def INET_CONFIG_ENABLE_UDP_BATCHED_IO
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) UDP endpoints on sockets move
+ *    datagrams in batches with recvmmsg() and sendmmsg().
+ *
+ *  @details
+ *    When enabled, each read readiness event on a listening UDP
+ *    endpoint drains up to #INET_CONFIG_UDP_RECV_BATCH_SIZE
+ *    datagrams with a single recvmmsg() call into packet buffers
+ *    kept allocated by the endpoint, and hands them to the
+ *    application one after another. UDPEndPoint::SendTo() queues
+ *    datagrams instead of sending them, waking the event loop for
+ *    the first one, and the queue of each endpoint is flushed with
+ *    sendmmsg() when it is full, when the endpoint is closed and at
+ *    the end of each pass through the event loop, i.e. in
+ *    InetLayer::PrepareSelect() or InetLayer::PrepareEPoll().
+ *    Datagrams the socket would not take stay queued until it is
+ *    writable, and SendTo() fails with the error of \c EAGAIN while
+ *    the queue is full. A datagram the system refuses otherwise is
+ *    logged and dropped, and the error is reported to the
+ *    OnReceiveError handler of the endpoint, without packet
+ *    information, once the queue has been flushed. Only endpoints
+ *    with queued datagrams are visited at the end of a pass.
+ *
+ *    Receive buffers are held across events only as far as recent
+ *    traffic fills them, but a busy endpoint may hold up to
+ *    #INET_CONFIG_UDP_RECV_BATCH_SIZE plus
+ *    #INET_CONFIG_UDP_SEND_BATCH_SIZE packet buffers at once, so
+ *    the default batch sizes shrink to fit a small fixed
+ *    #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC pool.
+ *
+ *    This requires the recvmmsg() and sendmmsg() system calls,
+ *    which Linux provides.
+ */
+#ifndef INET_CONFIG_ENABLE_UDP_BATCHED_IO
+#define INET_CONFIG_ENABLE_UDP_BATCHED_IO                  0
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+/**
+ *  @def INET_CONFIG_UDP_RECV_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of datagrams received by a UDP endpoint
+ *    with one recvmmsg() call when #INET_CONFIG_ENABLE_UDP_BATCHED_IO
+ *    is enabled.
+ *
+ *    This defaults to 16, or, with a fixed pool of fewer than 64
+ *    packet buffers, to a quarter of the pool, so that the receive
+ *    and send batches of an endpoint take at most half of it.
+ */
+#ifndef INET_CONFIG_UDP_RECV_BATCH_SIZE
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC >= 64
+#define INET_CONFIG_UDP_RECV_BATCH_SIZE                    16
+#else
+#define INET_CONFIG_UDP_RECV_BATCH_SIZE                    ((WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC + 3) / 4)
+#endif
+#endif // INET_CONFIG_UDP_RECV_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_UDP_SEND_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of datagrams queued by a UDP endpoint for
+ *    one sendmmsg() call when #INET_CONFIG_ENABLE_UDP_BATCHED_IO
+ *    is enabled.
+ *
+ *    This defaults to the same as #INET_CONFIG_UDP_RECV_BATCH_SIZE.
+ */
+#ifndef INET_CONFIG_UDP_SEND_BATCH_SIZE
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0 || WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC >= 64
+#define INET_CONFIG_UDP_SEND_BATCH_SIZE                    16
+#else
+#define INET_CONFIG_UDP_SEND_BATCH_SIZE                    ((WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC + 3) / 4)
+#endif
+#endif // INET_CONFIG_UDP_SEND_BATCH_SIZE
+
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "REQUIRED: if INET_CONFIG_ENABLE_UDP_BATCHED_IO then WEAVE_SYSTEM_CONFIG_USE_SOCKETS!"
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if INET_CONFIG_UDP_RECV_BATCH_SIZE <= 0 || INET_CONFIG_UDP_SEND_BATCH_SIZE <= 0
+#error "FORBIDDEN: INET_CONFIG_UDP_RECV_BATCH_SIZE <= 0 || INET_CONFIG_UDP_SEND_BATCH_SIZE <= 0"
+#endif // INET_CONFIG_UDP_RECV_BATCH_SIZE <= 0 || INET_CONFIG_UDP_SEND_BATCH_SIZE <= 0
+
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0 && \
+    WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC <= INET_CONFIG_UDP_RECV_BATCH_SIZE + INET_CONFIG_UDP_SEND_BATCH_SIZE
+#error "FORBIDDEN: INET_CONFIG_ENABLE_UDP_BATCHED_IO && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC <= INET_CONFIG_UDP_RECV_BATCH_SIZE + INET_CONFIG_UDP_SEND_BATCH_SIZE"
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC <= ...
+
+/**
+ *  @def INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+ *
+ *  @brief
+ *    Defines whether (1) or not (0) TCP endpoints on sockets write
+ *    their send queue with one sendmsg() call per send pass.
+ *
+ *  @details
+ *    When enabled, TCPEndPoint gathers up to
+ *    #INET_CONFIG_TCP_SEND_IOV_MAX buffers from the head of its
+ *    send queue, and no more than 65535 octets, into an iovec
+ *    array and hands them to the kernel in one sendmsg() call,
+ *    rather than calling send() once for each buffer. The number
+ *    of calls and octets written are counted per endpoint and can
+ *    be read with TCPEndPoint::GetSendStats().
+ */
+#ifndef INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+#define INET_CONFIG_ENABLE_TCP_GATHERED_SEND               0
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_IOV_MAX
+ *
+ *  @brief
+ *    The maximum number of send queue buffers written by one
+ *    sendmsg() call when #INET_CONFIG_ENABLE_TCP_GATHERED_SEND is
+ *    enabled.
+ */
+#ifndef INET_CONFIG_TCP_SEND_IOV_MAX
+#define INET_CONFIG_TCP_SEND_IOV_MAX                       16
+#endif // INET_CONFIG_TCP_SEND_IOV_MAX
+
+/**
+ *  @def INET_CONFIG_TCP_ZEROCOPY_THRESHOLD
+ *
+ *  @brief
+ *    The smallest number of octets gathered for one sendmsg() call
+ *    that is sent with MSG_ZEROCOPY, or 0 to never use MSG_ZEROCOPY.
+ *
+ *  @details
+ *    Requires #INET_CONFIG_ENABLE_TCP_GATHERED_SEND and the Linux
+ *    SO_ZEROCOPY socket option. Buffers written this way are kept,
+ *    up to #INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING of them per
+ *    endpoint, until the kernel reports that it has finished with
+ *    them. Sends that would exceed that limit, and sends on sockets
+ *    that refuse SO_ZEROCOPY, are copied as usual. Zero-copy only
+ *    pays off for large writes, such as bulk data transfer blocks.
+ */
+#ifndef INET_CONFIG_TCP_ZEROCOPY_THRESHOLD
+#define INET_CONFIG_TCP_ZEROCOPY_THRESHOLD                 0
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD
+
+/**
+ *  @def INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING
+ *
+ *  @brief
+ *    The maximum number of buffers a TCP endpoint keeps awaiting
+ *    zero-copy completion when #INET_CONFIG_TCP_ZEROCOPY_THRESHOLD
+ *    is non-zero.
+ */
+#ifndef INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING
+#define INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING               32
+#endif // INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING
+
+/**
+ *  @def INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL
+ *
+ *  @brief
+ *    The interval, in milliseconds, at which a TCP endpoint that is
+ *    being closed gracefully polls for the zero-copy completions it
+ *    is still waiting for.
+ *
+ *  @details
+ *    The kernel may go on reading buffers written with MSG_ZEROCOPY
+ *    until the peer has acknowledged them, and reports being done
+ *    with them on the error queue of the socket, which is lost once
+ *    the socket is closed. An endpoint closed without error with
+ *    such buffers outstanding therefore stays in the Closing state,
+ *    with its socket open, until they have all been reported.
+ */
+#ifndef INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL
+#define INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL       10
+#endif // INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL
+
+/**
+ *  @def INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT
+ *
+ *  @brief
+ *    The time, in milliseconds, a TCP endpoint that is being closed
+ *    gracefully and has no more data to send waits for its
+ *    outstanding zero-copy completions before it aborts the
+ *    connection.
+ *
+ *  @details
+ *    The connection is aborted with a zero SO_LINGER time, which
+ *    discards the data the kernel still holds, before the buffers
+ *    are released.
+ */
+#ifndef INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT
+#define INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT             10000
+#endif // INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT
+
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "REQUIRED: if INET_CONFIG_ENABLE_TCP_GATHERED_SEND then WEAVE_SYSTEM_CONFIG_USE_SOCKETS!"
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if INET_CONFIG_TCP_SEND_IOV_MAX <= 0
+#error "FORBIDDEN: INET_CONFIG_TCP_SEND_IOV_MAX <= 0"
+#endif // INET_CONFIG_TCP_SEND_IOV_MAX <= 0
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0 && !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+#error "REQUIRED: if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0 then INET_CONFIG_ENABLE_TCP_GATHERED_SEND!"
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0 && !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+
+#if INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING < INET_CONFIG_TCP_SEND_IOV_MAX || INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING > 255
+#error "FORBIDDEN: INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING < INET_CONFIG_TCP_SEND_IOV_MAX || INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING > 255"
+#endif // INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING < INET_CONFIG_TCP_SEND_IOV_MAX || INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING > 255
 // clang-format on
 
 #endif /* INETCONFIG_H */
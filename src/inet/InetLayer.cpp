@@ -129,6 +129,14 @@ InetLayer::InetLayer(void)
 {
     State = kState_NotInitialized;
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    mPendingSendEndPoints = NULL;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mReadyEndPoints = NULL;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     if (!sInetEventHandlerDelegate.IsInitialized())
         sInetEventHandlerDelegate.Init(HandleInetLayerEvent);
@@ -294,6 +302,14 @@ INET_ERROR InetLayer::Init(Weave::System::Layer& aSystemLayer, void *aContext)
     mSystemLayer = &aSystemLayer;
     mContext = aContext;
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    mPendingSendEndPoints = NULL;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mReadyEndPoints = NULL;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     err = InitQueueLimiter();
     SuccessOrExit(err);
@@ -343,10 +359,10 @@ INET_ERROR InetLayer::Shutdown(void)
     {
 #if INET_CONFIG_ENABLE_DNS_RESOLVER
         // Cancel all DNS resolution requests owned by this instance.
-        for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+        for (DNSResolver* lResolver = DNSResolver::sPool.GetFirst(*mSystemLayer); lResolver != NULL;
+             lResolver = DNSResolver::sPool.GetNext(*mSystemLayer, lResolver))
         {
-            DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
-            if ((lResolver != NULL) && lResolver->IsCreatedByInetLayer(*this))
+            if (lResolver->IsCreatedByInetLayer(*this))
             {
                 lResolver->Cancel();
             }
@@ -361,10 +377,10 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
         // Close all raw endpoints owned by this Inet layer instance.
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (RawEndPoint* lEndPoint = RawEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = RawEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->Close();
             }
@@ -373,10 +389,10 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
         // Abort all TCP endpoints owned by this instance.
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = TCPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->Abort();
             }
@@ -385,10 +401,10 @@ INET_ERROR InetLayer::Shutdown(void)
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
         // Close all UDP endpoints owned by this instance.
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (UDPEndPoint* lEndPoint = UDPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = UDPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->Close();
             }
@@ -444,11 +460,10 @@ bool InetLayer::IsIdleTimerRunning(void)
     bool timerRunning = false;
 
     // see if there are any TCP connections with the idle timer check in use.
-    for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+    for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+         lEndPoint = TCPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
     {
-        TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
-
-        if ((lEndPoint != NULL) && (lEndPoint->mIdleTimeout != 0))
+        if (lEndPoint->mIdleTimeout != 0)
         {
             timerRunning = true;
             break;
@@ -888,15 +903,9 @@ void InetLayer::CancelResolveHostAddress(DNSResolver::OnResolveCompleteFunct onC
     if (State != kState_Initialized)
         return;
 
-    for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+    for (DNSResolver* lResolver = DNSResolver::sPool.GetFirst(*mSystemLayer); lResolver != NULL;
+         lResolver = DNSResolver::sPool.GetNext(*mSystemLayer, lResolver))
     {
-        DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
-
-        if (lResolver == NULL)
-        {
-            continue;
-        }
-
         if (!lResolver->IsCreatedByInetLayer(*this))
         {
             continue;
@@ -1092,11 +1101,9 @@ void InetLayer::HandleTCPInactivityTimer(Weave::System::Layer* aSystemLayer, voi
     InetLayer& lInetLayer = *reinterpret_cast<InetLayer*>(aAppState);
     bool lTimerRequired = lInetLayer.IsIdleTimerRunning();
 
-    for (size_t i = 0; i < INET_CONFIG_NUM_TCP_ENDPOINTS; i++)
+    for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*aSystemLayer); lEndPoint != NULL;
+         lEndPoint = TCPEndPoint::sPool.GetNext(*aSystemLayer, lEndPoint))
     {
-        TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*aSystemLayer, i);
-
-        if (lEndPoint == NULL) continue;
         if (!lEndPoint->IsCreatedByInetLayer(lInetLayer)) continue;
         if (!lEndPoint->IsConnected()) continue;
         if (lEndPoint->mIdleTimeout == 0) continue;
@@ -1335,8 +1342,37 @@ INET_ERROR InetLayer::HandlePlatformTimer(void)
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+/**
+ *  Send the datagrams queued by UDP endpoints during this pass through the event loop, visiting only the endpoints that queued
+ *  any, and report the errors of those the system refused.
+ *
+ *  The list is taken first, so that endpoints queueing datagrams from the error handlers are flushed on the next pass, and
+ *  endpoints closed by the handlers unlink themselves from the taken list.
+ */
+void InetLayer::FlushPendingSends(void)
+{
+    UDPEndPoint* lEndPoints = mPendingSendEndPoints;
+
+    mPendingSendEndPoints = NULL;
+    if (lEndPoints != NULL)
+        lEndPoints->mPrevPendingSendLink = &lEndPoints;
+
+    while (lEndPoints != NULL)
+    {
+        UDPEndPoint* lEndPoint = lEndPoints;
+
+        lEndPoint->UnlinkPendingSend();
+        lEndPoint->FlushSendQueue();
+        lEndPoint->ReportSendError();
+    }
+}
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
 /**
  *  Prepare the sets of file descriptors for @p select() to work with.
+ *  With INET_CONFIG_ENABLE_UDP_BATCHED_IO, the datagrams queued by UDP
+ *  endpoints during this pass are sent first.
  *
  *  @param[out]    nfds       The range of file descriptors in the file
  *                            descriptor set.
@@ -1356,38 +1392,42 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
     if (State != kState_Initialized)
         return;
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    FlushPendingSends();
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-    for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+    for (RawEndPoint* lEndPoint = RawEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+         lEndPoint = RawEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
     {
-        RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
-        if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+        if (lEndPoint->IsCreatedByInetLayer(*this))
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-    for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+    for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+         lEndPoint = TCPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
     {
-        TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
-        if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+        if (lEndPoint->IsCreatedByInetLayer(*this))
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-    for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+    for (UDPEndPoint* lEndPoint = UDPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+         lEndPoint = UDPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
     {
-        UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
-        if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+        if (lEndPoint->IsCreatedByInetLayer(*this))
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-    for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+    for (TunEndPoint* lEndPoint = TunEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+         lEndPoint = TunEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
     {
-        TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
-        if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+        if (lEndPoint->IsCreatedByInetLayer(*this))
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
     }
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
@@ -1439,10 +1479,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
     {
         // Set the pending I/O field for each active endpoint based on the value returned by select.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (RawEndPoint* lEndPoint = RawEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = RawEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->mPendingIO = SocketEvents::FromFDs(lEndPoint->mSocket, readfds, writefds, exceptfds);
             }
@@ -1450,10 +1490,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = TCPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->mPendingIO = SocketEvents::FromFDs(lEndPoint->mSocket, readfds, writefds, exceptfds);
             }
@@ -1461,10 +1501,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (UDPEndPoint* lEndPoint = UDPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = UDPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->mPendingIO = SocketEvents::FromFDs(lEndPoint->mSocket, readfds, writefds, exceptfds);
             }
@@ -1472,10 +1512,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-        for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+        for (TunEndPoint* lEndPoint = TunEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = TunEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->mPendingIO = SocketEvents::FromFDs(lEndPoint->mSocket, readfds, writefds, exceptfds);
             }
@@ -1484,10 +1524,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 
         // Now call each active endpoint to handle its pending I/O.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
-        for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
+        for (RawEndPoint* lEndPoint = RawEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = RawEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            RawEndPoint* lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->HandlePendingIO();
             }
@@ -1495,10 +1535,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
-        for (size_t i = 0; i < TCPEndPoint::sPool.Size(); i++)
+        for (TCPEndPoint* lEndPoint = TCPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = TCPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            TCPEndPoint* lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->HandlePendingIO();
             }
@@ -1506,10 +1546,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_UDP_ENDPOINT
-        for (size_t i = 0; i < UDPEndPoint::sPool.Size(); i++)
+        for (UDPEndPoint* lEndPoint = UDPEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = UDPEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            UDPEndPoint* lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->HandlePendingIO();
             }
@@ -1517,10 +1557,10 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
-        for (size_t i = 0; i < TunEndPoint::sPool.Size(); i++)
+        for (TunEndPoint* lEndPoint = TunEndPoint::sPool.GetFirst(*mSystemLayer); lEndPoint != NULL;
+             lEndPoint = TunEndPoint::sPool.GetNext(*mSystemLayer, lEndPoint))
         {
-            TunEndPoint* lEndPoint = TunEndPoint::sPool.Get(*mSystemLayer, i);
-            if ((lEndPoint != NULL) && lEndPoint->IsCreatedByInetLayer(*this))
+            if (lEndPoint->IsCreatedByInetLayer(*this))
             {
                 lEndPoint->HandlePendingIO();
             }
@@ -1538,6 +1578,178 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+/**
+ *  Return the I/O events the given endpoint is interested in, based on its
+ *  concrete type.
+ */
+SocketEvents InetLayer::PrepareEndPointIO(EndPointBasis& aEndPoint)
+{
+    SocketEvents lEvents;
+
+    switch (aEndPoint.mSocketsEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Raw:
+        lEvents = static_cast<RawEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_TCP:
+        lEvents = static_cast<TCPEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_UDP:
+        lEvents = static_cast<UDPEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Tun:
+        lEvents = static_cast<TunEndPoint&>(aEndPoint).PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+
+    return lEvents;
+}
+
+/**
+ *  Invoke the I/O handling function of the given endpoint, based on its
+ *  concrete type.
+ */
+void InetLayer::HandleEndPointIO(EndPointBasis& aEndPoint)
+{
+    switch (aEndPoint.mSocketsEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Raw:
+        static_cast<RawEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_TCP:
+        static_cast<TCPEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_UDP:
+        static_cast<UDPEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Tun:
+        static_cast<TunEndPoint&>(aEndPoint).HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+}
+
+/**
+ *  Prepare the timeout for an epoll_wait() call on the epoll instance
+ *  of the underlying system layer.
+ *
+ *  If any endpoint holds readiness it has not yet consumed, and is
+ *  interested in it, the timeout is set to zero so that the endpoint is
+ *  serviced without blocking. With INET_CONFIG_ENABLE_UDP_BATCHED_IO,
+ *  the datagrams queued by UDP endpoints during this pass are sent
+ *  first.
+ *
+ *  @param[inout]  timeoutMS  The time to wait in milliseconds, or -1 to
+ *                            wait indefinitely.
+ *
+ */
+void InetLayer::PrepareEPoll(int& timeoutMS)
+{
+    if (State != kState_Initialized)
+        return;
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    FlushPendingSends();
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+    for (EndPointBasis* lEndPoint = mReadyEndPoints; lEndPoint != NULL; lEndPoint = lEndPoint->mNextReady)
+    {
+        SocketEvents lInterest = PrepareEndPointIO(*lEndPoint);
+
+        if ((lInterest.Value & lEndPoint->mReadyIO.Value) != 0)
+        {
+            timeoutMS = 0;
+            break;
+        }
+    }
+}
+
+/**
+ *  Handle I/O readiness recorded by the system layer in
+ *  Weave::System::Layer::HandleEPollResult(). Unlike
+ *  HandleSelectResult(), only endpoints with readiness are visited.
+ *
+ *  Each endpoint on the ready list has the readiness it is interested
+ *  in handed to its I/O handling function as pending I/O. Because the
+ *  socket is watched edge-triggered, the readiness is retained until
+ *  the endpoint observes EAGAIN, and the endpoint is returned to the
+ *  ready list after its handler runs for as long as some readiness
+ *  remains. An endpoint with no readiness of interest is dropped from
+ *  the list until its interest changes (see EndPointBasis::RefreshIO)
+ *  or the kernel reports new readiness.
+ *
+ *  @note
+ *    The list is detached before any callbacks are made, so endpoints
+ *    that become ready while it is processed, including those returned
+ *    to the list, are handled on the next pass of the event loop.
+ *
+ */
+void InetLayer::HandleEPollResult(void)
+{
+    EndPointBasis* lReadyList;
+
+    if (State != kState_Initialized)
+        return;
+
+    // Detach the ready list.
+    lReadyList = mReadyEndPoints;
+    mReadyEndPoints = NULL;
+    if (lReadyList != NULL)
+        lReadyList->mPrevReadyLink = &lReadyList;
+
+    while (lReadyList != NULL)
+    {
+        EndPointBasis* lEndPoint = lReadyList;
+
+        lEndPoint->UnlinkReady();
+
+        lEndPoint->mPendingIO.Value = PrepareEndPointIO(*lEndPoint).Value & lEndPoint->mReadyIO.Value;
+        if (!lEndPoint->mPendingIO.IsSet())
+            continue;
+
+        // Prevent the end point from being freed while in the middle of a callback.
+        lEndPoint->Retain();
+
+        HandleEndPointIO(*lEndPoint);
+
+        if (lEndPoint->IsOpenEndPoint() && lEndPoint->mReadyIO.IsSet())
+            lEndPoint->LinkReady();
+
+        lEndPoint->Release();
+    }
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 /**
  *  Reset the members of the IPPacketInfo object.
  *
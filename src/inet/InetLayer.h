@@ -89,6 +89,10 @@
 #include <InetLayer/InetBuffer.h>
 #endif // INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <InetLayer/EndPointBasis.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #include <InetLayer/AsyncDNSResolverSockets.h>
@@ -180,6 +184,10 @@ class NL_DLL_EXPORT InetLayer
     friend class TunEndPoint;
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    friend class EndPointBasis;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     friend class AsyncDNSResolverSockets;
@@ -282,6 +290,11 @@ class NL_DLL_EXPORT InetLayer
     void HandleSelectResult(int selectRes, fd_set *readfds, fd_set *writefds, fd_set *exceptfds);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    void PrepareEPoll(int& timeoutMS);
+    void HandleEPollResult(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     static void UpdateSnapshot(nl::Weave::System::Stats::Snapshot &aSnapshot);
 
     void *GetPlatformData(void);
@@ -361,6 +374,19 @@ private:
     void*                   mPlatformData;
     Weave::System::Layer*   mSystemLayer;
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    UDPEndPoint*            mPendingSendEndPoints;
+
+    void FlushPendingSends(void);
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT && INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    EndPointBasis*          mReadyEndPoints;
+
+    static SocketEvents PrepareEndPointIO(EndPointBasis& aEndPoint);
+    static void HandleEndPointIO(EndPointBasis& aEndPoint);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     AsyncDNSResolverSockets mAsyncDNSResolver;
@@ -73,7 +73,7 @@ public:
     IPAddress Address;
 };
 
-Weave::System::ObjectPool<RawEndPoint, INET_CONFIG_NUM_RAW_ENDPOINTS> RawEndPoint::sPool;
+Weave::System::LayerObjectPool<RawEndPoint, INET_CONFIG_NUM_RAW_ENDPOINTS> RawEndPoint::sPool;
 
 /**
  * Bind the raw endpoint to an IP address of the specified type.
@@ -274,6 +274,7 @@ INET_ERROR RawEndPoint::BindIPv6LinkLocal(InterfaceId intf, IPAddress addr)
 
 optfail:
     res = Weave::System::MapErrorPOSIX(errno);
+    UnwatchSocket();
     ::close(mSocket);
     mSocket = INET_INVALID_SOCKET_FD;
     mAddrType = kIPAddressType_Unknown;
@@ -293,10 +294,6 @@ INET_ERROR RawEndPoint::Listen()
 {
     INET_ERROR res = INET_NO_ERROR;
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    Weave::System::Layer& lSystemLayer = SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-
     if (mState == kState_Listening)
         return INET_NO_ERROR;
 
@@ -322,7 +319,7 @@ INET_ERROR RawEndPoint::Listen()
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     // Wake the thread calling select so that it starts selecting on the new socket.
-    lSystemLayer.WakeSelect();
+    RefreshIO();
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -359,6 +356,7 @@ void RawEndPoint::Close()
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+            UnwatchSocket();
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -625,6 +623,10 @@ void RawEndPoint::Init(InetLayer *inetLayer, IPVersion ipVer, IPProtocol ipProto
 {
     InitEndPointBasis(*inetLayer);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_Raw;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     IPVer = ipVer;
     IPProto = ipProto;
 }
@@ -778,6 +780,14 @@ INET_ERROR RawEndPoint::GetSocket(IPAddressType addrType)
 
         mSocket = sock;
         mAddrType = addrType;
+
+        INET_ERROR res = WatchSocket();
+        if (res != INET_NO_ERROR)
+        {
+            close(mSocket);
+            mSocket = INET_INVALID_SOCKET_FD;
+            return res;
+        }
     }
 
     return INET_NO_ERROR;
@@ -816,8 +826,16 @@ void RawEndPoint::HandlePendingIO()
 
             ssize_t rcvLen = recvfrom(mSocket, buf->Start(), buf->AvailableDataLength(), 0, &sa.any, &saLen);
             if (rcvLen < 0)
+            {
                 err = Weave::System::MapErrorPOSIX(errno);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                // The socket has been drained; wait for the next edge-triggered read event.
+                if (errno == EAGAIN)
+                    mReadyIO.ClearRead();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            }
+
             else if (rcvLen > buf->AvailableDataLength())
                 err = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
 
@@ -848,7 +866,11 @@ void RawEndPoint::HandlePendingIO()
         else
         {
             Weave::System::PacketBuffer::Free(buf);
-            if (OnReceiveError != NULL)
+            if (OnReceiveError != NULL
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                && err != Weave::System::MapErrorPOSIX(EAGAIN)
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            )
                 OnReceiveError(this, err, senderAddr); //FIXME
         }
     }
@@ -274,7 +274,7 @@ private:
     RawEndPoint(const RawEndPoint&);            // not defined
     ~RawEndPoint(void);                         // not defined
 
-    static Weave::System::ObjectPool<RawEndPoint, INET_CONFIG_NUM_RAW_ENDPOINTS> sPool;
+    static Weave::System::LayerObjectPool<RawEndPoint, INET_CONFIG_NUM_RAW_ENDPOINTS> sPool;
 
     void Init(InetLayer *inetLayer, IPVersion ipVer, IPProtocol ipProto);
     void Close(void);
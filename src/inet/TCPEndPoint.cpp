@@ -57,6 +57,15 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <netinet/tcp.h>
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif // defined(SO_ATTACH_REUSEPORT_CBPF)
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+#include <sys/uio.h>
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+#include <linux/errqueue.h>
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #include "arpa-inet-compatibility.h"
@@ -109,7 +118,7 @@ namespace Inet {
 
 using Weave::System::PacketBuffer;
 
-Weave::System::ObjectPool<TCPEndPoint, INET_CONFIG_NUM_TCP_ENDPOINTS> TCPEndPoint::sPool;
+Weave::System::LayerObjectPool<TCPEndPoint, INET_CONFIG_NUM_TCP_ENDPOINTS> TCPEndPoint::sPool;
 
 INET_ERROR TCPEndPoint::Bind(IPAddressType addrType, IPAddress addr, uint16_t port, bool reuseAddr)
 {
@@ -255,10 +264,6 @@ INET_ERROR TCPEndPoint::Listen(uint16_t backlog)
 {
     INET_ERROR res = INET_NO_ERROR;
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    Weave::System::Layer& lSystemLayer = SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-
     if (State != kState_Bound)
         return INET_ERROR_INCORRECT_STATE;
 
@@ -278,8 +283,9 @@ INET_ERROR TCPEndPoint::Listen(uint16_t backlog)
     if (listen(mSocket, backlog) != 0)
         res = Weave::System::MapErrorPOSIX(errno);
 
-    // Wake the thread calling select so that it recognizes the new socket.
-    lSystemLayer.WakeSelect();
+    // Discard readiness reported before the socket was listening and wake the thread calling select so that it recognizes
+    // the new socket.
+    ResetIO();
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -294,14 +300,37 @@ INET_ERROR TCPEndPoint::Listen(uint16_t backlog)
     return res;
 }
 
-INET_ERROR TCPEndPoint::Connect(IPAddress addr, uint16_t port, InterfaceId intf)
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+INET_ERROR TCPEndPoint::SetReusePortFilter(const struct sock_filter *filter, uint16_t filterLen)
 {
-    INET_ERROR res = INET_NO_ERROR;
+    INET_ERROR err = INET_NO_ERROR;
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    Weave::System::Layer& lSystemLayer = SystemLayer();
+    if (State != kState_Listening)
+        return INET_ERROR_INCORRECT_STATE;
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    struct sock_fprog program;
+
+    program.len = filterLen;
+    program.filter = const_cast<struct sock_filter *>(filter);
+
+    if (setsockopt(mSocket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0)
+        err = Weave::System::MapErrorPOSIX(errno);
+#else // !defined(SO_ATTACH_REUSEPORT_CBPF)
+    static_cast<void>(filter);
+    static_cast<void>(filterLen);
+
+    err = INET_ERROR_NOT_IMPLEMENTED;
+#endif // !defined(SO_ATTACH_REUSEPORT_CBPF)
+
+    return err;
+}
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+INET_ERROR TCPEndPoint::Connect(IPAddress addr, uint16_t port, InterfaceId intf)
+{
+    INET_ERROR res = INET_NO_ERROR;
+
     if (State != kState_Ready && State != kState_Bound)
         return INET_ERROR_INCORRECT_STATE;
 
@@ -510,8 +539,9 @@ INET_ERROR TCPEndPoint::Connect(IPAddress addr, uint16_t port, InterfaceId intf)
     else
         State = kState_Connecting;
 
-    // Wake the thread calling select so that it recognizes the new socket.
-    lSystemLayer.WakeSelect();
+    // Discard readiness reported before the connection was initiated and wake the thread calling select so that it
+    // recognizes the new socket.
+    ResetIO();
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -737,6 +767,11 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer *data, bool push)
     if (push)
         res = DriveSending();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    // Act upon any write readiness already held by the end point for the newly queued data.
+    RefreshIO();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     return res;
 }
 
@@ -747,10 +782,6 @@ void TCPEndPoint::DisableReceive()
 
 void TCPEndPoint::EnableReceive()
 {
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    Weave::System::Layer& lSystemLayer = SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-
     ReceiveEnabled = true;
 
     DriveReceiving();
@@ -759,7 +790,7 @@ void TCPEndPoint::EnableReceive()
 
     // Wake the thread calling select so that it can include the socket
     // in the select read fd_set.
-    lSystemLayer.WakeSelect();
+    RefreshIO();
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
@@ -1171,6 +1202,13 @@ void TCPEndPoint::SetIdleTimeout(uint32_t timeoutMS)
 }
 #endif // INET_TCP_IDLE_CHECK_INTERVAL > 0
 
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+void TCPEndPoint::GetSendStats(SendStats &stats) const
+{
+    stats = mSendStats;
+}
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+
 bool TCPEndPoint::IsConnected(int state)
 {
     return state == kState_Connected || state == kState_SendShutdown || state == kState_ReceiveShutdown || state == kState_Closing;
@@ -1179,6 +1217,11 @@ bool TCPEndPoint::IsConnected(int state)
 void TCPEndPoint::Init(InetLayer *inetLayer)
 {
     InitEndPointBasis(*inetLayer);
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_TCP;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     ReceiveEnabled = true;
 
     // Initialize to zero for using system defaults.
@@ -1197,6 +1240,19 @@ void TCPEndPoint::Init(InetLayer *inetLayer)
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
+
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+    memset(&mSendStats, 0, sizeof(mSendStats));
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+    mZeroCopyPendingHead = 0;
+    mZeroCopyPendingCount = 0;
+    mZeroCopyNextSendId = 0;
+    mZeroCopyCloseWaitMsecs = 0;
+    mZeroCopyEnabled = false;
+    mZeroCopyUnsupported = false;
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
 }
 
 INET_ERROR TCPEndPoint::DriveSending()
@@ -1305,26 +1361,133 @@ INET_ERROR TCPEndPoint::DriveSending()
                           return err;
                       });
 
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+    // Release any buffers the kernel has finished with before pinning more.
+    HandleZeroCopyCompletions();
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
     while (mSendQueue != NULL)
     {
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+        PacketBuffer *iovBufs[INET_CONFIG_TCP_SEND_IOV_MAX];
+        struct iovec iov[INET_CONFIG_TCP_SEND_IOV_MAX];
+        struct msghdr msg;
+        size_t iovCount = 0;
+        size_t bufLen = 0;
+
+        // Gather as much of the send queue as one call may carry.  The total is kept within the range
+        // of the length reported to OnDataSent.
+        for (PacketBuffer *buf = mSendQueue; buf != NULL && iovCount < INET_CONFIG_TCP_SEND_IOV_MAX; buf = buf->Next())
+        {
+            if (bufLen + buf->DataLength() > UINT16_MAX)
+                break;
+
+            iovBufs[iovCount] = buf;
+            iov[iovCount].iov_base = buf->Start();
+            iov[iovCount].iov_len = buf->DataLength();
+            bufLen += buf->DataLength();
+            iovCount++;
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovCount;
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+        bool zeroCopy = (bufLen >= INET_CONFIG_TCP_ZEROCOPY_THRESHOLD && !mZeroCopyUnsupported &&
+                         mZeroCopyPendingCount + iovCount <= INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING);
+
+        if (zeroCopy && !mZeroCopyEnabled)
+        {
+            int one = 1;
+            if (setsockopt(mSocket, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0)
+                mZeroCopyEnabled = true;
+            else
+            {
+                WeaveLogError(Inet, "SO_ZEROCOPY: %d", errno);
+                mZeroCopyUnsupported = true;
+                zeroCopy = false;
+            }
+        }
+
+        ssize_t lenSent = sendmsg(mSocket, &msg, zeroCopy ? (sendFlags | MSG_ZEROCOPY) : sendFlags);
+
+        // The kernel refuses zero-copy sends when the socket's option memory is exhausted; copy instead.
+        if (lenSent == -1 && zeroCopy && errno == ENOBUFS)
+        {
+            zeroCopy = false;
+            lenSent = sendmsg(mSocket, &msg, sendFlags);
+        }
+#else // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD <= 0
+        ssize_t lenSent = sendmsg(mSocket, &msg, sendFlags);
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD <= 0
+#else // !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
         uint16_t bufLen = mSendQueue->DataLength();
 
         ssize_t lenSent = send(mSocket, mSendQueue->Start(), (size_t) bufLen, sendFlags);
+#endif // !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
 
         if (lenSent == -1)
         {
             if (errno != EAGAIN && errno != EWOULDBLOCK)
                 err = (errno == EPIPE) ? INET_ERROR_PEER_DISCONNECTED : Weave::System::MapErrorPOSIX(errno);
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            else
+                // The socket send buffer is full; wait for the next edge-triggered write event.
+                mReadyIO.ClearWrite();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
             break;
         }
 
         // Mark the connection as being active.
         MarkActive();
 
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+        mSendStats.SendCalls++;
+        mSendStats.BytesSent += lenSent;
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+        // Hold each buffer the call read from until the kernel reports that it is done with it.
+        if (zeroCopy)
+        {
+            size_t covered = 0;
+
+            for (size_t i = 0; i < iovCount && covered < (size_t) lenSent; i++)
+            {
+                ZeroCopyPendingBuffer &pending = mZeroCopyPending[(mZeroCopyPendingHead + mZeroCopyPendingCount) % INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING];
+
+                iovBufs[i]->AddRef();
+                pending.Buffer = iovBufs[i];
+                pending.SendId = mZeroCopyNextSendId;
+                mZeroCopyPendingCount++;
+                covered += iov[i].iov_len;
+            }
+
+            mZeroCopyNextSendId++;
+            mSendStats.ZeroCopySendCalls++;
+        }
+#else // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD <= 0
+        static_cast<void>(iovBufs);
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD <= 0
+
+        // Free the buffers written in their entirety and consume the written part of the next one.
+        for (size_t remaining = (size_t) lenSent; mSendQueue != NULL; )
+        {
+            if (mSendQueue->DataLength() > remaining)
+            {
+                mSendQueue->ConsumeHead((uint16_t) remaining);
+                break;
+            }
+
+            remaining -= mSendQueue->DataLength();
+            mSendQueue = PacketBuffer::FreeHead(mSendQueue);
+        }
+#else // !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
         if (lenSent < bufLen)
             mSendQueue->ConsumeHead(lenSent);
         else
             mSendQueue = PacketBuffer::FreeHead(mSendQueue);
+#endif // !INET_CONFIG_ENABLE_TCP_GATHERED_SEND
 
         if (OnDataSent != NULL)
             OnDataSent(this, (uint16_t) lenSent);
@@ -1354,7 +1517,7 @@ INET_ERROR TCPEndPoint::DriveSending()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if ((size_t) lenSent < bufLen)
             break;
     }
 
@@ -1419,17 +1582,28 @@ void TCPEndPoint::HandleConnectComplete(INET_ERROR err)
 INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
 {
     int             oldState        = State;
+    bool            draining        = (mSendQueue != NULL || mRcvQueue != NULL);
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     struct linger   lingerStruct;
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+    // The kernel may still read buffers written with MSG_ZEROCOPY. A graceful close keeps them, and the socket their
+    // completions are reported on, until it is done with them.
+    if (IsConnected() && err == INET_NO_ERROR && mZeroCopyPendingCount > 0)
+    {
+        HandleZeroCopyCompletions();
+        draining = draining || (mZeroCopyPendingCount > 0);
+    }
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
     // If in one of the connected states (Connected, LocalShutdown, PeerShutdown or Closing)
     // AND this is a graceful close (i.e. not prompted by an error)
     // AND there is data waiting to be processed on either the send or receive queues
     // ... THEN enter the Closing state, allowing the queued data to drain,
     // ... OTHERWISE go straight to the Closed state.
-    if (IsConnected() && err == INET_NO_ERROR && (mSendQueue != NULL || mRcvQueue != NULL))
+    if (IsConnected() && err == INET_NO_ERROR && draining)
         State = kState_Closing;
     else
         State = kState_Closed;
@@ -1517,13 +1691,32 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
         // If entering the Closed state
         // OR if entering the Closing state, and there's no unsent data in the send queue
         // THEN close the socket.
-        if (State == kState_Closed ||
-            (State == kState_Closing && mSendQueue == NULL))
+        bool closeSocket = (State == kState_Closed || (State == kState_Closing && mSendQueue == NULL));
+        bool abortConnection = (IsConnected(oldState) && err != INET_NO_ERROR);
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+        if (State == kState_Closing && mZeroCopyEnabled)
+        {
+            // Keep the socket open while zero-copy buffers are outstanding, and poll for their completions, which
+            // arrive on the error queue of the socket without any other I/O the endpoint is waiting for.
+            if (mZeroCopyPendingCount > 0)
+                closeSocket = false;
+
+            mZeroCopyCloseWaitMsecs = 0;
+            SystemLayer().StartTimer(INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL, ZeroCopyCloseTimerHandler, this);
+        }
+
+        // Buffers still outstanding are released below; make sure the kernel sends nothing more from them.
+        if (State == kState_Closed && mZeroCopyPendingCount > 0)
+            abortConnection = true;
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
+        if (closeSocket)
         {
             Weave::System::Layer& lSystemLayer = SystemLayer();
 
             // If aborting the connection, ensure we send a TCP RST.
-            if (IsConnected(oldState) && err != INET_NO_ERROR)
+            if (abortConnection)
             {
                 lingerStruct.l_onoff = 1;
                 lingerStruct.l_linger = 0;
@@ -1532,6 +1725,7 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
                     WeaveLogError(Inet, "SO_LINGER: %d", errno);
             }
 
+            UnwatchSocket();
             if (close(mSocket) != 0 && err == INET_NO_ERROR)
                 err = Weave::System::MapErrorPOSIX(errno);
             mSocket = INET_INVALID_SOCKET_FD;
@@ -1559,6 +1753,10 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
         mSendQueue = NULL;
         PacketBuffer::Free(mRcvQueue);
         mRcvQueue = NULL;
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+        SystemLayer().CancelTimer(ZeroCopyCloseTimerHandler, this);
+        ReleaseZeroCopyBuffers();
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
 
         // Call the appropriate app callback if allowed.
         if (!suppressCallback)
@@ -2068,6 +2266,14 @@ INET_ERROR TCPEndPoint::GetSocket(IPAddressType addrType)
             return Weave::System::MapErrorPOSIX(errno);
         mAddrType = addrType;
 
+        INET_ERROR err = WatchSocket();
+        if (err != INET_NO_ERROR)
+        {
+            close(mSocket);
+            mSocket = INET_INVALID_SOCKET_FD;
+            return err;
+        }
+
         // If creating an IPv6 socket, tell the kernel that it will be IPv6 only.  This makes it
         // posible to bind two sockets to the same port, one for IPv4 and one for IPv6.
 #ifdef IPV6_V6ONLY
@@ -2150,6 +2356,12 @@ void TCPEndPoint::HandlePendingIO()
 
     else
     {
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+        // Zero-copy completions are queued on the socket's error queue, which makes it readable.
+        if (mPendingIO.IsReadable())
+            HandleZeroCopyCompletions();
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
         // If in a state where sending is allowed, and there is data to be sent, and the socket is ready for
         // writing, drive outbound data into the connection.
         if (IsConnected() && mSendQueue != NULL && mPendingIO.IsWriteable())
@@ -2234,11 +2446,17 @@ void TCPEndPoint::ReceiveData()
 
         if (systemErrno == EAGAIN)
         {
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            // The socket has been drained; wait for the next
+            // edge-triggered read event.
+            mReadyIO.ClearRead();
+#else // !WEAVE_SYSTEM_CONFIG_USE_EPOLL
             // Note: in this case, we opt to not retry the recv call,
             // and instead we expect that the read flags will get
             // reset correctly upon a subsequent return from the
             // select call.
             WeaveLogError(Inet, "recv: EAGAIN, will retry");
+#endif // !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
             return;
         }
@@ -2290,6 +2508,102 @@ void TCPEndPoint::ReceiveData()
     DriveReceiving();
 }
 
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
+void TCPEndPoint::HandleZeroCopyCompletions()
+{
+    while (mZeroCopyPendingCount > 0)
+    {
+        uint8_t control[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+        struct msghdr msg;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (recvmsg(mSocket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
+            break;
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            const struct sock_extended_err *ee;
+
+            if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                  (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)))
+                continue;
+
+            ee = reinterpret_cast<const struct sock_extended_err *>(CMSG_DATA(cmsg));
+            if (ee->ee_errno != 0 || ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+
+            if (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                mSendStats.ZeroCopyCopiedCompletions++;
+
+            // Completions on a TCP socket are reported in order, so every buffer written by a call up to the
+            // last one covered by the notification can be released.
+            while (mZeroCopyPendingCount > 0 &&
+                   static_cast<int32_t>(mZeroCopyPending[mZeroCopyPendingHead].SendId - ee->ee_data) <= 0)
+            {
+                PacketBuffer::Free(mZeroCopyPending[mZeroCopyPendingHead].Buffer);
+                mZeroCopyPendingHead = (mZeroCopyPendingHead + 1) % INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING;
+                mZeroCopyPendingCount--;
+            }
+        }
+    }
+}
+
+/**
+ *  Poll for the zero-copy completions a gracefully closing endpoint is waiting for, and finish closing the connection once
+ *  there are none left and the send queue is empty, or abort it after #INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT.
+ */
+void TCPEndPoint::ZeroCopyCloseTimerHandler(Weave::System::Layer* aSystemLayer, void* aAppState, Weave::System::Error aError)
+{
+    TCPEndPoint* tcpEndPoint = reinterpret_cast<TCPEndPoint*>(aAppState);
+
+    VerifyOrDie((aSystemLayer != NULL) && (tcpEndPoint != NULL));
+
+    if (tcpEndPoint->State != kState_Closing || tcpEndPoint->mSocket == INET_INVALID_SOCKET_FD)
+        return;
+
+    tcpEndPoint->HandleZeroCopyCompletions();
+
+    // Until the send queue drains, more zero-copy writes may be made; only the wait after that is limited.
+    if (tcpEndPoint->mSendQueue == NULL)
+    {
+        if (tcpEndPoint->mZeroCopyPendingCount == 0)
+        {
+            tcpEndPoint->DoClose(INET_NO_ERROR, false);
+            return;
+        }
+
+        tcpEndPoint->mZeroCopyCloseWaitMsecs += INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL;
+        if (tcpEndPoint->mZeroCopyCloseWaitMsecs >= INET_CONFIG_TCP_ZEROCOPY_CLOSE_TIMEOUT)
+        {
+            WeaveLogError(Inet, "Zero-copy completions timed out on close");
+            tcpEndPoint->DoClose(INET_ERROR_CONNECTION_ABORTED, false);
+            return;
+        }
+    }
+
+    aSystemLayer->StartTimer(INET_CONFIG_TCP_ZEROCOPY_CLOSE_POLL_INTERVAL, ZeroCopyCloseTimerHandler, tcpEndPoint);
+}
+
+void TCPEndPoint::ReleaseZeroCopyBuffers()
+{
+    while (mZeroCopyPendingCount > 0)
+    {
+        PacketBuffer::Free(mZeroCopyPending[mZeroCopyPendingHead].Buffer);
+        mZeroCopyPendingHead = (mZeroCopyPendingHead + 1) % INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING;
+        mZeroCopyPendingCount--;
+    }
+
+    mZeroCopyPendingHead = 0;
+    mZeroCopyNextSendId = 0;
+    mZeroCopyEnabled = false;
+}
+
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+
 void TCPEndPoint::HandleIncomingConnection()
 {
     INET_ERROR err = INET_NO_ERROR;
@@ -2309,7 +2623,18 @@ void TCPEndPoint::HandleIncomingConnection()
     // Accept the new connection.
     int conSocket = accept(mSocket, &sa.any, &saLen);
     if (conSocket == -1)
+    {
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        // The listen queue has been drained; wait for the next edge-triggered read event.
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            mReadyIO.ClearRead();
+            return;
+        }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
         err = Weave::System::MapErrorPOSIX(errno);
+    }
 
     // If there's no callback available, fail with an error.
     if (err == INET_NO_ERROR && OnConnectionReceived == NULL)
@@ -2342,12 +2667,21 @@ void TCPEndPoint::HandleIncomingConnection()
         err = lInetLayer.NewTCPEndPoint(&conEP);
     }
 
+    // Hand the new socket to the end point and arrange for its I/O to be serviced.
+    if (err == INET_NO_ERROR)
+    {
+        conEP->mSocket = conSocket;
+
+        err = conEP->WatchSocket();
+        if (err != INET_NO_ERROR)
+            conEP->mSocket = INET_INVALID_SOCKET_FD;
+    }
+
     // If all went well...
     if (err == INET_NO_ERROR)
     {
         // Put the new end point into the Connected state.
         conEP->State = kState_Connected;
-        conEP->mSocket = conSocket;
 #if INET_CONFIG_ENABLE_IPV4
         conEP->mAddrType = (sa.any.sa_family == AF_INET6) ? kIPAddressType_IPv6 : kIPAddressType_IPv4;
 #else // !INET_CONFIG_ENABLE_IPV4
@@ -33,6 +33,10 @@
 
 #include <SystemLayer/SystemPacketBuffer.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+struct sock_filter;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 namespace nl {
 namespace Inet {
 
@@ -130,6 +134,31 @@ public:
      */
     INET_ERROR Listen(uint16_t backlog);
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    /**
+     * @brief   Steer incoming connections among the sockets sharing the port.
+     *
+     * @param[in]   filter      the classic BPF program selecting a socket
+     * @param[in]   filterLen   the number of instructions in \c filter
+     *
+     * @retval  INET_NO_ERROR               success: program attached.
+     * @retval  INET_ERROR_INCORRECT_STATE  endpoint is not listening.
+     * @retval  INET_ERROR_NOT_IMPLEMENTED  the system cannot steer connections.
+     *
+     * @retval  other                   another system or platform error
+     *
+     * @details
+     *  Attaches \c filter with \c SO_ATTACH_REUSEPORT_CBPF to the group of
+     *  \c SO_REUSEPORT sockets listening on the same address and port as the
+     *  endpoint, replacing any program attached before. For each connection
+     *  request, the program runs on the SYN segment, which carries no payload,
+     *  so only the IP header is of use through \c SKF_NET_OFF. It returns the
+     *  number of the accepting socket in the group, as for
+     *  UDPEndPoint::SetReusePortFilter().
+     */
+    INET_ERROR SetReusePortFilter(const struct sock_filter *filter, uint16_t filterLen);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
     /**
      * @brief   Initiate a TCP connection.
      *
@@ -382,6 +411,27 @@ public:
     void SetIdleTimeout(uint32_t timeoutMS);
 #endif // INET_TCP_IDLE_CHECK_INTERVAL > 0
 
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+    /**
+     * @brief   Counters describing the writes made on the connection.
+     */
+    struct SendStats
+    {
+        uint32_t SendCalls;                             ///< Number of sendmsg() calls that wrote data.
+        uint64_t BytesSent;                             ///< Number of octets written by those calls.
+        uint32_t ZeroCopySendCalls;                     ///< Number of those calls made with MSG_ZEROCOPY.
+        uint32_t ZeroCopyCopiedCompletions;             ///< Number of zero-copy completions for which the kernel copied anyway.
+    };
+
+    /**
+     * @brief   Get the counters describing the writes made on the connection.
+     *
+     * @param[out]  stats   The current counters. BytesSent divided by SendCalls
+     *                      gives the average number of octets per system call.
+     */
+    void GetSendStats(SendStats &stats) const;
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+
     /**
      * @brief   Note activity, in other words, reset the idle timer.
      *
@@ -527,7 +577,7 @@ public:
     OnAcceptErrorFunct OnAcceptError;
 
 private:
-    static Weave::System::ObjectPool<TCPEndPoint, INET_CONFIG_NUM_TCP_ENDPOINTS> sPool;
+    static Weave::System::LayerObjectPool<TCPEndPoint, INET_CONFIG_NUM_TCP_ENDPOINTS> sPool;
 
     Weave::System::PacketBuffer *mRcvQueue;
     Weave::System::PacketBuffer *mSendQueue;
@@ -606,6 +656,30 @@ private:
     void ReceiveData(void);
     void HandleIncomingConnection(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+    SendStats mSendStats;
+
+#if INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+    struct ZeroCopyPendingBuffer
+    {
+        Weave::System::PacketBuffer *Buffer;            // Buffer written with MSG_ZEROCOPY, held until the kernel is done with it.
+        uint32_t SendId;                                // Kernel sequence number of the sendmsg() call that wrote it.
+    };
+
+    ZeroCopyPendingBuffer mZeroCopyPending[INET_CONFIG_TCP_ZEROCOPY_MAX_PENDING];
+    uint8_t mZeroCopyPendingHead;
+    uint8_t mZeroCopyPendingCount;
+    uint32_t mZeroCopyNextSendId;
+    uint32_t mZeroCopyCloseWaitMsecs;                   // Time spent in the Closing state waiting only for completions.
+    bool mZeroCopyEnabled;                              // SO_ZEROCOPY has been set on the socket.
+    bool mZeroCopyUnsupported;                          // Setting SO_ZEROCOPY on the socket failed.
+
+    void HandleZeroCopyCompletions(void);
+    void ReleaseZeroCopyBuffers(void);
+    static void ZeroCopyCloseTimerHandler(Weave::System::Layer* aSystemLayer, void* aAppState, Weave::System::Error aError);
+#endif // INET_CONFIG_TCP_ZEROCOPY_THRESHOLD > 0
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
 };
 
 inline bool TCPEndPoint::IsConnected(void) const
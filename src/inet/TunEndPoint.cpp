@@ -44,7 +44,7 @@ namespace Inet {
 
 using Weave::System::PacketBuffer;
 
-Weave::System::ObjectPool<TunEndPoint, INET_CONFIG_NUM_TUN_ENDPOINTS> TunEndPoint::sPool;
+Weave::System::LayerObjectPool<TunEndPoint, INET_CONFIG_NUM_TUN_ENDPOINTS> TunEndPoint::sPool;
 
 using namespace nl::Weave::Encoding;
 
@@ -62,6 +62,10 @@ using namespace nl::Weave::Encoding;
 void TunEndPoint::Init(InetLayer *inetLayer)
 {
     InitEndPointBasis(*inetLayer);
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_Tun;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 }
 
 /**
@@ -691,6 +695,9 @@ INET_ERROR TunEndPoint::TunDevOpen (const char *intfName)
         ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
     }
 
+    ret = WatchSocket();
+    SuccessOrExit(ret);
+
     if (ifr.ifr_name[0] != '\0')
     {
         //Keep member copy of interface name and Id
@@ -716,6 +723,7 @@ void TunEndPoint::TunDevClose (void)
 {
     if (mSocket >= 0)
     {
+        UnwatchSocket();
         close(mSocket);
     }
     mSocket = INET_INVALID_SOCKET_FD;
@@ -740,6 +748,12 @@ INET_ERROR TunEndPoint::TunDevRead (PacketBuffer *msg)
     if (rcvLen < 0)
     {
         err = Weave::System::MapErrorPOSIX(errno);
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        // The device has been drained; wait for the next edge-triggered read event.
+        if (errno == EAGAIN)
+            mReadyIO.ClearRead();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
     }
     else if (rcvLen > msg->AvailableDataLength())
     {
@@ -797,7 +811,11 @@ void TunEndPoint::HandlePendingIO ()
         else
         {
             PacketBuffer::Free(buf);
-            if (OnReceiveError != NULL)
+            if (OnReceiveError != NULL
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                && err != Weave::System::MapErrorPOSIX(EAGAIN)
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            )
             {
                 OnReceiveError(this, err);
             }
@@ -187,7 +187,7 @@ private:
     TunEndPoint(const TunEndPoint&);                    // not defined
     ~TunEndPoint(void);                                 // not defined
 
-    static Weave::System::ObjectPool<TunEndPoint, INET_CONFIG_NUM_TUN_ENDPOINTS> sPool;
+    static Weave::System::LayerObjectPool<TunEndPoint, INET_CONFIG_NUM_TUN_ENDPOINTS> sPool;
 
     /** Close the tunnel. */
     void Close(void);
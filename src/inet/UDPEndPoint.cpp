@@ -55,6 +55,9 @@
 #include <errno.h>
 #include <unistd.h>
 #include <net/if.h>
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif // defined(SO_ATTACH_REUSEPORT_CBPF)
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #include "arpa-inet-compatibility.h"
@@ -71,7 +74,7 @@ namespace Inet {
 
 using Weave::System::PacketBuffer;
 
-Weave::System::ObjectPool<UDPEndPoint, INET_CONFIG_NUM_UDP_ENDPOINTS> UDPEndPoint::sPool;
+Weave::System::LayerObjectPool<UDPEndPoint, INET_CONFIG_NUM_UDP_ENDPOINTS> UDPEndPoint::sPool;
 
 INET_ERROR UDPEndPoint::Bind(IPAddressType addrType, IPAddress addr, uint16_t port, InterfaceId intfId)
 {
@@ -228,10 +231,6 @@ INET_ERROR UDPEndPoint::Listen()
 {
     INET_ERROR res = INET_NO_ERROR;
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    Weave::System::Layer& lSystemLayer = SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-
     if (mState == kState_Listening)
         return INET_NO_ERROR;
 
@@ -260,7 +259,7 @@ INET_ERROR UDPEndPoint::Listen()
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     // Wake the thread calling select so that it recognizes the new socket.
-    lSystemLayer.WakeSelect();
+    RefreshIO();
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -292,6 +291,27 @@ void UDPEndPoint::Close()
 
 # if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+        // Send whatever is still queued, drop what the socket would not take and release the receive buffers. Errors are only
+        // logged, as the endpoint is going away.
+        FlushSendQueue();
+        UnlinkPendingSend();
+        mSendError = INET_NO_ERROR;
+
+        for (unsigned int i = 0; i < mSendQueueLen; i++)
+        {
+            PacketBuffer::Free(mSendQueue[i].Msg);
+            mSendQueue[i].Msg = NULL;
+        }
+        mSendQueueLen = 0;
+
+        for (size_t i = 0; i < INET_CONFIG_UDP_RECV_BATCH_SIZE; i++)
+        {
+            PacketBuffer::Free(mRecvBufs[i]);
+            mRecvBufs[i] = NULL;
+        }
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
         if (mSocket != INET_INVALID_SOCKET_FD)
         {
             Weave::System::Layer& lSystemLayer = SystemLayer();
@@ -299,6 +319,7 @@ void UDPEndPoint::Close()
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+            UnwatchSocket();
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -441,12 +462,7 @@ INET_ERROR UDPEndPoint::SendTo(IPAddress addr, uint16_t port, InterfaceId intfId
     if (res == INET_NO_ERROR)
     {
         struct iovec msgIOV;
-        union
-        {
-            sockaddr any;
-            sockaddr_in in;
-            sockaddr_in6 in6;
-        } peerSockAddr;
+        PeerSockAddr peerSockAddr;
         uint8_t controlData[256];
         struct msghdr msgHeader;
 
@@ -530,6 +546,14 @@ INET_ERROR UDPEndPoint::SendTo(IPAddress addr, uint16_t port, InterfaceId intfId
 
         if (res == INET_NO_ERROR)
         {
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+            // Queue UDP packet for the next sendmmsg() call.
+            res = QueueSend(msg, peerSockAddr, msgHeader.msg_namelen, sendFlags);
+
+            // The send queue now owns the buffer.
+            if (res == INET_NO_ERROR && (sendFlags & kSendFlag_RetainBuffer) == 0)
+                msg = NULL;
+#else // !INET_CONFIG_ENABLE_UDP_BATCHED_IO
             // Send UDP packet.
 //            ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
 
@@ -538,6 +562,7 @@ INET_ERROR UDPEndPoint::SendTo(IPAddress addr, uint16_t port, InterfaceId intfId
                 res = Weave::System::MapErrorPOSIX(errno);
             else if (lenSent != msg->DataLength())
                 res = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
+#endif // !INET_CONFIG_ENABLE_UDP_BATCHED_IO
         }
     }
 
@@ -643,6 +668,33 @@ INET_ERROR UDPEndPoint::BindInterface(IPAddressType addrType, InterfaceId intf)
     return err;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+INET_ERROR UDPEndPoint::SetReusePortFilter(const struct sock_filter *filter, uint16_t filterLen)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    if (mState != kState_Bound && mState != kState_Listening)
+        return INET_ERROR_INCORRECT_STATE;
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    struct sock_fprog program;
+
+    program.len = filterLen;
+    program.filter = const_cast<struct sock_filter *>(filter);
+
+    if (setsockopt(mSocket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0)
+        err = Weave::System::MapErrorPOSIX(errno);
+#else // !defined(SO_ATTACH_REUSEPORT_CBPF)
+    static_cast<void>(filter);
+    static_cast<void>(filterLen);
+
+    err = INET_ERROR_NOT_IMPLEMENTED;
+#endif // !defined(SO_ATTACH_REUSEPORT_CBPF)
+
+    return err;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 void UDPEndPoint::Init(InetLayer *inetLayer)
 {
     InitEndPointBasis(*inetLayer);
@@ -650,6 +702,19 @@ void UDPEndPoint::Init(InetLayer *inetLayer)
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     mBoundIntfId = INET_NULL_INTERFACEID;
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    memset(mRecvBufs, 0, sizeof(mRecvBufs));
+    mRecvBatchLen = 1;
+    mSendQueueLen = 0;
+    mSendError = INET_NO_ERROR;
+    mNextPendingSend = NULL;
+    mPrevPendingSendLink = NULL;
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_UDP;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 }
 
 InterfaceId UDPEndPoint::GetBoundInterface (void)
@@ -858,6 +923,14 @@ INET_ERROR UDPEndPoint::GetSocket(IPAddressType addrType)
             return Weave::System::MapErrorPOSIX(errno);
         mAddrType = addrType;
 
+        INET_ERROR err = WatchSocket();
+        if (err != INET_NO_ERROR)
+        {
+            close(mSocket);
+            mSocket = INET_INVALID_SOCKET_FD;
+            return err;
+        }
+
         //
         // NOTE WELL: the errors returned by setsockopt() here are not returned as Inet layer
         // Weave::System::MapErrorPOSIX(errno) codes because they are normally expected to fail on some
@@ -939,15 +1012,31 @@ SocketEvents UDPEndPoint::PrepareIO()
     if (mState == kState_Listening && OnMessageReceived != NULL)
         res.SetRead();
 
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    // Datagrams the socket would not take are sent when it becomes writable.
+    if (mSendQueueLen > 0)
+        res.SetWrite();
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
     return res;
 }
 
 void UDPEndPoint::HandlePendingIO()
 {
-    INET_ERROR err = INET_NO_ERROR;
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    if (mSendQueueLen > 0 && mPendingIO.IsWriteable())
+    {
+        FlushSendQueue();
+        ReportSendError();
+    }
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
 
     if (mState == kState_Listening && OnMessageReceived != NULL && mPendingIO.IsReadable())
     {
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+        ReceiveBatch();
+#else // !INET_CONFIG_ENABLE_UDP_BATCHED_IO
+        INET_ERROR err = INET_NO_ERROR;
         IPPacketInfo pktInfo;
         pktInfo.Clear();
         pktInfo.DestPort = mBoundPort;
@@ -957,12 +1046,7 @@ void UDPEndPoint::HandlePendingIO()
         if (buf != NULL)
         {
             struct iovec msgIOV;
-            union
-            {
-                sockaddr any;
-                sockaddr_in in;
-                sockaddr_in6 in6;
-            } peerSockAddr;
+            PeerSockAddr peerSockAddr;
             uint8_t controlData[256];
             struct msghdr msgHeader;
 
@@ -982,80 +1066,397 @@ void UDPEndPoint::HandlePendingIO()
             ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
 
             if (rcvLen < 0)
+            {
                 err = Weave::System::MapErrorPOSIX(errno);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                // The socket has been drained; wait for the next edge-triggered read event.
+                if (errno == EAGAIN)
+                    mReadyIO.ClearRead();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            }
+
             else if (rcvLen > buf->AvailableDataLength())
                 err = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
 
             else
             {
                 buf->SetDataLength((uint16_t) rcvLen);
+                err = DecodePacketInfo(msgHeader, pktInfo);
+            }
+        }
 
-                if (peerSockAddr.any.sa_family == AF_INET6)
-                {
-                    pktInfo.SrcAddress = IPAddress::FromIPv6(peerSockAddr.in6.sin6_addr);
-                    pktInfo.SrcPort = ntohs(peerSockAddr.in6.sin6_port);
-                }
+        else
+            err = INET_ERROR_NO_MEMORY;
+
+        if (err == INET_NO_ERROR)
+            OnMessageReceived(this, buf, &pktInfo);
+        else
+        {
+            PacketBuffer::Free(buf);
+            if (OnReceiveError != NULL
+                && err != Weave::System::MapErrorPOSIX(EAGAIN)
+            )
+                OnReceiveError(this, err, NULL);
+        }
+#endif // !INET_CONFIG_ENABLE_UDP_BATCHED_IO
+    }
+
+    mPendingIO.Clear();
+}
+
+/**
+ *  Fill in the source address and port, and, where the platform reports them, the destination address and the interface, of
+ *  a datagram received with \c recvmsg() or \c recvmmsg() from the message header of the call.
+ */
+INET_ERROR UDPEndPoint::DecodePacketInfo(const struct msghdr& msgHeader, IPPacketInfo& pktInfo)
+{
+    const sockaddr *peerSockAddr = static_cast<const sockaddr *>(msgHeader.msg_name);
+
+    if (peerSockAddr->sa_family == AF_INET6)
+    {
+        const sockaddr_in6 *peerSockAddr6 = reinterpret_cast<const sockaddr_in6 *>(peerSockAddr);
+        pktInfo.SrcAddress = IPAddress::FromIPv6(peerSockAddr6->sin6_addr);
+        pktInfo.SrcPort = ntohs(peerSockAddr6->sin6_port);
+    }
 #if INET_CONFIG_ENABLE_IPV4
-                else if (peerSockAddr.any.sa_family == AF_INET)
-                {
-                    pktInfo.SrcAddress = IPAddress::FromIPv4(peerSockAddr.in.sin_addr);
-                    pktInfo.SrcPort = ntohs(peerSockAddr.in.sin_port);
-                }
+    else if (peerSockAddr->sa_family == AF_INET)
+    {
+        const sockaddr_in *peerSockAddr4 = reinterpret_cast<const sockaddr_in *>(peerSockAddr);
+        pktInfo.SrcAddress = IPAddress::FromIPv4(peerSockAddr4->sin_addr);
+        pktInfo.SrcPort = ntohs(peerSockAddr4->sin_port);
+    }
 #endif // INET_CONFIG_ENABLE_IPV4
-                else
-                    err = INET_ERROR_INCORRECT_STATE;
-            }
+    else
+        return INET_ERROR_INCORRECT_STATE;
 
-            if (err == INET_NO_ERROR)
-            {
-                for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
-                     controlHdr != NULL;
-                     controlHdr = CMSG_NXTHDR(&msgHeader, controlHdr))
-                {
+    for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
+         controlHdr != NULL;
+         controlHdr = CMSG_NXTHDR(const_cast<struct msghdr *>(&msgHeader), controlHdr))
+    {
 #if INET_CONFIG_ENABLE_IPV4
 #ifdef IP_PKTINFO
-                    if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                    {
-                        struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
-                        pktInfo.Interface = inPktInfo->ipi_ifindex;
-                        pktInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
-                        continue;
-                    }
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
+            pktInfo.Interface = inPktInfo->ipi_ifindex;
+            pktInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
+            continue;
+        }
 #endif // defined(IP_PKTINFO)
 #endif // INET_CONFIG_ENABLE_IPV4
 
 #ifdef IPV6_PKTINFO
-                    if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                    {
-                        struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
-                        pktInfo.Interface = in6PktInfo->ipi6_ifindex;
-                        pktInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
-                        continue;
-                    }
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
+            pktInfo.Interface = in6PktInfo->ipi6_ifindex;
+            pktInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
+            continue;
+        }
 #endif // defined(IPV6_PKTINFO)
-                }
-            }
+    }
+
+    return INET_NO_ERROR;
+}
+
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+/**
+ *  Receive up to #INET_CONFIG_UDP_RECV_BATCH_SIZE datagrams with a single \c recvmmsg() call and hand them, in order of
+ *  arrival, to the \c OnMessageReceived delegate.
+ *
+ *  The endpoint keeps one packet buffer allocated for each datagram of a batch. Buffers handed to the application are replaced
+ *  on the next call; those left unused by a short batch are kept for the next call as they are.
+ */
+void UDPEndPoint::ReceiveBatch(void)
+{
+    struct mmsghdr msgHeaders[INET_CONFIG_UDP_RECV_BATCH_SIZE];
+    struct iovec msgIOVs[INET_CONFIG_UDP_RECV_BATCH_SIZE];
+    PeerSockAddr peerSockAddrs[INET_CONFIG_UDP_RECV_BATCH_SIZE];
+    union
+    {
+        struct cmsghdr align;
+        uint8_t data[CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(struct in_pktinfo))];
+    } controlData[INET_CONFIG_UDP_RECV_BATCH_SIZE];
+    INET_ERROR err = INET_NO_ERROR;
+    unsigned int numBufs;
+    int numRcvd;
+
+    memset(msgHeaders, 0, sizeof(msgHeaders));
+
+    // Only as many buffers as the recent traffic calls for are held, so that an idle endpoint does not tie up the pool.
+    for (numBufs = 0; numBufs < mRecvBatchLen; numBufs++)
+    {
+        struct msghdr& msgHeader = msgHeaders[numBufs].msg_hdr;
+
+        if (mRecvBufs[numBufs] == NULL)
+        {
+            mRecvBufs[numBufs] = PacketBuffer::New(0);
+            if (mRecvBufs[numBufs] == NULL)
+                break;
         }
 
+        msgIOVs[numBufs].iov_base = mRecvBufs[numBufs]->Start();
+        msgIOVs[numBufs].iov_len = mRecvBufs[numBufs]->AvailableDataLength();
+
+        memset(&peerSockAddrs[numBufs], 0, sizeof(PeerSockAddr));
+
+        msgHeader.msg_name = &peerSockAddrs[numBufs];
+        msgHeader.msg_namelen = sizeof(PeerSockAddr);
+        msgHeader.msg_iov = &msgIOVs[numBufs];
+        msgHeader.msg_iovlen = 1;
+        msgHeader.msg_control = controlData[numBufs].data;
+        msgHeader.msg_controllen = sizeof(controlData[numBufs].data);
+    }
+
+    VerifyOrExit(numBufs > 0, err = INET_ERROR_NO_MEMORY);
+
+    numRcvd = recvmmsg(mSocket, msgHeaders, numBufs, MSG_DONTWAIT, NULL);
+
+    if (numRcvd < 0)
+    {
+        err = Weave::System::MapErrorPOSIX(errno);
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        // The socket has been drained; wait for the next edge-triggered read event.
+        if (errno == EAGAIN)
+            mReadyIO.ClearRead();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+        ExitNow();
+    }
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    // A non-blocking recvmmsg() only returns a short batch once the socket has been drained.
+    if (static_cast<unsigned int>(numRcvd) < numBufs)
+        mReadyIO.ClearRead();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+    // Double the batch while the socket keeps filling it, otherwise shrink it to one more than what was received.
+    if (static_cast<unsigned int>(numRcvd) == numBufs)
+        mRecvBatchLen = (2 * numBufs < INET_CONFIG_UDP_RECV_BATCH_SIZE) ? 2 * numBufs : INET_CONFIG_UDP_RECV_BATCH_SIZE;
+    else
+        mRecvBatchLen = numRcvd + 1;
+
+    for (int i = 0; i < numRcvd; i++)
+    {
+        PacketBuffer *buf = mRecvBufs[i];
+        IPPacketInfo pktInfo;
+
+        mRecvBufs[i] = NULL;
+
+        pktInfo.Clear();
+        pktInfo.DestPort = mBoundPort;
+
+        if ((msgHeaders[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+            err = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
         else
-            err = INET_ERROR_NO_MEMORY;
+        {
+            buf->SetDataLength((uint16_t) msgHeaders[i].msg_len);
+            err = DecodePacketInfo(msgHeaders[i].msg_hdr, pktInfo);
+        }
 
         if (err == INET_NO_ERROR)
             OnMessageReceived(this, buf, &pktInfo);
         else
         {
             PacketBuffer::Free(buf);
-            if (OnReceiveError != NULL
-                && err != Weave::System::MapErrorPOSIX(EAGAIN)
-            )
+            if (OnReceiveError != NULL)
                 OnReceiveError(this, err, NULL);
         }
+
+        // The application may have closed the endpoint or stopped listening; the rest of the batch is dropped.
+        if (mState != kState_Listening || OnMessageReceived == NULL)
+            break;
     }
 
-    mPendingIO.Clear();
+    if (mState == kState_Listening)
+    {
+        for (unsigned int i = mRecvBatchLen; i < INET_CONFIG_UDP_RECV_BATCH_SIZE; i++)
+        {
+            PacketBuffer::Free(mRecvBufs[i]);
+            mRecvBufs[i] = NULL;
+        }
+    }
+
+    err = INET_NO_ERROR;
+
+exit:
+    if (err != INET_NO_ERROR && OnReceiveError != NULL && err != Weave::System::MapErrorPOSIX(EAGAIN))
+        OnReceiveError(this, err, NULL);
 }
 
+/**
+ *  Append a datagram to the send queue of the endpoint, flushing the queue first if it is full.
+ *
+ *  Where <tt>(sendFlags & kSendFlag_RetainBuffer) != 0</tt>, a copy of \c msg is queued and \c msg is left to the caller,
+ *  otherwise the queue takes ownership of \c msg on success.
+ *
+ *  The endpoint is put on the list of endpoints the Inet layer flushes at the end of the pass through the event loop, and the
+ *  first datagram queued during a pass wakes the loop, so that the queue is flushed before the loop next waits for I/O even
+ *  where the datagram was sent from another thread.
+ *
+ *  @retval INET_NO_ERROR   The datagram was queued.
+ *  @retval other           The datagram was not queued: either the queue is full and the socket would not take any of it, in
+ *                          which case the error of \c EAGAIN is returned as by \c sendto() on a non-blocking socket, or no
+ *                          buffer was available for the copy of a retained message.
+ */
+INET_ERROR UDPEndPoint::QueueSend(PacketBuffer *msg, const PeerSockAddr& peerAddr, socklen_t peerAddrLen, uint16_t sendFlags)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    QueuedSend *entry;
+
+    // Errors of the datagrams flushed here are reported at the end of the pass, not to this caller.
+    if (mSendQueueLen == INET_CONFIG_UDP_SEND_BATCH_SIZE)
+        FlushSendQueue();
+
+    VerifyOrExit(mSendQueueLen < INET_CONFIG_UDP_SEND_BATCH_SIZE, err = Weave::System::MapErrorPOSIX(EAGAIN));
+
+    if ((sendFlags & kSendFlag_RetainBuffer) != 0)
+    {
+        PacketBuffer *copy = PacketBuffer::New(0);
+
+        VerifyOrExit(copy != NULL, err = INET_ERROR_NO_MEMORY);
+
+        if (copy->AvailableDataLength() < msg->DataLength())
+        {
+            PacketBuffer::Free(copy);
+            ExitNow(err = INET_ERROR_MESSAGE_TOO_LONG);
+        }
+
+        memcpy(copy->Start(), msg->Start(), msg->DataLength());
+        copy->SetDataLength(msg->DataLength());
+        msg = copy;
+    }
+
+    entry = &mSendQueue[mSendQueueLen++];
+    entry->Msg = msg;
+    entry->PeerAddr = peerAddr;
+    entry->PeerAddrLen = peerAddrLen;
+
+    LinkPendingSend();
+
+    if (mSendQueueLen == 1)
+        RefreshIO();
+
+exit:
+    return err;
+}
+
+/**
+ *  Send the datagrams in the send queue of the endpoint with as few \c sendmmsg() calls as possible.
+ *
+ *  Where the socket would block (\c EAGAIN) or the system is out of buffers (\c ENOBUFS), sending stops and the unsent datagrams
+ *  stay queued, in order, until the socket is next writable. A datagram the system refuses for any other reason is logged and
+ *  dropped, the first such error is kept for ReportSendError(), and sending continues with the next datagram.
+ */
+void UDPEndPoint::FlushSendQueue(void)
+{
+    struct mmsghdr msgHeaders[INET_CONFIG_UDP_SEND_BATCH_SIZE];
+    struct iovec msgIOVs[INET_CONFIG_UDP_SEND_BATCH_SIZE];
+    unsigned int numDone = 0;
+
+    if (mSendQueueLen == 0)
+        return;
+
+    memset(msgHeaders, 0, sizeof(msgHeaders));
+
+    for (unsigned int i = 0; i < mSendQueueLen; i++)
+    {
+        struct msghdr& msgHeader = msgHeaders[i].msg_hdr;
+
+        msgIOVs[i].iov_base = mSendQueue[i].Msg->Start();
+        msgIOVs[i].iov_len = mSendQueue[i].Msg->DataLength();
+
+        msgHeader.msg_name = &mSendQueue[i].PeerAddr;
+        msgHeader.msg_namelen = mSendQueue[i].PeerAddrLen;
+        msgHeader.msg_iov = &msgIOVs[i];
+        msgHeader.msg_iovlen = 1;
+    }
+
+    while (numDone < mSendQueueLen)
+    {
+        int res = sendmmsg(mSocket, &msgHeaders[numDone], mSendQueueLen - numDone, 0);
+
+        if (res < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+            {
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                // The socket send buffer is full; wait for the next edge-triggered write event.
+                if (errno != ENOBUFS)
+                    mReadyIO.ClearWrite();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+                break;
+            }
+
+            WeaveLogError(Inet, "sendmmsg: %d", errno);
+
+            if (mSendError == INET_NO_ERROR)
+                mSendError = Weave::System::MapErrorPOSIX(errno);
+
+            res = 1;
+        }
+
+        numDone += res;
+    }
+
+    for (unsigned int i = 0; i < numDone; i++)
+    {
+        PacketBuffer::Free(mSendQueue[i].Msg);
+        mSendQueue[i].Msg = NULL;
+    }
+
+    mSendQueueLen -= numDone;
+    memmove(&mSendQueue[0], &mSendQueue[numDone], mSendQueueLen * sizeof(mSendQueue[0]));
+}
+
+/**
+ *  Report the first error of the datagrams refused since the last report to the \c OnReceiveError delegate, in the manner of an
+ *  asynchronous socket error. The delegate may close the endpoint.
+ */
+void UDPEndPoint::ReportSendError(void)
+{
+    const INET_ERROR err = mSendError;
+
+    mSendError = INET_NO_ERROR;
+
+    if (err != INET_NO_ERROR && OnReceiveError != NULL)
+        OnReceiveError(this, err, NULL);
+}
+
+void UDPEndPoint::LinkPendingSend(void)
+{
+    if (mPrevPendingSendLink == NULL)
+    {
+        InetLayer& lInetLayer = Layer();
+
+        mNextPendingSend = lInetLayer.mPendingSendEndPoints;
+        if (mNextPendingSend != NULL)
+            mNextPendingSend->mPrevPendingSendLink = &mNextPendingSend;
+        mPrevPendingSendLink = &lInetLayer.mPendingSendEndPoints;
+        lInetLayer.mPendingSendEndPoints = this;
+    }
+}
+
+void UDPEndPoint::UnlinkPendingSend(void)
+{
+    if (mPrevPendingSendLink != NULL)
+    {
+        *mPrevPendingSendLink = mNextPendingSend;
+        if (mNextPendingSend != NULL)
+            mNextPendingSend->mPrevPendingSendLink = mPrevPendingSendLink;
+        mNextPendingSend = NULL;
+        mPrevPendingSendLink = NULL;
+    }
+}
+
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
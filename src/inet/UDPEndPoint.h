@@ -33,6 +33,10 @@
 
 #include <SystemLayer/SystemPacketBuffer.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+struct sock_filter;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 namespace nl {
 namespace Inet {
 
@@ -201,6 +205,33 @@ public:
      */
     INET_ERROR BindInterface(IPAddressType addrType, InterfaceId intf);
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    /**
+     * @brief   Steer datagrams among the sockets sharing the bound port.
+     *
+     * @param[in]   filter      the classic BPF program selecting a socket
+     * @param[in]   filterLen   the number of instructions in \c filter
+     *
+     * @retval  INET_NO_ERROR               success: program attached.
+     * @retval  INET_ERROR_INCORRECT_STATE  endpoint is not bound.
+     * @retval  INET_ERROR_NOT_IMPLEMENTED  the system cannot steer datagrams.
+     *
+     * @retval  other                   another system or platform error
+     *
+     * @details
+     *  Attaches \c filter with \c SO_ATTACH_REUSEPORT_CBPF to the group of
+     *  \c SO_REUSEPORT sockets bound to the same address and port as the
+     *  endpoint, replacing any program attached before. For each datagram,
+     *  the program runs with the UDP payload as its packet data and returns
+     *  the number of the receiving socket in the group. The system numbers
+     *  the sockets in the order they were bound and, when one is closed,
+     *  gives its number to the last one, so the caller must follow these
+     *  changes and attach a new program for them. Any number out of range
+     *  leaves the choice to the system hash of the addresses and ports.
+     */
+    INET_ERROR SetReusePortFilter(const struct sock_filter *filter, uint16_t filterLen);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
     /**
      * @brief   Close the endpoint.
      *
@@ -268,7 +299,7 @@ private:
     UDPEndPoint(const UDPEndPoint&);                    // not defined
     ~UDPEndPoint(void);                                 // not defined
 
-    static Weave::System::ObjectPool<UDPEndPoint, INET_CONFIG_NUM_UDP_ENDPOINTS> sPool;
+    static Weave::System::LayerObjectPool<UDPEndPoint, INET_CONFIG_NUM_UDP_ENDPOINTS> sPool;
 
     void Init(InetLayer *inetLayer);
 
@@ -290,6 +321,39 @@ private:
     INET_ERROR GetSocket(IPAddressType addrType);
     SocketEvents PrepareIO(void);
     void HandlePendingIO(void);
+    union PeerSockAddr
+    {
+        sockaddr any;
+        sockaddr_in in;
+        sockaddr_in6 in6;
+    };
+
+    static INET_ERROR DecodePacketInfo(const struct msghdr& msgHeader, IPPacketInfo& pktInfo);
+
+#if INET_CONFIG_ENABLE_UDP_BATCHED_IO
+
+    struct QueuedSend
+    {
+        Weave::System::PacketBuffer *Msg;
+        PeerSockAddr PeerAddr;
+        socklen_t PeerAddrLen;
+    };
+
+    Weave::System::PacketBuffer *mRecvBufs[INET_CONFIG_UDP_RECV_BATCH_SIZE];
+    unsigned int mRecvBatchLen;
+    QueuedSend mSendQueue[INET_CONFIG_UDP_SEND_BATCH_SIZE];
+    unsigned int mSendQueueLen;
+    INET_ERROR mSendError;
+    UDPEndPoint *mNextPendingSend;              /**< Next endpoint in the InetLayer list of endpoints with queued datagrams. */
+    UDPEndPoint **mPrevPendingSendLink;         /**< Link pointing at this endpoint in that list, or NULL if not listed. */
+
+    void ReceiveBatch(void);
+    INET_ERROR QueueSend(Weave::System::PacketBuffer *msg, const PeerSockAddr& peerAddr, socklen_t peerAddrLen, uint16_t sendFlags);
+    void FlushSendQueue(void);
+    void ReportSendError(void);
+    void LinkPendingSend(void);
+    void UnlinkPendingSend(void);
+#endif // INET_CONFIG_ENABLE_UDP_BATCHED_IO
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 };
 
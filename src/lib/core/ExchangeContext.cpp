@@ -422,7 +422,7 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
     }
 
     // Abort early if Throttle is already set;
-    VerifyOrExit(mWRMPThrottleTimeout == 0, err = WEAVE_ERROR_SEND_THROTTLED);
+    VerifyOrExit(mWRMPThrottleTimeout <= System::Timer::GetCurrentEpoch(), err = WEAVE_ERROR_SEND_THROTTLED);
 
 #else // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
@@ -563,7 +563,7 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
             SuccessOrExit(err);
 
             WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMDoubleTx,
-                               entry->nextRetransTime = 0;
+                               ExchangeMgr->WRMPSetRetransTime(entry, System::Timer::GetCurrentEpoch());
                                ExchangeMgr->WRMPStartTimer()
                                );
 
@@ -708,14 +708,12 @@ WEAVE_ERROR ExchangeContext::EncodeExchHeader(WeaveExchangeHeader *exchangeHeade
         //     to avoid piggybacking uninitialized AckId.
         if (HasPeerRequestedAck())
         {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            ExchangeMgr->WRMPExpireTicks();
-
             exchangeHeader->Flags |= kWeaveExchangeFlag_AckId;
             exchangeHeader->AckMsgId = mPendingPeerAckId;
 
             //Set AckPending flag to false after setting the Ack flag;
             SetAckPending(false);
+            ExchangeMgr->WRMPCancelAckTime(this);
 
             // Schedule next physical wakeup
             ExchangeMgr->WRMPStartTimer();
@@ -771,9 +769,6 @@ void ExchangeContext::DoClose(bool clearRetransTable)
     OnKeyError = NULL;
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
-
     OnThrottleRcvd = NULL;
     OnDDRcvd = NULL;
     OnSendError = NULL;
@@ -861,7 +856,7 @@ void ExchangeContext::Release(void)
         mRefCount = 0;
         ExchangeMgr = NULL;
 
-        em->mContextsInUse--;
+        em->FreeContext(this);
         em->MessageLayer->SignalMessageLayerActivityChanged();
 #if defined(WEAVE_EXCHANGE_CONTEXT_DETAIL_LOGGING)
         WeaveLogProgress(ExchangeManager, "ec-- id: %d [%04" PRIX16 "], inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(this - em->ContextPool), tmpid,  em->mContextsInUse, this);
@@ -1120,16 +1115,17 @@ bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtx
 {
     bool res = false;
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    for (uint32_t next = mWRMPRetransList; next != 0; next = ExchangeMgr->RetransTable[next - 1].nextForContext)
     {
-        if ((ExchangeMgr->RetransTable[i].exchContext == this) &&
-            (ExchangeMgr->RetransTable[i].msgId == ackMsgId))
+        WeaveExchangeManager::RetransTableEntry &entry = ExchangeMgr->RetransTable[next - 1];
+
+        if (entry.msgId == ackMsgId)
         {
             //Return context value
-            *rCtxt = ExchangeMgr->RetransTable[i].msgCtxt;
+            *rCtxt = entry.msgCtxt;
 
             //Clear the entry from the retransmision table.
-            ExchangeMgr->ClearRetransmitTable(ExchangeMgr->RetransTable[i]);
+            ExchangeMgr->ClearRetransmitTable(entry);
 
 #if defined(DEBUG)
             WeaveLogProgress(ExchangeManager, "Rxd Ack; Removing MsgId:%08" PRIX32 " from Retrans Table",
@@ -1138,10 +1134,6 @@ bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtx
             res = true;
             break;
         }
-        else
-        {
-            continue;
-        }
     }
 
     return res;
@@ -1346,9 +1338,6 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
 {
     WEAVE_ERROR  err = WEAVE_NO_ERROR;
 
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
-
     // If the message IS a duplicate.
     if (msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage)
     {
@@ -1374,6 +1363,7 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
             // Restore previously pending ack id.
             mPendingPeerAckId = tempAckId;
             SetAckPending(true);
+            ExchangeMgr->WRMPSetAckTime(this, mWRMPNextAckTime);
         }
 
         SuccessOrExit(err);
@@ -1394,7 +1384,7 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
 
         // Replace the Pending ack id.
         mPendingPeerAckId = msgInfo->MessageId;
-        mWRMPNextAckTime = ExchangeMgr->GetTickCounterFromTimeDelta(mWRMPConfig.mAckPiggybackTimeout + System::Timer::GetCurrentEpoch(), ExchangeMgr->mWRMPTimeStampBase);
+        ExchangeMgr->WRMPSetAckTime(this, System::Timer::GetCurrentEpoch() + mWRMPConfig.mAckPiggybackTimeout);
         SetAckPending(true);
     }
 
@@ -1406,41 +1396,35 @@ exit:
 
 WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
+    const uint64_t now = System::Timer::GetCurrentEpoch();
 
     // Flow Control Message Received; Adjust Throttle timeout accordingly.
     // A PauseTimeMillis of zero indicates that peer is unthrottling this Exchange.
 
     if (0 != PauseTimeMillis)
     {
-        mWRMPThrottleTimeout = ExchangeMgr->GetTickCounterFromTimeDelta((System::Timer::GetCurrentEpoch() + PauseTimeMillis),
-                                                                        ExchangeMgr->mWRMPTimeStampBase);
+        mWRMPThrottleTimeout = now + PauseTimeMillis;
     }
     else
     {
         mWRMPThrottleTimeout = 0;
     }
 
-    // Go through the retrans table entries for that node and adjust the timer.
+    // Go through the retrans table entries for this exchange and adjust the timer.
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    for (uint32_t next = mWRMPRetransList; next != 0; next = ExchangeMgr->RetransTable[next - 1].nextForContext)
     {
-        // Check if ExchangeContext matches
+        WeaveExchangeManager::RetransTableEntry &entry = ExchangeMgr->RetransTable[next - 1];
 
-        if (ExchangeMgr->RetransTable[i].exchContext == this)
+        // Adjust the retrans timer value to account for throttling.
+        if (0 != PauseTimeMillis)
         {
-            // Adjust the retrans timer value to account for throttling.
-            if (0 != PauseTimeMillis)
-            {
-                ExchangeMgr->RetransTable[i].nextRetransTime += PauseTimeMillis / ExchangeMgr->mWRMPTimerInterval;
-            }
-            // UnThrottle when PauseTimeMillis is set to 0
-            else
-            {
-                ExchangeMgr->RetransTable[i].nextRetransTime = 0;
-            }
-            break;
+            ExchangeMgr->WRMPSetRetransTime(&entry, entry.nextRetransTime + PauseTimeMillis);
+        }
+        // UnThrottle when PauseTimeMillis is set to 0
+        else
+        {
+            ExchangeMgr->WRMPSetRetransTime(&entry, now);
         }
     }
     // Call OnThrottleRcvd application callback
@@ -135,6 +135,89 @@
 #define WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT 1
 #endif // WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT
 
+/**
+ *  @def WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+ *
+ *  @brief
+ *      Compile support for windowed (pipelined) V1 transfers.
+ *
+ *  When enabled, a transfer whose mIsWindowed flag is set proposes
+ *      a windowed transfer, and a node accepts one when its peer
+ *      proposes it.  The sender then keeps up to
+ *      #WEAVE_CONFIG_BDX_WINDOW_SIZE blocks in flight instead of
+ *      waiting for each block to be acknowledged.  Set to 0 to save
+ *      code space and the per-transfer window state.
+ */
+#ifndef WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+#define WEAVE_CONFIG_BDX_WINDOWED_SUPPORT 1
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
+/**
+ *  @def WEAVE_CONFIG_BDX_WINDOW_SIZE
+ *
+ *  @brief
+ *      Maximum number of blocks in flight during a windowed transfer.
+ *
+ *  A sender holds a copy of each unacknowledged block so that it can
+ *      be retransmitted, and a receiver holds blocks that arrive ahead
+ *      of a missing one, so a transfer may pin up to this many
+ *      PacketBuffers, plus those the message layer retains for WRMP
+ *      retransmission over UDP.  The two peers need not agree on the value: a
+ *      receiver with a smaller window discards blocks beyond it and
+ *      they are requested again.
+ */
+#ifndef WEAVE_CONFIG_BDX_WINDOW_SIZE
+#define WEAVE_CONFIG_BDX_WINDOW_SIZE 4
+#endif // WEAVE_CONFIG_BDX_WINDOW_SIZE
+
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT && (WEAVE_CONFIG_BDX_WINDOW_SIZE < 2)
+#error "WEAVE_CONFIG_BDX_WINDOW_SIZE must be at least 2 when WEAVE_CONFIG_BDX_WINDOWED_SUPPORT is enabled"
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT && (WEAVE_CONFIG_BDX_WINDOW_SIZE < 2)
+
+/**
+ *  @def WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+ *
+ *  @brief
+ *      Compile support for sending files straight from a memory mapping.
+ *
+ *  When enabled, BDXTransfer::SetFileSource() maps a file with
+ *      mmap() and the transfer's blocks are copied out of the mapping
+ *      instead of being requested from the GetBlockHandler.  A file
+ *      is mapped once and shared by every transfer that sends it,
+ *      so it must be updated by renaming a new file over it rather
+ *      than being rewritten or truncated in place; a transfer whose
+ *      file changes under it fails.  Requires POSIX mmap() support,
+ *      so it is enabled by default only where sockets are in use.
+ */
+#ifndef WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+#define WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT (WEAVE_SYSTEM_CONFIG_USE_SOCKETS)
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+/**
+ *  @def WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES
+ *
+ *  @brief
+ *      Number of files that can be mapped for sending at once.
+ *
+ *  A mapping is kept after its last transfer finishes, so that
+ *      the next request for the same file reuses it; it is unmapped
+ *      when its slot is needed for another file.
+ */
+#ifndef WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES
+#define WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES 4
+#endif // WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES
+
+/**
+ *  @def WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD
+ *
+ *  @brief
+ *      Number of bytes ahead of a transfer that the kernel is asked
+ *      to read into the page cache when sending from a mapped file.
+ */
+#ifndef WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD
+#define WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD 65536
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD
+
 /**
  *  @def WEAVE_CONFIG_BDX_SEND_INIT_MAX_METADATA_BYTES
  *
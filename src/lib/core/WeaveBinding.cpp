@@ -702,7 +702,7 @@ void Binding::PrepareSecurity()
     // Default encryption type, if not specified.
     if (kSecurityOption_None != mSecurityOption && kWeaveEncryptionType_None == mEncType)
     {
-        mEncType = kWeaveEncryptionType_AES128CTRSHA1;
+        mEncType = WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE;
     }
 
     switch (mSecurityOption)
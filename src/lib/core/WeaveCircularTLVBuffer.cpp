@@ -68,6 +68,40 @@ WeaveCircularTLVBuffer::WeaveCircularTLVBuffer(uint8_t *inBuffer, size_t inBuffe
 }
 
 
+/**
+ * @brief
+ *   Restores the queue state over data already present in the buffer
+ *
+ * This function is used when the underlying storage outlives the
+ * WeaveCircularTLVBuffer, e.g. when it is backed by a file.  The
+ * queue is set to hold the inDataLength bytes beginning at
+ * inHeadOffset, wrapping around the end of the storage.  The contents
+ * are not validated.
+ *
+ *  @param[in] inHeadOffset  The offset of the oldest element within the
+ *                           buffer.
+ *
+ *  @param[in] inDataLength  The number of bytes held in the queue.
+ *
+ *  @retval #WEAVE_NO_ERROR On success.
+ *
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT If the offset or the length
+ *                         fall outside of the buffer.  The queue
+ *                         remains unchanged.
+ */
+WEAVE_ERROR WeaveCircularTLVBuffer::Restore(size_t inHeadOffset, size_t inDataLength)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit((inHeadOffset < mQueueSize) && (inDataLength <= mQueueSize), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    mQueueHead   = mQueue + inHeadOffset;
+    mQueueLength = inDataLength;
+
+exit:
+    return err;
+}
+
 /**
  * @brief
  *   Evicts the oldest top-level TLV element in the WeaveCircularTLVBuffer
@@ -64,12 +64,14 @@ public:
     WEAVE_ERROR GetNextBuffer(TLVReader& ioReader, const uint8_t *& outBufStart, uint32_t& outBufLen);
 
     inline uint8_t *QueueHead(void) { return mQueueHead; };
+    inline size_t QueueHeadOffset(void) { return mQueueHead - mQueue; }
     inline uint8_t *QueueTail(void) { return mQueue + (((mQueueHead-mQueue) + mQueueLength) % mQueueSize); }
     inline size_t DataLength(void) { return mQueueLength; }
     inline size_t AvailableDataLength(void) { return mQueueSize - mQueueLength; }
     inline size_t GetQueueSize(void) { return mQueueSize; }
 
     WEAVE_ERROR EvictHead(void);
+    WEAVE_ERROR Restore(size_t inHeadOffset, size_t inDataLength);
 
     static WEAVE_ERROR GetNewBufferFunct(TLVWriter& ioWriter, uintptr_t& inBufHandle, uint8_t *& outBufStart, uint32_t& outBufLen);
     static WEAVE_ERROR FinalizeBufferFunct(TLVWriter& ioWriter, uintptr_t inBufHandle, uint8_t *inBufStart, uint32_t inBufLen);
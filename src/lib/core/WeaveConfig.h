@@ -914,11 +914,21 @@
  *    Maximum number of peer nodes that the local node can communicate
  *    with.
  *
+ *    This sizes the peer state table (message counters of unencrypted
+ *    and group key messages) that is statically allocated inside each
+ *    WeaveFabricState.  A larger table may be requested at run time
+ *    with WeaveFabricState::Init(groupKeyStore, maxPeerNodes,
+ *    maxSessionKeys), in which case it is allocated from the heap.
+ *
  */
 #ifndef WEAVE_CONFIG_MAX_PEER_NODES
 #define WEAVE_CONFIG_MAX_PEER_NODES                         128
 #endif // WEAVE_CONFIG_MAX_PEER_NODES
 
+#if WEAVE_CONFIG_MAX_PEER_NODES <= 0 || WEAVE_CONFIG_MAX_PEER_NODES >= 65535
+#error "Weave SDK requires 0 < WEAVE_CONFIG_MAX_PEER_NODES < 65535"
+#endif // WEAVE_CONFIG_MAX_PEER_NODES <= 0 || WEAVE_CONFIG_MAX_PEER_NODES >= 65535
+
 /**
  *  @def WEAVE_CONFIG_MAX_CONNECTIONS
  *
@@ -947,11 +957,20 @@
  *  @brief
  *    Maximum number of simultaneously active session keys.
  *
+ *    This sizes the session key table that is statically allocated
+ *    inside each WeaveFabricState.  A larger table may be requested at
+ *    run time with WeaveFabricState::Init(groupKeyStore, maxPeerNodes,
+ *    maxSessionKeys), in which case it is allocated from the heap.
+ *
  */
 #ifndef WEAVE_CONFIG_MAX_SESSION_KEYS
 #define WEAVE_CONFIG_MAX_SESSION_KEYS                       WEAVE_CONFIG_MAX_CONNECTIONS
 #endif // WEAVE_CONFIG_MAX_SESSION_KEYS
 
+#if WEAVE_CONFIG_MAX_SESSION_KEYS <= 0 || WEAVE_CONFIG_MAX_SESSION_KEYS >= 65535
+#error "Weave SDK requires 0 < WEAVE_CONFIG_MAX_SESSION_KEYS < 65535"
+#endif // WEAVE_CONFIG_MAX_SESSION_KEYS <= 0 || WEAVE_CONFIG_MAX_SESSION_KEYS >= 65535
+
 /**
  *  @def WEAVE_CONFIG_MAX_APPLICATION_EPOCH_KEYS
  *
@@ -1021,6 +1040,25 @@
 #error "Please set WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS to a value greater than zero and smaller than 256."
 #endif // !(WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS > 0 && WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS < 256)
 
+/**
+ *  @def WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+ *
+ *  @brief
+ *    Enable (1) or disable (0) caching of the expanded AES round keys
+ *    and the HMAC inner/outer pad states alongside each session key
+ *    and cached application key.
+ *
+ *    With the cache enabled, securing a message no longer expands the
+ *    AES key or re-hashes the HMAC key pads, at the cost of about
+ *    440 bytes of RAM per key with the OpenSSL AES and SHA-1
+ *    implementations, for each session key and cached application
+ *    key of the fabric state.
+ *
+ */
+#ifndef WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+#define WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES            0
+#endif // WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+
 /**
  *  @name Weave Encrypted Passcode Configuration
  *
@@ -1107,6 +1145,93 @@
 #define WEAVE_CONFIG_DEFAULT_SECURITY_SESSION_IDLE_TIMEOUT           15000
 #endif // WEAVE_CONFIG_DEFAULT_SECURITY_SESSION_IDLE_TIMEOUT
 
+/**
+ *  @def WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS
+ *
+ *  @brief
+ *    The maximum number of CASE, PASE, TAKE or key export interactions that
+ *    the security manager will run concurrently, counting both locally and
+ *    remotely initiated interactions.  Requests beyond this limit fail with
+ *    #WEAVE_ERROR_SECURITY_MANAGER_BUSY.
+ *
+ *  @note The simple security memory allocator supports a single interaction
+ *        at a time, so this value defaults to 1 when
+ *        #WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE is set.
+ *
+ */
+#ifndef WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS
+#if WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE
+#define WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS            1
+#else
+#define WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS            4
+#endif
+#endif // WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS
+
+/**
+ *  @def WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER
+ *
+ *  @brief
+ *    The maximum number of concurrent security manager interactions with any
+ *    single peer node.  This keeps one peer from occupying every slot
+ *    allowed by #WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS.
+ *
+ */
+#ifndef WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER
+#define WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER              1
+#endif // WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER
+
+#if WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS < 1 || WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS > 255
+#error "Weave SDK requires 0 < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS < 256"
+#endif
+
+#if WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER < 1
+#error "Weave SDK requires WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER > 0"
+#endif
+
+#if WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE && WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS > 1
+#error "Weave SDK requires WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS == 1 with WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE"
+#endif
+
+/**
+ *  @def WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS
+ *
+ *  @brief
+ *    The number of worker threads the security manager starts to run CASE
+ *    and PASE public-key operations (ECDH, signature generation and
+ *    verification, certificate validation, J-PAKE) off the Weave event
+ *    thread.  A value of 0 runs these operations inline, as they would
+ *    otherwise be.
+ *
+ *  @note When this value is non-zero, the CASE auth delegate and the
+ *        fabric state's password lookup (used by PASE) may be called from
+ *        a worker thread and must be safe to call concurrently for
+ *        different sessions.  The platform security memory allocator and
+ *        the secure random data source must likewise be thread-safe.  The
+ *        Nest DRBG (#WEAVE_CONFIG_RNG_IMPLEMENTATION_NESTDRBG) serializes
+ *        its callers in this case, and the OpenSSL RNG is thread-safe from
+ *        OpenSSL 1.1.0; a platform RNG
+ *        (#WEAVE_CONFIG_RNG_IMPLEMENTATION_PLATFORM) must provide its own
+ *        locking.
+ *
+ *  @note The platform time alerts (#WEAVE_CONFIG_SECURITY_MGR_TIME_ALERTS_PLATFORM)
+ *        are always raised on the Weave event thread.  With workers, they
+ *        bracket the period during which any operation is in flight:
+ *        OnTimeConsumingCryptoStart() when the first operation is submitted
+ *        and OnTimeConsumingCryptoDone() when the last one has completed.
+ *
+ */
+#ifndef WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS
+#define WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS                     0
+#endif // WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS < 0 || WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 255
+#error "Weave SDK requires 0 <= WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS < 256"
+#endif
+
+#if WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE && WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+#error "Weave SDK requires WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS == 0 with WEAVE_CONFIG_SECURITY_MGR_MEMORY_MGMT_SIMPLE"
+#endif
+
 /**
  *  @def WEAVE_CONFIG_NUM_MESSAGE_BUFS
  *
@@ -1131,17 +1256,34 @@
 #define WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS       32
 #endif // WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
 
+#if WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS <= 0 || WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS >= 65535
+#error "Weave SDK requires 0 < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS < 65535"
+#endif // WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS <= 0 || WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS >= 65535
+
 /**
  *  @def WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
  *
  *  @brief
  *    Maximum number of simultaneously active exchange contexts.
  *
+ *    This sizes the exchange context pool that is statically allocated
+ *    inside each WeaveExchangeManager.  A larger pool may be requested
+ *    at run time with WeaveExchangeManager::Init(msgLayer, maxContexts),
+ *    in which case it is allocated from the heap.
+ *
  */
 #ifndef WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
 #define WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS                  16
 #endif // WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+#if WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 0 || WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS >= 65535
+#error "Weave SDK requires 0 < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS < 65535"
+#endif // WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS <= 0 || WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS >= 65535
+
+#if WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+#error "Weave SDK requires WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE >= WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE"
+#endif // WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+
 /**
  *  @def WEAVE_CONFIG_MAX_BINDINGS
  *
@@ -1180,6 +1322,32 @@
 #define WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS           32
 #endif // WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS
 
+/**
+ *  @def WEAVE_CONFIG_MAX_SHARDS
+ *
+ *  @brief
+ *    Maximum number of message layers of a process sharing the Weave
+ *    port (see WeaveMessageLayer::InitContext::shardCount).
+ *
+ */
+#ifndef WEAVE_CONFIG_MAX_SHARDS
+#define WEAVE_CONFIG_MAX_SHARDS                             16
+#endif // WEAVE_CONFIG_MAX_SHARDS
+
+/**
+ *  @def WEAVE_CONFIG_MAX_SHARD_GROUPS
+ *
+ *  @brief
+ *    Maximum number of distinct addresses, ports and protocols on which
+ *    the sharded message layers of a process share their endpoints,
+ *    i.e. of the groups of endpoints among which incoming messages and
+ *    connections are steered.
+ *
+ */
+#ifndef WEAVE_CONFIG_MAX_SHARD_GROUPS
+#define WEAVE_CONFIG_MAX_SHARD_GROUPS                       (WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS + 8)
+#endif // WEAVE_CONFIG_MAX_SHARD_GROUPS
+
 /**
  *  @def WEAVE_CONFIG_CONNECT_IP_ADDRS
  *
@@ -1429,6 +1597,22 @@
 #endif
 #endif // WEAVE_CONFIG_DEFAULT_CASE_CURVE_ID
 
+/**
+ *  @def WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE
+ *
+ *  @brief
+ *    Message encryption type proposed when initiating a PASE or CASE session, and used by
+ *    bindings that do not specify one.
+ *
+ *    Responders accept any supported type proposed by the initiator.  The default remains
+ *    AES-128-CTR/HMAC-SHA-1 so that initiators interoperate with nodes that predate
+ *    AES-128-GCM (#kWeaveEncryptionType_AES128GCM).
+ *
+ */
+#ifndef WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE
+#define WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE        (nl::Weave::kWeaveEncryptionType_AES128CTRSHA1)
+#endif // WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE
+
 /**
  *  @def WEAVE_CONFIG_DEFAULT_CASE_ALLOWED_CURVES
  *
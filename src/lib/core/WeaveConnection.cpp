@@ -1316,19 +1316,41 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
             // and try again.
             if (data->Next() != NULL)
             {
-                data->CompactHead();
-                continue;
+                // Earlier messages split off the head buffer leave it with less room than a fresh buffer.  If the
+                // message cannot fit in what remains, move the part received so far into a buffer of its own.
+                if (frameLen > data->ReservedSize() + data->MaxDataLength())
+                {
+                    PacketBuffer *msgStartBuf = PacketBuffer::New(0);
+                    if (msgStartBuf != NULL)
+                    {
+                        memcpy(msgStartBuf->Start(), data->Start(), data->DataLength());
+                        msgStartBuf->SetDataLength(data->DataLength());
+                        msgStartBuf->AddToEnd(data->DetachTail());
+                        PacketBuffer::Free(data);
+                        data = msgStartBuf;
+                    }
+                    else
+                        err = WEAVE_ERROR_NO_MEMORY;
+                }
+
+                if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
+                {
+                    data->CompactHead();
+                    continue;
+                }
             }
 
             // Otherwise, we must wait for more data from the peer...
-
-            // Open the receive window just enough to allow the remainder of the message to be received.
-            // This is necessary in the case where the message size exceeds the TCP window size to ensure
-            // the peer has enough window to send us the entire message.
-            uint16_t neededLen = frameLen - data->DataLength();
-            err = endPoint->AckReceive(neededLen);
-            if (err == WEAVE_NO_ERROR)
-                break;
+            if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
+            {
+                // Open the receive window just enough to allow the remainder of the message to be received.
+                // This is necessary in the case where the message size exceeds the TCP window size to ensure
+                // the peer has enough window to send us the entire message.
+                uint16_t neededLen = frameLen - data->DataLength();
+                err = endPoint->AckReceive(neededLen);
+                if (err == WEAVE_NO_ERROR)
+                    break;
+            }
         }
 
         // If we successfully parsed a message, open the TCP receive window by the size of the message.
@@ -1357,14 +1379,17 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
                 payloadBuf->SetDataLength(payloadLen);
             }
 
-            // Otherwise we need to keep the buffer so we can parse the remaining data, so copy the
-            // payload data into a new buffer and arrange to pass the new buffer to the application.
+            // Otherwise we need to keep the buffer so we can parse the remaining data, so split the message
+            // off the front of the buffer, without copying it, and arrange to pass that to the application.  The
+            // message is copied only if the application reuses the buffer to send (see PacketBuffer::EnsureReservedSize()).
             else
             {
-                payloadBuf = PacketBuffer::New(0);
+                const uint16_t payloadOffset = static_cast<uint16_t>(payload - (data->Start() - frameLen));
+
+                payloadBuf = data->SplitConsumed(frameLen);
                 if (payloadBuf != NULL)
                 {
-                    memcpy(payloadBuf->Start(), payload, payloadLen);
+                    payloadBuf->SetStart(payloadBuf->Start() + payloadOffset);
                     payloadBuf->SetDataLength(payloadLen);
                 }
                 else
@@ -1372,6 +1397,7 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
             }
         }
 
+
         // Disconnect if an error occurred.
         if (err != WEAVE_NO_ERROR)
         {
@@ -0,0 +1,275 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a bounded pool of worker threads used to run
+ *      time-consuming cryptographic operations off the Weave event thread.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <Weave/Core/WeaveCryptoWorkerPool.h>
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+#include <time.h>
+#endif
+
+namespace nl {
+namespace Weave {
+
+CryptoWorkerPool::CryptoWorkerPool(void)
+{
+    mSystemLayer = NULL;
+    mEpoch = 0;
+    mNumWorkers = 0;
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    mWorkers = NULL;
+    mQueueHead = NULL;
+    mQueueTail = NULL;
+    mStopping = false;
+#endif
+}
+
+/**
+ *  Initialize the pool and start its worker threads.
+ *
+ *  @param[in] aSystemLayer     The system layer to which job completions are posted.
+ *  @param[in] aNumWorkers      The number of worker threads to start.  If zero, jobs
+ *                              are run inline by Submit().
+ *
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE    If the pool is already initialized.
+ *  @retval #WEAVE_ERROR_NOT_IMPLEMENTED    If worker threads were requested but are not
+ *                                          supported on this platform.
+ *  @retval #WEAVE_ERROR_NO_MEMORY          If the worker table could not be allocated.
+ *  @retval other                           A mapped POSIX error if a thread could not be created.
+ */
+WEAVE_ERROR CryptoWorkerPool::Init(System::Layer &aSystemLayer, uint8_t aNumWorkers)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(mSystemLayer == NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    mSystemLayer = &aSystemLayer;
+    mNumWorkers = 0;
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    if (aNumWorkers > 0)
+    {
+        mWorkers = (pthread_t *) malloc(aNumWorkers * sizeof(pthread_t));
+        VerifyOrExit(mWorkers != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        pthread_mutex_init(&mLock, NULL);
+        pthread_cond_init(&mQueueCond, NULL);
+        mQueueHead = mQueueTail = NULL;
+        mStopping = false;
+
+        for (uint8_t i = 0; i < aNumWorkers; i++)
+        {
+            int res = pthread_create(&mWorkers[i], NULL, WorkerMain, this);
+            VerifyOrExit(res == 0, err = System::MapErrorPOSIX(res));
+            mNumWorkers++;
+        }
+    }
+#else
+    VerifyOrExit(aNumWorkers == 0, err = WEAVE_ERROR_NOT_IMPLEMENTED);
+#endif
+
+exit:
+    if (err != WEAVE_NO_ERROR && err != WEAVE_ERROR_INCORRECT_STATE)
+        Shutdown();
+    return err;
+}
+
+/**
+ *  Stop the worker threads and abandon any outstanding jobs.
+ *
+ *  Jobs that have not yet started are discarded, jobs in progress are allowed to
+ *  finish, and no further OnComplete callbacks are delivered for jobs submitted
+ *  before the call.
+ */
+void CryptoWorkerPool::Shutdown(void)
+{
+    if (mSystemLayer == NULL)
+        return;
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    if (mWorkers != NULL)
+    {
+        pthread_mutex_lock(&mLock);
+        mStopping = true;
+        mQueueHead = mQueueTail = NULL;
+        pthread_cond_broadcast(&mQueueCond);
+        pthread_mutex_unlock(&mLock);
+
+        for (uint8_t i = 0; i < mNumWorkers; i++)
+            pthread_join(mWorkers[i], NULL);
+
+        pthread_cond_destroy(&mQueueCond);
+        pthread_mutex_destroy(&mLock);
+
+        free(mWorkers);
+        mWorkers = NULL;
+    }
+#endif
+
+    // Invalidate any completions still sitting in the event queue.
+    mEpoch++;
+
+    mNumWorkers = 0;
+    mSystemLayer = NULL;
+}
+
+/**
+ *  Submit a job to the pool.
+ *
+ *  When the pool has worker threads the job is queued and its OnComplete callback is
+ *  later invoked from the Weave event loop.  Otherwise the job and its OnComplete
+ *  callback are run before this method returns.  In either case the caller must not
+ *  rely on any state that OnComplete may release once Submit() has been called.
+ *
+ *  @param[in] job      The job to run.  Run and OnComplete must be set.
+ *
+ *  @retval #WEAVE_NO_ERROR                 If the job was accepted.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE    If the pool is not initialized.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT   If the job is missing a callback.
+ */
+WEAVE_ERROR CryptoWorkerPool::Submit(CryptoJob *job)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(mSystemLayer != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(job != NULL && job->Run != NULL && job->OnComplete != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    job->mPool = this;
+    job->mNext = NULL;
+    job->mResult = WEAVE_NO_ERROR;
+    job->mEpoch = mEpoch;
+    job->mDone = 0;
+
+    if (mNumWorkers == 0)
+    {
+        job->mResult = job->Run(job);
+        job->OnComplete(job, job->mResult);
+        ExitNow();
+    }
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    pthread_mutex_lock(&mLock);
+    if (mQueueTail != NULL)
+        mQueueTail->mNext = job;
+    else
+        mQueueHead = job;
+    mQueueTail = job;
+    pthread_cond_signal(&mQueueCond);
+    pthread_mutex_unlock(&mLock);
+#endif
+
+exit:
+    return err;
+}
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+
+void *CryptoWorkerPool::WorkerMain(void *arg)
+{
+    CryptoWorkerPool *pool = static_cast<CryptoWorkerPool *>(arg);
+
+    while (true)
+    {
+        CryptoJob *job;
+
+        pthread_mutex_lock(&pool->mLock);
+        while (!pool->mStopping && pool->mQueueHead == NULL)
+            pthread_cond_wait(&pool->mQueueCond, &pool->mLock);
+        if (pool->mStopping)
+        {
+            pthread_mutex_unlock(&pool->mLock);
+            break;
+        }
+        job = pool->mQueueHead;
+        pool->mQueueHead = job->mNext;
+        if (pool->mQueueHead == NULL)
+            pool->mQueueTail = NULL;
+        pthread_mutex_unlock(&pool->mLock);
+
+        job->mResult = job->Run(job);
+
+        // Publish the result before the completion can be observed by the event thread.
+        __sync_bool_compare_and_swap(&job->mDone, 0, 1);
+
+        pool->PostCompletion(job);
+    }
+
+    return NULL;
+}
+
+void CryptoWorkerPool::PostCompletion(CryptoJob *job)
+{
+    // Longest wait between attempts to post a completion, in milliseconds.
+    enum { kMaxPostBackoffMsec = 256 };
+
+    uint32_t backoffMsec = 1;
+
+    // ScheduleWork() only fails when the system layer is out of timer objects.  Since the
+    // submitter is waiting on this completion, retry rather than drop it, backing off
+    // exponentially so that a worker doesn't spin while the system layer is exhausted.
+    while (mSystemLayer->ScheduleWork(HandleJobComplete, job) != WEAVE_SYSTEM_NO_ERROR)
+    {
+        struct timespec backoff;
+        bool stopping;
+
+        pthread_mutex_lock(&mLock);
+        stopping = mStopping;
+        pthread_mutex_unlock(&mLock);
+
+        if (stopping)
+            break;
+
+        if (backoffMsec == 1)
+            WeaveLogError(SecurityManager, "Crypto worker failed to post completion; retrying");
+
+        backoff.tv_sec = backoffMsec / 1000;
+        backoff.tv_nsec = (backoffMsec % 1000) * 1000000L;
+        nanosleep(&backoff, NULL);
+
+        if (backoffMsec < kMaxPostBackoffMsec)
+            backoffMsec *= 2;
+    }
+}
+
+#endif // WEAVE_CRYPTO_WORKER_POOL_THREADS
+
+void CryptoWorkerPool::HandleJobComplete(System::Layer *aSystemLayer, void *aAppState, System::Error aError)
+{
+    CryptoJob *job = static_cast<CryptoJob *>(aAppState);
+
+    // Ignore completions for jobs submitted before the pool was last shut down, as well as
+    // stale completions for a job object that has since been resubmitted.
+    if (job->mEpoch != job->mPool->mEpoch || !__sync_bool_compare_and_swap(&job->mDone, 1, 0))
+        return;
+
+    job->OnComplete(job, job->mResult);
+}
+
+} // namespace Weave
+} // namespace nl
@@ -0,0 +1,141 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a bounded pool of worker threads used to run
+ *      time-consuming cryptographic operations (signature generation and
+ *      verification, ECDH, certificate validation) off the Weave event
+ *      thread.
+ *
+ */
+
+#ifndef WEAVECRYPTOWORKERPOOL_H_
+#define WEAVECRYPTOWORKERPOOL_H_
+
+#include <Weave/Core/WeaveConfig.h>
+#include <Weave/Core/WeaveError.h>
+#include <SystemLayer/SystemLayer.h>
+
+#include <Weave/Support/NLDLLUtil.h>
+
+/**
+ *  @def WEAVE_CRYPTO_WORKER_POOL_THREADS
+ *
+ *  @brief
+ *    Set when the crypto worker pool is able to start worker threads.  When
+ *    clear, the pool only supports running jobs inline on the calling thread.
+ *
+ */
+#define WEAVE_CRYPTO_WORKER_POOL_THREADS (WEAVE_SYSTEM_CONFIG_POSIX_LOCKING)
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0 && !WEAVE_CRYPTO_WORKER_POOL_THREADS
+#error "Weave SDK requires WEAVE_SYSTEM_CONFIG_POSIX_LOCKING when WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0"
+#endif
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+#include <pthread.h>
+#endif
+
+namespace nl {
+namespace Weave {
+
+class CryptoWorkerPool;
+
+/**
+ *  @class CryptoJob
+ *
+ *  @brief
+ *    A single unit of work submitted to a CryptoWorkerPool.
+ *
+ *    The Run function is called on a worker thread (or inline when the pool
+ *    has no workers) and must only touch state owned by the job.  The
+ *    OnComplete function is always called on the Weave event thread with the
+ *    value returned by Run.  The job object is owned by the submitter and
+ *    must remain valid until OnComplete has been called or the pool has been
+ *    shut down.
+ *
+ */
+class NL_DLL_EXPORT CryptoJob
+{
+    friend class CryptoWorkerPool;
+
+public:
+    typedef WEAVE_ERROR (*RunFunct)(CryptoJob *job);
+    typedef void (*CompleteFunct)(CryptoJob *job, WEAVE_ERROR result);
+
+    RunFunct Run;                       ///< Performs the operation; called on a worker thread.
+    CompleteFunct OnComplete;           ///< Consumes the result; called on the Weave event thread.
+    void *AppState;                     ///< Pointer to submitter-specific state.
+
+private:
+    CryptoWorkerPool *mPool;
+    CryptoJob *mNext;
+    WEAVE_ERROR mResult;
+    uint32_t mEpoch;
+    uint32_t mDone;
+};
+
+/**
+ *  @class CryptoWorkerPool
+ *
+ *  @brief
+ *    A fixed set of worker threads servicing a FIFO queue of CryptoJob
+ *    objects.  Completions are posted back to the System::Layer event queue
+ *    with System::Layer::ScheduleWork().
+ *
+ *    A pool initialized with zero workers runs each job, and its completion,
+ *    synchronously within Submit().
+ *
+ */
+class NL_DLL_EXPORT CryptoWorkerPool
+{
+public:
+    CryptoWorkerPool(void);
+
+    WEAVE_ERROR Init(System::Layer &aSystemLayer, uint8_t aNumWorkers);
+    void Shutdown(void);
+
+    WEAVE_ERROR Submit(CryptoJob *job);
+
+    uint8_t NumWorkers(void) const { return mNumWorkers; }
+
+private:
+    System::Layer *mSystemLayer;
+    uint32_t mEpoch;
+    uint8_t mNumWorkers;
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    pthread_t *mWorkers;
+    pthread_mutex_t mLock;
+    pthread_cond_t mQueueCond;
+    CryptoJob *mQueueHead;
+    CryptoJob *mQueueTail;
+    bool mStopping;
+
+    static void *WorkerMain(void *arg);
+    void PostCompletion(CryptoJob *job);
+#endif
+
+    static void HandleJobComplete(System::Layer *aSystemLayer, void *aAppState, System::Error aError);
+};
+
+} // namespace Weave
+} // namespace nl
+
+#endif /* WEAVECRYPTOWORKERPOOL_H_ */
@@ -297,13 +297,24 @@
  *    in Weave Data Management Next profile.
  *
  */
-#if WDM_PUBLISHER_ENABLE_VIEW
-#error "WDM_PUBLISHER_ENABLE_VIEW is set to 1 but the feature is not yet implemented"
-#endif
 #ifndef WDM_PUBLISHER_ENABLE_VIEW
 #define WDM_PUBLISHER_ENABLE_VIEW 0
 #endif // WDM_PUBLISHER_ENABLE_VIEW
 
+/**
+ *  @def WDM_PUBLISHER_MAX_NUM_VIEW_HANDLERS
+ *
+ *  @brief
+ *    Number of view requests that can be served at the same time
+ *    by a publisher in Weave Data Management Next profile.  A view
+ *    handler is held until the last chunk of the response has been
+ *    sent.
+ *
+ */
+#ifndef WDM_PUBLISHER_MAX_NUM_VIEW_HANDLERS
+#define WDM_PUBLISHER_MAX_NUM_VIEW_HANDLERS 2
+#endif // WDM_PUBLISHER_MAX_NUM_VIEW_HANDLERS
+
 /**
  *  @def WDM_PUBLISHER_MAX_NUM_PATH_GROUPS
  *
@@ -378,13 +389,26 @@
  *
  *  @brief
  *    Determines the maximum number of dirty items that can be stored in the granular trait data
- *    dirty/delete stores. This is a function of the peak # of handles across all trait instances that can be made dirty
- *    within any given evaluation cycle.
+ *    dirty/delete stores. Only handles within dictionaries are kept in these stores; other handles are tracked by
+ *    the per trait instance dirty bitmap (see #WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES). This is a function of the
+ *    peak # of dictionary handles across all trait instances that can be made dirty within any given evaluation cycle.
  */
 #ifndef WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE
 #define WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE  10
 #endif
 
+/**
+ *  @def WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES
+ *
+ *  @brief
+ *    Determines the size of the dirty bitmap kept by every publisher trait instance for the intermediate graph solver,
+ *    i.e. one more than the largest schema handle that can be tracked individually. This should cover the largest trait
+ *    schema published by the device; marking a larger handle dirty logs an error and marks the entire trait instance dirty.
+ */
+#ifndef WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES
+#define WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES  128
+#endif
+
 /**
  *  @def WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET
  *
@@ -423,6 +447,29 @@
 #define WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT 4
 #endif
 
+/**
+ *  @def WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+ *
+ *  @brief
+ *    Size in bytes of the buffer the notification engine uses to cache the data elements it encodes during a single evaluation
+ *    round. Subscribers that need the same trait instance at the same requested version then copy the encoded data element
+ *    instead of having the graph solver and the trait data source encode it again. This is most useful on devices with many
+ *    subscribers to the same traits. Setting this to 0 disables the cache.
+ */
+#ifndef WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE 0
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_MAX_CACHED_DATA_ELEMENTS
+ *
+ *  @brief
+ *    The maximum number of data elements held in the cache described by #WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE.
+ */
+#ifndef WDM_PUBLISHER_MAX_CACHED_DATA_ELEMENTS
+#define WDM_PUBLISHER_MAX_CACHED_DATA_ELEMENTS 8
+#endif
+
 /**
  * The auto-generated schema tables key off this define to enable/disable certain fields in the tables. Enable this for now, but remove this define
  * once it has been similarly removed from the auto-generated code since all products are expected to need dictionary support, so the savings in flash/ram
@@ -177,4 +177,78 @@
 #define WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS 0
 #endif
 
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+ *
+ * @brief
+ *   The number of checkpoints kept per importance buffer.  Each
+ *   checkpoint records where an event of that importance lives in the
+ *   event log, together with its event ID and the accumulated
+ *   timestamps preceding it, so that
+ *   LoggingManagement::FetchEventsSince() can begin decoding at the
+ *   nearest checkpoint rather than at the oldest event.  Checkpoints
+ *   are spaced roughly evenly across the importance buffer.  Setting
+ *   this to 0 disables the index.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE 8
+#endif
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+ *
+ * @brief
+ *   The number of staging rings available to threads that log events
+ *   through LoggingManagement::StageEvent().  A thread that owns a
+ *   ring encodes events into it without entering the logging critical
+ *   section; the staged events are committed to the event log, in the
+ *   order they were staged, on the Weave event loop.  By default, no
+ *   staging rings are allocated.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+#define WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS 0
+#endif
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_STAGING_RING_SIZE
+ *
+ * @brief
+ *   The size, in bytes, of each event staging ring.  An event whose
+ *   encoding, together with its staged metadata, does not fit in the
+ *   free space of the ring is rejected by LoggingManagement::StageEvent().
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_STAGING_RING_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_STAGING_RING_SIZE 2048
+#endif
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+ *
+ * @brief
+ *   Enable event buffers backed by memory-mapped files, see
+ *   nl::Weave::Profiles::DataManagement::PersistentEventBuffer.  Events
+ *   held in such buffers survive a restart of the application without
+ *   being re-encoded.  Requires POSIX mmap() support.  Disabled by
+ *   default.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+#define WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS 0
+#endif
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL
+ *
+ * @brief
+ *   The time, in milliseconds, after logging an event to a persistent
+ *   event buffer within which the event and the buffer state
+ *   describing it are written to stable storage, from a timer on the
+ *   Weave event loop.  Events logged within this window may be lost
+ *   if the application stops.  Events are always written before the
+ *   space of evicted events is reused.  When 0, every event is
+ *   written to stable storage before LogEvent() returns.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL
+#define WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL 1000
+#endif
+
 #endif /* WEAVEEVENTLOGGINGCONFIG_H */
@@ -43,12 +43,35 @@
 #include <SystemLayer/SystemTimer.h>
 #include <SystemLayer/SystemStats.h>
 
+#include <stdlib.h>
+
 namespace nl {
 namespace Weave {
 
 using namespace nl::Weave::Profiles;
 using namespace nl::Weave::Encoding;
 
+/**
+ *  Map a 32-bit hash onto a slot of an index table, using the high bits of the hash.
+ */
+static inline size_t HashToIndexSlot(uint32_t hash, size_t indexSize)
+{
+    return (size_t) (((uint64_t) hash * indexSize) >> 32);
+}
+
+/**
+ *  Advance to the next slot of a linearly probed index table.
+ */
+static inline size_t NextIndexSlot(size_t slot, size_t indexSize)
+{
+    return (slot + 1 < indexSize) ? slot + 1 : 0;
+}
+
+enum
+{
+    kUMHIndexSize = 2 * WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
+};
+
 /**
  *  Constructor for the WeaveExchangeManager class.
  *  It sets the state to kState_NotInitialized.
@@ -61,6 +84,10 @@ using namespace nl::Weave::Encoding;
 WeaveExchangeManager::WeaveExchangeManager()
 {
     State = kState_NotInitialized;
+    mContextPoolHeap = NULL;
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    mRetransTableHeap = NULL;
+#endif
 }
 
 /**
@@ -77,35 +104,121 @@ WeaveExchangeManager::WeaveExchangeManager()
  *
  */
 WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
+{
+    return Init(msgLayer, WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS);
+}
+
+/**
+ *  Initialize the WeaveExchangeManager object with an exchange context
+ *  pool of a given size.
+ *
+ *  Pools of up to #WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS contexts use the
+ *  storage built into the object.  Larger pools, for example for a
+ *  responder that holds thousands of concurrent exchanges, are allocated
+ *  from the heap and released by Shutdown().
+ *
+ *  @param[in]    msgLayer      A pointer to the WeaveMessageLayer object.
+ *
+ *  @param[in]    maxContexts   The maximum number of simultaneously active
+ *                              exchange contexts.
+ *
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE If the state is not equal to
+ *          kState_NotInitialized.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT If maxContexts is zero or too large.
+ *  @retval #WEAVE_ERROR_NO_MEMORY If the context pool could not be allocated.
+ *  @retval #WEAVE_NO_ERROR On success.
+ *
+ */
+WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer, size_t maxContexts)
 {
     if (State != kState_NotInitialized)
         return WEAVE_ERROR_INCORRECT_STATE;
 
+    if (maxContexts == 0 || maxContexts > kMaxContextPoolSize)
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+
+    if (maxContexts <= WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS)
+    {
+        ContextPool = mContextPoolStorage;
+        mContextIndex = mContextIndexStorage;
+        mFreeContexts = mFreeContextStorage;
+    }
+    else
+    {
+        // Carve the pool, its index and its free stack out of a single heap block.
+        mContextPoolHeap = malloc(maxContexts * (sizeof(ExchangeContext) + 3 * sizeof(uint16_t)));
+        if (mContextPoolHeap == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+
+        ContextPool = (ExchangeContext *) mContextPoolHeap;
+        mContextIndex = (uint16_t *) (ContextPool + maxContexts);
+        mFreeContexts = mContextIndex + 2 * maxContexts;
+    }
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    // The WRMP timer heap has room for one deadline per exchange context and per retransmission table entry,
+    // so a context pool larger than the built-in storage also needs a heap-allocated retransmission table.
+    mContextPoolSize = maxContexts;
+    mWRMPTimerHeapLen = 0;
+    mWRMPTimerArmed = false;
+
+    if (mContextPoolHeap == NULL)
+    {
+        RetransTable = mRetransTableStorage;
+        mRetransTableSize = WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE;
+        mFreeRetransEntries = mFreeRetransEntryStorage;
+        mWRMPTimerHeap = mWRMPTimerHeapStorage;
+
+        memset(RetransTable, 0, sizeof(mRetransTableStorage));
+        for (size_t i = 0; i < mRetransTableSize; i++)
+            mFreeRetransEntries[i] = (uint32_t) (mRetransTableSize - 1 - i);
+        mNumFreeRetransEntries = mRetransTableSize;
+    }
+    else
+    {
+        mRetransTableSize = 0;
+        mNumFreeRetransEntries = 0;
+        mWRMPTimerHeap = NULL;
+
+        if (GrowRetransTable(WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE) != WEAVE_NO_ERROR)
+        {
+            free(mContextPoolHeap);
+            mContextPoolHeap = NULL;
+            ContextPool = mContextPoolStorage;
+            mContextIndex = mContextIndexStorage;
+            mFreeContexts = mFreeContextStorage;
+            mContextPoolSize = 0;
+            return WEAVE_ERROR_NO_MEMORY;
+        }
+    }
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
     MessageLayer = msgLayer;
     FabricState = msgLayer->FabricState;
 
     NextExchangeId = GetRandU16();
 
-    memset(ContextPool, 0, sizeof(ContextPool));
+    mContextPoolSize = maxContexts;
+    mContextIndexSize = 2 * maxContexts;
+    memset(ContextPool, 0, mContextPoolSize * sizeof(ExchangeContext));
+    memset(mContextIndex, 0, mContextIndexSize * sizeof(uint16_t));
     mContextsInUse = 0;
 
+    // Stack the free contexts so that the lowest pool positions are handed out first.
+    for (size_t i = 0; i < mContextPoolSize; i++)
+        mFreeContexts[i] = (uint16_t) (mContextPoolSize - 1 - i);
+    mNumFreeContexts = mContextPoolSize;
+
     InitBindingPool();
 
     memset(UMHandlerPool, 0, sizeof(UMHandlerPool));
+    memset(mUMHandlerIndex, 0, sizeof(mUMHandlerIndex));
     OnExchangeContextChanged = NULL;
 
     msgLayer->ExchangeMgr = this;
     msgLayer->OnMessageReceived = HandleMessageReceived;
     msgLayer->OnAcceptError = HandleAcceptError;
 
-#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    mWRMPTimerInterval  = WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD;       //WRMP Timer tick period
-
-    memset(RetransTable, 0, sizeof(RetransTable));
-
-    mWRMPTimeStampBase = System::Timer::GetCurrentEpoch();
-#endif
-
     State = kState_Initialized;
 
     return WEAVE_NO_ERROR;
@@ -138,10 +251,12 @@ WEAVE_ERROR WeaveExchangeManager::Shutdown()
         WRMPStopTimer();
 
         //Clear the retransmit table
-        for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+        for (size_t i = 0; i < mRetransTableSize; i++)
         {
             ClearRetransmitTable(RetransTable[i]);
         }
+
+        WRMPStopTimer();
 #endif
         MessageLayer = NULL;
     }
@@ -150,6 +265,34 @@ WEAVE_ERROR WeaveExchangeManager::Shutdown()
 
     FabricState = NULL;
 
+    if (mContextPoolHeap != NULL)
+    {
+        free(mContextPoolHeap);
+        mContextPoolHeap = NULL;
+
+        ContextPool = mContextPoolStorage;
+        mContextIndex = mContextIndexStorage;
+        mFreeContexts = mFreeContextStorage;
+        mContextPoolSize = 0;
+        mContextIndexSize = 0;
+        mNumFreeContexts = 0;
+    }
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    if (mRetransTableHeap != NULL)
+    {
+        free(mRetransTableHeap);
+        mRetransTableHeap = NULL;
+
+        RetransTable = mRetransTableStorage;
+        mFreeRetransEntries = mFreeRetransEntryStorage;
+        mWRMPTimerHeap = mWRMPTimerHeapStorage;
+        mRetransTableSize = 0;
+        mNumFreeRetransEntries = 0;
+        mWRMPTimerHeapLen = 0;
+    }
+#endif
+
     State = kState_NotInitialized;
 
     return WEAVE_NO_ERROR;
@@ -220,6 +363,7 @@ ExchangeContext *WeaveExchangeManager::NewContext(const uint64_t &peerNodeId, co
         ec->PeerIntf = sendIntfId;
         ec->AppState = appState;
         ec->SetInitiator(true);
+        IndexContext(ec);
         //Initialize WRMP variables
         ec->mMsgProtocolVersion = 0;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -284,7 +428,7 @@ ExchangeContext *WeaveExchangeManager::NewContext(WeaveConnection *con, void *ap
 ExchangeContext *WeaveExchangeManager::FindContext(uint64_t peerNodeId, WeaveConnection *con, void *appState, bool isInitiator)
 {
     ExchangeContext *ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    for (size_t i = 0; i < mContextPoolSize; i++, ec++)
         if (ec->ExchangeMgr != NULL && ec->PeerNodeId == peerNodeId &&
             ec->Con == con && ec->AppState == appState &&
             ec->IsInitiator() == isInitiator)
@@ -499,7 +643,7 @@ void WeaveExchangeManager::HandleConnectionClosed(WeaveConnection *con, WEAVE_ER
     }
 
     ExchangeContext *ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    for (size_t i = 0; i < mContextPoolSize; i++, ec++)
         if (ec->ExchangeMgr != NULL && ec->Con == con)
         {
             ec->HandleConnectionClosed(conErr);
@@ -510,6 +654,7 @@ void WeaveExchangeManager::HandleConnectionClosed(WeaveConnection *con, WEAVE_ER
         if (umh->Handler != NULL && umh->Con == con)
         {
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
+            UnindexUMH(umh);
             umh->Handler = NULL;
         }
 }
@@ -525,7 +670,7 @@ size_t WeaveExchangeManager::ExpireExchangeTimers(void)
 {
     size_t retval = 0;
     ExchangeContext *ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    for (size_t i = 0; i < mContextPoolSize; i++, ec++)
     {
         if (ec->ExchangeMgr != NULL)
         {
@@ -544,38 +689,209 @@ size_t WeaveExchangeManager::ExpireExchangeTimers(void)
 
 ExchangeContext *WeaveExchangeManager::AllocContext()
 {
-    ExchangeContext *ec = (ExchangeContext *) ContextPool;
+    ExchangeContext *ec;
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_AllocExchangeContext,
                        return NULL);
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
-        if (ec->ExchangeMgr == NULL)
-        {
-            memset(ec, 0, sizeof(ExchangeContext));
-            ec->ExchangeMgr = this;
-            ec->mRefCount = 1;
-            mContextsInUse++;
-            MessageLayer->SignalMessageLayerActivityChanged();
+    if (mNumFreeContexts > 0)
+    {
+        ec = ContextPool + mFreeContexts[--mNumFreeContexts];
+
+        memset(ec, 0, sizeof(ExchangeContext));
+        ec->ExchangeMgr = this;
+        ec->mRefCount = 1;
+        mContextsInUse++;
+        MessageLayer->SignalMessageLayerActivityChanged();
 #if defined(WEAVE_EXCHANGE_CONTEXT_DETAIL_LOGGING)
-            WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
+        WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
+#endif
+        SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
+
+        return ec;
+    }
+    WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
+    return NULL;
+}
+
+/**
+ *  Return a released ExchangeContext to the free pool and remove it from the exchange index.
+ */
+void WeaveExchangeManager::FreeContext(ExchangeContext *ec)
+{
+    UnindexContext(ec);
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    WRMPCancelAckTime(ec);
 #endif
-            SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
 
+    mFreeContexts[mNumFreeContexts++] = (uint16_t) (ec - ContextPool);
+    mContextsInUse--;
+}
+
+/**
+ *  Return the home slot in the exchange index for a given exchange id and initiator flag.
+ */
+size_t WeaveExchangeManager::GetContextIndexSlot(uint16_t exchangeId, bool isInitiator) const
+{
+    const uint32_t key = (((uint32_t) exchangeId) << 1) | (isInitiator ? 1 : 0);
+
+    return HashToIndexSlot(key * 0x9E3779B1U, mContextIndexSize);
+}
+
+/**
+ *  Add an ExchangeContext to the exchange index.  This must be done once its exchange id and initiator flag are set.
+ */
+void WeaveExchangeManager::IndexContext(ExchangeContext *ec)
+{
+    size_t slot = GetContextIndexSlot(ec->ExchangeId, ec->IsInitiator());
+
+    // The index is twice the size of the pool, so there is always an empty slot.
+    while (mContextIndex[slot] != 0)
+        slot = NextIndexSlot(slot, mContextIndexSize);
+
+    mContextIndex[slot] = (uint16_t) (ec - ContextPool + 1);
+}
+
+/**
+ *  Remove an ExchangeContext from the exchange index, if present.
+ */
+void WeaveExchangeManager::UnindexContext(ExchangeContext *ec)
+{
+    const uint16_t entry = (uint16_t) (ec - ContextPool + 1);
+    size_t slot = GetContextIndexSlot(ec->ExchangeId, ec->IsInitiator());
+    size_t next;
+
+    while (mContextIndex[slot] != entry)
+    {
+        if (mContextIndex[slot] == 0)
+            return;
+        slot = NextIndexSlot(slot, mContextIndexSize);
+    }
+
+    // Shift later entries of the probe run back into the vacated slot, so that lookups never stop short of them.
+    for (next = NextIndexSlot(slot, mContextIndexSize); mContextIndex[next] != 0; next = NextIndexSlot(next, mContextIndexSize))
+    {
+        const ExchangeContext *other = ContextPool + mContextIndex[next] - 1;
+        const size_t home = GetContextIndexSlot(other->ExchangeId, other->IsInitiator());
+
+        // An entry can move back unless its home slot lies cyclically within (slot, next].
+        if ((slot < next) ? (home <= slot || home > next) : (home <= slot && home > next))
+        {
+            mContextIndex[slot] = mContextIndex[next];
+            slot = next;
+        }
+    }
+
+    mContextIndex[slot] = 0;
+}
+
+/**
+ *  Find the ExchangeContext, if any, that a received message belongs to.
+ */
+ExchangeContext *WeaveExchangeManager::FindContextForMessage(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+        const WeaveExchangeHeader *exchangeHeader)
+{
+    // A message sent by the initiator of an exchange belongs to a responder context, and vice versa.
+    const bool isInitiator = (exchangeHeader->Flags & kWeaveExchangeFlag_Initiator) == 0;
+    size_t slot = GetContextIndexSlot(exchangeHeader->ExchangeId, isInitiator);
+
+    for (; mContextIndex[slot] != 0; slot = NextIndexSlot(slot, mContextIndexSize))
+    {
+        ExchangeContext *ec = ContextPool + mContextIndex[slot] - 1;
+
+        if (ec->ExchangeMgr != NULL && ec->MatchExchange(msgCon, msgInfo, exchangeHeader))
             return ec;
+    }
+
+    return NULL;
+}
+
+/**
+ *  Return the home slot in the unsolicited message handler index for a given profile id and message type.
+ */
+size_t WeaveExchangeManager::GetUMHIndexSlot(uint32_t profileId, int16_t msgType) const
+{
+    const uint32_t hash = ((profileId * 0x9E3779B1U) ^ (uint16_t) msgType) * 0x85EBCA6BU;
+
+    return HashToIndexSlot(hash, kUMHIndexSize);
+}
+
+/**
+ *  Add a registered unsolicited message handler to the handler index.
+ */
+void WeaveExchangeManager::IndexUMH(UnsolicitedMessageHandler *umh)
+{
+    size_t slot = GetUMHIndexSlot(umh->ProfileId, umh->MessageType);
+
+    while (mUMHandlerIndex[slot] != 0)
+        slot = NextIndexSlot(slot, kUMHIndexSize);
+
+    mUMHandlerIndex[slot] = (uint16_t) (umh - UMHandlerPool + 1);
+}
+
+/**
+ *  Remove an unsolicited message handler from the handler index, if present.
+ */
+void WeaveExchangeManager::UnindexUMH(UnsolicitedMessageHandler *umh)
+{
+    const uint16_t entry = (uint16_t) (umh - UMHandlerPool + 1);
+    size_t slot = GetUMHIndexSlot(umh->ProfileId, umh->MessageType);
+    size_t next;
+
+    while (mUMHandlerIndex[slot] != entry)
+    {
+        if (mUMHandlerIndex[slot] == 0)
+            return;
+        slot = NextIndexSlot(slot, kUMHIndexSize);
+    }
+
+    // Shift later entries of the probe run back into the vacated slot, as in UnindexContext().
+    for (next = NextIndexSlot(slot, kUMHIndexSize); mUMHandlerIndex[next] != 0; next = NextIndexSlot(next, kUMHIndexSize))
+    {
+        const UnsolicitedMessageHandler *other = UMHandlerPool + mUMHandlerIndex[next] - 1;
+        const size_t home = GetUMHIndexSlot(other->ProfileId, other->MessageType);
+
+        if ((slot < next) ? (home <= slot || home > next) : (home <= slot && home > next))
+        {
+            mUMHandlerIndex[slot] = mUMHandlerIndex[next];
+            slot = next;
         }
-    WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
+    }
+
+    mUMHandlerIndex[slot] = 0;
+}
+
+/**
+ *  Find the unsolicited message handler for a received message.  Handlers that explicitly handle the message type
+ *  are preferred over handlers that handle all messages for a profile.
+ */
+WeaveExchangeManager::UnsolicitedMessageHandler *WeaveExchangeManager::FindUMH(uint32_t profileId, int16_t msgType,
+        WeaveConnection *msgCon, bool isDupMsg)
+{
+    const int16_t msgTypes[2] = { msgType, -1 };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        for (size_t slot = GetUMHIndexSlot(profileId, msgTypes[i]); mUMHandlerIndex[slot] != 0;
+             slot = NextIndexSlot(slot, kUMHIndexSize))
+        {
+            UnsolicitedMessageHandler *umh = UMHandlerPool + mUMHandlerIndex[slot] - 1;
+
+            if (umh->Handler != NULL && umh->ProfileId == profileId && umh->MessageType == msgTypes[i]
+                && (umh->Con == NULL || umh->Con == msgCon)
+                && (!isDupMsg || umh->AllowDuplicateMsgs))
+                return umh;
+        }
+    }
+
     return NULL;
 }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64_t DelayedNodeId)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    WRMPExpireTicks();
-
     //Go through the retrans table entries for that node and adjust the timer.
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    for (size_t i = 0; i < mRetransTableSize; i++)
     {
         //Exchcontext is the sentinel object to ascertain validity of the element
         if (RetransTable[i].exchContext)
@@ -585,7 +901,7 @@ void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64
             {
 
                 //Paustime is specified in milliseconds; Update retrans values
-                RetransTable[i].nextRetransTime += (PauseTimeMillis / mWRMPTimerInterval);
+                WRMPSetRetransTime(&RetransTable[i], RetransTable[i].nextRetransTime + PauseTimeMillis);
 
                 //Call the application callback
                 if (RetransTable[i].exchContext->OnDDRcvd)
@@ -622,7 +938,6 @@ static void DefaultOnMessageReceived(ExchangeContext *ec, const IPPacketInfo *pk
 void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
 {
     WeaveExchangeHeader exchangeHeader;
-    UnsolicitedMessageHandler *umh         = NULL;
     UnsolicitedMessageHandler *matchingUMH = NULL;
     ExchangeContext *ec                    = NULL;
     WeaveConnection *msgCon                = NULL;
@@ -721,27 +1036,24 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
 #endif
 
     // Search for an existing exchange that the message applies to. If a match is found...
-    ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    ec = FindContextForMessage(msgCon, msgInfo, &exchangeHeader);
+    if (ec != NULL)
     {
-        if (ec->ExchangeMgr != NULL && ec->MatchExchange(msgCon, msgInfo, &exchangeHeader))
-        {
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-            // Found a matching exchange. Set flag for correct subsequent WRM
-            // retransmission timeout selection.
-            if (!ec->HasRcvdMsgFromPeer())
-            {
-                ec->SetMsgRcvdFromPeer(true);
-            }
+        // Found a matching exchange. Set flag for correct subsequent WRM
+        // retransmission timeout selection.
+        if (!ec->HasRcvdMsgFromPeer())
+        {
+            ec->SetMsgRcvdFromPeer(true);
+        }
 #endif
 
-            //Matched ExchangeContext; send to message handler.
-            ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
+        //Matched ExchangeContext; send to message handler.
+        ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
 
-            msgBuf = NULL;
+        msgBuf = NULL;
 
-            ExitNow(err = WEAVE_NO_ERROR);
-        }
+        ExitNow(err = WEAVE_NO_ERROR);
     }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -757,23 +1069,8 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
     {
         // Search for an unsolicited message handler that can handle the message. Prefer handlers that can explicitly
         // handle the message type over handlers that handle all messages for a profile.
-        umh = (UnsolicitedMessageHandler *) UMHandlerPool;
-
-        matchingUMH = NULL;
-
-        for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
-            if (umh->Handler != NULL && umh->ProfileId == exchangeHeader.ProfileId && (umh->Con == NULL || umh->Con == msgCon)
-                && (!(msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage) || umh->AllowDuplicateMsgs))
-            {
-                if (umh->MessageType == exchangeHeader.MessageType)
-                {
-                    matchingUMH = umh;
-                    break;
-                }
-
-                if (umh->MessageType == -1)
-                    matchingUMH = umh;
-            }
+        matchingUMH = FindUMH(exchangeHeader.ProfileId, exchangeHeader.MessageType, msgCon,
+                              (msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage) != 0);
     }
     // Discard the message if it isn't marked as being sent by an initiator and the message is not a duplicate
     // that needs to send ack to the peer.
@@ -869,6 +1166,8 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
         }
 #endif
 
+        IndexContext(ec);
+
         // Add a reservation for the message encryption key.  This will ensure the key is not removed until the exchange is freed.
         MessageLayer->SecurityMgr->ReserveKey(ec->PeerNodeId, ec->KeyId);
 
@@ -902,16 +1201,13 @@ exit:
 WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgType, WeaveConnection *con, bool allowDups,
         ExchangeContext::MessageReceiveFunct handler, void *appState)
 {
-    UnsolicitedMessageHandler *umh = (UnsolicitedMessageHandler *) UMHandlerPool;
+    UnsolicitedMessageHandler *umh;
     UnsolicitedMessageHandler *selected = NULL;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+
+    for (size_t slot = GetUMHIndexSlot(profileId, msgType); mUMHandlerIndex[slot] != 0; slot = NextIndexSlot(slot, kUMHIndexSize))
     {
-        if (umh->Handler == NULL)
-        {
-            if (selected == NULL)
-                selected = umh;
-        }
-        else if (umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
+        umh = UMHandlerPool + mUMHandlerIndex[slot] - 1;
+        if (umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
         {
             umh->Handler = handler;
             umh->AppState = appState;
@@ -919,9 +1215,22 @@ WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgTyp
         }
     }
 
+    umh = (UnsolicitedMessageHandler *) UMHandlerPool;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+    {
+        if (umh->Handler == NULL)
+        {
+            selected = umh;
+            break;
+        }
+    }
+
     if (selected == NULL)
         return WEAVE_ERROR_TOO_MANY_UNSOLICITED_MESSAGE_HANDLERS;
 
+    // Drop any index entry left behind by an earlier registration of a NULL handler in this slot.
+    UnindexUMH(selected);
+
     selected->Handler = handler;
     selected->AppState = appState;
     selected->ProfileId = profileId;
@@ -929,6 +1238,8 @@ WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgTyp
     selected->MessageType = msgType;
     selected->AllowDuplicateMsgs = allowDups;
 
+    IndexUMH(selected);
+
     SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
 
     return WEAVE_NO_ERROR;
@@ -936,11 +1247,12 @@ WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgTyp
 
 WEAVE_ERROR WeaveExchangeManager::UnregisterUMH(uint32_t profileId, int16_t msgType, WeaveConnection *con)
 {
-    UnsolicitedMessageHandler *umh = (UnsolicitedMessageHandler *) UMHandlerPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+    for (size_t slot = GetUMHIndexSlot(profileId, msgType); mUMHandlerIndex[slot] != 0; slot = NextIndexSlot(slot, kUMHIndexSize))
     {
-        if (umh->Handler != NULL && umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
+        UnsolicitedMessageHandler *umh = UMHandlerPool + mUMHandlerIndex[slot] - 1;
+        if (umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
         {
+            UnindexUMH(umh);
             umh->Handler = NULL;
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
             return WEAVE_NO_ERROR;
@@ -1096,7 +1408,7 @@ void WeaveExchangeManager::NotifyKeyFailed(uint64_t peerNodeId, uint16_t keyId,
 {
     ExchangeContext *ec = (ExchangeContext *) ContextPool;
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    for (size_t i = 0; i < mContextPoolSize; i++, ec++)
     {
         if (ec->ExchangeMgr != NULL && ec->KeyId == keyId && ec->PeerNodeId == peerNodeId)
         {
@@ -1152,7 +1464,7 @@ void WeaveExchangeManager::ClearMsgCounterSyncReq(uint64_t peerNodeId)
     RetransTableEntry *re = (RetransTableEntry *) RetransTable;
 
     // Find all retransmit entries (re) matching peerNodeId and using application group key.
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++, re++)
+    for (size_t i = 0; i < mRetransTableSize; i++, re++)
     {
         if (re->exchContext != NULL && re->exchContext->PeerNodeId == peerNodeId && WeaveKeyId::IsAppGroupKey(re->exchContext->KeyId))
         {
@@ -1176,7 +1488,7 @@ void WeaveExchangeManager::RetransPendingAppGroupMsgs(uint64_t peerNodeId)
     RetransTableEntry *re = (RetransTableEntry *) RetransTable;
 
     // Find all retransmit entries (re) matching peerNodeId and using application group key.
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++, re++)
+    for (size_t i = 0; i < mRetransTableSize; i++, re++)
     {
         if (re->exchContext != NULL && re->exchContext->PeerNodeId == peerNodeId && WeaveKeyId::IsAppGroupKey(re->exchContext->KeyId))
         {
@@ -1190,37 +1502,16 @@ void WeaveExchangeManager::RetransPendingAppGroupMsgs(uint64_t peerNodeId)
     }
 }
 
-/**
-* Return a tick counter value given a time difference and a tick interval.
-* The difference in time is not expected to exceed (2^32 - 1) within the
-* scope of two timestamp comparisons in WRMP and, thus, it makes sense to cast
-* the time delta to uint32_t. This also avoids invocation of 64 bit divisions
-* in constrained platforms that do not support them.
-*
-* @param[in]  newTime        Timestamp value of in milliseconds.
-* @param[in]  oldTime        Timestamp value of in milliseconds.
-* @param[in]  tickInterval   Timer tick interval in milliseconds.
-*
-* @return Tick count for the time delta.
-*/
-uint32_t WeaveExchangeManager::GetTickCounterFromTimeDelta (uint64_t newTime,
-                                                            uint64_t oldTime)
-{
-    uint32_t timeDelta = static_cast<uint32_t>(newTime - oldTime);
-
-    return (timeDelta / mWRMPTimerInterval);
-}
-
 #if defined(WRMP_TICKLESS_DEBUG)
 void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log)
 {
      WeaveLogProgress(ExchangeManager, log);
 
-     for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+     for (size_t i = 0; i < mRetransTableSize; i++)
      {
          if (RetransTable[i].exchContext)
          {
-             WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTimeCtr:%04" PRIX16,
+             WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTime:%" PRIu64,
                               RetransTable[i].exchContext,
                               RetransTable[i].msgId,
                               RetransTable[i].nextRetransTime);
@@ -1232,190 +1523,218 @@ void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log) { retu
 #endif // WRMP_TICKLESS_DEBUG
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
-* If an action needs to be triggered by WRMP time facilities, execute
-* that action.
-*
-*/
-void WeaveExchangeManager::WRMPExecuteActions(void)
+ *  Return the deadline of a WRMP timer.
+ */
+uint64_t WeaveExchangeManager::WRMPGetTimerTime(uint32_t timerId) const
 {
-    ExchangeContext *ec               = NULL;
+    return (timerId < mContextPoolSize) ? ContextPool[timerId].mWRMPNextAckTime :
+                                          RetransTable[timerId - mContextPoolSize].nextRetransTime;
+}
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
+/**
+ *  Return a reference to the field holding the heap position + 1 of a WRMP timer.
+ */
+uint32_t &WeaveExchangeManager::WRMPGetTimerPos(uint32_t timerId)
+{
+    return (timerId < mContextPoolSize) ? ContextPool[timerId].mWRMPAckTimerPos :
+                                          RetransTable[timerId - mContextPoolSize].timerPos;
+}
 
-#if defined(WRMP_TICKLESS_DEBUG)
-    WeaveLogProgress(ExchangeManager, "WRMPExecuteActions");
-#endif
+/**
+ *  Store a WRMP timer at a given heap position.
+ */
+void WeaveExchangeManager::WRMPPlaceTimer(size_t pos, uint32_t timerId)
+{
+    mWRMPTimerHeap[pos] = timerId;
+    WRMPGetTimerPos(timerId) = (uint32_t) (pos + 1);
+}
+
+/**
+ *  Restore the heap order around a WRMP timer whose deadline may have moved in either direction.
+ */
+void WeaveExchangeManager::WRMPSiftTimer(size_t pos)
+{
+    const uint32_t timerId = mWRMPTimerHeap[pos];
+    const uint64_t time = WRMPGetTimerTime(timerId);
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    while (pos > 0)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
-        {
-            if (0 == ec->mWRMPNextAckTime)
-            {
-#if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
-#endif
-                //Send the Ack in a Common::Null message
-                ec->SendCommonNullMessage();
-                ec->SetAckPending(false);
-            }
-        }
-    }
+        const size_t parent = (pos - 1) / 2;
 
-    TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries before processing");
+        if (WRMPGetTimerTime(mWRMPTimerHeap[parent]) <= time)
+            break;
 
-    // Retransmit / cancel anything in the retrans table whose retrans timeout
-    // has expired
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
-    {
-        ec = RetransTable[i].exchContext;
-        if (ec)
-        {
-            WEAVE_ERROR err = WEAVE_NO_ERROR;
+        WRMPPlaceTimer(pos, mWRMPTimerHeap[parent]);
+        pos = parent;
+    }
 
-            if (0 == RetransTable[i].nextRetransTime)
-            {
-                uint8_t sendCount = RetransTable[i].sendCount;
-                void * msgCtxt = RetransTable[i].msgCtxt;
+    while (2 * pos + 1 < mWRMPTimerHeapLen)
+    {
+        size_t child = 2 * pos + 1;
 
-                if (sendCount > ec->mWRMPConfig.mMaxRetrans)
-                {
-                    err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
+        if (child + 1 < mWRMPTimerHeapLen && WRMPGetTimerTime(mWRMPTimerHeap[child + 1]) < WRMPGetTimerTime(mWRMPTimerHeap[child]))
+            child++;
 
-                    WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
-                                  RetransTable[i].msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
+        if (WRMPGetTimerTime(mWRMPTimerHeap[child]) >= time)
+            break;
 
-                    // Remove from Table
-                    ClearRetransmitTable(RetransTable[i]);
-                }
+        WRMPPlaceTimer(pos, mWRMPTimerHeap[child]);
+        pos = child;
+    }
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // Resend from Table (if the operation fails, the entry is cleared)
-                    err = SendFromRetransTable(&(RetransTable[i]));
-                }
+    WRMPPlaceTimer(pos, timerId);
+}
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // If the retransmission was successful, update the passive timer
-                    RetransTable[i].nextRetransTime = ec->GetCurrentRetransmitTimeout() / mWRMPTimerInterval;
-#if defined(DEBUG)
-                    WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
-                            RetransTable[i].msgId, RetransTable[i].sendCount);
-#endif
-                }
+/**
+ *  Add a WRMP timer to the heap, or reposition it after its deadline changed.
+ */
+void WeaveExchangeManager::WRMPScheduleTimer(uint32_t timerId)
+{
+    const uint32_t pos = WRMPGetTimerPos(timerId);
 
-                if (err != WEAVE_NO_ERROR)
-                {
-                    if (ec->OnSendError)
-                    {
-                        ec->OnSendError(ec, err, msgCtxt);
-                    }
-                }
-            } //nextRetransTime = 0
-        }
+    if (pos == 0)
+    {
+        WRMPPlaceTimer(mWRMPTimerHeapLen, timerId);
+        WRMPSiftTimer(mWRMPTimerHeapLen++);
+    }
+    else
+    {
+        WRMPSiftTimer(pos - 1);
     }
+}
 
-    TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries after processing");
+/**
+ *  Remove a WRMP timer from the heap, if present.
+ */
+void WeaveExchangeManager::WRMPCancelTimer(uint32_t timerId)
+{
+    uint32_t &posField = WRMPGetTimerPos(timerId);
+    size_t pos;
+
+    if (posField == 0)
+        return;
+
+    pos = posField - 1;
+    posField = 0;
+
+    if (pos < --mWRMPTimerHeapLen)
+    {
+        WRMPPlaceTimer(pos, mWRMPTimerHeap[mWRMPTimerHeapLen]);
+        WRMPSiftTimer(pos);
+    }
 }
 
 /**
-* Calculate number of virtual WRMP ticks that have expired since we last
-* called this function. Iterate through active exchange contexts and
-* retrans table entries, subtracting expired virtual ticks to synchronize
-* wakeup times with the current system time. Do not perform any actions
-* beyond updating tick counts, actions will be performed by the physical
-* WRMP timer tick expiry.
-*
-*/
-void WeaveExchangeManager::WRMPExpireTicks(void)
+ *  Set the time at which the pending acknowledgment of an exchange is sent as a Solo Ack.
+ */
+void WeaveExchangeManager::WRMPSetAckTime(ExchangeContext *ec, uint64_t ackTime)
 {
-    uint64_t            now         = 0;
-    ExchangeContext*    ec          = NULL;
-    uint16_t            deltaTicks;
+    ec->mWRMPNextAckTime = ackTime;
+    WRMPScheduleTimer((uint32_t) (ec - ContextPool));
+}
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
+/**
+ *  Cancel the Solo Ack deadline of an exchange, if any.
+ */
+void WeaveExchangeManager::WRMPCancelAckTime(ExchangeContext *ec)
+{
+    WRMPCancelTimer((uint32_t) (ec - ContextPool));
+}
 
-    now = System::Timer::GetCurrentEpoch();
+/**
+ *  Set the time at which a retransmission table entry is next retransmitted.
+ */
+void WeaveExchangeManager::WRMPSetRetransTime(RetransTableEntry *entry, uint64_t retransTime)
+{
+    entry->nextRetransTime = retransTime;
+    WRMPScheduleTimer((uint32_t) (mContextPoolSize + (entry - RetransTable)));
+}
 
-    // Number of full ticks elapsed since last timer processing.  We always round down
-    // to the previous tick.  If we are between tick boundaries, the extra time since the
-    // last virtual tick is not accounted for here (it will be accounted for when resetting
-    // the WRMP timer)
-    deltaTicks = GetTickCounterFromTimeDelta(now, mWRMPTimeStampBase);
+/**
+* Execute the WRMP actions whose deadlines have passed: send Solo Acks for
+* exchanges whose acknowledgments could not be piggybacked in time, and
+* retransmit (or give up on) unacknowledged messages.
+*
+*/
+void WeaveExchangeManager::WRMPExecuteActions(void)
+{
+    const uint64_t now = System::Timer::GetCurrentEpoch();
 
 #if defined(WRMP_TICKLESS_DEBUG)
-    WeaveLogProgress(ExchangeManager, "WRMPExpireTicks at %" PRIu64 ", %" PRIu64 ", %u", now, mWRMPTimeStampBase, deltaTicks);
+    WeaveLogProgress(ExchangeManager, "WRMPExecuteActions");
 #endif
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries before processing");
+
+    while (mWRMPTimerHeapLen > 0 && WRMPGetTimerTime(mWRMPTimerHeap[0]) <= now)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
+        const uint32_t timerId = mWRMPTimerHeap[0];
+        ExchangeContext *ec;
+
+        WRMPCancelTimer(timerId);
+
+        if (timerId < mContextPoolSize)
         {
-            //Decrement counter of Ack timestamp by the elapsed timer ticks
-            if (ec->mWRMPNextAckTime >= deltaTicks)
-            {
-                ec->mWRMPNextAckTime -= deltaTicks;
-            }
-            else
+            ec = ContextPool + timerId;
+
+            if (ec->ExchangeMgr != NULL && ec->IsAckPending())
             {
-                ec->mWRMPNextAckTime = 0;
-            }
 #if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPNextAckTime to %u", ec->mWRMPNextAckTime);
+                WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
 #endif
+                //Send the Ack in a Common::Null message
+                ec->SendCommonNullMessage();
+                ec->SetAckPending(false);
+            }
         }
-    }
-
-    //Process Throttle Time
-    //Check Throttle timeout stored in EC to set/unset Throttle flag
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
-    {
-        ec = RetransTable[i].exchContext;
-        if (ec)
+        else
         {
-            //Process Retransmit Table
-            //Decrement Throttle timeout by elapsed timeticks
-            if (ec->mWRMPThrottleTimeout >= deltaTicks)
+            // The table may grow (and move) while callbacks run, so refer to the entry by position.
+            const size_t i = timerId - mContextPoolSize;
+            WEAVE_ERROR err = WEAVE_NO_ERROR;
+            uint8_t sendCount = RetransTable[i].sendCount;
+            void * msgCtxt = RetransTable[i].msgCtxt;
+
+            ec = RetransTable[i].exchContext;
+
+            if (sendCount > ec->mWRMPConfig.mMaxRetrans)
             {
-                ec->mWRMPThrottleTimeout -= deltaTicks;
+                err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
+
+                WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
+                              RetransTable[i].msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
+
+                // Remove from Table
+                ClearRetransmitTable(RetransTable[i]);
             }
-            else
+
+            if (err == WEAVE_NO_ERROR)
             {
-                ec->mWRMPThrottleTimeout = 0;
+                // Resend from Table (if the operation fails, the entry is cleared)
+                err = SendFromRetransTable(&(RetransTable[i]));
             }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPThrottleTimeout to %u", RetransTable[i].nextRetransTime);
-#endif
 
-            //Decrement Retransmit timeout by elapsed timeticks
-            if (RetransTable[i].nextRetransTime >= deltaTicks)
+            if (err == WEAVE_NO_ERROR)
             {
-                RetransTable[i].nextRetransTime -= deltaTicks;
+                // If the retransmission was successful, update the passive timer
+                WRMPSetRetransTime(&RetransTable[i], System::Timer::GetCurrentEpoch() + ec->GetCurrentRetransmitTimeout());
+#if defined(DEBUG)
+                WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
+                        RetransTable[i].msgId, RetransTable[i].sendCount);
+#endif
             }
-            else
+
+            if (err != WEAVE_NO_ERROR)
             {
-                RetransTable[i].nextRetransTime = 0;
+                if (ec->OnSendError)
+                {
+                    ec->OnSendError(ec, err, msgCtxt);
+                }
             }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set nextRetransTime to %u", RetransTable[i].nextRetransTime);
-#endif
-        } //ec entry is allocated
+        }
     }
 
-    // Re-Adjust the base time stamp to the most recent tick boundary
-
-    // Note on math: because we're really multiplying two 16-bit
-    // unsigned numbers, we know that the result will fit in a 32-bit
-    // unsigned without overflow. Consequently, casting operands to
-    // 32-bit, and performing 32-bit multiplication is correct.
-    mWRMPTimeStampBase += static_cast<uint64_t>( static_cast<uint32_t>(deltaTicks) * static_cast<uint32_t>(mWRMPTimerInterval));
-#if defined(WRMP_TICKLESS_DEBUG)
-    WeaveLogProgress(ExchangeManager, "WRMPExpireTicks mWRMPTimeStampBase to %" PRIu64, mWRMPTimeStampBase);
-#endif
+    TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries after processing");
 }
 
 /**
@@ -1432,10 +1751,9 @@ void WeaveExchangeManager::WRMPTimeout(System::Layer* aSystemLayer, void* aAppSt
     WeaveLogProgress(ExchangeManager, "WRMPTimeout\n");
 #endif
 
-    // Make sure all tick counts are sync'd to the current time
-    exchangeMgr->WRMPExpireTicks();
+    exchangeMgr->mWRMPTimerArmed = false;
 
-    // Execute any actions that are due this tick
+    // Execute any actions that are due
     exchangeMgr->WRMPExecuteActions();
 
     // Calculate next physical wakeup
@@ -1446,6 +1764,8 @@ void WeaveExchangeManager::WRMPTimeout(System::Layer* aSystemLayer, void* aAppSt
  *  Add a Weave message into the retransmission table to be subsequently resent if a corresponding acknowledgment
  *  is not received within the retransmission timeout.
  *
+ *  If the table is full and #WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE permits, the table is grown first.
+ *
  *  @param[in]    ec        A pointer to the ExchangeContext object.
  *
  *  @param[in]    msgBuf    A pointer to the message buffer holding the Weave message to be retransmitted.
@@ -1462,44 +1782,106 @@ void WeaveExchangeManager::WRMPTimeout(System::Layer* aSystemLayer, void* aAppSt
  */
 WEAVE_ERROR WeaveExchangeManager::AddToRetransTable(ExchangeContext *ec, PacketBuffer *msgBuf, uint32_t messageId, void *msgCtxt, RetransTableEntry **rEntry)
 {
-    bool added      = false;
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    RetransTableEntry *entry;
+    uint32_t *link;
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    if (mNumFreeRetransEntries == 0 && mRetransTableSize < WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE)
     {
-        //Check the exchContext pointer for finding an empty slot in Table
-        if (!RetransTable[i].exchContext)
-        {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            WRMPExpireTicks();
-
-            RetransTable[i].exchContext = ec;
-            RetransTable[i].msgId = messageId;
-            RetransTable[i].msgBuf = msgBuf;
-            RetransTable[i].sendCount = 0;
-            RetransTable[i].nextRetransTime = GetTickCounterFromTimeDelta(ec->GetCurrentRetransmitTimeout() + System::Timer::GetCurrentEpoch(), mWRMPTimeStampBase);
-
-            RetransTable[i].msgCtxt = msgCtxt;
-            *rEntry = &RetransTable[i];
-            //Increment the reference count
-            ec->AddRef();
-            added = true;
+        size_t newSize = 2 * mRetransTableSize;
 
-            //Check if the timer needs to be started and start it.
-            WRMPStartTimer();
-            break;
+        if (newSize > WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE)
+            newSize = WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE;
+
+        if (GrowRetransTable(newSize) != WEAVE_NO_ERROR)
+        {
+            WeaveLogError(ExchangeManager, "RetransTable grow to %u FAILED", (unsigned) newSize);
         }
     }
 
-    if (!added)
+    if (mNumFreeRetransEntries == 0)
     {
         WeaveLogError(ExchangeManager, "RetransTable Already Full");
-        err = WEAVE_ERROR_RETRANS_TABLE_FULL;
+        ExitNow(err = WEAVE_ERROR_RETRANS_TABLE_FULL);
     }
 
+    entry = &RetransTable[mFreeRetransEntries[--mNumFreeRetransEntries]];
+
+    entry->exchContext = ec;
+    entry->msgId = messageId;
+    entry->msgBuf = msgBuf;
+    entry->sendCount = 0;
+    entry->msgCtxt = msgCtxt;
+    entry->nextForContext = 0;
+
+    // Append the entry to the exchange's list, preserving the order in which its messages were sent.
+    for (link = &ec->mWRMPRetransList; *link != 0; link = &RetransTable[*link - 1].nextForContext)
+        ;
+    *link = (uint32_t) (entry - RetransTable + 1);
+
+    //Increment the reference count
+    ec->AddRef();
+
+    WRMPSetRetransTime(entry, System::Timer::GetCurrentEpoch() + ec->GetCurrentRetransmitTimeout());
+    *rEntry = entry;
+
+    //Check if the timer needs to be started and start it.
+    WRMPStartTimer();
+
+exit:
     return err;
 }
 
+/**
+ *  Grow the retransmission table, moving it (along with its free stack and the WRMP
+ *  timer heap) into a new heap block.  Entries keep their positions.
+ *
+ *  @param[in]    newSize   The new number of table entries.
+ *
+ *  @retval  #WEAVE_ERROR_NO_MEMORY If the new table could not be allocated.
+ *  @retval  #WEAVE_NO_ERROR On success.
+ *
+ */
+WEAVE_ERROR WeaveExchangeManager::GrowRetransTable(size_t newSize)
+{
+    const size_t heapCapacity = mContextPoolSize + newSize;
+    RetransTableEntry *newTable;
+    uint32_t *newFreeEntries;
+    uint32_t *newTimerHeap;
+    void *block;
+
+    block = malloc(newSize * (sizeof(RetransTableEntry) + sizeof(uint32_t)) + heapCapacity * sizeof(uint32_t));
+    if (block == NULL)
+        return WEAVE_ERROR_NO_MEMORY;
+
+    newTable = (RetransTableEntry *) block;
+    newFreeEntries = (uint32_t *) (newTable + newSize);
+    newTimerHeap = newFreeEntries + newSize;
+
+    if (mRetransTableSize > 0)
+        memcpy(newTable, RetransTable, mRetransTableSize * sizeof(RetransTableEntry));
+    memset(newTable + mRetransTableSize, 0, (newSize - mRetransTableSize) * sizeof(RetransTableEntry));
+
+    if (mNumFreeRetransEntries > 0)
+        memcpy(newFreeEntries, mFreeRetransEntries, mNumFreeRetransEntries * sizeof(uint32_t));
+    for (size_t i = newSize; i > mRetransTableSize; i--)
+        newFreeEntries[mNumFreeRetransEntries++] = (uint32_t) (i - 1);
+
+    if (mWRMPTimerHeapLen > 0)
+        memcpy(newTimerHeap, mWRMPTimerHeap, mWRMPTimerHeapLen * sizeof(uint32_t));
+
+    if (mRetransTableHeap != NULL)
+        free(mRetransTableHeap);
+
+    mRetransTableHeap = block;
+    RetransTable = newTable;
+    mRetransTableSize = newSize;
+    mFreeRetransEntries = newFreeEntries;
+    mWRMPTimerHeap = newTimerHeap;
+
+    return WEAVE_NO_ERROR;
+}
+
 /**
  *  Send the specified entry from the retransmission table.
  *
@@ -1522,7 +1904,7 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMSendError,
                        entry->sendCount = (ec->mWRMPConfig.mMaxRetrans + 1);
-                       entry->nextRetransTime = 0;
+                       WRMPSetRetransTime(entry, System::Timer::GetCurrentEpoch());
                        WRMPStartTimer();
                        ExitNow());
 
@@ -1581,13 +1963,10 @@ exit:
  */
 void WeaveExchangeManager::ClearRetransmitTable(ExchangeContext *ec)
 {
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    while (ec->mWRMPRetransList != 0)
     {
-        if (RetransTable[i].exchContext == ec)
-        {
-            //Clear the retransmit table entry.
-            ClearRetransmitTable(RetransTable[i]);
-        }
+        //Clear the retransmit table entry.
+        ClearRetransmitTable(RetransTable[ec->mWRMPRetransList - 1]);
     }
 }
 
@@ -1601,8 +1980,15 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
 {
     if (rEntry.exchContext)
     {
-        // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-        WRMPExpireTicks();
+        const uint32_t pos = (uint32_t) (&rEntry - RetransTable);
+        uint32_t *link;
+
+        // Unlink the entry from its exchange's list before the exchange can be released.
+        for (link = &rEntry.exchContext->mWRMPRetransList; *link != pos + 1; link = &RetransTable[*link - 1].nextForContext)
+            ;
+        *link = rEntry.nextForContext;
+
+        WRMPCancelTimer(mContextPoolSize + pos);
 
         rEntry.exchContext->Release();
         rEntry.exchContext = NULL;
@@ -1616,6 +2002,8 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
         // Clear all other fields
         memset(&rEntry, 0, sizeof(rEntry));
 
+        mFreeRetransEntries[mNumFreeRetransEntries++] = pos;
+
         // Schedule next physical wakeup
         WRMPStartTimer();
 
@@ -1632,101 +2020,85 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
  */
 void WeaveExchangeManager::FailRetransmitTableEntries(ExchangeContext *ec, WEAVE_ERROR err)
 {
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    size_t count = 0;
+
+    for (uint32_t next = ec->mWRMPRetransList; next != 0; next = RetransTable[next - 1].nextForContext)
+        count++;
+
+    // Fail only the entries present on entry; any message sent from OnSendError is appended behind them.
+    for (; count > 0 && ec->mWRMPRetransList != 0; count--)
     {
-        if (RetransTable[i].exchContext == ec)
-        {
-            void *msgCtxt = RetransTable[i].msgCtxt;
+        RetransTableEntry &entry = RetransTable[ec->mWRMPRetransList - 1];
+        void *msgCtxt = entry.msgCtxt;
 
-            // Remove the entry from the retransmission table.
-            ClearRetransmitTable(RetransTable[i]);
+        // Remove the entry from the retransmission table.
+        ClearRetransmitTable(entry);
 
-            // Application callback OnSendError.
-            if (ec->OnSendError)
-                ec->OnSendError(ec, err, msgCtxt);
-        }
+        // Application callback OnSendError.
+        if (ec->OnSendError)
+            ec->OnSendError(ec, err, msgCtxt);
     }
 }
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
-* Determine how many WRMP ticks we need to sleep before we need to physically
-* wake the CPU to perform an action.  Set a timer to go off when we
-* next need to wake the system.
+* Arm the WRMP timer for the earliest pending WRMP deadline, or stop it if
+* there is none.
 *
 */
 void WeaveExchangeManager::WRMPStartTimer()
 {
     WEAVE_ERROR res                   = WEAVE_NO_ERROR;
-    uint32_t nextWakeTime             = UINT32_MAX;
-    bool foundWake                    = false;
-    ExchangeContext *ec               = NULL;
-
-    // Stop any active timers, we are about to set a new timer
-    // based on the most up to date contents of the retrans
-    // table
-    WRMPStopTimer();
-
-    // When do we need to next wake up to send an ACK?
-    ec = (ExchangeContext *)ContextPool;
+    uint64_t nextWakeTime;
+    uint64_t now;
+    uint32_t timerArmValue;
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    if (mWRMPTimerHeapLen == 0)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending() && ec->mWRMPNextAckTime < nextWakeTime) {
-            nextWakeTime = ec->mWRMPNextAckTime;
-            foundWake = true;
+        if (mWRMPTimerArmed)
+        {
+            WRMPStopTimer();
+        }
 #if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPStartTimer next ACK time %u", nextWakeTime);
+        WeaveLogProgress(ExchangeManager, "Not setting WRMP timeout at %" PRIu64, System::Timer::GetCurrentEpoch());
 #endif
-        }
+        return;
     }
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    // The earliest deadline sits at the top of the heap.  Leave the timer
+    // alone if it is already armed for it.
+    nextWakeTime = WRMPGetTimerTime(mWRMPTimerHeap[0]);
+    if (mWRMPTimerArmed && mWRMPTimerArmedTime == nextWakeTime)
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
-        {
-            // When do we need to next wake up for throttle retransmission?
-            if (ec->mWRMPThrottleTimeout != 0 && ec->mWRMPThrottleTimeout < nextWakeTime) {
-                nextWakeTime = ec->mWRMPThrottleTimeout;
-                foundWake = true;
-#if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer throttle timeout %u", nextWakeTime);
-#endif
-            }
+        return;
+    }
 
-            // When do we need to next wake up for WRMP retransmit?
-            if (RetransTable[i].nextRetransTime < nextWakeTime) {
-                nextWakeTime = RetransTable[i].nextRetransTime;
-                foundWake = true;
-#if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer RetransTime %u", nextWakeTime);
-#endif
-            }
-        }
+    // If the deadline has passed (delayed processing of event due to other
+    // system activity), expire the timer immediately
+    now = System::Timer::GetCurrentEpoch();
+    if (nextWakeTime <= now)
+    {
+        timerArmValue = 0;
+    }
+    else if (nextWakeTime - now > UINT32_MAX)
+    {
+        timerArmValue = UINT32_MAX;
+    }
+    else
+    {
+        timerArmValue = static_cast<uint32_t>(nextWakeTime - now);
     }
 
-    if (foundWake) {
-        // Set timer for next tick boundary - subtract the elapsed time from the current tick
-        int32_t timerArmValue = nextWakeTime * mWRMPTimerInterval - (System::Timer::GetCurrentEpoch() - mWRMPTimeStampBase);
 #if defined(WRMP_TICKLESS_DEBUG)
-        WeaveLogProgress(ExchangeManager, "Setting WRMP timer for %d ms (%u %" PRIu64 " %" PRIu64 ")",
-                timerArmValue,
-                nextWakeTime, System::Timer::GetCurrentEpoch(), mWRMPTimeStampBase);
+    WeaveLogProgress(ExchangeManager, "Setting WRMP timer for %" PRIu32 " ms (%" PRIu64 " %" PRIu64 ")",
+            timerArmValue, nextWakeTime, now);
 #endif
-        // If the tick boundary has expired in the past (delayed processing of event due to other system activity),
-        // expire the timer immediately
-        if (timerArmValue < 0) {
-            timerArmValue = 0;
-        }
-        res = MessageLayer->SystemLayer->StartTimer((uint32_t)timerArmValue, WRMPTimeout, this);
 
-        VerifyOrDieWithMsg(res == WEAVE_NO_ERROR, ExchangeManager, "Cannot start WRMPTimeout\n");
-#if defined(WRMP_TICKLESS_DEBUG)
-    } else {
-        WeaveLogProgress(ExchangeManager, "Not setting WRMP timeout at %" PRIu64, System::Timer::GetCurrentEpoch());
-#endif
-    }
+    res = MessageLayer->SystemLayer->StartTimer(timerArmValue, WRMPTimeout, this);
+
+    VerifyOrDieWithMsg(res == WEAVE_NO_ERROR, ExchangeManager, "Cannot start WRMPTimeout\n");
+
+    mWRMPTimerArmed = true;
+    mWRMPTimerArmedTime = nextWakeTime;
 
     TicklessDebugDumpRetransTable("WRMPStartTimer Dumping RetransTable entries after setting wakeup times");
 
@@ -1735,6 +2107,7 @@ void WeaveExchangeManager::WRMPStartTimer()
 void WeaveExchangeManager::WRMPStopTimer()
 {
     MessageLayer->SystemLayer->CancelTimer(WRMPTimeout, this);
+    mWRMPTimerArmed = false;
 }
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
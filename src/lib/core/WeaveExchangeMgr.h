@@ -357,8 +357,10 @@ private:
 
     uint32_t mPendingPeerAckId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    uint16_t mWRMPNextAckTime;                  //Next time for triggering Solo Ack
-    uint16_t mWRMPThrottleTimeout;              //Timeout until when Throttle is On when WRMPThrottleEnabled is set
+    uint64_t mWRMPNextAckTime;                  //Time (epoch milliseconds) for triggering Solo Ack
+    uint64_t mWRMPThrottleTimeout;              //Time (epoch milliseconds) until when Throttle is On; 0 if not throttled
+    uint32_t mWRMPAckTimerPos;                  //Position + 1 of the Solo Ack deadline in the WRMP timer heap; 0 if not scheduled
+    uint32_t mWRMPRetransList;                  //Position + 1 of the first RetransTable entry of this exchange; 0 if none
 #endif
     void DoClose(bool clearRetransTable);
     WEAVE_ERROR HandleMessage(WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchHeader, PacketBuffer *msgBuf);
@@ -408,6 +410,7 @@ public:
     uint8_t State;                              /**< [READ ONLY] The state of the WeaveExchangeManager object. */
 
     WEAVE_ERROR Init(WeaveMessageLayer *msgLayer);
+    WEAVE_ERROR Init(WeaveMessageLayer *msgLayer, size_t maxContexts);
     WEAVE_ERROR Shutdown(void);
 
 #if WEAVE_CONFIG_TEST
@@ -448,8 +451,6 @@ public:
 private:
     uint16_t NextExchangeId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    uint64_t mWRMPTimeStampBase;    //WRMP timer base value to add offsets to evaluate timeouts
-    uint16_t mWRMPTimerInterval;    //WRMP Timer tick period
     /**
      *  @class RetransTableEntry
      *
@@ -467,16 +468,15 @@ private:
        ExchangeContext      *exchContext;       /**< The ExchangeContext for the stored Weave message. */
        PacketBuffer         *msgBuf;            /**< A pointer to the PacketBuffer object holding the Weave message. */
        void                 *msgCtxt;           /**< A pointer to an application level context object associated with the message. */
-       uint16_t             nextRetransTime;    /**< A counter representing the next retransmission time for the message. */
+       uint64_t             nextRetransTime;    /**< The time (epoch milliseconds) at which the message is next retransmitted. */
+       uint32_t             timerPos;           /**< Position + 1 of the entry in the WRMP timer heap, or 0 if not scheduled. */
+       uint32_t             nextForContext;     /**< Table position + 1 of the next entry of the same ExchangeContext, or 0. */
        uint8_t              sendCount;          /**< A counter representing the number of times the message has been sent. */
     };
     void     WRMPExecuteActions(void);
-    void     WRMPExpireTicks(void);
     void     WRMPStartTimer(void);
     void     WRMPStopTimer(void);
     void     WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64_t DelayedNodeId);
-    uint32_t GetTickCounterFromTimeDelta (uint64_t newTime,
-                                          uint64_t oldTime);
     static void WRMPTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
     static bool isLaterInWRMP(uint64_t t2, uint64_t t1);
     bool IsSendErrorCritical(WEAVE_ERROR err) const;
@@ -486,11 +486,42 @@ private:
     void ClearRetransmitTable(RetransTableEntry &rEntry);
     void FailRetransmitTableEntries(ExchangeContext *ec, WEAVE_ERROR err);
     void RetransPendingAppGroupMsgs(uint64_t peerNodeId);
+    WEAVE_ERROR GrowRetransTable(size_t newSize);
 
     void TicklessDebugDumpRetransTable(const char *log);
 
+    // WRMP deadlines (Solo Ack timeouts and retransmissions) are kept in a binary min-heap ordered by time, and the
+    // system timer is armed for the earliest one.  Heap entries are timer ids: an id below mContextPoolSize names the
+    // Solo Ack deadline of the exchange context at that pool position; a larger id names RetransTable entry
+    // (id - mContextPoolSize).
+    uint64_t WRMPGetTimerTime(uint32_t timerId) const;
+    uint32_t &WRMPGetTimerPos(uint32_t timerId);
+    void WRMPPlaceTimer(size_t pos, uint32_t timerId);
+    void WRMPSiftTimer(size_t pos);
+    void WRMPScheduleTimer(uint32_t timerId);
+    void WRMPCancelTimer(uint32_t timerId);
+    void WRMPSetAckTime(ExchangeContext *ec, uint64_t ackTime);
+    void WRMPCancelAckTime(ExchangeContext *ec);
+    void WRMPSetRetransTime(RetransTableEntry *entry, uint64_t retransTime);
+
     //WRMP Global tables for timer context
-    RetransTableEntry RetransTable[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+    RetransTableEntry *RetransTable;            // The retransmission table; points at mRetransTableStorage until grown.
+    size_t mRetransTableSize;
+
+    // Stack of the positions of free RetransTable entries.
+    uint32_t *mFreeRetransEntries;
+    size_t mNumFreeRetransEntries;
+
+    uint32_t *mWRMPTimerHeap;                   // Timer ids; room for one per exchange context and table entry.
+    size_t mWRMPTimerHeapLen;
+    uint64_t mWRMPTimerArmedTime;               // The deadline the system timer is armed for, if mWRMPTimerArmed.
+    bool mWRMPTimerArmed;
+
+    void *mRetransTableHeap;                    // Heap block holding the table, free stack and timer heap, once grown.
+
+    RetransTableEntry mRetransTableStorage[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+    uint32_t mFreeRetransEntryStorage[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+    uint32_t mWRMPTimerHeapStorage[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS + WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
     class UnsolicitedMessageHandler
@@ -505,16 +536,54 @@ private:
     };
 
 
-    ExchangeContext ContextPool[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+    enum
+    {
+        kMaxContextPoolSize = 0xFFFE,           // Largest pool whose positions fit the uint16_t index entries.
+    };
+
+    ExchangeContext *ContextPool;               // The exchange context pool; points at mContextPoolStorage unless a larger pool was requested.
+    size_t mContextPoolSize;
     size_t mContextsInUse;
 
+    // Open-addressed (linear probing) index of in-use exchange contexts, keyed on exchange id and initiator flag.
+    // Each entry holds the context's pool position + 1, or 0 for an empty slot.  The table is kept at twice the
+    // pool size so probe sequences stay short.
+    uint16_t *mContextIndex;
+    size_t mContextIndexSize;
+
+    // Stack of the pool positions of free exchange contexts.
+    uint16_t *mFreeContexts;
+    size_t mNumFreeContexts;
+
+    void *mContextPoolHeap;                     // Heap block holding the pool, index and free stack, if Init() allocated one.
+
+    ExchangeContext mContextPoolStorage[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+    uint16_t mContextIndexStorage[2 * WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+    uint16_t mFreeContextStorage[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+
     Binding BindingPool[WEAVE_CONFIG_MAX_BINDINGS];
     size_t mBindingsInUse;
 
     UnsolicitedMessageHandler UMHandlerPool[WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
+
+    // Open-addressed index of registered unsolicited message handlers, keyed on profile id and message type.
+    // Entries hold the handler's pool position + 1, or 0 for an empty slot.
+    uint16_t mUMHandlerIndex[2 * WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
+
     void (*OnExchangeContextChanged)(size_t numContextsInUse);
 
     ExchangeContext *AllocContext(void);
+    void FreeContext(ExchangeContext *ec);
+    void IndexContext(ExchangeContext *ec);
+    void UnindexContext(ExchangeContext *ec);
+    size_t GetContextIndexSlot(uint16_t exchangeId, bool isInitiator) const;
+    ExchangeContext *FindContextForMessage(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+            const WeaveExchangeHeader *exchangeHeader);
+
+    void IndexUMH(UnsolicitedMessageHandler *umh);
+    void UnindexUMH(UnsolicitedMessageHandler *umh);
+    size_t GetUMHIndexSlot(uint32_t profileId, int16_t msgType) const;
+    UnsolicitedMessageHandler *FindUMH(uint32_t profileId, int16_t msgType, WeaveConnection *msgCon, bool isDupMsg);
 
     void HandleConnectionReceived(WeaveConnection *con);
     void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
@@ -92,6 +92,46 @@ enum
 // Key diversifier used for Weave message encryption key derivation.
 const uint8_t kWeaveMsgEncAppKeyDiversifier[] = { 0xB1, 0x1D, 0xAE, 0x5B };
 
+/**
+ * Recompute the state derived from the key material so that it need not be derived again for each message.
+ *
+ * Must be called whenever EncType or EncKey changes.
+ */
+void WeaveMsgEncryptionKey::UpdateKeySchedule(void)
+{
+#if WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+    switch (EncType)
+    {
+    case kWeaveEncryptionType_AES128CTRSHA1:
+        KeySchedule.DataKey.SetKey(EncKey.AES128CTRSHA1.DataKey);
+        KeySchedule.IntegrityKey.Set(EncKey.AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize);
+        break;
+    case kWeaveEncryptionType_AES128GCM:
+        KeySchedule.DataKey.SetKey(EncKey.AES128GCM.DataKey);
+        KeySchedule.IntegrityKey.Reset();
+        break;
+    default:
+        KeySchedule.DataKey.Reset();
+        KeySchedule.IntegrityKey.Reset();
+        break;
+    }
+#endif // WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+}
+
+/**
+ * Wipe the key material and the state derived from it, leaving no key set.
+ */
+void WeaveMsgEncryptionKey::Clear(void)
+{
+    KeyId = WeaveKeyId::kNone;
+    EncType = kWeaveEncryptionType_None;
+    ClearSecretData((uint8_t *)&EncKey, sizeof(EncKey));
+#if WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+    KeySchedule.DataKey.Reset();
+    KeySchedule.IntegrityKey.Reset();
+#endif // WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+}
+
 /**
  * Initialize a WeaveSessionKey object.
  */
@@ -103,7 +143,7 @@ void WeaveSessionKey::Init(void)
     BoundCon = NULL;
     RcvFlags = 0;
     AuthMode = kWeaveAuthMode_NotSpecified;
-    memset(&MsgEncKey, 0, sizeof(MsgEncKey));
+    MsgEncKey.Clear();
     ReserveCount = 0;
     Flags = 0;
 }
@@ -113,8 +153,8 @@ void WeaveSessionKey::Init(void)
  */
 void WeaveSessionKey::Clear(void)
 {
+    // Init() wipes the key material and the key schedule derived from it.
     Init();
-    ClearSecretData((uint8_t *)&MsgEncKey.EncKey, sizeof(MsgEncKey.EncKey));
 }
 
 /**
@@ -189,9 +229,35 @@ void WeaveSessionKey::Clear(void)
  * Signals the session as NOT having been active in the recent past.
  */
 
+/**
+ *  Map a 32-bit hash onto a slot of an index table, using the high bits of the hash.
+ */
+static inline size_t HashToIndexSlot(uint32_t hash, size_t indexSize)
+{
+    return (size_t) (((uint64_t) hash * indexSize) >> 32);
+}
+
+/**
+ *  Advance to the next slot of a linearly probed index table.
+ */
+static inline size_t NextIndexSlot(size_t slot, size_t indexSize)
+{
+    return (slot + 1 < indexSize) ? slot + 1 : 0;
+}
+
+/**
+ *  Fold a node id into 32 bits for hashing.
+ */
+static inline uint32_t FoldNodeId(uint64_t nodeId)
+{
+    return (uint32_t) nodeId ^ (uint32_t) (nodeId >> 32);
+}
+
 WeaveFabricState::WeaveFabricState()
 {
     State = kState_NotInitialized;
+    SessionKeyHeap = NULL;
+    PeerStateHeap = NULL;
 }
 
 WEAVE_ERROR WeaveFabricState::Init()
@@ -203,12 +269,37 @@ WEAVE_ERROR WeaveFabricState::Init()
 
 WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
 {
+    return Init(groupKeyStore, WEAVE_CONFIG_MAX_PEER_NODES, WEAVE_CONFIG_MAX_SESSION_KEYS);
+}
+
+/**
+ *  Initialize the fabric state with peer state and session key tables of the given sizes.
+ *
+ *  Tables no larger than #WEAVE_CONFIG_MAX_PEER_NODES and #WEAVE_CONFIG_MAX_SESSION_KEYS use the storage built into
+ *  the object; larger ones are allocated from the heap and released by Shutdown().
+ *
+ *  @param[in]  groupKeyStore   A pointer to the group key store object.
+ *  @param[in]  maxPeerNodes    The number of peers whose message counters are tracked.
+ *  @param[in]  maxSessionKeys  The maximum number of simultaneously active session keys.
+ *
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE    If the fabric state is already initialized.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT   If a table size is 0 or too large, or groupKeyStore is NULL.
+ *  @retval #WEAVE_ERROR_NO_MEMORY          If a table could not be allocated.
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ */
+WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore, size_t maxPeerNodes, size_t maxSessionKeys)
+{
+    WEAVE_ERROR err;
+
     if (State != kState_NotInitialized)
         return WEAVE_ERROR_INCORRECT_STATE;
 
     if (groupKeyStore == NULL)
         return WEAVE_ERROR_INVALID_ARGUMENT;
 
+    if (maxPeerNodes == 0 || maxPeerNodes > kMaxTableSize || maxSessionKeys == 0 || maxSessionKeys > kMaxTableSize)
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+
 #ifdef WEAVE_NON_PRODUCTION_MARKER
     // This is a trick to force the linker to include the WEAVE_NON_PRODUCTION_MARKER symbol
     // in the linked output.  (Note that the test will never evaluate to true).
@@ -222,21 +313,23 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     LocalNodeId = 1;
     PairingCode = NULL;
     DefaultSubnet = kWeaveSubnetId_PrimaryWiFi;
-    PeerCount = 0;
     NextUnencUDPMsgId.Init(GetRandU32());
     NextUnencTCPMsgId.Init(0);
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
-        SessionKeys[i].Init();
+
+    err = InitPeerStates(maxPeerNodes);
+    SuccessOrExit(err);
+
+    err = InitSessionKeys(maxSessionKeys);
+    SuccessOrExit(err);
+
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
-    WEAVE_ERROR err = NextGroupKeyMsgId.Init(WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID, WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_EPOCH);
-    if (err != WEAVE_NO_ERROR)
-        return err;
+    err = NextGroupKeyMsgId.Init(WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID, WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_EPOCH);
+    SuccessOrExit(err);
 
     GroupKeyMsgIdFreshWindowStart = 0;
     MsgCounterSyncStatus = 0;
     AppKeyCache.Init();
 #endif
-    memset(&PeerStates, 0, sizeof(PeerStates));
     Delegate = NULL;
     memset(SharedSessionsNodes, 0, sizeof(SharedSessionsNodes));
 
@@ -267,7 +360,11 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
 
     State = kState_Initialized;
 
-    return WEAVE_NO_ERROR;
+exit:
+    if (err != WEAVE_NO_ERROR)
+        FreeTables();
+
+    return err;
 }
 
 WEAVE_ERROR WeaveFabricState::Shutdown()
@@ -278,9 +375,128 @@ WEAVE_ERROR WeaveFabricState::Shutdown()
     AppKeyCache.Shutdown();
 #endif
 
+    FreeTables();
+
     return WEAVE_NO_ERROR;
 }
 
+/**
+ *  Set up an empty peer state table with room for the given number of peers.
+ */
+WEAVE_ERROR WeaveFabricState::InitPeerStates(size_t maxPeerNodes)
+{
+    if (maxPeerNodes <= WEAVE_CONFIG_MAX_PEER_NODES)
+    {
+        memset(&PeerStateStorage, 0, sizeof(PeerStateStorage));
+
+        PeerStates.NodeId = PeerStateStorage.NodeId;
+        PeerStates.MaxUnencUDPMsgIdRcvd = PeerStateStorage.MaxUnencUDPMsgIdRcvd;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.MaxGroupKeyMsgIdRcvd = PeerStateStorage.MaxGroupKeyMsgIdRcvd;
+        PeerStates.GroupKeyRcvFlags = PeerStateStorage.GroupKeyRcvFlags;
+#endif
+        PeerStates.UnencRcvFlags = PeerStateStorage.UnencRcvFlags;
+        PeerStates.ClockCredits = PeerStateStorage.ClockCredits;
+        PeerIndex = PeerStateStorage.PeerIndex;
+    }
+    else
+    {
+        size_t entrySize = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(WeaveSessionState::ReceiveFlagsType) + sizeof(uint8_t) +
+                           2 * sizeof(PeerIndexType);
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        entrySize += sizeof(uint32_t) + sizeof(WeaveSessionState::ReceiveFlagsType);
+#endif
+
+        // Carve the table and its index out of a single heap block, widest fields first so that every array is aligned.
+        PeerStateHeap = calloc(maxPeerNodes, entrySize);
+        if (PeerStateHeap == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+
+        PeerStates.NodeId = (uint64_t *) PeerStateHeap;
+        PeerStates.MaxUnencUDPMsgIdRcvd = (uint32_t *) (PeerStates.NodeId + maxPeerNodes);
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        PeerStates.MaxGroupKeyMsgIdRcvd = PeerStates.MaxUnencUDPMsgIdRcvd + maxPeerNodes;
+        PeerStates.GroupKeyRcvFlags = (WeaveSessionState::ReceiveFlagsType *) (PeerStates.MaxGroupKeyMsgIdRcvd + maxPeerNodes);
+        PeerStates.UnencRcvFlags = PeerStates.GroupKeyRcvFlags + maxPeerNodes;
+#else
+        PeerStates.UnencRcvFlags = (WeaveSessionState::ReceiveFlagsType *) (PeerStates.MaxUnencUDPMsgIdRcvd + maxPeerNodes);
+#endif
+        PeerIndex = (PeerIndexType *) (PeerStates.UnencRcvFlags + maxPeerNodes);
+        PeerStates.ClockCredits = (uint8_t *) (PeerIndex + 2 * maxPeerNodes);
+    }
+
+    PeerCount = 0;
+    MaxPeerCount = maxPeerNodes;
+    PeerClockHand = 0;
+
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ *  Set up an empty session key table with room for the given number of keys.
+ */
+WEAVE_ERROR WeaveFabricState::InitSessionKeys(size_t maxSessionKeys)
+{
+    if (maxSessionKeys <= WEAVE_CONFIG_MAX_SESSION_KEYS)
+    {
+        SessionKeys = SessionKeyStorage;
+        SessionKeyIndex = SessionKeyIndexStorage;
+        FreeSessionKeys = FreeSessionKeyStorage;
+    }
+    else
+    {
+        // Carve the table, its index and its free stack out of a single heap block.
+        SessionKeyHeap = malloc(maxSessionKeys * (sizeof(WeaveSessionKey) + 3 * sizeof(uint16_t)));
+        if (SessionKeyHeap == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+
+        SessionKeys = (WeaveSessionKey *) SessionKeyHeap;
+        SessionKeyIndex = (uint16_t *) (SessionKeys + maxSessionKeys);
+        FreeSessionKeys = SessionKeyIndex + 2 * maxSessionKeys;
+    }
+
+    MaxSessionKeys = maxSessionKeys;
+    for (size_t i = 0; i < MaxSessionKeys; i++)
+        SessionKeys[i].Init();
+    memset(SessionKeyIndex, 0, 2 * MaxSessionKeys * sizeof(uint16_t));
+
+    // Stack the free keys so that the lowest table positions are handed out first.
+    for (size_t i = 0; i < MaxSessionKeys; i++)
+        FreeSessionKeys[i] = (uint16_t) (MaxSessionKeys - 1 - i);
+    NumFreeSessionKeys = MaxSessionKeys;
+
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ *  Release the heap-allocated peer state and session key tables, if any, and fall back to the built-in storage.
+ */
+void WeaveFabricState::FreeTables(void)
+{
+    if (PeerStateHeap != NULL)
+    {
+        free(PeerStateHeap);
+        PeerStateHeap = NULL;
+
+        PeerCount = 0;
+        MaxPeerCount = 0;
+        PeerClockHand = 0;
+    }
+
+    if (SessionKeyHeap != NULL)
+    {
+        ClearSecretData((uint8_t *) SessionKeyHeap, MaxSessionKeys * sizeof(WeaveSessionKey));
+        free(SessionKeyHeap);
+        SessionKeyHeap = NULL;
+
+        SessionKeys = SessionKeyStorage;
+        SessionKeyIndex = SessionKeyIndexStorage;
+        FreeSessionKeys = FreeSessionKeyStorage;
+        MaxSessionKeys = 0;
+        NumFreeSessionKeys = 0;
+    }
+}
+
 WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, uint16_t keyId, WeaveConnection *boundCon, WeaveSessionKey *& sessionKey)
 {
     WEAVE_ERROR err;
@@ -299,6 +515,9 @@ WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, uint16_t keyI
             return WEAVE_ERROR_DUPLICATE_KEY_ID;
     }
 
+    // FindSessionKey() returned the key on top of the free stack.
+    NumFreeSessionKeys--;
+
     sessionKey->MsgEncKey.KeyId = keyId;
     sessionKey->NodeId = peerNodeId;
     sessionKey->MsgEncKey.EncType = kWeaveEncryptionType_None;
@@ -309,6 +528,8 @@ WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, uint16_t keyI
     sessionKey->Flags = WeaveSessionKey::kFlag_RecentlyActive;
     sessionKey->ReserveCount = 1;
 
+    IndexSessionKey(sessionKey);
+
     return WEAVE_NO_ERROR;
 }
 
@@ -330,6 +551,7 @@ void WeaveFabricState::SetSessionKey(WeaveSessionKey *sessionKey, uint8_t encTyp
 {
     sessionKey->MsgEncKey.EncType = encType;
     sessionKey->MsgEncKey.EncKey = *encKey;
+    sessionKey->MsgEncKey.UpdateKeySchedule();
     sessionKey->NextMsgId.Init(0);
     sessionKey->MaxRcvdMsgId = 0;
     sessionKey->RcvFlags = 0;
@@ -379,6 +601,12 @@ void WeaveFabricState::RemoveSessionKey(WeaveSessionKey *sessionKey, bool wasIdl
         }
     }
 
+    if (sessionKey->IsAllocated())
+    {
+        UnindexSessionKey(sessionKey);
+        FreeSessionKeys[NumFreeSessionKeys++] = (uint16_t) (sessionKey - SessionKeys);
+    }
+
     sessionKey->Clear();
 }
 
@@ -406,7 +634,7 @@ WeaveSessionKey *WeaveFabricState::FindSharedSession(uint64_t terminatingNodeId,
     // Search the session keys table for an established shared session key that targets the specified
     // terminating node and matches the given auth mode and encryption type.
     sessionKey = SessionKeys;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, sessionKey++)
+    for (size_t i = 0; i < MaxSessionKeys; i++, sessionKey++)
     {
         if (sessionKey->IsAllocated() && sessionKey->IsKeySet() && sessionKey->IsSharedSession() &&
             sessionKey->NodeId == terminatingNodeId && sessionKey->AuthMode == authMode &&
@@ -883,15 +1111,16 @@ exit:
  */
 bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex)
 {
-    uint16_t i;
+    const size_t indexSize = 2 * MaxPeerCount;
+    size_t slot;
     bool retVal = false;
 
     // Find peer entry in the peer state table.
-    for (i = 0; i < PeerCount; i++)
+    for (slot = GetPeerIndexSlot(peerNodeId); PeerIndex[slot] != 0; slot = NextIndexSlot(slot, indexSize))
     {
-        retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
-        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
+        if (PeerStates.NodeId[PeerIndex[slot] - 1] == peerNodeId)
         {
+            retPeerIndex = PeerIndex[slot] - 1;
             retVal = true;
             break;
         }
@@ -900,42 +1129,40 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
     // If peer entry is not found in the peer state table and allocation was requested.
     if (!retVal && allocEntry)
     {
-        // If PeerStates table is full then the least recently used entry is discarded
-        // and allocated for the new peer node. The replacement algorithms tries to find
-        // least recently used entry that didn't use encryption to avoid future
-        // complexity associated with encrypted message counter synchronization.
-        if (PeerCount == WEAVE_CONFIG_MAX_PEER_NODES)
+        // If PeerStates table is full then an entry that was not used recently is discarded
+        // and allocated for the new peer node. The clock hand sweeps the table, taking one
+        // credit from every entry it passes, and stops at the first entry without credit.
+        // Every use of an entry restores its credit, and entries that use encryption get an
+        // extra one, so the replacement prefers entries that didn't use encryption to avoid
+        // future complexity associated with encrypted message counter synchronization.
+        if (PeerCount == MaxPeerCount)
         {
-            // Choose the least recently used peer entry by default.
-            i = WEAVE_CONFIG_MAX_PEER_NODES - 1;
-
-#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
-            // Try to find the least recently used peer entry that didn't use encryption.
-            for (int j = WEAVE_CONFIG_MAX_PEER_NODES - 1; j >= 0; j--)
+            while (PeerStates.ClockCredits[PeerClockHand] != 0)
             {
-                PeerIndexType peerInd = PeerStates.MostRecentlyUsedIndexes[j];
-                if ((PeerStates.GroupKeyRcvFlags[peerInd] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) == 0)
-                {
-                    i = j;
-                    break;
-                }
+                PeerStates.ClockCredits[PeerClockHand]--;
+                PeerClockHand = (PeerClockHand + 1 < MaxPeerCount) ? PeerClockHand + 1 : 0;
             }
-#endif
 
             // The peer index chosen for replacement.
-            retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
+            retPeerIndex = (PeerIndexType) PeerClockHand;
+            PeerClockHand = (PeerClockHand + 1 < MaxPeerCount) ? PeerClockHand + 1 : 0;
+
+            // Removing the old peer from the index may shift entries back, so search again for a free slot.
+            UnindexPeer(retPeerIndex);
+            for (slot = GetPeerIndexSlot(peerNodeId); PeerIndex[slot] != 0; slot = NextIndexSlot(slot, indexSize))
+                ;
         }
 
-        // If PeerStates table is not full then the next available entry is "i".
+        // If PeerStates table is not full then the next available entry is allocated.
         // Entries in the table are allocated sequentially and never discarded until
-        // the table is full. Only when table is full the least recently used entry
-        // is discarded and replaced with the new entry.
+        // the table is full.
         else
         {
-            PeerCount++;
-            retPeerIndex = i;
+            retPeerIndex = (PeerIndexType) PeerCount++;
         }
 
+        PeerIndex[slot] = retPeerIndex + 1;
+
         PeerStates.NodeId[retPeerIndex] = peerNodeId;
         PeerStates.MaxUnencUDPMsgIdRcvd[retPeerIndex] = 0;
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
@@ -946,18 +1173,59 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         retVal = true;
     }
 
-    // Move the requested entry to the top of the most recently used indexes list.
+    // Restore the credit of the requested entry.
     if (retVal)
     {
-        memmove(&PeerStates.MostRecentlyUsedIndexes[1],
-                &PeerStates.MostRecentlyUsedIndexes[0],
-                i * sizeof(PeerIndexType));
-        PeerStates.MostRecentlyUsedIndexes[0] = retPeerIndex;
+        PeerStates.ClockCredits[retPeerIndex] = 1;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        if ((PeerStates.GroupKeyRcvFlags[retPeerIndex] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) != 0)
+            PeerStates.ClockCredits[retPeerIndex] = 2;
+#endif
     }
 
     return retVal;
 }
 
+/**
+ *  Return the home slot of a peer in the peer state index.
+ */
+size_t WeaveFabricState::GetPeerIndexSlot(uint64_t peerNodeId) const
+{
+    return HashToIndexSlot(FoldNodeId(peerNodeId) * 0x9E3779B1U, 2 * MaxPeerCount);
+}
+
+/**
+ *  Remove a peer state table entry from the peer state index.
+ */
+void WeaveFabricState::UnindexPeer(PeerIndexType peerIndex)
+{
+    const size_t indexSize = 2 * MaxPeerCount;
+    size_t slot = GetPeerIndexSlot(PeerStates.NodeId[peerIndex]);
+    size_t next;
+
+    while (PeerIndex[slot] != peerIndex + 1)
+    {
+        if (PeerIndex[slot] == 0)
+            return;
+        slot = NextIndexSlot(slot, indexSize);
+    }
+
+    // Shift later entries of the probe run back into the vacated slot, so that lookups never stop short of them.
+    for (next = NextIndexSlot(slot, indexSize); PeerIndex[next] != 0; next = NextIndexSlot(next, indexSize))
+    {
+        const size_t home = GetPeerIndexSlot(PeerStates.NodeId[PeerIndex[next] - 1]);
+
+        // An entry can move back unless its home slot lies cyclically within (slot, next].
+        if ((slot < next) ? (home <= slot || home > next) : (home <= slot && home > next))
+        {
+            PeerIndex[slot] = PeerIndex[next];
+            slot = next;
+        }
+    }
+
+    PeerIndex[slot] = 0;
+}
+
 WEAVE_ERROR WeaveFabricState::GetPassword(uint8_t pwSrc, const char *& ps, uint16_t& pwLen)
 {
     switch (pwSrc)
@@ -1248,7 +1516,7 @@ void WeaveFabricState::HandleConnectionClosed(WeaveConnection *con)
 
     // Remove any session keys that are bound to the closed connection.
     sessionKey = SessionKeys;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, sessionKey++)
+    for (size_t i = 0; i < MaxSessionKeys; i++, sessionKey++)
     {
         if (sessionKey->IsAllocated() && SessionKeys[i].BoundCon == con)
         {
@@ -1441,8 +1709,7 @@ exit:
  */
 WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId, bool create, WeaveSessionKey *& retRec)
 {
-    WeaveSessionKey *curRec = SessionKeys;
-    WeaveSessionKey *freeRec = NULL;
+    SharedSessionEndNode *endNode = SharedSessionsNodes;
 
     if (!WeaveKeyId::IsSessionKey(keyId))
         return WEAVE_ERROR_WRONG_KEY_TYPE;
@@ -1450,18 +1717,25 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (peerNodeId == kNodeIdNotSpecified || peerNodeId == kAnyNodeId)
         return WEAVE_ERROR_INVALID_ARGUMENT;
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, curRec++)
+    for (size_t slot = GetSessionKeyIndexSlot(keyId, peerNodeId); SessionKeyIndex[slot] != 0;
+         slot = NextIndexSlot(slot, 2 * MaxSessionKeys))
     {
-        if (!curRec->IsAllocated())
+        WeaveSessionKey *curRec = SessionKeys + SessionKeyIndex[slot] - 1;
+
+        if (curRec->MsgEncKey.KeyId == keyId && curRec->NodeId == peerNodeId)
         {
-            if (freeRec == NULL)
-                freeRec = curRec;
+            retRec = curRec;
+            return WEAVE_NO_ERROR;
         }
-        else if (curRec->MsgEncKey.KeyId == keyId &&
-                 (curRec->NodeId == peerNodeId ||
-                  (curRec->IsSharedSession() && FindSharedSessionEndNode(peerNodeId, curRec))))
+    }
+
+    // A shared session is indexed under its terminating node; the other end nodes are found in the end node records.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES; i++, endNode++)
+    {
+        if (endNode->SessionKey != NULL && endNode->EndNodeId == peerNodeId &&
+            endNode->SessionKey->MsgEncKey.KeyId == keyId && endNode->SessionKey->IsSharedSession())
         {
-            retRec = curRec;
+            retRec = endNode->SessionKey;
             return WEAVE_NO_ERROR;
         }
     }
@@ -1469,14 +1743,70 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (!create)
         return WEAVE_ERROR_KEY_NOT_FOUND;
 
-    if (freeRec == NULL)
+    if (NumFreeSessionKeys == 0)
         return WEAVE_ERROR_TOO_MANY_KEYS;
 
-    retRec = freeRec;
+    retRec = SessionKeys + FreeSessionKeys[NumFreeSessionKeys - 1];
 
     return WEAVE_NO_ERROR;
 }
 
+/**
+ *  Return the home slot of a session key in the session key index.
+ */
+size_t WeaveFabricState::GetSessionKeyIndexSlot(uint16_t keyId, uint64_t peerNodeId) const
+{
+    return HashToIndexSlot((FoldNodeId(peerNodeId) ^ ((uint32_t) keyId << 16)) * 0x9E3779B1U, 2 * MaxSessionKeys);
+}
+
+/**
+ *  Add a session key to the session key index.  This must be done once its key id and peer node id are set.
+ */
+void WeaveFabricState::IndexSessionKey(WeaveSessionKey *sessionKey)
+{
+    size_t slot = GetSessionKeyIndexSlot(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
+
+    // The index is twice the size of the table, so there is always an empty slot.
+    while (SessionKeyIndex[slot] != 0)
+        slot = NextIndexSlot(slot, 2 * MaxSessionKeys);
+
+    SessionKeyIndex[slot] = (uint16_t) (sessionKey - SessionKeys + 1);
+}
+
+/**
+ *  Remove a session key from the session key index, if present.
+ */
+void WeaveFabricState::UnindexSessionKey(WeaveSessionKey *sessionKey)
+{
+    const size_t indexSize = 2 * MaxSessionKeys;
+    const uint16_t entry = (uint16_t) (sessionKey - SessionKeys + 1);
+    size_t slot = GetSessionKeyIndexSlot(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
+    size_t next;
+
+    while (SessionKeyIndex[slot] != entry)
+    {
+        if (SessionKeyIndex[slot] == 0)
+            return;
+        slot = NextIndexSlot(slot, indexSize);
+    }
+
+    // Shift later entries of the probe run back into the vacated slot, so that lookups never stop short of them.
+    for (next = NextIndexSlot(slot, indexSize); SessionKeyIndex[next] != 0; next = NextIndexSlot(next, indexSize))
+    {
+        const WeaveSessionKey *other = SessionKeys + SessionKeyIndex[next] - 1;
+        const size_t home = GetSessionKeyIndexSlot(other->MsgEncKey.KeyId, other->NodeId);
+
+        // An entry can move back unless its home slot lies cyclically within (slot, next].
+        if ((slot < next) ? (home <= slot || home > next) : (home <= slot && home > next))
+        {
+            SessionKeyIndex[slot] = SessionKeyIndex[next];
+            slot = next;
+        }
+    }
+
+    SessionKeyIndex[slot] = 0;
+}
+
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 WEAVE_ERROR WeaveFabricState::FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec)
 {
@@ -1562,6 +1892,7 @@ WEAVE_ERROR WeaveFabricState::DeriveMsgEncAppKey(uint32_t keyId, uint8_t encType
     // Set key parameters.
     appKey.KeyId = keyId;
     appKey.EncType = encType;
+    appKey.UpdateKeySchedule();
 
 exit:
     ClearSecretData(keyData, sizeof(keyData));
@@ -1582,7 +1913,7 @@ bool WeaveFabricState::RemoveIdleSessionKeys()
 
     // For each allocated session key...
     sessionKey = SessionKeys;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, sessionKey++)
+    for (size_t i = 0; i < MaxSessionKeys; i++, sessionKey++)
         if (sessionKey->IsAllocated())
         {
             // Ignore the session if it is still in the process of being established.
@@ -1644,9 +1975,7 @@ void WeaveMsgEncryptionKeyCache::Reset()
 // Clear key cache entry.
 void WeaveMsgEncryptionKeyCache::Clear(uint8_t keyEntryIndex)
 {
-    ClearSecretData((uint8_t *)(&mKeyCache[keyEntryIndex]), sizeof(WeaveMsgEncryptionKey));
-    mKeyCache[keyEntryIndex].KeyId = WeaveKeyId::kNone;
-    mKeyCache[keyEntryIndex].EncType = kWeaveEncryptionType_None;
+    mKeyCache[keyEntryIndex].Clear();
 }
 
 // If the key is found in the cache then function returns pointer to the key.
@@ -1719,6 +2048,11 @@ void WeaveEncryptionKeyToString(uint8_t encType, const WeaveEncryptionKey& key,
         *buf++ = ',';
         ToHexString(key.AES128CTRSHA1.IntegrityKey, sizeof(key.AES128CTRSHA1.IntegrityKey), buf, bufSize);
     }
+    else if (encType == kWeaveEncryptionType_AES128GCM)
+    {
+        bufSize -= 1; // Reserve size for the null terminator.
+        ToHexString(key.AES128GCM.DataKey, sizeof(key.AES128GCM.DataKey), buf, bufSize);
+    }
 
     *buf = 0;
 }
@@ -45,6 +45,8 @@
 #include <Weave/Support/WeaveCounter.h>
 #include <Weave/Support/PersistedCounter.h>
 #include <Weave/Support/FlagUtils.hpp>
+#include <Weave/Support/crypto/AESBlockCipher.h>
+#include <Weave/Support/crypto/HMAC.h>
 #include <Weave/Core/WeaveKeyIds.h>
 #include <Weave/Profiles/security/WeaveSecurity.h>
 #include <Weave/Profiles/security/WeaveApplicationKeys.h>
@@ -281,10 +283,24 @@ public:
     uint8_t IntegrityKey[IntegrityKeySize];
 };
 
+// Encryption key for the AES-128-GCM message encryption type
+class WeaveEncryptionKey_AES128GCM
+{
+public:
+    enum
+    {
+        DataKeySize                                     = 16,
+        KeySize                                         = DataKeySize
+    };
+
+    uint8_t DataKey[DataKeySize];
+};
+
 // Represents a key or key set used to encrypt Weave messages.
 typedef union WeaveEncryptionKey
 {
     WeaveEncryptionKey_AES128CTRSHA1 AES128CTRSHA1;
+    WeaveEncryptionKey_AES128GCM AES128GCM;
 } WeaveEncryptionKey;
 
 // AES128CTRSHA1 encryption and integrity test keys, which should only be used for testing purposes.
@@ -307,6 +323,17 @@ public:
     uint16_t KeyId;                                     /**< The key ID. */
     uint8_t EncType;                                    /**< The encryption type supported by the key. */
     WeaveEncryptionKey EncKey;                          /**< The secret key material. */
+#if WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+    struct
+    {
+        Platform::Security::AES128BlockCipherEnc DataKey;   /**< The data key, expanded into AES round keys. */
+        Crypto::HMACSHA1::PrecomputedKey IntegrityKey;      /**< The HMAC pad states for the integrity key
+                                                                 (AES-128-CTR/HMAC-SHA-1 keys only). */
+    } KeySchedule;                                      /**< State derived from EncKey, computed once by UpdateKeySchedule(). */
+#endif
+
+    void UpdateKeySchedule(void);
+    void Clear(void);
 };
 
 /**
@@ -469,11 +496,7 @@ class NL_DLL_EXPORT WeaveFabricState
 {
 public:
 
-#if WEAVE_CONFIG_MAX_PEER_NODES <= UINT8_MAX
-    typedef uint8_t PeerIndexType;
-#else
     typedef uint16_t PeerIndexType;
-#endif
 
     enum State
     {
@@ -505,6 +528,8 @@ public:
 
     WEAVE_ERROR Init(void);
     WEAVE_ERROR Init(nl::Weave::Profiles::Security::AppKeys::GroupKeyStoreBase *groupKeyStore);
+    WEAVE_ERROR Init(nl::Weave::Profiles::Security::AppKeys::GroupKeyStoreBase *groupKeyStore, size_t maxPeerNodes,
+                     size_t maxSessionKeys);
     WEAVE_ERROR Shutdown(void);
 
     WEAVE_ERROR AllocSessionKey(uint64_t peerNodeId, uint16_t keyId, WeaveConnection *boundCon, WeaveSessionKey *& sessionKey);
@@ -603,10 +628,31 @@ public:
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 
 private:
-    PeerIndexType PeerCount;
+    enum
+    {
+        kMaxTableSize = 0xFFFE,                         // Largest peer or session key table whose positions fit the uint16_t index entries.
+    };
+
     MonotonicallyIncreasingCounter NextUnencUDPMsgId;
     MonotonicallyIncreasingCounter NextUnencTCPMsgId;
-    WeaveSessionKey SessionKeys[WEAVE_CONFIG_MAX_SESSION_KEYS];
+
+    // The session key table; points at SessionKeyStorage unless a larger table was requested.
+    WeaveSessionKey *SessionKeys;
+    size_t MaxSessionKeys;
+
+    // Open-addressed (linear probing) index of allocated session keys, keyed on key id and peer node id.  Each entry
+    // holds the key's table position + 1, or 0 for an empty slot.  The index is twice the size of the table.
+    uint16_t *SessionKeyIndex;
+
+    // Stack of the table positions of free session keys.
+    uint16_t *FreeSessionKeys;
+    size_t NumFreeSessionKeys;
+
+    void *SessionKeyHeap;                               // Heap block holding the session key table, if Init() allocated one.
+
+    WeaveSessionKey SessionKeyStorage[WEAVE_CONFIG_MAX_SESSION_KEYS];
+    uint16_t SessionKeyIndexStorage[2 * WEAVE_CONFIG_MAX_SESSION_KEYS];
+    uint16_t FreeSessionKeyStorage[WEAVE_CONFIG_MAX_SESSION_KEYS];
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     PersistedCounter NextGroupKeyMsgId;
 
@@ -630,6 +676,31 @@ private:
 
     WeaveMsgEncryptionKeyCache AppKeyCache;
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+
+    // The peer state table.  Entries are allocated sequentially until the table is full; after that the entry under
+    // the clock hand with no usage credit left is replaced (see FindOrAllocPeerEntry()).
+    struct
+    {
+        uint64_t *NodeId;
+        uint32_t *MaxUnencUDPMsgIdRcvd;
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+        uint32_t *MaxGroupKeyMsgIdRcvd;
+        WeaveSessionState::ReceiveFlagsType *GroupKeyRcvFlags;
+#endif
+        WeaveSessionState::ReceiveFlagsType *UnencRcvFlags;
+        // Usage credit of each entry, consumed by the clock hand when looking for an entry to replace.
+        uint8_t *ClockCredits;
+    } PeerStates;
+    size_t PeerCount;
+    size_t MaxPeerCount;
+    size_t PeerClockHand;
+
+    // Open-addressed (linear probing) index of the peer state table, keyed on node id.  Each entry holds the peer's
+    // table position + 1, or 0 for an empty slot.  The index is twice the size of the table.
+    PeerIndexType *PeerIndex;
+
+    void *PeerStateHeap;                                // Heap block holding the peer state table, if Init() allocated one.
+
     struct
     {
         uint64_t NodeId[WEAVE_CONFIG_MAX_PEER_NODES];
@@ -639,9 +710,9 @@ private:
         WeaveSessionState::ReceiveFlagsType GroupKeyRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
 #endif
         WeaveSessionState::ReceiveFlagsType UnencRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
-        // Array of peer indexes in sorted order from most- to least- recently used.
-        PeerIndexType MostRecentlyUsedIndexes[WEAVE_CONFIG_MAX_PEER_NODES];
-    } PeerStates;
+        uint8_t ClockCredits[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType PeerIndex[2 * WEAVE_CONFIG_MAX_PEER_NODES];
+    } PeerStateStorage;
     FabricStateDelegate *Delegate;
 
     // This structure contains information about shared session end node.
@@ -661,6 +732,15 @@ private:
 #endif
 
     bool FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex);
+    size_t GetPeerIndexSlot(uint64_t peerNodeId) const;
+    void UnindexPeer(PeerIndexType peerIndex);
+    WEAVE_ERROR InitPeerStates(size_t maxPeerNodes);
+    WEAVE_ERROR InitSessionKeys(size_t maxSessionKeys);
+    void FreeTables(void);
+
+    size_t GetSessionKeyIndexSlot(uint16_t keyId, uint64_t peerNodeId) const;
+    void IndexSessionKey(WeaveSessionKey *sessionKey);
+    void UnindexSessionKey(WeaveSessionKey *sessionKey);
     WEAVE_ERROR FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec);
     WEAVE_ERROR DeriveMsgEncAppKey(uint32_t keyId, uint8_t encType, WeaveMsgEncryptionKey & appKey, uint32_t& appGroupGlobalId);
 };
@@ -45,11 +45,19 @@
 #include <Weave/Support/crypto/HMAC.h>
 #include <Weave/Support/crypto/AESBlockCipher.h>
 #include <Weave/Support/crypto/CTRMode.h>
+#include <Weave/Support/crypto/GCMMode.h>
 #include <Weave/Support/logging/WeaveLogging.h>
 #include <Weave/Support/ErrorStr.h>
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Support/WeaveFaultInjection.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#include <sys/socket.h>
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#include <SystemLayer/SystemMutex.h>
+#endif // defined(SO_ATTACH_REUSEPORT_CBPF)
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 namespace nl {
 namespace Weave {
@@ -90,6 +98,53 @@ enum
     kMinPayloadLen = 1
 };
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+/**
+ *  The endpoints of the sharded message layers of the process that share an address, port and protocol, and so form
+ *  one group of SO_REUSEPORT sockets for the system. The members are kept in the order in which the system numbers
+ *  the sockets of the group: the order in which they joined it, with the last member taking the place of one that
+ *  leaves. The steering program attached to the group maps the shard of each message to the number of the member of
+ *  that shard.
+ */
+struct ShardGroup
+{
+    IPAddress Addr;
+    InterfaceId Intf;
+    uint16_t Port;
+    uint8_t AddrType;
+    bool IsTCP;
+    uint8_t ShardCount;
+    uint8_t NumMembers;
+    uint8_t MemberShards[WEAVE_CONFIG_MAX_SHARDS];
+    EndPointBasis *Members[WEAVE_CONFIG_MAX_SHARDS];
+};
+
+static ShardGroup sShardGroups[WEAVE_CONFIG_MAX_SHARD_GROUPS];
+
+#if !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+// Held while an endpoint joins or leaves a group, from binding or listening until the group program has been updated,
+// so that the members are recorded in the order the system sees them.
+static System::Mutex sShardGroupsMutex;
+static const System::Error sShardGroupsMutexInitError = System::Mutex::Init(sShardGroupsMutex);
+#endif // !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+
+static void LockShardGroups(void)
+{
+#if !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+    sShardGroupsMutex.Lock();
+#endif // !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+}
+
+static void UnlockShardGroups(void)
+{
+#if !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+    sShardGroupsMutex.Unlock();
+#endif // !WEAVE_SYSTEM_CONFIG_NO_LOCKING
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+
 /**
  *  The Weave Message layer constructor.
  *
@@ -106,10 +161,20 @@ WeaveMessageLayer::WeaveMessageLayer()
 /**
  *  Initialize the Weave Message layer object.
  *
+ *  Several message layers of a process, each with its own InetLayer and System::Layer and each serviced by its own
+ *  thread, may share the Weave port. Each of them is then initialized, in any order, with the number of such shards
+ *  and its own shard index, and the system steers incoming UDP messages to the shard given by GetShardForNode() for
+ *  the node id of the sender, so that all exchanges and sessions with a peer stay on one shard. Incoming IPv6 TCP
+ *  connections from ULA addresses are steered the same way by the node id in the address; other TCP connections
+ *  are spread among the shards by the system. No other socket may share the Weave port with the shards.
+ *
  *  @param[in]  context  A pointer to the InitContext object.
  *
  *  @retval  #WEAVE_NO_ERROR                     on successful initialization.
- *  @retval  #WEAVE_ERROR_INVALID_ARGUMENT       if the passed InitContext object is NULL.
+ *  @retval  #WEAVE_ERROR_INVALID_ARGUMENT       if the passed InitContext object is NULL, or its shard index is
+ *                                               not less than its shard count, or its shard count exceeds
+ *                                               #WEAVE_CONFIG_MAX_SHARDS.
+ *  @retval  #WEAVE_ERROR_NOT_IMPLEMENTED        if sharding was requested and the system cannot steer messages.
  *  @retval  #WEAVE_ERROR_INCORRECT_STATE        if the state of the WeaveMessageLayer object is incorrect.
  *  @retval  other errors generated from the lower Inet layer during endpoint creation.
  *
@@ -124,6 +189,10 @@ WEAVE_ERROR WeaveMessageLayer::Init(InitContext *context)
     if (State != kState_NotInitialized)
         return WEAVE_ERROR_INCORRECT_STATE;
 
+    if (context->shardCount == 0 || context->shardIndex >= context->shardCount ||
+        context->shardCount > WEAVE_CONFIG_MAX_SHARDS)
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+
     SystemLayer = context->systemLayer;
     Inet = context->inet;
 #if CONFIG_NETWORK_LAYER_BLE
@@ -153,6 +222,8 @@ WEAVE_ERROR WeaveMessageLayer::Init(InitContext *context)
     SecurityMgr = NULL;
     IsListening = context->listenTCP || context->listenUDP;
     IncomingConIdleTimeout = 0;
+    ShardIndex = context->shardIndex;
+    ShardCount = context->shardCount;
 
     //Internal and for Debug Only; When set, Message Layer drops message and returns.
     mDropMessage = false;
@@ -1063,6 +1134,19 @@ exit:
     return err;
 }
 
+// Key a cipher mode object with the data key of a message encryption key, reusing the key's cached AES round keys
+// when they are available.
+template <class CipherMode>
+static void SetDataKey(CipherMode& cipherMode, const WeaveMsgEncryptionKey *key, const uint8_t *dataKey)
+{
+#if WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+    cipherMode.SetKey(key->KeySchedule.DataKey);
+    IgnoreUnusedVariable(dataKey);
+#else
+    cipherMode.SetKey(dataKey);
+#endif
+}
+
 WEAVE_ERROR WeaveMessageLayer::ReEncodeMessage(PacketBuffer *msgBuf)
 {
     WeaveMessageInfo msgInfo;
@@ -1096,10 +1180,18 @@ WEAVE_ERROR WeaveMessageLayer::ReEncodeMessage(PacketBuffer *msgBuf)
             // TODO: re-validate MIC to ensure that no part of the message has been altered since the time it was received.
 
             // Re-encrypt the payload.
-            AES128CTRMode aes128CTR;
-            aes128CTR.SetKey(sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey);
-            aes128CTR.SetWeaveMessageCounter(msgInfo.SourceNodeId, msgInfo.MessageId);
-            aes128CTR.EncryptData(p, encryptionLen, p);
+            Encrypt_AES128CTRSHA1(&msgInfo, sessionState.MsgEncKey, p, encryptionLen, p);
+        }
+        break;
+
+    case kWeaveEncryptionType_AES128GCM:
+        {
+            // Re-encrypt the payload. The authentication tag that follows it covers the ciphertext,
+            // which is unchanged, so the tag is left as is.
+            AES128GCMMode aes128GCM;
+            SetDataKey(aes128GCM, sessionState.MsgEncKey, sessionState.MsgEncKey->EncKey.AES128GCM.DataKey);
+            aes128GCM.SetWeaveMessageIV(msgInfo.SourceNodeId, msgInfo.MessageId);
+            aes128GCM.EncryptData(p, encryptionLen - AES128GCMMode::kTagLength, p);
         }
         break;
     default:
@@ -1182,6 +1274,13 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
         headLen += 2;
         tailLen += HMACSHA1::kDigestLength;
         break;
+    case kWeaveEncryptionType_AES128GCM:
+        // Can only encrypt non-zero length payloads.
+        if (payloadLen == 0)
+            return WEAVE_ERROR_INVALID_MESSAGE_LENGTH;
+        headLen += 2;
+        tailLen += AES128GCMMode::kTagLength;
+        break;
     default:
         return WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE;
     }
@@ -1280,15 +1379,25 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
         p += payloadLen;
 
         // Compute the integrity check value and store it immediately after the payload data.
-        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
-                                            payloadStart, payloadLen, p);
+        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey, payloadStart, payloadLen, p);
         p += HMACSHA1::kDigestLength;
 
         // Encrypt the message payload and the integrity check value that follows it, in place, in the message buffer.
-        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
+        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey,
                               payloadStart, payloadLen + HMACSHA1::kDigestLength, payloadStart);
 
         break;
+
+    case kWeaveEncryptionType_AES128GCM:
+        // Encode the key id.
+        LittleEndian::Write16(p, msgInfo->KeyId);
+
+        // Encrypt the message payload in place and store the authentication tag immediately after it.
+        Encrypt_AES128GCM(msgInfo, sessionState.MsgEncKey,
+                          payloadStart, payloadLen, payloadStart, payloadStart + payloadLen);
+        p += payloadLen + AES128GCMMode::kTagLength;
+
+        break;
     }
 
     msgInfo->Flags |= kWeaveMessageFlag_MessageEncoded;
@@ -1348,13 +1457,12 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sour
         *rPayload = p;
 
         // Decrypt the message payload and the integrity check value that follows it, in place, in the message buffer.
-        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
+        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey,
                               p, payloadLen + HMACSHA1::kDigestLength, p);
 
         // Compute the expected integrity check value from the decrypted payload.
         uint8_t expectedIntegrityCheck[HMACSHA1::kDigestLength];
-        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
-                                            p, payloadLen, expectedIntegrityCheck);
+        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey, p, payloadLen, expectedIntegrityCheck);
         // Error if the expected integrity check doesn't match the integrity check in the message.
         if (!ConstantTimeCompare(p + payloadLen, expectedIntegrityCheck, HMACSHA1::kDigestLength))
             return WEAVE_ERROR_INTEGRITY_CHECK_FAILED;
@@ -1364,6 +1472,30 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sour
         break;
     }
 
+    case kWeaveEncryptionType_AES128GCM:
+    {
+        // Error if the message is short given the expected fields.
+        if ((p + kMinPayloadLen + AES128GCMMode::kTagLength) > msgEnd)
+            return WEAVE_ERROR_INVALID_MESSAGE_LENGTH;
+
+        // Return the position and length of the payload within the message.
+        uint16_t payloadLen = msgLen - ((p - msgStart) + AES128GCMMode::kTagLength);
+        *rPayloadLen = payloadLen;
+        *rPayload = p;
+
+        // Decrypt the message payload in place, computing the expected authentication tag as it goes.
+        uint8_t expectedTag[AES128GCMMode::kTagLength];
+        Decrypt_AES128GCM(msgInfo, sessionState.MsgEncKey,
+                          p, payloadLen, p, expectedTag);
+        // Error if the expected tag doesn't match the tag in the message.
+        if (!ConstantTimeCompare(p + payloadLen, expectedTag, AES128GCMMode::kTagLength))
+            return WEAVE_ERROR_INTEGRITY_CHECK_FAILED;
+        // Skip past the payload and the tag.
+        p += payloadLen + AES128GCMMode::kTagLength;
+
+        break;
+    }
+
     default:
         return WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE;
     }
@@ -1426,7 +1558,7 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessageWithLength(PacketBuffer *msgBuf, uin
     // long to ever fit in the buffer.
     if (dataLen < *rFrameLen)
     {
-        if (*rFrameLen > msgBuf->MaxDataLength() + msgBuf->ReservedSize())
+        if (*rFrameLen > msgBuf->AllocSize())
             return WEAVE_ERROR_MESSAGE_TOO_LONG;
         return WEAVE_ERROR_MESSAGE_INCOMPLETE;
     }
@@ -1743,13 +1875,13 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
     // Close and free the general-purpose IPv4 and IPv6 UDP endpoints.
     if (mIPv4UDP != NULL)
     {
-        mIPv4UDP->Free();
+        FreeShardedEndPoint(mIPv4UDP);
         mIPv4UDP = NULL;
     }
 #endif // INET_CONFIG_ENABLE_IPV4
     if (mIPv6UDP != NULL)
     {
-        mIPv6UDP->Free();
+        FreeShardedEndPoint(mIPv6UDP);
         mIPv6UDP = NULL;
     }
 
@@ -1759,7 +1891,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
         if (mIPv6UDPLocalAddr[i] != NULL)
         {
             if (mIPv6UDPLocalAddr[i] != mIPv6UDP)
-                mIPv6UDPLocalAddr[i]->Free();
+                FreeShardedEndPoint(mIPv6UDPLocalAddr[i]);
             mIPv6UDPLocalAddr[i] = NULL;
         }
 
@@ -1821,7 +1953,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
             mIPv4TCPListen->AppState = this;
             mIPv4TCPListen->OnConnectionReceived = HandleIncomingTcpConnection;
             mIPv4TCPListen->OnAcceptError = HandleAcceptError;
-            res = mIPv4TCPListen->Listen(1);
+            res = ListenShardedEndPoint(mIPv4TCPListen, kIPAddressType_IPv4, WEAVE_IPV4_LISTEN_ADDR, WEAVE_PORT);
             if (res != WEAVE_NO_ERROR)
                 goto exit;
         }
@@ -1855,7 +1987,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
             mIPv6TCPListen->AppState = this;
             mIPv6TCPListen->OnConnectionReceived = HandleIncomingTcpConnection;
             mIPv6TCPListen->OnAcceptError = HandleAcceptError;
-            res = mIPv6TCPListen->Listen(1);
+            res = ListenShardedEndPoint(mIPv6TCPListen, kIPAddressType_IPv6, WEAVE_IPV6_LISTEN_ADDR, WEAVE_PORT);
             if (res != WEAVE_NO_ERROR)
                 goto exit;
         }
@@ -1889,7 +2021,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
             mUnsecuredIPv6TCPListen->AppState = this;
             mUnsecuredIPv6TCPListen->OnConnectionReceived = HandleIncomingTcpConnection;
             mUnsecuredIPv6TCPListen->OnAcceptError = HandleAcceptError;
-            res = mUnsecuredIPv6TCPListen->Listen(1);
+            res = ListenShardedEndPoint(mUnsecuredIPv6TCPListen, kIPAddressType_IPv6, WEAVE_IPV6_LISTEN_ADDR, WEAVE_UNSECURED_PORT);
             if (res != WEAVE_NO_ERROR)
                 goto exit;
         }
@@ -1897,7 +2029,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
 
     else if (mUnsecuredIPv6TCPListen != NULL)
     {
-        mUnsecuredIPv6TCPListen->Free();
+        FreeShardedEndPoint(mUnsecuredIPv6TCPListen);
         mUnsecuredIPv6TCPListen = NULL;
     }
 #endif // WEAVE_CONFIG_ENABLE_UNSECURED_TCP_LISTEN
@@ -1917,7 +2049,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
 
         // Bind the endpoint.  If a listening IPv4 address was specified bind to that,
         // otherwise bind to all addresses.
-        res = mIPv4UDP->Bind(kIPAddressType_IPv4, WEAVE_IPV4_LISTEN_ADDR, WEAVE_PORT);
+        res = BindShardedEndPoint(mIPv4UDP, kIPAddressType_IPv4, WEAVE_IPV4_LISTEN_ADDR, WEAVE_PORT, INET_NULL_INTERFACEID);
         if (res != WEAVE_NO_ERROR)
             goto exit;
 
@@ -1951,7 +2083,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
 
         // Bind the endpoint.  If a particular IPv6 address was specified, bind to that address and its
         // associated interface. Otherwise bind to all IPv6 addresses.
-        res = mIPv6UDP->Bind(kIPAddressType_IPv6, WEAVE_IPV6_LISTEN_ADDR, WEAVE_PORT, WEAVE_IPV6_LISTEN_INTF);
+        res = BindShardedEndPoint(mIPv6UDP, kIPAddressType_IPv6, WEAVE_IPV6_LISTEN_ADDR, WEAVE_PORT, WEAVE_IPV6_LISTEN_INTF);
         if (res != WEAVE_NO_ERROR)
             goto exit;
 
@@ -2074,7 +2206,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
 
                 // Bind the endpoint to the identified address.  This ensures that messages sent over the endpoint
                 // have the correct source address and port.
-                epErr = ep->Bind(kIPAddressType_IPv6, curAddr, WEAVE_PORT, curIntfId);
+                epErr = BindShardedEndPoint(ep, kIPAddressType_IPv6, curAddr, WEAVE_PORT, curIntfId);
 
                 // Enable reception of incoming messages.
                 WeaveBindLog("Listening on IPv6 UDP interface endpoint");
@@ -2092,7 +2224,7 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
                     epCount++;
                 else
                 {
-                    ep->Free();
+                    FreeShardedEndPoint(ep);
                     ep = NULL;
                 }
             }
@@ -2118,24 +2250,28 @@ exit:
     return res;
 }
 
-void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
                                               const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
 {
     AES128CTRMode aes128CTR;
-    aes128CTR.SetKey(key);
+    SetDataKey(aes128CTR, key, key->EncKey.AES128CTRSHA1.DataKey);
     aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
     aes128CTR.EncryptData(inData, inLen, outBuf);
 }
 
-void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
                                                             const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
 {
     HMACSHA1 hmacSHA1;
     uint8_t encodedBuf[2 * sizeof(uint64_t) + sizeof(uint16_t) + sizeof(uint32_t)];
     uint8_t *p = encodedBuf;
 
-    // Initialize HMAC Key.
-    hmacSHA1.Begin(key, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize);
+    // Initialize HMAC Key, resuming from the cached pad states if available.
+#if WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES
+    hmacSHA1.Begin(key->KeySchedule.IntegrityKey);
+#else
+    hmacSHA1.Begin(key->EncKey.AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize);
+#endif
 
     // Encode the source and destination node identifiers in a little-endian format.
     Encoding::LittleEndian::Write64(p, msgInfo->SourceNodeId);
@@ -2165,6 +2301,46 @@ void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageIn
     hmacSHA1.Finish(outBuf);
 }
 
+// Authenticate the source and destination node ids, the message header field and the message id
+// alongside the payload.
+static void AddMessageAAD_AES128GCM(AES128GCMMode& aes128GCM, const WeaveMessageInfo *msgInfo)
+{
+    uint16_t headerField = EncodeHeaderField(msgInfo);
+    uint8_t encodedBuf[2 * sizeof(uint64_t) + sizeof(uint16_t) + sizeof(uint32_t)];
+    uint8_t *p = encodedBuf;
+
+    Encoding::LittleEndian::Write64(p, msgInfo->SourceNodeId);
+    Encoding::LittleEndian::Write64(p, msgInfo->DestNodeId);
+
+    // Mask destination and source node Id flags.
+    Encoding::LittleEndian::Write16(p, headerField & kMsgHeaderField_MessageHMACMask);
+    Encoding::LittleEndian::Write32(p, msgInfo->MessageId);
+
+    aes128GCM.AddAAD(encodedBuf, p - encodedBuf);
+}
+
+void WeaveMessageLayer::Encrypt_AES128GCM(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
+                                          const uint8_t *inData, uint16_t inLen, uint8_t *outBuf, uint8_t *tag)
+{
+    AES128GCMMode aes128GCM;
+    SetDataKey(aes128GCM, key, key->EncKey.AES128GCM.DataKey);
+    aes128GCM.SetWeaveMessageIV(msgInfo->SourceNodeId, msgInfo->MessageId);
+    AddMessageAAD_AES128GCM(aes128GCM, msgInfo);
+    aes128GCM.EncryptData(inData, inLen, outBuf);
+    aes128GCM.GetTag(tag);
+}
+
+void WeaveMessageLayer::Decrypt_AES128GCM(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
+                                          const uint8_t *inData, uint16_t inLen, uint8_t *outBuf, uint8_t *tag)
+{
+    AES128GCMMode aes128GCM;
+    SetDataKey(aes128GCM, key, key->EncKey.AES128GCM.DataKey);
+    aes128GCM.SetWeaveMessageIV(msgInfo->SourceNodeId, msgInfo->MessageId);
+    AddMessageAAD_AES128GCM(aes128GCM, msgInfo);
+    aes128GCM.DecryptData(inData, inLen, outBuf);
+    aes128GCM.GetTag(tag);
+}
+
 /**
  *  Close all open TCP and UDP endpoints. Then abort any
  *  open WeaveConnections and shutdown any open
@@ -2184,13 +2360,13 @@ WEAVE_ERROR WeaveMessageLayer::CloseEndpoints()
 
     if (mIPv6TCPListen != NULL)
     {
-        mIPv6TCPListen->Free();
+        FreeShardedEndPoint(mIPv6TCPListen);
         mIPv6TCPListen = NULL;
     }
 
     if (mIPv6UDP != NULL)
     {
-        mIPv6UDP->Free();
+        FreeShardedEndPoint(mIPv6UDP);
         mIPv6UDP = NULL;
     }
 
@@ -2208,7 +2384,7 @@ WEAVE_ERROR WeaveMessageLayer::CloseEndpoints()
 
     if (mUnsecuredIPv6TCPListen != NULL)
     {
-        mUnsecuredIPv6TCPListen->Free();
+        FreeShardedEndPoint(mUnsecuredIPv6TCPListen);
         mUnsecuredIPv6TCPListen = NULL;
     }
 
@@ -2219,7 +2395,7 @@ WEAVE_ERROR WeaveMessageLayer::CloseEndpoints()
         if (mIPv6UDPLocalAddr[i] != NULL)
         {
             if (mIPv6UDPLocalAddr[i] != mIPv6UDP)
-                mIPv6UDPLocalAddr[i]->Free();
+                FreeShardedEndPoint(mIPv6UDPLocalAddr[i]);
             mIPv6UDPLocalAddr[i] = NULL;
         }
     }
@@ -2227,13 +2403,13 @@ WEAVE_ERROR WeaveMessageLayer::CloseEndpoints()
 #if INET_CONFIG_ENABLE_IPV4
     if (mIPv4TCPListen != NULL)
     {
-        mIPv4TCPListen->Free();
+        FreeShardedEndPoint(mIPv4TCPListen);
         mIPv4TCPListen = NULL;
     }
 
     if (mIPv4UDP != NULL)
     {
-        mIPv4UDP->Free();
+        FreeShardedEndPoint(mIPv4UDP);
         mIPv4UDP = NULL;
     }
 #endif // INET_CONFIG_ENABLE_IPV4
@@ -2328,6 +2504,306 @@ void WeaveMessageLayer::SignalMessageLayerActivityChanged(void)
     }
 }
 
+/**
+ *  Get the shard that receives the messages of a peer node when message layers share the Weave port.
+ *
+ *  The system steers each incoming UDP message to the shard computed here from the source node id in its header or,
+ *  failing that, from the interface id of its IPv6 ULA source address, and each incoming IPv6 TCP connection from
+ *  the interface id of its ULA source address. An application with several shards uses this to pick the shard that
+ *  initiates exchanges with a peer, so that the responses reach the same shard.
+ *
+ *  @param[in]    nodeId        The node id of the peer.
+ *
+ *  @param[in]    shardCount    The number of shards.
+ *
+ *  @return the index of the shard for the peer.
+ */
+uint8_t WeaveMessageLayer::GetShardForNode(uint64_t nodeId, uint8_t shardCount)
+{
+    return static_cast<uint8_t>(static_cast<uint32_t>(nodeId) % shardCount);
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+enum
+{
+    // The longest steering program: the source node id branch, the ULA source address branch, a test and a return
+    // for each member and the final return.
+    kMaxShardProgramLength = 19 + 5 + 2 * WEAVE_CONFIG_MAX_SHARDS + 1,
+};
+
+static void AppendShardInstruction(struct sock_filter *program, uint16_t &len, uint16_t code, uint8_t jt, uint8_t jf, uint32_t k)
+{
+    program[len].code = code;
+    program[len].jt = jt;
+    program[len].jf = jf;
+    program[len].k = k;
+    len++;
+}
+
+/**
+ *  Build the program steering the messages or connections received by a group to the member of their shard, and
+ *  return its length.
+ *
+ *  The program computes GetShardForNode() in the system, using the low 32 bits of the source node id where the
+ *  message header carries it (UDP only), or of the interface id of an IPv6 ULA source address otherwise, then
+ *  returns the number of the member of that shard in the group. Messages without a node id, and those for a shard
+ *  without a member in the group, are left to the system hash of their addresses and ports.
+ */
+static uint16_t BuildShardProgram(const ShardGroup &group, struct sock_filter *program)
+{
+    // The packet data of a UDP program is the UDP payload, i.e. the Weave message. The little-endian node id is
+    // assembled byte by byte, as the program loads words in network byte order.
+    enum
+    {
+        kHeaderFieldFlagsOffset = 1,
+        kSourceNodeIdOffset     = 6,
+        kMinMessageLength       = kSourceNodeIdOffset + 8,
+        kIPv6SrcAddrOffset      = 8,
+        kIPv6SrcNodeIdOffset    = kIPv6SrcAddrOffset + 12,
+        kIPv6ULAPrefix          = 0xFD,
+    };
+    uint16_t len = 0;
+    uint16_t jumpToMap = 0;
+
+    if (!group.IsTCP)
+    {
+        AppendShardInstruction(program, len, BPF_LD | BPF_W | BPF_LEN, 0, 0, 0);
+        AppendShardInstruction(program, len, BPF_JMP | BPF_JGE | BPF_K, 0, 17, kMinMessageLength);
+        AppendShardInstruction(program, len, BPF_LD | BPF_B | BPF_ABS, 0, 0, kHeaderFieldFlagsOffset);
+        AppendShardInstruction(program, len, BPF_JMP | BPF_JSET | BPF_K, 0, 15, kWeaveHeaderFlag_SourceNodeId >> 8);
+        AppendShardInstruction(program, len, BPF_LD | BPF_B | BPF_ABS, 0, 0, kSourceNodeIdOffset + 3);
+        for (uint8_t i = 3; i > 0; i--)
+        {
+            AppendShardInstruction(program, len, BPF_ALU | BPF_LSH | BPF_K, 0, 0, 8);
+            AppendShardInstruction(program, len, BPF_MISC | BPF_TAX, 0, 0, 0);
+            AppendShardInstruction(program, len, BPF_LD | BPF_B | BPF_ABS, 0, 0, kSourceNodeIdOffset + i - 1);
+            AppendShardInstruction(program, len, BPF_ALU | BPF_OR | BPF_X, 0, 0, 0);
+        }
+        AppendShardInstruction(program, len, BPF_ALU | BPF_MOD | BPF_K, 0, 0, group.ShardCount);
+        jumpToMap = len;
+        AppendShardInstruction(program, len, BPF_JMP | BPF_JA, 0, 0, 0);
+    }
+
+    // No source node id in the header; only IPv6 ULA source addresses carry a node id.
+    if (group.AddrType == kIPAddressType_IPv6)
+    {
+        AppendShardInstruction(program, len, BPF_LD | BPF_B | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_NET_OFF + kIPv6SrcAddrOffset));
+        AppendShardInstruction(program, len, BPF_JMP | BPF_JEQ | BPF_K, 1, 0, kIPv6ULAPrefix);
+        AppendShardInstruction(program, len, BPF_RET | BPF_K, 0, 0, UINT32_MAX);
+        AppendShardInstruction(program, len, BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_NET_OFF + kIPv6SrcNodeIdOffset));
+        AppendShardInstruction(program, len, BPF_ALU | BPF_MOD | BPF_K, 0, 0, group.ShardCount);
+    }
+    else
+        AppendShardInstruction(program, len, BPF_RET | BPF_K, 0, 0, UINT32_MAX);
+
+    if (!group.IsTCP)
+        program[jumpToMap].k = len - jumpToMap - 1;
+
+    // Map the shard to the number of its member.
+    for (uint8_t i = 0; i < group.NumMembers; i++)
+    {
+        AppendShardInstruction(program, len, BPF_JMP | BPF_JEQ | BPF_K, 0, 1, group.MemberShards[i]);
+        AppendShardInstruction(program, len, BPF_RET | BPF_K, 0, 0, i);
+    }
+    AppendShardInstruction(program, len, BPF_RET | BPF_K, 0, 0, UINT32_MAX);
+
+    return len;
+}
+
+/**
+ *  Attach the steering program for the current members of a group, through one of its members.
+ */
+static WEAVE_ERROR AttachShardProgram(const ShardGroup &group, EndPointBasis *endPoint)
+{
+    struct sock_filter program[kMaxShardProgramLength];
+    uint16_t len = BuildShardProgram(group, program);
+
+    if (group.IsTCP)
+        return static_cast<TCPEndPoint *>(endPoint)->SetReusePortFilter(program, len);
+    else
+        return static_cast<UDPEndPoint *>(endPoint)->SetReusePortFilter(program, len);
+}
+
+/**
+ *  Record that an endpoint has just joined the group of its address, port and protocol, and steer the messages of
+ *  its shard to it. Must be called with the shard groups locked.
+ */
+static WEAVE_ERROR JoinShardGroup(EndPointBasis *endPoint, bool isTCP, IPAddressType addrType, const IPAddress &addr,
+        uint16_t port, InterfaceId intf, uint8_t shardIndex, uint8_t shardCount)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    ShardGroup *group = NULL;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_SHARD_GROUPS; i++)
+    {
+        ShardGroup &cur = sShardGroups[i];
+
+        if (cur.NumMembers == 0)
+        {
+            if (group == NULL)
+                group = &cur;
+        }
+        else if (cur.IsTCP == isTCP && cur.AddrType == addrType && cur.Addr == addr && cur.Port == port && cur.Intf == intf)
+        {
+            group = &cur;
+            break;
+        }
+    }
+
+    VerifyOrExit(group != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    VerifyOrExit(group->NumMembers < WEAVE_CONFIG_MAX_SHARDS, err = WEAVE_ERROR_NO_MEMORY);
+
+    if (group->NumMembers == 0)
+    {
+        group->Addr = addr;
+        group->Intf = intf;
+        group->Port = port;
+        group->AddrType = addrType;
+        group->IsTCP = isTCP;
+    }
+
+    // The endpoint is a member for the system whether or not the program can be attached, so it is recorded first.
+    group->ShardCount = shardCount;
+    group->MemberShards[group->NumMembers] = shardIndex;
+    group->Members[group->NumMembers] = endPoint;
+    group->NumMembers++;
+
+    err = AttachShardProgram(*group, endPoint);
+
+exit:
+    return err;
+}
+
+/**
+ *  Record that an endpoint has just been closed, if it was a member of a group, and steer the messages of the
+ *  remaining members again. Must be called with the shard groups locked.
+ *
+ *  The program is attached through another member, i.e. possibly an endpoint of another shard. This is safe as the
+ *  members are only closed with the shard groups locked.
+ */
+static void LeaveShardGroup(EndPointBasis *endPoint)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_SHARD_GROUPS; i++)
+    {
+        ShardGroup &group = sShardGroups[i];
+
+        for (uint8_t j = 0; j < group.NumMembers; j++)
+        {
+            if (group.Members[j] == endPoint)
+            {
+                WEAVE_ERROR err;
+
+                group.NumMembers--;
+                group.Members[j] = group.Members[group.NumMembers];
+                group.MemberShards[j] = group.MemberShards[group.NumMembers];
+
+                if (group.NumMembers > 0)
+                {
+                    err = AttachShardProgram(group, group.Members[0]);
+                    if (err != WEAVE_NO_ERROR)
+                        WeaveLogError(MessageLayer, "Failed to steer messages to shards: %s", ErrorStr(err));
+                }
+
+                return;
+            }
+        }
+    }
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+/**
+ *  Bind a UDP endpoint to the Weave port and, if the message layer is sharded, make it the member of its shard in the
+ *  group of endpoints bound to the same address.
+ */
+WEAVE_ERROR WeaveMessageLayer::BindShardedEndPoint(UDPEndPoint *endPoint, IPAddressType addrType, const IPAddress &addr,
+        uint16_t port, InterfaceId intf)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    if (ShardCount <= 1)
+        return endPoint->Bind(addrType, addr, port, intf);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+    LockShardGroups();
+
+    err = endPoint->Bind(addrType, addr, port, intf);
+    if (err == WEAVE_NO_ERROR)
+        err = JoinShardGroup(endPoint, false, addrType, addr, port, intf, ShardIndex, ShardCount);
+
+    UnlockShardGroups();
+#else // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+    err = WEAVE_ERROR_NOT_IMPLEMENTED;
+#endif // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+
+    if (err != WEAVE_NO_ERROR)
+        WeaveLogError(MessageLayer, "Failed to steer messages to shard %u: %s", ShardIndex, ErrorStr(err));
+
+    return err;
+}
+
+/**
+ *  Listen on a bound TCP endpoint and, if the message layer is sharded, make it the member of its shard in the group
+ *  of endpoints listening on the same address. Only IPv6 connection requests can be steered, so IPv4 endpoints are
+ *  left to the system hash.
+ */
+WEAVE_ERROR WeaveMessageLayer::ListenShardedEndPoint(TCPEndPoint *endPoint, IPAddressType addrType, const IPAddress &addr,
+        uint16_t port)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    if (ShardCount <= 1 || addrType != kIPAddressType_IPv6)
+        return endPoint->Listen(1);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+    LockShardGroups();
+
+    err = endPoint->Listen(1);
+    if (err == WEAVE_NO_ERROR)
+        err = JoinShardGroup(endPoint, true, addrType, addr, port, INET_NULL_INTERFACEID, ShardIndex, ShardCount);
+
+    UnlockShardGroups();
+#else // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+    err = WEAVE_ERROR_NOT_IMPLEMENTED;
+#endif // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+
+    if (err != WEAVE_NO_ERROR)
+        WeaveLogError(MessageLayer, "Failed to steer connections to shard %u: %s", ShardIndex, ErrorStr(err));
+
+    return err;
+}
+
+/**
+ *  Free an endpoint bound with BindShardedEndPoint(), taking it out of its group.
+ */
+void WeaveMessageLayer::FreeShardedEndPoint(UDPEndPoint *endPoint)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+    LockShardGroups();
+    endPoint->Free();
+    LeaveShardGroup(endPoint);
+    UnlockShardGroups();
+#else // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+    endPoint->Free();
+#endif // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+}
+
+/**
+ *  Free an endpoint listening with ListenShardedEndPoint(), taking it out of its group.
+ */
+void WeaveMessageLayer::FreeShardedEndPoint(TCPEndPoint *endPoint)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF)
+    LockShardGroups();
+    endPoint->Free();
+    LeaveShardGroup(endPoint);
+    UnlockShardGroups();
+#else // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+    endPoint->Free();
+#endif // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(SO_ATTACH_REUSEPORT_CBPF))
+}
+
 /**
  *  Get the max Weave payload size for a message configuration and supplied
  *  PacketBuffer.
@@ -160,8 +160,10 @@ typedef enum WeaveMessageFlags
 typedef enum WeaveEncryptionType
 {
     kWeaveEncryptionType_None                           = 0, /**< Message not encrypted. */
-    kWeaveEncryptionType_AES128CTRSHA1                  = 1  /**< Message encrypted using AES-128-CTR
+    kWeaveEncryptionType_AES128CTRSHA1                  = 1, /**< Message encrypted using AES-128-CTR
                                                                   encryption with HMAC-SHA-1 message integrity. */
+    kWeaveEncryptionType_AES128GCM                      = 2  /**< Message encrypted and authenticated in a single
+                                                                  pass using AES-128-GCM. */
 } WeaveEncryptionType;
 
 /**
@@ -498,6 +500,8 @@ public:
         InetLayer*          inet;           /**< A pointer to the InetLayer object. */
         bool                listenTCP;      /**< Boolean flag to indicate if listening over TCP. */
         bool                listenUDP;      /**< Boolean flag to indicate if listening over UDP. */
+        uint8_t             shardIndex;     /**< Index of this message layer among those sharing the Weave port. */
+        uint8_t             shardCount;     /**< Number of message layers sharing the Weave port, 1 if not sharded. */
 #if CONFIG_NETWORK_LAYER_BLE
         BleLayer*           ble;            /**< A pointer to the BleLayer object. */
         bool                listenBLE;      /**< Boolean flag to indicate if listening over BLE. */
@@ -514,6 +518,8 @@ public:
             fabricState = NULL;
             listenTCP = true;
             listenUDP = true;
+            shardIndex = 0;
+            shardCount = 1;
 #if CONFIG_NETWORK_LAYER_BLE
             ble = NULL;
             listenBLE = true;
@@ -535,6 +541,10 @@ public:
                                                              false otherwise. */
     bool mDropMessage;                                  /**< Internal and for Debug Only; When set, WeaveMessageLayer
                                                              drops the message and returns. */
+    uint8_t ShardIndex;                                 /**< [READ ONLY] The index of this object among the message layers
+                                                             sharing the Weave port. */
+    uint8_t ShardCount;                                 /**< [READ ONLY] The number of message layers sharing the Weave
+                                                             port, 1 if not sharded. */
 
     WEAVE_ERROR Init(InitContext *context);
     WEAVE_ERROR Shutdown(void);
@@ -669,6 +679,7 @@ public:
     void SignalMessageLayerActivityChanged(void);
 
     static uint32_t GetMaxWeavePayloadSize(const PacketBuffer *msgBuf, bool isUDP, uint32_t udpMTU);
+    static uint8_t GetShardForNode(uint64_t nodeId, uint8_t shardCount);
 
     static void GetPeerDescription(char *buf, size_t bufSize, uint64_t nodeId, const IPAddress *addr, uint16_t port, InterfaceId interfaceId, const WeaveConnection *con);
     static void GetPeerDescription(char *buf, size_t bufSize, const WeaveMessageInfo *msgInfo);
@@ -712,6 +723,11 @@ private:
     void *UnsecuredConnectionReceivedAppState;
     MessageLayerActivityChangeHandlerFunct OnMessageLayerActivityChange;
 
+    WEAVE_ERROR BindShardedEndPoint(UDPEndPoint *endPoint, IPAddressType addrType, const IPAddress &addr, uint16_t port,
+            InterfaceId intf);
+    WEAVE_ERROR ListenShardedEndPoint(TCPEndPoint *endPoint, IPAddressType addrType, const IPAddress &addr, uint16_t port);
+    static void FreeShardedEndPoint(UDPEndPoint *endPoint);
+    static void FreeShardedEndPoint(TCPEndPoint *endPoint);
     WEAVE_ERROR EnableUnsecuredListen(void);
     WEAVE_ERROR DisableUnsecuredListen(void);
     bool IsUnsecuredListenEnabled(void) const;
@@ -730,10 +746,14 @@ private:
     static void HandleIncomingTcpConnection(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint, const IPAddress &peerAddr,
             uint16_t peerPort);
     static void HandleAcceptError(TCPEndPoint *endPoint, INET_ERROR err);
-    static void Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+    static void Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
                                       const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
-    static void ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+    static void ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
                                                     const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
+    static void Encrypt_AES128GCM(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
+                                  const uint8_t *inData, uint16_t inLen, uint8_t *outBuf, uint8_t *tag);
+    static void Decrypt_AES128GCM(const WeaveMessageInfo *msgInfo, const WeaveMsgEncryptionKey *key,
+                                  const uint8_t *inData, uint16_t inLen, uint8_t *outBuf, uint8_t *tag);
     static bool IsIgnoredMulticastSendError(WEAVE_ERROR err);
 
     static bool IsSendErrorNonCritical(WEAVE_ERROR err);
@@ -27,6 +27,8 @@
 #define __STDC_FORMAT_MACROS
 #endif // __STDC_FORMAT_MACROS
 
+#include <string.h>
+
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Core/WeaveServerBase.h>
 #include <Weave/Profiles/WeaveProfiles.h>
@@ -93,13 +95,7 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
     OnSessionEstablished = NULL;
     OnSessionError = NULL;
     OnKeyErrorMsgRcvd = NULL;
-    mEC = NULL;
-    mCon = NULL;
-#if WEAVE_CONFIG_ENABLE_PASE_INITIATOR || WEAVE_CONFIG_ENABLE_PASE_RESPONDER
-    mPASEEngine = NULL;
-#endif
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
-    mCASEEngine = NULL;
     mDefaultAuthDelegate = NULL;
 #endif
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR
@@ -112,9 +108,6 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
     ResponderAllowedCASEConfigs = CASE::kCASEAllowedConfig_Config2|CASE::kCASEAllowedConfig_Config1;
     ResponderAllowedCASECurves = WEAVE_CONFIG_DEFAULT_CASE_ALLOWED_CURVES;
 #endif
-#if WEAVE_CONFIG_ENABLE_TAKE_INITIATOR || WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
-    mTAKEEngine = NULL;
-#endif
 #if WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
     mDefaultTAKETokenAuthDelegate = NULL;
 #endif
@@ -122,7 +115,6 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
     mDefaultTAKEChallengerAuthDelegate = NULL;
 #endif
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
-    mKeyExport = NULL;
     InitiatorKeyExportConfig = KeyExport::kKeyExportConfig_Config1;
     InitiatorAllowedKeyExportConfigs = KeyExport::kKeyExportSupportedConfig_All;
 #endif
@@ -135,15 +127,26 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR || WEAVE_CONFIG_ENABLE_KEY_EXPORT_RESPONDER
     mDefaultKeyExportDelegate = NULL;
 #endif
-    mStartSecureSession_OnComplete = NULL;
-    mStartSecureSession_OnError = NULL;
-    mStartSecureSession_ReqState = NULL;
-    mRequestedAuthMode = kWeaveAuthMode_NotSpecified;
-    mSessionKeyId = WeaveKeyId::kNone;
-    mEncType = kWeaveEncryptionType_None;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        SessionContext *sess = &mSessions[i];
+
+        memset(sess, 0, sizeof(*sess));
+        sess->SecMgr = this;
+        sess->RequestedAuthMode = kWeaveAuthMode_NotSpecified;
+        sess->SessionKeyId = WeaveKeyId::kNone;
+        sess->EncType = kWeaveEncryptionType_None;
+        sess->State = kState_Idle;
+    }
+    mActiveSessionCount = 0;
+    mTimeConsumingCryptoCount = 0;
 
     mFlags = 0;
 
+    err = mCryptoWorkers.Init(aSystemLayer, WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS);
+    SuccessOrExit(err);
+
     err = ExchangeManager->RegisterUnsolicitedMessageHandler(kWeaveProfile_Security, HandleUnsolicitedMessage, this);
     SuccessOrExit(err);
 
@@ -152,6 +155,8 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
     State = kState_Idle;
 
 exit:
+    if (err != WEAVE_NO_ERROR)
+        mCryptoWorkers.Shutdown();
     return err;
 }
 
@@ -172,9 +177,22 @@ WEAVE_ERROR WeaveSecurityManager::Shutdown(void)
         ExchangeManager->UnregisterUnsolicitedMessageHandler(kWeaveProfile_Security);
         ExchangeManager = NULL;
 
-        // TODO: clean-up in-progress session establishment
+        // Stop the crypto workers before tearing down the sessions they may be using.
+        mCryptoWorkers.Shutdown();
 
-        Reset();
+        // No completions will arrive for jobs still in flight, so end the time-consuming period here.
+        if (mTimeConsumingCryptoCount != 0)
+        {
+            mTimeConsumingCryptoCount = 0;
+            Platform::Security::OnTimeConsumingCryptoDone();
+        }
+
+        // Abandon any in-progress interactions.
+        for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+        {
+            if (!mSessions[i].IsFree())
+                Reset(&mSessions[i]);
+        }
 
         State = kState_NotInitialized;
     }
@@ -187,6 +205,7 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = NULL;
 
     // Handle Key Error Messages.
     if (profileId == kWeaveProfile_Security && msgType == kMsgType_KeyError)
@@ -198,9 +217,6 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
         ExitNow();
     }
 
-    // Verify that we don't already have a session establishment in progress.
-    VerifyOrExit(secMgr->State == kState_Idle, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
-
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_SecMgrBusy,
         {
             secMgr->AsyncNotifySecurityManagerAvailable();
@@ -223,7 +239,11 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
         // PASE is not supported over WRMP.
         VerifyOrExit(ec->Con != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-        secMgr->HandlePASESessionStart(ec, pktInfo, msgInfo, msgBuf);
+        // Claim a session context, subject to the overall and per-peer concurrency limits.
+        sess = secMgr->AllocSession(ec->PeerNodeId, kState_PASEInProgress);
+        VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+        secMgr->HandlePASESessionStart(sess, ec, pktInfo, msgInfo, msgBuf);
         msgBuf = NULL;
 #else
         ExitNow(err = WEAVE_ERROR_NOT_IMPLEMENTED);
@@ -234,7 +254,10 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
     else if (profileId == kWeaveProfile_Security && msgType == kMsgType_CASEBeginSessionRequest)
     {
 #if WEAVE_CONFIG_ENABLE_CASE_RESPONDER
-        secMgr->HandleCASESessionStart(ec, pktInfo, msgInfo, msgBuf);
+        sess = secMgr->AllocSession(ec->PeerNodeId, kState_CASEInProgress);
+        VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+        secMgr->HandleCASESessionStart(sess, ec, pktInfo, msgInfo, msgBuf);
         msgBuf = NULL;
 #else
         ExitNow(err = WEAVE_ERROR_NOT_IMPLEMENTED);
@@ -249,7 +272,10 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
         // TAKE is not supported over WRMP.
         VerifyOrExit(ec->Con != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-        secMgr->HandleTAKESessionStart(ec, pktInfo, msgInfo, msgBuf);
+        sess = secMgr->AllocSession(ec->PeerNodeId, kState_TAKEInProgress);
+        VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+        secMgr->HandleTAKESessionStart(sess, ec, pktInfo, msgInfo, msgBuf);
         msgBuf = NULL;
 #else
         ExitNow(err = WEAVE_ERROR_NOT_IMPLEMENTED);
@@ -260,7 +286,10 @@ void WeaveSecurityManager::HandleUnsolicitedMessage(ExchangeContext *ec, const I
     else if (profileId == kWeaveProfile_Security && msgType == kMsgType_KeyExportRequest)
     {
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_RESPONDER
-        secMgr->HandleKeyExportRequest(ec, pktInfo, msgInfo, msgBuf);
+        sess = secMgr->AllocSession(ec->PeerNodeId, kState_KeyExportInProgress);
+        VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+        secMgr->HandleKeyExportRequest(sess, ec, pktInfo, msgInfo, msgBuf);
         msgBuf = NULL;
 #else
         ExitNow(err = WEAVE_ERROR_NOT_IMPLEMENTED);
@@ -307,14 +336,12 @@ WEAVE_ERROR WeaveSecurityManager::StartPASESession(WeaveConnection *con, WeaveAu
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     WeaveSessionKey *sessionKey;
+    SessionContext *sess = NULL;
     bool clearStateOnError = false;
 
     // Verify security manager has been initialized.
     VerifyOrExit(State != kState_NotInitialized, err = WEAVE_ERROR_INCORRECT_STATE);
 
-    // Verify there is no session in process.
-    VerifyOrExit(State == kState_Idle, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
-
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_SecMgrBusy,
         {
             AsyncNotifySecurityManagerAvailable();
@@ -328,14 +355,17 @@ WEAVE_ERROR WeaveSecurityManager::StartPASESession(WeaveConnection *con, WeaveAu
     // PASE is not yet supported over WRMP.
     VerifyOrExit(con != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-    State = kState_PASEInProgress;
-    mRequestedAuthMode = requestedAuthMode;
-    mEncType = kWeaveEncryptionType_AES128CTRSHA1;
-    mCon = con;
-    mStartSecureSession_OnComplete = onComplete;
-    mStartSecureSession_OnError = onError;
-    mStartSecureSession_ReqState = reqState;
-    mSessionKeyId = WeaveKeyId::kNone;
+    // Claim a session context, subject to the overall and per-peer concurrency limits.
+    sess = AllocSession(con->PeerNodeId, kState_PASEInProgress);
+    VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+    sess->RequestedAuthMode = requestedAuthMode;
+    sess->EncType = WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE;
+    sess->Con = con;
+    sess->StartSecureSession_OnComplete = onComplete;
+    sess->StartSecureSession_OnError = onError;
+    sess->StartSecureSession_ReqState = reqState;
+    sess->SessionKeyId = WeaveKeyId::kNone;
 
     // Any error after this point requires call to the Reset() function.
     clearStateOnError = true;
@@ -345,68 +375,119 @@ WEAVE_ERROR WeaveSecurityManager::StartPASESession(WeaveConnection *con, WeaveAu
     err = FabricState->AllocSessionKey(con->PeerNodeId, WeaveKeyId::kNone, con, sessionKey);
     SuccessOrExit(err);
     sessionKey->SetLocallyInitiated(true);
-    mSessionKeyId = sessionKey->MsgEncKey.KeyId;
+    sess->SessionKeyId = sessionKey->MsgEncKey.KeyId;
 
     // Create a new exchange context.
-    err = NewSessionExchange(mCon->PeerNodeId, mCon->PeerAddr, mCon->PeerPort);
+    err = NewSessionExchange(sess, sess->Con->PeerNodeId, sess->Con->PeerAddr, sess->Con->PeerPort);
     SuccessOrExit(err);
 
-    // Initialize Weave platform memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Allocate and initialize PASE engine object.
-    mPASEEngine = (WeavePASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeavePASEEngine), true);
-    VerifyOrExit(mPASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mPASEEngine->Init();
+    sess->PASEEngine = (WeavePASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeavePASEEngine), true);
+    VerifyOrExit(sess->PASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->PASEEngine->Init();
 
     // Initialize PASE password if provided.
     if (pw != NULL)
     {
-        mPASEEngine->Pw = pw;
-        mPASEEngine->PwLen = pwLen;
+        sess->PASEEngine->Pw = pw;
+        sess->PASEEngine->PwLen = pwLen;
     }
 
     // Start PASE session.
-    StartPASESession();
+    StartPASESession(sess);
 
 exit:
     if (err != WEAVE_NO_ERROR && clearStateOnError)
     {
-        if (mSessionKeyId != WeaveKeyId::kNone)
-            FabricState->RemoveSessionKey(mSessionKeyId, con->PeerNodeId);
+        if (sess->SessionKeyId != WeaveKeyId::kNone)
+            FabricState->RemoveSessionKey(sess->SessionKeyId, con->PeerNodeId);
 
-        Reset();
+        Reset(sess);
     }
 
     return err;
 }
 
-void WeaveSecurityManager::StartPASESession(void)
+void WeaveSecurityManager::StartPASESession(SessionContext *sess)
+{
+    sess->EC->OnMessageReceived = HandlePASEMessageInitiator;
+    sess->EC->OnConnectionClosed = HandleConnectionClosed;
+
+    // Time limit overall PASE duration.
+    StartSessionTimer(sess);
+
+    StartPASEInitiatorStep1(sess, kPASEConfig_ConfigDefault);
+}
+
+void WeaveSecurityManager::StartPASEInitiatorStep1(SessionContext *sess, uint32_t paseConfig)
 {
     WEAVE_ERROR err;
 
-    err = SendPASEInitiatorStep1(kPASEConfig_ConfigDefault);
+    // Allocate a buffer to hold the step 1 message.
+    sess->JobMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    sess->PASEConfig = paseConfig;
+
+    // Generate the message, which involves J-PAKE key generation, on a crypto worker.
+    // Sending continues in HandlePASEInitiatorStep1Generated().
+    err = StartCryptoJob(sess, RunPASEGenerateInitiatorStep1, HandlePASEInitiatorStep1Generated);
     SuccessOrExit(err);
 
-    mEC->OnMessageReceived = HandlePASEMessageInitiator;
-    mEC->OnConnectionClosed = HandleConnectionClosed;
+exit:
+    if (err != WEAVE_NO_ERROR)
+        HandleSessionError(sess, err, NULL);
+}
+
+WEAVE_ERROR WeaveSecurityManager::RunPASEGenerateInitiatorStep1(CryptoJob *job)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveFabricState *fabricState = sess->SecMgr->FabricState;
 
-    // Time limit overall PASE duration.
-    StartSessionTimer();
+    return sess->PASEEngine->GenerateInitiatorStep1(sess->JobMsgBuf, sess->PASEConfig, fabricState->LocalNodeId, sess->PeerNodeId,
+                                                    sess->SessionKeyId, sess->EncType, PasswordSourceFromAuthMode(sess->RequestedAuthMode),
+                                                    fabricState, true);
+}
+
+void WeaveSecurityManager::HandlePASEInitiatorStep1Generated(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *msgBuf = sess->JobMsgBuf;
+
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
+    SuccessOrExit(err);
+
+    // Send PASE step 1 message.
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_PASEInitiatorStep1, msgBuf, 0);
+    msgBuf = NULL;
+    SuccessOrExit(err);
 
 exit:
+    if (msgBuf != NULL)
+        PacketBuffer::Free(msgBuf);
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
 void WeaveSecurityManager::HandlePASEMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
         uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the PASE interaction immediately if we receive a status report message from the responder.
     // This is a signal that the responder does not want to continue.
@@ -419,11 +500,13 @@ void WeaveSecurityManager::HandlePASEMessageInitiator(ExchangeContext *ec, const
         SuccessOrExit(err);
         if (rcvdStatusReport.mStatusCode == Security::kStatusCode_PASESupportsOnlyConfig1)
         {
+            VerifyOrExit(!sess->CryptoJobPending, err = WEAVE_ERROR_INCORRECT_STATE);
+
             // Free the received message buffer so that it can be reused to send the outgoing message.
             PacketBuffer::Free(msgBuf);
             msgBuf = NULL;
 
-            err = secMgr->SendPASEInitiatorStep1(kPASEConfig_Config1);
+            secMgr->StartPASEInitiatorStep1(sess, kPASEConfig_Config1);
             ExitNow();
         }
         else
@@ -436,62 +519,64 @@ void WeaveSecurityManager::HandlePASEMessageInitiator(ExchangeContext *ec, const
     // All other messages must be part of the Security profile.
     VerifyOrExit(profileId == kWeaveProfile_Security, err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
 
+    // The responder sends its step 2 message immediately after its step 1 message, so step 2 may
+    // arrive while step 1 is still being processed.  Hold it until then.
+    if (msgType == kMsgType_PASEResponderStep2 && sess->CryptoJobPending && sess->HeldMsgBuf == NULL)
+    {
+        sess->HeldMsgBuf = msgBuf;
+        msgBuf = NULL;
+        ExitNow();
+    }
+
+    // Nothing else is expected from the responder while a crypto job is outstanding.
+    VerifyOrExit(!sess->CryptoJobPending, err = WEAVE_ERROR_INCORRECT_STATE);
+
     // Handle the responder's message...
     switch (msgType)
     {
     case kMsgType_PASEResponderReconfigure:
         uint32_t newConfig;
 
-        err = secMgr->ProcessPASEResponderReconfigure(msgBuf, newConfig);
+        err = secMgr->ProcessPASEResponderReconfigure(sess, msgBuf, newConfig);
         SuccessOrExit(err);
 
         // Free the received message buffer so that it can be reused to send the outgoing message.
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->SendPASEInitiatorStep1(newConfig);
-        SuccessOrExit(err);
+        secMgr->StartPASEInitiatorStep1(sess, newConfig);
 
         break;
 
     case kMsgType_PASEResponderStep1:
 
-        err = secMgr->ProcessPASEResponderStep1(msgBuf);
+        // Decode and process the responder's step 1 message on a crypto worker.  The buffer containing
+        // the message is held by the session until the job completes.
+        sess->JobMsgBuf = msgBuf;
+        msgBuf = NULL;
+
+        err = secMgr->StartCryptoJob(sess, RunPASEProcessResponderStep1, HandlePASEResponderStep1Processed);
         SuccessOrExit(err);
 
         break;
 
     case kMsgType_PASEResponderStep2:
 
-        err = secMgr->ProcessPASEResponderStep2(msgBuf);
-        SuccessOrExit(err);
-
-        // Free the received message buffer so that it can be reused to send the outgoing message.
-        PacketBuffer::Free(msgBuf);
+        err = secMgr->ProcessPASEResponderStep2(sess, msgBuf);
         msgBuf = NULL;
-
-        err = secMgr->SendPASEInitiatorStep2();
         SuccessOrExit(err);
 
-        if (secMgr->mPASEEngine->State == WeavePASEEngine::kState_InitiatorDone)
-        {
-            err = secMgr->HandleSessionEstablished();
-            SuccessOrExit(err);
-
-            secMgr->HandleSessionComplete();
-        }
-
         break;
 
     case kMsgType_PASEResponderKeyConfirm:
 
-        err = secMgr->ProcessPASEResponderKeyConfirm(msgBuf);
+        err = secMgr->ProcessPASEResponderKeyConfirm(sess, msgBuf);
         SuccessOrExit(err);
 
-        err = secMgr->HandleSessionEstablished();
+        err = secMgr->HandleSessionEstablished(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
 
         break;
 
@@ -503,119 +588,139 @@ void WeaveSecurityManager::HandlePASEMessageInitiator(ExchangeContext *ec, const
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEInitiatorStep1(uint32_t paseConfig)
+WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderReconfigure(SessionContext *sess, PacketBuffer* msgBuf, uint32_t &newConfig)
 {
-    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
-    PacketBuffer*   msgBuf  = NULL;
-    uint8_t         pwSource;
-
-    // Allocate buffer.
-    msgBuf = PacketBuffer::New();
-    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
-
-    // Extract the password source from the requested auth mode.
-    pwSource = PasswordSourceFromAuthMode(mRequestedAuthMode);
-
-    // Generate and encode PASE step 1 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->GenerateInitiatorStep1(msgBuf, paseConfig, FabricState->LocalNodeId, mEC->PeerNodeId, mSessionKeyId, kWeaveEncryptionType_AES128CTRSHA1, pwSource, FabricState, true);
-    Platform::Security::OnTimeConsumingCryptoDone();
-    SuccessOrExit(err);
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    // Send PASE step 1 message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEInitiatorStep1, msgBuf, 0);
-    msgBuf = NULL;
+    // Decode and process the responder's reconfigure message.
+    err = sess->PASEEngine->ProcessResponderReconfigure(msgBuf, newConfig);
     SuccessOrExit(err);
 
 exit:
-    if (msgBuf != NULL)
-        PacketBuffer::Free(msgBuf);
     return err;
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderReconfigure(PacketBuffer* msgBuf, uint32_t &newConfig)
+WEAVE_ERROR WeaveSecurityManager::RunPASEProcessResponderStep1(CryptoJob *job)
 {
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SessionContext *sess = (SessionContext *)job->AppState;
 
-    // Decode and process the responder's reconfigure message.
-    err = mPASEEngine->ProcessResponderReconfigure(msgBuf, newConfig);
+    return sess->PASEEngine->ProcessResponderStep1(sess->JobMsgBuf);
+}
+
+void WeaveSecurityManager::HandlePASEResponderStep1Processed(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *heldMsgBuf = sess->HeldMsgBuf;
+
+    sess->HeldMsgBuf = NULL;
+
+    // Release the buffer containing the step 1 message.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
     SuccessOrExit(err);
 
+    // Go on to the responder's step 2 message if it arrived in the meantime.
+    if (heldMsgBuf != NULL)
+    {
+        err = secMgr->ProcessPASEResponderStep2(sess, heldMsgBuf);
+        heldMsgBuf = NULL;
+        SuccessOrExit(err);
+    }
+
 exit:
-    return err;
+    if (heldMsgBuf != NULL)
+        PacketBuffer::Free(heldMsgBuf);
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderStep1(PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderStep2(SessionContext *sess, PacketBuffer* msgBuf)
 {
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    WEAVE_ERROR err;
+
+    // Process the responder's step 2 message and generate the initiator's step 2 message on a crypto
+    // worker.  The session takes ownership of the received message buffer.  Sending continues in
+    // HandlePASEResponderStep2Processed().
+    sess->JobMsgBuf = msgBuf;
 
-    // Decode and process the responder's step 1 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->ProcessResponderStep1(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    sess->JobRespMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobRespMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    err = StartCryptoJob(sess, RunPASEProcessResponderStep2, HandlePASEResponderStep2Processed);
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderStep2(PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::RunPASEProcessResponderStep2(CryptoJob *job)
 {
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WEAVE_ERROR err;
 
     // Decode and process the responder's step 2 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->ProcessResponderStep2(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    err = sess->PASEEngine->ProcessResponderStep2(sess->JobMsgBuf);
+    SuccessOrExit(err);
+
+    // Generate and encode the initiator's step 2 message.
+    err = sess->PASEEngine->GenerateInitiatorStep2(sess->JobRespMsgBuf);
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEInitiatorStep2(void)
+void WeaveSecurityManager::HandlePASEResponderStep2Processed(CryptoJob *job, WEAVE_ERROR err)
 {
-    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
-    PacketBuffer*   msgBuf  = NULL;
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *respMsgBuf = sess->JobRespMsgBuf;
 
-    // Allocate buffer.
-    msgBuf = PacketBuffer::New();
-    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->JobRespMsgBuf = NULL;
 
-    // Generate and encode PASE step 1 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->GenerateInitiatorStep2(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    // Release the buffer containing the responder's step 2 message.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
     SuccessOrExit(err);
 
     // Send PASE step 2 message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEInitiatorStep2, msgBuf, 0);
-    msgBuf = NULL;
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_PASEInitiatorStep2, respMsgBuf, 0);
+    respMsgBuf = NULL;
     SuccessOrExit(err);
 
+    if (sess->PASEEngine->State == WeavePASEEngine::kState_InitiatorDone)
+    {
+        err = secMgr->HandleSessionEstablished(sess);
+        SuccessOrExit(err);
+
+        secMgr->HandleSessionComplete(sess);
+    }
+
 exit:
-    if (msgBuf != NULL)
-        PacketBuffer::Free(msgBuf);
-    return err;
+    if (respMsgBuf != NULL)
+        PacketBuffer::Free(respMsgBuf);
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderKeyConfirm(PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessPASEResponderKeyConfirm(SessionContext *sess, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
     // Decode and process the responder's key confirmation message.
-    err = mPASEEngine->ProcessResponderKeyConfirm(msgBuf);
+    err = sess->PASEEngine->ProcessResponderKeyConfirm(msgBuf);
     SuccessOrExit(err);
 
 exit:
@@ -635,14 +740,14 @@ WEAVE_ERROR WeaveSecurityManager::StartPASESession(WeaveConnection *con, WeaveAu
 
 #if WEAVE_CONFIG_ENABLE_PASE_RESPONDER
 
-void WeaveSecurityManager::HandlePASESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
+void WeaveSecurityManager::HandlePASESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
     // Setup state for the new PASE exchange.
-    State = kState_PASEInProgress;
-    mEC = ec;
-    mCon = ec->Con;
+    sess->EC = ec;
+    sess->Con = ec->Con;
+    ec->AppState = sess;
     ec->OnMessageReceived = HandlePASEMessageResponder;
     ec->OnConnectionClosed = HandleConnectionClosed;
 
@@ -652,107 +757,89 @@ void WeaveSecurityManager::HandlePASESessionStart(ExchangeContext *ec, const IPP
     // TODO: rate limit unsuccessful PASE exchanges (WEAVE_ERROR_SECURITY_RATE_LIMIT_EXCEEDED)
 
     // Time limit overall PASE duration.
-    StartSessionTimer();
-
-    // Initialize Weave Platform Memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    StartSessionTimer(sess);
 
-    // Prepare PASE engine and start session
-    mPASEEngine = (WeavePASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeavePASEEngine), true);
-    VerifyOrExit(mPASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mPASEEngine->Init();
-
-    err = ProcessPASEInitiatorStep1(ec, msgBuf);
-
-    // Free the received message buffer so that it can be reused to send the outgoing messages.
-    PacketBuffer::Free(msgBuf);
-    msgBuf = NULL;
-
-    // Check if ProcessPASEInitiatorStep1 generated Reconfiguration Request
-    if (err == WEAVE_ERROR_PASE_RECONFIGURE_REQUIRED)
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
     {
-        err = SendPASEResponderReconfigure();
+        err = Platform::Security::MemoryInit();
         SuccessOrExit(err);
-
-        // Reset state.
-        Reset();
     }
-    else
-    {
-        SuccessOrExit(err);
 
-        err = SendPASEResponderStep1();
-        SuccessOrExit(err);
+    // Prepare PASE engine and start session
+    sess->PASEEngine = (WeavePASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeavePASEEngine), true);
+    VerifyOrExit(sess->PASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->PASEEngine->Init();
+
+    // Allocate a buffer to hold the encoded step 1 message.
+    sess->JobRespMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobRespMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    // Process the initiator's step 1 message and generate the responder's step 1 message on a crypto
+    // worker.  The request buffer is held by the session until the job completes.  Processing
+    // continues in HandlePASEInitiatorStep1Processed().
+    sess->JobMsgBuf = msgBuf;
+    msgBuf = NULL;
 
-        err = SendPASEResponderStep2();
-        SuccessOrExit(err);
-    }
+    err = StartCryptoJob(sess, RunPASEProcessInitiatorStep1, HandlePASEInitiatorStep1Processed);
+    SuccessOrExit(err);
 
 exit:
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
+        HandleSessionError(sess, err, NULL);
 }
 
-void WeaveSecurityManager::HandlePASEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo,
-        const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::RunPASEProcessInitiatorStep1(CryptoJob *job)
 {
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveFabricState *fabricState = sess->SecMgr->FabricState;
+    WEAVE_ERROR err;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    // Decode and process the initiator's step 1 message.  This fails with WEAVE_ERROR_PASE_RECONFIGURE_REQUIRED
+    // if the initiator proposed a configuration we don't support.
+    err = sess->PASEEngine->ProcessInitiatorStep1(sess->JobMsgBuf, fabricState->LocalNodeId, sess->PeerNodeId, fabricState);
+    SuccessOrExit(err);
 
-    // Abort the PASE interaction immediately if we receive a status report message from the initiator.
-    // This is a signal that the initiator does not want to continue.
-    if (profileId == kWeaveProfile_Common && msgType == kMsgType_StatusReport)
-        ExitNow(err = WEAVE_ERROR_STATUS_REPORT_RECEIVED);
+    // Generate PASE step 1 message.
+    err = sess->PASEEngine->GenerateResponderStep1(sess->JobRespMsgBuf);
+    SuccessOrExit(err);
 
-    // Otherwise, the only other message expected is an InitiatorStep2.
-    VerifyOrExit(profileId == kWeaveProfile_Security && msgType == kMsgType_PASEInitiatorStep2,
-                 err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+exit:
+    return err;
+}
 
-    err = secMgr->ProcessPASEInitiatorStep2(msgBuf);
-    SuccessOrExit(err);
+void WeaveSecurityManager::HandlePASEInitiatorStep1Processed(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    ExchangeContext *ec = sess->EC;
+    WeaveSessionKey *sessionKey;
+    PacketBuffer *respMsgBuf = sess->JobRespMsgBuf;
 
-    // Free the received message buffer so that it can be reused to send the outgoing messages.
-    PacketBuffer::Free(msgBuf);
-    msgBuf = NULL;
+    sess->JobRespMsgBuf = NULL;
 
-    // If performing key confirmation send a responder key confirmation message.
-    if (secMgr->mPASEEngine->PerformKeyConfirmation)
-    {
-        err = secMgr->SendPASEResponderKeyConfirm();
-        SuccessOrExit(err);
-    }
+    // Discard the request buffer.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
 
-    // If we've successfully establish a session, go perform the appropriate actions.
-    if (secMgr->mPASEEngine->State == WeavePASEEngine::kState_ResponderDone)
+    secMgr->EndCryptoJob(sess, err);
+
+    // If the initiator must be asked for a different configuration...
+    if (err == WEAVE_ERROR_PASE_RECONFIGURE_REQUIRED)
     {
-        err = secMgr->HandleSessionEstablished();
+        PacketBuffer::Free(respMsgBuf);
+        respMsgBuf = NULL;
+
+        err = secMgr->SendPASEResponderReconfigure(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        // Reset state.
+        secMgr->Reset(sess);
+        ExitNow();
     }
-
-exit:
-    if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
-    if (msgBuf != NULL)
-        PacketBuffer::Free(msgBuf);
-}
-
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEInitiatorStep1(ExchangeContext *ec, PacketBuffer* msgBuf)
-{
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSessionKey *sessionKey;
-
-    // Generate and encode PASE step 1 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->ProcessInitiatorStep1(msgBuf, FabricState->LocalNodeId, ec->PeerNodeId, FabricState);
-    Platform::Security::OnTimeConsumingCryptoDone();
     SuccessOrExit(err);
 
     // Allocate an entry in the session key table using the key id proposed by the peer.
@@ -761,73 +848,143 @@ WEAVE_ERROR WeaveSecurityManager::ProcessPASEInitiatorStep1(ExchangeContext *ec,
     //
     // If the initiator has proposed a key id that already exists, make sure we don't remove the
     // existing key during the error clean-up process.
-    err = FabricState->AllocSessionKey(ec->PeerNodeId, mPASEEngine->SessionKeyId, ec->Con, sessionKey);
+    err = secMgr->FabricState->AllocSessionKey(ec->PeerNodeId, sess->PASEEngine->SessionKeyId, ec->Con, sessionKey);
     SuccessOrExit(err);
     sessionKey->SetLocallyInitiated(false);
     sessionKey->SetRemoveOnIdle(false); // TODO FUTURE: Set this to true when support for PASE over WRM is implemented.
 
     // Save the proposed session key id and encryption type.
-    mSessionKeyId = mPASEEngine->SessionKeyId;
-    mEncType = mPASEEngine->EncryptionType;
+    sess->SessionKeyId = sess->PASEEngine->SessionKeyId;
+    sess->EncType = sess->PASEEngine->EncryptionType;
+
+    // Send PASE step 1 message.
+    err = ec->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderStep1, respMsgBuf, 0);
+    respMsgBuf = NULL;
+    SuccessOrExit(err);
+
+    // Generate the responder's step 2 message on a crypto worker.  Sending continues in
+    // HandlePASEResponderStep2Generated().
+    sess->JobRespMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobRespMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    err = secMgr->StartCryptoJob(sess, RunPASEGenerateResponderStep2, HandlePASEResponderStep2Generated);
+    SuccessOrExit(err);
 
 exit:
-    return err;
+    if (respMsgBuf != NULL)
+        PacketBuffer::Free(respMsgBuf);
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEResponderReconfigure(void)
+WEAVE_ERROR WeaveSecurityManager::RunPASEGenerateResponderStep2(CryptoJob *job)
 {
-    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
-    PacketBuffer*   msgBuf  = NULL;
+    SessionContext *sess = (SessionContext *)job->AppState;
 
-    // Allocate buffer.
-    msgBuf = PacketBuffer::New();
-    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    return sess->PASEEngine->GenerateResponderStep2(sess->JobRespMsgBuf);
+}
 
-    // Generate PASE reconfigure message.
-    err = mPASEEngine->GenerateResponderReconfigure(msgBuf);
+void WeaveSecurityManager::HandlePASEResponderStep2Generated(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *respMsgBuf = sess->JobRespMsgBuf;
+
+    sess->JobRespMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
     SuccessOrExit(err);
 
-    // Send PASE reconfigure message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderReconfigure, msgBuf, 0);
-    msgBuf = NULL;
+    // Send PASE step 2 message.
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderStep2, respMsgBuf, 0);
+    respMsgBuf = NULL;
     SuccessOrExit(err);
 
 exit:
-    if (msgBuf != NULL)
-        PacketBuffer::Free(msgBuf);
-    return err;
+    if (respMsgBuf != NULL)
+        PacketBuffer::Free(respMsgBuf);
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEResponderStep1(void)
+void WeaveSecurityManager::HandlePASEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo,
+        const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
-    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
-    PacketBuffer*   msgBuf  = NULL;
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    // Allocate buffer.
-    msgBuf = PacketBuffer::New();
-    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    VerifyOrDie(ec == sess->EC);
 
-    // Generate PASE step 1 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->GenerateResponderStep1(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
-    SuccessOrExit(err);
+    // Abort the PASE interaction immediately if we receive a status report message from the initiator.
+    // This is a signal that the initiator does not want to continue.
+    if (profileId == kWeaveProfile_Common && msgType == kMsgType_StatusReport)
+        ExitNow(err = WEAVE_ERROR_STATUS_REPORT_RECEIVED);
 
-    // Send PASE step 1 message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderStep1, msgBuf, 0);
+    // Otherwise, the only other message expected is an InitiatorStep2.
+    VerifyOrExit(profileId == kWeaveProfile_Security && msgType == kMsgType_PASEInitiatorStep2,
+                 err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+
+    // The initiator can't have sent its step 2 message before receiving ours.
+    VerifyOrExit(!sess->CryptoJobPending, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    // Decode and process the initiator's step 2 message on a crypto worker.  The buffer containing
+    // the message is held by the session until the job completes.
+    sess->JobMsgBuf = msgBuf;
     msgBuf = NULL;
+
+    err = secMgr->StartCryptoJob(sess, RunPASEProcessInitiatorStep2, HandlePASEInitiatorStep2Processed);
     SuccessOrExit(err);
 
 exit:
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
-    return err;
+}
+
+WEAVE_ERROR WeaveSecurityManager::RunPASEProcessInitiatorStep2(CryptoJob *job)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+
+    return sess->PASEEngine->ProcessInitiatorStep2(sess->JobMsgBuf);
+}
+
+void WeaveSecurityManager::HandlePASEInitiatorStep2Processed(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+
+    // Release the buffer containing the initiator's step 2 message.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
+    SuccessOrExit(err);
+
+    // If performing key confirmation send a responder key confirmation message.
+    if (sess->PASEEngine->PerformKeyConfirmation)
+    {
+        err = secMgr->SendPASEResponderKeyConfirm(sess);
+        SuccessOrExit(err);
+    }
+
+    // If we've successfully establish a session, go perform the appropriate actions.
+    if (sess->PASEEngine->State == WeavePASEEngine::kState_ResponderDone)
+    {
+        err = secMgr->HandleSessionEstablished(sess);
+        SuccessOrExit(err);
+
+        secMgr->HandleSessionComplete(sess);
+    }
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEResponderStep2(void)
+WEAVE_ERROR WeaveSecurityManager::SendPASEResponderReconfigure(SessionContext *sess)
 {
     WEAVE_ERROR     err     = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf  = NULL;
@@ -836,14 +993,12 @@ WEAVE_ERROR WeaveSecurityManager::SendPASEResponderStep2(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    // Generate PASE step 2 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->GenerateResponderStep2(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    // Generate PASE reconfigure message.
+    err = sess->PASEEngine->GenerateResponderReconfigure(msgBuf);
     SuccessOrExit(err);
 
-    // Send PASE step 2 message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderStep2, msgBuf, 0);
+    // Send PASE reconfigure message.
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderReconfigure, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -854,22 +1009,7 @@ exit:
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::ProcessPASEInitiatorStep2(PacketBuffer* msgBuf)
-{
-    WEAVE_ERROR err = WEAVE_NO_ERROR;
-
-    // Decode and process the initiator's step 2 message.
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mPASEEngine->ProcessInitiatorStep2(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
-    SuccessOrExit(err);
-
-exit:
-    return err;
-}
-
-__attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendPASEResponderKeyConfirm(void)
+WEAVE_ERROR WeaveSecurityManager::SendPASEResponderKeyConfirm(SessionContext *sess)
 {
     WEAVE_ERROR     err     = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf  = NULL;
@@ -879,11 +1019,11 @@ WEAVE_ERROR WeaveSecurityManager::SendPASEResponderKeyConfirm(void)
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
     // Generate and encode a key confirmation message.
-    err = mPASEEngine->GenerateResponderKeyConfirm(msgBuf);
+    err = sess->PASEEngine->GenerateResponderKeyConfirm(msgBuf);
     SuccessOrExit(err);
 
     // Send a key confirmation message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderKeyConfirm, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_PASEResponderKeyConfirm, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -926,9 +1066,10 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     WeaveSessionKey *sessionKey = NULL;
+    SessionContext *sess = NULL;
     bool clearStateOnError = false;
     bool isSharedSession = (terminatingNodeId != kNodeIdNotSpecified);
-    const uint8_t encType = kWeaveEncryptionType_AES128CTRSHA1; // Only one encryption type supported for now.
+    const uint8_t encType = WEAVE_CONFIG_DEFAULT_SESSION_ENCRYPTION_TYPE;
 
     // Verify security manager has been initialized.
     VerifyOrExit(State != kState_NotInitialized, err = WEAVE_ERROR_INCORRECT_STATE);
@@ -953,7 +1094,7 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
             // the concurrent request to wait until the session is fully established.
             //
             // If the located shared session is NOT in the process of being established...
-            if (State != kState_CASEInProgress || mEC->PeerNodeId != terminatingNodeId || mSessionKeyId != sessionKey->MsgEncKey.KeyId)
+            if (!IsSessionKeyInProgress(terminatingNodeId, sessionKey->MsgEncKey.KeyId))
             {
                 // Add a new end node to the list of end nodes associated with the session.
                 err = FabricState->AddSharedSessionEndNode(sessionKey, peerNodeId);
@@ -970,23 +1111,23 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
         }
     }
 
-    // Verify there is no session in process.
-    VerifyOrExit(State == kState_Idle, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
-
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_SecMgrBusy,
         {
             AsyncNotifySecurityManagerAvailable();
             ExitNow(err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
         });
 
-    State = kState_CASEInProgress;
-    mRequestedAuthMode = requestedAuthMode;
-    mEncType = encType;
-    mCon = con;
-    mStartSecureSession_OnComplete = onComplete;
-    mStartSecureSession_OnError = onError;
-    mStartSecureSession_ReqState = reqState;
-    mSessionKeyId = WeaveKeyId::kNone;
+    // Claim a session context, subject to the overall and per-peer concurrency limits.
+    sess = AllocSession((isSharedSession ? terminatingNodeId : peerNodeId), kState_CASEInProgress);
+    VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+    sess->RequestedAuthMode = requestedAuthMode;
+    sess->EncType = encType;
+    sess->Con = con;
+    sess->StartSecureSession_OnComplete = onComplete;
+    sess->StartSecureSession_OnError = onError;
+    sess->StartSecureSession_ReqState = reqState;
+    sess->SessionKeyId = WeaveKeyId::kNone;
 
     // Any error after that would require state clearing in case of error.
     clearStateOnError = true;
@@ -998,7 +1139,7 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
     SuccessOrExit(err);
     sessionKey->SetLocallyInitiated(true);
     sessionKey->SetSharedSession(isSharedSession);
-    mSessionKeyId = sessionKey->MsgEncKey.KeyId;
+    sess->SessionKeyId = sessionKey->MsgEncKey.KeyId;
 
     // If requested session is shared.
     if (isSharedSession)
@@ -1009,37 +1150,41 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
     }
 
     // Create a new exchange context.
-    err = NewSessionExchange((isSharedSession ? terminatingNodeId : peerNodeId), peerAddr, peerPort);
+    err = NewSessionExchange(sess, (isSharedSession ? terminatingNodeId : peerNodeId), peerAddr, peerPort);
     SuccessOrExit(err);
 
-    // Initialize Weave Platform Memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Allocate and Initialize CASE Engine object
-    mCASEEngine = (WeaveCASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveCASEEngine), true);
-    VerifyOrExit(mCASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mCASEEngine->Init();
+    sess->CASEEngine = (WeaveCASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveCASEEngine), true);
+    VerifyOrExit(sess->CASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->CASEEngine->Init();
 
     // Initialize CASE Authentication Delegate
     if (authDelegate == NULL)
         authDelegate = mDefaultAuthDelegate;
     VerifyOrExit(authDelegate != NULL, err = WEAVE_ERROR_NO_CASE_AUTH_DELEGATE);
-    mCASEEngine->AuthDelegate = authDelegate;
+    sess->CASEEngine->AuthDelegate = authDelegate;
 
     // Set the allowed CASE configs and ECDH curves.
-    mCASEEngine->SetAllowedConfigs(InitiatorAllowedCASEConfigs);
-    mCASEEngine->SetAllowedCurves(InitiatorAllowedCASECurves);
+    sess->CASEEngine->SetAllowedConfigs(InitiatorAllowedCASEConfigs);
+    sess->CASEEngine->SetAllowedCurves(InitiatorAllowedCASECurves);
 
     // Set the expected peer certificate type based on the requested authentication mode.
-    mCASEEngine->SetCertType(CertTypeFromAuthMode(requestedAuthMode));
+    sess->CASEEngine->SetCertType(CertTypeFromAuthMode(requestedAuthMode));
 
 #if WEAVE_CONFIG_SECURITY_TEST_MODE
-    mCASEEngine->SetUseKnownECDHKey(CASEUseKnownECDHKey);
+    sess->CASEEngine->SetUseKnownECDHKey(CASEUseKnownECDHKey);
 #endif
 
     // Start CASE Session using specified initiator parameters.
-    StartCASESession(InitiatorCASEConfig, InitiatorCASECurveId);
+    StartCASESession(sess, InitiatorCASEConfig, InitiatorCASECurveId);
 
 exit:
     if (err != WEAVE_NO_ERROR && clearStateOnError)
@@ -1047,71 +1192,94 @@ exit:
         if (sessionKey != NULL)
             FabricState->RemoveSessionKey(sessionKey);
 
-        Reset();
+        Reset(sess);
     }
 
     return err;
 }
 
-void WeaveSecurityManager::StartCASESession(uint32_t config, uint32_t curveId)
+void WeaveSecurityManager::StartCASESession(SessionContext *sess, uint32_t config, uint32_t curveId)
 {
     WEAVE_ERROR                         err;
-    CASE::BeginSessionRequestMessage    req;
-    PacketBuffer*                       msgBuf = NULL;
-    uint16_t                            sendFlags = 0;
+    CASE::BeginSessionRequestMessage&   req = sess->CASEBeginReq;
 
     // Allocate a buffer to hold the Begin Session message.
-    msgBuf = PacketBuffer::New();
-    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->JobMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    // Generate the CASE Begin Session message.
+    // Prepare the contents of the CASE Begin Session message.
     req.Reset();
-    req.PeerNodeId = mEC->PeerNodeId;
+    req.PeerNodeId = sess->EC->PeerNodeId;
     req.ProtocolConfig = config;
-    mCASEEngine->SetAlternateConfigs(req);
+    sess->CASEEngine->SetAlternateConfigs(req);
     req.CurveId = curveId;
-    mCASEEngine->SetAlternateCurves(req);
+    sess->CASEEngine->SetAlternateCurves(req);
     req.PerformKeyConfirm = true;
-    req.SessionKeyId = mSessionKeyId;
-    req.EncryptionType = mEncType;
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mCASEEngine->GenerateBeginSessionRequest(req, msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    req.SessionKeyId = sess->SessionKeyId;
+    req.EncryptionType = sess->EncType;
+
+    sess->EC->OnMessageReceived = HandleCASEMessageInitiator;
+    sess->EC->OnConnectionClosed = HandleConnectionClosed;
+
+    // Generate the message, which involves ECDH key generation and signing, on a crypto worker.
+    // Sending continues in HandleCASEBeginSessionRequestGenerated().
+    err = StartCryptoJob(sess, RunCASEGenerateBeginSessionRequest, HandleCASEBeginSessionRequestGenerated);
+    SuccessOrExit(err);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        HandleSessionError(sess, err, NULL);
+}
+
+WEAVE_ERROR WeaveSecurityManager::RunCASEGenerateBeginSessionRequest(CryptoJob *job)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+
+    return sess->CASEEngine->GenerateBeginSessionRequest(sess->CASEBeginReq, sess->JobMsgBuf);
+}
+
+void WeaveSecurityManager::HandleCASEBeginSessionRequestGenerated(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *msgBuf = sess->JobMsgBuf;
+    uint16_t sendFlags = 0;
+
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
     SuccessOrExit(err);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    if (mCon == NULL)
+    if (sess->Con == NULL)
     {
         sendFlags = ExchangeContext::kSendFlag_RequestAck;
     }
 #endif
 
     // Send the message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_CASEBeginSessionRequest, msgBuf, sendFlags);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_CASEBeginSessionRequest, msgBuf, sendFlags);
     msgBuf = NULL;
     SuccessOrExit(err);
 
-    mEC->OnMessageReceived = HandleCASEMessageInitiator;
-    mEC->OnConnectionClosed = HandleConnectionClosed;
-
     // Time limit overall CASE duration.
-    StartSessionTimer();
+    secMgr->StartSessionTimer(sess);
 
 exit:
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
+        secMgr->HandleSessionError(sess, err, NULL);
 }
 
 void WeaveSecurityManager::HandleCASEMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo,
         const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
-    uint16_t sendFlags = 0;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the CASE interaction immediately if we receive a status report message from the responder.
     // This is a signal that the responder does not want to continue.
@@ -1121,71 +1289,28 @@ void WeaveSecurityManager::HandleCASEMessageInitiator(ExchangeContext *ec, const
     // All other messages must be part of the Security profile.
     VerifyOrExit(profileId == kWeaveProfile_Security, err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
 
+    // Nothing further is expected from the responder while a crypto job is outstanding.
+    VerifyOrExit(!sess->CryptoJobPending, err = WEAVE_ERROR_INCORRECT_STATE);
+
     // If the message is a BeginSessionResponse...
     if (msgType == kMsgType_CASEBeginSessionResponse)
     {
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
         // Flush any pending WRM ACKs before we begin the long crypto operation,
         // to prevent the peer from re-transmitting the Begin Session response.
-        err = secMgr->mEC->WRMPFlushAcks();
+        err = sess->EC->WRMPFlushAcks();
         SuccessOrExit(err);
 #endif
 
-        // Decode and process the BeginSessionResponse.
-        {
-            CASE::BeginSessionResponseMessage resp;
-            resp.Reset();
-            resp.PeerNodeId = ec->PeerNodeId;
-
-            Platform::Security::OnTimeConsumingCryptoStart();
-            err = secMgr->mCASEEngine->ProcessBeginSessionResponse(msgBuf, resp);
-            Platform::Security::OnTimeConsumingCryptoDone();
-            SuccessOrExit(err);
-        }
-
-        // Release the buffer containing the response.
-        PacketBuffer::Free(msgBuf);
+        // Decode and process the BeginSessionResponse on a crypto worker.  The buffer containing
+        // the response is held by the session until the job completes.
+        sess->CASEBeginResp.Reset();
+        sess->CASEBeginResp.PeerNodeId = ec->PeerNodeId;
+        sess->JobMsgBuf = msgBuf;
         msgBuf = NULL;
 
-        // If performing key confirmation...
-        if (secMgr->mCASEEngine->PerformingKeyConfirm())
-        {
-            // Generate and encode an InitiatorKeyConfirm message.
-            msgBuf = PacketBuffer::New();
-            VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
-            err = secMgr->mCASEEngine->GenerateInitiatorKeyConfirm(msgBuf);
-            SuccessOrExit(err);
-
-#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-            if (secMgr->mCon == NULL)
-            {
-                sendFlags = ExchangeContext::kSendFlag_RequestAck;
-            }
-#endif
-
-            // Send the InitiatorKeyConfirm message to the peer.
-            err = secMgr->mEC->SendMessage(kWeaveProfile_Security, kMsgType_CASEInitiatorKeyConfirm, msgBuf, sendFlags);
-            msgBuf = NULL;
-            SuccessOrExit(err);
-        }
-
-        // Initialize the newly established security session.
-        err = secMgr->HandleSessionEstablished();
+        err = secMgr->StartCryptoJob(sess, RunCASEProcessBeginSessionResponse, HandleCASEBeginSessionResponseProcessed);
         SuccessOrExit(err);
-
-#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-        // Complete the session when any of these is true:
-        //     - session establishment was done over a Weave connection
-        //     - key confirmation wasn't required
-        // For WRMP when key confirmation is required, the session will be completed
-        // on one of these events:
-        //     - Received Ack from the peer for the last message on this exchange (CASEInitiatorKeyConfirm)
-        //     - Received first message from the peer encrypted with established session key (mSessionKeyId)
-        if (secMgr->mCon || !secMgr->mCASEEngine->PerformingKeyConfirm())
-#endif
-        {
-            secMgr->HandleSessionComplete();
-        }
     }
 
     // Otherwise, if the message is a Reconfigure...
@@ -1194,7 +1319,7 @@ void WeaveSecurityManager::HandleCASEMessageInitiator(ExchangeContext *ec, const
         // Process the reconfigure message.  If this proposed alternate configuration is not acceptable,
         // the call will fail with an error.
         CASE::ReconfigureMessage reconfMsg;
-        err = secMgr->mCASEEngine->ProcessReconfigure(msgBuf, reconfMsg);
+        err = sess->CASEEngine->ProcessReconfigure(msgBuf, reconfMsg);
         SuccessOrExit(err);
 
         // Release the buffer containing the response.
@@ -1204,11 +1329,11 @@ void WeaveSecurityManager::HandleCASEMessageInitiator(ExchangeContext *ec, const
         // Create a new exchange context for the new CASE session.  This will result in the old exchange context
         // being closed. (NOTE: We cannot re-use the initial exchange for the new CASE session because the peer
         // believes the exchange ended when the Reconfigure message was sent).
-        err = secMgr->NewSessionExchange(ec->PeerNodeId, ec->PeerAddr, ec->PeerPort);
+        err = secMgr->NewSessionExchange(sess, ec->PeerNodeId, ec->PeerAddr, ec->PeerPort);
         SuccessOrExit(err);
 
         // Restart the CASE session using the peer's propose parameters.
-        secMgr->StartCASESession(reconfMsg.ProtocolConfig, reconfMsg.CurveId);
+        secMgr->StartCASESession(sess, reconfMsg.ProtocolConfig, reconfMsg.CurveId);
     }
 
     // Fail if the message is unrecognized.
@@ -1217,7 +1342,75 @@ void WeaveSecurityManager::HandleCASEMessageInitiator(ExchangeContext *ec, const
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+    if (msgBuf != NULL)
+        PacketBuffer::Free(msgBuf);
+}
+
+WEAVE_ERROR WeaveSecurityManager::RunCASEProcessBeginSessionResponse(CryptoJob *job)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+
+    return sess->CASEEngine->ProcessBeginSessionResponse(sess->JobMsgBuf, sess->CASEBeginResp);
+}
+
+void WeaveSecurityManager::HandleCASEBeginSessionResponseProcessed(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    PacketBuffer *msgBuf = NULL;
+    uint16_t sendFlags = 0;
+
+    // Release the buffer containing the response.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
+    SuccessOrExit(err);
+
+    // If performing key confirmation...
+    if (sess->CASEEngine->PerformingKeyConfirm())
+    {
+        // Generate and encode an InitiatorKeyConfirm message.
+        msgBuf = PacketBuffer::New();
+        VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+        err = sess->CASEEngine->GenerateInitiatorKeyConfirm(msgBuf);
+        SuccessOrExit(err);
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+        if (sess->Con == NULL)
+        {
+            sendFlags = ExchangeContext::kSendFlag_RequestAck;
+        }
+#endif
+
+        // Send the InitiatorKeyConfirm message to the peer.
+        err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_CASEInitiatorKeyConfirm, msgBuf, sendFlags);
+        msgBuf = NULL;
+        SuccessOrExit(err);
+    }
+
+    // Initialize the newly established security session.
+    err = secMgr->HandleSessionEstablished(sess);
+    SuccessOrExit(err);
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    // Complete the session when any of these is true:
+    //     - session establishment was done over a Weave connection
+    //     - key confirmation wasn't required
+    // For WRMP when key confirmation is required, the session will be completed
+    // on one of these events:
+    //     - Received Ack from the peer for the last message on this exchange (CASEInitiatorKeyConfirm)
+    //     - Received first message from the peer encrypted with established session key (sess->SessionKeyId)
+    if (sess->Con || !sess->CASEEngine->PerformingKeyConfirm())
+#endif
+    {
+        secMgr->HandleSessionComplete(sess);
+    }
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        secMgr->HandleSessionError(sess, err, NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
@@ -1236,18 +1429,13 @@ WEAVE_ERROR WeaveSecurityManager::StartCASESession(WeaveConnection *con, uint64_
 
 #if WEAVE_CONFIG_ENABLE_CASE_RESPONDER
 
-void WeaveSecurityManager::HandleCASESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
+void WeaveSecurityManager::HandleCASESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
 {
-    WEAVE_ERROR                         err;
-    WeaveSessionKey                     *sessionKey;
-    CASE::BeginSessionRequestMessage    req;
-    CASE::ReconfigureMessage            reconf;
-    PacketBuffer                        *respMsgBuf = NULL;
-    uint16_t                            sendFlags = 0;
-
-    State = kState_CASEInProgress;
-    mEC = ec;
-    mCon = ec->Con;
+    WEAVE_ERROR err;
+
+    sess->EC = ec;
+    sess->Con = ec->Con;
+    ec->AppState = sess;
     ec->OnMessageReceived = HandleCASEMessageResponder;
     ec->OnConnectionClosed = HandleConnectionClosed;
 
@@ -1255,64 +1443,126 @@ void WeaveSecurityManager::HandleCASESessionStart(ExchangeContext *ec, const IPP
     ec->AddRef();
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    if (mCon == NULL)
+    if (sess->Con == NULL)
     {
-        mEC->OnAckRcvd = WRMPHandleAckRcvd;
-        mEC->OnSendError = WRMPHandleSendError;
+        sess->EC->OnAckRcvd = WRMPHandleAckRcvd;
+        sess->EC->OnSendError = WRMPHandleSendError;
 
         // Flush any pending WRM ACKs before we begin the long crypto operation,
         // to prevent the peer from re-transmitting the Begin Session request.
-        err = mEC->WRMPFlushAcks();
+        err = sess->EC->WRMPFlushAcks();
         SuccessOrExit(err);
-
-        sendFlags |= ExchangeContext::kSendFlag_RequestAck;
     }
 #endif
 
-    // Initialize Weave Platform Memory
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Allocate and initialize a CASE engine.
-    mCASEEngine = (WeaveCASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveCASEEngine), true);
-    VerifyOrExit(mCASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mCASEEngine->Init();
+    sess->CASEEngine = (WeaveCASEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveCASEEngine), true);
+    VerifyOrExit(sess->CASEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->CASEEngine->Init();
 
     // Since this session is being initiated by a remote node, use the default auth delegate.
     // Reject the request if no auth delegate has been set.
     VerifyOrExit(mDefaultAuthDelegate != NULL, err = WEAVE_ERROR_NO_CASE_AUTH_DELEGATE);
-    mCASEEngine->AuthDelegate = mDefaultAuthDelegate;
+    sess->CASEEngine->AuthDelegate = mDefaultAuthDelegate;
 
     // Set the allowed protocol options for a responder.
-    mCASEEngine->SetAllowedConfigs(ResponderAllowedCASEConfigs);
-    mCASEEngine->SetAllowedCurves(ResponderAllowedCASECurves);
-    mCASEEngine->SetResponderRequiresKeyConfirm(true);
+    sess->CASEEngine->SetAllowedConfigs(ResponderAllowedCASEConfigs);
+    sess->CASEEngine->SetAllowedCurves(ResponderAllowedCASECurves);
+    sess->CASEEngine->SetResponderRequiresKeyConfirm(true);
 
 #if WEAVE_CONFIG_SECURITY_TEST_MODE
-    mCASEEngine->SetUseKnownECDHKey(CASEUseKnownECDHKey);
+    sess->CASEEngine->SetUseKnownECDHKey(CASEUseKnownECDHKey);
 #endif
 
-    // Process the BeginSessionRequest
-    req.Reset();
-    req.PeerNodeId = ec->PeerNodeId;
-    reconf.Reset();
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mCASEEngine->ProcessBeginSessionRequest(msgBuf, req, reconf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    sess->CASEBeginReq.Reset();
+    sess->CASEBeginReq.PeerNodeId = ec->PeerNodeId;
+    sess->CASEReconf.Reset();
+    sess->CASEBeginResp.Reset();
+    sess->CASEBeginResp.PeerNodeId = ec->PeerNodeId;
+
+    // Allocate a buffer to hold the encoded BeginSessionResponse (or Reconfigure) message.
+    sess->JobRespMsgBuf = PacketBuffer::New();
+    VerifyOrExit(sess->JobRespMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    // Process the BeginSessionRequest and generate the BeginSessionResponse on a crypto worker.  The
+    // request buffer is held by the session until the job completes, since the decoded request refers
+    // into it.  Processing continues in HandleCASEBeginSessionRequestProcessed().
+    sess->JobMsgBuf = msgBuf;
+    msgBuf = NULL;
+
+    err = StartCryptoJob(sess, RunCASEProcessBeginSessionRequest, HandleCASEBeginSessionRequestProcessed);
+    SuccessOrExit(err);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        HandleSessionError(sess, err, NULL);
+    if (msgBuf != NULL)
+        PacketBuffer::Free(msgBuf);
+}
+
+WEAVE_ERROR WeaveSecurityManager::RunCASEProcessBeginSessionRequest(CryptoJob *job)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    CASE::BeginSessionRequestMessage& req = sess->CASEBeginReq;
+    CASE::BeginSessionResponseMessage& resp = sess->CASEBeginResp;
+    WEAVE_ERROR err;
+
+    // Process the BeginSessionRequest.
+    err = sess->CASEEngine->ProcessBeginSessionRequest(sess->JobMsgBuf, req, sess->CASEReconf);
+    SuccessOrExit(err);
+
+    // Prepare the contents of a BeginSessionResponse message to be sent to the initiator.
+    resp.ProtocolConfig = req.ProtocolConfig;
+    resp.CurveId = req.CurveId;
+    resp.PerformKeyConfirm = true;
+
+    // Generate the BeginSessionResponse message.
+    err = sess->CASEEngine->GenerateBeginSessionResponse(resp, sess->JobRespMsgBuf, req);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+void WeaveSecurityManager::HandleCASEBeginSessionRequestProcessed(CryptoJob *job, WEAVE_ERROR err)
+{
+    SessionContext *sess = (SessionContext *)job->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
+    ExchangeContext *ec = sess->EC;
+    WeaveSessionKey *sessionKey;
+    PacketBuffer *respMsgBuf = sess->JobRespMsgBuf;
+    uint16_t sendFlags = 0;
+
+    sess->JobRespMsgBuf = NULL;
+
+    // Discard the request buffer.
+    PacketBuffer::Free(sess->JobMsgBuf);
+    sess->JobMsgBuf = NULL;
+
+    secMgr->EndCryptoJob(sess, err);
     if (err != WEAVE_ERROR_CASE_RECONFIG_REQUIRED)
         SuccessOrExit(err);
 
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    if (sess->Con == NULL)
+    {
+        sendFlags |= ExchangeContext::kSendFlag_RequestAck;
+    }
+#endif
+
     // If a reconfigure is required...
     if (err == WEAVE_ERROR_CASE_RECONFIG_REQUIRED)
     {
-        // Discard the request buffer.
-        PacketBuffer::Free(msgBuf);
-        msgBuf = NULL;
-
-        // Encode a CASE Reconfigure message into a new buffer.
-        respMsgBuf = PacketBuffer::New();
-        VerifyOrExit(respMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
-        err = reconf.Encode(respMsgBuf);
+        // Encode a CASE Reconfigure message into the unused response buffer.
+        err = sess->CASEReconf.Encode(respMsgBuf);
         SuccessOrExit(err);
 
         // Send the Reconfigure message to the peer.
@@ -1321,7 +1571,7 @@ void WeaveSecurityManager::HandleCASESessionStart(ExchangeContext *ec, const IPP
         SuccessOrExit(err);
 
         // Reset the security manager.
-        Reset();
+        secMgr->Reset(sess);
     }
 
     // Otherwise the proposed protocol parameters are acceptable, so...
@@ -1332,32 +1582,14 @@ void WeaveSecurityManager::HandleCASESessionStart(ExchangeContext *ec, const IPP
         // be bound to the connection, such that when the connection closes, the key is removed.
         // Set the RemoveOnIdle flag so that the session will be automatically removed after a period of
         // inactivity (note that this only applies to sessions that are NOT bound to connections).
-        err = FabricState->AllocSessionKey(ec->PeerNodeId, req.SessionKeyId, ec->Con, sessionKey);
+        err = secMgr->FabricState->AllocSessionKey(ec->PeerNodeId, sess->CASEBeginReq.SessionKeyId, ec->Con, sessionKey);
         SuccessOrExit(err);
         sessionKey->SetLocallyInitiated(false);
         sessionKey->SetRemoveOnIdle(true);
 
         // Save the proposed session key id and encryption type.
-        mSessionKeyId = req.SessionKeyId;
-        mEncType = req.EncryptionType;
-
-        // Prepare the contents of a BeginSessionResponse message to be sent to the initiator.
-        CASE::BeginSessionResponseMessage resp;
-        resp.Reset();
-        resp.PeerNodeId = ec->PeerNodeId;
-        resp.ProtocolConfig = req.ProtocolConfig;
-        resp.CurveId = req.CurveId;
-        resp.PerformKeyConfirm = true;
-
-        // Allocate a buffer to hold the encoded BeginSessionResponse message.
-        respMsgBuf = PacketBuffer::New();
-        VerifyOrExit(respMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
-
-        // Generate the BeginSessionResponse message.
-        Platform::Security::OnTimeConsumingCryptoStart();
-        err = mCASEEngine->GenerateBeginSessionResponse(resp, respMsgBuf, req);
-        Platform::Security::OnTimeConsumingCryptoDone();
-        SuccessOrExit(err);
+        sess->SessionKeyId = sess->CASEBeginReq.SessionKeyId;
+        sess->EncType = sess->CASEBeginReq.EncryptionType;
 
         // Send the BeginSessionResponse message to the peer.
         err = ec->SendMessage(kWeaveProfile_Security, kMsgType_CASEBeginSessionResponse, respMsgBuf, sendFlags);
@@ -1365,34 +1597,32 @@ void WeaveSecurityManager::HandleCASESessionStart(ExchangeContext *ec, const IPP
         SuccessOrExit(err);
 
         // Start a timer to limit the overall duration of session establishment.
-        StartSessionTimer();
+        secMgr->StartSessionTimer(sess);
 
         // If the CASE interaction is complete...
         // (NOTE: this will only be true if the initiator didn't request key confirmation).
-        if (mCASEEngine->State == CASE::WeaveCASEEngine::kState_Complete)
+        if (sess->CASEEngine->State == CASE::WeaveCASEEngine::kState_Complete)
         {
             // Initialize the new session.
-            err = HandleSessionEstablished();
+            err = secMgr->HandleSessionEstablished(sess);
             SuccessOrExit(err);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
             // 1. Complete the session now if it was established over a connection.
             // 2. For WRMP the session will be completed on one of these events:
             //     - Received Ack from the peer for the last message on this exchange (CASEBeginSessionResponse)
-            //     - Received first message from the peer encrypted with established session key (mSessionKeyId)
-            if (mCon)
+            //     - Received first message from the peer encrypted with established session key (sess->SessionKeyId)
+            if (sess->Con)
 #endif
             {
-                HandleSessionComplete();
+                secMgr->HandleSessionComplete(sess);
             }
         }
     }
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
-    if (msgBuf != NULL)
-        PacketBuffer::Free(msgBuf);
+        secMgr->HandleSessionError(sess, err, NULL);
     if (respMsgBuf != NULL)
         PacketBuffer::Free(respMsgBuf);
 }
@@ -1401,9 +1631,10 @@ void WeaveSecurityManager::HandleCASEMessageResponder(ExchangeContext *ec, const
         const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the CASE interaction immediately if we receive a status report message from the initiator.
     // This is a signal that the initiator does not want to continue.
@@ -1414,28 +1645,32 @@ void WeaveSecurityManager::HandleCASEMessageResponder(ExchangeContext *ec, const
     VerifyOrExit(profileId == kWeaveProfile_Security && msgType == kMsgType_CASEInitiatorKeyConfirm,
                  err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
 
+    // The initiator cannot have sent its key confirmation before our response, which is still
+    // being generated while a crypto job is outstanding.
+    VerifyOrExit(!sess->CryptoJobPending, err = WEAVE_ERROR_INCORRECT_STATE);
+
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
     // Flush any pending WRM ACKs to give sooner notification to the peer that current
     // CASE session establishment can be finalized.
-    err = secMgr->mEC->WRMPFlushAcks();
+    err = sess->EC->WRMPFlushAcks();
     SuccessOrExit(err);
 #endif
 
     // Process the initiator's key confirm message.
     // NOTE: No need to initialize crypto memory for this call.
-    err = secMgr->mCASEEngine->ProcessInitiatorKeyConfirm(msgBuf);
+    err = sess->CASEEngine->ProcessInitiatorKeyConfirm(msgBuf);
     SuccessOrExit(err);
 
     // At this point the session is established.
-    err = secMgr->HandleSessionEstablished();
+    err = secMgr->HandleSessionEstablished(sess);
     SuccessOrExit(err);
 
     // Complete the session and notify the user.
-    secMgr->HandleSessionComplete();
+    secMgr->HandleSessionComplete(sess);
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
@@ -1476,15 +1711,13 @@ WEAVE_ERROR WeaveSecurityManager::StartTAKESession(WeaveConnection *con, WeaveAu
                                                    WeaveTAKEChallengerAuthDelegate *authDelegate)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SessionContext *sess = NULL;
     bool useSessionKeyID = encryptAuthPhase || encryptCommPhase;
     bool clearStateOnError = false;
 
     // Verify security manager has been initialized.
     VerifyOrExit(State != kState_NotInitialized, err = WEAVE_ERROR_INCORRECT_STATE);
 
-    // Verify there is no session in process.
-    VerifyOrExit(State == kState_Idle, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
-
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_SecMgrBusy,
         {
             AsyncNotifySecurityManagerAvailable();
@@ -1497,14 +1730,17 @@ WEAVE_ERROR WeaveSecurityManager::StartTAKESession(WeaveConnection *con, WeaveAu
     // Reject the request if no connection has been specified.
     VerifyOrExit(con != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-    State = kState_TAKEInProgress;
-    mRequestedAuthMode = requestedAuthMode;
-    mEncType = kWeaveEncryptionType_AES128CTRSHA1;
-    mCon = con;
-    mStartSecureSession_OnComplete = onComplete;
-    mStartSecureSession_OnError = onError;
-    mStartSecureSession_ReqState = reqState;
-    mSessionKeyId = WeaveKeyId::kNone;
+    // Claim a session context, subject to the overall and per-peer concurrency limits.
+    sess = AllocSession(con->PeerNodeId, kState_TAKEInProgress);
+    VerifyOrExit(sess != NULL, err = WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+    sess->RequestedAuthMode = requestedAuthMode;
+    sess->EncType = kWeaveEncryptionType_AES128CTRSHA1;
+    sess->Con = con;
+    sess->StartSecureSession_OnComplete = onComplete;
+    sess->StartSecureSession_OnError = onError;
+    sess->StartSecureSession_ReqState = reqState;
+    sess->SessionKeyId = WeaveKeyId::kNone;
 
     // Any error after this point requires call to the Reset() function.
     clearStateOnError = true;
@@ -1517,61 +1753,65 @@ WEAVE_ERROR WeaveSecurityManager::StartTAKESession(WeaveConnection *con, WeaveAu
         err = FabricState->AllocSessionKey(con->PeerNodeId, WeaveKeyId::kNone, con, sessionKey);
         SuccessOrExit(err);
         sessionKey->SetLocallyInitiated(true);
-        mSessionKeyId = sessionKey->MsgEncKey.KeyId;
+        sess->SessionKeyId = sessionKey->MsgEncKey.KeyId;
     }
 
     // Create a new exchange context.
-    err = NewSessionExchange(mCon->PeerNodeId, mCon->PeerAddr, mCon->PeerPort);
+    err = NewSessionExchange(sess, sess->Con->PeerNodeId, sess->Con->PeerAddr, sess->Con->PeerPort);
     SuccessOrExit(err);
 
-    // Initialize Weave platform memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Allocate and initialize TAKE engine object.
-    mTAKEEngine = (WeaveTAKEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveTAKEEngine), true);
-    VerifyOrExit(mTAKEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mTAKEEngine->Init();
+    sess->TAKEEngine = (WeaveTAKEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveTAKEEngine), true);
+    VerifyOrExit(sess->TAKEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->TAKEEngine->Init();
 
     if (authDelegate == NULL)
         authDelegate = mDefaultTAKEChallengerAuthDelegate;
     VerifyOrExit(authDelegate != NULL, err = WEAVE_ERROR_NO_TAKE_AUTH_DELEGATE);
-    mTAKEEngine->ChallengerAuthDelegate = authDelegate;
+    sess->TAKEEngine->ChallengerAuthDelegate = authDelegate;
 
     // Start TAKE session.
-    StartTAKESession(encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId);
+    StartTAKESession(sess, encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId);
 
 exit:
     if (err != WEAVE_NO_ERROR && clearStateOnError)
     {
-        FabricState->RemoveSessionKey(mSessionKeyId, con->PeerNodeId);
+        FabricState->RemoveSessionKey(sess->SessionKeyId, con->PeerNodeId);
 
-        Reset();
+        Reset(sess);
     }
 
     return err;
 }
 
-void WeaveSecurityManager::StartTAKESession(bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId)
+void WeaveSecurityManager::StartTAKESession(SessionContext *sess, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId)
 {
     WEAVE_ERROR err;
 
-    err = SendTAKEIdentifyToken(TAKE::kTAKEConfig_Config1, encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId);
+    err = SendTAKEIdentifyToken(sess, TAKE::kTAKEConfig_Config1, encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId);
     SuccessOrExit(err);
 
-    mEncType = mTAKEEngine->GetEncryptionType();
+    sess->EncType = sess->TAKEEngine->GetEncryptionType();
 
-    mEC->OnMessageReceived = HandleTAKEMessageInitiator;
-    mEC->OnConnectionClosed = HandleConnectionClosed;
+    sess->EC->OnMessageReceived = HandleTAKEMessageInitiator;
+    sess->EC->OnConnectionClosed = HandleConnectionClosed;
 
     // Using a smaller timeout may help prevent Relay Attack.
     // TODO: consider reducing the timeout, and using different values of timeout
     // for first and subsequent authentication.
-    StartSessionTimer();
+    StartSessionTimer(sess);
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
+        HandleSessionError(sess, err, NULL);
 }
 
 
@@ -1579,9 +1819,10 @@ void WeaveSecurityManager::HandleTAKEMessageInitiator(ExchangeContext *ec, const
         uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the TAKE interaction immediately if we receive a status report message from the responder.
     // This is a signal that the responder does not want to continue.
@@ -1598,15 +1839,15 @@ void WeaveSecurityManager::HandleTAKEMessageInitiator(ExchangeContext *ec, const
     {
     case kMsgType_TAKEIdentifyTokenResponse:
     {
-        err = secMgr->ProcessTAKEIdentifyTokenResponse(msgBuf);
+        err = secMgr->ProcessTAKEIdentifyTokenResponse(sess, msgBuf);
         bool doReauth = err == WEAVE_ERROR_TAKE_REAUTH_POSSIBLE;
 
         if (!doReauth)
             SuccessOrExit(err);
 
-        if (secMgr->mTAKEEngine->IsEncryptAuthPhase())
+        if (sess->TAKEEngine->IsEncryptAuthPhase())
         {
-            err = secMgr->CreateTAKESecureSession();
+            err = secMgr->CreateTAKESecureSession(sess);
             SuccessOrExit(err);
         }
 
@@ -1616,11 +1857,11 @@ void WeaveSecurityManager::HandleTAKEMessageInitiator(ExchangeContext *ec, const
 
         if (doReauth)
         {
-            err = secMgr->SendTAKEReAuthenticateToken();
+            err = secMgr->SendTAKEReAuthenticateToken(sess);
         }
         else
         {
-            err = secMgr->SendTAKEAuthenticateToken();
+            err = secMgr->SendTAKEAuthenticateToken(sess);
         }
         SuccessOrExit(err);
         break;
@@ -1628,44 +1869,44 @@ void WeaveSecurityManager::HandleTAKEMessageInitiator(ExchangeContext *ec, const
     case kMsgType_TAKETokenReconfigure:
         uint8_t newConfig;
 
-        err = secMgr->ProcessTAKETokenReconfigure(newConfig, msgBuf);
+        err = secMgr->ProcessTAKETokenReconfigure(sess, newConfig, msgBuf);
         SuccessOrExit(err);
 
         // Free the received message buffer so that it can be reused to send the outgoing message.
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->SendTAKEIdentifyToken(newConfig, secMgr->mTAKEEngine->IsEncryptAuthPhase(),
-                secMgr->mTAKEEngine->IsEncryptCommPhase(), secMgr->mTAKEEngine->IsTimeLimitedIK(), secMgr->mTAKEEngine->HasSentChallengerId());
+        err = secMgr->SendTAKEIdentifyToken(sess, newConfig, sess->TAKEEngine->IsEncryptAuthPhase(),
+                sess->TAKEEngine->IsEncryptCommPhase(), sess->TAKEEngine->IsTimeLimitedIK(), sess->TAKEEngine->HasSentChallengerId());
         SuccessOrExit(err);
         break;
 
     case kMsgType_TAKEAuthenticateTokenResponse:
-        err = secMgr->ProcessTAKEAuthenticateTokenResponse(msgBuf);
+        err = secMgr->ProcessTAKEAuthenticateTokenResponse(sess, msgBuf);
         SuccessOrExit(err);
 
         // Free the received message buffer so that it can be reused to send the outgoing message.
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->FinishTAKESetUp();
+        err = secMgr->FinishTAKESetUp(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
         break;
 
     case kMsgType_TAKEReAuthenticateTokenResponse:
-        err = secMgr->ProcessTAKEReAuthenticateTokenResponse(msgBuf);
+        err = secMgr->ProcessTAKEReAuthenticateTokenResponse(sess, msgBuf);
         SuccessOrExit(err);
 
         // Free the received message buffer so that it can be reused to send the outgoing message.
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->FinishTAKESetUp();
+        err = secMgr->FinishTAKESetUp(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
         break;
 
     default:
@@ -1675,12 +1916,12 @@ void WeaveSecurityManager::HandleTAKEMessageInitiator(ExchangeContext *ec, const
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKEIdentifyToken(uint8_t takeConfig, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId)
+WEAVE_ERROR WeaveSecurityManager::SendTAKEIdentifyToken(SessionContext *sess, uint8_t takeConfig, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId)
 {
     WEAVE_ERROR     err;
     PacketBuffer*   msgBuf = NULL;
@@ -1689,11 +1930,11 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKEIdentifyToken(uint8_t takeConfig, bool
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    err = mTAKEEngine->GenerateIdentifyTokenMessage(mSessionKeyId, takeConfig, encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId, kWeaveEncryptionType_AES128CTRSHA1, FabricState->LocalNodeId, msgBuf);
+    err = sess->TAKEEngine->GenerateIdentifyTokenMessage(sess->SessionKeyId, takeConfig, encryptAuthPhase, encryptCommPhase, timeLimitedIK, sendChallengerId, kWeaveEncryptionType_AES128CTRSHA1, FabricState->LocalNodeId, msgBuf);
     SuccessOrExit(err);
 
     // Send the message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEIdentifyToken, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEIdentifyToken, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -1704,29 +1945,29 @@ exit:
 }
 
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKEIdentifyTokenResponse(const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKEIdentifyTokenResponse(SessionContext *sess, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = mTAKEEngine->ProcessIdentifyTokenResponseMessage(msgBuf);
+    err = sess->TAKEEngine->ProcessIdentifyTokenResponseMessage(msgBuf);
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKETokenReconfigure(uint8_t& config, const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKETokenReconfigure(SessionContext *sess, uint8_t& config, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = mTAKEEngine->ProcessTokenReconfigureMessage(config, msgBuf);
+    err = sess->TAKEEngine->ProcessTokenReconfigureMessage(config, msgBuf);
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateToken(void)
+WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateToken(SessionContext *sess)
 {
     WEAVE_ERROR     err = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf = NULL;
@@ -1734,12 +1975,12 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateToken(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mTAKEEngine->GenerateAuthenticateTokenMessage(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    StartTimeConsumingCrypto();
+    err = sess->TAKEEngine->GenerateAuthenticateTokenMessage(msgBuf);
+    EndTimeConsumingCrypto();
     SuccessOrExit(err);
 
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEAuthenticateToken, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEAuthenticateToken, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -1747,20 +1988,20 @@ exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKEAuthenticateTokenResponse(const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKEAuthenticateTokenResponse(SessionContext *sess, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mTAKEEngine->ProcessAuthenticateTokenResponseMessage(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    StartTimeConsumingCrypto();
+    err = sess->TAKEEngine->ProcessAuthenticateTokenResponseMessage(msgBuf);
+    EndTimeConsumingCrypto();
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateToken(void)
+WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateToken(SessionContext *sess)
 {
     WEAVE_ERROR     err = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf = NULL;
@@ -1768,10 +2009,10 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateToken(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    err = mTAKEEngine->GenerateReAuthenticateTokenMessage(msgBuf);
+    err = sess->TAKEEngine->GenerateReAuthenticateTokenMessage(msgBuf);
     SuccessOrExit(err);
 
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEReAuthenticateToken, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEReAuthenticateToken, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -1779,11 +2020,11 @@ exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKEReAuthenticateTokenResponse(const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKEReAuthenticateTokenResponse(SessionContext *sess, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = mTAKEEngine->ProcessReAuthenticateTokenResponseMessage(msgBuf);
+    err = sess->TAKEEngine->ProcessReAuthenticateTokenResponseMessage(msgBuf);
     SuccessOrExit(err);
 
 exit:
@@ -1805,7 +2046,7 @@ WEAVE_ERROR WeaveSecurityManager::StartTAKESession(WeaveConnection *con, WeaveAu
 
 #if WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
 
-void WeaveSecurityManager::HandleTAKESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
+void WeaveSecurityManager::HandleTAKESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR     err = WEAVE_NO_ERROR;
     PacketBuffer*   respMsgBuf = NULL;
@@ -1813,9 +2054,9 @@ void WeaveSecurityManager::HandleTAKESessionStart(ExchangeContext *ec, const IPP
     VerifyOrExit(mDefaultTAKETokenAuthDelegate != NULL, err = WEAVE_ERROR_NO_TAKE_AUTH_DELEGATE);
 
     // Setup state for the new TAKE exchange.
-    State = kState_TAKEInProgress;
-    mEC = ec;
-    mCon = ec->Con;
+    sess->EC = ec;
+    sess->Con = ec->Con;
+    ec->AppState = sess;
 
     ec->OnMessageReceived = HandleTAKEMessageResponder;
     ec->OnConnectionClosed = HandleConnectionClosed;
@@ -1823,60 +2064,64 @@ void WeaveSecurityManager::HandleTAKESessionStart(ExchangeContext *ec, const IPP
     // Ensure the exchange context stays around until we're done with it.
     ec->AddRef();
 
-    StartSessionTimer();
+    StartSessionTimer(sess);
 
-    // Initialize Weave Platform Memory
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Prepare TAKE engine and start session
-    mTAKEEngine = (WeaveTAKEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveTAKEEngine), true);
-    VerifyOrExit(mTAKEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mTAKEEngine->Init();
+    sess->TAKEEngine = (WeaveTAKEEngine *)Platform::Security::MemoryAlloc(sizeof(WeaveTAKEEngine), true);
+    VerifyOrExit(sess->TAKEEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->TAKEEngine->Init();
 
-    mTAKEEngine->TokenAuthDelegate = mDefaultTAKETokenAuthDelegate;
+    sess->TAKEEngine->TokenAuthDelegate = mDefaultTAKETokenAuthDelegate;
 
-    err = mTAKEEngine->ProcessIdentifyTokenMessage(ec->PeerNodeId, msgBuf);
+    err = sess->TAKEEngine->ProcessIdentifyTokenMessage(ec->PeerNodeId, msgBuf);
     PacketBuffer::Free(msgBuf);
     msgBuf = NULL;
 
     if (err == WEAVE_ERROR_TAKE_RECONFIGURE_REQUIRED)
     {
-        err = SendTAKETokenReconfigure();
+        err = SendTAKETokenReconfigure(sess);
         SuccessOrExit(err);
 
         // Reset state.
-        Reset();
+        Reset(sess);
 
         ExitNow();
     }
 
     SuccessOrExit(err);
 
-    if (mTAKEEngine->UseSessionKey())
+    if (sess->TAKEEngine->UseSessionKey())
     {
         WeaveSessionKey *sessionKey;
-        err = FabricState->AllocSessionKey(ec->PeerNodeId, mTAKEEngine->SessionKeyId, ec->Con, sessionKey);
+        err = FabricState->AllocSessionKey(ec->PeerNodeId, sess->TAKEEngine->SessionKeyId, ec->Con, sessionKey);
         SuccessOrExit(err);
         sessionKey->SetLocallyInitiated(false);
         sessionKey->SetRemoveOnIdle(true);
-        mSessionKeyId = mTAKEEngine->SessionKeyId;
-        mEncType = mTAKEEngine->GetEncryptionType();
+        sess->SessionKeyId = sess->TAKEEngine->SessionKeyId;
+        sess->EncType = sess->TAKEEngine->GetEncryptionType();
     }
 
     respMsgBuf = PacketBuffer::New();
     VerifyOrExit(respMsgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    err = mTAKEEngine->GenerateIdentifyTokenResponseMessage(respMsgBuf);
+    err = sess->TAKEEngine->GenerateIdentifyTokenResponseMessage(respMsgBuf);
     SuccessOrExit(err);
 
     err = ec->SendMessage(kWeaveProfile_Security, kMsgType_TAKEIdentifyTokenResponse, respMsgBuf);
     respMsgBuf = NULL;
     SuccessOrExit(err);
 
-    if (mTAKEEngine->IsEncryptAuthPhase())
+    if (sess->TAKEEngine->IsEncryptAuthPhase())
     {
-        err = CreateTAKESecureSession();
+        err = CreateTAKESecureSession(sess);
         SuccessOrExit(err);
     }
 
@@ -1886,16 +2131,17 @@ exit:
     if (respMsgBuf != NULL)
         PacketBuffer::Free(respMsgBuf);
     if (err != WEAVE_NO_ERROR)
-        HandleSessionError(err, NULL);
+        HandleSessionError(sess, err, NULL);
 }
 
 void WeaveSecurityManager::HandleTAKEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo,
         const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the TAKE interaction immediately if we receive a status report message from the initiator.
     // This is a signal that the initiator does not want to continue.
@@ -1908,36 +2154,36 @@ void WeaveSecurityManager::HandleTAKEMessageResponder(ExchangeContext *ec, const
     switch (msgType)
     {
     case kMsgType_TAKEAuthenticateToken:
-        err = secMgr->ProcessTAKEAuthenticateToken(msgBuf);
+        err = secMgr->ProcessTAKEAuthenticateToken(sess, msgBuf);
         SuccessOrExit(err);
 
-        err = secMgr->SendTAKEAuthenticateTokenResponse();
+        err = secMgr->SendTAKEAuthenticateTokenResponse(sess);
         SuccessOrExit(err);
 
         // freeing the buffer after the generation of the next message in order to not copy the gx array
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->FinishTAKESetUp();
+        err = secMgr->FinishTAKESetUp(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
         break;
 
     case kMsgType_TAKEReAuthenticateToken:
-        err = secMgr->ProcessTAKEReAuthenticateToken(msgBuf);
+        err = secMgr->ProcessTAKEReAuthenticateToken(sess, msgBuf);
         SuccessOrExit(err);
 
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->SendTAKEReAuthenticateTokenResponse();
+        err = secMgr->SendTAKEReAuthenticateTokenResponse(sess);
         SuccessOrExit(err);
 
-        err = secMgr->FinishTAKESetUp();
+        err = secMgr->FinishTAKESetUp(sess);
         SuccessOrExit(err);
 
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
         break;
 
     default:
@@ -1951,25 +2197,25 @@ void WeaveSecurityManager::HandleTAKEMessageResponder(ExchangeContext *ec, const
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleSessionError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleSessionError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKEAuthenticateToken(const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKEAuthenticateToken(SessionContext *sess, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mTAKEEngine->ProcessAuthenticateTokenMessage(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    StartTimeConsumingCrypto();
+    err = sess->TAKEEngine->ProcessAuthenticateTokenMessage(msgBuf);
+    EndTimeConsumingCrypto();
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKETokenReconfigure(void)
+WEAVE_ERROR WeaveSecurityManager::SendTAKETokenReconfigure(SessionContext *sess)
 {
     WEAVE_ERROR     err     = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf  = NULL;
@@ -1978,10 +2224,10 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKETokenReconfigure(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    err = mTAKEEngine->GenerateTokenReconfigureMessage(msgBuf);
+    err = sess->TAKEEngine->GenerateTokenReconfigureMessage(msgBuf);
     SuccessOrExit(err);
 
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKETokenReconfigure, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKETokenReconfigure, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -1991,7 +2237,7 @@ exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateTokenResponse(void)
+WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateTokenResponse(SessionContext *sess)
 {
     WEAVE_ERROR     err     = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf  = NULL;
@@ -1999,12 +2245,12 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKEAuthenticateTokenResponse(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    Platform::Security::OnTimeConsumingCryptoStart();
-    err = mTAKEEngine->GenerateAuthenticateTokenResponseMessage(msgBuf);
-    Platform::Security::OnTimeConsumingCryptoDone();
+    StartTimeConsumingCrypto();
+    err = sess->TAKEEngine->GenerateAuthenticateTokenResponseMessage(msgBuf);
+    EndTimeConsumingCrypto();
     SuccessOrExit(err);
 
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEAuthenticateTokenResponse, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEAuthenticateTokenResponse, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -2014,11 +2260,11 @@ exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::ProcessTAKEReAuthenticateToken(const PacketBuffer* msgBuf)
+WEAVE_ERROR WeaveSecurityManager::ProcessTAKEReAuthenticateToken(SessionContext *sess, const PacketBuffer* msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = mTAKEEngine->ProcessReAuthenticateTokenMessage(msgBuf);
+    err = sess->TAKEEngine->ProcessReAuthenticateTokenMessage(msgBuf);
     SuccessOrExit(err);
 
 exit:
@@ -2026,7 +2272,7 @@ exit:
 }
 
 
-WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateTokenResponse(void)
+WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateTokenResponse(SessionContext *sess)
 {
     WEAVE_ERROR     err     = WEAVE_NO_ERROR;
     PacketBuffer*   msgBuf  = NULL;
@@ -2034,10 +2280,10 @@ WEAVE_ERROR WeaveSecurityManager::SendTAKEReAuthenticateTokenResponse(void)
     msgBuf = PacketBuffer::New();
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    err = mTAKEEngine->GenerateReAuthenticateTokenResponseMessage(msgBuf);
+    err = sess->TAKEEngine->GenerateReAuthenticateTokenResponseMessage(msgBuf);
     SuccessOrExit(err);
 
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEReAuthenticateTokenResponse, msgBuf, 0);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_TAKEReAuthenticateTokenResponse, msgBuf, 0);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -2051,44 +2297,44 @@ exit:
 
 #if WEAVE_CONFIG_ENABLE_TAKE_INITIATOR || WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
 
-WEAVE_ERROR WeaveSecurityManager::CreateTAKESecureSession(void)
+WEAVE_ERROR WeaveSecurityManager::CreateTAKESecureSession(SessionContext *sess)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = HandleSessionEstablished();
+    err = HandleSessionEstablished(sess);
     SuccessOrExit(err);
 
-    mEC->KeyId = mSessionKeyId;
-    mEC->EncryptionType = mEncType;
+    sess->EC->KeyId = sess->SessionKeyId;
+    sess->EC->EncryptionType = sess->EncType;
 
     // Add a reservation for the new session key and configure the ExchangeContext to automatically release
     // the key when the context is freed.  This will ensure the key is not removed until rest of the TAKE
     // exchange completes.
-    ReserveKey(mEC->PeerNodeId, mEC->KeyId);
-    mEC->SetAutoReleaseKey(true);
+    ReserveKey(sess->EC->PeerNodeId, sess->EC->KeyId);
+    sess->EC->SetAutoReleaseKey(true);
 
 exit:
     return err;
 }
 
-WEAVE_ERROR WeaveSecurityManager::FinishTAKESetUp(void)
+WEAVE_ERROR WeaveSecurityManager::FinishTAKESetUp(SessionContext *sess)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    if (mTAKEEngine->IsEncryptCommPhase())
+    if (sess->TAKEEngine->IsEncryptCommPhase())
     {
-        err = HandleSessionEstablished();
+        err = HandleSessionEstablished(sess);
         SuccessOrExit(err);
     }
     else
     {
-        if (mTAKEEngine->IsEncryptAuthPhase())
+        if (sess->TAKEEngine->IsEncryptAuthPhase())
         {
-            err = FabricState->RemoveSessionKey(mSessionKeyId, mEC->PeerNodeId);
+            err = FabricState->RemoveSessionKey(sess->SessionKeyId, sess->EC->PeerNodeId);
             SuccessOrExit(err);
         }
-        mEncType = kWeaveEncryptionType_None;
-        mSessionKeyId = WeaveKeyId::kNone;
+        sess->EncType = kWeaveEncryptionType_None;
+        sess->SessionKeyId = WeaveKeyId::kNone;
     }
 
 exit:
@@ -2104,54 +2350,58 @@ WEAVE_ERROR WeaveSecurityManager::StartKeyExport(WeaveConnection *con, uint64_t
         KeyExportCompleteFunct onComplete, KeyExportErrorFunct onError, WeaveKeyExportDelegate *keyExportDelegate)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SessionContext *sess;
 
-    // Verify we've been initialized and that we don't already have a session in process.
+    // Verify we've been initialized and that a session context is available for the peer.
     if (State == kState_NotInitialized)
         return WEAVE_ERROR_INCORRECT_STATE;
-    if (State != kState_Idle)
+    sess = AllocSession(peerNodeId, kState_KeyExportInProgress);
+    if (sess == NULL)
         return WEAVE_ERROR_SECURITY_MANAGER_BUSY;
 
-    State = kState_KeyExportInProgress;
-
-    mCon = con;
+    sess->Con = con;
 
     // Create a new exchange context.
-    err = NewSessionExchange(peerNodeId, peerAddr, peerPort);
+    err = NewSessionExchange(sess, peerNodeId, peerAddr, peerPort);
     SuccessOrExit(err);
 
     // Initialize key export delegate.
     if (keyExportDelegate == NULL)
         keyExportDelegate = mDefaultKeyExportDelegate;
 
-    // Initialize Weave Platform Memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Allocate and initialize KeyExport object.
-    mKeyExport = (WeaveKeyExport *)Platform::Security::MemoryAlloc(sizeof(WeaveKeyExport), true);
-    VerifyOrExit(mKeyExport != NULL, err = WEAVE_ERROR_NO_MEMORY);
-    mKeyExport->Init(keyExportDelegate);
+    sess->KeyExportEngine = (WeaveKeyExport *)Platform::Security::MemoryAlloc(sizeof(WeaveKeyExport), true);
+    VerifyOrExit(sess->KeyExportEngine != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    sess->KeyExportEngine->Init(keyExportDelegate);
 
     // Set the allowed key export protocol configurations.
-    mKeyExport->SetAllowedConfigs(InitiatorAllowedKeyExportConfigs);
+    sess->KeyExportEngine->SetAllowedConfigs(InitiatorAllowedKeyExportConfigs);
 
     // Send key export request message.
-    err = SendKeyExportRequest(InitiatorKeyExportConfig, keyId, signMessage);
+    err = SendKeyExportRequest(sess, InitiatorKeyExportConfig, keyId, signMessage);
     SuccessOrExit(err);
 
-    mStartKeyExport_OnComplete = onComplete;
-    mStartKeyExport_OnError = onError;
-    mStartKeyExport_ReqState = reqState;
+    sess->StartKeyExport_OnComplete = onComplete;
+    sess->StartKeyExport_OnError = onError;
+    sess->StartKeyExport_ReqState = reqState;
 
-    mEC->OnMessageReceived = HandleKeyExportMessageInitiator;
-    mEC->OnConnectionClosed = HandleConnectionClosed;
+    sess->EC->OnMessageReceived = HandleKeyExportMessageInitiator;
+    sess->EC->OnConnectionClosed = HandleConnectionClosed;
 
     // Time limit overall Key Export duration.
-    StartSessionTimer();
+    StartSessionTimer(sess);
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        HandleKeyExportError(err, NULL);
+        HandleKeyExportError(sess, err, NULL);
 
     return err;
 }
@@ -2160,9 +2410,10 @@ void WeaveSecurityManager::HandleKeyExportMessageInitiator(ExchangeContext *ec,
         uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    VerifyOrDie(ec == secMgr->mEC);
+    VerifyOrDie(ec == sess->EC);
 
     // Abort the key export interaction immediately if we receive a status report message from the responder.
     // This is a signal that the responder does not want to continue.
@@ -2177,7 +2428,7 @@ void WeaveSecurityManager::HandleKeyExportMessageInitiator(ExchangeContext *ec,
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
     // Flush any pending WRM ACKs before we begin the long crypto operation,
     // to prevent the peer from re-transmitting message.
-    err = secMgr->mEC->WRMPFlushAcks();
+    err = sess->EC->WRMPFlushAcks();
     SuccessOrExit(err);
 #endif
 
@@ -2187,14 +2438,14 @@ void WeaveSecurityManager::HandleKeyExportMessageInitiator(ExchangeContext *ec,
     case kMsgType_KeyExportReconfigure:
         uint8_t newConfig;
 
-        err = secMgr->mKeyExport->ProcessKeyExportReconfigure(msgBuf->Start(), msgBuf->DataLength(), newConfig);
+        err = sess->KeyExportEngine->ProcessKeyExportReconfigure(msgBuf->Start(), msgBuf->DataLength(), newConfig);
         SuccessOrExit(err);
 
         // Free the received message buffer so that it can be reused to send the outgoing message.
         PacketBuffer::Free(msgBuf);
         msgBuf = NULL;
 
-        err = secMgr->SendKeyExportRequest(newConfig, secMgr->mKeyExport->KeyId, secMgr->mKeyExport->SignMessages);
+        err = secMgr->SendKeyExportRequest(sess, newConfig, sess->KeyExportEngine->KeyId, sess->KeyExportEngine->SignMessages);
         SuccessOrExit(err);
 
         break;
@@ -2204,18 +2455,18 @@ void WeaveSecurityManager::HandleKeyExportMessageInitiator(ExchangeContext *ec,
         uint16_t exportedKeyLen;
         uint8_t exportedKey[kWeaveFabricSecretSize];
 
-        err = secMgr->mKeyExport->ProcessKeyExportResponse(msgBuf->Start(), msgBuf->DataLength(), pktInfo, msgInfo,
+        err = sess->KeyExportEngine->ProcessKeyExportResponse(msgBuf->Start(), msgBuf->DataLength(), pktInfo, msgInfo,
                                                            exportedKey, sizeof(exportedKey), exportedKeyLen, exportedKeyId);
         SuccessOrExit(err);
 
         // Call the user's completion function.
-        if (secMgr->mStartKeyExport_OnComplete != NULL)
+        if (sess->StartKeyExport_OnComplete != NULL)
         {
-            secMgr->mStartKeyExport_OnComplete(secMgr, secMgr->mCon, secMgr->mStartKeyExport_ReqState, exportedKeyId, exportedKey, exportedKeyLen);
+            sess->StartKeyExport_OnComplete(secMgr, sess->Con, sess->StartKeyExport_ReqState, exportedKeyId, exportedKey, exportedKeyLen);
         }
 
         // Reset state.
-        secMgr->Reset();
+        secMgr->Reset(sess);
 
         break;
 
@@ -2227,13 +2478,13 @@ void WeaveSecurityManager::HandleKeyExportMessageInitiator(ExchangeContext *ec,
 
 exit:
     if (err != WEAVE_NO_ERROR)
-        secMgr->HandleKeyExportError(err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
+        secMgr->HandleKeyExportError(sess, err, (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED) ? msgBuf : NULL);
 
     if (msgBuf != NULL)
         PacketBuffer::Free(msgBuf);
 }
 
-void WeaveSecurityManager::HandleKeyExportError(WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf)
+void WeaveSecurityManager::HandleKeyExportError(SessionContext *sess, WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf)
 {
     // If session establishment in progress...
     //
@@ -2244,11 +2495,11 @@ void WeaveSecurityManager::HandleKeyExportError(WEAVE_ERROR err, PacketBuffer *s
     // Then when SendMessage() returns, the function that called it will also call this
     // function with the error returned by SendMessage().
     //
-    if (State != kState_Idle)
+    if (sess->State != kState_Idle)
     {
-        WeaveConnection *con = mCon;
-        KeyExportErrorFunct userOnError = mStartKeyExport_OnError;
-        void *reqState = mStartKeyExport_ReqState;
+        WeaveConnection *con = sess->Con;
+        KeyExportErrorFunct userOnError = sess->StartKeyExport_OnError;
+        void *reqState = sess->StartKeyExport_ReqState;
         StatusReport rcvdStatusReport;
         StatusReport *statusReportPtr = NULL;
 
@@ -2264,7 +2515,7 @@ void WeaveSecurityManager::HandleKeyExportError(WEAVE_ERROR err, PacketBuffer *s
         }
 
         // Reset state.
-        Reset();
+        Reset(sess);
 
         // Call the user's error handler.
         if (userOnError != NULL)
@@ -2273,7 +2524,7 @@ void WeaveSecurityManager::HandleKeyExportError(WEAVE_ERROR err, PacketBuffer *s
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendKeyExportRequest(uint8_t keyExportConfig, uint32_t keyId, bool signMessage)
+WEAVE_ERROR WeaveSecurityManager::SendKeyExportRequest(SessionContext *sess, uint8_t keyExportConfig, uint32_t keyId, bool signMessage)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     PacketBuffer *msgBuf = NULL;
@@ -2285,21 +2536,21 @@ WEAVE_ERROR WeaveSecurityManager::SendKeyExportRequest(uint8_t keyExportConfig,
     VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
     // Generate key export request.
-    err = mKeyExport->GenerateKeyExportRequest(msgBuf->Start(), msgBuf->AvailableDataLength(), dataLen, keyExportConfig, keyId, signMessage);
+    err = sess->KeyExportEngine->GenerateKeyExportRequest(msgBuf->Start(), msgBuf->AvailableDataLength(), dataLen, keyExportConfig, keyId, signMessage);
     SuccessOrExit(err);
 
     // Set message length.
     msgBuf->SetDataLength(dataLen);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    if (mCon == NULL)
+    if (sess->Con == NULL)
     {
         sendFlags = ExchangeContext::kSendFlag_RequestAck;
     }
 #endif
 
     // Send key export request message.
-    err = mEC->SendMessage(kWeaveProfile_Security, kMsgType_KeyExportRequest, msgBuf, sendFlags);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, kMsgType_KeyExportRequest, msgBuf, sendFlags);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -2314,36 +2565,40 @@ exit:
 
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_RESPONDER
 
-void WeaveSecurityManager::HandleKeyExportRequest(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
+void WeaveSecurityManager::HandleKeyExportRequest(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
 {
     WEAVE_ERROR err;
     WeaveKeyExport keyExport;
 
-    State = kState_KeyExportInProgress;
-    mEC = ec;
-    mCon = ec->Con;
+    sess->EC = ec;
+    sess->Con = ec->Con;
+    ec->AppState = sess;
 
     // Ensure the exchange context stays around until we're done with it.
     ec->AddRef();
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    if (mCon == NULL)
+    if (sess->Con == NULL)
     {
         // Do nothing on the Ack received from the requestor.
-        // mEC->OnAckRcvd is not initialized.
+        // sess->EC->OnAckRcvd is not initialized.
         // Do nothing on the message send error.
-        // mEC->OnSendError is not initialized.
+        // sess->EC->OnSendError is not initialized.
 
         // Flush any pending WRM ACKs before we begin the long crypto operation,
         // to prevent the peer from re-transmitting the Key Export request.
-        err = mEC->WRMPFlushAcks();
+        err = sess->EC->WRMPFlushAcks();
         SuccessOrExit(err);
     }
 #endif
 
-    // Initialize Weave Platform Memory.
-    err = Platform::Security::MemoryInit();
-    SuccessOrExit(err);
+    // Initialize Weave platform memory when the first interaction starts; interactions
+    // already in progress are using it.
+    if (mActiveSessionCount == 1)
+    {
+        err = Platform::Security::MemoryInit();
+        SuccessOrExit(err);
+    }
 
     // Prepare key export engine.
     keyExport.Init(mDefaultKeyExportDelegate, FabricState->GroupKeyStore);
@@ -2361,11 +2616,11 @@ void WeaveSecurityManager::HandleKeyExportRequest(ExchangeContext *ec, const IPP
     // Check if reconfiguration was requested.
     if (err == WEAVE_ERROR_KEY_EXPORT_RECONFIGURE_REQUIRED)
     {
-        err = SendKeyExportResponse(keyExport, kMsgType_KeyExportReconfigure);
+        err = SendKeyExportResponse(sess, keyExport, kMsgType_KeyExportReconfigure);
     }
     else if (err == WEAVE_NO_ERROR)
     {
-        err = SendKeyExportResponse(keyExport, kMsgType_KeyExportResponse);
+        err = SendKeyExportResponse(sess, keyExport, kMsgType_KeyExportResponse);
     }
     SuccessOrExit(err);
 
@@ -2381,11 +2636,11 @@ exit:
     keyExport.Shutdown();
 
     // Reset state.
-    Reset();
+    Reset(sess);
 }
 
 __attribute__((noinline))
-WEAVE_ERROR WeaveSecurityManager::SendKeyExportResponse(WeaveKeyExport& keyExport, uint8_t msgType)
+WEAVE_ERROR WeaveSecurityManager::SendKeyExportResponse(SessionContext *sess, WeaveKeyExport& keyExport, uint8_t msgType)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     PacketBuffer *msgBuf = NULL;
@@ -2409,14 +2664,14 @@ WEAVE_ERROR WeaveSecurityManager::SendKeyExportResponse(WeaveKeyExport& keyExpor
     msgBuf->SetDataLength(dataLen);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    if (mCon == NULL)
+    if (sess->Con == NULL)
     {
         sendFlags = ExchangeContext::kSendFlag_RequestAck;
     }
 #endif
 
     // Send key export response message.
-    err = mEC->SendMessage(kWeaveProfile_Security, msgType, msgBuf, sendFlags);
+    err = sess->EC->SendMessage(kWeaveProfile_Security, msgType, msgBuf, sendFlags);
     msgBuf = NULL;
     SuccessOrExit(err);
 
@@ -2654,32 +2909,32 @@ exit:
     return;
 }
 
-WEAVE_ERROR WeaveSecurityManager::NewSessionExchange(uint64_t peerNodeId, IPAddress peerAddr, uint16_t peerPort)
+WEAVE_ERROR WeaveSecurityManager::NewSessionExchange(SessionContext *sess, uint64_t peerNodeId, IPAddress peerAddr, uint16_t peerPort)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    if (mEC != NULL)
+    if (sess->EC != NULL)
     {
-        mEC->Close();
-        mEC = NULL;
+        sess->EC->Close();
+        sess->EC = NULL;
     }
 
     // Create a new exchange context.
-    if (mCon)
+    if (sess->Con)
     {
-        mEC = ExchangeManager->NewContext(mCon, this);
-        VerifyOrExit(mEC != NULL, err = WEAVE_ERROR_NO_MEMORY);
+        sess->EC = ExchangeManager->NewContext(sess->Con, sess);
+        VerifyOrExit(sess->EC != NULL, err = WEAVE_ERROR_NO_MEMORY);
     }
     else
     {
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
         VerifyOrExit(peerNodeId != kNodeIdNotSpecified && peerNodeId != kAnyNodeId, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-        mEC = ExchangeManager->NewContext(peerNodeId, peerAddr, peerPort, INET_NULL_INTERFACEID, this);
-        VerifyOrExit(mEC != NULL, err = WEAVE_ERROR_NO_MEMORY);
+        sess->EC = ExchangeManager->NewContext(peerNodeId, peerAddr, peerPort, INET_NULL_INTERFACEID, sess);
+        VerifyOrExit(sess->EC != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-        mEC->OnAckRcvd = WRMPHandleAckRcvd;
-        mEC->OnSendError = WRMPHandleSendError;
+        sess->EC->OnAckRcvd = WRMPHandleAckRcvd;
+        sess->EC->OnSendError = WRMPHandleSendError;
 #else
         // Reject the request if no connection has been specified.
         ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
@@ -2830,22 +3085,22 @@ exit:
 
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 
-WEAVE_ERROR WeaveSecurityManager::HandleSessionEstablished(void)
+WEAVE_ERROR WeaveSecurityManager::HandleSessionEstablished(SessionContext *sess)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    uint64_t peerNodeId = mEC->PeerNodeId;
-    uint16_t sessionKeyId = mSessionKeyId;
-    uint8_t encType = mEncType;
+    uint64_t peerNodeId = sess->EC->PeerNodeId;
+    uint16_t sessionKeyId = sess->SessionKeyId;
+    uint8_t encType = sess->EncType;
     const WeaveEncryptionKey *sessionKey;
     WeaveAuthMode authMode;
 
-    switch (State)
+    switch (sess->State)
     {
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
     case kState_CASEInProgress:
 
         // Get the derived session key.
-        err = mCASEEngine->GetSessionKey(sessionKey);
+        err = sess->CASEEngine->GetSessionKey(sessionKey);
         SuccessOrExit(err);
 
         // Form the key auth mode based on the type of certificate that was used by the peer.
@@ -2854,7 +3109,7 @@ WEAVE_ERROR WeaveSecurityManager::HandleSessionEstablished(void)
         // was requested by the application.  For example, if the app requested kWeaveAuthMode_CASE_AnyCert
         // then the final key auth mode will reflect the actual certificate type used by the peer.
         //
-        authMode = CASEAuthMode(mCASEEngine->CertType());
+        authMode = CASEAuthMode(sess->CASEEngine->CertType());
 
         break;
 #endif
@@ -2863,11 +3118,11 @@ WEAVE_ERROR WeaveSecurityManager::HandleSessionEstablished(void)
     case kState_PASEInProgress:
 
         // Get the derived session key.
-        err = mPASEEngine->GetSessionKey(sessionKey);
+        err = sess->PASEEngine->GetSessionKey(sessionKey);
         SuccessOrExit(err);
 
         // Form the key auth mode based on the password source.
-        authMode = PASEAuthMode(mPASEEngine->PwSource);
+        authMode = PASEAuthMode(sess->PASEEngine->PwSource);
 
         break;
 #endif
@@ -2876,7 +3131,7 @@ WEAVE_ERROR WeaveSecurityManager::HandleSessionEstablished(void)
     case kState_TAKEInProgress:
 
         // Get the derived session key.
-        err = mTAKEEngine->GetSessionKey(sessionKey);
+        err = sess->TAKEEngine->GetSessionKey(sessionKey);
         SuccessOrExit(err);
 
         // Currently only one key auth mode is supported for TAKE.
@@ -2897,17 +3152,17 @@ exit:
     return err;
 }
 
-void WeaveSecurityManager::HandleSessionComplete(void)
+void WeaveSecurityManager::HandleSessionComplete(SessionContext *sess)
 {
-    WeaveConnection *con = mCon;
-    uint64_t peerNodeId = mEC->PeerNodeId;
-    uint16_t sessionKeyId = mSessionKeyId;
-    uint8_t encType = mEncType;
-    SessionEstablishedFunct userOnComplete = mStartSecureSession_OnComplete;
-    void *reqState = mStartSecureSession_ReqState;
+    WeaveConnection *con = sess->Con;
+    uint64_t peerNodeId = sess->EC->PeerNodeId;
+    uint16_t sessionKeyId = sess->SessionKeyId;
+    uint8_t encType = sess->EncType;
+    SessionEstablishedFunct userOnComplete = sess->StartSecureSession_OnComplete;
+    void *reqState = sess->StartSecureSession_ReqState;
 
     // Reset state.
-    Reset();
+    Reset(sess);
 
     // Call the general session established handler.
     if (OnSessionEstablished != NULL)
@@ -2936,8 +3191,17 @@ void WeaveSecurityManager::HandleSessionComplete(void)
     AsyncNotifySecurityManagerAvailable();
 }
 
-void WeaveSecurityManager::HandleSessionError(WEAVE_ERROR err, PacketBuffer* statusReportMsgBuf)
+void WeaveSecurityManager::HandleSessionError(SessionContext *sess, WEAVE_ERROR err, PacketBuffer* statusReportMsgBuf)
 {
+    // If a worker thread is still operating on the session, hold on to the first error until
+    // the job completes.  The job's completion handler then reports it.
+    if (sess->CryptoJobPending)
+    {
+        if (sess->DeferredError == WEAVE_NO_ERROR)
+            sess->DeferredError = err;
+        return;
+    }
+
     // If session establishment in progress...
     //
     // NOTE: This check is necessary because it is possible for HandleSessionError() to be
@@ -2947,36 +3211,40 @@ void WeaveSecurityManager::HandleSessionError(WEAVE_ERROR err, PacketBuffer* sta
     // Then when SendMessage() returns, the function that called it will also call this
     // function with the error returned by SendMessage().
     //
-    if (State != kState_Idle)
+    if (sess->State != kState_Idle)
     {
-        WeaveConnection *con = mCon;
-        uint64_t peerNodeId = mEC->PeerNodeId;
-        uint16_t sessionKeyId = mSessionKeyId;
-        SessionErrorFunct userOnError = mStartSecureSession_OnError;
-        void *reqState = mStartSecureSession_ReqState;
+        WeaveConnection *con = sess->Con;
+        uint64_t peerNodeId = sess->EC->PeerNodeId;
+        uint16_t sessionKeyId = sess->SessionKeyId;
+        SessionErrorFunct userOnError = sess->StartSecureSession_OnError;
+        void *reqState = sess->StartSecureSession_ReqState;
         StatusReport rcvdStatusReport;
         StatusReport *statusReportPtr = NULL;
 
         // If a status report was received from the peer, parse it and arrange to pass it
-        // to the callbacks.
+        // to the callbacks.  (A report that arrived while a crypto job was pending is not
+        // retained, in which case only the error is passed on.)
         if (err == WEAVE_ERROR_STATUS_REPORT_RECEIVED)
         {
-            WEAVE_ERROR parseErr = StatusReport::parse(statusReportMsgBuf, rcvdStatusReport);
-            if (parseErr == WEAVE_NO_ERROR)
-                statusReportPtr = &rcvdStatusReport;
-            else
-                err = parseErr;
+            if (statusReportMsgBuf != NULL)
+            {
+                WEAVE_ERROR parseErr = StatusReport::parse(statusReportMsgBuf, rcvdStatusReport);
+                if (parseErr == WEAVE_NO_ERROR)
+                    statusReportPtr = &rcvdStatusReport;
+                else
+                    err = parseErr;
+            }
         }
 
         // Otherwise, send a status report to the peer with our reason for the failure.
         else
-            SendStatusReport(err, mEC);
+            SendStatusReport(err, sess->EC);
 
         // Remove the session key from the key table.
         FabricState->RemoveSessionKey(sessionKeyId, peerNodeId);
 
         // Reset state.
-        Reset();
+        Reset(sess);
 
         // Call the general session error handler.
         if (OnSessionError != NULL)
@@ -2994,18 +3262,19 @@ void WeaveSecurityManager::HandleSessionError(WEAVE_ERROR err, PacketBuffer* sta
 
 void WeaveSecurityManager::HandleConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr)
 {
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
     if (conErr == WEAVE_NO_ERROR)
         conErr = WEAVE_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY;
 
     // Clean-up the local state and invoke the appropriate callbacks.
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
-    if (secMgr->State == kState_KeyExportInProgress)
-        secMgr->HandleKeyExportError(conErr, NULL);
+    if (sess->State == kState_KeyExportInProgress)
+        secMgr->HandleKeyExportError(sess, conErr, NULL);
     else
 #endif
-        secMgr->HandleSessionError(conErr, NULL);
+        secMgr->HandleSessionError(sess, conErr, NULL);
 }
 
 WEAVE_ERROR WeaveSecurityManager::SendStatusReport(WEAVE_ERROR localErr, ExchangeContext *ec)
@@ -3128,53 +3397,56 @@ exit:
     return err;
 }
 
-void WeaveSecurityManager::Reset(void)
+void WeaveSecurityManager::Reset(SessionContext *sess)
 {
-    if (mEC != NULL)
+    if (sess->IsFree())
+        return;
+
+    if (sess->EC != NULL)
     {
-        mEC->Abort();
-        mEC = NULL;
+        sess->EC->Abort();
+        sess->EC = NULL;
     }
 
-    switch (State)
+    switch (sess->State)
     {
 #if WEAVE_CONFIG_ENABLE_PASE_INITIATOR || WEAVE_CONFIG_ENABLE_PASE_RESPONDER
     case kState_PASEInProgress:
-        if (mPASEEngine != NULL)
+        if (sess->PASEEngine != NULL)
         {
-            mPASEEngine->Shutdown();
-            Platform::Security::MemoryFree(mPASEEngine);
-            mPASEEngine = NULL;
+            sess->PASEEngine->Shutdown();
+            Platform::Security::MemoryFree(sess->PASEEngine);
+            sess->PASEEngine = NULL;
         }
         break;
 #endif
 #if WEAVE_CONFIG_ENABLE_TAKE_INITIATOR || WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
     case kState_TAKEInProgress:
-        if (mTAKEEngine != NULL)
+        if (sess->TAKEEngine != NULL)
         {
-            mTAKEEngine->Shutdown();
-            Platform::Security::MemoryFree(mTAKEEngine);
-            mTAKEEngine = NULL;
+            sess->TAKEEngine->Shutdown();
+            Platform::Security::MemoryFree(sess->TAKEEngine);
+            sess->TAKEEngine = NULL;
         }
         break;
 #endif
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
     case kState_CASEInProgress:
-        if (mCASEEngine != NULL)
+        if (sess->CASEEngine != NULL)
         {
-            mCASEEngine->Shutdown();
-            Platform::Security::MemoryFree(mCASEEngine);
-            mCASEEngine = NULL;
+            sess->CASEEngine->Shutdown();
+            Platform::Security::MemoryFree(sess->CASEEngine);
+            sess->CASEEngine = NULL;
         }
         break;
 #endif
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
     case kState_KeyExportInProgress:
-        if (mKeyExport != NULL)
+        if (sess->KeyExportEngine != NULL)
         {
-            mKeyExport->Shutdown();
-            Platform::Security::MemoryFree(mKeyExport);
-            mKeyExport = NULL;
+            sess->KeyExportEngine->Shutdown();
+            Platform::Security::MemoryFree(sess->KeyExportEngine);
+            sess->KeyExportEngine = NULL;
         }
         break;
 #endif
@@ -3182,44 +3454,191 @@ void WeaveSecurityManager::Reset(void)
         break;
     }
 
-    Platform::Security::MemoryShutdown();
+    CancelSessionTimer(sess);
+
+    if (sess->JobMsgBuf != NULL)
+    {
+        PacketBuffer::Free(sess->JobMsgBuf);
+        sess->JobMsgBuf = NULL;
+    }
+    if (sess->JobRespMsgBuf != NULL)
+    {
+        PacketBuffer::Free(sess->JobRespMsgBuf);
+        sess->JobRespMsgBuf = NULL;
+    }
+    if (sess->HeldMsgBuf != NULL)
+    {
+        PacketBuffer::Free(sess->HeldMsgBuf);
+        sess->HeldMsgBuf = NULL;
+    }
+    sess->CryptoJobPending = false;
+    sess->DeferredError = WEAVE_NO_ERROR;
+
+    sess->State = kState_Idle;
+    sess->PeerNodeId = kNodeIdNotSpecified;
+    sess->Con = NULL;
+    sess->RequestedAuthMode = kWeaveAuthMode_NotSpecified;
+    sess->SessionKeyId = WeaveKeyId::kNone;
+    sess->EncType = kWeaveEncryptionType_None;
+    sess->StartSecureSession_OnComplete = NULL;
+    sess->StartSecureSession_OnError = NULL;
+    sess->StartSecureSession_ReqState = NULL;
+
+    // Release security platform memory once the last in-progress interaction has finished.
+    mActiveSessionCount--;
+    if (mActiveSessionCount == 0)
+        Platform::Security::MemoryShutdown();
+
+    UpdateState();
+}
+
+WeaveSecurityManager::SessionContext *WeaveSecurityManager::AllocSession(uint64_t peerNodeId, uint8_t state)
+{
+    SessionContext *sess = NULL;
+    uint8_t peerSessionCount = 0;
+
+    // Find a free session context and count the interactions already in progress with the peer.
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        if (mSessions[i].IsFree())
+        {
+            if (sess == NULL)
+                sess = &mSessions[i];
+        }
+        else if (mSessions[i].PeerNodeId == peerNodeId)
+            peerSessionCount++;
+    }
+
+    // Refuse the request if the pool is exhausted or the peer already has its share of it.
+    VerifyOrExit(sess != NULL && peerSessionCount < WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER, sess = NULL);
+
+    sess->State = state;
+    sess->PeerNodeId = peerNodeId;
+    mActiveSessionCount++;
+
+    State = state;
+
+exit:
+    return sess;
+}
+
+bool WeaveSecurityManager::IsSessionKeyInProgress(uint64_t peerNodeId, uint16_t sessionKeyId) const
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        const SessionContext *sess = &mSessions[i];
+
+        if (sess->State == kState_CASEInProgress && sess->PeerNodeId == peerNodeId && sess->SessionKeyId == sessionKeyId)
+            return true;
+    }
 
-    CancelSessionTimer();
+    return false;
+}
 
+void WeaveSecurityManager::UpdateState(void)
+{
+    // The public State reflects the first in-progress interaction, or Idle if there are none.
     State = kState_Idle;
-    mCon = NULL;
-    mRequestedAuthMode = kWeaveAuthMode_NotSpecified;
-    mSessionKeyId = WeaveKeyId::kNone;
-    mEncType = kWeaveEncryptionType_None;
-    mStartSecureSession_OnComplete = NULL;
-    mStartSecureSession_OnError = NULL;
-    mStartSecureSession_ReqState = NULL;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        if (!mSessions[i].IsFree())
+        {
+            State = mSessions[i].State;
+            break;
+        }
+    }
+}
+
+WEAVE_ERROR WeaveSecurityManager::StartCryptoJob(SessionContext *sess, CryptoJob::RunFunct run, CryptoJob::CompleteFunct onComplete)
+{
+    WEAVE_ERROR err;
+
+    sess->Job.Run = run;
+    sess->Job.OnComplete = onComplete;
+    sess->Job.AppState = sess;
+    sess->DeferredError = WEAVE_NO_ERROR;
+    sess->CryptoJobPending = true;
+
+    StartTimeConsumingCrypto();
+
+    // NOTE: With no crypto workers configured, the job and its completion handler run before
+    // Submit() returns, and may release the session.
+    err = mCryptoWorkers.Submit(&sess->Job);
+    if (err != WEAVE_NO_ERROR)
+    {
+        sess->CryptoJobPending = false;
+        EndTimeConsumingCrypto();
+    }
+
+    return err;
+}
+
+void WeaveSecurityManager::EndCryptoJob(SessionContext *sess, WEAVE_ERROR &err)
+{
+    sess->CryptoJobPending = false;
+
+    EndTimeConsumingCrypto();
+
+    // An error raised against the session while the job was running (e.g. a timeout, a closed
+    // connection or a status report from the peer) takes precedence over the job's result.
+    if (sess->DeferredError != WEAVE_NO_ERROR)
+    {
+        err = sess->DeferredError;
+        sess->DeferredError = WEAVE_NO_ERROR;
+    }
+}
+
+/**
+ * Mark the start of a time-consuming cryptographic operation, alerting the platform if no other
+ * operation is already in progress.  Must be called on the Weave thread, including for operations
+ * that then run on a crypto worker, so that the alerts are never raised concurrently.
+ */
+void WeaveSecurityManager::StartTimeConsumingCrypto(void)
+{
+    if (mTimeConsumingCryptoCount++ == 0)
+        Platform::Security::OnTimeConsumingCryptoStart();
+}
+
+/**
+ * Mark the end of a time-consuming cryptographic operation, alerting the platform if it was the
+ * last one in progress.
+ */
+void WeaveSecurityManager::EndTimeConsumingCrypto(void)
+{
+    if (--mTimeConsumingCryptoCount == 0)
+        Platform::Security::OnTimeConsumingCryptoDone();
 }
 
-void WeaveSecurityManager::StartSessionTimer(void)
+void WeaveSecurityManager::StartSessionTimer(SessionContext *sess)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
 
     if (SessionEstablishTimeout != 0)
     {
-        mSystemLayer->StartTimer(SessionEstablishTimeout, HandleSessionTimeout, this);
+        mSystemLayer->StartTimer(SessionEstablishTimeout, HandleSessionTimeout, sess);
     }
 }
 
-void WeaveSecurityManager::CancelSessionTimer(void)
+void WeaveSecurityManager::CancelSessionTimer(SessionContext *sess)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
-    mSystemLayer->CancelTimer(HandleSessionTimeout, this);
+    mSystemLayer->CancelTimer(HandleSessionTimeout, sess);
 }
 
 void WeaveSecurityManager::HandleSessionTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
 
-    WeaveSecurityManager* securityMgr = reinterpret_cast<WeaveSecurityManager*>(aAppState);
-    if (securityMgr)
+    SessionContext* sess = reinterpret_cast<SessionContext*>(aAppState);
+    if (sess)
     {
-        securityMgr->HandleSessionError(WEAVE_ERROR_TIMEOUT, NULL);
+#if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
+        if (sess->State == kState_KeyExportInProgress)
+            sess->SecMgr->HandleKeyExportError(sess, WEAVE_ERROR_TIMEOUT, NULL);
+        else
+#endif
+            sess->SecMgr->HandleSessionError(sess, WEAVE_ERROR_TIMEOUT, NULL);
     }
 }
 
@@ -3267,13 +3686,20 @@ void WeaveSecurityManager::OnEncryptedMsgRcvd(uint16_t sessionKeyId, uint64_t pe
     // is received before the Ack for the last message on the session establishment exchange.
     // In that case there is no need to wait for the Ack and the session can be completed.
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
-    if (State == kState_CASEInProgress &&
-        mCASEEngine->State == WeaveCASEEngine::kState_Complete &&
-        mSessionKeyId == sessionKeyId &&
-        mEC->PeerNodeId == peerNodeId &&
-        mEncType == encType)
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
     {
-        HandleSessionComplete();
+        SessionContext *sess = &mSessions[i];
+
+        if (sess->State == kState_CASEInProgress &&
+            !sess->CryptoJobPending &&
+            sess->CASEEngine->State == WeaveCASEEngine::kState_Complete &&
+            sess->SessionKeyId == sessionKeyId &&
+            sess->EC->PeerNodeId == peerNodeId &&
+            sess->EncType == encType)
+        {
+            HandleSessionComplete(sess);
+            break;
+        }
     }
 #endif
 }
@@ -3283,29 +3709,32 @@ void WeaveSecurityManager::OnEncryptedMsgRcvd(uint16_t sessionKeyId, uint64_t pe
 void WeaveSecurityManager::WRMPHandleAckRcvd(ExchangeContext *ec, void *msgCtxt)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
-    if (secMgr->State == kState_CASEInProgress &&
-        secMgr->mCASEEngine->State == WeaveCASEEngine::kState_Complete)
+    if (sess->State == kState_CASEInProgress &&
+        !sess->CryptoJobPending &&
+        sess->CASEEngine->State == WeaveCASEEngine::kState_Complete)
     {
-        secMgr->HandleSessionComplete();
+        secMgr->HandleSessionComplete(sess);
     }
 }
 
 void WeaveSecurityManager::WRMPHandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
-    WeaveSecurityManager *secMgr = (WeaveSecurityManager *)ec->AppState;
+    SessionContext *sess = (SessionContext *)ec->AppState;
+    WeaveSecurityManager *secMgr = sess->SecMgr;
 
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
-    if (secMgr->State == kState_KeyExportInProgress)
+    if (sess->State == kState_KeyExportInProgress)
     {
-        secMgr->HandleKeyExportError(err, NULL);
+        secMgr->HandleKeyExportError(sess, err, NULL);
     }
     else
 #endif
     {
-        secMgr->HandleSessionError(err, NULL);
+        secMgr->HandleSessionError(sess, err, NULL);
     }
 }
 
@@ -3319,7 +3748,7 @@ void WeaveSecurityManager::AsyncNotifySecurityManagerAvailable()
 void WeaveSecurityManager::DoNotifySecurityManagerAvailable(System::Layer *systemLayer, void *appState, System::Error err)
 {
     WeaveSecurityManager *_this = (WeaveSecurityManager *)appState;
-    if (_this->State == kState_Idle)
+    if (_this->mActiveSessionCount < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS)
     {
         _this->ExchangeManager->NotifySecurityManagerAvailable();
     }
@@ -3333,30 +3762,32 @@ void WeaveSecurityManager::DoNotifySecurityManagerAvailable(System::Layer *syste
  *
  * @retval #WEAVE_NO_ERROR      If a matching in-progress session establishment was found and canceled.
  *
- * @retval #WEAVE_ERROR_INCORRECT_STATE   If there was no session establishment in progress, or the
- *                              in-progress session did not match the supplied request state pointer.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE   If there was no session establishment in progress that
+ *                              matched the supplied request state pointer.
  */
 WEAVE_ERROR WeaveSecurityManager::CancelSessionEstablishment(void *reqState)
 {
-    // If a session establishment is in progress and the supplied request state matches what was provided
-    // when the session was started...
-    if ((State == kState_CASEInProgress || State == kState_PASEInProgress || State == kState_TAKEInProgress) &&
-        reqState == mStartSecureSession_ReqState)
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
     {
-        // Clear the application's OnError handler to prevent a callback.
-        mStartSecureSession_OnError = NULL;
+        SessionContext *sess = &mSessions[i];
+
+        // If a session establishment is in progress and the supplied request state matches what was provided
+        // when the session was started...
+        if ((sess->State == kState_CASEInProgress || sess->State == kState_PASEInProgress || sess->State == kState_TAKEInProgress) &&
+            reqState == sess->StartSecureSession_ReqState)
+        {
+            // Clear the application's OnError handler to prevent a callback.
+            sess->StartSecureSession_OnError = NULL;
 
-        // Fail the session with a canceled error.
-        HandleSessionError(WEAVE_ERROR_TRANSACTION_CANCELED, NULL);
+            // Fail the session with a canceled error.
+            HandleSessionError(sess, WEAVE_ERROR_TRANSACTION_CANCELED, NULL);
 
-        return WEAVE_NO_ERROR;
+            return WEAVE_NO_ERROR;
+        }
     }
 
     // Otherwise, tell the caller there was no match.
-    else
-    {
-        return WEAVE_ERROR_INCORRECT_STATE;
-    }
+    return WEAVE_ERROR_INCORRECT_STATE;
 }
 
 /**
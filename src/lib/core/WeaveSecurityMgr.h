@@ -27,6 +27,7 @@
 // This allows WeaveCore.h to enforce a canonical include order for core
 // header files, making it easier to manage dependencies between these files.
 #include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveCryptoWorkerPool.h>
 
 #ifndef WEAVESECURITYMANAGER_H_
 #define WEAVESECURITYMANAGER_H_
@@ -145,6 +146,10 @@ extern void MemoryFree(void *p);
  * This function is called to notify the application when a time-consuming
  * cryptographic operation is about to start.
  *
+ * Both alerts are called on the Weave event thread.  When several operations
+ * overlap, which can happen with #WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS,
+ * they are reported as a single period of time-consuming activity.
+ *
  * @note If application wants to receive these alerts and adjust platform settings
  *       accordingly then it should provide its own implementation of these functions
  *       and enable (1) #WEAVE_CONFIG_SECURITY_MGR_TIME_ALERTS_PLATFORM option.
@@ -154,7 +159,8 @@ extern void OnTimeConsumingCryptoStart(void);
 
 /**
  * This function is called to notify the application when a time-consuming
- * cryptographic operation has just finished.
+ * cryptographic operation has just finished.  When operations overlap, this
+ * is only called once the last of them has finished.
  *
  * @note If application wants to receive these alerts and adjust platform settings
  *       accordingly then it should provide its own implementation of these functions
@@ -363,48 +369,87 @@ private:
         kFlag_IdleSessionTimerRunning   = 0x01
     };
 
-    ExchangeContext *mEC;
-    WeaveConnection *mCon;
-    union
+    /**
+     * State for a single in-progress session establishment or key export interaction.
+     *
+     * Each context owns its own exchange, protocol engine and establishment timer, and
+     * is referenced by the exchange's AppState, allowing several interactions to proceed
+     * concurrently.  A context is free when its State is kState_Idle.
+     */
+    class SessionContext
     {
+    public:
+        WeaveSecurityManager *SecMgr;
+        ExchangeContext *EC;
+        WeaveConnection *Con;
+        union
+        {
 #if WEAVE_CONFIG_ENABLE_PASE_INITIATOR || WEAVE_CONFIG_ENABLE_PASE_RESPONDER
-        WeavePASEEngine *mPASEEngine;
+            WeavePASEEngine *PASEEngine;
 #endif
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
-        WeaveCASEEngine *mCASEEngine;
+            WeaveCASEEngine *CASEEngine;
 #endif
 #if WEAVE_CONFIG_ENABLE_TAKE_INITIATOR || WEAVE_CONFIG_ENABLE_TAKE_RESPONDER
-        WeaveTAKEEngine *mTAKEEngine;
+            WeaveTAKEEngine *TAKEEngine;
 #endif
 #if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
-        WeaveKeyExport *mKeyExport;
+            WeaveKeyExport *KeyExportEngine;
+#endif
+        };
+        union
+        {
+            SessionEstablishedFunct StartSecureSession_OnComplete;
+
+            /**
+             * The key export protocol complete callback function. This function is
+             * called when the secret key export process is complete.
+             */
+            KeyExportCompleteFunct StartKeyExport_OnComplete;
+        };
+        union
+        {
+            SessionErrorFunct StartSecureSession_OnError;
+
+            /**
+             * The key export protocol error callback function. This function is
+             * called when an error is encountered during key export process.
+             */
+            KeyExportErrorFunct StartKeyExport_OnError;
+        };
+        union
+        {
+            void *StartSecureSession_ReqState;
+            void *StartKeyExport_ReqState;
+        };
+        // Inputs and outputs of a CASE or PASE crypto job, which must outlive the message handler
+        // that submitted it, and a peer message held back until the job completes.
+        CryptoJob                                               Job;
+        PacketBuffer                                            *JobMsgBuf;
+        PacketBuffer                                            *JobRespMsgBuf;
+        PacketBuffer                                            *HeldMsgBuf;
+#if WEAVE_CONFIG_ENABLE_PASE_INITIATOR
+        uint32_t                                                PASEConfig;
 #endif
+#if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
+        Profiles::Security::CASE::BeginSessionRequestMessage    CASEBeginReq;
+        Profiles::Security::CASE::BeginSessionResponseMessage   CASEBeginResp;
+        Profiles::Security::CASE::ReconfigureMessage            CASEReconf;
+#endif
+        uint64_t        PeerNodeId;
+        WEAVE_ERROR     DeferredError;
+        uint16_t        SessionKeyId;
+        WeaveAuthMode   RequestedAuthMode;
+        uint8_t         EncType;
+        uint8_t         State;
+        bool            CryptoJobPending;
+
+        bool IsFree(void) const { return State == kState_Idle; }
     };
-    union
-    {
-        SessionEstablishedFunct mStartSecureSession_OnComplete;
 
-        /**
-         * The key export protocol complete callback function. This function is
-         * called when the secret key export process is complete.
-         */
-        KeyExportCompleteFunct mStartKeyExport_OnComplete;
-    };
-    union
-    {
-        SessionErrorFunct mStartSecureSession_OnError;
+    SessionContext  mSessions[WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS];
+    uint8_t         mActiveSessionCount;
 
-        /**
-         * The key export protocol error callback function. This function is
-         * called when an error is encountered during key export process.
-         */
-        KeyExportErrorFunct mStartKeyExport_OnError;
-    };
-    union
-    {
-        void *mStartSecureSession_ReqState;
-        void *mStartKeyExport_ReqState;
-    };
 #if WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER
     WeaveCASEAuthDelegate *mDefaultAuthDelegate;
 #endif
@@ -418,14 +463,18 @@ private:
     WeaveKeyExportDelegate *mDefaultKeyExportDelegate;
 #endif
 
-    uint16_t        mSessionKeyId;
-    WeaveAuthMode   mRequestedAuthMode;
-    uint8_t         mEncType;
+    CryptoWorkerPool mCryptoWorkers;
+    uint8_t         mTimeConsumingCryptoCount;
+
     System::Layer*  mSystemLayer;
     uint8_t         mFlags;
 
-    void StartSessionTimer(void);
-    void CancelSessionTimer(void);
+    SessionContext *AllocSession(uint64_t peerNodeId, uint8_t state);
+    bool IsSessionKeyInProgress(uint64_t peerNodeId, uint16_t sessionKeyId) const;
+    void UpdateState(void);
+
+    void StartSessionTimer(SessionContext *sess);
+    void CancelSessionTimer(SessionContext *sess);
     static void HandleSessionTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
 
     void StartIdleSessionTimer(void);
@@ -435,81 +484,98 @@ private:
     static void HandleUnsolicitedMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
 
-    void StartPASESession(void);
-    void HandlePASESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
-    WEAVE_ERROR ProcessPASEInitiatorStep1(ExchangeContext *ec, PacketBuffer *msgBuf);
-    WEAVE_ERROR SendPASEResponderReconfigure(void);
-    WEAVE_ERROR SendPASEResponderStep1(void);
-    WEAVE_ERROR SendPASEResponderStep2(void);
-    WEAVE_ERROR SendPASEInitiatorStep1(uint32_t paseConfig);
-    WEAVE_ERROR ProcessPASEResponderReconfigure(PacketBuffer *msgBuf, uint32_t &newConfig);
-    WEAVE_ERROR ProcessPASEResponderStep1(PacketBuffer *msgBuf);
-    WEAVE_ERROR ProcessPASEResponderStep2(PacketBuffer *msgBuf);
-    WEAVE_ERROR SendPASEInitiatorStep2(void);
-    WEAVE_ERROR ProcessPASEInitiatorStep2(PacketBuffer *msgBuf);
-    WEAVE_ERROR SendPASEResponderKeyConfirm(void);
-    WEAVE_ERROR ProcessPASEResponderKeyConfirm(PacketBuffer *msgBuf);
+    void StartPASESession(SessionContext *sess);
+    void StartPASEInitiatorStep1(SessionContext *sess, uint32_t paseConfig);
+    void HandlePASESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendPASEResponderReconfigure(SessionContext *sess);
+    WEAVE_ERROR ProcessPASEResponderReconfigure(SessionContext *sess, PacketBuffer *msgBuf, uint32_t &newConfig);
+    WEAVE_ERROR ProcessPASEResponderStep2(SessionContext *sess, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendPASEResponderKeyConfirm(SessionContext *sess);
+    WEAVE_ERROR ProcessPASEResponderKeyConfirm(SessionContext *sess, PacketBuffer *msgBuf);
     WEAVE_ERROR HandlePASESessionEstablished(void);
     static void HandlePASEMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
     static void HandlePASEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
     static void HandlePASEConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr);
-
-    void StartCASESession(uint32_t config, uint32_t curveId);
-    void HandleCASESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    static WEAVE_ERROR RunPASEGenerateInitiatorStep1(CryptoJob *job);
+    static void HandlePASEInitiatorStep1Generated(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunPASEProcessResponderStep1(CryptoJob *job);
+    static void HandlePASEResponderStep1Processed(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunPASEProcessResponderStep2(CryptoJob *job);
+    static void HandlePASEResponderStep2Processed(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunPASEProcessInitiatorStep1(CryptoJob *job);
+    static void HandlePASEInitiatorStep1Processed(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunPASEGenerateResponderStep2(CryptoJob *job);
+    static void HandlePASEResponderStep2Generated(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunPASEProcessInitiatorStep2(CryptoJob *job);
+    static void HandlePASEInitiatorStep2Processed(CryptoJob *job, WEAVE_ERROR err);
+
+    void StartCASESession(SessionContext *sess, uint32_t config, uint32_t curveId);
+    void HandleCASESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
     static void HandleCASEMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
     static void HandleCASEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
-
-    void StartTAKESession(bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId);
-    void HandleTAKESessionStart(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
-    WEAVE_ERROR SendTAKEIdentifyToken(uint8_t takeConfig, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId);
+    static WEAVE_ERROR RunCASEGenerateBeginSessionRequest(CryptoJob *job);
+    static void HandleCASEBeginSessionRequestGenerated(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunCASEProcessBeginSessionResponse(CryptoJob *job);
+    static void HandleCASEBeginSessionResponseProcessed(CryptoJob *job, WEAVE_ERROR err);
+    static WEAVE_ERROR RunCASEProcessBeginSessionRequest(CryptoJob *job);
+    static void HandleCASEBeginSessionRequestProcessed(CryptoJob *job, WEAVE_ERROR err);
+
+    void StartTAKESession(SessionContext *sess, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId);
+    void HandleTAKESessionStart(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTAKEIdentifyToken(SessionContext *sess, uint8_t takeConfig, bool encryptAuthPhase, bool encryptCommPhase, bool timeLimitedIK, bool sendChallengerId);
     static void HandleTAKEMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
     static void HandleTAKEMessageResponder(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
-    WEAVE_ERROR ProcessTAKEIdentifyTokenResponse(const PacketBuffer *msgBuf);
-    WEAVE_ERROR CreateTAKESecureSession(void);
-    WEAVE_ERROR SendTAKEAuthenticateToken(void);
-    WEAVE_ERROR ProcessTAKEAuthenticateToken(const PacketBuffer *msgBuf);
-    WEAVE_ERROR SendTAKEAuthenticateTokenResponse(void);
-    WEAVE_ERROR ProcessTAKEAuthenticateTokenResponse(const PacketBuffer *msgBuf);
-    WEAVE_ERROR SendTAKEReAuthenticateToken(void);
-    WEAVE_ERROR ProcessTAKEReAuthenticateToken(const PacketBuffer *msgBuf);
-    WEAVE_ERROR SendTAKEReAuthenticateTokenResponse(void);
-    WEAVE_ERROR ProcessTAKEReAuthenticateTokenResponse(const PacketBuffer *msgBuf);
-    WEAVE_ERROR SendTAKETokenReconfigure(void);
-    WEAVE_ERROR ProcessTAKETokenReconfigure(uint8_t& config, const PacketBuffer *msgBuf);
-    WEAVE_ERROR FinishTAKESetUp(void);
+    WEAVE_ERROR ProcessTAKEIdentifyTokenResponse(SessionContext *sess, const PacketBuffer *msgBuf);
+    WEAVE_ERROR CreateTAKESecureSession(SessionContext *sess);
+    WEAVE_ERROR SendTAKEAuthenticateToken(SessionContext *sess);
+    WEAVE_ERROR ProcessTAKEAuthenticateToken(SessionContext *sess, const PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTAKEAuthenticateTokenResponse(SessionContext *sess);
+    WEAVE_ERROR ProcessTAKEAuthenticateTokenResponse(SessionContext *sess, const PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTAKEReAuthenticateToken(SessionContext *sess);
+    WEAVE_ERROR ProcessTAKEReAuthenticateToken(SessionContext *sess, const PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTAKEReAuthenticateTokenResponse(SessionContext *sess);
+    WEAVE_ERROR ProcessTAKEReAuthenticateTokenResponse(SessionContext *sess, const PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTAKETokenReconfigure(SessionContext *sess);
+    WEAVE_ERROR ProcessTAKETokenReconfigure(SessionContext *sess, uint8_t& config, const PacketBuffer *msgBuf);
+    WEAVE_ERROR FinishTAKESetUp(SessionContext *sess);
 
     void HandleKeyErrorMsg(ExchangeContext *ec, PacketBuffer *msgBuf);
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     WEAVE_ERROR NewMsgCounterSyncExchange(const WeaveMessageInfo *rcvdMsgInfo, const IPPacketInfo *rcvdMsgPacketInfo, ExchangeContext *& ec);
 #endif
-    WEAVE_ERROR NewSessionExchange(uint64_t peerNodeId, IPAddress peerAddr, uint16_t peerPort);
-    WEAVE_ERROR HandleSessionEstablished(void);
-    void HandleSessionComplete(void);
-    void HandleSessionError(WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf);
+    WEAVE_ERROR NewSessionExchange(SessionContext *sess, uint64_t peerNodeId, IPAddress peerAddr, uint16_t peerPort);
+    WEAVE_ERROR HandleSessionEstablished(SessionContext *sess);
+    void HandleSessionComplete(SessionContext *sess);
+    void HandleSessionError(SessionContext *sess, WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf);
     static void HandleConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr);
 
     static WEAVE_ERROR SendStatusReport(WEAVE_ERROR localError, ExchangeContext *ec);
 
-    void HandleKeyExportRequest(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
-    WEAVE_ERROR SendKeyExportRequest(uint8_t keyExportConfig, uint32_t keyId, bool signMessage);
-    WEAVE_ERROR SendKeyExportResponse(WeaveKeyExport& keyExport, uint8_t msgType);
+    void HandleKeyExportRequest(SessionContext *sess, ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendKeyExportRequest(SessionContext *sess, uint8_t keyExportConfig, uint32_t keyId, bool signMessage);
+    WEAVE_ERROR SendKeyExportResponse(SessionContext *sess, WeaveKeyExport& keyExport, uint8_t msgType);
     static void HandleKeyExportMessageInitiator(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
                                                 uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
-    void HandleKeyExportError(WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf);
+    void HandleKeyExportError(SessionContext *sess, WEAVE_ERROR err, PacketBuffer *statusReportMsgBuf);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
     static void WRMPHandleAckRcvd(ExchangeContext *ec, void *msgCtxt);
     static void WRMPHandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt);
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
-    void Reset(void);
+    WEAVE_ERROR StartCryptoJob(SessionContext *sess, CryptoJob::RunFunct run, CryptoJob::CompleteFunct onComplete);
+    void EndCryptoJob(SessionContext *sess, WEAVE_ERROR &err);
+    void StartTimeConsumingCrypto(void);
+    void EndTimeConsumingCrypto(void);
+
+    void Reset(SessionContext *sess);
 
     void AsyncNotifySecurityManagerAvailable();
     static void DoNotifySecurityManagerAvailable(System::Layer *systemLayer, void *appState, System::Error err);
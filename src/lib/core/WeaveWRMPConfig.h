@@ -46,7 +46,9 @@ namespace Weave {
  *  @def WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD
  *
  *  @brief
- *    The default WRMP timer tick interval in milliseconds.
+ *    The default WRMP timer period in milliseconds.  WRMP deadlines are
+ *    tracked individually to the millisecond, so this value only
+ *    serves as the default acknowledgment timeout.
  *
  */
 #ifndef WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD
@@ -97,11 +99,35 @@ namespace Weave {
 #ifndef WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
 #ifdef PBUF_POOL_SIZE
 #define WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE                (PBUF_POOL_SIZE)
-#else
+#elif WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC > 0
 #define WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE                (WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC)
+#else
+#define WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE                (WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS)
 #endif // PBUF_POOL_SIZE
 #endif // WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
 
+/**
+ *  @def WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE
+ *
+ *  @brief
+ *    The size to which the WRMP retransmission table may grow.
+ *
+ *    The table starts out at #WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+ *    entries.  When it fills up and this value is larger, the table is
+ *    moved to the heap and doubled in size, up to this limit.  By
+ *    default the table only grows when packet buffers are allocated
+ *    from the heap, since otherwise the packet buffer pool already
+ *    bounds the number of outstanding messages.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE
+#if !defined(PBUF_POOL_SIZE) && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+#define WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE            4096
+#else
+#define WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE            (WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE)
+#endif
+#endif // WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE
+
 /**
  *  @def WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS
  *
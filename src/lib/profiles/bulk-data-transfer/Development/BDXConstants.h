@@ -81,6 +81,19 @@ enum
     kMode_Asynchronous =                    0x40,
 };
 
+/*
+ * windowed transfer is not a transfer mode of its own but a modifier
+ * of the sender drive and receiver drive modes. when set in an init
+ * message it advertises that the initiator can pipeline several V1
+ * blocks in flight; when set in an accept message it selects that
+ * behavior for the transfer. peers that do not know the flag ignore
+ * it, which leaves the transfer in stop-and-wait.
+ */
+enum
+{
+    kMode_Windowed =                        0x80,
+};
+
 /*
  * with respect to range control, there are several options:
  * - definite length, if set then the transfer has definite length
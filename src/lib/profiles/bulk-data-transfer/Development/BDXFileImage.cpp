@@ -0,0 +1,373 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the memory-mapped files that BDX transfers
+ *      can send their blocks from.
+ *
+ */
+
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXFileImage.h>
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+#include <SystemLayer/SystemError.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development) {
+
+static BdxFileImage sImagePool[WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES];
+
+/**
+ * Returns the modification time of a file in nanoseconds, so that a
+ * rewrite within the same second as the mapping is still noticed.
+ */
+static int64_t GetModifiedTime(const struct stat &aStat)
+{
+#if defined (__APPLE__) && defined (__MACH__)
+    const struct timespec &modified = aStat.st_mtimespec;
+#else
+    const struct timespec &modified = aStat.st_mtim;
+#endif // defined (__APPLE__) && defined (__MACH__)
+
+    return static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+}
+
+BdxFileImage::BdxFileImage(void) :
+    mData(NULL), mLength(0), mDevice(0), mInode(0), mModified(0), mFd(-1), mRefCount(0), mIsMapped(false)
+{
+}
+
+/**
+ * @brief
+ *  Gets a reference to the mapping of a file, mapping it if it is not
+ *  already in the pool.
+ *
+ * The reference must be returned with Release().
+ *
+ * @param[in]   aPath       The path of the file to map.
+ * @param[out]  aImage      The image holding the mapping.
+ *
+ * @retval #WEAVE_NO_ERROR                  On success.
+ * @retval #WEAVE_ERROR_NO_MEMORY           If every entry of the pool is in use.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT    If the path is not a regular file.
+ * @retval other                            The POSIX error mapped into a #WEAVE_ERROR.
+ */
+WEAVE_ERROR BdxFileImage::Acquire(const char *aPath, BdxFileImage * &aImage)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    BdxFileImage *  image       = NULL;
+    BdxFileImage *  idle        = NULL;
+    struct stat     fileStat;
+
+    aImage = NULL;
+
+    VerifyOrExit(stat(aPath, &fileStat) == 0, err = System::MapErrorPOSIX(errno));
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES && image == NULL; i++)
+    {
+        BdxFileImage &candidate = sImagePool[i];
+
+        if (!candidate.mIsMapped)
+        {
+            if (idle == NULL || idle->mIsMapped)
+            {
+                idle = &candidate;
+            }
+        }
+        else if (candidate.mDevice == static_cast<uint64_t>(fileStat.st_dev) &&
+                 candidate.mInode == static_cast<uint64_t>(fileStat.st_ino) &&
+                 candidate.mModified == GetModifiedTime(fileStat) &&
+                 candidate.mLength == static_cast<uint64_t>(fileStat.st_size))
+        {
+            image = &candidate;
+        }
+        else if (candidate.mRefCount == 0 && idle == NULL)
+        {
+            idle = &candidate;
+        }
+    }
+
+    if (image == NULL)
+    {
+        // Prefer an empty entry; otherwise give up the mapping of a file
+        // that no transfer is sending.
+        VerifyOrExit(idle != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        idle->Unmap();
+
+        err = idle->Map(aPath);
+        SuccessOrExit(err);
+
+        image = idle;
+    }
+
+    image->mRefCount++;
+    aImage = image;
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  Unmaps every file in the pool that no transfer is sending.
+ */
+void BdxFileImage::UnmapIdle(void)
+{
+    for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES; i++)
+    {
+        if (sImagePool[i].mRefCount == 0)
+        {
+            sImagePool[i].Unmap();
+        }
+    }
+}
+
+/**
+ * @brief
+ *  Returns a reference obtained from Acquire().  The file stays mapped
+ *  for later transfers until its entry is needed for another file.
+ */
+void BdxFileImage::Release(void)
+{
+    if (mRefCount > 0)
+    {
+        mRefCount--;
+    }
+}
+
+/**
+ * @brief
+ *  Returns the length of the mapped file.
+ */
+uint64_t BdxFileImage::GetLength(void) const
+{
+    return mLength;
+}
+
+/**
+ * @brief
+ *  Provides the next block of a transfer sending from this image, in the
+ *  manner of a GetBlockHandler.
+ *
+ * The block is returned as a pointer into the mapping, so the protocol
+ * copies it straight into the outgoing PacketBuffer.  Each time the
+ * transfer moves into a new stretch of #WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD
+ * bytes, the kernel is asked to start reading the following one.
+ *
+ * The file is checked before each block, and the transfer fails once it
+ * has been written to or truncated since it was mapped, rather than
+ * sending bytes from two versions of it or faulting on pages past its new
+ * end.  See the class description for why files should be replaced
+ * rather than modified in place.
+ *
+ * @param[in]       aXfer           The transfer, whose mStartOffset and mLength
+ *                                  select the part of the file to send.
+ * @param[inout]    aLength         The room available in the block on input,
+ *                                  the length of the block on return.
+ * @param[inout]    aDataBlock      Set to the block within the mapping.
+ * @param[out]      aLastBlock      True if the block ends the transfer.
+ *
+ * @retval #WEAVE_NO_ERROR                  On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE     If the file is no longer mapped.
+ * @retval System::MapErrorPOSIX(ESTALE)    If the file changed since it was mapped.
+ * @retval other                            The POSIX error mapped into a #WEAVE_ERROR.
+ */
+WEAVE_ERROR BdxFileImage::GetBlock(BDXTransfer &aXfer, uint64_t *aLength, uint8_t **aDataBlock, bool *aLastBlock)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    const uint64_t  readAhead   = WEAVE_CONFIG_BDX_FILE_SOURCE_READAHEAD;
+    const uint64_t  pageSize    = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t  end         = aXfer.mStartOffset + aXfer.mLength;
+    const uint64_t  offset      = aXfer.mStartOffset + aXfer.mBytesSent;
+    uint64_t        length      = (offset < end) ? (end - offset) : 0;
+    uint64_t        prefetch    = end;
+    uint64_t        prefetchLength = 0;
+
+    err = CheckUnchanged();
+    SuccessOrExit(err);
+
+    if (length > *aLength)
+    {
+        length = *aLength;
+    }
+
+    if (length > aXfer.mMaxBlockSize)
+    {
+        length = aXfer.mMaxBlockSize;
+    }
+
+    // Stay one stretch ahead of the transfer: the first block covers the
+    // stretch it starts in and the next one, and each later crossing into
+    // a stretch covers the one after it.
+    if (aXfer.mBytesSent == 0)
+    {
+        prefetch = offset - (offset % pageSize);
+        prefetchLength = (offset / readAhead + 2) * readAhead - prefetch;
+    }
+    else if ((offset / readAhead) != ((offset + length) / readAhead))
+    {
+        prefetch = ((offset + length) / readAhead + 1) * readAhead;
+        prefetchLength = readAhead;
+    }
+
+    if (prefetch < end)
+    {
+        if (prefetchLength > end - prefetch)
+        {
+            prefetchLength = end - prefetch;
+        }
+
+        posix_madvise(mData + prefetch, static_cast<size_t>(prefetchLength), POSIX_MADV_WILLNEED);
+    }
+
+    if (length > 0)
+    {
+        *aDataBlock = mData + offset;
+    }
+
+    *aLength = length;
+    *aLastBlock = (offset + length >= end);
+
+    aXfer.mBytesSent += length;
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  Checks that the mapped file is still the one that was mapped, and has
+ *  not been written to or resized since.
+ *
+ * The descriptor kept open with the mapping refers to the mapped file
+ * even after its path has been given to a replacement, which is left
+ * for the next Acquire() to find.
+ */
+WEAVE_ERROR BdxFileImage::CheckUnchanged(void) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    struct stat fileStat;
+
+    VerifyOrExit(mIsMapped, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    VerifyOrExit(fstat(mFd, &fileStat) == 0, err = System::MapErrorPOSIX(errno));
+
+    VerifyOrExit(GetModifiedTime(fileStat) == mModified &&
+                 static_cast<uint64_t>(fileStat.st_size) == mLength,
+                 err = System::MapErrorPOSIX(ESTALE);
+                 WeaveLogError(BDX, "Mapped file changed while being sent"));
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  Maps a file into this empty entry.
+ */
+WEAVE_ERROR BdxFileImage::Map(const char *aPath)
+{
+    WEAVE_ERROR err         = WEAVE_NO_ERROR;
+    int         fd          = -1;
+    void *      mapping     = NULL;
+    struct stat fileStat;
+
+    fd = open(aPath, O_RDONLY);
+    VerifyOrExit(fd >= 0, err = System::MapErrorPOSIX(errno));
+
+    VerifyOrExit(fstat(fd, &fileStat) == 0, err = System::MapErrorPOSIX(errno));
+    VerifyOrExit(S_ISREG(fileStat.st_mode), err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(static_cast<uint64_t>(fileStat.st_size) <= SIZE_MAX, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // An empty file cannot be mapped, but has nothing to send either.
+    if (fileStat.st_size > 0)
+    {
+        mapping = mmap(NULL, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        VerifyOrExit(mapping != MAP_FAILED, err = System::MapErrorPOSIX(errno));
+
+        posix_madvise(mapping, static_cast<size_t>(fileStat.st_size), POSIX_MADV_SEQUENTIAL);
+    }
+
+    mData = static_cast<uint8_t *>(mapping);
+    mLength = static_cast<uint64_t>(fileStat.st_size);
+    mDevice = static_cast<uint64_t>(fileStat.st_dev);
+    mInode = static_cast<uint64_t>(fileStat.st_ino);
+    mModified = GetModifiedTime(fileStat);
+    mFd = fd;
+    mRefCount = 0;
+    mIsMapped = true;
+
+    fd = -1;
+
+    WeaveLogDetail(BDX, "Mapped %s (%" PRIu64 " bytes) for sending", aPath, mLength);
+
+exit:
+    // On success the descriptor is kept, so that each block can check
+    // the file it was mapped from; see CheckUnchanged().
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *  Unmaps the file held by this entry, if any.
+ */
+void BdxFileImage::Unmap(void)
+{
+    if (mData != NULL)
+    {
+        munmap(mData, static_cast<size_t>(mLength));
+    }
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+    }
+
+    mData = NULL;
+    mLength = 0;
+    mFd = -1;
+    mIsMapped = false;
+}
+
+} // namespace BulkDataTransfer
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares a read-only file mapped into memory, from
+ *      which BDX transfers can send their blocks without going through
+ *      an application GetBlockHandler.
+ *
+ */
+
+#ifndef _WEAVE_BDX_FILE_IMAGE_H
+#define _WEAVE_BDX_FILE_IMAGE_H
+
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXManagedNamespace.hpp>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXTransferState.h>
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development) {
+
+/**
+ * @brief
+ *  A file mapped into memory for sending over BDX.
+ *
+ * Images live in a process-wide pool of #WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES
+ * entries.  Every transfer sending the same file shares one mapping, which
+ * stays in the pool after its last transfer finishes until the entry is
+ * needed for another file.  A file that has been replaced since it was
+ * mapped is mapped afresh for new transfers, while transfers already in
+ * progress keep reading the old mapping.
+ *
+ * A file being sent must be updated by writing the new contents to another
+ * file and renaming it over the old one, which leaves the mapped file
+ * untouched.  Since the mapping is shared with the file, rewriting it in
+ * place would let a transfer send a mix of old and new bytes, and truncating
+ * it would fault on the pages past its new end.  Each block checks that the
+ * file has not changed since it was mapped and fails the transfer if it has,
+ * but a change racing with the copy of a block cannot be caught in time.
+ *
+ * Applications do not use this class directly; see BDXTransfer::SetFileSource().
+ */
+class NL_DLL_EXPORT BdxFileImage
+{
+public:
+    BdxFileImage(void);
+
+    static WEAVE_ERROR Acquire(const char *aPath, BdxFileImage * &aImage);
+    static void UnmapIdle(void);
+
+    void Release(void);
+
+    uint64_t GetLength(void) const;
+
+    WEAVE_ERROR GetBlock(BDXTransfer &aXfer, uint64_t *aLength, uint8_t **aDataBlock, bool *aLastBlock);
+
+private:
+    WEAVE_ERROR Map(const char *aPath);
+    void Unmap(void);
+    WEAVE_ERROR CheckUnchanged(void) const;
+
+    uint8_t *   mData;
+    uint64_t    mLength;
+    uint64_t    mDevice;    // identify the file that was mapped, so that a
+    uint64_t    mInode;     // replaced or rewritten file is not served from
+    int64_t     mModified;  // a stale mapping; in nanoseconds
+    int         mFd;        // the mapped file, checked before each block
+    uint32_t    mRefCount;  // number of transfers sending from the mapping
+    bool        mIsMapped;
+};
+
+} // namespace BulkDataTransfer
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+#endif // _WEAVE_BDX_FILE_IMAGE_H
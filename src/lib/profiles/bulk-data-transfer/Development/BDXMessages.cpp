@@ -50,6 +50,7 @@ SendInit::SendInit()
     , mSenderDriveSupported(true)
     , mReceiverDriveSupported(false)
     , mAsynchronousModeSupported(false)
+    , mWindowedModeSupported(false)
     , mDefiniteLength(true)
     , mStartOffsetPresent(false)
     , mWideRange(false)
@@ -241,6 +242,7 @@ WEAVE_ERROR SendInit::pack(PacketBuffer *aBuffer)
     if (mSenderDriveSupported) ptcByte |= kMode_SenderDrive;
     if (mReceiverDriveSupported) ptcByte |= kMode_ReceiverDrive;
     if (mAsynchronousModeSupported) ptcByte |= kMode_Asynchronous;
+    if (mWindowedModeSupported) ptcByte |= kMode_Windowed;
 
     err = i.writeByte(ptcByte);
     SuccessOrExit(err);
@@ -398,6 +400,7 @@ WEAVE_ERROR SendInit::parse(PacketBuffer *aBuffer, SendInit &aRequest)
     aRequest.mSenderDriveSupported = ((ptcByte & kMode_SenderDrive) != 0);
     aRequest.mReceiverDriveSupported = ((ptcByte & kMode_ReceiverDrive) != 0);
     aRequest.mAsynchronousModeSupported = ((ptcByte & kMode_Asynchronous) != 0);
+    aRequest.mWindowedModeSupported = ((ptcByte & kMode_Windowed) != 0);
 
     // now the range ctl field and do the same
     err = i.readByte(&rangeCtl);
@@ -461,6 +464,7 @@ bool SendInit::operator == (const SendInit &another) const
             mSenderDriveSupported == another.mSenderDriveSupported &&
             mReceiverDriveSupported == another.mReceiverDriveSupported &&
             mAsynchronousModeSupported == another.mAsynchronousModeSupported &&
+            mWindowedModeSupported == another.mWindowedModeSupported &&
             mDefiniteLength == another.mDefiniteLength &&
             mStartOffsetPresent == another.mStartOffsetPresent &&
             mAsynchronousModeSupported == another.mAsynchronousModeSupported &&
@@ -478,6 +482,7 @@ bool SendInit::operator == (const SendInit &another) const
 SendAccept::SendAccept()
     : mVersion(0)
     , mTransferMode(kMode_SenderDrive)
+    , mWindowed(false)
     , mMaxBlockSize(0)
 {
 }
@@ -531,7 +536,7 @@ WEAVE_ERROR SendAccept::pack(PacketBuffer *aBuffer)
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
     i.append();
-    err = i.writeByte(mTransferMode | (mVersion & VERSION_MASK));
+    err = i.writeByte(mTransferMode | (mWindowed ? kMode_Windowed : 0) | (mVersion & VERSION_MASK));
     SuccessOrExit(err);
 
     err = i.write16(mMaxBlockSize);
@@ -576,7 +581,8 @@ WEAVE_ERROR SendAccept::parse(PacketBuffer *aBuffer, SendAccept &aResponse)
     SuccessOrExit(err);
 
     aResponse.mVersion = tcByte & VERSION_MASK ;
-    aResponse.mTransferMode = tcByte & ~VERSION_MASK;
+    aResponse.mTransferMode = tcByte & ~(VERSION_MASK | kMode_Windowed);
+    aResponse.mWindowed = (tcByte & kMode_Windowed) != 0;
 
     err = i.read16(&aResponse.mMaxBlockSize);
     SuccessOrExit(err);
@@ -599,6 +605,7 @@ bool SendAccept::operator == (const SendAccept &another) const
 {
     return (mVersion == another.mVersion &&
             mTransferMode == another.mTransferMode &&
+            mWindowed == another.mWindowed &&
             mMaxBlockSize == another.mMaxBlockSize &&
             mMetaData == another.mMetaData);
 }
@@ -616,6 +623,7 @@ ReceiveInit::ReceiveInit()
     mSenderDriveSupported = false;
     mReceiverDriveSupported = true;
     mAsynchronousModeSupported = false;
+    mWindowedModeSupported = false;
     mDefiniteLength = true;
     mStartOffsetPresent = false;
     mWideRange = false;
@@ -710,7 +718,7 @@ WEAVE_ERROR ReceiveAccept::pack(PacketBuffer *aBuffer)
     uint8_t rangeCtl = 0;
 
     i.append();
-    err = i.writeByte(mTransferMode | (mVersion & VERSION_MASK));
+    err = i.writeByte(mTransferMode | (mWindowed ? kMode_Windowed : 0) | (mVersion & VERSION_MASK));
     SuccessOrExit(err);
 
     // format and pack the range control field
@@ -779,7 +787,8 @@ WEAVE_ERROR ReceiveAccept::parse(PacketBuffer *aBuffer, ReceiveAccept &aResponse
     SuccessOrExit(err);
 
     aResponse.mVersion = tcByte & VERSION_MASK ;
-    aResponse.mTransferMode = tcByte & ~VERSION_MASK;
+    aResponse.mTransferMode = tcByte & ~(VERSION_MASK | kMode_Windowed);
+    aResponse.mWindowed = (tcByte & kMode_Windowed) != 0;
 
     // unpack the range control byte
     err = i.readByte(&rangeCtl);
@@ -823,6 +832,7 @@ exit:
 bool ReceiveAccept::operator == (const ReceiveAccept &another) const
 {
     return (mTransferMode == another.mTransferMode &&
+            mWindowed == another.mWindowed &&
             mDefiniteLength == another.mDefiniteLength &&
             mWideRange == another.mWideRange &&
             mMaxBlockSize == another.mMaxBlockSize &&
@@ -140,6 +140,7 @@ public:
     bool mSenderDriveSupported;         /**< True if we can support sender drive. */
     bool mReceiverDriveSupported;       /**< True if we can support receiver drive. */
     bool mAsynchronousModeSupported;    /**< True if we can support async mode. */
+    bool mWindowedModeSupported;        /**< True if we can pipeline V1 blocks with a sliding window. */
     // Range control options
     bool mDefiniteLength;               /**< True if the length field is present. */
     bool mStartOffsetPresent;           /**< True if the start offset field is present. */
@@ -179,6 +180,7 @@ public:
 
     uint8_t mVersion;               /**< Version of the BDX protocol we decided on. */
     uint8_t mTransferMode;          /**< Transfer mode that we decided on. */
+    bool mWindowed;                 /**< True if blocks will be pipelined with a sliding window. */
     uint16_t mMaxBlockSize;         /**< Maximum block size we decided on. */
     ReferencedTLVData mMetaData;    /**< Optional TLV Metadata. */
 };
@@ -29,6 +29,7 @@
 #include <Weave/Profiles/common/CommonProfile.h>
 
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXNode.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXFileImage.h>
 
 namespace nl {
 namespace Weave {
@@ -109,6 +110,11 @@ WEAVE_ERROR BdxNode::Shutdown(void)
         ShutdownTransfer(&mTransferPool[i]);
     }
 
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    // Files kept mapped for later transfers are no longer needed.
+    BdxFileImage::UnmapIdle();
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
     AllowBdxTransferToRun(false);
 
 #if WEAVE_CONFIG_BDX_SERVER_SUPPORT
@@ -721,6 +727,10 @@ void BdxNode::HandleReceiveInit(ExchangeContext *anEc, const IPPacketInfo *aPktI
     xfer->mAmSender = true;
     xfer->mMaxBlockSize = receiveInit.mMaxBlockSize;
     xfer->mVersion = (receiveInit.mVersion > WEAVE_CONFIG_BDX_VERSION) ? WEAVE_CONFIG_BDX_VERSION : receiveInit.mVersion;
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    // Accept a windowed transfer if proposed; the application may still opt out
+    xfer->mIsWindowed = receiveInit.mWindowedModeSupported && xfer->mVersion == 1;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
 
     // Verify we have a legitimate block size or reject
     VerifyOrExit(receiveInit.mMaxBlockSize > 0,
@@ -867,6 +877,10 @@ void BdxNode::HandleSendInit(ExchangeContext *anEc, const IPPacketInfo *aPktInfo
     xfer->mAmInitiator = false;
     xfer->mAmSender = false;
     xfer->mVersion = (sendInit.mVersion > WEAVE_CONFIG_BDX_VERSION) ? WEAVE_CONFIG_BDX_VERSION : sendInit.mVersion;
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    // Accept a windowed transfer if proposed; the application may still opt out
+    xfer->mIsWindowed = sendInit.mWindowedModeSupported && xfer->mVersion == 1;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
 
     // Fire application callback to validate request and setup transfer
     // Application should set the transfer mode and accept the transfer.
@@ -1005,6 +1019,9 @@ WEAVE_ERROR BdxNode::SendReceiveAccept(ExchangeContext *anEc, BDXTransfer *aXfer
     err = receiveAccept.init(aXfer->mVersion, aXfer->mTransferMode, aXfer->mMaxBlockSize, aXfer->mLength, NULL);
     VerifyOrExit(err == WEAVE_NO_ERROR,
                  WeaveLogDetail(BDX, "SendReceiveAccept error calling Init on receiveAccept: %d", err));
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    receiveAccept.mWindowed = aXfer->mIsWindowed;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
 
     payload = PacketBuffer::New();
     VerifyOrExit(payload != NULL,
@@ -1031,7 +1048,11 @@ WEAVE_ERROR BdxNode::SendReceiveAccept(ExchangeContext *anEc, BDXTransfer *aXfer
         WeaveLogDetail(BDX, "ReceiveAccept sent: Am driving so sending first block");
         if (aXfer->mVersion == 1)
         {
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+            err = aXfer->mIsWindowed ? BdxProtocol::SendWindowV1(*aXfer) : BdxProtocol::SendNextBlockV1(*aXfer);
+#else
             err = BdxProtocol::SendNextBlockV1(*aXfer);
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
         }
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
         else if (aXfer->mVersion == 0)
@@ -1071,6 +1092,9 @@ WEAVE_ERROR BdxNode::SendSendAccept(ExchangeContext *anEc, BDXTransfer *aXfer)
     err = sendAccept.init(aXfer->mVersion, aXfer->mTransferMode, aXfer->mMaxBlockSize, NULL);
     VerifyOrExit(err == WEAVE_NO_ERROR,
                  WeaveLogDetail(BDX, "SendSendAccept error calling Init on sendAccept: %d", err));
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    sendAccept.mWindowed = aXfer->mIsWindowed;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
 
     payload = PacketBuffer::New();
     VerifyOrExit(payload != NULL,
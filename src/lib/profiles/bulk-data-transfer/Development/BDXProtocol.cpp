@@ -78,6 +78,10 @@ WEAVE_ERROR InitBdxReceive(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    msg.mWindowedModeSupported = aXfer.mIsWindowed;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -134,6 +138,10 @@ WEAVE_ERROR InitBdxSend(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    msg.mWindowedModeSupported = aXfer.mIsWindowed;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -190,6 +198,10 @@ WEAVE_ERROR InitBdxSend(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    msg.mWindowedModeSupported = aXfer.mIsWindowed;
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -491,10 +503,10 @@ WEAVE_ERROR SendNextBlock(BDXTransfer &aXfer)
 
     VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
-    // Before anything, we need to ensure that we have a registered GetBlockHandler
+    // Before anything, we need to ensure that we have a registered GetBlockHandler (or a file source)
     // or else length, data, and isLast won't be properly initialized and we'll
     // be sending hard-to-debug garbage out.  See WEAV-524.
-    VerifyOrExit(aXfer.mHandlers.mGetBlockHandler != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(aXfer.HasBlockSource(), err = WEAVE_ERROR_INCORRECT_STATE);
 
     // TODO: this should probably have an error code so we can properly handle/log issues detected by the user's callback
     // OR we could at least define some contract about when we will actually send a block
@@ -509,7 +521,8 @@ WEAVE_ERROR SendNextBlock(BDXTransfer &aXfer)
     data += sizeof(counter);
     length = buffer->AvailableDataLength() - sizeof(counter);
 
-    aXfer.DispatchGetBlockHandler(&length, &data, &isLast);
+    err = aXfer.DispatchGetBlockHandler(&length, &data, &isLast);
+    SuccessOrExit(err);
 
     // Ensure that we can fit the buffer within the PacketBuffer, fail
     // if we cannot.
@@ -554,63 +567,89 @@ exit:
 
 /**
  * @brief
- *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
+ *  This function fills a PacketBuffer with a BlockSendV1 payload: the given block
+ *  counter followed by the next block retrieved by calling the BDXTransfer's
  *  GetBlockHandler.
  *
- * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
- *                          next block before sending it using the associated ExchangeContext
+ * @param[in]       aXfer           The BDXTransfer whose GetBlockHandler is called to get the
+ *                                  next block
+ * @param[in]       aBlockCounter   The block counter to encode ahead of the data
+ * @param[in]       aBuffer         The PacketBuffer to fill
+ * @param[out]      aIsLast         True if the application returned the last block
  *
  * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ * @retval          #WEAVE_ERROR_BUFFER_TOO_SMALL   If the block does not fit in aBuffer
+ * @retval          other                           If the file source could not provide the block
  */
-WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+static WEAVE_ERROR GetNextBlockV1(BDXTransfer &aXfer, uint32_t aBlockCounter, PacketBuffer *aBuffer, bool &aIsLast)
 {
     WEAVE_ERROR     err         = WEAVE_NO_ERROR;
     uint64_t        length;
     uint8_t*        data;
-    bool            isLast;
-    uint8_t         msgType;
-    PacketBuffer*   buffer      = PacketBuffer::New();
-    uint16_t        flags;
-    uint32_t        blockCounter;
 
-    WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mBlockCounter);
-
-    VerifyOrExit(aXfer.mHandlers.mGetBlockHandler != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
-
-    VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+    VerifyOrExit(aXfer.HasBlockSource(), err = WEAVE_ERROR_INCORRECT_STATE);
 
     // pack the message, no additional abstraction for now.
 
-    data = buffer->Start();
+    data = aBuffer->Start();
 
-    blockCounter = aXfer.mBlockCounter;
-    WEAVE_FAULT_INJECT(FaultInjection::kFault_BDXBadBlockCounter, blockCounter++);
+    WEAVE_FAULT_INJECT(FaultInjection::kFault_BDXBadBlockCounter, aBlockCounter++);
 
-    nl::Weave::Encoding::LittleEndian::Write32(data, blockCounter);
+    nl::Weave::Encoding::LittleEndian::Write32(data, aBlockCounter);
 
-    length = buffer->AvailableDataLength() - sizeof(aXfer.mBlockCounter);
+    length = aBuffer->AvailableDataLength() - sizeof(aBlockCounter);
 
     if (length > aXfer.mMaxBlockSize)
     {
         length = aXfer.mMaxBlockSize;
     }
 
-    aXfer.DispatchGetBlockHandler(&length, &data, &isLast);
+    err = aXfer.DispatchGetBlockHandler(&length, &data, &aIsLast);
+    SuccessOrExit(err);
 
     // Ensure that we can fit the buffer within the PacketBuffer, fail
     // if we cannot.
 
-    VerifyOrExit((length + sizeof(aXfer.mBlockCounter)) <= buffer->AvailableDataLength(), err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+    VerifyOrExit((length + sizeof(aBlockCounter)) <= aBuffer->AvailableDataLength(), err = WEAVE_ERROR_BUFFER_TOO_SMALL);
 
     // if the data pointer has changed, the callee used her own
     // buffer.  Copy the contents.
 
-    if (data != (buffer->Start() + sizeof(aXfer.mBlockCounter)))
+    if (data != (aBuffer->Start() + sizeof(aBlockCounter)))
     {
-        memcpy(buffer->Start() + sizeof(aXfer.mBlockCounter), data, length);
+        memcpy(aBuffer->Start() + sizeof(aBlockCounter), data, length);
     }
 
-    buffer->SetDataLength(length + sizeof(aXfer.mBlockCounter));
+    aBuffer->SetDataLength(length + sizeof(aBlockCounter));
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
+ *  GetBlockHandler.
+ *
+ * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
+ *                          next block before sending it using the associated ExchangeContext
+ *
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    bool            isLast;
+    uint8_t         msgType;
+    PacketBuffer*   buffer      = PacketBuffer::New();
+    uint16_t        flags;
+
+    WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mBlockCounter);
+
+    VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    err = GetNextBlockV1(aXfer, aXfer.mBlockCounter, buffer, isLast);
+    SuccessOrExit(err);
 
     if (isLast)
     {
@@ -637,6 +676,264 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+/**
+ * @brief
+ *  Returns the sliding window slot that holds the given block.
+ */
+static inline PacketBuffer *& WindowSlot(BDXTransfer &aXfer, uint32_t aBlockCounter)
+{
+    return aXfer.mWindow[aBlockCounter % WEAVE_CONFIG_BDX_WINDOW_SIZE];
+}
+
+/**
+ * @brief
+ *  This function sends a copy of a block held in the sender's sliding window,
+ *  as a BlockEOFV1 if it is the last block of the transfer and as a BlockSendV1
+ *  otherwise.  The window keeps its copy until the block is acknowledged.
+ *
+ * @param[in]       aXfer           The windowed BDXTransfer we're sending a block for.
+ * @param[in]       aBlockCounter   The counter of the block to send.
+ * @param[in]       aBuffer         An empty PacketBuffer to send the copy in.  This
+ *                                  function takes ownership of it.
+ *
+ * @retval          #WEAVE_NO_ERROR                 If we successfully sent the message.
+ * @retval          #WEAVE_ERROR_BUFFER_TOO_SMALL   If the block does not fit in aBuffer.
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the block is not in the window.
+ */
+static WEAVE_ERROR SendWindowBlockV1(BDXTransfer &aXfer, uint32_t aBlockCounter, PacketBuffer *aBuffer)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    PacketBuffer*   block   = WindowSlot(aXfer, aBlockCounter);
+    PacketBuffer*   buffer  = aBuffer;
+    uint8_t         msgType;
+    uint16_t        flags;
+
+    VerifyOrExit(block != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    // The message layer encodes messages in place, so send a copy of the block.
+    VerifyOrExit(block->DataLength() <= buffer->AvailableDataLength(), err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(buffer->Start(), block->Start(), block->DataLength());
+    buffer->SetDataLength(block->DataLength());
+
+    if (aXfer.mWindowEOF && aBlockCounter == aXfer.mWindowNext - 1)
+    {
+        msgType = kMsgType_BlockEOFV1;
+    }
+    else
+    {
+        msgType = kMsgType_BlockSendV1;
+    }
+
+    // The exchange tracks a single outstanding response, so only the first block in
+    // flight arms the response timer; any ack or query from the receiver answers it.
+    flags = aXfer.GetDefaultFlags(!aXfer.mExchangeContext->IsResponseExpected());
+
+    err = aXfer.mExchangeContext->SendMessage(kWeaveProfile_BDX, msgType, buffer, flags);
+    buffer = NULL;
+
+exit:
+    if (buffer != NULL)
+    {
+        PacketBuffer::Free(buffer);
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *  This function reads new blocks from the BDXTransfer's GetBlockHandler and
+ *  sends them until WEAVE_CONFIG_BDX_WINDOW_SIZE blocks are unacknowledged or
+ *  the last block has been sent.
+ *
+ * A block that was read but could not be sent because the message layer had
+ * no room left to track it for retransmission is kept at the end of the
+ * window, and sent first the next time the window is topped up.  While
+ * earlier blocks are in flight, the window is also not grown past the point
+ * where no PacketBuffer would be left for receiving their acknowledgements.
+ *
+ * @param[in]       aXfer   The windowed BDXTransfer we're sending blocks for.
+ *
+ * @retval          #WEAVE_NO_ERROR                 If the window was filled, or partially filled
+ *                                                  while other blocks are still in flight.
+ * @retval          #WEAVE_ERROR_NO_MEMORY          If no available PacketBuffers.
+ * @retval          #WEAVE_ERROR_RETRANS_TABLE_FULL If no room to track the first block for
+ *                                                  retransmission.
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendWindowV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    PacketBuffer*   block   = NULL;
+    PacketBuffer*   buffer  = NULL;
+    bool            isLast;
+
+    while ((aXfer.mWindowNext - aXfer.mBlockCounter) < WEAVE_CONFIG_BDX_WINDOW_SIZE)
+    {
+        bool isHeld = (WindowSlot(aXfer, aXfer.mWindowNext) != NULL);
+
+        if (!isHeld && aXfer.mWindowEOF)
+        {
+            break;
+        }
+
+        // Both buffers are taken before the block is read, since the GetBlockHandler cannot
+        // be asked for the same block twice.  Running out of buffers only narrows the window
+        // while earlier blocks are in flight; the next acknowledgement will resume filling it.
+        block = isHeld ? NULL : PacketBuffer::New();
+        buffer = (isHeld || block != NULL) ? PacketBuffer::New() : NULL;
+        VerifyOrExit(buffer != NULL,
+                     err = (aXfer.mWindowNext != aXfer.mBlockCounter) ? WEAVE_NO_ERROR : WEAVE_ERROR_NO_MEMORY);
+
+        // The copies in the window and those the message layer retains for WRMP can drain
+        // the pool, leaving nothing to receive the acknowledgements that would free them.
+        // Only grow the window while a buffer is left over for receiving.
+        if (aXfer.mWindowNext != aXfer.mBlockCounter)
+        {
+            PacketBuffer *spare = PacketBuffer::New();
+
+            VerifyOrExit(spare != NULL, err = WEAVE_NO_ERROR);
+            PacketBuffer::Free(spare);
+        }
+
+        if (isHeld)
+        {
+            isLast = aXfer.mWindowHeldLast;
+        }
+        else
+        {
+            WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mWindowNext);
+
+            err = GetNextBlockV1(aXfer, aXfer.mWindowNext, block, isLast);
+            SuccessOrExit(err);
+
+            WindowSlot(aXfer, aXfer.mWindowNext) = block;
+            block = NULL;
+        }
+
+        aXfer.mWindowNext++;
+        aXfer.mWindowEOF = isLast;
+
+        err = SendWindowBlockV1(aXfer, aXfer.mWindowNext - 1, buffer);
+        buffer = NULL;
+
+        if (err == WEAVE_ERROR_RETRANS_TABLE_FULL)
+        {
+            // Like running out of buffers, this narrows the window while earlier blocks
+            // are in flight.  The block has already been read, so hold on to it unsent.
+            aXfer.mWindowNext--;
+            aXfer.mWindowEOF = false;
+            aXfer.mWindowHeldLast = isLast;
+
+            if (aXfer.mWindowNext != aXfer.mBlockCounter)
+            {
+                err = WEAVE_NO_ERROR;
+            }
+        }
+        SuccessOrExit(err);
+    }
+
+exit:
+    if (block != NULL)
+    {
+        PacketBuffer::Free(block);
+    }
+
+    if (buffer != NULL)
+    {
+        PacketBuffer::Free(buffer);
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *  This function slides the sender's window forward so that it starts at the
+ *  given block, freeing the copies of the blocks before it.
+ *
+ * @param[in]       aXfer           The windowed BDXTransfer.
+ * @param[in]       aBlockCounter   The new oldest unacknowledged block.
+ */
+static void AdvanceWindow(BDXTransfer &aXfer, uint32_t aBlockCounter)
+{
+    while (aXfer.mBlockCounter < aBlockCounter)
+    {
+        PacketBuffer *& block = WindowSlot(aXfer, aXfer.mBlockCounter);
+
+        if (block != NULL)
+        {
+            PacketBuffer::Free(block);
+            block = NULL;
+        }
+
+        aXfer.mBlockCounter++;
+    }
+}
+
+/**
+ * @brief
+ *  This function retransmits the oldest unacknowledged block, which the receiver
+ *  reported missing, and then tops up the window.
+ *
+ * @param[in]       aXfer   The windowed BDXTransfer we're resending a block for.
+ *
+ * @retval          #WEAVE_NO_ERROR         If we successfully sent the messages.
+ * @retval          #WEAVE_ERROR_NO_MEMORY  If no available PacketBuffers.
+ */
+static WEAVE_ERROR ResendBlockV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    PacketBuffer*   buffer  = PacketBuffer::New();
+
+    VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    WeaveLogDetail(BDX, "Resending block # %d\n", aXfer.mBlockCounter);
+
+    err = SendWindowBlockV1(aXfer, aXfer.mBlockCounter, buffer);
+    SuccessOrExit(err);
+
+    err = SendWindowV1(aXfer);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  This function replies to the sender of a windowed transfer.  If every block
+ *  seen so far has been delivered, it sends a BlockAckV1 that cumulatively
+ *  acknowledges them; otherwise it sends a BlockQueryV1 for the first missing
+ *  block, which acknowledges every block before it and asks for that block to
+ *  be sent again.
+ *
+ * @param[in]       aXfer   The windowed BDXTransfer we're replying for.
+ *
+ * @retval          #WEAVE_NO_ERROR         If we successfully sent the message.
+ * @retval          #WEAVE_ERROR_NO_MEMORY  If no available PacketBuffers.
+ */
+static WEAVE_ERROR SendWindowReplyV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR err;
+
+    if (aXfer.mWindowNext > aXfer.mBlockCounter)
+    {
+        WeaveLogDetail(BDX, "Requesting missing block # %d\n", aXfer.mBlockCounter);
+
+        aXfer.mWindowQuerySent = true;
+        err = SendBlockQueryV1(aXfer);
+    }
+    else
+    {
+        err = SendBlockAckV1(aXfer);
+    }
+
+    return err;
+}
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 /**
  * @brief
  *  The main handler for messages arriving on the BDX exchange.  It essentially
@@ -845,6 +1142,77 @@ void SendStatusReport(ExchangeContext *anEc, uint32_t aProfileId, uint16_t aStat
 }
 
 #if WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+/*
+ * the windowed transfer has been started and i'm the sender.
+ * Regardless of who drives, I should expect cumulative BlockAcks,
+ * BlockQueries for blocks the receiver is missing (or, for the first
+ * one, for block 0) and finally a BlockEOFAck.
+ */
+static WEAVE_ERROR HandleWindowTransmit(BDXTransfer &aXfer, uint8_t aMessageType, PacketBuffer *aPacketBuffer)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    // BlockAckV1 and BlockEOFAckV1 share the BlockQueryV1 format
+    BlockQueryV1 inMsg;
+    uint32_t rcvdCounter;
+
+    if (aMessageType != kMsgType_BlockAckV1 &&
+        aMessageType != kMsgType_BlockQueryV1 &&
+        aMessageType != kMsgType_BlockEOFAckV1)
+    {
+        aXfer.DispatchErrorHandler(WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+        ExitNow();
+    }
+
+    err = BlockQueryV1::parse(aPacketBuffer, inMsg);
+    VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "Windowed BlockQueryV1/BlockAckV1 parse failed."));
+
+    rcvdCounter = inMsg.mBlockCounter;
+
+    if (aMessageType == kMsgType_BlockEOFAckV1)
+    {
+        VerifyOrExit(aXfer.mWindowEOF && rcvdCounter == aXfer.mWindowNext - 1,
+                     WeaveLogDetail(BDX, "Received bad block counter: %d, expected: %d", rcvdCounter, aXfer.mWindowNext - 1);
+                     aXfer.mNext = SendBadBlockCounterStatusReport);
+
+        aXfer.ReleaseWindow();
+        aXfer.mBlockCounter = rcvdCounter;
+        aXfer.mIsCompletedSuccessfully = true;
+        aXfer.DispatchXferDoneHandler();
+    }
+    else if (rcvdCounter < aXfer.mBlockCounter)
+    {
+        // Overtaken by a later acknowledgement; ignore it
+        WeaveLogDetail(BDX, "Received old block counter: %d, window starts at: %d", rcvdCounter, aXfer.mBlockCounter);
+    }
+    else if (aMessageType == kMsgType_BlockAckV1)
+    {
+        // Every block up to and including rcvdCounter has been received
+        VerifyOrExit(rcvdCounter < aXfer.mWindowNext,
+                     WeaveLogDetail(BDX, "Received BlockAckV1 for unsent block: %d", rcvdCounter);
+                     aXfer.mNext = SendBadBlockCounterStatusReport);
+
+        AdvanceWindow(aXfer, rcvdCounter + 1);
+        aXfer.mNext = SendWindowV1;
+    }
+    else
+    {
+        // Every block before rcvdCounter has been received, and the receiver
+        // wants rcvdCounter itself: either a block it is missing or the next
+        // new one.
+        VerifyOrExit(rcvdCounter < aXfer.mWindowNext || (rcvdCounter == aXfer.mWindowNext && !aXfer.mWindowEOF),
+                     WeaveLogDetail(BDX, "Received BlockQueryV1 past the end of the window: %d", rcvdCounter);
+                     aXfer.mNext = SendBadBlockCounterStatusReport);
+
+        AdvanceWindow(aXfer, rcvdCounter);
+        aXfer.mNext = (rcvdCounter < aXfer.mWindowNext) ? ResendBlockV1 : SendWindowV1;
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 /*
  * the transfer has been started and i'm the sender.
  * If I'm driving, I should expect an ACK from my counterpart
@@ -867,6 +1235,12 @@ WEAVE_ERROR HandleResponseTransmit(BDXTransfer &aXfer, uint32_t aProfileId, uint
             aXfer.DispatchXferErrorHandler(&statusReport);
         }
     }
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    else if (aProfileId == kWeaveProfile_BDX && aXfer.mIsWindowed)
+    {
+        err = HandleWindowTransmit(aXfer, aMessageType, aPacketBuffer);
+    }
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
     else if (aProfileId == kWeaveProfile_BDX)
     {
         switch (aMessageType)
@@ -1092,6 +1466,99 @@ exit:
 #endif // WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT
 
 #if WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+/*
+ * the windowed transfer has been started and i'm the receiver.
+ * Blocks may arrive ahead of the one I'm waiting for; I hold on to
+ * those that fit in my window and deliver them once the gap is
+ * filled.  Regardless of who drives, I reply with a cumulative
+ * BlockAck, or with a BlockQuery for the block I'm missing.
+ */
+static WEAVE_ERROR HandleWindowReceive(BDXTransfer &aXfer, uint8_t aMessageType, PacketBuffer *aPacketBuffer)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    // BlockEOFV1 shares the BlockSendV1 format
+    BlockSendV1 block;
+    PacketBuffer *held;
+    bool isLast = (aMessageType == kMsgType_BlockEOFV1);
+    uint32_t rcvdCounter;
+
+    if (aMessageType != kMsgType_BlockSendV1 && !isLast)
+    {
+        aXfer.DispatchErrorHandler(WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+        ExitNow();
+    }
+
+    err = BlockSendV1::parse(aPacketBuffer, block);
+    VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "Windowed BlockSendV1/BlockEOFV1 parse failed."));
+
+    rcvdCounter = block.mBlockCounter;
+
+    if (rcvdCounter == aXfer.mBlockCounter)
+    {
+        aXfer.DispatchPutBlockHandler(block.mLength, block.mData, isLast);
+
+        // Deliver the blocks that were waiting for this one
+        while (!isLast)
+        {
+            aXfer.mBlockCounter++;
+
+            held = WindowSlot(aXfer, aXfer.mBlockCounter);
+            if (held == NULL)
+            {
+                break;
+            }
+
+            WindowSlot(aXfer, aXfer.mBlockCounter) = NULL;
+            isLast = aXfer.mWindowEOF && (aXfer.mBlockCounter == aXfer.mWindowNext - 1);
+
+            // block takes its own reference, so drop the window's
+            err = BlockSendV1::parse(held, block);
+            PacketBuffer::Free(held);
+            SuccessOrExit(err);
+
+            aXfer.DispatchPutBlockHandler(block.mLength, block.mData, isLast);
+        }
+
+        aXfer.mWindowQuerySent = false;
+        aXfer.mNext = isLast ? SendBlockEOFAckV1 : SendWindowReplyV1;
+    }
+    else if (rcvdCounter > aXfer.mBlockCounter)
+    {
+        if (rcvdCounter >= aXfer.mWindowNext)
+        {
+            aXfer.mWindowNext = rcvdCounter + 1;
+        }
+
+        // Blocks beyond our window are dropped and asked for again once we catch up
+        if ((rcvdCounter - aXfer.mBlockCounter) < WEAVE_CONFIG_BDX_WINDOW_SIZE && WindowSlot(aXfer, rcvdCounter) == NULL)
+        {
+            aPacketBuffer->AddRef();
+            WindowSlot(aXfer, rcvdCounter) = aPacketBuffer;
+
+            if (isLast)
+            {
+                aXfer.mWindowEOF = true;
+            }
+        }
+
+        if (!aXfer.mWindowQuerySent)
+        {
+            aXfer.mNext = SendWindowReplyV1;
+        }
+    }
+    else
+    {
+        // A block we already delivered was sent again, so our last reply may have been lost
+        WeaveLogDetail(BDX, "Received old block counter: %d, expected: %d", rcvdCounter, aXfer.mBlockCounter);
+        aXfer.mNext = SendWindowReplyV1;
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 /*
  * otherwise, I'm the receiver. I should expect to get
  * a block here and then, If I'm driving, send out a
@@ -1112,6 +1579,12 @@ WEAVE_ERROR HandleResponseReceive(BDXTransfer &aXfer, uint32_t aProfileId, uint8
             aXfer.DispatchXferErrorHandler(&statusReport);
         }
     }
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    else if (aProfileId == kWeaveProfile_BDX && aXfer.mIsWindowed)
+    {
+        err = HandleWindowReceive(aXfer, aMessageType, aPacketBuffer);
+    }
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
     else if (aProfileId == kWeaveProfile_BDX)
     {
         switch (aMessageType)
@@ -1306,6 +1779,8 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                     aXfer.mMaxBlockSize = inMsg.mMaxBlockSize;
                     aXfer.mTransferMode = inMsg.mTransferMode;
                     aXfer.mVersion = inMsg.mVersion;
+                    // Fall back to stop-and-wait unless our windowed proposal was accepted
+                    aXfer.mIsWindowed = aXfer.mIsWindowed && inMsg.mWindowed && aXfer.mVersion == 1;
                     err = aXfer.DispatchSendAccept(&inMsg);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "DispatchSendAccept failed."));
 
@@ -1317,6 +1792,14 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                             // Try and send the first block
                             VerifyOrExit(aXfer.mVersion < 2, err = WEAVE_ERROR_UNSUPPORTED_MESSAGE_VERSION);
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+                            if (aXfer.mIsWindowed)
+                            {
+                                aXfer.mNext = SendWindowV1;
+                                break;
+                            }
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
                             aXfer.mNext = aXfer.mVersion == 1 ? SendNextBlockV1 : SendNextBlock;
 #else
@@ -1380,6 +1863,8 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                     aXfer.mMaxBlockSize = inMsg.mMaxBlockSize;
                     aXfer.mTransferMode = inMsg.mTransferMode;
                     aXfer.mVersion = inMsg.mVersion;
+                    // Fall back to stop-and-wait unless our windowed proposal was accepted
+                    aXfer.mIsWindowed = aXfer.mIsWindowed && inMsg.mWindowed && aXfer.mVersion == 1;
                     aXfer.mLength = inMsg.mLength;
                     err = aXfer.DispatchReceiveAccept(&inMsg);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "DispatchReceiveAccept failed."));
@@ -66,6 +66,10 @@ WEAVE_ERROR SendNextBlock(BDXTransfer &aXfer);
 
 WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer);
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+WEAVE_ERROR SendWindowV1(BDXTransfer &aXfer);
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 // The following handlers are stateless callbacks meant to be passed to the
 // ExchangeContext in order to handle incoming BDX messages.
 // They handle the actual BDX protocol interaction and defer to the previously
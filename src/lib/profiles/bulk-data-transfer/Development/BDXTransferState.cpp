@@ -25,6 +25,7 @@
 #include <Weave/Support/logging/WeaveLogging.h>
 
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXTransferState.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXFileImage.h>
 
 namespace nl {
 namespace Weave {
@@ -65,6 +66,17 @@ void BDXTransfer::Shutdown(void)
         }
     }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    ReleaseWindow();
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    if (mFileImage != NULL)
+    {
+        mFileImage->Release();
+    }
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
     Reset();
 }
 
@@ -86,6 +98,23 @@ void BDXTransfer::Reset(void)
     mIsWideRange                    = false;
     mIsCompletedSuccessfully        = false;
     mAmInitiator                    = false;
+    mIsWindowed                     = false;
+
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    mWindowNext                     = 0;
+    mWindowEOF                      = false;
+    mWindowHeldLast                 = false;
+    mWindowQuerySent                = false;
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_WINDOW_SIZE; i++)
+    {
+        mWindow[i] = NULL;
+    }
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    mFileImage                      = NULL;
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
 
     mHandlers.mSendAcceptHandler    = NULL;
     mHandlers.mReceiveAcceptHandler = NULL;
@@ -97,6 +126,29 @@ void BDXTransfer::Reset(void)
     mHandlers.mErrorHandler         = NULL;
 }
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+/**
+ * @brief
+ *      Frees every block held in the sliding window of a windowed transfer.
+ *
+ * @note
+ *   Reset() only forgets the window, since it is also used to initialize
+ *   transfer objects whose contents are not yet valid; call this first
+ *   when a transfer may still hold blocks.
+ */
+void BDXTransfer::ReleaseWindow(void)
+{
+    for (int i = 0; i < WEAVE_CONFIG_BDX_WINDOW_SIZE; i++)
+    {
+        if (mWindow[i] != NULL)
+        {
+            PacketBuffer::Free(mWindow[i]);
+            mWindow[i] = NULL;
+        }
+    }
+}
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
 /**
  * @brief
  *      Returns true if this transfer is asynchronous, false otherwise.
@@ -141,6 +193,80 @@ void BDXTransfer::SetHandlers(BDXHandlers aHandlers)
     mHandlers = aHandlers;
 }
 
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+/**
+ * @brief
+ *  This function makes the transfer send part of a file directly from a
+ *  memory mapping of it, in place of the GetBlockHandler.
+ *
+ * The file is mapped once and shared with any other transfer sending it,
+ * and each block is copied out of the mapping straight into its message.
+ * mStartOffset and mLength are set to the part of the file being sent, so
+ * that the accept message reports the actual length.  The mapping is
+ * released when the transfer is shut down.  The file must not be modified
+ * in place while it is being sent; see BdxFileImage.
+ *
+ * @param[in]   aPath           Path of the file to send
+ * @param[in]   aStartOffset    Offset in the file of the first byte to send
+ * @param[in]   aLength         Number of bytes to send, or 0 to send the rest of
+ *                              the file.  Clamped to the end of the file.
+ *
+ * @retval  #WEAVE_NO_ERROR                 On success.
+ * @retval  #WEAVE_ERROR_INCORRECT_STATE    If the transfer already has a file source.
+ * @retval  #WEAVE_ERROR_INVALID_ARGUMENT   If aStartOffset is past the end of the
+ *                                          file, or aPath is not a regular file.
+ * @retval  #WEAVE_ERROR_NO_MEMORY          If too many files are being sent at once.
+ * @retval  other                           The POSIX error mapped into a #WEAVE_ERROR.
+ */
+WEAVE_ERROR BDXTransfer::SetFileSource(const char *aPath, uint64_t aStartOffset, uint64_t aLength)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    BdxFileImage *  image   = NULL;
+    uint64_t        available;
+
+    VerifyOrExit(mFileImage == NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    err = BdxFileImage::Acquire(aPath, image);
+    SuccessOrExit(err);
+
+    VerifyOrExit(aStartOffset <= image->GetLength(), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    available = image->GetLength() - aStartOffset;
+
+    mFileImage = image;
+    image = NULL;
+
+    mStartOffset = aStartOffset;
+    mLength = (aLength == 0 || aLength > available) ? available : aLength;
+    mBytesSent = 0;
+
+exit:
+    if (image != NULL)
+    {
+        image->Release();
+    }
+
+    return err;
+}
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+/**
+ * @brief
+ *  Returns true if blocks can be obtained for sending, either from a file
+ *  source or from the GetBlockHandler.
+ */
+bool BDXTransfer::HasBlockSource(void)
+{
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    if (mFileImage != NULL)
+    {
+        return true;
+    }
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+    return (mHandlers.mGetBlockHandler != NULL);
+}
+
 /**
  * @brief
  *  This function returns the default flags to be sent with a message
@@ -231,20 +357,33 @@ void BDXTransfer::DispatchPutBlockHandler(uint64_t aLength,
 
 /**
  * @brief
- *  If the get block handler has been set, call it.
+ *  If the transfer sends from a file source, get the next block from it;
+ *  otherwise, if the get block handler has been set, call it.
  *
  * @param[in]   aLength             Length of block
  * @param[in]   aDataBlock          Pointer to the data block
  * @param[in]   aLastBlock          True if this is the last block in the transfer
+ *
+ * @return an error value; only a file source can fail, e.g. if the file
+ *         changed while it was being sent.
  */
-void BDXTransfer::DispatchGetBlockHandler(uint64_t *aLength,
-                                          uint8_t **aDataBlock,
-                                          bool *aLastBlock)
+WEAVE_ERROR BDXTransfer::DispatchGetBlockHandler(uint64_t *aLength,
+                                                 uint8_t **aDataBlock,
+                                                 bool *aLastBlock)
 {
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    if (mFileImage != NULL)
+    {
+        return mFileImage->GetBlock(*this, aLength, aDataBlock, aLastBlock);
+    }
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
     if (mHandlers.mGetBlockHandler)
     {
         mHandlers.mGetBlockHandler(this, aLength, aDataBlock, aLastBlock);
     }
+
+    return WEAVE_NO_ERROR;
 }
 
 /**
@@ -41,6 +41,10 @@ namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesigna
 
 struct BDXTransfer; // forward declaration for inclusion in callbacks
 
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+class BdxFileImage;
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
 // typedefs for handler types needed below
 
 /**
@@ -266,6 +270,7 @@ struct BDXTransfer
     bool                mAmSender;
     bool                mIsWideRange; // true is widths and offsets are 64 bits
     bool                mFirstQuery; // true if we haven't received our first query
+    bool                mIsWindowed; // true to propose, and once accepted to use, a windowed transfer
     //TODO: bool mAckRcvd;  // may want to keep track of ACKs to support
                             // retransmission of old blocks in the future
     //TODO: int mSendFlags; // may want to configure SendFlags to be used in calls to
@@ -290,6 +295,31 @@ struct BDXTransfer
      */
     uint32_t            mBlockCounter;
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    /** Sliding window state for windowed transfers.
+     * When sending, mBlockCounter is the oldest unacknowledged block,
+     * mWindowNext the next block to be sent, and mWindow holds a copy of
+     * every block in between for retransmission, as well as the block at
+     * mWindowNext if it was read from the application but not yet sent.
+     * When receiving, mWindowNext is one past the highest block counter
+     * seen so far and mWindow holds the blocks that arrived ahead of
+     * mBlockCounter.  In both cases a block lives in slot
+     * (counter % WEAVE_CONFIG_BDX_WINDOW_SIZE).
+     */
+    uint32_t            mWindowNext;
+    bool                mWindowEOF; // true once the last block has been sent, or buffered when receiving
+    bool                mWindowHeldLast; // when sending, true if a block read but held unsent at mWindowNext is the last one
+    bool                mWindowQuerySent; // true if we already asked for the block at mBlockCounter
+    PacketBuffer *      mWindow[WEAVE_CONFIG_BDX_WINDOW_SIZE];
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    /** The mapped file that blocks are sent from, see SetFileSource().
+     * When set, it takes the place of the GetBlockHandler.
+     */
+    BdxFileImage *      mFileImage;
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
     // application-supplied handlers
     //TODO: make these private when BdxProtocol doesn't inspect them directly
     //before calling DispatchGetBlockHandler().  We'll have to remove that check
@@ -302,12 +332,22 @@ struct BDXTransfer
 
     void Reset(void);
 
+#if WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+    void ReleaseWindow(void);
+#endif // WEAVE_CONFIG_BDX_WINDOWED_SUPPORT
+
     bool IsAsync(void);
 
     bool IsDriver(void);
 
     void SetHandlers(BDXHandlers aHandlers);
 
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    WEAVE_ERROR SetFileSource(const char *aPath, uint64_t aStartOffset, uint64_t aLength);
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+    bool HasBlockSource(void);
+
     uint16_t GetDefaultFlags(bool aExpectResponse);
 
     /**
@@ -324,9 +364,9 @@ struct BDXTransfer
     void DispatchPutBlockHandler(uint64_t aLength,
                                  uint8_t *aDataBlock,
                                  bool aLastBlock);
-    void DispatchGetBlockHandler(uint64_t *aLength,
-                                 uint8_t **aDataBlock,
-                                 bool *aLastBlock);
+    WEAVE_ERROR DispatchGetBlockHandler(uint64_t *aLength,
+                                        uint8_t **aDataBlock,
+                                        bool *aLastBlock);
     void DispatchErrorHandler(WEAVE_ERROR anErrorCode);
     void DispatchXferErrorHandler(StatusReport *aXferError);
     void DispatchXferDoneHandler(void);
@@ -30,6 +30,7 @@
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXConstants.h>
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXMessages.h>
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXTransferState.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXFileImage.h>
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXProtocol.h>
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXNode.h>
 
@@ -22,6 +22,7 @@
 
 // it is important for this first inclusion of inttypes.h to have all the right switches turned ON
 #include <inttypes.h>
+#include <string.h>
 
 #define WEAVE_CONFIG_BDX_NAMESPACE kWeaveManagedNamespace_Development
 
@@ -33,6 +34,14 @@
 
 #include <SystemLayer/SystemTimer.h>
 
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 #if HAVE_NEW
 #include <new>
 #else
@@ -101,6 +110,10 @@ WEAVE_ERROR LoggingManagement::CopyToNextBuffer(CircularEventBuffer * inEventBuf
     err = writer.Finalize();
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    inEventBuffer->mNext->mUnsyncedLength += writer.GetLengthWritten();
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 exit:
     if (err != WEAVE_NO_ERROR)
     {
@@ -109,6 +122,39 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+// The position of the oldest element in a circular buffer, normalized
+// the same way the readers of that buffer normalize it.
+static const uint8_t * GetHeadEventPosition(WeaveCircularTLVBuffer & inBuffer)
+{
+    CircularTLVReader reader;
+
+    reader.Init(&inBuffer);
+
+    return reader.GetReadPoint();
+}
+
+/**
+ * @brief
+ *   Update the checkpoints of all importances that refer to an event
+ *   leaving a buffer.
+ *
+ * @param[in] inFromBuffer   The buffer the event is being evicted from.
+ * @param[in] inFromPosition The position of the event in inFromBuffer.
+ * @param[in] inToBuffer     The buffer the event was copied into, or
+ *                           NULL if the event was dropped.
+ * @param[in] inToPosition   The position of the event in inToBuffer.
+ */
+void LoggingManagement::MoveCheckpoints(CircularEventBuffer * inFromBuffer, const uint8_t * inFromPosition,
+                                        CircularEventBuffer * inToBuffer, const uint8_t * inToPosition)
+{
+    for (CircularEventBuffer * buf = mEventBuffer; buf != NULL; buf = buf->mNext)
+    {
+        buf->MoveCheckpoints(inFromBuffer, inFromPosition, inToBuffer, inToPosition);
+    }
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
 WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
 {
     WEAVE_ERROR err                   = WEAVE_NO_ERROR;
@@ -116,6 +162,10 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
     CircularEventBuffer * eventBuffer = mEventBuffer;
     WeaveCircularTLVBuffer * circularBuffer;
     ReclaimEventCtx ctx;
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    const uint8_t * evictedPosition;
+    const uint8_t * copiedPosition;
+#endif
 
     // check whether we actually need to do anything, exit if we don't
     VerifyOrExit(requiredSpace > eventBuffer->mBuffer.AvailableDataLength(), err = WEAVE_NO_ERROR);
@@ -131,10 +181,22 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
             ctx.mEventBuffer         = eventBuffer;
             ctx.mSpaceNeededForEvent = 0;
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+            evictedPosition = GetHeadEventPosition(*circularBuffer);
+#endif
+
             circularBuffer->mProcessEvictedElement = EvictEvent;
             circularBuffer->mAppData               = &ctx;
             err                                    = circularBuffer->EvictHead();
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+            if (err == WEAVE_NO_ERROR)
+            {
+                // the event was dropped from the log
+                MoveCheckpoints(eventBuffer, evictedPosition, NULL, NULL);
+            }
+#endif
+
             // one of two things happened: either the element was evicted,
             // or we figured out how much space we need to evict it into
             // the next buffer
@@ -150,6 +212,9 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
                     // Since we're calling CopyElement and we've checked
                     // that there is space in the next buffer, we don't expect
                     // this to fail.
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+                    copiedPosition = eventBuffer->mNext->mBuffer.QueueTail();
+#endif
                     err = CopyToNextBuffer(eventBuffer);
                     SuccessOrExit(err);
 
@@ -162,6 +227,10 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
                     // caller know that we could not honor the
                     // request
                     SuccessOrExit(err);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+                    MoveCheckpoints(eventBuffer, evictedPosition, eventBuffer->mNext, copiedPosition);
+#endif
                     continue;
                 }
                 // we cannot copy event outright. We remember the
@@ -433,6 +502,13 @@ void LoggingManagement::CreateLoggingManagement(nl::Weave::WeaveExchangeManager
 void LoggingManagement::DestroyLoggingManagement(void)
 {
     Platform::CriticalSectionEnter();
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    // Write out the events still within the persist interval.
+    if (sInstance.mState != kLoggingManagementState_Shutdown)
+    {
+        sInstance.PersistEventBuffers();
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
     sInstance.mState       = kLoggingManagementState_Shutdown;
     sInstance.mEventBuffer = NULL;
     Platform::CriticalSectionExit();
@@ -484,6 +560,14 @@ LoggingManagement::LoggingManagement(WeaveExchangeManager * inMgr, size_t inNumB
 
     mThrottled   = 0;
     mExchangeMgr = inMgr;
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    mStagingTicket         = 0;
+    mStagingCommitTicket   = 0;
+    mStagingDrainScheduled = false;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    mPersistScheduled = false;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
 
     for (i = 0; i < inNumBuffers; i++)
     {
@@ -555,6 +639,14 @@ LoggingManagement::LoggingManagement(WeaveExchangeManager * inMgr, size_t inNumB
 
     mThrottled   = 0;
     mExchangeMgr = inMgr;
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    mStagingTicket         = 0;
+    mStagingCommitTicket   = 0;
+    mStagingDrainScheduled = false;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    mPersistScheduled = false;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
 
     for (i = 0; i < inNumBuffers; i++)
     {
@@ -589,6 +681,14 @@ LoggingManagement::LoggingManagement(WeaveExchangeManager * inMgr, size_t inNumB
 LoggingManagement::LoggingManagement(void) :
     mEventBuffer(NULL), mExchangeMgr(NULL), mState(kLoggingManagementState_Idle), mBDXUploader(NULL), mBytesWritten(0),
     mThrottled(0), mMaxImportanceBuffer(kImportanceType_Invalid), mUploadRequested(false)
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    ,
+    mStagingTicket(0), mStagingCommitTicket(0), mStagingDrainScheduled(false)
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    ,
+    mPersistScheduled(false)
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
 { }
 
 /**
@@ -922,86 +1022,126 @@ event_id_t LoggingManagement::LogEvent(const EventSchema & inSchema, EventWriter
                                        const EventOptions * inOptions)
 {
     event_id_t event_id = 0;
+    EventOptions opts;
+    timestamp_t systemTimestamp;
 
     Platform::CriticalSectionEnter();
 
     // Make sure we're alive.
     VerifyOrExit(mState != kLoggingManagementState_Shutdown, /* no-op */);
 
-    event_id = LogEventPrivate(inSchema, inEventWriter, inAppData, inOptions);
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    // Commit the events staged so far first, so that event IDs follow
+    // the order in which the events were logged.
+    DrainStagedEventsPrivate();
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+
+    ResolveEventOptions(inOptions, opts, systemTimestamp);
+
+    event_id = LogEventPrivate(inSchema, inEventWriter, inAppData, opts, systemTimestamp);
 
 exit:
     Platform::CriticalSectionExit();
     return event_id;
 }
 
-// Note: the function below must be called with the critical section
-// locked, and only when the logger is not shutting down
-
-inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
-                                                     const EventOptions * inOptions)
+/**
+ * @brief
+ *   Compute the metadata of an event as of the time it is logged.
+ *
+ * The system timestamp is the caller-supplied one, or the current
+ * time.  When UTC timestamps are enabled and available, the resolved
+ * options carry a UTC timestamp instead; the system timestamp is
+ * always returned separately.
+ *
+ * @param[in]  inOptions          The caller's event options; may be NULL.
+ *
+ * @param[out] outOptions         The options to log the event with.
+ *
+ * @param[out] outSystemTimestamp The system timestamp of the event.
+ */
+void LoggingManagement::ResolveEventOptions(const EventOptions * inOptions, EventOptions & outOptions,
+                                            timestamp_t & outSystemTimestamp)
 {
-    event_id_t event_id = 0;
-    CircularTLVWriter writer;
-    WEAVE_ERROR err    = WEAVE_NO_ERROR;
-    size_t requestSize = WEAVE_CONFIG_EVENT_SIZE_RESERVE;
-    bool didWriteEvent = false;
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
     int32_t ev_opts_deltatime = 0;
 #endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-    WeaveCircularTLVBuffer checkpoint = mEventBuffer->mBuffer;
-    EventLoadOutContext ctxt =
-        EventLoadOutContext(writer, inSchema.mImportance, GetImportanceBuffer(inSchema.mImportance)->mLastEventID);
-    EventOptions opts = EventOptions(static_cast<timestamp_t>(System::Timer::GetCurrentEpoch()));
 
-    // check whether the entry is to be logged or discarded silently
-    VerifyOrExit(inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId), /* no-op */);
+    outOptions = EventOptions(static_cast<timestamp_t>(System::Timer::GetCurrentEpoch()));
 
     // Create all event specific data
     // Timestamp; encoded as a delta time
     if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_System))
     {
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-        ev_opts_deltatime = inOptions->timestamp.systemTimestamp - opts.timestamp.systemTimestamp;
+        ev_opts_deltatime = inOptions->timestamp.systemTimestamp - outOptions.timestamp.systemTimestamp;
 #endif
-        opts.timestamp.systemTimestamp = inOptions->timestamp.systemTimestamp;
+        outOptions.timestamp.systemTimestamp = inOptions->timestamp.systemTimestamp;
     }
 
-    if (GetImportanceBuffer(inSchema.mImportance)->mFirstEventTimestamp == 0)
-    {
-        GetImportanceBuffer(inSchema.mImportance)->AddEvent(opts.timestamp.systemTimestamp);
-    }
+    outSystemTimestamp = outOptions.timestamp.systemTimestamp;
 
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
     // UTC timestamp; encoded as a delta time
     if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_UTC))
     {
-        opts.timestamp.utcTimestamp = inOptions->timestamp.utcTimestamp;
-        opts.timestampType          = kTimestampType_UTC;
+        outOptions.timestamp.utcTimestamp = inOptions->timestamp.utcTimestamp;
+        outOptions.timestampType          = kTimestampType_UTC;
     }
     else
     {
         uint64_t utc_tmp;
-        err = System::Layer::GetClock_RealTimeMS(utc_tmp);
+        WEAVE_ERROR err = System::Layer::GetClock_RealTimeMS(utc_tmp);
         if ((err == WEAVE_NO_ERROR) && (utc_tmp != 0))
         {
-            opts.timestamp.utcTimestamp = static_cast<utc_timestamp_t>(utc_tmp + ev_opts_deltatime);
-            opts.timestampType          = kTimestampType_UTC;
+            outOptions.timestamp.utcTimestamp = static_cast<utc_timestamp_t>(utc_tmp + ev_opts_deltatime);
+            outOptions.timestampType          = kTimestampType_UTC;
         }
     }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
 
-    if ((opts.timestampType == kTimestampType_UTC) && (GetImportanceBuffer(inSchema.mImportance)->mFirstEventUTCTimestamp == 0))
+    if (inOptions != NULL)
     {
-        GetImportanceBuffer(inSchema.mImportance)->AddEventUTC(opts.timestamp.utcTimestamp);
+        outOptions.eventSource       = inOptions->eventSource;
+        outOptions.relatedEventID    = inOptions->relatedEventID;
+        outOptions.relatedImportance = inOptions->relatedImportance;
+        outOptions.urgent            = inOptions->urgent;
     }
-#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+}
 
-    if (inOptions != NULL)
+// Note: the function below must be called with the critical section
+// locked, and only when the logger is not shutting down
+
+inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
+                                                     const EventOptions & inOptions, timestamp_t inSystemTimestamp)
+{
+    event_id_t event_id = 0;
+    CircularTLVWriter writer;
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    size_t requestSize = WEAVE_CONFIG_EVENT_SIZE_RESERVE;
+    bool didWriteEvent = false;
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    const uint8_t * eventPosition = NULL;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    WeaveCircularTLVBuffer checkpoint = mEventBuffer->mBuffer;
+    EventLoadOutContext ctxt =
+        EventLoadOutContext(writer, inSchema.mImportance, GetImportanceBuffer(inSchema.mImportance)->mLastEventID);
+    EventOptions opts = inOptions;
+
+    // check whether the entry is to be logged or discarded silently
+    VerifyOrExit(inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId), /* no-op */);
+
+    if (GetImportanceBuffer(inSchema.mImportance)->mFirstEventTimestamp == 0)
+    {
+        GetImportanceBuffer(inSchema.mImportance)->AddEvent(inSystemTimestamp);
+    }
+
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    if ((opts.timestampType == kTimestampType_UTC) && (GetImportanceBuffer(inSchema.mImportance)->mFirstEventUTCTimestamp == 0))
     {
-        opts.eventSource       = inOptions->eventSource;
-        opts.relatedEventID    = inOptions->relatedEventID;
-        opts.relatedImportance = inOptions->relatedImportance;
+        GetImportanceBuffer(inSchema.mImportance)->AddEventUTC(opts.timestamp.utcTimestamp);
     }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
 
     ctxt.mFirst          = false;
     ctxt.mCurrentEventID = GetImportanceBuffer(inSchema.mImportance)->mLastEventID;
@@ -1013,6 +1153,10 @@ inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchem
     // Begin writing
     while (!didWriteEvent)
     {
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+        const size_t dataLength = mEventBuffer->mBuffer.DataLength();
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
         // Ensure we have space in the in-memory logging queues
         err = EnsureSpace(requestSize);
         // If we fail to ensure the initial reserve size, then the
@@ -1022,12 +1166,25 @@ inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchem
             WeaveDie();
         SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+        // Every eviction starts at the first buffer.  Record the
+        // evictions before the space they freed is reused.
+        if (mEventBuffer->mBuffer.DataLength() < dataLength)
+        {
+            PersistEventBuffers();
+        }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
         // save a checkpoint for the underlying buffer.  Note that with
         // the current event buffering scheme, only the mEventBuffer will
         // be affected by the writes to the `writer` below, and thus
         // that's the only thing we need to checkpoint.
         checkpoint = mEventBuffer->mBuffer;
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+        eventPosition = mEventBuffer->mBuffer.QueueTail();
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
         // Start the event container (anonymous structure) in the circular buffer
         writer.Init(&(mEventBuffer->mBuffer));
 
@@ -1072,6 +1229,25 @@ exit:
     {
         event_id = GetImportanceBuffer(inSchema.mImportance)->VendEventID();
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+        {
+            CircularEventBuffer * importanceBuffer = GetImportanceBuffer(inSchema.mImportance);
+            EventCheckpoint eventCheckpoint;
+
+            // The event's delta time is relative to the last event of
+            // its importance; record that base before it is advanced.
+            eventCheckpoint.mBuffer    = mEventBuffer;
+            eventCheckpoint.mPosition  = eventPosition;
+            eventCheckpoint.mEventID   = event_id;
+            eventCheckpoint.mTimestamp = importanceBuffer->mLastEventTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            eventCheckpoint.mUTCTimestamp = importanceBuffer->mLastEventUTCTimestamp;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+            importanceBuffer->AddCheckpoint(eventCheckpoint, writer.GetLengthWritten());
+        }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
         if (opts.timestampType == kTimestampType_UTC)
         {
@@ -1095,62 +1271,88 @@ exit:
 #endif // WEAVE_CONFIG_EVENT_LOGGING_VERBOSE_DEBUG_LOGS
         }
 
-        ScheduleFlushIfNeeded(inOptions == NULL ? false : inOptions->urgent);
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+        mEventBuffer->mUnsyncedLength += writer.GetLengthWritten();
+        SchedulePersist();
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
+        ScheduleFlushIfNeeded(opts.urgent);
     }
 
     return event_id;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
 /**
  * @brief
- *   ThrottleLogger elevates the effective logging level to the Production level.
- *
+ *   Internal header of an event held in an EventStagingRing.  The
+ *   TLV-encoded event data follows the header.
  */
-void LoggingManagement::ThrottleLogger(void)
+struct StagedEvent
 {
-    WeaveLogProgress(EventLogging, "LogThrottle on");
+    uint32_t mLength;     //< Bytes occupied in the ring, including this header
+    uint32_t mDataLength; //< Length of the event data following the header
+    uint32_t mTicket;     //< Position of the event in the global staging order
+    bool mPadding;        //< The remainder of the ring is unused; continue at its start
+    bool mHasEventSource; //< Whether mOptions refers to mEventSource
+    EventSchema mSchema;
+    EventOptions mOptions;
+    DetailedRootSection mEventSource;
+    timestamp_t mSystemTimestamp;
+};
 
-    __sync_add_and_fetch(&mThrottled, 1);
-}
+#define STAGED_EVENT_ALIGN(len) (((len) + 7) & ~static_cast<uint32_t>(7))
 
-/**
- * @brief
- *   UnthrottleLogger restores the effective logging level to the configured logging level.
- *
- */
-void LoggingManagement::UnthrottleLogger(void)
+// Return the oldest event in the ring, skipping any padding, or NULL
+// if the ring holds no published events.  Called by the consumer only.
+StagedEvent * EventStagingRing::PeekStagedEvent(void)
 {
-    uint32_t throttled = __sync_sub_and_fetch(&mThrottled, 1);
+    uint8_t * const storage = reinterpret_cast<uint8_t *>(mStorage);
+    const uint32_t ringSize = sizeof(mStorage);
+    uint32_t head           = mHead;
+    const uint32_t tail     = mTail;
+    StagedEvent * retval    = NULL;
 
-    if (throttled == 0)
+    // Pairs with the barrier in StageEvent: the event contents are
+    // visible once the tail covering them is.
+    __sync_synchronize();
+
+    while (head != tail)
     {
-        WeaveLogProgress(EventLogging, "LogThrottle off");
+        if ((ringSize - head < sizeof(StagedEvent)) || reinterpret_cast<StagedEvent *>(storage + head)->mPadding)
+        {
+            head = 0;
+            continue;
+        }
+
+        retval = reinterpret_cast<StagedEvent *>(storage + head);
+        break;
     }
+
+    mHead = head;
+
+    return retval;
 }
 
-// internal API, used to copy events to external buffers
-WEAVE_ERROR LoggingManagement::CopyEvent(const TLVReader & aReader, TLVWriter & aWriter, EventLoadOutContext * aContext)
+// Supplies the staged event data to LogEventPrivate.
+static WEAVE_ERROR CopyStagedEventData(TLVWriter & ioWriter, uint8_t inDataTag, void * inAppData)
 {
-    TLVReader reader;
-    TLVType containerType;
-    CopyAndAdjustDeltaTimeContext context(&aWriter, aContext);
-    const bool recurse = false;
     WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    TLVReader * reader = static_cast<TLVReader *>(inAppData);
+    TLVType container;
 
-    reader.Init(aReader);
-    err = reader.EnterContainer(containerType);
+    // Staged data is wrapped in an anonymous structure, since a context
+    // tag cannot appear at the top level.
+    err = reader->Next();
     SuccessOrExit(err);
 
-    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, containerType);
+    err = reader->EnterContainer(container);
     SuccessOrExit(err);
 
-    err = nl::Weave::TLV::Utilities::Iterate(reader, CopyAndAdjustDeltaTime, &context, recurse);
-    VerifyOrExit(err == WEAVE_NO_ERROR || err == WEAVE_END_OF_TLV, );
-
-    err = aWriter.EndContainer(containerType);
+    err = reader->Next();
     SuccessOrExit(err);
 
-    err = aWriter.Finalize();
+    err = ioWriter.CopyElement(ContextTag(inDataTag), *reader);
 
 exit:
     return err;
@@ -1158,146 +1360,876 @@ exit:
 
 /**
  * @brief
- *   Internal API used to implement #FetchEventsSince
- *
- * Iterator function to used to copy an event from the log into a
- * TLVWriter. The included aContext contains the context of the copy
- * operation, including the TLVWriter that will hold the copy of an
- * event.  If event cannot be written as a whole, the TLVWriter will
- * be rolled back to event boundary.
+ *   Claim an event staging ring for the calling thread.
  *
- * @retval #WEAVE_END_OF_TLV             Function reached the end of the event
- * @retval #WEAVE_ERROR_NO_MEMORY        Function could not write a portion of
- *                                       the event to the TLVWriter.
- * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL Function could not write a
- *                                       portion of the event to the TLVWriter.
+ * @return A ring for the exclusive use of the calling thread, or NULL
+ *         if every ring is in use.
  */
-WEAVE_ERROR LoggingManagement::CopyEventsSince(const TLVReader & aReader, size_t aDepth, void * aContext)
+EventStagingRing * LoggingManagement::AcquireStagingRing(void)
 {
-    WEAVE_ERROR err    = WEAVE_NO_ERROR;
-    const bool recurse = false;
-    TLVReader innerReader;
-    TLVType tlvType;
-    EventEnvelopeContext event;
-    EventLoadOutContext * loadOutContext = static_cast<EventLoadOutContext *>(aContext);
-    nl::Weave::TLV::TLVWriter checkpoint;
-
-#if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
-    // TODO: CopyEventsSince using the LoggingManagement singleton is less than
-    // ideal. Consider a future refactor of the Iterate call in FetchEventsSince.
-    while (LoggingManagement::GetInstance().IsEventExternal(loadOutContext->mImportance, loadOutContext->mCurrentEventID))
-    {
-        if (loadOutContext->mCurrentEventID >= loadOutContext->mStartingEventID)
-        {
-            // the next event is externally handled. return to FetchEventsSince.
-            err = WEAVE_END_OF_TLV;
-            break;
-        }
-        else
-        {
-            // skip over
-            loadOutContext->mCurrentEventID = LoggingManagement::GetInstance().GetEndOfExternalEventRange(
-                                                  loadOutContext->mImportance, loadOutContext->mCurrentEventID) +
-                1;
-        }
-    }
-    SuccessOrExit(err);
-#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
-
-    innerReader.Init(aReader);
-    err = innerReader.EnterContainer(tlvType);
-    SuccessOrExit(err);
-
-    err = nl::Weave::TLV::Utilities::Iterate(innerReader, FetchEventParameters, &event, recurse);
-    VerifyOrExit(event.mNumFieldsToRead == 0, err = WEAVE_NO_ERROR);
-
-    err = WEAVE_NO_ERROR;
-
-    if (event.mImportance == loadOutContext->mImportance)
+    for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS; i++)
     {
-        loadOutContext->mCurrentTime += event.mDeltaTime;
-#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-        loadOutContext->mCurrentUTCTime += event.mDeltaUtc;
-#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-        if (loadOutContext->mCurrentEventID >= loadOutContext->mStartingEventID)
+        if (__sync_bool_compare_and_swap(&mStagingRings[i].mInUse, false, true))
         {
-            // checkpoint the writer
-            checkpoint = loadOutContext->mWriter;
-
-            err = CopyEvent(aReader, loadOutContext->mWriter, loadOutContext);
-
-            // WEAVE_NO_ERROR and WEAVE_END_OF_TLV signify a
-            // successful copy.  In all other cases, roll back the
-            // writer state back to the checkpoint, i.e., the state
-            // before we began the copy operation.
-            VerifyOrExit((err == WEAVE_NO_ERROR) || (err == WEAVE_END_OF_TLV), loadOutContext->mWriter = checkpoint);
-
-            loadOutContext->mCurrentTime = 0;
-            loadOutContext->mFirst       = false;
+            return &mStagingRings[i];
         }
-
-        loadOutContext->mCurrentEventID++;
     }
 
-exit:
-    return err;
+    return NULL;
 }
 
-#if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
 /**
  * @brief
- *   IsEventExternal checks whether inEventID is stored by the platform.
+ *   Return an event staging ring obtained from AcquireStagingRing().
  *
- * @retval true   The event is stored externally.
- * @retval false  The event is not stored externally.
- */
-inline bool LoggingManagement::IsEventExternal(ImportanceType inImportance, event_id_t inEventID) const
-{
-    return (GetImportanceBuffer(inImportance)->GetExternalEventsFromEventID(inEventID) != NULL);
-}
-
-/**
- * @brief
- *   For an event ID known to be stored externally, return the last event ID in that set.
+ * Events already staged in the ring are still committed to the log.
  *
- * @return The last event ID of a group of event IDs.
+ * @param[in] inRing The ring to return.
  */
-inline event_id_t LoggingManagement::GetEndOfExternalEventRange(ImportanceType inImportance, event_id_t inEventID) const
+void LoggingManagement::ReleaseStagingRing(EventStagingRing * inRing)
 {
-    ExternalEvents * ev = GetImportanceBuffer(inImportance)->GetExternalEventsFromEventID(inEventID);
-    return ev->mLastEventID;
+    if (inRing != NULL)
+    {
+        __sync_synchronize();
+        inRing->mInUse = false;
+    }
 }
-#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
 
 /**
  * @brief
- *   A function to retrieve events of specified importance since a specified event ID.
+ *   Log an event via a callback, with options, without entering the
+ *   logging critical section.
  *
- * Given a nl::Weave::TLV::TLVWriter, an importance type, and an event ID, the
- * function will fetch events of specified importance since the
- * specified event.  The function will continue fetching events until
- * it runs out of space in the nl::Weave::TLV::TLVWriter or in the log. The function
- * will terminate the event writing on event boundary.
+ * The event data is encoded into the caller's staging ring, and the
+ * event metadata resolved, immediately, exactly as #LogEvent would
+ * encode and resolve them.  The timestamp is taken once the event is
+ * encoded, together with the event's place in the staging order, so
+ * that staged events are committed in timestamp order.  The event is committed to the log, and
+ * assigned its event ID, by DrainStagedEvents(), which is scheduled on
+ * the Weave event loop and also runs ahead of every #LogEvent.  Staged
+ * events are committed in the order in which StageEvent() returned
+ * for them, across all rings.
  *
- * @param[in] ioWriter     The writer to use for event storage
+ * @param[in] inRing        A staging ring owned by the calling thread.
  *
- * @param[in] inImportance The importance of events to be fetched
+ * @param[in] inSchema      Schema defining importance, profile ID, and
+ *                          structure type of this event.
  *
- * @param[inout] ioEventID On input, the ID of the event immediately
- *                         prior to the one we're fetching.  On
- *                         completion, the ID of the last event
- *                         fetched.
+ * @param[in] inEventWriter The callback to invoke to serialize the event data.
  *
- * @retval #WEAVE_END_OF_TLV             The function has reached the end of the
- *                                       available log entries at the specified
- *                                       importance level
+ * @param[in] inAppData     Application context for the callback.
  *
- * @retval #WEAVE_ERROR_NO_MEMORY        The function ran out of space in the
- *                                       ioWriter, more events in the log are
- *                                       available.
+ * @param[in] inOptions     The options for the event metadata. May be NULL.
  *
- * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL The function ran out of space in the
- *                                       ioWriter, more events in the log are
+ * @retval #WEAVE_NO_ERROR                On success, or if the event
+ *                                        is below the logging threshold
+ *                                        and was discarded.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT  The ring is not owned.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE   The logging subsystem is shut down.
+ * @retval #WEAVE_ERROR_NO_MEMORY         The ring is too full to hold the event.
+ * @retval other                          An error returned by inEventWriter.
+ */
+WEAVE_ERROR LoggingManagement::StageEvent(EventStagingRing * inRing, const EventSchema & inSchema, EventWriterFunct inEventWriter,
+                                          void * inAppData, const EventOptions * inOptions)
+{
+    WEAVE_ERROR err         = WEAVE_NO_ERROR;
+    const uint32_t ringSize = sizeof(inRing->mStorage);
+    uint8_t * storage;
+    uint32_t head, tail, available;
+    StagedEvent * event = NULL;
+    TLVWriter writer;
+    TLVType container;
+    EventOptions opts;
+    timestamp_t systemTimestamp;
+    uint32_t ticket;
+
+    VerifyOrExit((inRing != NULL) && inRing->mInUse, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(mState != kLoggingManagementState_Shutdown, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    // check whether the entry is to be logged or discarded silently
+    VerifyOrExit(inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId), /* no-op */);
+
+    storage = reinterpret_cast<uint8_t *>(inRing->mStorage);
+    tail    = inRing->mTail;
+    head    = inRing->mHead;
+
+    // Do not reuse space until the consumer is done reading it.
+    __sync_synchronize();
+
+    while (true)
+    {
+        // Contiguous free space at the tail.  The tail never catches
+        // up with the head, so that a full ring is not mistaken for an
+        // empty one.
+        if (tail < head)
+        {
+            available = head - tail - 8;
+        }
+        else
+        {
+            available = ringSize - tail - ((head == 0) ? 8 : 0);
+        }
+
+        if (available > sizeof(StagedEvent))
+        {
+            writer.Init(storage + tail + sizeof(StagedEvent), available - sizeof(StagedEvent));
+
+            err = writer.StartContainer(AnonymousTag, kTLVType_Structure, container);
+            if (err == WEAVE_NO_ERROR)
+            {
+                err = inEventWriter(writer, kTag_EventData, inAppData);
+            }
+            if (err == WEAVE_NO_ERROR)
+            {
+                err = writer.EndContainer(container);
+            }
+            if (err == WEAVE_NO_ERROR)
+            {
+                err = writer.Finalize();
+            }
+
+            if (err == WEAVE_NO_ERROR)
+            {
+                break;
+            }
+
+            VerifyOrExit((err == WEAVE_ERROR_NO_MEMORY) || (err == WEAVE_ERROR_BUFFER_TOO_SMALL), /* no-op */);
+        }
+
+        // Out of room.  Wrap to the start of the ring once, if the
+        // free space continues there.
+        VerifyOrExit((tail >= head) && (tail != 0) && (head != 0), err = WEAVE_ERROR_NO_MEMORY);
+
+        if (ringSize - tail >= sizeof(StagedEvent))
+        {
+            reinterpret_cast<StagedEvent *>(storage + tail)->mPadding = true;
+        }
+        tail = 0;
+    }
+
+    // Take the next place in the staging order together with the
+    // timestamp, so that events are committed in timestamp order.  If
+    // another thread takes the ticket between the two, this thread's
+    // timestamp may predate the other's: read both again.
+    do
+    {
+        ticket = mStagingTicket;
+        __sync_synchronize();
+        ResolveEventOptions(inOptions, opts, systemTimestamp);
+    } while (!__sync_bool_compare_and_swap(&mStagingTicket, ticket, ticket + 1));
+
+    event = reinterpret_cast<StagedEvent *>(storage + tail);
+
+    event->mDataLength     = writer.GetLengthWritten();
+    event->mLength         = STAGED_EVENT_ALIGN(sizeof(StagedEvent) + event->mDataLength);
+    event->mPadding        = false;
+    event->mSchema          = inSchema;
+    event->mOptions         = opts;
+    event->mSystemTimestamp = systemTimestamp;
+    event->mHasEventSource  = (opts.eventSource != NULL);
+    if (event->mHasEventSource)
+    {
+        event->mEventSource = *opts.eventSource;
+    }
+
+    tail = (tail + event->mLength) % ringSize;
+
+    // Publish the event.
+    event->mTicket = ticket;
+    __sync_synchronize();
+    inRing->mTail = tail;
+
+    if (__sync_bool_compare_and_swap(&mStagingDrainScheduled, false, true))
+    {
+        if ((mExchangeMgr != NULL) && (mExchangeMgr->MessageLayer != NULL) && (mExchangeMgr->MessageLayer->SystemLayer != NULL))
+        {
+            mExchangeMgr->MessageLayer->SystemLayer->ScheduleWork(HandleStagedEvents, this);
+        }
+        else
+        {
+            mStagingDrainScheduled = false;
+        }
+    }
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Commit the events staged by StageEvent() to the event log.
+ *
+ * Normally invoked from the Weave event loop; platforms without one
+ * may call it directly.
+ */
+void LoggingManagement::DrainStagedEvents(void)
+{
+    Platform::CriticalSectionEnter();
+
+    if (mState != kLoggingManagementState_Shutdown)
+    {
+        DrainStagedEventsPrivate();
+    }
+
+    Platform::CriticalSectionExit();
+}
+
+void LoggingManagement::HandleStagedEvents(System::Layer * inSystemLayer, void * inAppState, System::Error inErr)
+{
+    static_cast<LoggingManagement *>(inAppState)->DrainStagedEvents();
+}
+
+// Note: the function below must be called with the critical section
+// locked, and only when the logger is not shutting down
+
+void LoggingManagement::DrainStagedEventsPrivate(void)
+{
+    const uint32_t ringSize = sizeof(mStagingRings[0].mStorage);
+
+    // Any event published from here on schedules another drain.
+    mStagingDrainScheduled = false;
+    __sync_synchronize();
+
+    while (true)
+    {
+        EventStagingRing * ring = NULL;
+        StagedEvent * event     = NULL;
+        EventOptions opts;
+        TLVReader reader;
+
+        // Find the event holding the next ticket.  If it has been
+        // handed out but not yet published, stop; its producer will
+        // schedule another drain.
+        for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS; i++)
+        {
+            StagedEvent * head = mStagingRings[i].PeekStagedEvent();
+
+            if ((head != NULL) && (head->mTicket == mStagingCommitTicket))
+            {
+                ring  = &mStagingRings[i];
+                event = head;
+                break;
+            }
+        }
+
+        if (event == NULL)
+        {
+            break;
+        }
+
+        opts = event->mOptions;
+        if (event->mHasEventSource)
+        {
+            opts.eventSource = &event->mEventSource;
+        }
+
+        reader.Init(reinterpret_cast<uint8_t *>(event + 1), event->mDataLength);
+
+        LogEventPrivate(event->mSchema, CopyStagedEventData, &reader, opts, event->mSystemTimestamp);
+
+        mStagingCommitTicket++;
+
+        // Hand the space back to the producer.
+        __sync_synchronize();
+        ring->mHead = (ring->mHead + event->mLength) % ringSize;
+    }
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+// Identifies a persistent event buffer file along with the size of the
+// state it records.
+static const uint32_t kPersistedEventBufferMagic = 0x57454c00 | sizeof(PersistedEventBufferState);
+
+PersistentEventBuffer::PersistentEventBuffer(void) : mHeader(NULL), mHeaderLength(0), mBufferLength(0), mFd(-1) { }
+
+/**
+ * @brief
+ *   Open and map the file backing an event buffer, creating it if
+ *   necessary.
+ *
+ * A file whose size does not match the requested buffer length is
+ * cleared.
+ *
+ * @param[in] inPath          The path of the backing file.
+ *
+ * @param[in] inBufferLength  The length of the buffer to be passed to
+ *                            LoggingManagement::CreateLoggingManagement().
+ *
+ * @retval #WEAVE_NO_ERROR                On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE   If the buffer is already open.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT  If the buffer length is too small.
+ * @retval other                          The POSIX error mapped into a
+ *                                        #WEAVE_ERROR.
+ */
+WEAVE_ERROR PersistentEventBuffer::Open(const char * inPath, size_t inBufferLength)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    struct stat fileStat;
+    void * mapping;
+
+    VerifyOrExit(mFd < 0, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(inBufferLength > sizeof(CircularEventBuffer), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // The header occupies pages of its own, so that it can be synced
+    // separately from the events.
+    mHeaderLength = ((sizeof(PersistedEventBufferHeader) + pageSize - 1) / pageSize) * pageSize;
+    mBufferLength = inBufferLength;
+
+    mFd = open(inPath, O_RDWR | O_CREAT, 0600);
+    VerifyOrExit(mFd >= 0, err = System::MapErrorPOSIX(errno));
+
+    VerifyOrExit(fstat(mFd, &fileStat) == 0, err = System::MapErrorPOSIX(errno));
+
+    if (static_cast<size_t>(fileStat.st_size) != mHeaderLength + mBufferLength)
+    {
+        VerifyOrExit(ftruncate(mFd, 0) == 0, err = System::MapErrorPOSIX(errno));
+        VerifyOrExit(ftruncate(mFd, mHeaderLength + mBufferLength) == 0, err = System::MapErrorPOSIX(errno));
+    }
+
+    mapping = mmap(NULL, mHeaderLength + mBufferLength, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    VerifyOrExit(mapping != MAP_FAILED, err = System::MapErrorPOSIX(errno));
+
+    mHeader = static_cast<PersistedEventBufferHeader *>(mapping);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        Close();
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *   Write the events and the header of the buffer to stable storage.
+ *
+ * The events are synced before the header that refers to them, so
+ * that a header on stable storage never describes events that are
+ * not.
+ *
+ * @retval #WEAVE_NO_ERROR               On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE  If the buffer is not open.
+ * @retval other                         The POSIX error mapped into a
+ *                                       #WEAVE_ERROR.
+ */
+WEAVE_ERROR PersistentEventBuffer::Sync(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(mHeader != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    err = SyncEvents();
+    SuccessOrExit(err);
+
+    err = SyncHeader();
+
+exit:
+    return err;
+}
+
+// Write the events held in the buffer to stable storage.
+WEAVE_ERROR PersistentEventBuffer::SyncEvents(void)
+{
+    return (msync(GetBuffer(), mBufferLength, MS_SYNC) == 0) ? WEAVE_NO_ERROR : System::MapErrorPOSIX(errno);
+}
+
+// Write a range of the buffer to stable storage.
+WEAVE_ERROR PersistentEventBuffer::SyncEvents(const uint8_t * inStart, size_t inLength)
+{
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t start    = reinterpret_cast<uintptr_t>(inStart);
+    const uintptr_t pageOffset = start % pageSize;
+
+    return (msync(reinterpret_cast<void *>(start - pageOffset), inLength + pageOffset, MS_SYNC) == 0)
+        ? WEAVE_NO_ERROR
+        : System::MapErrorPOSIX(errno);
+}
+
+// Write the header of the buffer to stable storage.
+WEAVE_ERROR PersistentEventBuffer::SyncHeader(void)
+{
+    return (msync(mHeader, mHeaderLength, MS_SYNC) == 0) ? WEAVE_NO_ERROR : System::MapErrorPOSIX(errno);
+}
+
+/**
+ * @brief
+ *   Sync and unmap the buffer, and close the backing file.  The buffer
+ *   must no longer be in use by the logging subsystem.
+ */
+void PersistentEventBuffer::Close(void)
+{
+    if (mHeader != NULL)
+    {
+        Sync();
+        munmap(mHeader, mHeaderLength + mBufferLength);
+        mHeader = NULL;
+    }
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+}
+
+/**
+ * @brief
+ *   The buffer to pass to LoggingManagement::CreateLoggingManagement(),
+ *   or NULL if the buffer is not open.
+ */
+void * PersistentEventBuffer::GetBuffer(void) const
+{
+    return (mHeader != NULL) ? reinterpret_cast<uint8_t *>(mHeader) + mHeaderLength : NULL;
+}
+
+/**
+ * @brief
+ *   The length of the buffer returned by GetBuffer().
+ */
+size_t PersistentEventBuffer::GetBufferLength(void) const
+{
+    return mBufferLength;
+}
+
+// Check that a restored buffer holds a sequence of complete events, and
+// add the number of events of each importance to ioNumEvents.
+WEAVE_ERROR LoggingManagement::ValidatePersistedEvents(WeaveCircularTLVBuffer & inBuffer, size_t * ioNumEvents)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    CircularTLVReader reader;
+    TLVType containerType;
+    const bool recurse = false;
+
+    reader.Init(&inBuffer);
+    reader.ImplicitProfileId = kCommonProfileId;
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        EventEnvelopeContext context;
+
+        VerifyOrExit((reader.GetType() == kTLVType_Structure) && (reader.GetTag() == AnonymousTag),
+                     err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+
+        err = reader.EnterContainer(containerType);
+        SuccessOrExit(err);
+
+        nl::Weave::TLV::Utilities::Iterate(reader, FetchEventParameters, &context, recurse);
+
+        err = reader.ExitContainer(containerType);
+        SuccessOrExit(err);
+
+        VerifyOrExit((context.mImportance >= kImportanceType_First) && (context.mImportance <= kImportanceType_Last),
+                     err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+
+        ioNumEvents[context.mImportance - kImportanceType_First]++;
+    }
+
+    if (err == WEAVE_END_OF_TLV)
+    {
+        err = WEAVE_NO_ERROR;
+    }
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Back the event buffers with memory-mapped files.
+ *
+ * The buffers must have been obtained from inBuffers, in the same
+ * order, when the logging subsystem was created.  If every file holds
+ * a consistent log, the events, event IDs and timestamps recorded in
+ * the files are restored; otherwise the log starts out empty.  From
+ * then on, each event is synced to its file, together with the header
+ * describing it, before the call that logged it returns.
+ *
+ * @param[in] inBuffers     The open persistent buffers.
+ *
+ * @param[in] inNumBuffers  The number of persistent buffers.
+ *
+ * @retval #WEAVE_NO_ERROR                On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE   If the logging subsystem is shut down.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT  If the persistent buffers do not
+ *                                        match the event buffers.
+ */
+WEAVE_ERROR LoggingManagement::AttachPersistentBuffers(PersistentEventBuffer * inBuffers, size_t inNumBuffers)
+{
+    WEAVE_ERROR err              = WEAVE_NO_ERROR;
+    CircularEventBuffer * buffer = NULL;
+    bool restore                 = true;
+    size_t numEvents[kImportanceType_Last - kImportanceType_First + 1];
+    size_t i;
+
+    memset(numEvents, 0, sizeof(numEvents));
+
+    Platform::CriticalSectionEnter();
+
+    VerifyOrExit(mState != kLoggingManagementState_Shutdown, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    for (i = 0, buffer = mEventBuffer; (i < inNumBuffers) && (buffer != NULL); i++, buffer = buffer->mNext)
+    {
+        VerifyOrExit(inBuffers[i].GetBuffer() == buffer, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+    VerifyOrExit((i == inNumBuffers) && (buffer == NULL), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // The buffers depend on each other, so restore either all or none
+    // of them.
+    for (i = 0, buffer = mEventBuffer; i < inNumBuffers; i++, buffer = buffer->mNext)
+    {
+        const PersistedEventBufferHeader * header = inBuffers[i].mHeader;
+        const PersistedEventBufferState & state   = header->mState[header->mSequence & 1];
+        WeaveCircularTLVBuffer probe              = buffer->mBuffer;
+
+        if ((header->mMagic != kPersistedEventBufferMagic) || (header->mBufferLength != inBuffers[i].mBufferLength) ||
+            (probe.Restore(state.mHeadOffset, state.mDataLength) != WEAVE_NO_ERROR) ||
+            (ValidatePersistedEvents(probe, numEvents) != WEAVE_NO_ERROR))
+        {
+            restore = false;
+            break;
+        }
+    }
+
+    // Event IDs are not stored with the events, but implied by their
+    // order, so the events restored for a buffer must account for every
+    // ID vended since its first event.  Events stored by external
+    // callbacks are not persisted, so a log that includes them is not
+    // restored either.
+    for (i = 0, buffer = mEventBuffer; restore && (i < inNumBuffers); i++, buffer = buffer->mNext)
+    {
+        const PersistedEventBufferHeader * header = inBuffers[i].mHeader;
+        const PersistedEventBufferState & state   = header->mState[header->mSequence & 1];
+        size_t restored                           = 0;
+
+        for (int importance = kImportanceType_First; importance <= kImportanceType_Last; importance++)
+        {
+            if (GetImportanceBuffer(static_cast<ImportanceType>(importance)) == buffer)
+            {
+                restored += numEvents[importance - kImportanceType_First];
+            }
+        }
+
+        restore = (state.mNextEventID >= state.mFirstEventID) && (restored == state.mNextEventID - state.mFirstEventID);
+    }
+
+    for (i = 0, buffer = mEventBuffer; i < inNumBuffers; i++, buffer = buffer->mNext)
+    {
+        PersistedEventBufferHeader * header = inBuffers[i].mHeader;
+
+        if (restore)
+        {
+            err = buffer->Restore(header->mState[header->mSequence & 1]);
+            SuccessOrExit(err);
+        }
+        else
+        {
+            header->mMagic = 0;
+        }
+
+        buffer->mPersistentBuffer = &inBuffers[i];
+        buffer->mUnsyncedLength   = 0;
+        buffer->Persist();
+
+        if (!restore)
+        {
+            __sync_synchronize();
+            header->mBufferLength = inBuffers[i].mBufferLength;
+            header->mMagic        = kPersistedEventBufferMagic;
+        }
+    }
+
+    WeaveLogProgress(EventLogging, "%s persisted events", restore ? "Restored" : "No usable");
+
+exit:
+    Platform::CriticalSectionExit();
+
+    return err;
+}
+
+// Write the events appended since the last time, and then the states
+// describing them, to stable storage.  Every buffer's events are
+// synced before any header, since an event moved between buffers is
+// described by the headers of both.
+void LoggingManagement::PersistEventBuffers(void)
+{
+    CircularEventBuffer * buffer;
+    WEAVE_ERROR err;
+
+    for (buffer = mEventBuffer; buffer != NULL; buffer = buffer->mNext)
+    {
+        if ((buffer->mPersistentBuffer != NULL) && (buffer->mUnsyncedLength > 0))
+        {
+            err = buffer->SyncEvents();
+            if (err != WEAVE_NO_ERROR)
+            {
+                WeaveLogError(EventLogging, "%s SyncEvents() failed with %d", __FUNCTION__, err);
+            }
+        }
+    }
+
+    for (buffer = mEventBuffer; buffer != NULL; buffer = buffer->mNext)
+    {
+        if (buffer->mPersistentBuffer != NULL)
+        {
+            buffer->Persist();
+
+            err = buffer->mPersistentBuffer->SyncHeader();
+            if (err != WEAVE_NO_ERROR)
+            {
+                WeaveLogError(EventLogging, "%s SyncHeader() failed with %d", __FUNCTION__, err);
+            }
+        }
+    }
+}
+
+// Arrange for the events just logged to be persisted: right away if
+// every event must be, and otherwise from a timer on the Weave event
+// loop, so that loggers do not wait for stable storage.
+void LoggingManagement::SchedulePersist(void)
+{
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL
+    if (__sync_bool_compare_and_swap(&mPersistScheduled, false, true))
+    {
+        if ((mExchangeMgr != NULL) && (mExchangeMgr->MessageLayer != NULL) && (mExchangeMgr->MessageLayer->SystemLayer != NULL))
+        {
+            mExchangeMgr->MessageLayer->SystemLayer->ScheduleWork(HandlePersistScheduled, this);
+        }
+        else
+        {
+            mPersistScheduled = false;
+            PersistEventBuffers();
+        }
+    }
+#else  // !WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL
+    PersistEventBuffers();
+#endif // !WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL
+}
+
+// Start the persist timer; timers are only started from the Weave
+// event loop, while events may be logged from any thread.
+void LoggingManagement::HandlePersistScheduled(System::Layer * inSystemLayer, void * inAppState, System::Error inErr)
+{
+    inSystemLayer->StartTimer(WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL, HandlePersistTimer, inAppState);
+}
+
+void LoggingManagement::HandlePersistTimer(System::Layer * inSystemLayer, void * inAppState, System::Error inErr)
+{
+    LoggingManagement * logger = static_cast<LoggingManagement *>(inAppState);
+
+    Platform::CriticalSectionEnter();
+
+    // Any event logged from here on schedules another pass.
+    logger->mPersistScheduled = false;
+
+    if (logger->mState != kLoggingManagementState_Shutdown)
+    {
+        logger->PersistEventBuffers();
+    }
+
+    Platform::CriticalSectionExit();
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
+/**
+ * @brief
+ *   ThrottleLogger elevates the effective logging level to the Production level.
+ *
+ */
+void LoggingManagement::ThrottleLogger(void)
+{
+    WeaveLogProgress(EventLogging, "LogThrottle on");
+
+    __sync_add_and_fetch(&mThrottled, 1);
+}
+
+/**
+ * @brief
+ *   UnthrottleLogger restores the effective logging level to the configured logging level.
+ *
+ */
+void LoggingManagement::UnthrottleLogger(void)
+{
+    uint32_t throttled = __sync_sub_and_fetch(&mThrottled, 1);
+
+    if (throttled == 0)
+    {
+        WeaveLogProgress(EventLogging, "LogThrottle off");
+    }
+}
+
+// internal API, used to copy events to external buffers
+WEAVE_ERROR LoggingManagement::CopyEvent(const TLVReader & aReader, TLVWriter & aWriter, EventLoadOutContext * aContext)
+{
+    TLVReader reader;
+    TLVType containerType;
+    CopyAndAdjustDeltaTimeContext context(&aWriter, aContext);
+    const bool recurse = false;
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+
+    reader.Init(aReader);
+    err = reader.EnterContainer(containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = nl::Weave::TLV::Utilities::Iterate(reader, CopyAndAdjustDeltaTime, &context, recurse);
+    VerifyOrExit(err == WEAVE_NO_ERROR || err == WEAVE_END_OF_TLV, );
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Finalize();
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Internal API used to implement #FetchEventsSince
+ *
+ * Iterator function to used to copy an event from the log into a
+ * TLVWriter. The included aContext contains the context of the copy
+ * operation, including the TLVWriter that will hold the copy of an
+ * event.  If event cannot be written as a whole, the TLVWriter will
+ * be rolled back to event boundary.
+ *
+ * @retval #WEAVE_END_OF_TLV             Function reached the end of the event
+ * @retval #WEAVE_ERROR_NO_MEMORY        Function could not write a portion of
+ *                                       the event to the TLVWriter.
+ * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL Function could not write a
+ *                                       portion of the event to the TLVWriter.
+ */
+WEAVE_ERROR LoggingManagement::CopyEventsSince(const TLVReader & aReader, size_t aDepth, void * aContext)
+{
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    const bool recurse = false;
+    TLVReader innerReader;
+    TLVType tlvType;
+    EventEnvelopeContext event;
+    EventLoadOutContext * loadOutContext = static_cast<EventLoadOutContext *>(aContext);
+    nl::Weave::TLV::TLVWriter checkpoint;
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
+    // TODO: CopyEventsSince using the LoggingManagement singleton is less than
+    // ideal. Consider a future refactor of the Iterate call in FetchEventsSince.
+    while (LoggingManagement::GetInstance().IsEventExternal(loadOutContext->mImportance, loadOutContext->mCurrentEventID))
+    {
+        if (loadOutContext->mCurrentEventID >= loadOutContext->mStartingEventID)
+        {
+            // the next event is externally handled. return to FetchEventsSince.
+            err = WEAVE_END_OF_TLV;
+            break;
+        }
+        else
+        {
+            // skip over
+            loadOutContext->mCurrentEventID = LoggingManagement::GetInstance().GetEndOfExternalEventRange(
+                                                  loadOutContext->mImportance, loadOutContext->mCurrentEventID) +
+                1;
+        }
+    }
+    SuccessOrExit(err);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
+
+    innerReader.Init(aReader);
+    err = innerReader.EnterContainer(tlvType);
+    SuccessOrExit(err);
+
+    err = nl::Weave::TLV::Utilities::Iterate(innerReader, FetchEventParameters, &event, recurse);
+    VerifyOrExit(event.mNumFieldsToRead == 0, err = WEAVE_NO_ERROR);
+
+    err = WEAVE_NO_ERROR;
+
+    if (event.mImportance == loadOutContext->mImportance)
+    {
+        loadOutContext->mCurrentTime += event.mDeltaTime;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        loadOutContext->mCurrentUTCTime += event.mDeltaUtc;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        if (loadOutContext->mCurrentEventID >= loadOutContext->mStartingEventID)
+        {
+            // checkpoint the writer
+            checkpoint = loadOutContext->mWriter;
+
+            err = CopyEvent(aReader, loadOutContext->mWriter, loadOutContext);
+
+            // WEAVE_NO_ERROR and WEAVE_END_OF_TLV signify a
+            // successful copy.  In all other cases, roll back the
+            // writer state back to the checkpoint, i.e., the state
+            // before we began the copy operation.
+            VerifyOrExit((err == WEAVE_NO_ERROR) || (err == WEAVE_END_OF_TLV), loadOutContext->mWriter = checkpoint);
+
+            loadOutContext->mCurrentTime = 0;
+            loadOutContext->mFirst       = false;
+        }
+
+        loadOutContext->mCurrentEventID++;
+    }
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
+/**
+ * @brief
+ *   IsEventExternal checks whether inEventID is stored by the platform.
+ *
+ * @retval true   The event is stored externally.
+ * @retval false  The event is not stored externally.
+ */
+inline bool LoggingManagement::IsEventExternal(ImportanceType inImportance, event_id_t inEventID) const
+{
+    return (GetImportanceBuffer(inImportance)->GetExternalEventsFromEventID(inEventID) != NULL);
+}
+
+/**
+ * @brief
+ *   For an event ID known to be stored externally, return the last event ID in that set.
+ *
+ * @return The last event ID of a group of event IDs.
+ */
+inline event_id_t LoggingManagement::GetEndOfExternalEventRange(ImportanceType inImportance, event_id_t inEventID) const
+{
+    ExternalEvents * ev = GetImportanceBuffer(inImportance)->GetExternalEventsFromEventID(inEventID);
+    return ev->mLastEventID;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
+
+/**
+ * @brief
+ *   A function to retrieve events of specified importance since a specified event ID.
+ *
+ * Given a nl::Weave::TLV::TLVWriter, an importance type, and an event ID, the
+ * function will fetch events of specified importance since the
+ * specified event.  The function will continue fetching events until
+ * it runs out of space in the nl::Weave::TLV::TLVWriter or in the log. The function
+ * will terminate the event writing on event boundary.
+ *
+ * @param[in] ioWriter     The writer to use for event storage
+ *
+ * @param[in] inImportance The importance of events to be fetched
+ *
+ * @param[inout] ioEventID On input, the ID of the event immediately
+ *                         prior to the one we're fetching.  On
+ *                         completion, the ID of the last event
+ *                         fetched.
+ *
+ * @retval #WEAVE_END_OF_TLV             The function has reached the end of the
+ *                                       available log entries at the specified
+ *                                       importance level
+ *
+ * @retval #WEAVE_ERROR_NO_MEMORY        The function ran out of space in the
+ *                                       ioWriter, more events in the log are
+ *                                       available.
+ *
+ * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL The function ran out of space in the
+ *                                       ioWriter, more events in the log are
  *                                       available.
  *
  */
@@ -1324,6 +2256,28 @@ WEAVE_ERROR LoggingManagement::FetchEventsSince(TLVWriter & ioWriter, Importance
     err                      = GetEventReader(reader, inImportance);
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    {
+        // Skip over the events preceding the nearest checkpoint rather
+        // than decoding them one at a time.
+        const EventCheckpoint * checkpoint = buf->FindCheckpoint(ioEventID);
+
+        if (checkpoint != NULL)
+        {
+            CircularEventReader checkpointReader;
+
+            checkpointReader.Init(checkpoint->mBuffer, checkpoint->mPosition);
+            reader.Init(checkpointReader);
+
+            aContext.mCurrentTime = checkpoint->mTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            aContext.mCurrentUTCTime = checkpoint->mUTCTimestamp;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+            aContext.mCurrentEventID = checkpoint->mEventID;
+        }
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
 #if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
     if (IsEventExternal(inImportance, ioEventID))
     {
@@ -1780,6 +2734,14 @@ CircularEventBuffer::CircularEventBuffer(uint8_t * inBuffer, size_t inBufferLeng
     mEventIdCounter(NULL)
 {
     // TODO: hook up the platform-specific persistent event ID.
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    mPersistentBuffer = NULL;
+    mUnsyncedLength   = 0;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    memset(mCheckpoints, 0, sizeof(mCheckpoints));
+    mBytesSinceCheckpoint = 0;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
 #if WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
     for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS; i++)
     {
@@ -1855,6 +2817,206 @@ void CircularEventBuffer::RemoveEvent(void)
     mFirstEventID++;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+/**
+ * @brief
+ *   Offer a newly logged event of this importance as a checkpoint.
+ *
+ * Checkpoints are taken roughly every
+ * 1/#WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE of this
+ * buffer's size.  When every slot is in use, the checkpoint of the
+ * oldest event is replaced.
+ *
+ * @param[in] inCheckpoint  The location, ID and base timestamps of the event.
+ *
+ * @param[in] inEventLength The encoded length of the event.
+ */
+void CircularEventBuffer::AddCheckpoint(const EventCheckpoint & inCheckpoint, size_t inEventLength)
+{
+    const size_t interval  = mBuffer.GetQueueSize() / WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE;
+    EventCheckpoint * slot = NULL;
+
+    if (mBytesSinceCheckpoint < interval)
+    {
+        mBytesSinceCheckpoint += inEventLength;
+        return;
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE; i++)
+    {
+        if (mCheckpoints[i].mBuffer == NULL)
+        {
+            slot = &mCheckpoints[i];
+            break;
+        }
+
+        if ((slot == NULL) || (mCheckpoints[i].mEventID < slot->mEventID))
+        {
+            slot = &mCheckpoints[i];
+        }
+    }
+
+    *slot                 = inCheckpoint;
+    mBytesSinceCheckpoint = inEventLength;
+}
+
+/**
+ * @brief
+ *   Follow an event that leaves a buffer: retarget any checkpoint
+ *   referring to it, or discard it if the event was dropped.
+ *
+ * @param[in] inFromBuffer   The buffer the event is being evicted from.
+ * @param[in] inFromPosition The position of the event in inFromBuffer.
+ * @param[in] inToBuffer     The buffer the event was copied into, or
+ *                           NULL if the event was dropped.
+ * @param[in] inToPosition   The position of the event in inToBuffer.
+ */
+void CircularEventBuffer::MoveCheckpoints(CircularEventBuffer * inFromBuffer, const uint8_t * inFromPosition,
+                                          CircularEventBuffer * inToBuffer, const uint8_t * inToPosition)
+{
+    for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE; i++)
+    {
+        if ((mCheckpoints[i].mBuffer == inFromBuffer) && (mCheckpoints[i].mPosition == inFromPosition))
+        {
+            mCheckpoints[i].mBuffer   = inToBuffer;
+            mCheckpoints[i].mPosition = inToPosition;
+        }
+    }
+}
+
+/**
+ * @brief
+ *   Find the checkpoint closest to, but not past, an event.
+ *
+ * @param[in] inEventID The ID of the first event of interest.
+ *
+ * @return The checkpoint with the largest event ID not exceeding
+ *         inEventID, or NULL if there is none.
+ */
+const EventCheckpoint * CircularEventBuffer::FindCheckpoint(event_id_t inEventID) const
+{
+    const EventCheckpoint * retval = NULL;
+
+    for (int i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE; i++)
+    {
+        const EventCheckpoint & checkpoint = mCheckpoints[i];
+
+        if ((checkpoint.mBuffer != NULL) && (checkpoint.mEventID >= mFirstEventID) && (checkpoint.mEventID <= inEventID) &&
+            ((retval == NULL) || (checkpoint.mEventID > retval->mEventID)))
+        {
+            retval = &checkpoint;
+        }
+    }
+
+    return retval;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+/**
+ * @brief
+ *   Record the state of the buffer in the header of its backing file.
+ *
+ * The state is written to the copy in the header that is not in use,
+ * and then published by advancing the header sequence number.
+ */
+void CircularEventBuffer::Persist(void)
+{
+    PersistedEventBufferHeader * header = mPersistentBuffer->mHeader;
+    PersistedEventBufferState & state   = header->mState[(header->mSequence + 1) & 1];
+
+    state.mHeadOffset          = static_cast<uint32_t>(mBuffer.QueueHeadOffset());
+    state.mDataLength          = static_cast<uint32_t>(mBuffer.DataLength());
+    state.mFirstEventID        = mFirstEventID;
+    state.mLastEventID         = mLastEventID;
+    state.mNextEventID         = mEventIdCounter->GetValue();
+    state.mFirstEventTimestamp = mFirstEventTimestamp;
+    state.mLastEventTimestamp  = mLastEventTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    state.mFirstEventUTCTimestamp = mFirstEventUTCTimestamp;
+    state.mLastEventUTCTimestamp  = mLastEventUTCTimestamp;
+    state.mUTCInitialized         = mUTCInitialized;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+    __sync_synchronize();
+    header->mSequence++;
+}
+
+/**
+ * @brief
+ *   Write the events appended to the buffer since the last sync to
+ *   stable storage.
+ *
+ * Events are only appended at the tail, so these are the last
+ * mUnsyncedLength bytes before the tail, or the whole buffer if more
+ * than that was appended.
+ */
+WEAVE_ERROR CircularEventBuffer::SyncEvents(void)
+{
+    WEAVE_ERROR err          = WEAVE_NO_ERROR;
+    const size_t queueSize   = mBuffer.GetQueueSize();
+    const uint8_t * queue    = mBuffer.QueueHead() - mBuffer.QueueHeadOffset();
+    const size_t tailOffset  = static_cast<size_t>(mBuffer.QueueTail() - queue);
+    size_t length            = (mUnsyncedLength < queueSize) ? mUnsyncedLength : queueSize;
+
+    if (length > tailOffset)
+    {
+        // The range wraps around the end of the queue.
+        err = mPersistentBuffer->SyncEvents(queue + queueSize - (length - tailOffset), length - tailOffset);
+        SuccessOrExit(err);
+
+        length = tailOffset;
+    }
+
+    err = mPersistentBuffer->SyncEvents(queue + tailOffset - length, length);
+    SuccessOrExit(err);
+
+    mUnsyncedLength = 0;
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Restore the buffer from a state recorded in its backing file.
+ *
+ * The built-in event ID counter is advanced past the restored events;
+ * a counter provided by the application is expected to persist
+ * itself.
+ *
+ * @param[in] inState  The recorded state.
+ *
+ * @retval #WEAVE_NO_ERROR                On success.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT  If the state does not fit the buffer.
+ */
+WEAVE_ERROR CircularEventBuffer::Restore(const PersistedEventBufferState & inState)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    err = mBuffer.Restore(inState.mHeadOffset, inState.mDataLength);
+    SuccessOrExit(err);
+
+    mFirstEventID        = inState.mFirstEventID;
+    mLastEventID         = inState.mLastEventID;
+    mFirstEventTimestamp = inState.mFirstEventTimestamp;
+    mLastEventTimestamp  = inState.mLastEventTimestamp;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    mFirstEventUTCTimestamp = inState.mFirstEventUTCTimestamp;
+    mLastEventUTCTimestamp  = inState.mLastEventUTCTimestamp;
+    mUTCInitialized         = inState.mUTCInitialized;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+    if ((mEventIdCounter == &mNonPersistedCounter) && (mNonPersistedCounter.GetValue() < inState.mNextEventID))
+    {
+        err = mNonPersistedCounter.Init(inState.mNextEventID);
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 /**
  * @brief
  *   This function registers a set of event IDs and a function
@@ -2017,6 +3179,40 @@ void CircularEventReader::Init(CircularEventBuffer * inBuf)
     }
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+/**
+ * @brief
+ *   Initializes a TLV reader object to start reading at a given
+ *   position within a CircularEventBuffer, typically the position
+ *   of an #EventCheckpoint.  Reading continues into the previous
+ *   CircularEventBuffers as with #Init(CircularEventBuffer *).
+ *
+ * @param[in] inBuf       A pointer to a fully initialized CircularEventBuffer
+ *
+ * @param[in] inReadPoint The position of an element boundary within inBuf
+ *
+ */
+void CircularEventReader::Init(CircularEventBuffer * inBuf, const uint8_t * inReadPoint)
+{
+    uint32_t bufLen;
+
+    Init(inBuf);
+
+    if ((inReadPoint < mReadPoint) || (inReadPoint >= mBufEnd))
+    {
+        // The position lies past the point where the buffer contents
+        // wrap around the end of the underlying storage.
+        mMaxLen -= static_cast<uint32_t>(mBufEnd - mReadPoint);
+        mReadPoint = mBufEnd;
+        GetNextBuffer(*this, mBufHandle, mReadPoint, bufLen);
+        mBufEnd = mReadPoint + bufLen;
+    }
+
+    mMaxLen -= static_cast<uint32_t>(inReadPoint - mReadPoint);
+    mReadPoint = inReadPoint;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
 WEAVE_ERROR CircularEventBuffer::GetNextBufferFunct(TLVReader & ioReader, uintptr_t & inBufHandle, const uint8_t *& outBufStart,
                                                     uint32_t & outBufLen)
 {
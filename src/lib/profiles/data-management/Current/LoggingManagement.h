@@ -40,6 +40,74 @@ namespace Weave {
 namespace Profiles {
 namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
 
+struct CircularEventBuffer;
+
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+/**
+ * @brief
+ *   Internal structure marking the location of an event in the log.
+ *
+ * A checkpoint lets #LoggingManagement::FetchEventsSince begin
+ * decoding at a known event instead of at the oldest event of an
+ * importance.  It is moved along with the event when the event is
+ * bumped to a more important buffer, and discarded when the event is
+ * dropped.
+ */
+struct EventCheckpoint
+{
+    CircularEventBuffer * mBuffer; //< The buffer currently holding the event; NULL when the checkpoint is unused
+    const uint8_t * mPosition;     //< The start of the event's TLV encoding within mBuffer
+    event_id_t mEventID;           //< The ID of the event
+    timestamp_t mTimestamp;        //< The system timestamp preceding the event, i.e. the base of its delta time
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    utc_timestamp_t mUTCTimestamp; //< The UTC timestamp preceding the event
+#endif
+};
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+/**
+ * @brief
+ *   The state of a #CircularEventBuffer as recorded in its backing
+ *   file.  Positions are kept as offsets, so that the state remains
+ *   valid when the file is mapped at a different address.
+ */
+struct PersistedEventBufferState
+{
+    uint32_t mHeadOffset;             //< Offset of the oldest event within the TLV storage
+    uint32_t mDataLength;             //< Number of bytes of events held in the buffer
+    event_id_t mFirstEventID;         //< First event ID stored for this importance
+    event_id_t mLastEventID;          //< Last event ID vended for this importance
+    event_id_t mNextEventID;          //< Value of the event ID counter
+    timestamp_t mFirstEventTimestamp; //< The timestamp of the first event in this buffer
+    timestamp_t mLastEventTimestamp;  //< The timestamp of the last event in this buffer
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    utc_timestamp_t mFirstEventUTCTimestamp; //< The UTC timestamp of the first event in this buffer
+    utc_timestamp_t mLastEventUTCTimestamp;  //< The UTC timestamp of the last event in this buffer
+    bool mUTCInitialized;                    //< Whether UTC timestamps are initialized in this buffer
+#endif
+};
+
+/**
+ * @brief
+ *   The header at the start of a persistent event buffer file.
+ *
+ * The header holds two copies of the buffer state.  A new state is
+ * written to the copy not currently in use, and takes effect when
+ * mSequence is incremented, so that a crash in the middle of an update
+ * leaves the previous state intact.
+ */
+struct PersistedEventBufferHeader
+{
+    uint32_t mMagic;             //< Identifies the file format and the layout of the state
+    uint32_t mBufferLength;      //< Length of the buffer following the header
+    volatile uint32_t mSequence; //< The state in use is mState[mSequence & 1]
+    PersistedEventBufferState mState[2];
+};
+
+class PersistentEventBuffer;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 /**
  * @brief
  *   Internal event buffer, built around the nl::Weave::TLV::WeaveCircularTLVBuffer
@@ -106,6 +174,35 @@ struct CircularEventBuffer
     ExternalEvents * GetNextAvailableExternalEvents(void);
 #endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_EXTERNAL_CALLBACKS
 
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    EventCheckpoint mCheckpoints[WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE]; //< Checkpoints for events of this importance
+    size_t mBytesSinceCheckpoint; //< Bytes of events of this importance logged since the last checkpoint
+
+    // for doxygen, see the CPP file
+    void AddCheckpoint(const EventCheckpoint & inCheckpoint, size_t inEventLength);
+
+    // for doxygen, see the CPP file
+    void MoveCheckpoints(CircularEventBuffer * inFromBuffer, const uint8_t * inFromPosition, CircularEventBuffer * inToBuffer,
+                         const uint8_t * inToPosition);
+
+    // for doxygen, see the CPP file
+    const EventCheckpoint * FindCheckpoint(event_id_t inEventID) const;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    PersistentEventBuffer * mPersistentBuffer; //< The backing file; NULL when the buffer is not persistent
+    size_t mUnsyncedLength;                    //< Bytes appended since the events were last synced
+
+    // for doxygen, see the CPP file
+    void Persist(void);
+
+    // for doxygen, see the CPP file
+    WEAVE_ERROR SyncEvents(void);
+
+    // for doxygen, see the CPP file
+    WEAVE_ERROR Restore(const PersistedEventBufferState & inState);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
     static WEAVE_ERROR GetNextBufferFunct(nl::Weave::TLV::TLVReader & ioReader, uintptr_t & inBufHandle,
                                           const uint8_t *& outBufStart, uint32_t & outBufLen);
 };
@@ -120,6 +217,9 @@ class CircularEventReader : public nl::Weave::TLV::TLVReader
 
 public:
     void Init(CircularEventBuffer * inBuf);
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    void Init(CircularEventBuffer * inBuf, const uint8_t * inReadPoint);
+#endif
 };
 
 /**
@@ -161,6 +261,77 @@ enum LoggingManagementStates
 // forward class declaration
 class LogBDXUpload;
 
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+struct StagedEvent;
+
+/**
+ * @brief
+ *   A single-producer ring in which one thread stages events for the
+ *   event log without entering the logging critical section.
+ *
+ * A thread obtains a ring with LoggingManagement::AcquireStagingRing(),
+ * logs into it with LoggingManagement::StageEvent(), and returns it with
+ * LoggingManagement::ReleaseStagingRing().  Only the owning thread may
+ * stage events into a ring; the staged events are committed by
+ * LoggingManagement::DrainStagedEvents().
+ */
+class EventStagingRing
+{
+    friend class LoggingManagement;
+
+public:
+    EventStagingRing(void) : mHead(0), mTail(0), mInUse(false) { }
+
+private:
+    StagedEvent * PeekStagedEvent(void);
+
+    uint64_t mStorage[(WEAVE_CONFIG_EVENT_LOGGING_STAGING_RING_SIZE + 7) / 8];
+    volatile uint32_t mHead; //< Offset of the oldest staged event, advanced by the consumer
+    volatile uint32_t mTail; //< Offset past the newest staged event, advanced by the producer
+    volatile bool mInUse;    //< Whether a thread currently owns the ring
+};
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+/**
+ * @brief
+ *   An event buffer backed by a memory-mapped file.
+ *
+ * The file holds a PersistedEventBufferHeader in its first page,
+ * followed by the buffer handed to
+ * LoggingManagement::CreateLoggingManagement().  After the logging
+ * subsystem is created, LoggingManagement::AttachPersistentBuffers()
+ * restores the events recorded in the files and, from then on, syncs
+ * the events and the headers to stable storage as events are logged
+ * (see #WEAVE_CONFIG_EVENT_LOGGING_PERSIST_INTERVAL).
+ */
+class PersistentEventBuffer
+{
+    friend class LoggingManagement;
+    friend struct CircularEventBuffer;
+
+public:
+    PersistentEventBuffer(void);
+
+    WEAVE_ERROR Open(const char * inPath, size_t inBufferLength);
+    WEAVE_ERROR Sync(void);
+    void Close(void);
+
+    void * GetBuffer(void) const;
+    size_t GetBufferLength(void) const;
+
+private:
+    WEAVE_ERROR SyncEvents(void);
+    WEAVE_ERROR SyncEvents(const uint8_t * inStart, size_t inLength);
+    WEAVE_ERROR SyncHeader(void);
+
+    PersistedEventBufferHeader * mHeader;
+    size_t mHeaderLength;
+    size_t mBufferLength;
+    int mFd;
+};
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 /**
  * @brief
  *   A class for managing the in memory event logs.
@@ -192,6 +363,20 @@ public:
     event_id_t LogEvent(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
                         const EventOptions * inOptions);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    EventStagingRing * AcquireStagingRing(void);
+    void ReleaseStagingRing(EventStagingRing * inRing);
+
+    WEAVE_ERROR StageEvent(EventStagingRing * inRing, const EventSchema & inSchema, EventWriterFunct inEventWriter,
+                           void * inAppData, const EventOptions * inOptions);
+
+    void DrainStagedEvents(void);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    WEAVE_ERROR AttachPersistentBuffers(PersistentEventBuffer * inBuffers, size_t inNumBuffers);
+#endif
+
     WEAVE_ERROR GetEventReader(nl::Weave::TLV::TLVReader & ioReader, ImportanceType inImportance);
 
     WEAVE_ERROR FetchEventsSince(nl::Weave::TLV::TLVWriter & ioWriter, ImportanceType inImportance, event_id_t & ioEventID);
@@ -240,12 +425,30 @@ public:
 #endif
 private:
     event_id_t LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
-                               const EventOptions * inOptions);
+                               const EventOptions & inOptions, timestamp_t inSystemTimestamp);
+    static void ResolveEventOptions(const EventOptions * inOptions, EventOptions & outOptions, timestamp_t & outSystemTimestamp);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    void PersistEventBuffers(void);
+    void SchedulePersist(void);
+    static void HandlePersistScheduled(System::Layer * inSystemLayer, void * inAppState, System::Error inErr);
+    static void HandlePersistTimer(System::Layer * inSystemLayer, void * inAppState, System::Error inErr);
+    static WEAVE_ERROR ValidatePersistedEvents(nl::Weave::TLV::WeaveCircularTLVBuffer & inBuffer, size_t * ioNumEvents);
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    void DrainStagedEventsPrivate(void);
+    static void HandleStagedEvents(System::Layer * inSystemLayer, void * inAppState, System::Error inErr);
+#endif
 
     void FlushHandler(System::Layer * inSystemLayer, INET_ERROR inErr);
     void SignalUploadDone(void);
     WEAVE_ERROR CopyToNextBuffer(CircularEventBuffer * inEventBuffer);
     WEAVE_ERROR EnsureSpace(size_t inRequiredSpace);
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    void MoveCheckpoints(CircularEventBuffer * inFromBuffer, const uint8_t * inFromPosition, CircularEventBuffer * inToBuffer,
+                         const uint8_t * inToPosition);
+#endif
 
     static WEAVE_ERROR CopyEventsSince(const nl::Weave::TLV::TLVReader & aReader, size_t aDepth, void * aContext);
     static WEAVE_ERROR FetchEventParameters(const nl::Weave::TLV::TLVReader & aReader, size_t aDepth, void * aContext);
@@ -277,6 +480,17 @@ private:
     uint32_t mThrottled;
     ImportanceType mMaxImportanceBuffer;
     bool mUploadRequested;
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    EventStagingRing mStagingRings[WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS];
+    uint32_t mStagingTicket;       //< The ticket given to the next staged event
+    uint32_t mStagingCommitTicket; //< The ticket of the next staged event to commit to the log
+    bool mStagingDrainScheduled;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    bool mPersistScheduled;
+#endif
 };
 
 namespace Platform {
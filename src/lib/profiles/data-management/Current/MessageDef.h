@@ -725,7 +725,8 @@ enum
 namespace ViewResponse {
 enum
 {
-    kCsTag_DataList = 2,
+    kCsTag_DataList            = 2,
+    kCsTag_MoreChunkedMessages = 3,
 };
 };
 
@@ -78,7 +78,7 @@ WEAVE_ERROR NotificationEngine::BasicGraphSolver::SetDirty(TraitDataHandle aData
     SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
 
     // Iterate over all subscriptions and their trait instance info lists and mark them dirty as appropriate
-    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; ++i)
+    for (int i = 0; i < subEngine->mNumHandlers; ++i)
     {
         SubscriptionHandler * subHandler = &subEngine->mHandlers[i];
 
@@ -105,6 +105,27 @@ WEAVE_ERROR NotificationEngine::BasicGraphSolver::ClearDirty()
     return WEAVE_NO_ERROR;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// IntermediateGraphSolver
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+NotificationEngine::IntermediateGraphSolver::IntermediateGraphSolver() :
+    mNumRootDirtyFallbacks(0)
+{
+}
+
+// Gives up on granular dirty tracking for a trait instance: every reference to it is dropped from the stores and the
+// whole instance is marked dirty.
+void NotificationEngine::IntermediateGraphSolver::FallBackToRootDirty(TraitDataSource * aDataSource, TraitDataHandle aDataHandle)
+{
+    mDirtyStore.RemoveItem(aDataHandle);
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+    mDeleteStore.RemoveItem(aDataHandle);
+#endif
+
+    aDataSource->SetRootDirty();
+    mNumRootDirtyFallbacks++;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // IntermediateGraphSolver::Store
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -112,46 +133,57 @@ NotificationEngine::IntermediateGraphSolver::Store::Store()
 {
     mNumItems = 0;
 
-    for (size_t i = 0; i < WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; i++)
+    for (size_t i = 0; i < kStoreSize; i++)
     {
         mStore[i].mPropertyPathHandle = kNullPropertyPathHandle;
         mStore[i].mTraitDataHandle    = UINT16_MAX;
         mValidFlags[i]                = false;
+        mUsedFlags[i]                 = false;
     }
 }
 
+uint32_t NotificationEngine::IntermediateGraphSolver::Store::GetHomeIndex(const TraitPath & aItem)
+{
+    return (aItem.mPropertyPathHandle * 2654435761U + aItem.mTraitDataHandle * 40503U) % kStoreSize;
+}
+
 bool NotificationEngine::IntermediateGraphSolver::Store::AddItem(TraitPath aItem)
 {
+    uint32_t index = GetHomeIndex(aItem);
+
     if (mNumItems >= WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE)
     {
         return false;
     }
 
-    for (size_t i = 0; i < WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; i++)
+    for (size_t i = 0; i < kStoreSize; i++)
     {
-        if (!mValidFlags[i])
+        if (!mValidFlags[index])
         {
-            mStore[i]      = aItem;
-            mValidFlags[i] = true;
+            mStore[index]      = aItem;
+            mValidFlags[index] = true;
+            mUsedFlags[index]  = true;
             mNumItems++;
             return true;
         }
-    }
 
-    return false;
+        index = (index + 1) % kStoreSize;
+    }
 
     // Shouldn't get here since that would imply that mNumItems and mValidFlags are out of sync
     // which should never happen unless someone mucked with the flags themselves. Continuing past
     // this point runs the risk of unpredictable behavior and so, it's better to just assert
     // at this point.
     VerifyOrDie(0);
+
+    return false;
 }
 
 void NotificationEngine::IntermediateGraphSolver::Store::RemoveItem(TraitDataHandle aDataHandle)
 {
     if (mNumItems)
     {
-        for (size_t i = 0; i < WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; i++)
+        for (size_t i = 0; i < kStoreSize; i++)
         {
             if (mValidFlags[i] && (mStore[i].mTraitDataHandle == aDataHandle))
             {
@@ -164,7 +196,7 @@ void NotificationEngine::IntermediateGraphSolver::Store::RemoveItem(TraitDataHan
 
 void NotificationEngine::IntermediateGraphSolver::Store::RemoveItemAt(uint32_t aIndex)
 {
-    if (mNumItems)
+    if (mNumItems && mValidFlags[aIndex])
     {
         mValidFlags[aIndex] = false;
         mNumItems--;
@@ -173,12 +205,17 @@ void NotificationEngine::IntermediateGraphSolver::Store::RemoveItemAt(uint32_t a
 
 bool NotificationEngine::IntermediateGraphSolver::Store::IsPresent(TraitPath aItem)
 {
-    for (size_t i = 0; i < WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; i++)
+    uint32_t index = GetHomeIndex(aItem);
+
+    // Probe from the home slot until reaching a slot that has never been used.
+    for (size_t i = 0; (i < kStoreSize) && mUsedFlags[index]; i++)
     {
-        if (mValidFlags[i] && (mStore[i] == aItem))
+        if (mValidFlags[index] && (mStore[index] == aItem))
         {
             return true;
         }
+
+        index = (index + 1) % kStoreSize;
     }
 
     return false;
@@ -228,12 +265,9 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::DeleteKey(TraitDataHand
     // existing references to this trait instance in the delete store.
     if (mDeleteStore.IsFull())
     {
-        WeaveLogDetail(DataManagement, "<ISolver:DeleteKey> No more space in granular store!");
-
-        mDeleteStore.RemoveItem(aDataHandle);
+        WeaveLogError(DataManagement, "<ISolver:DeleteKey> No more space in granular store, marking T%u root dirty", aDataHandle);
 
-        // Mark the data source is being entirely dirty.
-        dataSource->SetRootDirty();
+        FallBackToRootDirty(dataSource, aDataHandle);
     }
     else
     {
@@ -267,6 +301,8 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::SetDirty(TraitDataHandl
     SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
     TraitDataSource * dataSource;
 
+    PropertyPathHandle dictionaryItemHandle;
+
     WeaveLogDetail(DataManagement, "<ISolver:SetDirty> T%u::(%u:%u), CurDirtyItems = %u/%u", aDataHandle,
                    GetPropertyDictionaryKey(aPropertyHandle), GetPropertySchemaHandle(aPropertyHandle), mDirtyStore.GetNumItems(),
                    WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE);
@@ -283,6 +319,21 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::SetDirty(TraitDataHandl
     VerifyOrExit(!dataSource->IsRootDirty(), WeaveLogDetail(DataManagement, "<ISolver:SetDirty> Already root dirty!");
                  err = WEAVE_NO_ERROR);
 
+    // Handles outside of dictionaries are tracked in the data source's own dirty bitmap. Only dictionary elements, which
+    // carry a key, need to go into the shared store.
+    if (GetPropertyDictionaryKey(aPropertyHandle) == 0 &&
+        !dataSource->GetSchemaEngine()->IsInDictionary(aPropertyHandle, dictionaryItemHandle))
+    {
+        if (!dataSource->SetSchemaHandleDirty(GetPropertySchemaHandle(aPropertyHandle)))
+        {
+            WeaveLogError(DataManagement, "<ISolver:SetDirty> Handle %u exceeds dirty bitmap, marking root dirty",
+                          GetPropertySchemaHandle(aPropertyHandle));
+            FallBackToRootDirty(dataSource, aDataHandle);
+        }
+
+        ExitNow();
+    }
+
     // if previously present in the delete store, nothing more to be done!
     if (mDirtyStore.IsPresent(TraitPath(aDataHandle, aPropertyHandle)))
     {
@@ -294,12 +345,9 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::SetDirty(TraitDataHandl
     // existing references to this trait instance in the dirty store.
     if (mDirtyStore.IsFull())
     {
-        WeaveLogDetail(DataManagement, "<ISolver:SetDirty> No more space in granular store!");
+        WeaveLogError(DataManagement, "<ISolver:SetDirty> No more space in granular store, marking T%u root dirty", aDataHandle);
 
-        mDirtyStore.RemoveItem(aDataHandle);
-
-        // Mark the data source is being entirely dirty.
-        dataSource->SetRootDirty();
+        FallBackToRootDirty(dataSource, aDataHandle);
     }
     else
     {
@@ -338,16 +386,34 @@ exit:
 }
 
 PropertyPathHandle NotificationEngine::IntermediateGraphSolver::GetNextCandidateHandle(uint32_t & aChangeStoreCursor,
+                                                                                       const TraitDataSource * aDataSource,
                                                                                        TraitDataHandle aTargetDataHandle,
                                                                                        bool & aCandidateHandleIsDelete)
 {
     PropertyPathHandle candidateHandle = kNullPropertyPathHandle;
+    const uint32_t dirtyStoreBase      = WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES;
 
-    while (aChangeStoreCursor < mDirtyStore.GetStoreSize())
+    // The cursor first walks the data source's dirty bitmap, then the dirty store and lastly, the delete store.
+    if (aChangeStoreCursor < dirtyStoreBase)
     {
-        TraitPath dirtyPath = mDirtyStore.mStore[aChangeStoreCursor];
+        PropertySchemaHandle dirtyHandle = aDataSource->GetNextDirtySchemaHandle(aChangeStoreCursor);
 
-        if (mDirtyStore.mValidFlags[aChangeStoreCursor] && (dirtyPath.mTraitDataHandle == aTargetDataHandle))
+        if (dirtyHandle != kNullPropertyPathHandle)
+        {
+            aCandidateHandleIsDelete = false;
+            aChangeStoreCursor       = dirtyHandle + 1U;
+            return CreatePropertyPathHandle(dirtyHandle);
+        }
+
+        aChangeStoreCursor = dirtyStoreBase;
+    }
+
+    while (aChangeStoreCursor < dirtyStoreBase + mDirtyStore.GetStoreSize())
+    {
+        uint32_t index      = aChangeStoreCursor - dirtyStoreBase;
+        TraitPath dirtyPath = mDirtyStore.mStore[index];
+
+        if (mDirtyStore.mValidFlags[index] && (dirtyPath.mTraitDataHandle == aTargetDataHandle))
         {
             candidateHandle          = dirtyPath.mPropertyPathHandle;
             aCandidateHandleIsDelete = false;
@@ -359,13 +425,13 @@ PropertyPathHandle NotificationEngine::IntermediateGraphSolver::GetNextCandidate
     }
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-    while (aChangeStoreCursor >= mDirtyStore.GetStoreSize() &&
-           aChangeStoreCursor < (mDeleteStore.GetStoreSize() + mDirtyStore.GetStoreSize()))
+    while (candidateHandle == kNullPropertyPathHandle && aChangeStoreCursor >= dirtyStoreBase + mDirtyStore.GetStoreSize() &&
+           aChangeStoreCursor < (dirtyStoreBase + mDirtyStore.GetStoreSize() + mDeleteStore.GetStoreSize()))
     {
-        TraitPath deletePath = mDeleteStore.mStore[aChangeStoreCursor - mDirtyStore.GetStoreSize()];
+        uint32_t index       = aChangeStoreCursor - dirtyStoreBase - mDirtyStore.GetStoreSize();
+        TraitPath deletePath = mDeleteStore.mStore[index];
 
-        if (mDeleteStore.mValidFlags[aChangeStoreCursor - mDirtyStore.GetStoreSize()] &&
-            (deletePath.mTraitDataHandle == aTargetDataHandle))
+        if (mDeleteStore.mValidFlags[index] && (deletePath.mTraitDataHandle == aTargetDataHandle))
         {
             candidateHandle          = deletePath.mPropertyPathHandle;
             aCandidateHandleIsDelete = true;
@@ -467,8 +533,8 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::RetrieveTraitInstanceDa
         //      mergeHandleSet = set of handles that will be merged in relative to the currentCommonHandle. If empty, all children
         //                   under the commonHandle will be included.
         //
-        while ((candidateHandle = GetNextCandidateHandle(changeStoreCursor, aTraitDataHandle, candidateHandleIsDelete)) !=
-               kNullPropertyPathHandle)
+        while ((candidateHandle = GetNextCandidateHandle(changeStoreCursor, dataSource, aTraitDataHandle,
+                                                         candidateHandleIsDelete)) != kNullPropertyPathHandle)
         {
             oldCandidateHandleIsDelete = candidateHandleIsDelete;
 
@@ -703,6 +769,7 @@ void NotificationEngine::IntermediateGraphSolver::ClearTraitInstanceDirty(void *
 {
     TraitDataSource * dataSource = static_cast<TraitDataSource *>(aDataSource);
     dataSource->ClearRootDirty();
+    dataSource->ClearSchemaHandlesDirty();
 }
 
 WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::ClearDirty()
@@ -724,6 +791,7 @@ void NotificationEngine::IntermediateGraphSolver::Store::Clear()
 {
     mNumItems = 0;
     memset(mValidFlags, 0, sizeof(mValidFlags));
+    memset(mUsedFlags, 0, sizeof(mUsedFlags));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -858,6 +926,7 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
                                                            uint32_t aNumDeleteHandles)
 {
     WEAVE_ERROR err;
+    TLVType outerContainerType;
     TLVType dummyContainerType;
     TraitDataSource * dataSource;
     bool retrievingData = false;
@@ -865,7 +934,7 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
 
     VerifyOrExit(mState == kNotifyRequestBuilder_BuildDataList, err = WEAVE_ERROR_INCORRECT_STATE);
 
-    err = mWriter->StartContainer(AnonymousTag, kTLVType_Structure, dummyContainerType);
+    err = mWriter->StartContainer(AnonymousTag, kTLVType_Structure, outerContainerType);
     SuccessOrExit(err);
 
     err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(aTraitDataHandle, &dataSource);
@@ -942,7 +1011,7 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
         retrievingData = false;
     }
 
-    err = mWriter->EndContainer(kTLVType_Array);
+    err = mWriter->EndContainer(outerContainerType);
     SuccessOrExit(err);
 
 exit:
@@ -1033,6 +1102,10 @@ WEAVE_ERROR NotificationEngine::Init()
     mCurTraitInstanceIdx       = 0;
     mNumNotifiesInFlight       = 0;
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    ResetDataElementCache(false);
+#endif
+
     return WEAVE_NO_ERROR;
 }
 
@@ -1100,8 +1173,13 @@ WEAVE_ERROR NotificationEngine::RetrieveTraitInstanceData(SubscriptionHandler *
 
     *aPacketFull = false;
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    err = WriteCachedDataElement(aBuilder, aTraitInfo->mTraitDataHandle, aTraitInfo->mRequestedVersion,
+                                 aSubHandler->IsSubscribing());
+#else
     err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitInfo->mTraitDataHandle, aTraitInfo->mRequestedVersion,
                                                  aSubHandler->IsSubscribing());
+#endif
     SuccessOrExit(err);
 
     // Clear out the dirty bit since we're done processing this trait instance.
@@ -1117,6 +1195,92 @@ exit:
     return err;
 }
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+void NotificationEngine::ResetDataElementCache(bool aEnable)
+{
+    mNumCachedDataElements   = 0;
+    mDataElementCacheLen     = 0;
+    mDataElementCacheEnabled = aEnable;
+    mDataElementCacheFull    = false;
+}
+
+/**
+ *  @brief
+ *    Write the data element for a trait instance, encoding it at most once per evaluation round.
+ *
+ *  The first subscriber to need a given trait instance has the graph solver encode the data element into the cache; it and every
+ *  later subscriber with the same requested version and retrieval scope then copy the encoded bytes into their own notify. Once
+ *  the cache is full, or outside of Run(), data elements are encoded straight into the notify.
+ */
+WEAVE_ERROR NotificationEngine::WriteCachedDataElement(NotifyRequestBuilder * aBuilder, TraitDataHandle aTraitDataHandle,
+                                                       SchemaVersion aSchemaVersion, bool aRetrieveAll)
+{
+    WEAVE_ERROR err                   = WEAVE_NO_ERROR;
+    CachedDataElement * cachedElement = NULL;
+    TLVWriter * notifyWriter;
+    TLVWriter cacheWriter;
+    TLVReader reader;
+
+    VerifyOrExit(mDataElementCacheEnabled,
+                 err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitDataHandle, aSchemaVersion, aRetrieveAll));
+
+    for (uint32_t i = 0; i < mNumCachedDataElements; i++)
+    {
+        if (mCachedDataElements[i].mTraitDataHandle == aTraitDataHandle &&
+            mCachedDataElements[i].mRequestedVersion == aSchemaVersion && mCachedDataElements[i].mRetrieveAll == aRetrieveAll)
+        {
+            cachedElement = &mCachedDataElements[i];
+            break;
+        }
+    }
+
+    if (cachedElement == NULL)
+    {
+        VerifyOrExit(!mDataElementCacheFull && mNumCachedDataElements < WDM_PUBLISHER_MAX_CACHED_DATA_ELEMENTS,
+                     err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitDataHandle, aSchemaVersion, aRetrieveAll));
+
+        cacheWriter.Init(mDataElementCache + mDataElementCacheLen, sizeof(mDataElementCache) - mDataElementCacheLen);
+
+        // Have the solver write into the cache instead of the notify.
+        notifyWriter = aBuilder->GetWriter();
+        aBuilder->SetWriter(&cacheWriter);
+        err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitDataHandle, aSchemaVersion, aRetrieveAll);
+        aBuilder->SetWriter(notifyWriter);
+
+        if (err == WEAVE_ERROR_BUFFER_TOO_SMALL)
+        {
+            WeaveLogDetail(DataManagement, "<NE> Data element cache full");
+            mDataElementCacheFull = true;
+            ExitNow(err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitDataHandle, aSchemaVersion, aRetrieveAll));
+        }
+        SuccessOrExit(err);
+
+        err = cacheWriter.Finalize();
+        SuccessOrExit(err);
+
+        cachedElement                    = &mCachedDataElements[mNumCachedDataElements++];
+        cachedElement->mTraitDataHandle  = aTraitDataHandle;
+        cachedElement->mRequestedVersion = aSchemaVersion;
+        cachedElement->mRetrieveAll      = aRetrieveAll;
+        cachedElement->mOffset           = mDataElementCacheLen;
+        cachedElement->mLength           = cacheWriter.GetLengthWritten();
+
+        mDataElementCacheLen += cachedElement->mLength;
+    }
+
+    reader.Init(mDataElementCache + cachedElement->mOffset, cachedElement->mLength);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = aBuilder->GetWriter()->CopyElement(reader);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+
 WEAVE_ERROR NotificationEngine::SendNotify(PacketBuffer * aBuffer, SubscriptionHandler * aSubHandler)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -1715,10 +1879,15 @@ void NotificationEngine::Run()
 
     isLocked = true;
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    // Trait data cannot change while we hold the lock, so data elements encoded from here on can be shared across subscribers.
+    ResetDataElementCache(true);
+#endif
+
     WeaveLogDetail(DataManagement, "<NE:Run> NotifiesInFlight = %u", mNumNotifiesInFlight);
 
     while ((mNumNotifiesInFlight < WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT) &&
-           (numSubscriptionsHandled < SubscriptionEngine::kMaxNumSubscriptionHandlers))
+           (numSubscriptionsHandled < subEngine->mNumHandlers))
     {
         subscriptionHandled = true;
 
@@ -1754,7 +1923,7 @@ void NotificationEngine::Run()
             numSubscriptionsHandled = 0;
         }
 
-        mCurSubscriptionHandlerIdx = (mCurSubscriptionHandlerIdx + 1) % SubscriptionEngine::kMaxNumSubscriptionHandlers;
+        mCurSubscriptionHandlerIdx = (mCurSubscriptionHandlerIdx + 1) % subEngine->mNumHandlers;
         subHandler                 = subEngine->mHandlers + mCurSubscriptionHandlerIdx;
     }
 
@@ -1763,7 +1932,7 @@ void NotificationEngine::Run()
 
     // We only wipe our granular dirty stores if all the subscriptions are clean. To do so, we iterate over
     // all of them and check each of their dirty flags.
-    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; i++)
+    for (int i = 0; i < subEngine->mNumHandlers; i++)
     {
         if (subHandler->IsActive())
         {
@@ -1791,6 +1960,10 @@ void NotificationEngine::Run()
     }
 
 exit:
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    ResetDataElementCache(false);
+#endif
+
     if (isLocked)
     {
         subEngine->Unlock();
@@ -242,6 +242,7 @@ public:
         WEAVE_ERROR Rollback(TLV::TLVWriter & aPoint);
 
         TLV::TLVWriter * GetWriter(void) { return mWriter; }
+        void SetWriter(TLV::TLVWriter * aWriter) { mWriter = aWriter; }
 
         /**
          * The main state transition function. The function takes the desired state (i.e., the phase of the notify request builder
@@ -312,14 +313,15 @@ public:
     /*
      *  @class IntermediateGraphSolver
      *
-     *  @brief This solver is able to generate compact notifies that try to only contain the modified bits of data. This leverages a
-     *         finitely sized, global dirty store that houses granular dirty information per property handle per trait
-     *         instance. When a notify is to be generated, the solver attempts to find the LCA (lowest-common-ancestor) of all the
-     *         dirty nodes in the tree and generates a data-element against that path. In addition, it exploits the merge semantics
-     *         of WDM to only include child trees of that LCA that contain dirty elements. This is pretty efficient given the
-     *         reasonably flat, shallow structure of our IDLs.
+     *  @brief This solver is able to generate compact notifies that try to only contain the modified bits of data. Each trait
+     *         instance keeps a dirty bitmap indexed by schema handle, while handles within dictionaries are kept in a finitely
+     *         sized, global hashed store that houses granular dirty information per property handle per trait instance. When a
+     *         notify is to be generated, the solver attempts to find the LCA (lowest-common-ancestor) of all the dirty nodes in the
+     *         tree and generates a data-element against that path. In addition, it exploits the merge semantics of WDM to only
+     *         include child trees of that LCA that contain dirty elements. This is pretty efficient given the reasonably flat,
+     *         shallow structure of our IDLs.
      *
-     *         If it is unable to store anymore dirty items in the granular store, it will degrade to marking the entire trait
+     *         If it is unable to store anymore dictionary items in the granular store, it will degrade to marking the entire trait
      *         instance as dirty. In addition, if it runs out of space in the merge handle set, it will degrade to including all
      *         child trees of the LCA'ed node.
      *
@@ -327,6 +329,8 @@ public:
     class IntermediateGraphSolver
     {
     public:
+        IntermediateGraphSolver(void);
+
         static bool IsPropertyPathSupported(PropertyPathHandle aHandle);
         WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, TraitDataHandle aTraitDataHandle,
                                               SchemaVersion aSchemaVersion, bool aRetrieveAll);
@@ -338,6 +342,12 @@ public:
 
         WEAVE_ERROR ClearDirty(void);
 
+        /**
+         * Number of times a trait instance was marked entirely dirty because its granular dirty information could not be
+         * stored, each of which makes the next notify carry the whole trait instance.
+         */
+        uint32_t GetNumRootDirtyFallbacks(void) const { return mNumRootDirtyFallbacks; }
+
         struct Store
         {
         public:
@@ -348,24 +358,37 @@ public:
             bool IsPresent(TraitPath aItem);
             bool IsFull() { return mNumItems >= WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; }
             uint32_t GetNumItems() { return mNumItems; }
-            uint32_t GetStoreSize() { return WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE; }
+            uint32_t GetStoreSize() { return kStoreSize; }
             void Clear();
 
-            TraitPath mStore[WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE];
-            bool mValidFlags[WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE];
+            // The store is an open-addressed hash table that is never more than half full, keeping probe sequences short.
+            enum
+            {
+                kStoreSize = 2 * WDM_PUBLISHER_MAX_ITEMS_IN_TRAIT_DIRTY_STORE
+            };
+
+            TraitPath mStore[kStoreSize];
+            bool mValidFlags[kStoreSize];
+            bool mUsedFlags[kStoreSize]; // Slots that held an item since the last Clear(); lookups probe past them.
             uint32_t mNumItems;
+
+        private:
+            static uint32_t GetHomeIndex(const TraitPath & aItem);
         };
 
     private:
         static void ClearTraitInstanceDirty(void * aDataSource, TraitDataHandle aDataHandle, void * aContext);
-        PropertyPathHandle GetNextCandidateHandle(uint32_t & aChangeStoreCursor, TraitDataHandle aTargetDataHandle,
-                                                  bool & aCandidateHandleIsDelete);
+        void FallBackToRootDirty(TraitDataSource * aDataSource, TraitDataHandle aDataHandle);
+        PropertyPathHandle GetNextCandidateHandle(uint32_t & aChangeStoreCursor, const TraitDataSource * aDataSource,
+                                                  TraitDataHandle aTargetDataHandle, bool & aCandidateHandleIsDelete);
 
         Store mDirtyStore;
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
         Store mDeleteStore;
 #endif
+
+        uint32_t mNumRootDirtyFallbacks;
     };
 
 private:
@@ -396,6 +419,26 @@ private:
 
     WEAVE_ERROR SendNotifyRequest();
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    /*
+     * A data element encoded during the current evaluation round. The element depends only on the trait instance, the version
+     * requested by the subscriber and whether the whole instance is being retrieved, so it can be shared by every subscriber that
+     * matches all three.
+     */
+    struct CachedDataElement
+    {
+        TraitDataHandle mTraitDataHandle;
+        SchemaVersion mRequestedVersion;
+        bool mRetrieveAll;
+        uint32_t mOffset;
+        uint32_t mLength;
+    };
+
+    WEAVE_ERROR WriteCachedDataElement(NotifyRequestBuilder * aBuilder, TraitDataHandle aTraitDataHandle,
+                                       SchemaVersion aSchemaVersion, bool aRetrieveAll);
+    void ResetDataElementCache(bool aEnable);
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+
 #if WDM_ENABLE_SUBSCRIPTIONLESS_NOTIFICATION
     WEAVE_ERROR BuildSubscriptionlessNotification(PacketBuffer *msgBuf, uint32_t maxPayloadSize, TraitPath *aPathList,
                                                   uint16_t aPathListSize);
@@ -405,6 +448,15 @@ private:
     uint32_t mNumNotifiesInFlight;
     nl::Weave::TLV::TLVType mOuterContainerType;
     WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER mGraphSolver;
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    CachedDataElement mCachedDataElements[WDM_PUBLISHER_MAX_CACHED_DATA_ELEMENTS];
+    uint8_t mDataElementCache[WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE];
+    uint32_t mNumCachedDataElements;
+    uint32_t mDataElementCacheLen;
+    bool mDataElementCacheEnabled; // Only set while Run() holds the subscription engine lock.
+    bool mDataElementCacheFull;
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
 };
 
 }; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
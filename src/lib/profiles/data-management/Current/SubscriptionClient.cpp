@@ -483,7 +483,9 @@ WEAVE_ERROR SubscriptionClient::SendSubscribeRequest(void)
 
     if (IsCounterSubscriber())
     {
+        SubscriptionEngine::GetInstance()->UnindexClient(this);
         mSubscriptionId = outSubscribeParam.mSubscribeRequestPrepareNeeded.mSubscriptionId;
+        SubscriptionEngine::GetInstance()->IndexClient(this);
     }
 
     VerifyOrExit(kState_Initialized == mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
@@ -941,6 +943,7 @@ void SubscriptionClient::_AbortSubscription()
         (void) RefreshTimer();
 
         mRetryCounter = 0;
+        SubscriptionEngine::GetInstance()->UnindexClient(this);
         mSubscriptionId = 0;
 
         MoveToState(kState_Initialized);
@@ -1878,7 +1881,9 @@ void SubscriptionClient::OnMessageReceivedFromLocallyInitiatedExchange(nl::Weave
                 if (kState_Subscribing == pClient->mCurrentState)
                 {
                     // capture subscription ID
+                    SubscriptionEngine::GetInstance()->UnindexClient(pClient);
                     pClient->mSubscriptionId = subscriptionId;
+                    SubscriptionEngine::GetInstance()->IndexClient(pClient);
                 }
                 else
                 {
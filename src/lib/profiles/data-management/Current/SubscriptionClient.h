@@ -389,6 +389,10 @@ private:
     uint32_t mLivenessTimeoutMsec;
     uint64_t mSubscriptionId;
 
+    // Links of the subscription ID index kept by SubscriptionEngine, see SubscriptionEngine::IndexClient().
+    uint16_t mIndexHead;
+    uint16_t mIndexNext;
+
     // retry params
     uint32_t mRetryCounter;
 
@@ -44,7 +44,20 @@ namespace Weave {
 namespace Profiles {
 namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
 
-SubscriptionEngine::SubscriptionEngine() { }
+SubscriptionEngine::SubscriptionEngine()
+{
+#if WDM_ENABLE_SUBSCRIPTION_CLIENT
+    mClients    = mClientStorage;
+    mNumClients = kMaxNumSubscriptionClients;
+#endif // WDM_ENABLE_SUBSCRIPTION_CLIENT
+
+#if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
+    mHandlers          = mHandlerStorage;
+    mNumHandlers       = kMaxNumSubscriptionHandlers;
+    mTraitInfoPool     = mTraitInfoStorage;
+    mTraitInfoPoolSize = kMaxNumPathGroups;
+#endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
+}
 
 void SubscriptionEngine::SetEventCallback(void * const aAppState, const EventCallback aEventCallback)
 {
@@ -60,6 +73,41 @@ void SubscriptionEngine::DefaultEventHandler(EventID aEvent, const InEventParam
     WeaveLogDetail(DataManagement, "%s event: %d", __func__, aEvent);
 }
 
+size_t SubscriptionEngine::GetIndexBucket(const uint64_t aSubscriptionId, const size_t aNumBuckets)
+{
+    // Subscription IDs are mostly random, so folding the two halves together spreads them well enough.
+    return static_cast<size_t>((aSubscriptionId ^ (aSubscriptionId >> 32)) % aNumBuckets);
+}
+
+template <class T>
+void SubscriptionEngine::IndexInsert(T * const aPool, const size_t aPoolSize, T * const aItem)
+{
+    T * const bucket = aPool + GetIndexBucket(aItem->mSubscriptionId, aPoolSize);
+
+    // Links hold the position in the pool plus one, so that 0 terminates a chain.
+    aItem->mIndexNext  = bucket->mIndexHead;
+    bucket->mIndexHead = static_cast<uint16_t>(aItem - aPool + 1);
+}
+
+template <class T>
+void SubscriptionEngine::IndexRemove(T * const aPool, const size_t aPoolSize, T * const aItem)
+{
+    const uint16_t id = static_cast<uint16_t>(aItem - aPool + 1);
+    uint16_t * link   = &aPool[GetIndexBucket(aItem->mSubscriptionId, aPoolSize)].mIndexHead;
+
+    while (*link != 0)
+    {
+        if (*link == id)
+        {
+            *link             = aItem->mIndexNext;
+            aItem->mIndexNext = 0;
+            break;
+        }
+
+        link = &aPool[*link - 1].mIndexNext;
+    }
+}
+
 WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apExchangeMgr, void * const aAppState,
                                      const EventCallback aEventCallback)
 {
@@ -79,9 +127,11 @@ WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apE
         mCommandObjs[i].Init(NULL);
     }
 
-    for (size_t i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (size_t i = 0; i < mNumClients; ++i)
     {
         mClients[i].InitAsFree();
+        mClients[i].mIndexHead = 0;
+        mClients[i].mIndexNext = 0;
     }
 
 #endif // WDM_ENABLE_SUBSCRIPTION_CLIENT
@@ -90,9 +140,11 @@ WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apE
     err = mNotificationEngine.Init();
     SuccessOrExit(err);
 
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (size_t i = 0; i < mNumHandlers; ++i)
     {
         mHandlers[i].InitAsFree();
+        mHandlers[i].mIndexHead = 0;
+        mHandlers[i].mIndexNext = 0;
     }
 
     // erase everything
@@ -100,7 +152,7 @@ WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apE
 
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
-    mNumTraitInfosInPool = 0;
+    ResetTraitInfoPool();
 
 exit:
     WeaveLogFunctError(err);
@@ -116,7 +168,7 @@ void SubscriptionEngine::LogSubscriptionFreed(void) const
     uint32_t countAllocatedHandlers = 0;
 
 #if WDM_ENABLE_SUBSCRIPTION_CLIENT
-    for (int i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (int i = 0; i < mNumClients; ++i)
     {
         if (SubscriptionClient::kState_Free != mClients[i].mCurrentState)
         {
@@ -126,7 +178,7 @@ void SubscriptionEngine::LogSubscriptionFreed(void) const
 #endif // #if WDM_ENABLE_SUBSCRIPTION_CLIENT
 
 #if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
-    for (int i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (int i = 0; i < mNumHandlers; ++i)
     {
         if (SubscriptionHandler::kState_Free != mHandlers[i].mCurrentState)
         {
@@ -172,14 +224,17 @@ void SubscriptionEngine::OnCancelRequest(nl::Weave::ExchangeContext * aEC, const
     }
 
 #if WDM_ENABLE_SUBSCRIPTION_CLIENT
-    for (size_t i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (uint16_t id = pEngine->mClients[GetIndexBucket(SubscriptionId, pEngine->mNumClients)].mIndexHead; id != 0;
+         id = pEngine->mClients[id - 1].mIndexNext)
     {
-        if ((SubscriptionClient::kState_SubscriptionEstablished_Idle == pEngine->mClients[i].mCurrentState) ||
-            (SubscriptionClient::kState_SubscriptionEstablished_Confirming == pEngine->mClients[i].mCurrentState))
+        SubscriptionClient * const pClient = pEngine->mClients + id - 1;
+
+        if ((SubscriptionClient::kState_SubscriptionEstablished_Idle == pClient->mCurrentState) ||
+            (SubscriptionClient::kState_SubscriptionEstablished_Confirming == pClient->mCurrentState))
         {
-            if (pEngine->mClients[i].mSubscriptionId == SubscriptionId)
+            if (pClient->mSubscriptionId == SubscriptionId)
             {
-                pEngine->mClients[i].CancelRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
+                pClient->CancelRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
                 found = true;
                 break;
             }
@@ -188,15 +243,18 @@ void SubscriptionEngine::OnCancelRequest(nl::Weave::ExchangeContext * aEC, const
 #endif // #if WDM_ENABLE_SUBSCRIPTION_CLIENT
 
 #if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (uint16_t id = pEngine->mHandlers[GetIndexBucket(SubscriptionId, pEngine->mNumHandlers)].mIndexHead; id != 0;
+         id = pEngine->mHandlers[id - 1].mIndexNext)
     {
-        if ((pEngine->mHandlers[i].mCurrentState >= SubscriptionHandler::kState_SubscriptionInfoValid_Begin) &&
-            (pEngine->mHandlers[i].mCurrentState <= SubscriptionHandler::kState_SubscriptionInfoValid_End))
+        SubscriptionHandler * const pHandler = pEngine->mHandlers + id - 1;
+
+        if ((pHandler->mCurrentState >= SubscriptionHandler::kState_SubscriptionInfoValid_Begin) &&
+            (pHandler->mCurrentState <= SubscriptionHandler::kState_SubscriptionInfoValid_End))
         {
             // Note that there is no need to compare more than subscription ID, because it must already be unique on publisher side
-            if (pEngine->mHandlers[i].mSubscriptionId == SubscriptionId)
+            if (pHandler->mSubscriptionId == SubscriptionId)
             {
-                pEngine->mHandlers[i].CancelRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
+                pHandler->CancelRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
                 found = true;
                 break;
             }
@@ -244,7 +302,7 @@ WEAVE_ERROR SubscriptionEngine::NewClient(SubscriptionClient ** const appClient,
 
     *appClient = NULL;
 
-    for (size_t i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (size_t i = 0; i < mNumClients; ++i)
     {
         if (SubscriptionClient::kState_Free == mClients[i].mCurrentState)
         {
@@ -340,6 +398,12 @@ void SubscriptionEngine::UnsolicitedMessageHandler(nl::Weave::ExchangeContext *
         func = OnCustomCommand;
         break;
 
+#if WDM_PUBLISHER_ENABLE_VIEW
+    case kMsgType_ViewRequest:
+        func = OnViewRequest;
+        break;
+#endif // WDM_PUBLISHER_ENABLE_VIEW
+
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
 #if WDM_ENABLE_SUBSCRIPTION_CANCEL
@@ -418,15 +482,17 @@ void SubscriptionEngine::OnNotificationRequest(nl::Weave::ExchangeContext * aEC,
         WEAVE_FAULT_INJECT(FaultInjection::kFault_WDM_BadSubscriptionId, SubscriptionId += 1);
     }
 
-    for (size_t i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (uint16_t id = pEngine->mClients[GetIndexBucket(SubscriptionId, pEngine->mNumClients)].mIndexHead; id != 0;
+         id = pEngine->mClients[id - 1].mIndexNext)
     {
-        if ((SubscriptionClient::kState_SubscriptionEstablished_Idle == pEngine->mClients[i].mCurrentState) ||
-            (SubscriptionClient::kState_SubscriptionEstablished_Confirming == pEngine->mClients[i].mCurrentState))
+        SubscriptionClient * const pClient = pEngine->mClients + id - 1;
+
+        if ((SubscriptionClient::kState_SubscriptionEstablished_Idle == pClient->mCurrentState) ||
+            (SubscriptionClient::kState_SubscriptionEstablished_Confirming == pClient->mCurrentState))
         {
-            if (pEngine->mClients[i].mBinding->IsAuthenticMessageFromPeer(aMsgInfo) &&
-                pEngine->mClients[i].mSubscriptionId == SubscriptionId)
+            if (pClient->mBinding->IsAuthenticMessageFromPeer(aMsgInfo) && pClient->mSubscriptionId == SubscriptionId)
             {
-                pEngine->mClients[i].NotificationRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
+                pClient->NotificationRequestHandler(aEC, aPktInfo, aMsgInfo, aPayload);
                 aPayload = NULL;
                 aEC      = NULL;
                 ExitNow();
@@ -752,14 +818,17 @@ SubscriptionClient * SubscriptionEngine::FindClient(const uint64_t aPeerNodeId,
 {
     SubscriptionClient * result = NULL;
 
-    for (size_t i = 0; i < kMaxNumSubscriptionClients; ++i)
+    for (uint16_t id = mClients[GetIndexBucket(aSubscriptionId, mNumClients)].mIndexHead; id != 0;
+         id = mClients[id - 1].mIndexNext)
     {
-        if ((mClients[i].mCurrentState >= SubscriptionClient::kState_Subscribing_IdAssigned) &&
-            (mClients[i].mCurrentState <= SubscriptionClient::kState_SubscriptionEstablished_Confirming))
+        SubscriptionClient * const pClient = mClients + id - 1;
+
+        if ((pClient->mCurrentState >= SubscriptionClient::kState_Subscribing_IdAssigned) &&
+            (pClient->mCurrentState <= SubscriptionClient::kState_SubscriptionEstablished_Confirming))
         {
-            if ((aPeerNodeId == mClients[i].mBinding->GetPeerNodeId()) && (mClients[i].mSubscriptionId == aSubscriptionId))
+            if ((aPeerNodeId == pClient->mBinding->GetPeerNodeId()) && (pClient->mSubscriptionId == aSubscriptionId))
             {
-                result = &mClients[i];
+                result = pClient;
                 break;
             }
         }
@@ -768,6 +837,49 @@ SubscriptionClient * SubscriptionEngine::FindClient(const uint64_t aPeerNodeId,
     return result;
 }
 
+WEAVE_ERROR SubscriptionEngine::SetClientPool(SubscriptionClient * const aClients, const uint16_t aNumClients)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit((NULL != aClients) && (aNumClients > 0), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < mNumClients; ++i)
+    {
+        VerifyOrExit(SubscriptionClient::kState_Free == mClients[i].mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+    mClients    = aClients;
+    mNumClients = aNumClients;
+
+    for (size_t i = 0; i < mNumClients; ++i)
+    {
+        mClients[i].InitAsFree();
+        mClients[i].mIndexHead = 0;
+        mClients[i].mIndexNext = 0;
+    }
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+/**
+ * Add a client to the subscription ID index. Must be called once its subscription ID is assigned.
+ */
+void SubscriptionEngine::IndexClient(SubscriptionClient * const aClient)
+{
+    IndexInsert(mClients, mNumClients, aClient);
+}
+
+/**
+ * Remove a client from the subscription ID index, if present. Must be called before its subscription ID changes.
+ */
+void SubscriptionEngine::UnindexClient(SubscriptionClient * const aClient)
+{
+    IndexRemove(mClients, mNumClients, aClient);
+}
+
 bool SubscriptionEngine::UpdateClientLiveness(const uint64_t aPeerNodeId, const uint64_t aSubscriptionId, const bool aKill)
 {
     WEAVE_ERROR err              = WEAVE_NO_ERROR;
@@ -867,18 +979,74 @@ bool SubscriptionEngine::UpdateHandlerLiveness(const uint64_t aPeerNodeId, const
     return found;
 }
 
+WEAVE_ERROR SubscriptionEngine::SetHandlerPool(SubscriptionHandler * const aHandlers, const uint16_t aNumHandlers,
+                                               SubscriptionHandler::TraitInstanceInfo * const aTraitInfos,
+                                               const uint32_t aNumTraitInfos)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit((NULL != aHandlers) && (aNumHandlers > 0) && (NULL != aTraitInfos) && (aNumTraitInfos > 0),
+                 err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < mNumHandlers; ++i)
+    {
+        VerifyOrExit(SubscriptionHandler::kState_Free == mHandlers[i].mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+    mHandlers            = aHandlers;
+    mNumHandlers         = aNumHandlers;
+    mTraitInfoPool       = aTraitInfos;
+    mTraitInfoPoolSize   = aNumTraitInfos;
+    ResetTraitInfoPool();
+
+    for (size_t i = 0; i < mNumHandlers; ++i)
+    {
+        mHandlers[i].InitAsFree();
+        mHandlers[i].mIndexHead = 0;
+        mHandlers[i].mIndexNext = 0;
+    }
+
+    // The notification engine walks the handlers round-robin, so restart it on the new pool.
+    err = mNotificationEngine.Init();
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+/**
+ * Add a handler to the subscription ID index. Must be called once its subscription ID is assigned.
+ */
+void SubscriptionEngine::IndexHandler(SubscriptionHandler * const aHandler)
+{
+    IndexInsert(mHandlers, mNumHandlers, aHandler);
+}
+
+/**
+ * Remove a handler from the subscription ID index, if present. Must be called before its subscription ID changes.
+ */
+void SubscriptionEngine::UnindexHandler(SubscriptionHandler * const aHandler)
+{
+    IndexRemove(mHandlers, mNumHandlers, aHandler);
+}
+
 SubscriptionHandler * SubscriptionEngine::FindHandler(const uint64_t aPeerNodeId, const uint64_t aSubscriptionId)
 {
     SubscriptionHandler * result = NULL;
 
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (uint16_t id = mHandlers[GetIndexBucket(aSubscriptionId, mNumHandlers)].mIndexHead; id != 0;
+         id = mHandlers[id - 1].mIndexNext)
     {
-        if ((mHandlers[i].mCurrentState >= SubscriptionHandler::kState_SubscriptionInfoValid_Begin) &&
-            (mHandlers[i].mCurrentState <= SubscriptionHandler::kState_SubscriptionInfoValid_End))
+        SubscriptionHandler * const pHandler = mHandlers + id - 1;
+
+        if ((pHandler->mCurrentState >= SubscriptionHandler::kState_SubscriptionInfoValid_Begin) &&
+            (pHandler->mCurrentState <= SubscriptionHandler::kState_SubscriptionInfoValid_End))
         {
-            if ((aPeerNodeId == mHandlers[i].mBinding->GetPeerNodeId()) && (aSubscriptionId == mHandlers[i].mSubscriptionId))
+            if ((aPeerNodeId == pHandler->mBinding->GetPeerNodeId()) && (aSubscriptionId == pHandler->mSubscriptionId))
             {
-                result = &mHandlers[i];
+                result = pHandler;
                 break;
             }
         }
@@ -891,7 +1059,7 @@ WEAVE_ERROR SubscriptionEngine::GetMinEventLogPosition(size_t & outLogPosition)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    for (size_t subIdx = 0; subIdx < kMaxNumSubscriptionHandlers; ++subIdx)
+    for (size_t subIdx = 0; subIdx < mNumHandlers; ++subIdx)
     {
         const SubscriptionHandler * subHandler = &(mHandlers[subIdx]);
         if (subHandler->mCurrentState == SubscriptionHandler::kState_Free)
@@ -908,11 +1076,75 @@ WEAVE_ERROR SubscriptionEngine::GetMinEventLogPosition(size_t & outLogPosition)
     return err;
 }
 
+// A free run of trait instances links to the next free run of the same size through its first instance, whose handle and
+// requested version hold the low and high halves of the index of the next run plus one.
+static uint32_t GetNextFreeTraitInfoRun(const SubscriptionHandler::TraitInstanceInfo & aRun)
+{
+    return (static_cast<uint32_t>(aRun.mRequestedVersion) << 16) | aRun.mTraitDataHandle;
+}
+
+static void SetNextFreeTraitInfoRun(SubscriptionHandler::TraitInstanceInfo & aRun, const uint32_t aNext)
+{
+    aRun.mTraitDataHandle  = static_cast<TraitDataHandle>(aNext & 0xFFFF);
+    aRun.mRequestedVersion = static_cast<uint16_t>(aNext >> 16);
+}
+
+/**
+ * Add a trait instance to the end of a handler's list, moving the list to a run twice the size when it is full.
+ *
+ * @return A pointer to the new trait instance, or NULL if the pool has no room for it.
+ */
+SubscriptionHandler::TraitInstanceInfo * SubscriptionEngine::AllocTraitInfo(SubscriptionHandler * const aHandler)
+{
+    SubscriptionHandler::TraitInstanceInfo * run = aHandler->mTraitInstanceList;
+    const uint32_t runSize                       = (NULL != run) ? (1UL << aHandler->mTraitInstanceRunClass) : 0;
+    SubscriptionHandler::TraitInstanceInfo * traitInfo = NULL;
+
+    VerifyOrExit(aHandler->mNumTraitInstances < UINT16_MAX, );
+
+    if (NULL == run)
+    {
+        run = AllocTraitInfoRun(0);
+        VerifyOrExit(NULL != run, );
+
+        aHandler->mTraitInstanceList     = run;
+        aHandler->mTraitInstanceRunClass = 0;
+    }
+    else if (aHandler->mNumTraitInstances == runSize)
+    {
+        const uint32_t index = static_cast<uint32_t>(run - mTraitInfoPool);
+
+        if ((index + runSize == mTraitInfoPoolTail) && (mTraitInfoPoolSize - mTraitInfoPoolTail >= runSize))
+        {
+            // The run ends where the carved part of the pool does, so it can grow in place.
+            mTraitInfoPoolTail += runSize;
+        }
+        else
+        {
+            run = AllocTraitInfoRun(aHandler->mTraitInstanceRunClass + 1);
+            VerifyOrExit(NULL != run, );
+
+            memcpy(run, aHandler->mTraitInstanceList, sizeof(SubscriptionHandler::TraitInstanceInfo) * runSize);
+            FreeTraitInfoRun(aHandler->mTraitInstanceList, aHandler->mTraitInstanceRunClass);
+
+            aHandler->mTraitInstanceList = run;
+        }
+
+        ++(aHandler->mTraitInstanceRunClass);
+    }
+
+    traitInfo = aHandler->mTraitInstanceList + aHandler->mNumTraitInstances;
+    ++(aHandler->mNumTraitInstances);
+    ++mNumTraitInfosInPool;
+
+exit:
+    return traitInfo;
+}
+
 void SubscriptionEngine::ReclaimTraitInfo(SubscriptionHandler * const aHandlerToBeReclaimed)
 {
     SubscriptionHandler::TraitInstanceInfo * const traitInfoList = aHandlerToBeReclaimed->mTraitInstanceList;
     const uint16_t numTraitInstances                             = aHandlerToBeReclaimed->mNumTraitInstances;
-    size_t numTraitInstancesToBeAffected;
 
     aHandlerToBeReclaimed->mTraitInstanceList = NULL;
     aHandlerToBeReclaimed->mNumTraitInstances = 0;
@@ -927,39 +1159,96 @@ void SubscriptionEngine::ReclaimTraitInfo(SubscriptionHandler * const aHandlerTo
     WeaveLogIfFalse(traitInfoList >= mTraitInfoPool);
     WeaveLogIfFalse(numTraitInstances <= mNumTraitInfosInPool);
 
-    // mPathGroupPool + kMaxNumPathGroups is a pointer which points to the last+1byte of this array
-    // traitInfoList is a pointer to the first trait instance to be released
-    // the result of subtraction is the number of trait instances from traitInfoList to the end of this array
-    numTraitInstancesToBeAffected = (mTraitInfoPool + mNumTraitInfosInPool) - traitInfoList;
-
-    // Shrink the traitInfosInPool by the number of trait instances in this subscription.
     mNumTraitInfosInPool -= numTraitInstances;
     SYSTEM_STATS_DECREMENT_BY_N(nl::Weave::System::Stats::kWDM_NumTraits, numTraitInstances);
 
-    if (numTraitInstances == numTraitInstancesToBeAffected)
+    if (0 == mNumTraitInfosInPool)
     {
-        WeaveLogDetail(DataManagement, "Releasing the last block of trait instances");
-        ExitNow();
+        // Nothing is left in use, so start over with the whole pool uncarved.
+        ResetTraitInfoPool();
+    }
+    else
+    {
+        FreeTraitInfoRun(traitInfoList, aHandlerToBeReclaimed->mTraitInstanceRunClass);
+    }
+
+exit:
+    WeaveLogDetail(DataManagement, "Number of allocated trait instances: %u", mNumTraitInfosInPool);
+}
+
+/**
+ * Take a run of (1 << aRunClass) trait instances from the free runs of that size, from the uncarved end of the pool, or
+ * by splitting the smallest larger free run.
+ *
+ * @return A pointer to the first trait instance of the run, or NULL if there is no room for it.
+ */
+SubscriptionHandler::TraitInstanceInfo * SubscriptionEngine::AllocTraitInfoRun(const uint8_t aRunClass)
+{
+    const uint32_t runSize = 1UL << aRunClass;
+    uint8_t splitClass     = aRunClass;
+    uint32_t index;
+
+    if (aRunClass >= kNumTraitInfoRunClasses)
+    {
+        return NULL;
     }
 
-    WeaveLogDetail(DataManagement, "Moving %u trait instances forward",
-                   static_cast<unsigned int>(numTraitInstancesToBeAffected - numTraitInstances));
+    if ((0 == mFreeTraitInfoRuns[aRunClass]) && (mTraitInfoPoolSize - mTraitInfoPoolTail >= runSize))
+    {
+        index = mTraitInfoPoolTail;
+        mTraitInfoPoolTail += runSize;
 
-    memmove(traitInfoList, traitInfoList + numTraitInstances,
-            sizeof(SubscriptionHandler::TraitInstanceInfo) * (numTraitInstancesToBeAffected - numTraitInstances));
+        return mTraitInfoPool + index;
+    }
 
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    while ((splitClass < kNumTraitInfoRunClasses) && (0 == mFreeTraitInfoRuns[splitClass]))
     {
-        SubscriptionHandler * const pHandler = mHandlers + i;
+        ++splitClass;
+    }
 
-        if ((aHandlerToBeReclaimed != pHandler) && (pHandler->mTraitInstanceList > traitInfoList))
-        {
-            pHandler->mTraitInstanceList -= numTraitInstances;
-        }
+    if (splitClass >= kNumTraitInfoRunClasses)
+    {
+        return NULL;
     }
 
-exit:
-    WeaveLogDetail(DataManagement, "Number of allocated trait instances: %u", mNumTraitInfosInPool);
+    index                          = mFreeTraitInfoRuns[splitClass] - 1;
+    mFreeTraitInfoRuns[splitClass] = GetNextFreeTraitInfoRun(mTraitInfoPool[index]);
+
+    // Keep the first half of a larger run until it is the size asked for, freeing the second halves.
+    while (splitClass > aRunClass)
+    {
+        --splitClass;
+        PushFreeTraitInfoRun(index + (1UL << splitClass), splitClass);
+    }
+
+    return mTraitInfoPool + index;
+}
+
+void SubscriptionEngine::FreeTraitInfoRun(SubscriptionHandler::TraitInstanceInfo * const aRun, const uint8_t aRunClass)
+{
+    const uint32_t index = static_cast<uint32_t>(aRun - mTraitInfoPool);
+
+    if (index + (1UL << aRunClass) == mTraitInfoPoolTail)
+    {
+        mTraitInfoPoolTail = index;
+    }
+    else
+    {
+        PushFreeTraitInfoRun(index, aRunClass);
+    }
+}
+
+void SubscriptionEngine::PushFreeTraitInfoRun(const uint32_t aIndex, const uint8_t aRunClass)
+{
+    SetNextFreeTraitInfoRun(mTraitInfoPool[aIndex], mFreeTraitInfoRuns[aRunClass]);
+    mFreeTraitInfoRuns[aRunClass] = aIndex + 1;
+}
+
+void SubscriptionEngine::ResetTraitInfoPool(void)
+{
+    mNumTraitInfosInPool = 0;
+    mTraitInfoPoolTail   = 0;
+    memset(mFreeTraitInfoRuns, 0, sizeof(mFreeTraitInfoRuns));
 }
 
 WEAVE_ERROR SubscriptionEngine::EnablePublisher(IWeavePublisherLock * aLock,
@@ -1005,7 +1294,7 @@ void SubscriptionEngine::DisablePublisher()
     mIsPublisherEnabled = false;
     mPublisherCatalog   = NULL;
 
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (size_t i = 0; i < mNumHandlers; ++i)
     {
         switch (mHandlers[i].mCurrentState)
         {
@@ -1030,7 +1319,7 @@ WEAVE_ERROR SubscriptionEngine::NewSubscriptionHandler(SubscriptionHandler ** su
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_WDM_SubscriptionHandlerNew, ExitNow());
 
-    for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+    for (size_t i = 0; i < mNumHandlers; ++i)
     {
         if (SubscriptionHandler::kState_Free == mHandlers[i].mCurrentState)
         {
@@ -1124,7 +1413,7 @@ void SubscriptionEngine::OnSubscribeRequest(nl::Weave::ExchangeContext * aEC, co
         if (outParam.mIncomingSubscribeRequest.mAutoClosePriorSubscription)
         {
             // if not rejected, default behavior is to abort any prior communication with this node id
-            for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
+            for (size_t i = 0; i < pEngine->mNumHandlers; ++i)
             {
                 if ((pEngine->mHandlers[i].mCurrentState >= SubscriptionHandler::kState_SubscriptionInfoValid_Begin) &&
                     (pEngine->mHandlers[i].mCurrentState <= SubscriptionHandler::kState_SubscriptionInfoValid_End))
@@ -1501,6 +1790,68 @@ exit:
 }
 #endif // WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
 
+#if WDM_PUBLISHER_ENABLE_VIEW
+void SubscriptionEngine::OnViewRequest(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
+                                       const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
+                                       PacketBuffer * aPayload)
+{
+    WEAVE_ERROR err                    = WEAVE_NO_ERROR;
+    SubscriptionEngine * const pEngine = reinterpret_cast<SubscriptionEngine *>(aEC->AppState);
+    ViewHandler * handler              = NULL;
+    uint32_t statusReportProfile       = nl::Weave::Profiles::kWeaveProfile_Common;
+    uint16_t statusReportCode          = nl::Weave::Profiles::Common::kStatus_OutOfMemory;
+
+    if (!pEngine->mIsPublisherEnabled)
+    {
+        statusReportCode = nl::Weave::Profiles::Common::kStatus_UnsupportedMessage;
+        ExitNow(err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+    }
+
+    for (size_t i = 0; i < kMaxNumViewHandlers; ++i)
+    {
+        if (pEngine->mViewHandlers[i].IsFree())
+        {
+            handler = &(pEngine->mViewHandlers[i]);
+            break;
+        }
+    }
+    VerifyOrExit(NULL != handler, err = WEAVE_ERROR_NO_MEMORY);
+
+    // The handler owns the exchange and the request from here on, and releases both when it is done.
+    err = handler->Init(aEC, aPayload);
+    aEC      = NULL;
+    aPayload = NULL;
+
+    if (WEAVE_NO_ERROR == err)
+    {
+        err = handler->SendResponse();
+    }
+
+    if (WEAVE_NO_ERROR != err)
+    {
+        handler->HandleError(err);
+    }
+
+exit:
+    WeaveLogFunctError(err);
+
+    if (NULL != aPayload)
+    {
+        PacketBuffer::Free(aPayload);
+        aPayload = NULL;
+    }
+
+    if (NULL != aEC)
+    {
+        err = SendStatusReport(aEC, statusReportProfile, statusReportCode);
+        WeaveLogFunctError(err);
+
+        aEC->Close();
+        aEC = NULL;
+    }
+}
+#endif // WDM_PUBLISHER_ENABLE_VIEW
+
 #endif // #if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
 }; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
@@ -34,6 +34,7 @@
 #include <Weave/Profiles/data-management/SubscriptionHandler.h>
 #include <Weave/Profiles/data-management/NotificationEngine.h>
 #include <Weave/Profiles/data-management/Command.h>
+#include <Weave/Profiles/data-management/ViewHandler.h>
 
 namespace nl {
 namespace Weave {
@@ -256,6 +257,21 @@ public:
 
     WEAVE_ERROR NewSubscriptionHandler(SubscriptionHandler ** const subHandler);
 
+    /**
+     * @brief Replace the pool of subscription clients.
+     *
+     * By default, the engine uses a pool of #WDM_MAX_NUM_SUBSCRIPTION_CLIENTS clients embedded in it. This lets the application
+     * size the pool at runtime instead. The storage must outlive the engine. All clients in the current pool must be free.
+     *
+     * @param[in]  aClients         A pointer to the array of clients to use
+     * @param[in]  aNumClients      The number of clients in aClients
+     *
+     * @retval #WEAVE_NO_ERROR                  On success.
+     * @retval #WEAVE_ERROR_INVALID_ARGUMENT    If the pool is empty.
+     * @retval #WEAVE_ERROR_INCORRECT_STATE     If a client in the current pool is in use.
+     */
+    WEAVE_ERROR SetClientPool(SubscriptionClient * const aClients, const uint16_t aNumClients);
+
     uint16_t GetClientId(const SubscriptionClient * const apClient) const;
 
     SubscriptionClient * FindClient(const uint64_t aPeerNodeId, const uint64_t aSubscriptionId);
@@ -283,6 +299,29 @@ public:
     // After this call returns, it's free to tear down the current publisher catalog
     void DisablePublisher(void);
 
+    /**
+     * @brief Replace the pools of subscription handlers and of their trait instances.
+     *
+     * By default, the engine uses a pool of #WDM_MAX_NUM_SUBSCRIPTION_HANDLERS handlers sharing
+     * #WDM_PUBLISHER_MAX_NUM_PATH_GROUPS trait instances, all embedded in it. This lets the application size the pools at
+     * runtime instead, e.g. for a service with many subscribers. The storage must outlive the engine. All handlers in the
+     * current pool must be free.
+     *
+     * Each handler takes its trait instances from the pool as one run, whose size is the number of traits it subscribes
+     * to rounded up to a power of two.
+     *
+     * @param[in]  aHandlers        A pointer to the array of handlers to use
+     * @param[in]  aNumHandlers     The number of handlers in aHandlers
+     * @param[in]  aTraitInfos      A pointer to the array of trait instances shared by the handlers
+     * @param[in]  aNumTraitInfos   The number of trait instances in aTraitInfos
+     *
+     * @retval #WEAVE_NO_ERROR                  On success.
+     * @retval #WEAVE_ERROR_INVALID_ARGUMENT    If either pool is empty.
+     * @retval #WEAVE_ERROR_INCORRECT_STATE     If a handler in the current pool is in use.
+     */
+    WEAVE_ERROR SetHandlerPool(SubscriptionHandler * const aHandlers, const uint16_t aNumHandlers,
+                               SubscriptionHandler::TraitInstanceInfo * const aTraitInfos, const uint32_t aNumTraitInfos);
+
     SubscriptionHandler * FindHandler(const uint64_t aPeerNodeId, const uint64_t aSubscriptionId);
 
     bool UpdateHandlerLiveness(const uint64_t aPeerNodeId, const uint64_t aSubscriptionId, const bool aKill = false);
@@ -309,6 +348,7 @@ private:
     friend class SubscriptionHandler;
     friend class SubscriptionClient;
     friend class NotificationEngine;
+    friend class ViewHandler;
     friend class TestTdm;
     friend class TestWdm;
 
@@ -322,6 +362,16 @@ private:
 
     static WEAVE_ERROR SendStatusReport(nl::Weave::ExchangeContext * aEC, uint32_t aProfileId, uint16_t aStatusCode);
 
+    // Clients and handlers are indexed by subscription ID. The index is a chained hash table whose bucket heads and links are
+    // threaded through the pool itself, so it scales with the pool without any additional storage.
+    static size_t GetIndexBucket(const uint64_t aSubscriptionId, const size_t aNumBuckets);
+
+    template <class T>
+    static void IndexInsert(T * const aPool, const size_t aPoolSize, T * const aItem);
+
+    template <class T>
+    static void IndexRemove(T * const aPool, const size_t aPoolSize, T * const aItem);
+
     static void UnsolicitedMessageHandler(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
                                           const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
                                           PacketBuffer * aPayload);
@@ -360,7 +410,12 @@ private:
 #if WDM_ENABLE_SUBSCRIPTION_CLIENT
     // Client-specific features
 
-    SubscriptionClient mClients[kMaxNumSubscriptionClients];
+    SubscriptionClient * mClients;
+    uint16_t mNumClients;
+    SubscriptionClient mClientStorage[kMaxNumSubscriptionClients];
+
+    void IndexClient(SubscriptionClient * const aClient);
+    void UnindexClient(SubscriptionClient * const aClient);
 
     static void OnNotificationRequest(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
                                       const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
@@ -384,33 +439,61 @@ private:
     {
         kMaxNumSubscriptionHandlers = (WDM_MAX_NUM_SUBSCRIPTION_HANDLERS),
         kMaxNumPathGroups           = (WDM_PUBLISHER_MAX_NUM_PATH_GROUPS),
+        kNumTraitInfoRunClasses     = 17, //< Trait instance runs hold 1, 2, 4 ... 65536 instances, enough for any handler
         kMaxNumPropertyPathHandles  = (WDM_PUBLISHER_MAX_NUM_PROPERTY_PATH_HANDLES),
         kMaxNumCommandObjs          = (WDM_MAX_NUM_COMMAND_OBJECTS), //< Max number of command objects this engine can accommodate
+#if WDM_PUBLISHER_ENABLE_VIEW
+        kMaxNumViewHandlers         = (WDM_PUBLISHER_MAX_NUM_VIEW_HANDLERS), //< Max number of view requests served at the same time
+#endif // WDM_PUBLISHER_ENABLE_VIEW
     };
 
     Command mCommandObjs[kMaxNumCommandObjs];
 
+#if WDM_PUBLISHER_ENABLE_VIEW
+    ViewHandler mViewHandlers[kMaxNumViewHandlers];
+#endif // WDM_PUBLISHER_ENABLE_VIEW
+
     // Lock
     IWeavePublisherLock * mLock;
 
     // ******************* begin protected by lock **************************
     bool mIsPublisherEnabled;
-    SubscriptionHandler mHandlers[kMaxNumSubscriptionHandlers];
+    SubscriptionHandler * mHandlers;
+    uint16_t mNumHandlers;
     TraitCatalogBase<TraitDataSource> * mPublisherCatalog;
     NotificationEngine mNotificationEngine;
 
     // used for fairness
     uint16_t mNextHandlerToNotify;
 
-    uint16_t mNumTraitInfosInPool;
-    SubscriptionHandler::TraitInstanceInfo mTraitInfoPool[kMaxNumPathGroups];
+    uint32_t mNumTraitInfosInPool;
+    uint32_t mTraitInfoPoolSize;
+    SubscriptionHandler::TraitInstanceInfo * mTraitInfoPool;
+
+    // Each handler holds its trait instances in a run of a power-of-two number of them, see AllocTraitInfo(). Runs are
+    // carved from the pool up to mTraitInfoPoolTail, and freed runs are kept on a list per size, headed by the index of
+    // their first instance plus one.
+    uint32_t mTraitInfoPoolTail;
+    uint32_t mFreeTraitInfoRuns[kNumTraitInfoRunClasses];
 
     uint16_t mNumOfPropertyPathHandlesAllocated;
     // PropertyPathHandle mPropertyPathHandlePool[kMaxNumPropertyPathHandles];
     // ******************* end protected by lock   **************************
 
+    SubscriptionHandler mHandlerStorage[kMaxNumSubscriptionHandlers];
+    SubscriptionHandler::TraitInstanceInfo mTraitInfoStorage[kMaxNumPathGroups];
+
+    SubscriptionHandler::TraitInstanceInfo * AllocTraitInfo(SubscriptionHandler * const aHandler);
     void ReclaimTraitInfo(SubscriptionHandler * const aHandlerToBeReclaimed);
 
+    SubscriptionHandler::TraitInstanceInfo * AllocTraitInfoRun(const uint8_t aRunClass);
+    void FreeTraitInfoRun(SubscriptionHandler::TraitInstanceInfo * const aRun, const uint8_t aRunClass);
+    void PushFreeTraitInfoRun(const uint32_t aIndex, const uint8_t aRunClass);
+    void ResetTraitInfoPool(void);
+
+    void IndexHandler(SubscriptionHandler * const aHandler);
+    void UnindexHandler(SubscriptionHandler * const aHandler);
+
     static void OnSubscribeRequest(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
                                    const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
                                    PacketBuffer * aPayload);
@@ -426,6 +509,12 @@ private:
 
 #endif // WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
 
+#if WDM_PUBLISHER_ENABLE_VIEW
+    static void OnViewRequest(nl::Weave::ExchangeContext * aEC, const nl::Inet::IPPacketInfo * aPktInfo,
+                              const nl::Weave::WeaveMessageInfo * aMsgInfo, uint32_t aProfileId, uint8_t aMsgType,
+                              PacketBuffer * aPayload);
+#endif // WDM_PUBLISHER_ENABLE_VIEW
+
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 };
 
@@ -69,6 +69,7 @@ void SubscriptionHandler::InitAsFree()
     mIsInitiator                   = false;
     mTraitInstanceList             = NULL;
     mNumTraitInstances             = 0;
+    mTraitInstanceRunClass         = 0;
     mMaxNotificationSize           = 0;
     mSubscribeToAllEvents          = false;
     mCurProcessingTraitInstanceIdx = 0;
@@ -333,12 +334,10 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
             // allocate a new trait instance
             WEAVE_FAULT_INJECT(FaultInjection::kFault_WDM_TraitInstanceNew, SuccessOrExit(err = WEAVE_ERROR_NO_MEMORY));
 
-            if (SubscriptionEngine::GetInstance()->mNumTraitInfosInPool < SubscriptionEngine::kMaxNumPathGroups)
+            traitInstance = SubscriptionEngine::GetInstance()->AllocTraitInfo(this);
+
+            if (NULL != traitInstance)
             {
-                traitInstance =
-                    SubscriptionEngine::GetInstance()->mTraitInfoPool + SubscriptionEngine::GetInstance()->mNumTraitInfosInPool;
-                ++mNumTraitInstances;
-                ++(SubscriptionEngine::GetInstance()->mNumTraitInfosInPool);
                 SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kWDM_NumTraits);
 
                 traitInstance->Init();
@@ -356,13 +355,6 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
         traitInstance->mTraitDataHandle  = traitDataHandle;
         traitInstance->mRequestedVersion = computedForwardRequestedVersion;
 
-        if (NULL == mTraitInstanceList)
-        {
-            // this the first trait instance for this subscription
-            // mNumTraitInstanceList has already be incremented
-            mTraitInstanceList = traitInstance;
-        }
-
         if (!IsVersionListPresent)
         {
             // no existing version
@@ -670,6 +662,9 @@ void SubscriptionHandler::InitWithIncomingRequest(Binding * const aBinding, cons
     err = ParseSubscriptionId(request, RejectReasonProfileId, RejectReasonStatusCode, aRandomNumber);
     SuccessOrExit(err);
 
+    // The subscription ID is final from here on. The handler is indexed exactly once; Abort() removes it again.
+    SubscriptionEngine::GetInstance()->IndexHandler(this);
+
     // Third stage: path, version, and events
     err = ParsePathVersionEventLists(request, RejectReasonProfileId, RejectReasonStatusCode);
     SuccessOrExit(err);
@@ -1194,6 +1189,7 @@ void SubscriptionHandler::AbortSubscription()
 
         FlushExistingExchangeContext(true);
         mLivenessTimeoutMsec           = kNoTimeout;
+        SubscriptionEngine::GetInstance()->UnindexHandler(this);
         mPeerNodeId                    = 0;
         mSubscriptionId                = 0;
         mIsInitiator                   = false;
@@ -243,8 +243,13 @@ private:
     uint64_t mSubscriptionId;
     Binding * mBinding;
 
+    // Links of the subscription ID index kept by SubscriptionEngine, see SubscriptionEngine::IndexHandler().
+    uint16_t mIndexHead;
+    uint16_t mIndexNext;
+
     TraitInstanceInfo * mTraitInstanceList;
     uint16_t mNumTraitInstances;
+    uint8_t mTraitInstanceRunClass; //< mTraitInstanceList is a run of (1 << mTraitInstanceRunClass) trait instances
     uint16_t mMaxNotificationSize;
     uint32_t mCurProcessingTraitInstanceIdx;
 
@@ -32,6 +32,8 @@
 #define __STDC_LIMIT_MACROS
 #endif
 
+#include <string.h>
+
 #include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
 #include <Weave/Profiles/data-management/DataManagement.h>
 #include <Weave/Support/WeaveFaultInjection.h>
@@ -1134,6 +1136,7 @@ TraitDataSource::TraitDataSource(const TraitSchemaEngine * aEngine)
 
 #if (WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER == IntermediateGraphSolver)
     ClearRootDirty();
+    ClearSchemaHandlesDirty();
 #endif
 }
 
@@ -1238,6 +1241,62 @@ void TraitDataSource::SetDirty(PropertyPathHandle aPropertyHandle)
     }
 }
 
+#if (WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER == IntermediateGraphSolver)
+/**
+ * Mark a schema handle of this data source as dirty.
+ *
+ * @retval true  The handle is marked dirty.
+ * @retval false The handle is beyond #WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES and cannot be tracked individually.
+ */
+bool TraitDataSource::SetSchemaHandleDirty(PropertySchemaHandle aHandle)
+{
+    if (aHandle >= WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES)
+    {
+        return false;
+    }
+
+    mDirtySchemaHandles[aHandle / 32] |= (1U << (aHandle % 32));
+    return true;
+}
+
+bool TraitDataSource::IsSchemaHandleDirty(PropertySchemaHandle aHandle) const
+{
+    return (aHandle < WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES) && (mDirtySchemaHandles[aHandle / 32] & (1U << (aHandle % 32)));
+}
+
+/**
+ * Find the first dirty schema handle that is no less than aHandle.
+ *
+ * @return The dirty handle, or kNullPropertyPathHandle if there is none.
+ */
+PropertySchemaHandle TraitDataSource::GetNextDirtySchemaHandle(PropertySchemaHandle aHandle) const
+{
+    uint32_t i = aHandle / 32;
+    uint32_t word;
+
+    if (aHandle >= WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES)
+    {
+        return kNullPropertyPathHandle;
+    }
+
+    // Skip over the words without dirty handles.
+    for (word = mDirtySchemaHandles[i] & (UINT32_MAX << (aHandle % 32)); word == 0; word = mDirtySchemaHandles[i])
+    {
+        if (++i >= ArraySize(mDirtySchemaHandles))
+        {
+            return kNullPropertyPathHandle;
+        }
+    }
+
+    return static_cast<PropertySchemaHandle>(i * 32 + __builtin_ctz(word));
+}
+
+void TraitDataSource::ClearSchemaHandlesDirty(void)
+{
+    memset(mDirtySchemaHandles, 0, sizeof(mDirtySchemaHandles));
+}
+#endif // (WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER == IntermediateGraphSolver)
+
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 void TraitDataSource::DeleteKey(PropertyPathHandle aPropertyHandle)
 {
@@ -865,6 +865,14 @@ public:
     void ClearRootDirty(void) { mRootIsDirty = false; }
     bool IsRootDirty(void) const { return mRootIsDirty; }
     bool mRootIsDirty;
+
+    /* Set of functions to be called by the intermediate graph solver to track the dirtiness of individual schema handles in this
+     * data source, one bit per handle */
+    bool SetSchemaHandleDirty(PropertySchemaHandle aHandle);
+    bool IsSchemaHandleDirty(PropertySchemaHandle aHandle) const;
+    PropertySchemaHandle GetNextDirtySchemaHandle(PropertySchemaHandle aHandle) const;
+    void ClearSchemaHandlesDirty(void);
+    uint32_t mDirtySchemaHandles[(WDM_PUBLISHER_MAX_DIRTY_SCHEMA_HANDLES + 31) / 32];
 #endif
 
 protected: // IGetDataDelegate
@@ -328,6 +328,7 @@ void ViewClient::OnMessageReceived(nl::Weave::ExchangeContext * aEC, const nl::I
     ViewClient * pViewClient   = reinterpret_cast<ViewClient *>(aEC->AppState);
     void * const pAppState     = pViewClient->mAppState;
     EventCallback CallbackFunc = pViewClient->mEventCallback;
+    bool moreChunks            = false;
     EventParam Param;
 
     VerifyOrExit((kMode_DataSink == pViewClient->mCurrentMode) || (kMode_WithoutDataSink == pViewClient->mCurrentMode),
@@ -359,6 +360,22 @@ void ViewClient::OnMessageReceived(nl::Weave::ExchangeContext * aEC, const nl::I
         err = reader.EnterContainer(dummyContainerType);
         SuccessOrExit(err);
 
+        {
+            // Every chunk of a chunked response but the last one carries the MoreChunkedMessages flag
+            nl::Weave::TLV::TLVReader flagReader;
+            flagReader.Init(reader);
+
+            while (WEAVE_NO_ERROR == flagReader.Next())
+            {
+                if (nl::Weave::TLV::ContextTag(ViewResponse::kCsTag_MoreChunkedMessages) == flagReader.GetTag())
+                {
+                    err = flagReader.Get(moreChunks);
+                    SuccessOrExit(err);
+                    break;
+                }
+            }
+        }
+
         err = reader.Next();
         SuccessOrExit(err);
 
@@ -505,6 +522,12 @@ void ViewClient::OnMessageReceived(nl::Weave::ExchangeContext * aEC, const nl::I
         err = reader.ExitContainer(dummyContainerType);
         SuccessOrExit(err);
 
+        if (moreChunks)
+        {
+            // Keep the exchange open for the rest of the response
+            ExitNow();
+        }
+
         pViewClient->Cancel();
 
         Param.mViewResponseConsumedEventParam.mMessage = aPayload;
@@ -523,7 +546,10 @@ exit:
 
     // aEC should be the same as pViewClient->mEC and be closed in InternalCancel
     // If they are not the same, we're in big trouble
-    pViewClient->Cancel();
+    if (!moreChunks || (WEAVE_NO_ERROR != err))
+    {
+        pViewClient->Cancel();
+    }
     aEC = NULL;
 
     if (NULL != aPayload)
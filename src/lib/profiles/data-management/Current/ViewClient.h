@@ -57,10 +57,12 @@ public:
         kEvent_AboutToSendRequest = 2,
 
         // Response just arrived, mEC is valid
+        // A response split into chunks raises this event once per chunk
         kEvent_ViewResponseReceived = 3,
 
         // Cancel is already called when this callback happens
         // Response processing has been completed, InternalCancel will be called upon return
+        // A response split into chunks raises this event only after the last chunk
         kEvent_ViewResponseConsumed = 4,
 
         // Cancel is already called when this callback happens
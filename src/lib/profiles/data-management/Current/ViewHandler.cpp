@@ -0,0 +1,607 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements view handler, which serves view requests on
+ *      the publisher side of Weave Data Management (WDM) profile.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif // __STDC_FORMAT_MACROS
+
+#include <Weave/Profiles/WeaveProfiles.h>
+#include <Weave/Profiles/common/CommonProfile.h>
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+#include <Weave/Profiles/data-management/DataManagement.h>
+#include <Weave/Core/WeaveServerBase.h>
+
+#if WDM_ENABLE_SUBSCRIPTION_PUBLISHER && WDM_PUBLISHER_ENABLE_VIEW
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+using namespace nl::Weave::TLV;
+
+ViewHandler::ViewHandler(void) : mEC(NULL), mRequest(NULL)
+{
+    Close();
+}
+
+/**
+ * Take ownership of an incoming view request and the exchange it arrived on.
+ *
+ * All paths in the request are resolved against the publisher catalog before anything is sent, so a request with
+ * an unknown path is rejected as a whole.  The handler is released, and the exchange closed, once the response has
+ * been sent or has failed.
+ */
+WEAVE_ERROR ViewHandler::Init(nl::Weave::ExchangeContext * aEC, PacketBuffer * aRequest)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVReader reader;
+    TLVReader pathReader;
+    TLVType dummyContainerType;
+    PathList::Parser pathList;
+    TraitDataHandle traitDataHandle;
+    PropertyPathHandle propertyPathHandle;
+    SchemaVersion schemaVersion;
+
+    mEC      = aEC;
+    mRequest = aRequest;
+
+    if (NULL != mEC)
+    {
+        mEC->AppState = this;
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+        mEC->OnAckRcvd   = OnAckReceived;
+        mEC->OnSendError = OnSendError;
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    }
+
+    reader.Init(mRequest);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    VerifyOrExit(kTLVType_Structure == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    err = reader.EnterContainer(dummyContainerType);
+    SuccessOrExit(err);
+
+    while (WEAVE_NO_ERROR == (err = reader.Next()))
+    {
+        if (ContextTag(ViewRequest::kCsTag_PathList) == reader.GetTag())
+        {
+            break;
+        }
+    }
+    VerifyOrExit(WEAVE_NO_ERROR == err, err = WEAVE_ERROR_INVALID_PATH_LIST);
+
+    err = pathList.Init(reader);
+    SuccessOrExit(err);
+
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+    err = pathList.CheckSchemaValidity();
+    SuccessOrExit(err);
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+
+    pathList.GetReader(&mPathListIterator);
+
+    pathList.GetReader(&pathReader);
+    while (WEAVE_NO_ERROR == (err = pathReader.Next()))
+    {
+        err = ResolvePath(pathReader, traitDataHandle, propertyPathHandle, schemaVersion);
+        SuccessOrExit(err);
+    }
+    VerifyOrExit(WEAVE_END_OF_TLV == err, );
+
+    err = MoveToNextPath();
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+/**
+ * Release the request and the exchange, returning the handler to the pool.
+ */
+void ViewHandler::Close(void)
+{
+    if (NULL != mEC)
+    {
+        mEC->Close();
+        mEC = NULL;
+    }
+
+    if (NULL != mRequest)
+    {
+        PacketBuffer::Free(mRequest);
+        mRequest = NULL;
+    }
+
+    mHasCurrentPath     = false;
+    mTraitDataHandle    = 0;
+    mPropertyPathHandle = kNullPropertyPathHandle;
+    mSchemaVersion      = 0;
+    mNextChildHandle    = kNullPropertyPathHandle;
+    mSplitVersion       = 0;
+}
+
+WEAVE_ERROR ViewHandler::ResolvePath(const TLVReader & aPathReader, TraitDataHandle & aTraitDataHandle,
+                                     PropertyPathHandle & aPropertyPathHandle, SchemaVersion & aSchemaVersion)
+{
+    WEAVE_ERROR err                              = WEAVE_NO_ERROR;
+    TraitCatalogBase<TraitDataSource> * pCatalog = SubscriptionEngine::GetInstance()->mPublisherCatalog;
+    TraitDataSource * dataSource;
+    TLVReader pathReader;
+    SchemaVersionRange requestedSchemaVersionRange, computedVersionIntersection;
+
+    pathReader.Init(aPathReader);
+
+    err = pCatalog->AddressToHandle(pathReader, aTraitDataHandle, requestedSchemaVersionRange);
+    SuccessOrExit(err);
+
+    err = pCatalog->Locate(aTraitDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    VerifyOrExit(dataSource->GetSchemaEngine()->GetVersionIntersection(requestedSchemaVersionRange, computedVersionIntersection),
+                 err = WEAVE_ERROR_INCOMPATIBLE_SCHEMA_VERSION);
+
+    aSchemaVersion = dataSource->GetSchemaEngine()->GetHighestForwardVersion(computedVersionIntersection.mMaxVersion);
+
+    err = dataSource->GetSchemaEngine()->MapPathToHandle(pathReader, aPropertyPathHandle);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR ViewHandler::MoveToNextPath(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    mNextChildHandle = kNullPropertyPathHandle;
+
+    err = mPathListIterator.Next();
+    if (WEAVE_END_OF_TLV == err)
+    {
+        mHasCurrentPath = false;
+        ExitNow(err = WEAVE_NO_ERROR);
+    }
+    SuccessOrExit(err);
+
+    err = ResolvePath(mPathListIterator, mTraitDataHandle, mPropertyPathHandle, mSchemaVersion);
+    SuccessOrExit(err);
+
+    mHasCurrentPath = true;
+
+exit:
+    return err;
+}
+
+/**
+ * Start sending the current path as one data element per child property.  Only structures outside of dictionaries
+ * can be split this way; the data of a leaf, a dictionary or a dictionary item has to fit in a single message.
+ */
+WEAVE_ERROR ViewHandler::StartSplit(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TraitDataSource * dataSource;
+    const TraitSchemaEngine * schemaEngine;
+    PropertyPathHandle dictionaryItemHandle;
+
+    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(mTraitDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    schemaEngine = dataSource->GetSchemaEngine();
+
+    VerifyOrExit(!schemaEngine->IsLeaf(mPropertyPathHandle) && !schemaEngine->IsDictionary(mPropertyPathHandle) &&
+                     !schemaEngine->IsInDictionary(mPropertyPathHandle, dictionaryItemHandle),
+                 err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    mNextChildHandle = schemaEngine->GetFirstChild(mPropertyPathHandle);
+    VerifyOrExit(kNullPropertyPathHandle != mNextChildHandle, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    mSplitVersion = dataSource->GetVersion();
+
+    WeaveLogDetail(DataManagement, "<VH> Splitting path 0x%08x of trait %u", mPropertyPathHandle, mTraitDataHandle);
+
+exit:
+    return err;
+}
+
+/**
+ * Encode the next chunk of the view response into @a aBuf.
+ *
+ * @param[in]   aBuf            The buffer to encode the chunk into.
+ * @param[in]   aMaxPayloadSize The maximum size of the encoded chunk.
+ * @param[out]  aMoreChunks     Set to true if part of the response remains to be sent after this chunk.
+ *
+ * @retval WEAVE_ERROR_BUFFER_TOO_SMALL if a single property does not fit in a chunk.
+ * @retval WEAVE_ERROR_WDM_VERSION_MISMATCH if a split path changed in between chunks.
+ */
+WEAVE_ERROR ViewHandler::BuildResponse(PacketBuffer * aBuf, const uint32_t aMaxPayloadSize, bool & aMoreChunks)
+{
+    WEAVE_ERROR err          = WEAVE_NO_ERROR;
+    uint32_t numDataElements = 0;
+    TLVWriter writer;
+    TLVType responseContainerType, dataListContainerType;
+    TraitDataSource * dataSource;
+    bool written;
+
+    aMoreChunks = false;
+
+    writer.Init(aBuf, aMaxPayloadSize);
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, responseContainerType);
+    SuccessOrExit(err);
+
+    err = writer.StartContainer(ContextTag(ViewResponse::kCsTag_DataList), kTLVType_Array, dataListContainerType);
+    SuccessOrExit(err);
+
+    while (mHasCurrentPath)
+    {
+        if (kNullPropertyPathHandle == mNextChildHandle)
+        {
+            err = TryWriteDataElement(writer, aMaxPayloadSize, mPropertyPathHandle, false, written);
+            SuccessOrExit(err);
+
+            if (written)
+            {
+                ++numDataElements;
+
+                err = MoveToNextPath();
+                SuccessOrExit(err);
+
+                continue;
+            }
+
+            if (numDataElements > 0)
+            {
+                aMoreChunks = true;
+                break;
+            }
+
+            // The path does not fit even in an empty chunk.
+            err = StartSplit();
+            SuccessOrExit(err);
+        }
+        else
+        {
+            err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(mTraitDataHandle, &dataSource);
+            SuccessOrExit(err);
+
+            // The elements of a split path form one change, which cannot straddle two versions of the trait.
+            VerifyOrExit(dataSource->GetVersion() == mSplitVersion, err = WEAVE_ERROR_WDM_VERSION_MISMATCH);
+        }
+
+        {
+            PropertyPathHandle childHandle = mNextChildHandle;
+            PropertyPathHandle nextChildHandle;
+
+            err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(mTraitDataHandle, &dataSource);
+            SuccessOrExit(err);
+
+            nextChildHandle = dataSource->GetSchemaEngine()->GetNextChild(mPropertyPathHandle, childHandle);
+
+            err = TryWriteDataElement(writer, aMaxPayloadSize, childHandle, (kNullPropertyPathHandle != nextChildHandle),
+                                      written);
+            SuccessOrExit(err);
+
+            if (!written)
+            {
+                VerifyOrExit(numDataElements > 0, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+                aMoreChunks = true;
+                break;
+            }
+
+            ++numDataElements;
+
+            mNextChildHandle = nextChildHandle;
+            if (kNullPropertyPathHandle == mNextChildHandle)
+            {
+                err = MoveToNextPath();
+                SuccessOrExit(err);
+            }
+        }
+    }
+
+    err = writer.EndContainer(dataListContainerType);
+    SuccessOrExit(err);
+
+    if (aMoreChunks)
+    {
+        err = writer.PutBoolean(ContextTag(ViewResponse::kCsTag_MoreChunkedMessages), true);
+        SuccessOrExit(err);
+    }
+
+    err = writer.EndContainer(responseContainerType);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+/**
+ * Write a data element if it fits in the chunk together with the response trailer, otherwise leave the writer
+ * untouched and clear @a aWritten.
+ */
+WEAVE_ERROR ViewHandler::TryWriteDataElement(TLVWriter & aWriter, const uint32_t aMaxPayloadSize,
+                                             const PropertyPathHandle aPropertyPathHandle, const bool aIsPartialChange,
+                                             bool & aWritten)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVWriter checkpoint;
+
+    checkpoint = aWriter;
+    aWritten   = false;
+
+    err = WriteDataElement(aWriter, aPropertyPathHandle, aIsPartialChange);
+    if ((WEAVE_ERROR_BUFFER_TOO_SMALL == err) || (WEAVE_ERROR_NO_MEMORY == err) ||
+        ((WEAVE_NO_ERROR == err) && (aWriter.GetLengthWritten() + kResponseTrailerSize > aMaxPayloadSize)))
+    {
+        aWriter = checkpoint;
+        ExitNow(err = WEAVE_NO_ERROR);
+    }
+    SuccessOrExit(err);
+
+    aWritten = true;
+
+exit:
+    return err;
+}
+
+/**
+ * Write a data element for a property.  Like NotificationEngine, a dictionary is written as the only member of its
+ * parent, so the client replaces its contents rather than merging into them.
+ */
+WEAVE_ERROR ViewHandler::WriteDataElement(TLVWriter & aWriter, const PropertyPathHandle aPropertyPathHandle,
+                                          const bool aIsPartialChange)
+{
+    WEAVE_ERROR err                              = WEAVE_NO_ERROR;
+    TraitCatalogBase<TraitDataSource> * pCatalog = SubscriptionEngine::GetInstance()->mPublisherCatalog;
+    TraitDataSource * dataSource;
+    const TraitSchemaEngine * schemaEngine;
+    TLVType elementContainerType, pathContainerType, dataContainerType;
+    SchemaVersionRange versionRange;
+    bool isDictionary;
+
+    err = pCatalog->Locate(mTraitDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    schemaEngine = dataSource->GetSchemaEngine();
+    isDictionary = schemaEngine->IsDictionary(aPropertyPathHandle);
+
+    versionRange.mMaxVersion = mSchemaVersion;
+    versionRange.mMinVersion = schemaEngine->GetLowestCompatibleVersion(versionRange.mMaxVersion);
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, elementContainerType);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(DataElement::kCsTag_Path), kTLVType_Path, pathContainerType);
+    SuccessOrExit(err);
+
+    err = pCatalog->HandleToAddress(mTraitDataHandle, aWriter, versionRange);
+    SuccessOrExit(err);
+
+    err = schemaEngine->MapHandleToPath(isDictionary ? schemaEngine->GetParent(aPropertyPathHandle) : aPropertyPathHandle,
+                                        aWriter);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(pathContainerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(DataElement::kCsTag_Version), dataSource->GetVersion());
+    SuccessOrExit(err);
+
+    if (aIsPartialChange)
+    {
+        err = aWriter.PutBoolean(ContextTag(DataElement::kCsTag_IsPartialChange), true);
+        SuccessOrExit(err);
+    }
+
+    if (isDictionary)
+    {
+        err = aWriter.StartContainer(ContextTag(DataElement::kCsTag_Data), kTLVType_Structure, dataContainerType);
+        SuccessOrExit(err);
+
+        err = dataSource->ReadData(aPropertyPathHandle, schemaEngine->GetTag(aPropertyPathHandle), aWriter);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(dataContainerType);
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = dataSource->ReadData(aPropertyPathHandle, ContextTag(DataElement::kCsTag_Data), aWriter);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(elementContainerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+/**
+ * Send the next chunk of the response, and if the peer does not acknowledge messages, all the chunks after it.  The
+ * handler is closed once the last chunk has been sent.
+ */
+WEAVE_ERROR ViewHandler::SendResponse(void)
+{
+    WEAVE_ERROR err                    = WEAVE_NO_ERROR;
+    SubscriptionEngine * const pEngine = SubscriptionEngine::GetInstance();
+    PacketBuffer * msgBuf              = NULL;
+    bool moreChunks                    = true;
+    bool isLocked                      = false;
+    uint32_t maxPayloadSize;
+    uint16_t sendFlags = 0;
+
+    while (moreChunks)
+    {
+        const uint32_t trailerSize = WEAVE_TRAILER_RESERVE_SIZE;
+        uint32_t allocSize         = nl::Weave::min(static_cast<uint32_t>(WDM_MAX_NOTIFICATION_SIZE),
+                                            static_cast<uint32_t>(WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX -
+                                                                  WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE - trailerSize));
+
+        msgBuf = PacketBuffer::NewWithAvailableSize(WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE, allocSize + trailerSize);
+        VerifyOrExit(NULL != msgBuf, err = WEAVE_ERROR_NO_MEMORY);
+
+        maxPayloadSize = nl::Weave::min(WeaveMessageLayer::GetMaxWeavePayloadSize(msgBuf, (NULL == mEC->Con),
+                                                                                  WEAVE_CONFIG_DEFAULT_UDP_MTU_SIZE),
+                                        allocSize);
+
+        err = pEngine->Lock();
+        SuccessOrExit(err);
+
+        isLocked = true;
+
+        err = BuildResponse(msgBuf, maxPayloadSize, moreChunks);
+        SuccessOrExit(err);
+
+        err = pEngine->Unlock();
+        isLocked = false;
+        SuccessOrExit(err);
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+        if (mEC->HasPeerRequestedAck())
+        {
+            sendFlags = nl::Weave::ExchangeContext::kSendFlag_RequestAck;
+        }
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+        err    = mEC->SendMessage(nl::Weave::Profiles::kWeaveProfile_WDM, kMsgType_ViewResponse, msgBuf, sendFlags);
+        msgBuf = NULL;
+        SuccessOrExit(err);
+
+        // Wait for the acknowledgement before sending the next chunk.
+        if (moreChunks && (0 != sendFlags))
+        {
+            ExitNow();
+        }
+    }
+
+    Close();
+
+exit:
+    WeaveLogFunctError(err);
+
+    if (isLocked)
+    {
+        pEngine->Unlock();
+    }
+
+    if (NULL != msgBuf)
+    {
+        PacketBuffer::Free(msgBuf);
+        msgBuf = NULL;
+    }
+
+    return err;
+}
+
+/**
+ * Report @a aError to the peer in a Status Report and release the handler.
+ */
+void ViewHandler::HandleError(WEAVE_ERROR aError)
+{
+    uint32_t profileId  = nl::Weave::Profiles::kWeaveProfile_Common;
+    uint16_t statusCode = nl::Weave::Profiles::Common::kStatus_InternalServerProblem;
+
+    switch (aError)
+    {
+    case WEAVE_ERROR_INVALID_PROFILE_ID:
+    case WEAVE_ERROR_INVALID_PATH_LIST:
+    case WEAVE_ERROR_TLV_TAG_NOT_FOUND:
+        profileId  = nl::Weave::Profiles::kWeaveProfile_WDM;
+        statusCode = kStatus_InvalidPath;
+        break;
+
+    case WEAVE_ERROR_INCOMPATIBLE_SCHEMA_VERSION:
+        profileId  = nl::Weave::Profiles::kWeaveProfile_WDM;
+        statusCode = kStatus_IncompatibleDataSchemaVersion;
+        break;
+
+    case WEAVE_ERROR_WDM_VERSION_MISMATCH:
+        profileId  = nl::Weave::Profiles::kWeaveProfile_WDM;
+        statusCode = kStatus_VersionMismatch;
+        break;
+
+    case WEAVE_ERROR_NO_MEMORY:
+        statusCode = nl::Weave::Profiles::Common::kStatus_OutOfMemory;
+        break;
+
+    default:
+        break;
+    }
+
+    if (NULL != mEC)
+    {
+        (void) SubscriptionEngine::SendStatusReport(mEC, profileId, statusCode);
+    }
+
+    Close();
+}
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+void ViewHandler::OnAckReceived(nl::Weave::ExchangeContext * aEC, void * aMsgSpecificContext)
+{
+    WEAVE_ERROR err                  = WEAVE_NO_ERROR;
+    ViewHandler * const pViewHandler = reinterpret_cast<ViewHandler *>(aEC->AppState);
+
+    VerifyOrExit(pViewHandler->mHasCurrentPath, );
+
+    err = pViewHandler->SendResponse();
+    if (WEAVE_NO_ERROR != err)
+    {
+        pViewHandler->HandleError(err);
+    }
+
+exit:
+    return;
+}
+
+void ViewHandler::OnSendError(nl::Weave::ExchangeContext * aEC, WEAVE_ERROR aErrorCode, void * aMsgSpecificContext)
+{
+    ViewHandler * const pViewHandler = reinterpret_cast<ViewHandler *>(aEC->AppState);
+
+    WeaveLogError(DataManagement, "<VH> Failed to send view response: %d", aErrorCode);
+
+    pViewHandler->mEC->Abort();
+    pViewHandler->mEC = NULL;
+    pViewHandler->Close();
+}
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+}; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+}; // namespace Profiles
+}; // namespace Weave
+}; // namespace nl
+
+#endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER && WDM_PUBLISHER_ENABLE_VIEW
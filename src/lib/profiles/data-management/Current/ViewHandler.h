@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines view handler, which serves view requests on
+ *      the publisher side of Weave Data Management (WDM) profile.
+ *
+ */
+
+#ifndef _WEAVE_DATA_MANAGEMENT_VIEW_HANDLER_CURRENT_H
+#define _WEAVE_DATA_MANAGEMENT_VIEW_HANDLER_CURRENT_H
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Profiles/data-management/MessageDef.h>
+#include <Weave/Profiles/data-management/TraitData.h>
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+/**
+ *  @class ViewHandler
+ *
+ *  @brief
+ *    Serves a single incoming view request from the publisher catalog.
+ *
+ *    The data for the requested paths is returned in View Response messages on the exchange the request arrived on.
+ *    When the data does not fit in one message, the response is split into chunks, and every chunk but the last one
+ *    carries the MoreChunkedMessages flag.  A path whose data does not fit in a message by itself is sent as one data
+ *    element per child property, all but the last of them marked as a partial change, so the client applies them as
+ *    a single change.  If the peer requested acknowledgements, each chunk is sent only after the previous one has been
+ *    acknowledged; otherwise all chunks are sent at once.
+ *
+ *    View handlers are owned by SubscriptionEngine, which allocates one for every incoming view request.
+ */
+class ViewHandler
+{
+private:
+    friend class SubscriptionEngine;
+    friend class TestTdm;
+
+    enum
+    {
+        // End of the data list, the MoreChunkedMessages flag and end of the response structure
+        kResponseTrailerSize = 4,
+    };
+
+    nl::Weave::ExchangeContext * mEC;
+    PacketBuffer * mRequest;
+
+    // Positioned on the path currently being served, if mHasCurrentPath is set
+    nl::Weave::TLV::TLVReader mPathListIterator;
+    bool mHasCurrentPath;
+
+    TraitDataHandle mTraitDataHandle;
+    PropertyPathHandle mPropertyPathHandle;
+    SchemaVersion mSchemaVersion;
+
+    // Next child of mPropertyPathHandle to be sent while the current path is split into one data element per child
+    PropertyPathHandle mNextChildHandle;
+    uint64_t mSplitVersion;
+
+    ViewHandler(void);
+
+    WEAVE_ERROR Init(nl::Weave::ExchangeContext * aEC, PacketBuffer * aRequest);
+    void Close(void);
+    bool IsFree(void) const { return (NULL == mEC) && (NULL == mRequest); };
+
+    WEAVE_ERROR ResolvePath(const nl::Weave::TLV::TLVReader & aPathReader, TraitDataHandle & aTraitDataHandle,
+                            PropertyPathHandle & aPropertyPathHandle, SchemaVersion & aSchemaVersion);
+    WEAVE_ERROR MoveToNextPath(void);
+    WEAVE_ERROR StartSplit(void);
+
+    WEAVE_ERROR BuildResponse(PacketBuffer * aBuf, const uint32_t aMaxPayloadSize, bool & aMoreChunks);
+    WEAVE_ERROR TryWriteDataElement(nl::Weave::TLV::TLVWriter & aWriter, const uint32_t aMaxPayloadSize,
+                                    const PropertyPathHandle aPropertyPathHandle, const bool aIsPartialChange, bool & aWritten);
+    WEAVE_ERROR WriteDataElement(nl::Weave::TLV::TLVWriter & aWriter, const PropertyPathHandle aPropertyPathHandle,
+                                 const bool aIsPartialChange);
+
+    WEAVE_ERROR SendResponse(void);
+    void HandleError(WEAVE_ERROR aError);
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    static void OnAckReceived(nl::Weave::ExchangeContext * aEC, void * aMsgSpecificContext);
+    static void OnSendError(nl::Weave::ExchangeContext * aEC, WEAVE_ERROR aErrorCode, void * aMsgSpecificContext);
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+};
+
+}; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+}; // namespace Profiles
+}; // namespace Weave
+}; // namespace nl
+
+#endif // _WEAVE_DATA_MANAGEMENT_VIEW_HANDLER_CURRENT_H
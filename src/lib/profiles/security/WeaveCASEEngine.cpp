@@ -146,8 +146,9 @@ WEAVE_ERROR WeaveCASEEngine::GenerateBeginSessionRequest(BeginSessionRequestMess
     VerifyOrExit(WeaveKeyId::IsSessionKey(req.SessionKeyId), err = WEAVE_ERROR_WRONG_KEY_TYPE);
 
     // Verify the requested encryption type.
-    VerifyOrExit(req.EncryptionType == kWeaveEncryptionType_AES128CTRSHA1,
-            err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+    VerifyOrExit(req.EncryptionType == kWeaveEncryptionType_AES128CTRSHA1 ||
+                 req.EncryptionType == kWeaveEncryptionType_AES128GCM,
+                 err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
 
     SetIsInitiator(true);
 
@@ -241,7 +242,8 @@ WEAVE_ERROR WeaveCASEEngine::ProcessBeginSessionRequest(PacketBuffer *msgBuf, Be
     VerifyOrExit(WeaveKeyId::IsSessionKey(req.SessionKeyId), err = WEAVE_ERROR_WRONG_KEY_TYPE);
 
     // Verify the requested encryption type.
-    VerifyOrExit(req.EncryptionType == kWeaveEncryptionType_AES128CTRSHA1,
+    VerifyOrExit(req.EncryptionType == kWeaveEncryptionType_AES128CTRSHA1 ||
+                 req.EncryptionType == kWeaveEncryptionType_AES128GCM,
                  err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
 
     State = kState_BeginRequestProcessed;
@@ -860,6 +862,7 @@ WEAVE_ERROR WeaveCASEEngine::DeriveSessionKeys(EncodedECPublicKey& pubKey, const
 {
     WEAVE_ERROR err;
     uint8_t hashLen = ConfigHashLength();
+    uint16_t encKeySize;
 #if WEAVE_CONFIG_SUPPORT_CASE_CONFIG1
     HKDFSHA1Or256 hkdf(IsUsingConfig1());
 #else
@@ -868,8 +871,13 @@ WEAVE_ERROR WeaveCASEEngine::DeriveSessionKeys(EncodedECPublicKey& pubKey, const
 
     WeaveLogDetail(SecurityManager, "CASE:DeriveSessionKeys");
 
-    // Only AES128CTRSHA1 keys supported for now.
-    VerifyOrExit(EncryptionType == kWeaveEncryptionType_AES128CTRSHA1, err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+    // Determine the amount of key data needed for the negotiated encryption type.
+    if (EncryptionType == kWeaveEncryptionType_AES128CTRSHA1)
+        encKeySize = WeaveEncryptionKey_AES128CTRSHA1::KeySize;
+    else if (EncryptionType == kWeaveEncryptionType_AES128GCM)
+        encKeySize = WeaveEncryptionKey_AES128GCM::KeySize;
+    else
+        ExitNow(err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
 
     // Prepare a salt value to be used in the generation of the master key. The salt value
     // is composed from the hashes of the signed portions of the CASE request and response
@@ -924,9 +932,9 @@ WEAVE_ERROR WeaveCASEEngine::DeriveSessionKeys(EncodedECPublicKey& pubKey, const
         // If performing key confirmation, arrange to generate enough key data for the session
         // keys (data encryption and integrity) as well as a key to be used in key confirmation.
         if (PerformingKeyConfirm())
-            keyLen = WeaveEncryptionKey_AES128CTRSHA1::KeySize + hashLen;
+            keyLen = encKeySize + hashLen;
         else
-            keyLen = WeaveEncryptionKey_AES128CTRSHA1::KeySize;
+            keyLen = encKeySize;
 
         // Perform HKDF-based key expansion to produce the desired key data.
         err = hkdf.ExpandKey(NULL, 0, keyLen, sessionKeyData);
@@ -937,12 +945,21 @@ WEAVE_ERROR WeaveCASEEngine::DeriveSessionKeys(EncodedECPublicKey& pubKey, const
 #endif
 
         // Copy the generated key data to the appropriate destinations.
-        memcpy(mSecureState.AfterKeyGen.EncryptionKey.AES128CTRSHA1.DataKey,
-               sessionKeyData,
-               WeaveEncryptionKey_AES128CTRSHA1::DataKeySize);
-        memcpy(mSecureState.AfterKeyGen.EncryptionKey.AES128CTRSHA1.IntegrityKey,
-               sessionKeyData + WeaveEncryptionKey_AES128CTRSHA1::DataKeySize,
-               WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize);
+        if (EncryptionType == kWeaveEncryptionType_AES128GCM)
+        {
+            memcpy(mSecureState.AfterKeyGen.EncryptionKey.AES128GCM.DataKey,
+                   sessionKeyData,
+                   WeaveEncryptionKey_AES128GCM::DataKeySize);
+        }
+        else
+        {
+            memcpy(mSecureState.AfterKeyGen.EncryptionKey.AES128CTRSHA1.DataKey,
+                   sessionKeyData,
+                   WeaveEncryptionKey_AES128CTRSHA1::DataKeySize);
+            memcpy(mSecureState.AfterKeyGen.EncryptionKey.AES128CTRSHA1.IntegrityKey,
+                   sessionKeyData + WeaveEncryptionKey_AES128CTRSHA1::DataKeySize,
+                   WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize);
+        }
 
         // If performing key confirmation...
         if (PerformingKeyConfirm())
@@ -950,7 +967,7 @@ WEAVE_ERROR WeaveCASEEngine::DeriveSessionKeys(EncodedECPublicKey& pubKey, const
             // Use the key confirmation key to generate key confirmation hashes. Store the initiator hash
             // (the single hash) in state data for later use.  Return the responder hash (the double hash)
             // to the caller.
-            uint8_t *keyConfirmKey = sessionKeyData + WeaveEncryptionKey_AES128CTRSHA1::KeySize;
+            uint8_t *keyConfirmKey = sessionKeyData + encKeySize;
             GenerateKeyConfirmHashes(keyConfirmKey, mSecureState.AfterKeyGen.InitiatorKeyConfirmHash,
                                      responderKeyConfirmHash);
         }
@@ -40,6 +40,53 @@ namespace Security {
 
 using namespace nl::Weave::Crypto;
 
+enum
+{
+    kMaxBlocksInFlight = 8
+};
+
+// Encrypts kNumBlocks consecutive blocks, running each round over all of the blocks before moving on to the next
+// round.  The AES-NI round instructions are pipelined, so interleaving independent blocks hides their latency.
+template <size_t kNumBlocks>
+static inline void EncryptBlocksInFlight(const __m128i *key, int roundCount, const uint8_t *inBlocks, uint8_t *outBlocks)
+{
+    __m128i blocks[kNumBlocks];
+    size_t i;
+    int round;
+
+    for (i = 0; i < kNumBlocks; i++)
+        blocks[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks + 16 * i)), key[0]);
+    for (round = 1; round < roundCount; round++)
+        for (i = 0; i < kNumBlocks; i++)
+            blocks[i] = _mm_aesenc_si128(blocks[i], key[round]);
+    for (i = 0; i < kNumBlocks; i++)
+        _mm_storeu_si128((__m128i *)(outBlocks + 16 * i), _mm_aesenclast_si128(blocks[i], key[roundCount]));
+    ClearSecretData((uint8_t *)blocks, sizeof(blocks));
+}
+
+static void EncryptConsecutiveBlocks(const __m128i *key, int roundCount, const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    for (; numBlocks >= kMaxBlocksInFlight; numBlocks -= kMaxBlocksInFlight)
+    {
+        EncryptBlocksInFlight<kMaxBlocksInFlight>(key, roundCount, inBlocks, outBlocks);
+        inBlocks += 16 * kMaxBlocksInFlight;
+        outBlocks += 16 * kMaxBlocksInFlight;
+    }
+
+    if (numBlocks >= kMaxBlocksInFlight / 2)
+    {
+        EncryptBlocksInFlight<kMaxBlocksInFlight / 2>(key, roundCount, inBlocks, outBlocks);
+        inBlocks += 16 * (kMaxBlocksInFlight / 2);
+        outBlocks += 16 * (kMaxBlocksInFlight / 2);
+        numBlocks -= kMaxBlocksInFlight / 2;
+    }
+
+    for (; numBlocks > 0; numBlocks--, inBlocks += 16, outBlocks += 16)
+    {
+        EncryptBlocksInFlight<1>(key, roundCount, inBlocks, outBlocks);
+    }
+}
+
 AES128BlockCipher::AES128BlockCipher()
 {
     memset(&mKey, 0, sizeof(mKey));
@@ -108,6 +155,11 @@ void AES128BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    EncryptConsecutiveBlocks(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES128BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
@@ -234,6 +286,11 @@ void AES256BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    EncryptConsecutiveBlocks(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES256BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
@@ -64,6 +64,14 @@ void AES128BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     AES_encrypt(inBlock, outBlock, &mKey);
 }
 
+void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    for (; numBlocks > 0; numBlocks--, inBlocks += kBlockLength, outBlocks += kBlockLength)
+    {
+        AES_encrypt(inBlocks, outBlocks, &mKey);
+    }
+}
+
 void AES128BlockCipherDec::SetKey(const uint8_t *key)
 {
     AES_set_decrypt_key(key, kKeyLengthBits, &mKey);
@@ -99,6 +107,14 @@ void AES256BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     AES_encrypt(inBlock, outBlock, &mKey);
 }
 
+void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    for (; numBlocks > 0; numBlocks--, inBlocks += kBlockLength, outBlocks += kBlockLength)
+    {
+        AES_encrypt(inBlocks, outBlocks, &mKey);
+    }
+}
+
 void AES256BlockCipherDec::SetKey(const uint8_t *key)
 {
     AES_set_decrypt_key(key, kKeyLengthBits, &mKey);
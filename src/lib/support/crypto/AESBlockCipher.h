@@ -48,6 +48,12 @@ namespace Weave {
 namespace Platform {
 namespace Security {
 
+/*
+ *  The Enc classes below provide EncryptBlocks() in addition to EncryptBlock().  EncryptBlocks() encrypts a run of
+ *  consecutive blocks in ECB fashion, and allows inBlocks and outBlocks to be the same buffer.  Implementations that
+ *  can keep several blocks in flight at once (e.g. AES-NI) do so; others simply encrypt one block after another.
+ */
+
 class AES128BlockCipher
 {
 public:
@@ -81,6 +87,7 @@ class NL_DLL_EXPORT AES128BlockCipherEnc : public AES128BlockCipher
 public:
     void SetKey(const uint8_t *key);
     void EncryptBlock(const uint8_t *inBlock, uint8_t *outBlock);
+    void EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks);
 };
 
 class NL_DLL_EXPORT AES128BlockCipherDec : public AES128BlockCipher
@@ -123,6 +130,7 @@ class NL_DLL_EXPORT AES256BlockCipherEnc : public AES256BlockCipher
 public:
     void SetKey(const uint8_t *key);
     void EncryptBlock(const uint8_t *inBlock, uint8_t *outBlock);
+    void EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks);
 };
 
 class NL_DLL_EXPORT AES256BlockCipherDec : public AES256BlockCipher
@@ -55,10 +55,19 @@ void CTRMode<BlockCipher>::SetKey(const uint8_t *key)
     mBlockCipher.SetKey(key);
 }
 
+template <class BlockCipher>
+void CTRMode<BlockCipher>::SetKey(const BlockCipher& keyedBlockCipher)
+{
+    // Adopt an already expanded key schedule rather than expanding the key again.
+    mBlockCipher = keyedBlockCipher;
+}
+
 template <class BlockCipher>
 void CTRMode<BlockCipher>::SetCounter(const uint8_t *counter)
 {
+    // A new counter starts a new key stream.
     memcpy(Counter, counter, kCounterLength);
+    mMsgIndex = 0;
 }
 
 template <class BlockCipher>
@@ -86,48 +95,108 @@ void CTRMode<BlockCipher>::SetWeaveMessageCounter(uint64_t sendingNodeId, uint32
     Counter[13] = 0;
     Counter[14] = 0;
     Counter[15] = 0;
+    mMsgIndex = 0;
+}
+
+// Store the block counter in the four least-significant bytes of a counter block.
+static inline void PutBlockCounter(uint8_t *counterBlockEnd, uint32_t blockCounter)
+{
+    counterBlockEnd[-4] = (uint8_t) (blockCounter >> (3 * 8));
+    counterBlockEnd[-3] = (uint8_t) (blockCounter >> (2 * 8));
+    counterBlockEnd[-2] = (uint8_t) (blockCounter >> (1 * 8));
+    counterBlockEnd[-1] = (uint8_t) (blockCounter);
+}
+
+// XOR a whole number of blocks of data with the key stream, a word at a time.
+static inline void XorKeyStream(const uint8_t *inData, const uint8_t *keyStream, uint8_t *outData, size_t len)
+{
+    for (size_t i = 0; i < len; i += sizeof(uint64_t))
+    {
+        uint64_t data, key;
+
+        memcpy(&data, inData + i, sizeof(data));
+        memcpy(&key, keyStream + i, sizeof(key));
+        data ^= key;
+        memcpy(outData + i, &data, sizeof(data));
+    }
 }
 
 template <class BlockCipher>
 void CTRMode<BlockCipher>::EncryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData)
 {
+    uint8_t keyStream[kKeyStreamBlocks * kCounterLength];
+
     // Index to next byte of encrypted counter to be used.
     uint32_t encryptedCounterIndex = mMsgIndex % kCounterLength;
 
-    // For each byte of input data...
-    for (uint16_t dataIndex = 0; dataIndex < dataLen && mMsgIndex < UINT32_MAX; dataIndex++, mMsgIndex++)
+    // The block counter occupies the four least-significant bytes of the counter. Since the message size is at most
+    // UINT32_MAX (and the counter counts blocks) it never carries into the rest of the counter.
+    uint32_t blockCounter = ((uint32_t) Counter[kCounterLength-4] << 24) | ((uint32_t) Counter[kCounterLength-3] << 16) |
+                            ((uint32_t) Counter[kCounterLength-2] << 8) | Counter[kCounterLength-1];
+
+    if (dataLen > UINT32_MAX - mMsgIndex)
+    {
+        dataLen = (uint16_t) (UINT32_MAX - mMsgIndex);
+    }
+
+    // Use up the encrypted counter bytes left over from the previous call.
+    if (encryptedCounterIndex != 0)
     {
-        // If we need more encrypted counter bytes...
-        if (encryptedCounterIndex == 0)
+        for (; dataLen > 0 && encryptedCounterIndex < kCounterLength; dataLen--, encryptedCounterIndex++, mMsgIndex++)
         {
-            // Encrypt the next counter value.
-            mBlockCipher.EncryptBlock(Counter, mEncryptedCounter);
-
-            // Bump the counter. Since the message size is at most UINT32_MAX (and the counter counts blocks)
-            // we will never need to update more than the four least-significant bytes.
-            Counter[kCounterLength-1]++;
-            if (Counter[kCounterLength-1] == 0)
-            {
-                Counter[kCounterLength-2]++;
-                if (Counter[kCounterLength-2] == 0)
-                {
-                    Counter[kCounterLength-3]++;
-                    if (Counter[kCounterLength-3] == 0)
-                    {
-                        Counter[kCounterLength-4]++;
-                    }
-                }
-            }
+            *outData++ = *inData++ ^ mEncryptedCounter[encryptedCounterIndex];
+        }
+    }
+
+    // Encrypt whole blocks, generating the key stream for several of them at a time.
+    while (dataLen >= kCounterLength)
+    {
+        uint32_t numBlocks = dataLen / kCounterLength;
+        uint32_t numBytes;
+
+        if (numBlocks > kKeyStreamBlocks)
+        {
+            numBlocks = kKeyStreamBlocks;
+        }
+        numBytes = numBlocks * kCounterLength;
+
+        for (uint32_t i = 0; i < numBlocks; i++, blockCounter++)
+        {
+            uint8_t *block = keyStream + i * kCounterLength;
+
+            memcpy(block, Counter, kCounterLength - 4);
+            PutBlockCounter(block + kCounterLength, blockCounter);
         }
 
-        // XOR the data with the corresponding byte of the encrypted counter.
-        outData[dataIndex] = inData[dataIndex] ^ mEncryptedCounter[encryptedCounterIndex];
+        mBlockCipher.EncryptBlocks(keyStream, keyStream, numBlocks);
 
-        // Bump the counter index.
-        encryptedCounterIndex++;
-        if (encryptedCounterIndex == kCounterLength)
-            encryptedCounterIndex = 0;
+        XorKeyStream(inData, keyStream, outData, numBytes);
+
+        inData += numBytes;
+        outData += numBytes;
+        dataLen -= numBytes;
+        mMsgIndex += numBytes;
+    }
+
+    // Encrypt the final partial block, keeping the rest of its encrypted counter for the next call.
+    if (dataLen > 0)
+    {
+        memcpy(keyStream, Counter, kCounterLength - 4);
+        PutBlockCounter(keyStream + kCounterLength, blockCounter);
+        blockCounter++;
+
+        mBlockCipher.EncryptBlock(keyStream, mEncryptedCounter);
+
+        for (encryptedCounterIndex = 0; encryptedCounterIndex < dataLen; encryptedCounterIndex++)
+        {
+            outData[encryptedCounterIndex] = inData[encryptedCounterIndex] ^ mEncryptedCounter[encryptedCounterIndex];
+        }
+        mMsgIndex += dataLen;
     }
+
+    PutBlockCounter(Counter + kCounterLength, blockCounter);
+
+    ClearSecretData(keyStream, sizeof(keyStream));
 }
 
 template <class BlockCipher>
@@ -53,6 +53,7 @@ public:
     uint8_t Counter[kCounterLength];
 
     void SetKey(const uint8_t *key);
+    void SetKey(const BlockCipher& keyedBlockCipher);
     void SetCounter(const uint8_t *counter);
     void SetWeaveMessageCounter(uint64_t sendingNodeId, uint32_t msgId);
     void EncryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData);
@@ -60,6 +61,11 @@ public:
     void Reset(void);
 
 private:
+    enum
+    {
+        kKeyStreamBlocks = 8    // Number of counter blocks encrypted per call to the block cipher
+    };
+
     BlockCipher mBlockCipher;
     uint32_t mMsgIndex;
     uint8_t mEncryptedCounter[kCounterLength];
@@ -0,0 +1,401 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a template object for doing Galois/Counter
+ *      mode (GCM) authenticated encryption with block ciphers, as
+ *      specified in NIST SP 800-38D, and a specialized object for
+ *      AES-128-GCM.
+ *
+ *      The GHASH multiplication uses the carry-less multiply instruction
+ *      when building with the AES-NI block cipher and PCLMULQDQ is
+ *      enabled in the compiler; otherwise it uses 4-bit multiplication
+ *      tables.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Weave/Core/WeaveEncoding.h>
+
+#include "WeaveCrypto.h"
+#include "GCMMode.h"
+
+#if WEAVE_CONFIG_AES_IMPLEMENTATION_AESNI && defined(__PCLMUL__) && defined(__SSSE3__)
+#define GHASH_USE_PCLMUL 1
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#else
+#define GHASH_USE_PCLMUL 0
+#endif
+
+namespace nl {
+namespace Weave {
+namespace Crypto {
+
+using namespace nl::Weave::Encoding;
+
+void GHASH::SetHashKey(const uint8_t *hashKey)
+{
+    uint64_t vh = BigEndian::Get64(hashKey);
+    uint64_t vl = BigEndian::Get64(hashKey + 8);
+
+    // Entry 8 is H itself, and entries 4, 2 and 1 are H shifted right (i.e. multiplied by x) once, twice and three
+    // times.  The remaining entries are sums of those.
+    mTableHigh[0] = 0;
+    mTableLow[0] = 0;
+    mTableHigh[8] = vh;
+    mTableLow[8] = vl;
+
+    for (int i = 4; i > 0; i >>= 1)
+    {
+        uint64_t reduce = (vl & 1) ? 0xE100000000000000ULL : 0;
+
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ reduce;
+        mTableHigh[i] = vh;
+        mTableLow[i] = vl;
+    }
+
+    for (int i = 2; i <= 8; i *= 2)
+    {
+        for (int j = 1; j < i; j++)
+        {
+            mTableHigh[i + j] = mTableHigh[i] ^ mTableHigh[j];
+            mTableLow[i + j] = mTableLow[i] ^ mTableLow[j];
+        }
+    }
+}
+
+#if GHASH_USE_PCLMUL
+
+// Carry-less multiplication of two bit-reflected field elements followed by reduction modulo the GCM polynomial,
+// as described in the Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode white paper.
+static inline __m128i GFMultiply(__m128i a, __m128i b)
+{
+    __m128i lo, mid, hi, carryLo, carryHi, carryMid, reduce;
+
+    lo = _mm_clmulepi64_si128(a, b, 0x00);
+    mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    hi = _mm_clmulepi64_si128(a, b, 0x11);
+
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // Shift the 256-bit product left by one bit to account for the bit reflection.
+    carryLo = _mm_srli_epi32(lo, 31);
+    carryHi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    carryMid = _mm_srli_si128(carryLo, 12);
+    carryHi = _mm_slli_si128(carryHi, 4);
+    carryLo = _mm_slli_si128(carryLo, 4);
+    lo = _mm_or_si128(lo, carryLo);
+    hi = _mm_or_si128(hi, carryHi);
+    hi = _mm_or_si128(hi, carryMid);
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    reduce = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    carryMid = _mm_srli_si128(reduce, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(reduce, 12));
+    reduce = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    reduce = _mm_xor_si128(reduce, carryMid);
+    lo = _mm_xor_si128(lo, reduce);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+void GHASH::Multiply(uint8_t *block) const
+{
+    const __m128i byteSwap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) block), byteSwap);
+    __m128i h = _mm_set_epi64x((long long) mTableHigh[8], (long long) mTableLow[8]);
+
+    x = GFMultiply(x, h);
+    _mm_storeu_si128((__m128i *) block, _mm_shuffle_epi8(x, byteSwap));
+}
+
+#else // GHASH_USE_PCLMUL
+
+// Reduction of the four bits shifted out of the low end of the product, pre-shifted into the top 16 bits.
+static const uint64_t sReduce4Bits[16] =
+{
+    0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0, 0x48C0, 0x54E0,
+    0xE100, 0xFD20, 0xD940, 0xC560, 0x9180, 0x8DA0, 0xA9C0, 0xB5E0
+};
+
+void GHASH::Multiply(uint8_t *block) const
+{
+    uint8_t nibble = block[15] & 0xF;
+    uint64_t zh = mTableHigh[nibble];
+    uint64_t zl = mTableLow[nibble];
+
+    // Horner's rule over the nibbles of the block, from the last one to the first.
+    for (int i = 15; i >= 0; i--)
+    {
+        uint8_t rem;
+
+        if (i != 15)
+        {
+            nibble = block[i] & 0xF;
+            rem = (uint8_t) (zl & 0xF);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (sReduce4Bits[rem] << 48);
+            zh ^= mTableHigh[nibble];
+            zl ^= mTableLow[nibble];
+        }
+
+        nibble = block[i] >> 4;
+        rem = (uint8_t) (zl & 0xF);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (sReduce4Bits[rem] << 48);
+        zh ^= mTableHigh[nibble];
+        zl ^= mTableLow[nibble];
+    }
+
+    BigEndian::Put64(block, zh);
+    BigEndian::Put64(block + 8, zl);
+}
+
+#endif // GHASH_USE_PCLMUL
+
+void GHASH::Reset()
+{
+    ClearSecretData((uint8_t *) mTableHigh, sizeof(mTableHigh));
+    ClearSecretData((uint8_t *) mTableLow, sizeof(mTableLow));
+}
+
+template <class BlockCipher>
+GCMMode<BlockCipher>::GCMMode()
+{
+    mAADLen = 0;
+    mDataLen = 0;
+    mAADComplete = false;
+    memset(mHash, 0, sizeof(mHash));
+    memset(mEncryptedJ0, 0, sizeof(mEncryptedJ0));
+}
+
+template <class BlockCipher>
+GCMMode<BlockCipher>::~GCMMode()
+{
+    Reset();
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::SetKey(const uint8_t *key)
+{
+    mCTR.SetKey(key);
+    DeriveHashKey();
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::SetKey(const BlockCipher& keyedBlockCipher)
+{
+    mCTR.SetKey(keyedBlockCipher);
+    DeriveHashKey();
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::DeriveHashKey(void)
+{
+    static const uint8_t zeroBlock[kBlockLength] = { 0 };
+    uint8_t hashKey[kBlockLength];
+
+    // The hash key is the encryption of the all-zero block.
+    mCTR.SetCounter(zeroBlock);
+    mCTR.EncryptData(zeroBlock, kBlockLength, hashKey);
+    mGHASH.SetHashKey(hashKey);
+
+    ClearSecretData(hashKey, sizeof(hashKey));
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::SetIV(const uint8_t *iv)
+{
+    static const uint8_t zeroBlock[kBlockLength] = { 0 };
+    uint8_t counter[kBlockLength];
+
+    // For a 96-bit IV the initial counter block (J0) is the IV followed by a 32-bit block counter of 1.  J0 itself
+    // encrypts the tag, and the data is encrypted with the counter blocks that follow it.
+    memcpy(counter, iv, kIVLength);
+    memset(counter + kIVLength, 0, kBlockLength - kIVLength - 1);
+    counter[kBlockLength - 1] = 1;
+
+    mCTR.SetCounter(counter);
+    mCTR.EncryptData(zeroBlock, kBlockLength, mEncryptedJ0);
+
+    mAADLen = 0;
+    mDataLen = 0;
+    mAADComplete = false;
+    memset(mHash, 0, sizeof(mHash));
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::SetWeaveMessageIV(uint64_t sendingNodeId, uint32_t msgId)
+{
+    // The IV for a Weave message is the same as the leading 96 bits of the AES-128-CTR message counter:
+    //
+    //        (64-bits)     |   (32 bits)
+    //    <sending-node-id> | <message-id>
+    //
+    uint8_t iv[kIVLength];
+
+    BigEndian::Put64(iv, sendingNodeId);
+    BigEndian::Put32(iv + 8, msgId);
+
+    SetIV(iv);
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::Hash(const uint8_t *data, uint16_t dataLen, uint32_t& totalLen)
+{
+    uint32_t pos = totalLen % kBlockLength;
+
+    totalLen += dataLen;
+
+    while (dataLen > 0)
+    {
+        if (pos == 0 && dataLen >= kBlockLength)
+        {
+            for (uint32_t i = 0; i < kBlockLength; i++)
+            {
+                mHash[i] ^= data[i];
+            }
+            mGHASH.Multiply(mHash);
+
+            data += kBlockLength;
+            dataLen -= kBlockLength;
+            continue;
+        }
+
+        mHash[pos++] ^= *data++;
+        dataLen--;
+
+        if (pos == kBlockLength)
+        {
+            mGHASH.Multiply(mHash);
+            pos = 0;
+        }
+    }
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::CompleteAAD()
+{
+    // Zero-pad the last block of AAD.
+    if (!mAADComplete)
+    {
+        if (mAADLen % kBlockLength != 0)
+        {
+            mGHASH.Multiply(mHash);
+        }
+        mAADComplete = true;
+    }
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::AddAAD(const uint8_t *aad, uint16_t aadLen)
+{
+    Hash(aad, aadLen, mAADLen);
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::EncryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData)
+{
+    CompleteAAD();
+
+    // Hash each chunk of ciphertext right after producing it, so the data only passes through the cache once.
+    while (dataLen > 0)
+    {
+        uint16_t chunkLen = (dataLen < kChunkLength) ? dataLen : (uint16_t) kChunkLength;
+
+        mCTR.EncryptData(inData, chunkLen, outData);
+        Hash(outData, chunkLen, mDataLen);
+
+        inData += chunkLen;
+        outData += chunkLen;
+        dataLen -= chunkLen;
+    }
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::DecryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData)
+{
+    CompleteAAD();
+
+    // Hash each chunk of ciphertext before decrypting it, since it may be decrypted in place.
+    while (dataLen > 0)
+    {
+        uint16_t chunkLen = (dataLen < kChunkLength) ? dataLen : (uint16_t) kChunkLength;
+
+        Hash(inData, chunkLen, mDataLen);
+        mCTR.EncryptData(inData, chunkLen, outData);
+
+        inData += chunkLen;
+        outData += chunkLen;
+        dataLen -= chunkLen;
+    }
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::GetTag(uint8_t *tag)
+{
+    uint8_t lengthBlock[kBlockLength];
+
+    CompleteAAD();
+
+    // Zero-pad the last block of data.
+    if (mDataLen % kBlockLength != 0)
+    {
+        mGHASH.Multiply(mHash);
+    }
+
+    // Finish with the bit lengths of the AAD and the data.
+    BigEndian::Put64(lengthBlock, (uint64_t) mAADLen * 8);
+    BigEndian::Put64(lengthBlock + 8, (uint64_t) mDataLen * 8);
+    for (uint32_t i = 0; i < kBlockLength; i++)
+    {
+        mHash[i] ^= lengthBlock[i];
+    }
+    mGHASH.Multiply(mHash);
+
+    for (uint32_t i = 0; i < kTagLength; i++)
+    {
+        tag[i] = mHash[i] ^ mEncryptedJ0[i];
+    }
+}
+
+template <class BlockCipher>
+void GCMMode<BlockCipher>::Reset()
+{
+    mCTR.Reset();
+    mGHASH.Reset();
+    mAADLen = 0;
+    mDataLen = 0;
+    mAADComplete = false;
+    ClearSecretData(mHash, sizeof(mHash));
+    ClearSecretData(mEncryptedJ0, sizeof(mEncryptedJ0));
+}
+
+template class GCMMode<Platform::Security::AES128BlockCipherEnc>;
+
+} /* namespace Crypto */
+} /* namespace Weave */
+} /* namespace nl */
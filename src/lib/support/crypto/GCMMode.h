@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a template object for doing Galois/Counter
+ *      mode (GCM) authenticated encryption with block ciphers and a
+ *      specialized object for AES-128-GCM.
+ *
+ */
+
+#include <Weave/Support/NLDLLUtil.h>
+
+#include "AESBlockCipher.h"
+#include "CTRMode.h"
+
+#ifndef GCMMODE_H_
+#define GCMMODE_H_
+
+namespace nl {
+namespace Weave {
+namespace Crypto {
+
+// Multiplication by the hash key H in GF(2^128), as used by the GCM authentication function (GHASH).
+class NL_DLL_EXPORT GHASH
+{
+public:
+    enum
+    {
+        kBlockLength    = 16
+    };
+
+    void SetHashKey(const uint8_t *hashKey);
+    void Multiply(uint8_t *block) const;
+
+    void Reset(void);
+
+private:
+    // Multiples of H by every 4-bit value, split into the high and low halves of each product.
+    uint64_t mTableHigh[16];
+    uint64_t mTableLow[16];
+};
+
+template <class BlockCipher>
+class NL_DLL_EXPORT GCMMode
+{
+public:
+    enum
+    {
+        kKeyLength      = BlockCipher::kKeyLength,
+        kBlockLength    = BlockCipher::kBlockLength,
+        kIVLength       = 12,
+        kTagLength      = 16
+    };
+
+    GCMMode(void);
+    ~GCMMode(void);
+
+    void SetKey(const uint8_t *key);
+    void SetKey(const BlockCipher& keyedBlockCipher);
+    void SetIV(const uint8_t *iv);
+    void SetWeaveMessageIV(uint64_t sendingNodeId, uint32_t msgId);
+
+    // All additional authenticated data must be added before any data is encrypted or decrypted.
+    void AddAAD(const uint8_t *aad, uint16_t aadLen);
+    void EncryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData);
+    void DecryptData(const uint8_t *inData, uint16_t dataLen, uint8_t *outData);
+    void GetTag(uint8_t *tag);
+
+    void Reset(void);
+
+private:
+    enum
+    {
+        kChunkLength    = 128   // Amount of data encrypted and hashed together while it is in cache
+    };
+
+    CTRMode<BlockCipher> mCTR;
+    GHASH mGHASH;
+    uint32_t mAADLen;
+    uint32_t mDataLen;
+    bool mAADComplete;
+    uint8_t mHash[kBlockLength];
+    uint8_t mEncryptedJ0[kBlockLength];
+
+    void DeriveHashKey(void);
+    void Hash(const uint8_t *data, uint16_t dataLen, uint32_t& totalLen);
+    void CompleteAAD(void);
+};
+
+typedef GCMMode<Platform::Security::AES128BlockCipherEnc> AES128GCMMode;
+
+} /* namespace Crypto */
+} /* namespace Weave */
+} /* namespace nl */
+
+#endif /* GCMMODE_H_ */
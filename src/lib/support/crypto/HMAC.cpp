@@ -84,6 +84,16 @@ void HMAC<H>::Begin(const uint8_t *key, uint16_t keyLen)
     ClearSecretData(pad, sizeof(kBlockLength));
 }
 
+template <class H>
+void HMAC<H>::Begin(const PrecomputedKey& key)
+{
+    Reset();
+
+    // Resume the inner hash from the state following the inner pad, and remember where to find the outer one.
+    mHash = key.mInnerHash;
+    mOuterHash = &key.mOuterHash;
+}
+
 template <class H>
 void HMAC<H>::AddData(const uint8_t *msgData, uint16_t dataLen)
 {
@@ -109,6 +119,18 @@ void HMAC<H>::Finish(uint8_t *hashBuf)
     // Finalize the inner hash.
     mHash.Finish(innerHash);
 
+    // If the key was precomputed, resume the outer hash from the state following the outer pad.
+    if (mOuterHash != NULL)
+    {
+        mHash = *mOuterHash;
+        mHash.AddData(innerHash, kDigestLength);
+        mHash.Finish(hashBuf);
+
+        Reset();
+        ClearSecretData(innerHash, sizeof(innerHash));
+        return;
+    }
+
     // Form the pad for the outer hash.
     memcpy(pad, mKey, mKeyLen);
     if (mKeyLen < kBlockLength)
@@ -132,10 +154,41 @@ template <class H>
 void HMAC<H>::Reset()
 {
     mHash.Reset();
+    mOuterHash = NULL;
     ClearSecretData(mKey, sizeof(mKey));
     mKeyLen = 0;
 }
 
+template <class H>
+void HMAC<H>::PrecomputedKey::Set(const uint8_t *keyData, uint16_t keyLen)
+{
+    HMAC<H> hmac;
+
+    // Absorb the inner pad as for a normal HMAC computation and save the resulting state.
+    hmac.Begin(keyData, keyLen);
+    mInnerHash = hmac.mHash;
+
+    // Form the pad for the outer hash, and save the state after absorbing it.
+    uint8_t pad[kBlockLength];
+    memcpy(pad, hmac.mKey, hmac.mKeyLen);
+    if (hmac.mKeyLen < kBlockLength)
+        memset(pad + hmac.mKeyLen, 0, kBlockLength - hmac.mKeyLen);
+    for (size_t i = 0; i < kBlockLength; i++)
+        pad[i] = pad[i] ^ 0x5c;
+
+    mOuterHash.Begin();
+    mOuterHash.AddData(pad, kBlockLength);
+
+    ClearSecretData(pad, sizeof(pad));
+}
+
+template <class H>
+void HMAC<H>::PrecomputedKey::Reset()
+{
+    mInnerHash.Reset();
+    mOuterHash.Reset();
+}
+
 template class HMAC<Platform::Security::SHA1>;
 template class HMAC<Platform::Security::SHA256>;
 
@@ -43,10 +43,26 @@ public:
         kDigestLength           = H::kHashLength
     };
 
+    // The hash states reached after absorbing the inner and outer key pads. Computing these once
+    // for a long-lived key saves two hash block compressions for every message authenticated with it.
+    class PrecomputedKey
+    {
+    public:
+        void Set(const uint8_t *keyData, uint16_t keyLen);
+        void Reset(void);
+
+    private:
+        friend class HMAC;
+
+        H mInnerHash;
+        H mOuterHash;
+    };
+
     HMAC(void);
     ~HMAC(void);
 
     void Begin(const uint8_t *keyData, uint16_t keyLen);
+    void Begin(const PrecomputedKey& key);
     void AddData(const uint8_t *msgData, uint16_t dataLen);
 #if WEAVE_WITH_OPENSSL
     void AddData(const BIGNUM& num);
@@ -61,6 +77,7 @@ private:
     };
 
     H mHash;
+    const H *mOuterHash;
     uint8_t mKey[kBlockLength];
     uint16_t mKeyLen;
 };
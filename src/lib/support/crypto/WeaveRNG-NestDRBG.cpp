@@ -31,6 +31,10 @@
 #include "AESBlockCipher.h"
 #include <Weave/Support/CodeUtils.h>
 
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+#include <pthread.h>
+#endif
+
 #if WEAVE_CONFIG_DEV_RANDOM_DRBG_SEED
 #include <unistd.h>
 #include <fcntl.h>
@@ -98,19 +102,48 @@ exit:
 
 AES128CTRDRBG CtrDRBG;
 
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+// The security manager's crypto worker threads draw random data concurrently with the Weave thread.
+static pthread_mutex_t sCtrDRBGLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 WEAVE_ERROR InitSecureRandomDataSource(EntropyFunct entropyFunct, uint16_t entropyLen, const uint8_t *personalizationData, uint16_t perDataLen)
 {
+    WEAVE_ERROR err;
+
 #if WEAVE_CONFIG_DEV_RANDOM_DRBG_SEED
     if (entropyFunct == NULL)
         entropyFunct = GetDRBGSeedDevRandom;
 #endif
 
-    return CtrDRBG.Instantiate(entropyFunct, entropyLen, personalizationData, perDataLen);
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    pthread_mutex_lock(&sCtrDRBGLock);
+#endif
+
+    err = CtrDRBG.Instantiate(entropyFunct, entropyLen, personalizationData, perDataLen);
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    pthread_mutex_unlock(&sCtrDRBGLock);
+#endif
+
+    return err;
 }
 
 WEAVE_ERROR GetSecureRandomData(uint8_t *buf, uint16_t len)
 {
-    return CtrDRBG.Generate(buf, len);
+    WEAVE_ERROR err;
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    pthread_mutex_lock(&sCtrDRBGLock);
+#endif
+
+    err = CtrDRBG.Generate(buf, len);
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    pthread_mutex_unlock(&sCtrDRBGLock);
+#endif
+
+    return err;
 }
 
 #endif // WEAVE_CONFIG_RNG_IMPLEMENTATION_NESTDRBG
@@ -452,6 +452,113 @@ struct LwIPEvent;
 #define WEAVE_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* WEAVE_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) armed timers are kept in a hashed timing wheel.
+ *
+ *      When asserted, starting and cancelling a timer through nl::Weave::System::Layer::StartTimer and
+ *      nl::Weave::System::Layer::CancelTimer take constant time regardless of the number of armed timers, and expiry only
+ *      visits the wheel slots that have elapsed. When deasserted, armed timers are kept in a sorted list (LwIP) or found by
+ *      scanning the timer pool (BSD sockets).
+ *
+ *      The wheel and its timer index are allocated from the heap by nl::Weave::System::Layer::Init.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+#define WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL 0
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE
+ *
+ *  @brief
+ *      This is the number of slots in the timing wheel. A timer whose delay exceeds one revolution of the wheel, i.e.
+ *      #WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE * #WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS milliseconds, is examined once
+ *      per revolution until it expires.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE 512
+#endif // WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS
+ *
+ *  @brief
+ *      This is the span, in milliseconds, covered by each slot of the timing wheel. It affects how timers are grouped, not
+ *      when they fire: timers still expire with millisecond resolution.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS 8
+#endif // WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE
+ *
+ *  @brief
+ *      This is the initial number of hash buckets used to look up an armed timer by its completion function and application
+ *      state when #WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL is asserted. The index doubles whenever the number of indexed timers
+ *      would exceed its number of buckets, so that a lookup takes constant time on average however many timers are armed.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE
+#define WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE 1024
+#endif // WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE
+
+#if WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE <= 0
+#error "FORBIDDEN: WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE <= 0"
+#endif // WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS <= 0 || WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE <= 0
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) the pools of timers and Inet layer endpoints grow on demand.
+ *
+ *      When asserted, these pools are nl::Weave::System::SlabObjectPool instances, which allocate objects from the heap in
+ *      slabs of growing size, starting with the configured number of objects (e.g. #WEAVE_SYSTEM_CONFIG_NUM_TIMERS), and keep a
+ *      free list so that allocation takes constant time. When deasserted, they are fixed-size nl::Weave::System::ObjectPool
+ *      instances.
+ *
+ *      This is intended for hosts with a heap, such as server processes on Linux.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+#define WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS 0
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS
+ *
+ *  @brief
+ *      This is the maximum number of slabs of a slab object pool. Each slab holds twice as many objects as the one before, so a
+ *      pool whose first slab holds N objects can hold up to N * (2 ^ #WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS - 1).
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS
+#define WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS 16
+#endif // WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_EPOLL
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) the Weave System Layer provides an edge-triggered Linux epoll(7) event loop alongside
+ *      the select(2) interface.
+ *
+ *      When asserted, sockets owned by the Inet layer endpoints are registered with a single epoll instance once, when they are
+ *      created, and readiness is delivered directly to the owning endpoint. Applications drive the event loop with
+ *      nl::Weave::System::Layer::PrepareEPoll, epoll_wait(2) and nl::Weave::System::Layer::HandleEPollResult, followed by
+ *      nl::Inet::InetLayer::PrepareEPoll and nl::Inet::InetLayer::HandleEPollResult. The select(2) interface remains available
+ *      and functional for applications that have not been converted.
+ *
+ *      This is only meaningful for BSD sockets-based systems on Linux.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#define WEAVE_SYSTEM_CONFIG_USE_EPOLL 0
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "FORBIDDEN: WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 /**
  *  @def WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
@@ -40,6 +40,8 @@
 
 // Include system and language headers
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #include <unistd.h>
@@ -47,6 +49,10 @@
 #include <errno.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if !WEAVE_SYSTEM_CONFIG_PLATFORM_PROVIDES_EVENT_FUNCTIONS
 #include <lwip/err.h>
@@ -95,10 +101,20 @@ Layer::Layer()
         sSystemEventHandlerDelegate.Init(HandleSystemLayerEvent);
 
     this->mEventDelegateList = NULL;
+#if !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     this->mTimerList = NULL;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     this->mTimerComplete = false;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->mTimerWheel = NULL;
+    this->mTimerIndex = NULL;
+    this->mTimerIndexSize = 0;
+    this->mNumIndexedTimers = 0;
+    this->mNumWheelTimers = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     this->mWakePipeIn = 0;
     this->mWakePipeOut = 0;
@@ -106,6 +122,12 @@ Layer::Layer()
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    this->mEPollFD = -1;
+    this->mWakePipeWatch.OnReady = HandleWakePipeReady;
+    this->mWakePipeWatch.AppState = this;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -127,6 +149,11 @@ Error Layer::Init(void* aContext)
     this->AddEventHandlerDelegate(sSystemEventHandlerDelegate);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    lReturn = this->InitTimerWheel();
+    SuccessOrExit(lReturn);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     // Create a Unix pipe to allow an arbitrary thread to wake the thread in the select loop.
     lOSReturn = ::pipe(lPipeFDs);
@@ -143,6 +170,15 @@ Error Layer::Init(void* aContext)
     lFlags = ::fcntl(this->mWakePipeOut, F_GETFL, 0);
     lOSReturn = ::fcntl(this->mWakePipeOut, F_SETFL, lFlags | O_NONBLOCK);
     VerifyOrExit(lOSReturn == 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    // Create the epoll instance and register the read end of the wake pipe with it.
+    this->mEPollFD = ::epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrExit(this->mEPollFD >= 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+
+    lReturn = this->AddEPollWatch(this->mWakePipeIn, EPOLLIN, this->mWakePipeWatch);
+    SuccessOrExit(lReturn);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     this->mLayerState = kLayerState_Initialized;
@@ -172,18 +208,43 @@ Error Layer::Shutdown()
         this->mWakePipeOut = -1;
         this->mWakePipeIn = -1;
     }
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (this->mEPollFD != -1)
+    {
+        ::close(this->mEPollFD);
+        this->mEPollFD = -1;
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif
 
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+    for (Timer* lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL;
+         lTimer = Timer::sPool.GetNext(*this, lTimer))
     {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
+        lTimer->Cancel();
+    }
 
-        if (lTimer != NULL)
-        {
-            lTimer->Cancel();
-        }
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Drop the retentions held by scheduled work that was cancelled above before it could run.
+    this->TakeScheduledWork();
+
+    for (Timer* lTimer = this->mPendingWork; lTimer != NULL; )
+    {
+        Timer* lNext = lTimer->mNextTimer;
+
+        lTimer->mNextTimer = NULL;
+        lTimer->Release();
+        lTimer = lNext;
     }
 
+    this->mPendingWork = NULL;
+    this->mPendingWorkTail = &this->mPendingWork;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->FreeTimerWheel();
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     this->mContext = NULL;
     this->mLayerState = kLayerState_NotInitialized;
 
@@ -288,26 +349,53 @@ void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void* aAppState)
     if (this->State() != kLayerState_Initialized)
         return;
 
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer* lTimer;
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    // Work scheduled from any thread is indexed only once the I/O thread takes it off the scheduled work stack.
+    if (this->mScheduledWork != NULL)
+        this->TakeScheduledWork();
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+    lTimer = Timer::FindIndexed(*this, aOnComplete, aAppState);
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    // Work posted to the LwIP event queue is never indexed, so look for it in the pool while any is outstanding.
+    if (lTimer == NULL && this->mNumPostedWork != 0)
     {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
+        for (lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL; lTimer = Timer::sPool.GetNext(*this, lTimer))
+        {
+            if (lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+                break;
+        }
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-        if (lTimer != NULL && lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+    if (lTimer != NULL)
+    {
+        lTimer->Cancel();
+    }
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    for (Timer* lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL;
+         lTimer = Timer::sPool.GetNext(*this, lTimer))
+    {
+        if (lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
         {
             lTimer->Cancel();
             break;
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 }
 
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 void Layer::CancelAllMatchingInetTimers(nl::Inet::InetLayer& aInetLayer, void* aOnCompleteInetLayer, void* aAppState)
 {
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
+    for (Timer* lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL;
+         lTimer = Timer::sPool.GetNext(*this, lTimer))
     {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
-
-        if (lTimer != NULL && lTimer->mInetLayer == &aInetLayer && lTimer->mOnCompleteInetLayer == aOnCompleteInetLayer &&
+        if (lTimer->mInetLayer == &aInetLayer && lTimer->mOnCompleteInetLayer == aOnCompleteInetLayer &&
             lTimer->mAppStateInetLayer == aAppState)
         {
             lTimer->Cancel();
@@ -317,6 +405,150 @@ void Layer::CancelAllMatchingInetTimers(nl::Inet::InetLayer& aInetLayer, void* a
 }
 #endif // WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+/**
+ *  Allocate, or empty, the timing wheel and the timer index, and align the wheel with the current epoch.
+ *
+ *  The wheel and the index are allocated when the layer is initialized, rather than embedded in it, so that a Layer object
+ *  stays small wherever it is declared.
+ *
+ *  @retval WEAVE_SYSTEM_NO_ERROR           On success.
+ *  @retval WEAVE_SYSTEM_ERROR_NO_MEMORY    If the wheel or the index could not be allocated.
+ */
+Error Layer::InitTimerWheel(void)
+{
+    if (this->mTimerWheel == NULL)
+    {
+        this->mTimerWheel = static_cast<Timer**>(calloc(WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE, sizeof(Timer*)));
+        this->mTimerIndex = static_cast<Timer**>(calloc(WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE, sizeof(Timer*)));
+        this->mTimerIndexSize = WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE;
+
+        if (this->mTimerWheel == NULL || this->mTimerIndex == NULL)
+        {
+            this->FreeTimerWheel();
+            return WEAVE_SYSTEM_ERROR_NO_MEMORY;
+        }
+    }
+    else
+    {
+        // An index grown by an earlier run of the layer keeps its size.
+        memset(this->mTimerWheel, 0, WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE * sizeof(Timer*));
+        memset(this->mTimerIndex, 0, this->mTimerIndexSize * sizeof(Timer*));
+    }
+
+    this->mTimerWheelTick = Timer::GetCurrentEpoch() / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+    this->mNumIndexedTimers = 0;
+    this->mNumWheelTimers = 0;
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    this->mPlatformTimerEpoch = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    this->mScheduledWork = NULL;
+    this->mPendingWork = NULL;
+    this->mPendingWorkTail = &this->mPendingWork;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    this->mNumPostedWork = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    return WEAVE_SYSTEM_NO_ERROR;
+}
+
+/**
+ *  Release the timing wheel and the timer index.  No timer may be armed.
+ */
+void Layer::FreeTimerWheel(void)
+{
+    free(this->mTimerWheel);
+    free(this->mTimerIndex);
+
+    this->mTimerWheel = NULL;
+    this->mTimerIndex = NULL;
+    this->mTimerIndexSize = 0;
+    this->mNumIndexedTimers = 0;
+    this->mNumWheelTimers = 0;
+}
+
+/**
+ *  Double the number of buckets in the timer index and rehash the indexed timers into them.
+ *
+ *  Should the larger index not be allocated, the current one is kept; lookups then slow down as its chains lengthen, but
+ *  timers can still be started and cancelled.
+ */
+void Layer::GrowTimerIndex(void)
+{
+    Timer** const lOldIndex = this->mTimerIndex;
+    const size_t lOldSize = this->mTimerIndexSize;
+    const size_t lNewSize = lOldSize * 2;
+    Timer** lNewIndex;
+
+    if (lNewSize / 2 != lOldSize)
+        return;
+
+    lNewIndex = static_cast<Timer**>(calloc(lNewSize, sizeof(Timer*)));
+    if (lNewIndex == NULL)
+        return;
+
+    this->mTimerIndex = lNewIndex;
+    this->mTimerIndexSize = lNewSize;
+    this->mNumIndexedTimers = 0;
+
+    for (size_t i = 0; i < lOldSize; i++)
+    {
+        Timer* lTimer = lOldIndex[i];
+
+        while (lTimer != NULL)
+        {
+            Timer* lNext = lTimer->mNextIndexed;
+
+            lTimer->LinkIndex(*this);
+            lTimer = lNext;
+        }
+    }
+
+    free(lOldIndex);
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+/**
+ *  Move the work scheduled from any thread onto the pending work list of the I/O thread, in the order in which it was
+ *  scheduled, and index it so that CancelTimer() can find it.
+ */
+void Layer::TakeScheduledWork(void)
+{
+    Timer* lWork = __sync_lock_test_and_set(&this->mScheduledWork, NULL);
+    Timer* lTaken = NULL;
+
+    // The stack holds the most recently scheduled work first.
+    while (lWork != NULL)
+    {
+        Timer* lNext = lWork->mNextTimer;
+
+        lWork->mNextTimer = lTaken;
+        lTaken = lWork;
+        lWork = lNext;
+    }
+
+    while (lTaken != NULL)
+    {
+        Timer* lNext = lTaken->mNextTimer;
+
+        // Work cancelled while on the stack is still appended, so that its retention is dropped once it is handled.
+        if (lTaken->OnComplete != NULL)
+            lTaken->LinkIndex(*this);
+
+        lTaken->mNextTimer = NULL;
+        *this->mPendingWorkTail = lTaken;
+        this->mPendingWorkTail = &lTaken->mNextTimer;
+        lTaken = lNext;
+    }
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 /**
  * @brief
  *   Schedules a function with a signature identical to
@@ -563,27 +795,7 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
 
     FD_SET(this->mWakePipeIn, aReadSet);
 
-    const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
-    Timer::Epoch lAwakenEpoch = kCurrentEpoch + static_cast<Timer::Epoch>(aSleepTime.tv_sec) * 1000 + aSleepTime.tv_usec / 1000;
-
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
-    {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
-
-        if (lTimer != NULL)
-        {
-            if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
-            {
-                lAwakenEpoch = kCurrentEpoch;
-                break;
-            }
-
-            if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
-                lAwakenEpoch = lTimer->mAwakenEpoch;
-        }
-    }
-
-    const Timer::Epoch kSleepTime = lAwakenEpoch - kCurrentEpoch;
+    const uint32_t kSleepTime = this->GetTimerSleepTime(static_cast<uint32_t>(aSleepTime.tv_sec) * 1000 + aSleepTime.tv_usec / 1000);
     aSleepTime.tv_sec = kSleepTime / 1000;
     aSleepTime.tv_usec = (kSleepTime % 1000) * 1000;
 }
@@ -607,48 +819,121 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
  */
 void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd_set* aExceptionSet)
 {
-    pthread_t lThreadSelf;
-
     if (this->State() != kLayerState_Initialized)
         return;
 
     if (aSetSize < 0)
         return;
 
-#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
-    lThreadSelf = pthread_self();
-#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
-
     if (aSetSize > 0)
     {
         // If we woke because of someone writing to the wake pipe, clear the contents of the pipe before returning.
         if (FD_ISSET(this->mWakePipeIn, aReadSet))
         {
-            while (true)
-            {
-                uint8_t lBytes[128];
-                int lTmp = ::read(this->mWakePipeIn, static_cast<void*>(lBytes), sizeof(lBytes));
-                if (lTmp < static_cast<int>(sizeof(lBytes)))
-                    break;
-            }
+            this->DrainWakePipe();
         }
     }
 
+    this->HandleExpiredTimers();
+}
+
+/**
+ *  Compute how long the I/O thread may sleep before the earliest armed timer expires.
+ *
+ *  @param[in]  aMaxSleepTime   The maximum sleep time, in milliseconds, requested by the caller.
+ *
+ *  @return The lesser of \c aMaxSleepTime and the time, in milliseconds, until the earliest timer expires.
+ */
+uint32_t Layer::GetTimerSleepTime(uint32_t aMaxSleepTime)
+{
     const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+    Timer::Epoch lAwakenEpoch = kCurrentEpoch + aMaxSleepTime;
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    if (this->mScheduledWork != NULL || this->mPendingWork != NULL)
+        return 0;
+
+    lAwakenEpoch = Timer::GetWheelAwakenEpoch(*this, kCurrentEpoch, lAwakenEpoch);
+
+    if (!Timer::IsEarlierEpoch(kCurrentEpoch, lAwakenEpoch))
+        lAwakenEpoch = kCurrentEpoch;
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    for (Timer* lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL;
+         lTimer = Timer::sPool.GetNext(*this, lTimer))
+    {
+        if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
+        {
+            lAwakenEpoch = kCurrentEpoch;
+            break;
+        }
+
+        if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
+            lAwakenEpoch = lTimer->mAwakenEpoch;
+    }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+    return static_cast<uint32_t>(lAwakenEpoch - kCurrentEpoch);
+}
+
+/**
+ *  Consume all bytes written to the wake pipe by WakeSelect().
+ */
+void Layer::DrainWakePipe(void)
+{
+    while (true)
+    {
+        uint8_t lBytes[128];
+        int lTmp = ::read(this->mWakePipeIn, static_cast<void*>(lBytes), sizeof(lBytes));
+        if (lTmp < static_cast<int>(sizeof(lBytes)))
+            break;
+    }
+}
+
+/**
+ *  Invoke the completion handlers of all timers that have expired.
+ *
+ *  While the handlers run, the calling thread is recorded as the I/O thread so that WakeSelect() may skip writing to the wake
+ *  pipe.
+ */
+void Layer::HandleExpiredTimers(void)
+{
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
-    this->mHandleSelectThread = lThreadSelf;
+    this->mHandleSelectThread = pthread_self();
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Run scheduled work in the order in which it was scheduled. Work scheduled by these handlers runs on the next pass.
+    Timer* lPending;
+
+    this->TakeScheduledWork();
+
+    lPending = this->mPendingWork;
+    this->mPendingWork = NULL;
+    this->mPendingWorkTail = &this->mPendingWork;
+
+    while (lPending != NULL)
     {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
+        Timer* lNext = lPending->mNextTimer;
 
-        if (lTimer != NULL && !Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
+        lPending->mNextTimer = NULL;
+        lPending->HandleComplete();
+        lPending->Release();
+        lPending = lNext;
+    }
+
+    Timer::ExpireWheelTimers(*this);
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+
+    for (Timer* lTimer = Timer::sPool.GetFirst(*this); lTimer != NULL;
+         lTimer = Timer::sPool.GetNext(*this, lTimer))
+    {
+        if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
         {
             lTimer->HandleComplete();
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
@@ -683,6 +968,123 @@ void Layer::WakeSelect()
     static_cast<void>(kIOResult);
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+/**
+ *  Register a file descriptor with the epoll instance of the layer object.
+ *
+ *  The file descriptor is registered once and edge-triggered. Each time its readiness for any of @p aEvents, or for an error or
+ *  hang-up condition, changes, the \c OnReady function of @p aWatch is invoked from HandleEPollResult().
+ *
+ *  @note
+ *      The file descriptor must be in non-blocking mode and must be removed with RemoveEPollWatch() before it is closed.
+ *
+ *  @param[in]  aFD     The file descriptor to watch.
+ *  @param[in]  aEvents The epoll event mask of interest, e.g. \c EPOLLIN. \c EPOLLET is implied.
+ *  @param[in]  aWatch  The registration record, which must remain valid until the file descriptor is removed.
+ *
+ *  @retval #WEAVE_SYSTEM_NO_ERROR                  On success.
+ *  @retval #WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE    If the layer has no epoll instance.
+ *  @retval other                                   The mapped POSIX error from epoll_ctl(2).
+ */
+Error Layer::AddEPollWatch(int aFD, uint32_t aEvents, EPollWatch& aWatch)
+{
+    Error lReturn = WEAVE_SYSTEM_NO_ERROR;
+    struct epoll_event lEvent;
+
+    VerifyOrExit(this->mEPollFD >= 0, lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+
+    lEvent.events = aEvents | EPOLLET;
+    lEvent.data.ptr = &aWatch;
+
+    if (::epoll_ctl(this->mEPollFD, EPOLL_CTL_ADD, aFD, &lEvent) != 0)
+        lReturn = nl::Weave::System::MapErrorPOSIX(errno);
+
+exit:
+    return lReturn;
+}
+
+/**
+ *  Remove a file descriptor previously registered with AddEPollWatch().
+ *
+ *  @param[in]  aFD     The file descriptor to stop watching.
+ *
+ *  @retval #WEAVE_SYSTEM_NO_ERROR                  On success.
+ *  @retval #WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE    If the layer has no epoll instance.
+ *  @retval other                                   The mapped POSIX error from epoll_ctl(2).
+ */
+Error Layer::RemoveEPollWatch(int aFD)
+{
+    Error lReturn = WEAVE_SYSTEM_NO_ERROR;
+    struct epoll_event lEvent;
+
+    VerifyOrExit(this->mEPollFD >= 0, lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+
+    // A non-NULL event pointer is required by kernels prior to 2.6.9.
+    lEvent.events = 0;
+    lEvent.data.ptr = NULL;
+
+    if (::epoll_ctl(this->mEPollFD, EPOLL_CTL_DEL, aFD, &lEvent) != 0)
+        lReturn = nl::Weave::System::MapErrorPOSIX(errno);
+
+exit:
+    return lReturn;
+}
+
+/**
+ *  Prepare the timeout for an @p epoll_wait() call on the epoll instance returned by GetEPollFD().
+ *
+ *  @param[inout]   aTimeoutMS  On input, the maximum time to wait in milliseconds, or -1 to wait indefinitely. On output, that
+ *                              value reduced to the time until the earliest timer expires.
+ */
+void Layer::PrepareEPoll(int& aTimeoutMS)
+{
+    if (this->State() != kLayerState_Initialized)
+        return;
+
+    const uint32_t kMaxSleepTime = (aTimeoutMS < 0) ? UINT32_MAX : static_cast<uint32_t>(aTimeoutMS);
+    const uint32_t kSleepTime = this->GetTimerSleepTime(kMaxSleepTime);
+
+    if (kSleepTime != UINT32_MAX)
+        aTimeoutMS = (kSleepTime > INT32_MAX) ? INT32_MAX : static_cast<int>(kSleepTime);
+}
+
+/**
+ *  Handle the events returned by an @p epoll_wait() call. This method dispatches each event to the \c OnReady function of its
+ *  registration record and then invokes the completion handlers of all expired timers.
+ *
+ *  @note
+ *      Like HandleSelectResult(), the \c OnReady functions are expected only to record readiness. The Inet layer acts on the
+ *      recorded readiness in nl::Inet::InetLayer::HandleEPollResult(), which must be called after this method.
+ *
+ *  @param[in]  aNumEvents  The return value of the @p epoll_wait() call.
+ *  @param[in]  aEvents     The array of events filled in by the @p epoll_wait() call.
+ */
+void Layer::HandleEPollResult(int aNumEvents, const struct epoll_event* aEvents)
+{
+    if (this->State() != kLayerState_Initialized)
+        return;
+
+    if (aNumEvents < 0)
+        return;
+
+    for (int i = 0; i < aNumEvents; i++)
+    {
+        EPollWatch* lWatch = static_cast<EPollWatch*>(aEvents[i].data.ptr);
+
+        lWatch->OnReady(*lWatch, aEvents[i].events);
+    }
+
+    this->HandleExpiredTimers();
+}
+
+void Layer::HandleWakePipeReady(EPollWatch& aWatch, uint32_t aEvents)
+{
+    static_cast<Layer*>(aWatch.AppState)->DrainWakePipe();
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -708,6 +1110,9 @@ Error Layer::HandleSystemLayerEvent(Object& aTarget, EventType aEventType, uintp
         break;
 
     case kEvent_ScheduleWork:
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+        __sync_fetch_and_sub(&static_cast<Timer&>(aTarget).SystemLayer().mNumPostedWork, 1);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
         static_cast<Timer&>(aTarget).HandleComplete();
         break;
 
@@ -34,6 +34,10 @@
 #include <sys/select.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 #include <pthread.h>
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
@@ -122,6 +126,28 @@ private:
 };
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+/**
+ *  @class EPollWatch
+ *
+ *  @brief
+ *      This is the registration record for a file descriptor watched by the epoll instance of a Layer object.
+ *
+ *      The owner of the file descriptor supplies an instance of this class, which must remain valid for as long as the file
+ *      descriptor is registered. The \c OnReady function is invoked with the raw epoll event mask each time the file descriptor
+ *      becomes ready. Because registration is edge-triggered, the owner must consume the file descriptor until it reports
+ *      \c EAGAIN before it can expect another notification.
+ */
+class NL_DLL_EXPORT EPollWatch
+{
+public:
+    typedef void (*ReadyFunct)(EPollWatch& aWatch, uint32_t aEvents);
+
+    ReadyFunct OnReady;     /**< The function to invoke when the file descriptor becomes ready. */
+    void* AppState;         /**< A pointer to application-specific state for \c OnReady. */
+};
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 /**
  *  @class Layer
  *
@@ -161,6 +187,15 @@ public:
     void WakeSelect(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    int GetEPollFD(void) const;
+    Error AddEPollWatch(int aFD, uint32_t aEvents, EPollWatch& aWatch);
+    Error RemoveEPollWatch(int aFD);
+
+    void PrepareEPoll(int& aTimeoutMS);
+    void HandleEPollResult(int aNumEvents, const struct epoll_event* aEvents);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     typedef Error (*EventHandler)(Object& aTarget, EventType aEventType, uintptr_t aArgument);
     Error AddEventHandlerDelegate(LwIPEventHandlerDelegate& aDelegate);
@@ -191,10 +226,38 @@ private:
     static LwIPEventHandlerDelegate sSystemEventHandlerDelegate;
 
     const LwIPEventHandlerDelegate* mEventDelegateList;
+#if !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Timer* mTimerList;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     bool mTimerComplete;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer** mTimerWheel;
+    Timer** mTimerIndex;
+    size_t mTimerIndexSize;
+    size_t mNumIndexedTimers;
+    uint64_t mTimerWheelTick;
+    unsigned int mNumWheelTimers;
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    uint64_t mPlatformTimerEpoch;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    Timer* volatile mScheduledWork;
+    Timer* mPendingWork;
+    Timer** mPendingWorkTail;
+
+    void TakeScheduledWork(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    volatile unsigned int mNumPostedWork;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    Error InitTimerWheel(void);
+    void FreeTimerWheel(void);
+    void GrowTimerIndex(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     int mWakePipeIn;
     int mWakePipeOut;
@@ -202,6 +265,17 @@ private:
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     pthread_t mHandleSelectThread;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    int mEPollFD;
+    EPollWatch mWakePipeWatch;
+
+    static void HandleWakePipeReady(EPollWatch& aWatch, uint32_t aEvents);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+    uint32_t GetTimerSleepTime(uint32_t aMaxSleepTime);
+    void DrainWakePipe(void);
+    void HandleExpiredTimers(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -235,6 +309,16 @@ inline LayerState Layer::State(void) const
     return this->mLayerState;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+/**
+ * This returns the file descriptor of the epoll instance owned by the layer object, or -1 if the layer is not initialized.
+ */
+inline int Layer::GetEPollFD(void) const
+{
+    return this->mEPollFD;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 } // namespace System
 } // namespace Weave
 } // namespace nl
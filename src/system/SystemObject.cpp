@@ -34,6 +34,7 @@
 
 // Include local headers
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 namespace nl {
@@ -53,6 +54,11 @@ NL_DLL_EXPORT void Object::Release(void)
     {
         this->mSystemLayer = NULL;
         __sync_synchronize();
+
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+        if (this->mSlabPool != NULL)
+            this->mSlabPool->Recycle(*this);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
     }
     else if (oldCount == 0)
     {
@@ -77,6 +83,250 @@ NL_DLL_EXPORT bool Object::TryCreate(Layer& aLayer, size_t aOctets)
     return lReturn;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+/**
+ *  @brief
+ *      Returns a pointer to the object at \c aIndex, whether or not it is in use, or \c NULL if the pool holds no such object.
+ */
+Object* SlabObjectPoolBase::Get(size_t aIndex)
+{
+    const unsigned int lNumSlabs = this->mNumSlabs;
+
+    for (unsigned int lSlab = 0; lSlab < lNumSlabs; ++lSlab)
+    {
+        const Slab& lCandidate = this->mSlabs[lSlab];
+
+        if (aIndex < lCandidate.mFirstIndex + lCandidate.mNumObjects)
+            return reinterpret_cast<Object*>(lCandidate.mObjects + (aIndex - lCandidate.mFirstIndex) * this->mObjectSize);
+    }
+
+    return NULL;
+}
+
+/**
+ *  @brief
+ *      Returns a pointer to the next object in use after \c aObject, or the first object in use if \c aObject is \c NULL.
+ */
+Object* SlabObjectPoolBase::GetNext(const Object* aObject)
+{
+    unsigned int lSlab = 0;
+    size_t lOffset = 0;
+
+    if (aObject != NULL)
+    {
+        lSlab = this->FindSlab(*aObject, lOffset);
+        lOffset++;
+    }
+
+    return this->FindInUse(lSlab, lOffset);
+}
+
+/**
+ *  @brief
+ *      Tries to initially retain an object from the free list, allocating a new slab if the free list is empty.
+ *
+ *  @return A pointer to the object, or \c NULL if the pool cannot grow.
+ */
+Object* SlabObjectPoolBase::TryCreate(Layer& aLayer, size_t aObjectSize, size_t aSlabSize)
+{
+    Object* lReturn = NULL;
+    size_t lOffset;
+    unsigned int lSlab;
+
+    this->Lock();
+
+    VerifyOrExit(this->mFreeList != NULL || this->Grow(aObjectSize, aSlabSize), );
+
+    lReturn = this->mFreeList;
+    this->mFreeList = lReturn->mNextFree;
+    lReturn->mNextFree = NULL;
+
+    lSlab = this->FindSlab(*lReturn, lOffset);
+    this->mSlabs[lSlab].mInUse[lOffset / kBitsPerWord] |= static_cast<BitmapWord>(1) << (lOffset % kBitsPerWord);
+
+    if (++this->mNumInUse > this->mHighWatermark)
+        this->mHighWatermark = this->mNumInUse;
+
+exit:
+    this->Unlock();
+
+    // A dead object is never retained, so the initial retention cannot fail.
+    if (lReturn != NULL)
+    {
+        VerifyOrDie(lReturn->TryCreate(aLayer, aObjectSize));
+    }
+
+    return lReturn;
+}
+
+void SlabObjectPoolBase::GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse,
+                                       nl::Weave::System::Stats::count_t& aHighWatermark)
+{
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    unsigned int lNumInUse;
+    unsigned int lHighWatermark;
+
+    this->Lock();
+    lNumInUse = this->mNumInUse;
+    lHighWatermark = this->mHighWatermark;
+    this->Unlock();
+
+    if (lNumInUse > WEAVE_SYS_STATS_COUNT_MAX)
+    {
+        lNumInUse = WEAVE_SYS_STATS_COUNT_MAX;
+    }
+    if (lHighWatermark > WEAVE_SYS_STATS_COUNT_MAX)
+    {
+        lHighWatermark = WEAVE_SYS_STATS_COUNT_MAX;
+    }
+    aNumInUse = static_cast<nl::Weave::System::Stats::count_t>(lNumInUse);
+    aHighWatermark = static_cast<nl::Weave::System::Stats::count_t>(lHighWatermark);
+#endif
+}
+
+void SlabObjectPoolBase::Lock(void)
+{
+    while (__sync_lock_test_and_set(&this->mLock, 1))
+    {
+        while (this->mLock)
+            continue;
+    }
+}
+
+void SlabObjectPoolBase::Unlock(void)
+{
+    __sync_lock_release(&this->mLock);
+}
+
+/**
+ *  @brief
+ *      Allocates the next slab, twice the size of the previous one, and puts its objects on the free list. Called with the lock
+ *      held.
+ *
+ *  @return \c true on success, \c false if the slab limit has been reached or memory is exhausted.
+ */
+bool SlabObjectPoolBase::Grow(size_t aObjectSize, size_t aSlabSize)
+{
+    const unsigned int lSlab = this->mNumSlabs;
+    Slab* lNew = NULL;
+    bool lReturn = false;
+
+    VerifyOrExit(lSlab < WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS, );
+
+    lNew = &this->mSlabs[lSlab];
+    lNew->mNumObjects = aSlabSize << lSlab;
+    lNew->mFirstIndex = (lSlab > 0) ? this->mSlabs[lSlab - 1].mFirstIndex + this->mSlabs[lSlab - 1].mNumObjects : 0;
+    lNew->mObjects = static_cast<uint8_t*>(calloc(lNew->mNumObjects, aObjectSize));
+    lNew->mInUse = static_cast<BitmapWord*>(calloc((lNew->mNumObjects + kBitsPerWord - 1) / kBitsPerWord, sizeof(BitmapWord)));
+
+    if (lNew->mObjects == NULL || lNew->mInUse == NULL)
+    {
+        free(lNew->mObjects);
+        free(lNew->mInUse);
+        memset(lNew, 0, sizeof(*lNew));
+        ExitNow();
+    }
+
+    // Push in reverse so that objects are handed out in index order.
+    for (size_t lOffset = lNew->mNumObjects; lOffset-- > 0; )
+    {
+        Object& lObject = *reinterpret_cast<Object*>(lNew->mObjects + lOffset * aObjectSize);
+
+        lObject.mSlabPool = this;
+        lObject.mNextFree = this->mFreeList;
+        this->mFreeList = &lObject;
+    }
+
+    this->mObjectSize = aObjectSize;
+
+    // Publish the slab to lock-free readers only once it is complete.
+    __sync_synchronize();
+    this->mNumSlabs = lSlab + 1;
+    lReturn = true;
+
+exit:
+    return lReturn;
+}
+
+/**
+ *  @brief
+ *      Finds the slab holding \c aObject and the offset of the object within it.
+ */
+unsigned int SlabObjectPoolBase::FindSlab(const Object& aObject, size_t& aOffset) const
+{
+    const uint8_t* const lObject = reinterpret_cast<const uint8_t*>(&aObject);
+    const unsigned int lNumSlabs = this->mNumSlabs;
+    unsigned int lSlab;
+
+    for (lSlab = 0; lSlab < lNumSlabs; ++lSlab)
+    {
+        const Slab& lCandidate = this->mSlabs[lSlab];
+
+        if (lObject >= lCandidate.mObjects && lObject < lCandidate.mObjects + lCandidate.mNumObjects * this->mObjectSize)
+        {
+            aOffset = static_cast<size_t>(lObject - lCandidate.mObjects) / this->mObjectSize;
+            break;
+        }
+    }
+
+    VerifyOrDie(lSlab < lNumSlabs);
+
+    return lSlab;
+}
+
+/**
+ *  @brief
+ *      Returns a pointer to the first object in use at or after \c aOffset in slab \c aSlab, continuing into later slabs, or
+ *      \c NULL if there is none.
+ */
+Object* SlabObjectPoolBase::FindInUse(unsigned int aSlab, size_t aOffset)
+{
+    const unsigned int lNumSlabs = this->mNumSlabs;
+
+    for (; aSlab < lNumSlabs; ++aSlab, aOffset = 0)
+    {
+        const Slab& lSlab = this->mSlabs[aSlab];
+
+        while (aOffset < lSlab.mNumObjects)
+        {
+            const size_t lWordIndex = aOffset / kBitsPerWord;
+            const BitmapWord lWord = lSlab.mInUse[lWordIndex] & (~static_cast<BitmapWord>(0) << (aOffset % kBitsPerWord));
+
+            if (lWord != 0)
+            {
+                aOffset = lWordIndex * kBitsPerWord + static_cast<size_t>(__builtin_ctzl(lWord));
+                return reinterpret_cast<Object*>(lSlab.mObjects + aOffset * this->mObjectSize);
+            }
+
+            aOffset = (lWordIndex + 1) * kBitsPerWord;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ *  @brief
+ *      Returns a dead object to the free list. Called by Object::Release().
+ */
+void SlabObjectPoolBase::Recycle(Object& aObject)
+{
+    size_t lOffset;
+    unsigned int lSlab;
+
+    this->Lock();
+
+    lSlab = this->FindSlab(aObject, lOffset);
+    this->mSlabs[lSlab].mInUse[lOffset / kBitsPerWord] &= ~(static_cast<BitmapWord>(1) << (lOffset % kBitsPerWord));
+
+    aObject.mNextFree = this->mFreeList;
+    this->mFreeList = &aObject;
+    this->mNumInUse--;
+
+    this->Unlock();
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 void Object::DeferredRelease(Object::ReleaseDeferralErrorTactic aTactic)
 {
@@ -24,6 +24,9 @@
  *        - class nl::Weave::System::Object
  *        - template<typename ALIGN, size_t SIZE> union nl::Weave::System::ObjectArena
  *        - template<class T, unsigned int N> class nl::Weave::System::ObjectPool
+ *        - class nl::Weave::System::SlabObjectPoolBase
+ *        - template<class T, unsigned int N> class nl::Weave::System::SlabObjectPool
+ *        - template<class T, unsigned int N> class nl::Weave::System::LayerObjectPool
  */
 
 #ifndef SYSTEMOBJECT_H
@@ -53,6 +56,10 @@ namespace System {
 // Forward class and class template declarations
 class Layer;
 template<class T, unsigned int N> class ObjectPool;
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+class SlabObjectPoolBase;
+template<class T, unsigned int N> class SlabObjectPool;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
 
 /**
  *  @class Object
@@ -73,6 +80,10 @@ template<class T, unsigned int N> class ObjectPool;
 class NL_DLL_EXPORT Object
 {
     template<class T, unsigned int N> friend class ObjectPool;
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    friend class SlabObjectPoolBase;
+    template<class T, unsigned int N> friend class SlabObjectPool;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
 
 public:
     /** Test whether this object is retained by \c aLayer. Concurrency safe. */
@@ -104,6 +115,11 @@ private:
     Layer* volatile mSystemLayer;   /**< Pointer to the layer object that owns this object. */
     unsigned int mRefCount;         /**< Count of remaining calls to Release before object is dead. */
 
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    SlabObjectPoolBase* mSlabPool;  /**< Slab pool that owns this object, or NULL if it lives in a fixed ObjectPool. */
+    Object* mNextFree;              /**< Next object in the free list of the slab pool. */
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
     /** If not already retained, attempt initial retention of this object for \c aLayer and zero up to \c aOctets. */
     bool TryCreate(Layer& aLayer, size_t aOctets);
 
@@ -181,6 +197,8 @@ public:
     static size_t Size(void);
 
     T* Get(const Layer& aLayer, size_t aIndex);
+    T* GetFirst(const Layer& aLayer);
+    T* GetNext(const Layer& aLayer, const T* aObject);
     T* TryCreate(Layer& aLayer);
     void GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse, nl::Weave::System::Stats::count_t& aHighWatermark);
 
@@ -223,6 +241,38 @@ inline T* ObjectPool<T, N>::Get(const Layer& aLayer, size_t aIndex)
     return (lReturn != NULL) && lReturn->IsRetained(aLayer) ? lReturn : NULL;
 }
 
+/**
+ *  @brief
+ *      Returns a pointer to the first object in the pool retained by \c aLayer, or \c NULL if there is none.
+ */
+template<class T, unsigned int N>
+inline T* ObjectPool<T, N>::GetFirst(const Layer& aLayer)
+{
+    T* lReturn = NULL;
+
+    for (size_t lIndex = 0; lIndex < N && lReturn == NULL; ++lIndex)
+        lReturn = this->Get(aLayer, lIndex);
+
+    return lReturn;
+}
+
+/**
+ *  @brief
+ *      Returns a pointer to the next object in the pool after \c aObject that is retained by \c aLayer, or \c NULL if there is
+ *      none.
+ */
+template<class T, unsigned int N>
+inline T* ObjectPool<T, N>::GetNext(const Layer& aLayer, const T* aObject)
+{
+    T* lReturn = NULL;
+
+    for (size_t lIndex = static_cast<size_t>(aObject - reinterpret_cast<T*>(mArena.uMemory)) + 1; lIndex < N && lReturn == NULL;
+         ++lIndex)
+        lReturn = this->Get(aLayer, lIndex);
+
+    return lReturn;
+}
+
 /**
  *  @brief
  *      Tries to initially retain the first object in the pool that is not retained by any layer.
@@ -336,6 +386,174 @@ inline void ObjectPool<T, N>::GetStatistics(nl::Weave::System::Stats::count_t& a
 #endif
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+/**
+ *  @class SlabObjectPoolBase
+ *
+ *  @brief
+ *      The type-independent part of SlabObjectPool<T, N>.
+ *
+ *  @note
+ *      Objects are carved from slabs allocated from the heap on demand. The first slab holds \c N objects and each further slab
+ *      twice as many as the one before, up to #WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS slabs. Slabs are never returned to
+ *      the heap, so pointers to and indices of objects remain valid for the lifetime of the pool. Dead objects are kept on a free
+ *      list, and a bitmap of the objects in use lets iteration skip over unused ones a word at a time.
+ *
+ *      An instance whose memory is all zeros is a valid empty pool, so pools with static storage duration need no constructor.
+ */
+class NL_DLL_EXPORT SlabObjectPoolBase
+{
+public:
+    size_t Size(void) const;
+
+protected:
+    Object* Get(size_t aIndex);
+    Object* GetNext(const Object* aObject);
+    Object* TryCreate(Layer& aLayer, size_t aObjectSize, size_t aSlabSize);
+    void GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse, nl::Weave::System::Stats::count_t& aHighWatermark);
+
+private:
+    friend class Object;
+
+    typedef unsigned long BitmapWord;
+
+    enum
+    {
+        kBitsPerWord = sizeof(BitmapWord) * 8
+    };
+
+    struct Slab
+    {
+        uint8_t* mObjects;          /**< Storage for the objects of the slab. */
+        BitmapWord* mInUse;         /**< One bit per object, set while the object is in use. */
+        size_t mFirstIndex;         /**< Pool index of the first object of the slab. */
+        size_t mNumObjects;         /**< Number of objects in the slab. */
+    };
+
+    Slab mSlabs[WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS];
+    volatile unsigned int mNumSlabs;
+    size_t mObjectSize;
+    Object* mFreeList;
+    volatile int mLock;
+    unsigned int mNumInUse;
+    unsigned int mHighWatermark;
+
+    void Lock(void);
+    void Unlock(void);
+    bool Grow(size_t aObjectSize, size_t aSlabSize);
+    unsigned int FindSlab(const Object& aObject, size_t& aOffset) const;
+    Object* FindInUse(unsigned int aSlab, size_t aOffset);
+    void Recycle(Object& aObject);
+};
+
+/**
+ *  @brief
+ *      Returns the number of objects the pool can hold without growing.
+ */
+inline size_t SlabObjectPoolBase::Size(void) const
+{
+    const unsigned int lNumSlabs = this->mNumSlabs;
+
+    return (lNumSlabs > 0) ? this->mSlabs[lNumSlabs - 1].mFirstIndex + this->mSlabs[lNumSlabs - 1].mNumObjects : 0;
+}
+
+/**
+ *  @brief
+ *      A class template used for allocating Object subclass objects from a pool that grows in slabs.
+ *
+ *  @note
+ *      This has the same interface and object retention semantics as ObjectPool<T, N>, except that the number of objects is not
+ *      fixed at \c N. TryCreate() takes constant time, apart from the occasional allocation of a slab, and GetFirst() / GetNext()
+ *      visit only the objects in use.
+ *
+ *  @tparam     T   a subclass of Object to be allocated from the pool.
+ *  @tparam     N   a positive integer number of objects of class T in the first slab.
+ */
+template<class T, unsigned int N>
+class SlabObjectPool : public SlabObjectPoolBase
+{
+public:
+    T* Get(const Layer& aLayer, size_t aIndex);
+    T* GetFirst(const Layer& aLayer);
+    T* GetNext(const Layer& aLayer, const T* aObject);
+    T* TryCreate(Layer& aLayer);
+    using SlabObjectPoolBase::GetStatistics;
+
+private:
+    T* Retained(const Layer& aLayer, Object* aObject);
+};
+
+template<class T, unsigned int N>
+inline T* SlabObjectPool<T, N>::Retained(const Layer& aLayer, Object* aObject)
+{
+    // Skip objects in use by other layers.
+    while (aObject != NULL && !aObject->IsRetained(aLayer))
+        aObject = SlabObjectPoolBase::GetNext(aObject);
+
+    return static_cast<T*>(aObject);
+}
+
+/**
+ *  @brief
+ *      Returns a pointer the object at \c aIndex or \c NULL if the object is not retained by \c aLayer.
+ */
+template<class T, unsigned int N>
+inline T* SlabObjectPool<T, N>::Get(const Layer& aLayer, size_t aIndex)
+{
+    Object* lObject = SlabObjectPoolBase::Get(aIndex);
+
+    return (lObject != NULL) && lObject->IsRetained(aLayer) ? static_cast<T*>(lObject) : NULL;
+}
+
+/**
+ *  @brief
+ *      Returns a pointer to the first object in the pool retained by \c aLayer, or \c NULL if there is none.
+ */
+template<class T, unsigned int N>
+inline T* SlabObjectPool<T, N>::GetFirst(const Layer& aLayer)
+{
+    return this->Retained(aLayer, SlabObjectPoolBase::GetNext(NULL));
+}
+
+/**
+ *  @brief
+ *      Returns a pointer to the next object in the pool after \c aObject that is retained by \c aLayer, or \c NULL if there is
+ *      none.
+ */
+template<class T, unsigned int N>
+inline T* SlabObjectPool<T, N>::GetNext(const Layer& aLayer, const T* aObject)
+{
+    return this->Retained(aLayer, SlabObjectPoolBase::GetNext(aObject));
+}
+
+/**
+ *  @brief
+ *      Tries to initially retain an object from the free list of the pool, growing the pool if the free list is empty.
+ */
+template<class T, unsigned int N>
+inline T* SlabObjectPool<T, N>::TryCreate(Layer& aLayer)
+{
+    return static_cast<T*>(SlabObjectPoolBase::TryCreate(aLayer, sizeof(T), N));
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
+/**
+ *  @brief
+ *      The class template of the pools from which the Weave System and Inet layers allocate their objects.
+ *
+ *  @note
+ *      This is SlabObjectPool<T, N> when #WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS is asserted, and ObjectPool<T, N> otherwise.
+ */
+template<class T, unsigned int N>
+class LayerObjectPool :
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    public SlabObjectPool<T, N>
+#else // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    public ObjectPool<T, N>
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+{
+};
+
 } // namespace System
 } // namespace Weave
 } // namespace nl
@@ -110,8 +110,8 @@ uint8_t* PacketBuffer::Start() const
  */
 void PacketBuffer::SetStart(uint8_t* aNewStart)
 {
-    uint8_t* const kStart = reinterpret_cast<uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
-    uint8_t* const kEnd = kStart + this->AllocSize();
+    uint8_t* const kStart = this->BufferBase();
+    uint8_t* const kEnd = this->BufferLimit();
 
     if (aNewStart < kStart)
         aNewStart = kStart;
@@ -186,9 +186,8 @@ uint16_t PacketBuffer::TotalLength() const
  */
 uint16_t PacketBuffer::MaxDataLength() const
 {
-    const uint8_t* const kStart = reinterpret_cast<const uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
-    const ptrdiff_t kDelta = static_cast<uint8_t*>(this->payload) - kStart;
-    return static_cast<uint16_t>(this->AllocSize() - kDelta);
+    const ptrdiff_t kDelta = this->BufferLimit() - static_cast<uint8_t*>(this->payload);
+    return static_cast<uint16_t>(kDelta);
 }
 
 /**
@@ -208,8 +207,8 @@ uint16_t PacketBuffer::AvailableDataLength() const
  */
 uint16_t PacketBuffer::ReservedSize() const
 {
-    const ptrdiff_t kDelta = static_cast<uint8_t*>(this->payload) - reinterpret_cast<const uint8_t*>(this);
-    return static_cast<uint16_t>(kDelta - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE);
+    const ptrdiff_t kDelta = static_cast<uint8_t*>(this->payload) - this->BufferBase();
+    return static_cast<uint16_t>(kDelta);
 }
 
 /**
@@ -268,7 +267,7 @@ PacketBuffer* PacketBuffer::DetachTail()
  */
 void PacketBuffer::CompactHead()
 {
-    uint8_t* const kStart = reinterpret_cast<uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+    uint8_t* const kStart = this->BufferBase();
 
     if (this->payload != kStart)
     {
@@ -357,17 +356,25 @@ PacketBuffer* PacketBuffer::Consume(uint16_t aConsumeLength)
  *  Ensure the buffer has at least the specified amount of reserved space moving the data in the buffer forward to make room if
  *  necessary.
  *
+ *  A buffer created by `PacketBuffer::SplitConsumed()` that still shares the storage of another buffer first has its data
+ *  copied into storage of its own, placed after exactly \c aReservedSize octets, so that it can be reused to send a message.
+ *
  *  @param[in] aReservedSize - number of bytes desired for the headers.
  *
  *  @return \c true if the requested reserved size is available, \c false if there's not enough room in the buffer.
  */
 bool PacketBuffer::EnsureReservedSize(uint16_t aReservedSize)
 {
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    if (this->owner != NULL)
+        return this->Unshare(aReservedSize);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
     const uint16_t kCurrentReservedSize = this->ReservedSize();
     if (aReservedSize <= kCurrentReservedSize)
         return true;
 
-    if ((aReservedSize + this->len) > this->AllocSize())
+    if ((aReservedSize + this->len) > (kCurrentReservedSize + this->MaxDataLength()))
         return false;
 
     const uint16_t kMoveLength = aReservedSize - kCurrentReservedSize;
@@ -401,6 +408,131 @@ bool PacketBuffer::AlignPayload(uint16_t aAlignBytes)
     return (this->EnsureReservedSize(this->ReservedSize() + kPayloadShift));
 }
 
+/**
+ * Split the most recently consumed data off the front of the buffer into a new buffer.
+ *
+ *  The \c aLength octets immediately preceding the current data start position (typically data just parsed and consumed
+ *  from the buffer) become the data of the returned buffer.  All space preceding the current data start position becomes
+ *  inaccessible through the current buffer, so that neither buffer can write into octets belonging to the other.  The current
+ *  buffer must be the head of its chain.
+ *
+ *  In the socket-based implementations the returned buffer is a view that shares the storage of the current buffer and holds
+ *  a reference to it; no data is copied and the storage is released once both have been freed.  A view can reach no reserved
+ *  or available space beyond its data, since that belongs to other messages.  It is allocated with storage of its own all the
+ *  same, into which EnsureReservedSize() copies the data, releasing the shared storage, when the view is to be reused for
+ *  sending.  With LwIP the data is copied into a newly allocated buffer of the default size at once.
+ *
+ *  @param[in] aLength - number of octets preceding the current data start position to split off.  It is clamped to the
+ *      reserved size of the buffer.
+ *
+ *  @return a buffer holding the split-off data, or \c NULL if no buffer could be allocated.
+ */
+PacketBuffer* PacketBuffer::SplitConsumed(uint16_t aLength)
+{
+    uint8_t* const kDataStart = static_cast<uint8_t*>(this->payload);
+    const uint16_t kReservedSize = this->ReservedSize();
+    PacketBuffer* lView;
+
+    if (aLength > kReservedSize)
+        aLength = kReservedSize;
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    lView = PacketBuffer::New(0);
+    if (lView != NULL)
+    {
+        if (lView->MaxDataLength() < aLength)
+        {
+            PacketBuffer::Free(lView);
+            return NULL;
+        }
+
+        memcpy(lView->payload, kDataStart - aLength, aLength);
+        lView->len = lView->tot_len = aLength;
+    }
+
+#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    PacketBuffer* const kOwner = (this->owner != NULL) ? static_cast<PacketBuffer*>(this->owner) : this;
+    uint8_t* const kStorage = reinterpret_cast<uint8_t*>(kOwner) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+
+    lView = PacketBuffer::New(0);
+    if (lView != NULL)
+    {
+        kOwner->AddRef();
+
+        lView->owner = kOwner;
+        lView->base = static_cast<uint16_t>(kDataStart - aLength - kStorage);
+        lView->view_size = aLength;
+        lView->payload = kDataStart - aLength;
+        lView->len = lView->tot_len = aLength;
+
+        if (this->owner != NULL)
+            this->view_size = static_cast<uint16_t>(this->view_size - kReservedSize);
+        this->base = static_cast<uint16_t>(kDataStart - kStorage);
+    }
+
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    return lView;
+}
+
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
+/**
+ * Copy the data of a view into the storage of its own, after \c aReservedSize octets, and release the storage it shared.
+ *
+ *  @return \c true on success, \c false if the data and reserved space do not fit, in which case the view is left unchanged.
+ */
+bool PacketBuffer::Unshare(uint16_t aReservedSize)
+{
+    PacketBuffer* const kOwner = static_cast<PacketBuffer*>(this->owner);
+    uint8_t* const kStorage = reinterpret_cast<uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+
+    // Without its owner, the view reports the size of its own allocation.
+    this->owner = NULL;
+    if (static_cast<size_t>(aReservedSize) + this->len > this->AllocSize())
+    {
+        this->owner = kOwner;
+        return false;
+    }
+
+    memcpy(kStorage + aReservedSize, this->payload, this->len);
+    this->payload = kStorage + aReservedSize;
+    this->base = 0;
+    this->view_size = 0;
+
+    PacketBuffer::Free(kOwner);
+
+    return true;
+}
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+/**
+ * Get pointer to first octet of storage accessible through the buffer.
+ */
+uint8_t* PacketBuffer::BufferBase() const
+{
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    return reinterpret_cast<uint8_t*>(const_cast<PacketBuffer*>(this)) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    const struct pbuf* const kStorageOwner = (this->owner != NULL) ? this->owner : this;
+    return reinterpret_cast<uint8_t*>(const_cast<struct pbuf*>(kStorageOwner)) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + this->base;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+}
+
+/**
+ * Get pointer one past the last octet of storage accessible through the buffer.
+ */
+uint8_t* PacketBuffer::BufferLimit() const
+{
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    if (this->owner != NULL)
+        return this->BufferBase() + this->view_size;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    return reinterpret_cast<uint8_t*>(const_cast<PacketBuffer*>(this)) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + this->AllocSize();
+}
+
 /**
  * Get pointer to next buffer in chain.
  *
@@ -489,9 +621,14 @@ PacketBuffer* PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, size_t
     lPacket->len = lPacket->tot_len = 0;
     lPacket->next = NULL;
     lPacket->ref = 1;
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
     lPacket->alloc_size = lAllocSize;
 #endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+    lPacket->base = 0;
+    lPacket->view_size = 0;
+    lPacket->owner = NULL;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     return lPacket;
 }
@@ -571,17 +708,20 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
 
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-    LOCK_BUF_POOL();
-
     while (aPacket != NULL)
     {
         PacketBuffer* lNextPacket = static_cast<PacketBuffer*>(aPacket->next);
+        PacketBuffer* lOwner = NULL;
+
+        LOCK_BUF_POOL();
 
         VerifyOrDieWithMsg(aPacket->ref > 0, WeaveSystemLayer, "SystemPacketBuffer::Free: aPacket->ref = 0");
 
         aPacket->ref--;
         if (aPacket->ref == 0)
         {
+            lOwner = static_cast<PacketBuffer*>(aPacket->owner);
+
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
             aPacket->next = sFreeList;
@@ -589,15 +729,21 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
 #else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
             free(aPacket);
 #endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
-            aPacket = lNextPacket;
         }
         else
         {
-            aPacket = NULL;
+            lNextPacket = NULL;
         }
-    }
 
-    UNLOCK_BUF_POOL();
+        UNLOCK_BUF_POOL();
+
+        // Release the reference a view holds on the buffer whose storage it shares.  Owners are never views themselves,
+        // so this recurses at most once.
+        if (lOwner != NULL)
+            PacketBuffer::Free(lOwner);
+
+        aPacket = lNextPacket;
+    }
 
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 }
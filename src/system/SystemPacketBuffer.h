@@ -58,6 +58,9 @@ struct pbuf
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
     uint16_t alloc_size;
 #endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
+    uint16_t base;          // Offset, within the owning allocation, of the first octet accessible through this buffer.
+    uint16_t view_size;     // For a view, the number of octets accessible through it.
+    struct pbuf* owner;     // For a view, the buffer whose storage it shares; otherwise NULL.
 };
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
@@ -119,6 +122,7 @@ public:
     void ConsumeHead(uint16_t aConsumeLength);
     bool EnsureReservedSize(uint16_t aReservedSize);
     bool AlignPayload(uint16_t aAlignBytes);
+    PacketBuffer* SplitConsumed(uint16_t aLength);
 
     void AddRef(void);
 
@@ -134,6 +138,12 @@ public:
     static PacketBuffer* FreeHead(PacketBuffer* aPacket);
 
 private:
+    uint8_t* BufferBase(void) const;
+    uint8_t* BufferLimit(void) const;
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    bool Unshare(uint16_t aReservedSize);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
 #if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
     static PacketBuffer* sFreeList;
 
@@ -207,6 +217,10 @@ typedef union
  *
  *  @note    The allocation size is equal or greater than \c aAllocSize paramater to \c Create method).
  *
+ *  @note    For a view created by `PacketBuffer::SplitConsumed()` that still shares the storage of another buffer, this is
+ *           the number of octets of that storage the view can reach, i.e. the length of its data when it was split off, not
+ *           the size of either allocation.
+ *
  *  @return     size of the allocation
  */
 inline size_t PacketBuffer::AllocSize(void) const
@@ -222,6 +236,8 @@ inline size_t PacketBuffer::AllocSize(void) const
     return LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
 #endif // !LWIP_PBUF_FROM_CUSTOM_POOLS
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    if (this->owner != NULL)
+        return static_cast<size_t>(this->view_size);
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
     return static_cast<size_t>(this->alloc_size);
 #else // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
@@ -76,7 +76,7 @@ namespace nl {
 namespace Weave {
 namespace System {
 
-ObjectPool<Timer, WEAVE_SYSTEM_CONFIG_NUM_TIMERS> Timer::sPool;
+LayerObjectPool<Timer, WEAVE_SYSTEM_CONFIG_NUM_TIMERS> Timer::sPool;
 
 /**
  *  This method returns the current epoch, corrected by system sleep with the system timescale, in milliseconds.
@@ -125,9 +125,9 @@ bool Timer::IsEarlierEpoch(const Timer::Epoch &inFirst, const Timer::Epoch &inSe
  */
 Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, void* aAppState)
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Layer& lLayer = this->SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP || WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     WEAVE_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, aDelayMilliseconds = 0);
 
@@ -138,7 +138,23 @@ Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, voi
         WeaveDie();
     }
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->LinkIndex(lLayer);
+    this->LinkWheel(lLayer);
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    // if this is the only armed timer, or it expires before the platform timer is due, the platform timer needs (re-)starting
+    // provided that the system is not currently processing expired timers, in which case it is left to HandleExpiredTimers()
+    // to re-start the timer.
+    if (!lLayer.mTimerComplete &&
+        (lLayer.mNumWheelTimers == 1 || this->IsEarlierEpoch(this->mAwakenEpoch, lLayer.mPlatformTimerEpoch)))
+    {
+        lLayer.mPlatformTimerEpoch = this->mAwakenEpoch;
+        lLayer.StartPlatformTimer(aDelayMilliseconds);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+#elif WEAVE_SYSTEM_CONFIG_USE_LWIP
     // add to the sorted list of timers. Earliest timer appears first.
     if (lLayer.mTimerList == NULL ||
         this->IsEarlierEpoch(this->mAwakenEpoch, lLayer.mTimerList->mAwakenEpoch))
@@ -172,7 +188,7 @@ Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, voi
         this->mNextTimer = lTimer->mNextTimer;
         lTimer->mNextTimer = this;
     }
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     return WEAVE_SYSTEM_NO_ERROR;
 }
@@ -190,9 +206,31 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
     }
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Posted work is not indexed; counting it lets CancelTimer() know when it must also search the pool.
+    __sync_fetch_and_add(&lLayer.mNumPostedWork, 1);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     err = lLayer.PostEvent(*this, Weave::System::kEvent_ScheduleWork, 0);
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    if (err != WEAVE_SYSTEM_NO_ERROR)
+        __sync_fetch_and_sub(&lLayer.mNumPostedWork, 1);
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Work may be scheduled from any thread, so rather than entering the timing wheel, the timer is pushed onto a lock-free
+    // stack that the I/O thread drains. The additional retention keeps the timer from being recycled by a concurrent Cancel()
+    // while it is still on the stack.
+    this->Retain();
+
+    do
+    {
+        this->mNextTimer = lLayer.mScheduledWork;
+    } while (!__sync_bool_compare_and_swap(&lLayer.mScheduledWork, this->mNextTimer, this));
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
     lLayer.WakeSelect();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -206,9 +244,9 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
  */
 Error Timer::Cancel()
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     Layer& lLayer = this->SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP && !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     OnCompleteFunct lOnComplete = this->OnComplete;
 
     // Check if the timer is armed
@@ -219,7 +257,10 @@ Error Timer::Cancel()
     // Since this thread changed the state of OnComplete, release the timer.
     this->AppState = NULL;
 
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->UnlinkIndex();
+    this->UnlinkWheel();
+#elif WEAVE_SYSTEM_CONFIG_USE_LWIP
     if (lLayer.mTimerList)
     {
         if (this == lLayer.mTimerList)
@@ -244,7 +285,7 @@ Error Timer::Cancel()
 
         this->mNextTimer = NULL;
     }
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     this->Release();
 exit:
@@ -268,6 +309,10 @@ void Timer::HandleComplete()
 
     // Since this thread changed the state of OnComplete, release the timer.
     AppState = NULL;
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    this->UnlinkIndex();
+    this->UnlinkWheel();
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     this->Release();
 
     // Invoke the app's callback, if it's still valid.
@@ -278,6 +323,221 @@ exit:
     return;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+/**
+ *  Insert the timer into the slot of the timing wheel covering its awaken epoch.
+ *
+ *  A timer that is already due, relative to the earliest slot not yet processed, is placed in that slot so that it is handled on
+ *  the next pass.
+ */
+void Timer::LinkWheel(Layer& aLayer)
+{
+    Epoch lTick = this->mAwakenEpoch / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+
+    if (lTick < aLayer.mTimerWheelTick)
+        lTick = aLayer.mTimerWheelTick;
+
+    Timer** const lSlot = &aLayer.mTimerWheel[lTick % WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE];
+
+    this->mNextTimer = *lSlot;
+    if (this->mNextTimer != NULL)
+        this->mNextTimer->mPrevTimerLink = &this->mNextTimer;
+    this->mPrevTimerLink = lSlot;
+    *lSlot = this;
+
+    aLayer.mNumWheelTimers++;
+}
+
+/**
+ *  Remove the timer from the timing wheel, if present.
+ */
+void Timer::UnlinkWheel(void)
+{
+    if (this->mPrevTimerLink != NULL)
+    {
+        *this->mPrevTimerLink = this->mNextTimer;
+        if (this->mNextTimer != NULL)
+            this->mNextTimer->mPrevTimerLink = this->mPrevTimerLink;
+
+        this->mNextTimer = NULL;
+        this->mPrevTimerLink = NULL;
+
+        this->SystemLayer().mNumWheelTimers--;
+    }
+}
+
+/**
+ *  Insert the timer into the index bucket for its completion function and application state, growing the index first if
+ *  it would otherwise hold more timers than buckets.
+ */
+void Timer::LinkIndex(Layer& aLayer)
+{
+    Timer** lBucket;
+
+    if (aLayer.mNumIndexedTimers >= aLayer.mTimerIndexSize)
+        aLayer.GrowTimerIndex();
+
+    lBucket = &aLayer.mTimerIndex[Timer::GetIndexBucket(aLayer, this->OnComplete, this->AppState)];
+
+    this->mNextIndexed = *lBucket;
+    if (this->mNextIndexed != NULL)
+        this->mNextIndexed->mPrevIndexedLink = &this->mNextIndexed;
+    this->mPrevIndexedLink = lBucket;
+    *lBucket = this;
+
+    aLayer.mNumIndexedTimers++;
+}
+
+/**
+ *  Remove the timer from the index, if present.
+ */
+void Timer::UnlinkIndex(void)
+{
+    if (this->mPrevIndexedLink != NULL)
+    {
+        *this->mPrevIndexedLink = this->mNextIndexed;
+        if (this->mNextIndexed != NULL)
+            this->mNextIndexed->mPrevIndexedLink = this->mPrevIndexedLink;
+
+        this->mNextIndexed = NULL;
+        this->mPrevIndexedLink = NULL;
+
+        this->SystemLayer().mNumIndexedTimers--;
+    }
+}
+
+/**
+ *  Hash a completion function and application state pair to an index bucket.
+ */
+size_t Timer::GetIndexBucket(const Layer& aLayer, OnCompleteFunct aOnComplete, void* aAppState)
+{
+    uintptr_t lHash = reinterpret_cast<uintptr_t>(aAppState) ^ (reinterpret_cast<uintptr_t>(aOnComplete) >> 2);
+
+    // Mix the high-order bits into the low-order ones, since objects and functions are aligned and tend to be clustered.
+    lHash *= static_cast<uintptr_t>(0x9E3779B1UL);
+    lHash ^= lHash >> 15;
+
+    return static_cast<size_t>(lHash % aLayer.mTimerIndexSize);
+}
+
+/**
+ *  Find an armed timer started with the given completion function and application state.
+ *
+ *  @return A pointer to the timer, or NULL if no such timer is armed.
+ */
+Timer* Timer::FindIndexed(Layer& aLayer, OnCompleteFunct aOnComplete, void* aAppState)
+{
+    Timer* lTimer = aLayer.mTimerIndex[Timer::GetIndexBucket(aLayer, aOnComplete, aAppState)];
+
+    while (lTimer != NULL && (lTimer->OnComplete != aOnComplete || lTimer->AppState != aAppState))
+        lTimer = lTimer->mNextIndexed;
+
+    return lTimer;
+}
+
+/**
+ *  Find the awaken epoch of the earliest timer in the timing wheel.
+ *
+ *  @note
+ *      The search covers at most one revolution of the wheel. If no timer falls within that revolution, the epoch at which the
+ *      next revolution starts is returned, at which point the caller is expected to search again.
+ *
+ *  @param[in]  aLayer          The layer owning the timing wheel.
+ *  @param[in]  aCurrentEpoch   The current epoch.
+ *  @param[in]  aMaxEpoch       The latest epoch of interest to the caller.
+ *
+ *  @return The earlier of \c aMaxEpoch and the awaken epoch of the earliest timer.
+ */
+Timer::Epoch Timer::GetWheelAwakenEpoch(Layer& aLayer, Epoch aCurrentEpoch, Epoch aMaxEpoch)
+{
+    const Epoch kMaxTick = aMaxEpoch / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+    Epoch lAwakenEpoch = aMaxEpoch;
+    Epoch lTick = aLayer.mTimerWheelTick;
+    bool lFound = false;
+
+    VerifyOrExit(aLayer.mNumWheelTimers > 0, );
+
+    for (size_t i = 0; i < WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE && lTick <= kMaxTick && !lFound; i++, lTick++)
+    {
+        for (Timer* lTimer = aLayer.mTimerWheel[lTick % WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE]; lTimer != NULL;
+             lTimer = lTimer->mNextTimer)
+        {
+            // Timers belonging to a later revolution of the wheel share the slot; skip them.
+            if (lTimer->mAwakenEpoch / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS <= lTick)
+            {
+                lFound = true;
+
+                if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
+                    lAwakenEpoch = lTimer->mAwakenEpoch;
+            }
+        }
+    }
+
+    if (!lFound && lTick <= kMaxTick)
+        lAwakenEpoch = lTick * WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+
+exit:
+    return lAwakenEpoch;
+}
+
+/**
+ *  Complete the timers in the timing wheel that have expired.
+ *
+ *  @brief
+ *      Each slot that has elapsed since the previous call is processed once. Expired timers are completed; timers belonging to a
+ *      later revolution of the wheel are returned to their slot. Timers started or cancelled by the completion handlers are
+ *      handled correctly.
+ */
+void Timer::ExpireWheelTimers(Layer& aLayer)
+{
+    const Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+    const Epoch kCurrentTick = kCurrentEpoch / WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+    Epoch lTick = aLayer.mTimerWheelTick;
+
+    VerifyOrExit(lTick <= kCurrentTick, );
+
+    aLayer.mTimerWheelTick = kCurrentTick;
+    VerifyOrExit(aLayer.mNumWheelTimers > 0, );
+
+    // No slot needs visiting more than once per pass.
+    if (kCurrentTick - lTick >= WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE)
+        lTick = kCurrentTick - (WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE - 1);
+
+    while (true)
+    {
+        Timer*& lSlot = aLayer.mTimerWheel[lTick % WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE];
+        Timer* lList = lSlot;
+
+        if (lList != NULL)
+        {
+            // Detach the slot so that a completion handler cancelling a pending timer of this slot unlinks it from lList.
+            lSlot = NULL;
+            lList->mPrevTimerLink = &lList;
+
+            while (lList != NULL)
+            {
+                Timer& lTimer = *lList;
+
+                lTimer.UnlinkWheel();
+
+                if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer.mAwakenEpoch))
+                    lTimer.HandleComplete();
+                else
+                    lTimer.LinkWheel(aLayer);
+            }
+        }
+
+        if (lTick == kCurrentTick)
+            break;
+
+        lTick++;
+    }
+
+exit:
+    return;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 /**
  * Completes any timers that have expired.
@@ -295,6 +555,24 @@ exit:
  */
 Error Timer::HandleExpiredTimers(Layer& aLayer)
 {
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    aLayer.mTimerComplete = true;
+    Timer::ExpireWheelTimers(aLayer);
+    aLayer.mTimerComplete = false;
+
+    if (aLayer.mNumWheelTimers > 0)
+    {
+        // timers still exist so restart the platform timer.
+        const Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+        const Epoch kMaxEpoch = kCurrentEpoch + WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE * WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+        const Epoch kAwakenEpoch = Timer::GetWheelAwakenEpoch(aLayer, kCurrentEpoch, kMaxEpoch);
+        const uint32_t kDelayMilliseconds =
+            Timer::IsEarlierEpoch(kCurrentEpoch, kAwakenEpoch) ? static_cast<uint32_t>(kAwakenEpoch - kCurrentEpoch) : 0;
+
+        aLayer.mPlatformTimerEpoch = kCurrentEpoch + kDelayMilliseconds;
+        aLayer.StartPlatformTimer(kDelayMilliseconds);
+    }
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
     // expire each timer in turn until an unexpired timer is reached or the timerlist is emptied.
     while (aLayer.mTimerList)
     {
@@ -328,6 +606,7 @@ Error Timer::HandleExpiredTimers(Layer& aLayer)
             break; // all remaining timers are still ticking.
         }
     }
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
 
     return WEAVE_SYSTEM_NO_ERROR;
 }
@@ -95,7 +95,7 @@ public:
 #endif // WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 
 private:
-    static ObjectPool<Timer, WEAVE_SYSTEM_CONFIG_NUM_TIMERS> sPool;
+    static LayerObjectPool<Timer, WEAVE_SYSTEM_CONFIG_NUM_TIMERS> sPool;
 
     Epoch mAwakenEpoch;
 
@@ -109,9 +109,26 @@ private:
 
     Error ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState);
 
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    Timer* mNextTimer;              /**< Next timer in the same wheel slot, or in the pending scheduled work. */
+    Timer** mPrevTimerLink;         /**< Link pointing at this timer in its wheel slot, or NULL if not in the wheel. */
+    Timer* mNextIndexed;            /**< Next timer in the same index bucket. */
+    Timer** mPrevIndexedLink;       /**< Link pointing at this timer in its index bucket, or NULL if not indexed. */
+
+    void LinkWheel(Layer& aLayer);
+    void UnlinkWheel(void);
+    void LinkIndex(Layer& aLayer);
+    void UnlinkIndex(void);
+
+    static size_t GetIndexBucket(const Layer& aLayer, OnCompleteFunct aOnComplete, void* aAppState);
+    static Timer* FindIndexed(Layer& aLayer, OnCompleteFunct aOnComplete, void* aAppState);
+    static Epoch GetWheelAwakenEpoch(Layer& aLayer, Epoch aCurrentEpoch, Epoch aMaxEpoch);
+    static void ExpireWheelTimers(Layer& aLayer);
+#elif WEAVE_SYSTEM_CONFIG_USE_LWIP
     Timer *mNextTimer;
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
     static Error HandleExpiredTimers(Layer& aLayer);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
@@ -111,6 +111,7 @@ PASEEngineTest::PASEEngineTest(const char *testName)
 {
     mTestName = testName;
     mProposedConfig = mExpectedConfig = kPASEConfig_Unspecified;
+    mEncryptionType = kWeaveEncryptionType_AES128CTRSHA1;
     mInitPW = mRespPW = "TestPassword";
     mInitiatorAllowedConfigs = mResponderAllowedConfigs = kPASEConfig_Config1|kPASEConfig_Config4;
     mExpectReconfig = false;
@@ -125,6 +126,9 @@ const char *PASEEngineTest::TestName() const { return mTestName; }
 uint32_t PASEEngineTest::ProposedConfig() const { return mProposedConfig; }
 PASEEngineTest& PASEEngineTest::ProposedConfig(uint32_t val) { mProposedConfig = val; return *this; }
 
+uint8_t PASEEngineTest::EncryptionType() const { return mEncryptionType; }
+PASEEngineTest& PASEEngineTest::EncryptionType(uint8_t val) { mEncryptionType = val; return *this; }
+
 uint32_t PASEEngineTest::InitiatorAllowedConfigs() const { return mInitiatorAllowedConfigs; }
 PASEEngineTest& PASEEngineTest::InitiatorAllowedConfigs(uint32_t val) { mInitiatorAllowedConfigs = val; return *this; }
 
@@ -249,7 +253,7 @@ void PASEEngineTest::Run()
     uint64_t initNodeId = 1;
     uint64_t respNodeId = 2;
     uint16_t sessionKeyId = sTestDefaultSessionKeyId;
-    uint16_t encType = kWeaveEncryptionType_AES128CTRSHA1;
+    uint16_t encType = EncryptionType();
     uint16_t pwSrc = kPasswordSource_PairingCode;
     bool expectSuccess = strcmp(mInitPW, mRespPW) == 0;
 
@@ -474,10 +478,18 @@ onReconfig:
     err = responderEng.GetSessionKey(responderKey);
     SuccessOrQuit(err, "WeavePASEEngine::GetSessionKey() failed\n");
 
-    VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.DataKey, responderKey->AES128CTRSHA1.DataKey, WeaveEncryptionKey_AES128CTRSHA1::DataKeySize) == 0,
-                 "Data key mismatch\n");
-    VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.IntegrityKey, responderKey->AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize) == 0,
-                 "Integrity key mismatch\n");
+    if (encType == kWeaveEncryptionType_AES128GCM)
+    {
+        VerifyOrQuit(memcmp(initiatorKey->AES128GCM.DataKey, responderKey->AES128GCM.DataKey, WeaveEncryptionKey_AES128GCM::DataKeySize) == 0,
+                     "Data key mismatch\n");
+    }
+    else
+    {
+        VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.DataKey, responderKey->AES128CTRSHA1.DataKey, WeaveEncryptionKey_AES128CTRSHA1::DataKeySize) == 0,
+                     "Data key mismatch\n");
+        VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.IntegrityKey, responderKey->AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize) == 0,
+                     "Integrity key mismatch\n");
+    }
 
     // Shutdown the Initiator/Responder FabricState objects
     err = initFabricState.Shutdown();
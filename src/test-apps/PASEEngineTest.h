@@ -59,6 +59,9 @@ public:
     uint32_t ProposedConfig() const;
     PASEEngineTest& ProposedConfig(uint32_t val);
 
+    uint8_t EncryptionType() const;
+    PASEEngineTest& EncryptionType(uint8_t val);
+
     uint32_t InitiatorAllowedConfigs() const;
     PASEEngineTest& InitiatorAllowedConfigs(uint32_t val);
 
@@ -108,6 +111,7 @@ private:
     };
     const char *mTestName;
     uint32_t mProposedConfig;
+    uint8_t mEncryptionType;
     const char *mInitPW;
     const char *mRespPW;
     uint32_t mInitiatorAllowedConfigs;
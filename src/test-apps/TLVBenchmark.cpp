@@ -0,0 +1,1059 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a throughput benchmark for the Weave TLV
+ *      reader, writer, updater and circular buffer implementations.
+ *
+ *      Each operation is timed over a set of representative encodings
+ *      (Weave certificates, a WDM notify, an event log and deeply
+ *      nested containers), and, where the operation supports it,
+ *      against a single flat buffer, a chain of packet buffers and a
+ *      circular buffer that wraps around in the middle of the data.
+ *
+ */
+
+#include "ToolCommon.h"
+
+#include <string.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveTLV.h>
+#include <Weave/Core/WeaveCircularTLVBuffer.h>
+#include <Weave/Profiles/security/WeaveSecurity.h>
+#include <Weave/Support/CodeUtils.h>
+
+#include "TestWeaveCertData.h"
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#include <lwip/init.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+using namespace nl;
+using namespace nl::Weave::TLV;
+using namespace nl::TestCerts;
+
+#define TOOL_NAME "TLVBenchmark"
+
+static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg);
+
+enum
+{
+    kCorpusBufferSize               = 8192,
+    kScratchBufferSize              = 1024,     // Large enough for any string or byte string leaf in the corpora
+    kPacketBufferSegmentSize        = 256,      // Minimum amount of data placed in each buffer of a packet buffer chain
+    kMaxPacketBufferSegments        = 8,        // Keeps larger corpora within the packet buffer pool
+    kCircularSlack                  = 512,      // Room in the circular buffer beyond the size of the corpus
+    kNumNotifyDataElements          = 32,
+    kNumEvents                      = 64,
+    kNestingDepth                   = 32,
+};
+
+// Context tags of the WDM notify and event encodings, as defined in MessageDef.h
+enum
+{
+    kNotifyTag_SubscriptionId       = 1,
+    kNotifyTag_DataList             = 2,
+    kNotifyTag_EventList            = 23,
+
+    kDataElementTag_Path            = 1,
+    kDataElementTag_Version         = 2,
+    kDataElementTag_Data            = 3,
+
+    kPathTag_InstanceLocator        = 1,
+    kPathTag_ResourceID             = 1,
+    kPathTag_TraitProfileID         = 2,
+    kPathTag_TraitInstanceID        = 3,
+
+    kEventTag_Source                = 1,
+    kEventTag_Importance            = 2,
+    kEventTag_Id                    = 3,
+    kEventTag_DeltaSystemTimestamp  = 6,
+    kEventTag_TraitProfileID        = 8,
+    kEventTag_DataSchemaVersion     = 9,
+    kEventTag_Type                  = 10,
+    kEventTag_Data                  = 16,
+};
+
+enum Backend
+{
+    kBackend_Flat                   = 0,
+    kBackend_PacketBufferChain,
+    kBackend_Circular,
+
+    kBackend_NumBackends
+};
+
+static const char * const sBackendNames[kBackend_NumBackends] =
+{
+    "flat",
+    "pbuf-chain",
+    "circular",
+};
+
+struct Corpus
+{
+    const char * mName;
+    WEAVE_ERROR (*mEncode)(TLVWriter & aWriter);
+    uint8_t mData[kCorpusBufferSize];
+    uint32_t mDataLen;
+    uint32_t mNumElements;
+};
+
+struct BenchmarkContext
+{
+    Corpus * mCorpus;
+    Backend mBackend;
+
+    // Input of the read operations, prepared once per corpus and backend
+    PacketBuffer * mChain;
+    WeaveCircularTLVBuffer * mCircularBuffer;
+
+    // Output of the write operations
+    WeaveCircularTLVBuffer * mCircularOutput;
+    uint8_t mOutput[kCorpusBufferSize * 2];
+};
+
+struct Operation
+{
+    const char * mName;
+    WEAVE_ERROR (*mRun)(BenchmarkContext & aContext);
+    bool mSupportsBackend[kBackend_NumBackends];
+};
+
+static uint32_t gMinDurationMs = 250;
+static const char * gCorpusName = NULL;
+
+static uint8_t sScratch[kScratchBufferSize];
+static uint8_t sCircularStore[kCorpusBufferSize * 2];
+
+static const char sEventDescription[] = "Front door unlocked by a guest pincode";
+
+// ================================ Corpora ================================
+
+static WEAVE_ERROR EncodeCertificates(TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVType outerContainer;
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Array, outerContainer);
+    SuccessOrExit(err);
+
+    for (size_t i = 0; i < gNumTestCerts; i++)
+    {
+        const uint8_t * certData;
+        size_t certDataLen;
+        TLVReader reader;
+
+        GetTestCert(gTestCerts[i], certData, certDataLen);
+
+        reader.Init(certData, certDataLen);
+
+        err = reader.Next();
+        SuccessOrExit(err);
+
+        err = aWriter.CopyElement(AnonymousTag, reader);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(outerContainer);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeNotify(TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVType notifyContainer, dataListContainer, elementContainer, pathContainer, locatorContainer, dataContainer;
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, notifyContainer);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kNotifyTag_SubscriptionId), static_cast<uint64_t>(0xB6C4B7BE2C4B859AULL));
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kNotifyTag_DataList), kTLVType_Array, dataListContainer);
+    SuccessOrExit(err);
+
+    for (uint32_t i = 0; i < kNumNotifyDataElements; i++)
+    {
+        err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, elementContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.StartContainer(ContextTag(kDataElementTag_Path), kTLVType_Path, pathContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.StartContainer(ContextTag(kPathTag_InstanceLocator), kTLVType_Structure, locatorContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kPathTag_ResourceID), static_cast<uint64_t>(0x18B4300001408362ULL));
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kPathTag_TraitProfileID), static_cast<uint32_t>(0x235A0000 + (i % 4)));
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kPathTag_TraitInstanceID), i);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(locatorContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(1), static_cast<uint8_t>(i % 8 + 1));
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(pathContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kDataElementTag_Version), static_cast<uint64_t>(0x1000000000ULL + i));
+        SuccessOrExit(err);
+
+        err = aWriter.StartContainer(ContextTag(kDataElementTag_Data), kTLVType_Structure, dataContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(1), static_cast<int32_t>(-2100 + i));
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(2), static_cast<uint16_t>(400 * i));
+        SuccessOrExit(err);
+
+        err = aWriter.PutBoolean(ContextTag(3), (i & 1) != 0);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(4), 21.5 + i);
+        SuccessOrExit(err);
+
+        err = aWriter.PutString(ContextTag(5), "living-room");
+        SuccessOrExit(err);
+
+        err = aWriter.PutNull(ContextTag(6));
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(dataContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(elementContainer);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(dataListContainer);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(notifyContainer);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeEventLog(TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVType notifyContainer, eventListContainer, eventContainer, dataContainer;
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, notifyContainer);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kNotifyTag_EventList), kTLVType_Array, eventListContainer);
+    SuccessOrExit(err);
+
+    for (uint32_t i = 0; i < kNumEvents; i++)
+    {
+        err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, eventContainer);
+        SuccessOrExit(err);
+
+        if (i == 0)
+        {
+            err = aWriter.Put(ContextTag(kEventTag_Source), static_cast<uint64_t>(0x18B4300001408362ULL));
+            SuccessOrExit(err);
+
+            err = aWriter.Put(ContextTag(kEventTag_Importance), static_cast<uint8_t>(2));
+            SuccessOrExit(err);
+
+            err = aWriter.Put(ContextTag(kEventTag_Id), static_cast<uint64_t>(0x4000));
+            SuccessOrExit(err);
+        }
+        else
+        {
+            err = aWriter.Put(ContextTag(kEventTag_DeltaSystemTimestamp), static_cast<int32_t>(37 * i));
+            SuccessOrExit(err);
+        }
+
+        err = aWriter.Put(ContextTag(kEventTag_TraitProfileID), static_cast<uint32_t>(0x235A0000 + (i % 3)));
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kEventTag_DataSchemaVersion), static_cast<uint16_t>(2));
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(kEventTag_Type), static_cast<uint32_t>(i % 5 + 1));
+        SuccessOrExit(err);
+
+        err = aWriter.StartContainer(ContextTag(kEventTag_Data), kTLVType_Structure, dataContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.Put(ContextTag(1), static_cast<uint32_t>(i));
+        SuccessOrExit(err);
+
+        err = aWriter.PutString(ContextTag(2), sEventDescription);
+        SuccessOrExit(err);
+
+        err = aWriter.PutBytes(ContextTag(3), reinterpret_cast<const uint8_t *>(sEventDescription), 8 + (i % 8));
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(dataContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(eventContainer);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(eventListContainer);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(notifyContainer);
+
+exit:
+    return err;
+}
+
+// Structures and arrays alternate; members of a structure are context tagged, those of an array anonymous.
+static WEAVE_ERROR EncodeNestedLevel(TLVWriter & aWriter, uint64_t aTag, uint32_t aLevel)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const bool isArray = (aLevel % 2) != 0;
+    TLVType outerContainer;
+
+    err = aWriter.StartContainer(aTag, isArray ? kTLVType_Array : kTLVType_Structure, outerContainer);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(isArray ? AnonymousTag : ContextTag(1), aLevel);
+    SuccessOrExit(err);
+
+    if (aLevel + 1 < kNestingDepth)
+    {
+        err = EncodeNestedLevel(aWriter, isArray ? AnonymousTag : ContextTag(2), aLevel + 1);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.PutBoolean(isArray ? AnonymousTag : ContextTag(3), isArray);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(outerContainer);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeNested(TLVWriter & aWriter)
+{
+    return EncodeNestedLevel(aWriter, AnonymousTag, 0);
+}
+
+static Corpus sCorpora[] =
+{
+    { "certs",  EncodeCertificates },
+    { "notify", EncodeNotify       },
+    { "events", EncodeEventLog     },
+    { "nested", EncodeNested       },
+};
+
+static const size_t kNumCorpora = sizeof(sCorpora) / sizeof(sCorpora[0]);
+
+// ============================ Element helpers ============================
+
+static WEAVE_ERROR CountElements(TLVReader & aReader, uint32_t & aCount)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVType outerContainer;
+
+    aCount++;
+
+    if (TLVTypeIsContainer(aReader.GetType()))
+    {
+        err = aReader.EnterContainer(outerContainer);
+        SuccessOrExit(err);
+
+        while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+        {
+            err = CountElements(aReader, aCount);
+            SuccessOrExit(err);
+        }
+
+        VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+        err = aReader.ExitContainer(outerContainer);
+    }
+
+exit:
+    return err;
+}
+
+// Re-encodes the element under the reader one Put() at a time
+static WEAVE_ERROR PutElement(TLVReader & aReader, TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const uint64_t tag = aReader.GetTag();
+    TLVType outerReaderContainer, outerWriterContainer;
+
+    switch (aReader.GetType())
+    {
+    case kTLVType_Structure:
+    case kTLVType_Array:
+    case kTLVType_Path:
+        err = aWriter.StartContainer(tag, aReader.GetType(), outerWriterContainer);
+        SuccessOrExit(err);
+
+        err = aReader.EnterContainer(outerReaderContainer);
+        SuccessOrExit(err);
+
+        while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+        {
+            err = PutElement(aReader, aWriter);
+            SuccessOrExit(err);
+        }
+
+        VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+        err = aReader.ExitContainer(outerReaderContainer);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(outerWriterContainer);
+        break;
+
+    case kTLVType_SignedInteger:
+    {
+        int64_t v;
+        err = aReader.Get(v);
+        SuccessOrExit(err);
+        err = aWriter.Put(tag, v);
+        break;
+    }
+
+    case kTLVType_UnsignedInteger:
+    {
+        uint64_t v;
+        err = aReader.Get(v);
+        SuccessOrExit(err);
+        err = aWriter.Put(tag, v);
+        break;
+    }
+
+    case kTLVType_FloatingPointNumber:
+    {
+        double v;
+        err = aReader.Get(v);
+        SuccessOrExit(err);
+        err = aWriter.Put(tag, v);
+        break;
+    }
+
+    case kTLVType_Boolean:
+    {
+        bool v;
+        err = aReader.Get(v);
+        SuccessOrExit(err);
+        err = aWriter.PutBoolean(tag, v);
+        break;
+    }
+
+    case kTLVType_UTF8String:
+        err = aReader.GetBytes(sScratch, sizeof(sScratch));
+        SuccessOrExit(err);
+        err = aWriter.PutString(tag, reinterpret_cast<const char *>(sScratch), aReader.GetLength());
+        break;
+
+    case kTLVType_ByteString:
+        err = aReader.GetBytes(sScratch, sizeof(sScratch));
+        SuccessOrExit(err);
+        err = aWriter.PutBytes(tag, sScratch, aReader.GetLength());
+        break;
+
+    case kTLVType_Null:
+        err = aWriter.PutNull(tag);
+        break;
+
+    default:
+        err = WEAVE_ERROR_INVALID_TLV_ELEMENT;
+        break;
+    }
+
+exit:
+    return err;
+}
+
+// ================================ Backends ===============================
+
+static WEAVE_ERROR PrepareBackend(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const Corpus & corpus = *aContext.mCorpus;
+
+    if (aContext.mBackend == kBackend_PacketBufferChain)
+    {
+        uint32_t segmentSize = (corpus.mDataLen + kMaxPacketBufferSegments - 1) / kMaxPacketBufferSegments;
+
+        if (segmentSize < kPacketBufferSegmentSize)
+        {
+            segmentSize = kPacketBufferSegmentSize;
+        }
+
+        // Spread the corpus over a chain of partially filled buffers, so that elements straddle buffer boundaries
+        for (uint32_t offset = 0; offset < corpus.mDataLen; offset += segmentSize)
+        {
+            const uint32_t remaining = corpus.mDataLen - offset;
+            const uint16_t segmentLen = static_cast<uint16_t>(remaining < segmentSize ? remaining : segmentSize);
+            PacketBuffer * segment = PacketBuffer::New(0);
+
+            VerifyOrExit(segment != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+            memcpy(segment->Start(), corpus.mData + offset, segmentLen);
+            segment->SetDataLength(segmentLen);
+
+            if (aContext.mChain == NULL)
+            {
+                aContext.mChain = segment;
+            }
+            else
+            {
+                aContext.mChain->AddToEnd(segment);
+            }
+        }
+    }
+    else if (aContext.mBackend == kBackend_Circular)
+    {
+        CircularTLVWriter writer;
+        TLVReader reader;
+
+        // The buffer starts out with a filler element that is too large to share the buffer with the corpus.  It gets
+        // evicted to make room for the corpus, which then wraps around the end of the buffer.
+        aContext.mCircularBuffer = new WeaveCircularTLVBuffer(sCircularStore, corpus.mDataLen + kCircularSlack);
+
+        writer.Init(aContext.mCircularBuffer);
+
+        err = writer.PutBytes(AnonymousTag, aContext.mOutput, corpus.mDataLen / 2 + kCircularSlack);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        SuccessOrExit(err);
+
+        reader.Init(corpus.mData, corpus.mDataLen);
+
+        err = reader.Next();
+        SuccessOrExit(err);
+
+        writer.Init(aContext.mCircularBuffer);
+
+        err = writer.CopyElement(reader);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        SuccessOrExit(err);
+
+        VerifyOrExit(aContext.mCircularBuffer->DataLength() == corpus.mDataLen, err = WEAVE_ERROR_INCORRECT_STATE);
+
+        // Sized so that every write evicts the previous copy and wraps around the end of the buffer
+        aContext.mCircularOutput = new WeaveCircularTLVBuffer(aContext.mOutput, corpus.mDataLen + corpus.mDataLen / 2);
+    }
+
+exit:
+    return err;
+}
+
+static void ReleaseBackend(BenchmarkContext & aContext)
+{
+    if (aContext.mChain != NULL)
+    {
+        PacketBuffer::Free(aContext.mChain);
+        aContext.mChain = NULL;
+    }
+
+    if (aContext.mCircularBuffer != NULL)
+    {
+        delete aContext.mCircularBuffer;
+        aContext.mCircularBuffer = NULL;
+    }
+
+    if (aContext.mCircularOutput != NULL)
+    {
+        delete aContext.mCircularOutput;
+        aContext.mCircularOutput = NULL;
+    }
+}
+
+static void InitReader(BenchmarkContext & aContext, TLVReader & aReader, CircularTLVReader & aCircularReader, TLVReader *& aOutReader)
+{
+    switch (aContext.mBackend)
+    {
+    case kBackend_PacketBufferChain:
+        aReader.Init(aContext.mChain, 0xFFFFFFFFUL, true);
+        aOutReader = &aReader;
+        break;
+
+    case kBackend_Circular:
+        aCircularReader.Init(aContext.mCircularBuffer);
+        aOutReader = &aCircularReader;
+        break;
+
+    default:
+        aReader.Init(aContext.mCorpus->mData, aContext.mCorpus->mDataLen);
+        aOutReader = &aReader;
+        break;
+    }
+}
+
+// Runs aEncode against a writer on the output side of the backend
+template <typename Encoder>
+static WEAVE_ERROR WriteToBackend(BenchmarkContext & aContext, Encoder & aEncode)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer * buf = NULL;
+
+    switch (aContext.mBackend)
+    {
+    case kBackend_PacketBufferChain:
+    {
+        TLVWriter writer;
+
+        buf = PacketBuffer::New(0);
+        VerifyOrExit(buf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        writer.Init(buf, 0xFFFFFFFFUL, true);
+
+        err = aEncode(writer);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        break;
+    }
+
+    case kBackend_Circular:
+    {
+        CircularTLVWriter writer;
+
+        writer.Init(aContext.mCircularOutput);
+
+        err = aEncode(writer);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        break;
+    }
+
+    default:
+    {
+        TLVWriter writer;
+
+        writer.Init(aContext.mOutput, sizeof(aContext.mOutput));
+
+        err = aEncode(writer);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        break;
+    }
+    }
+
+exit:
+    if (buf != NULL)
+    {
+        PacketBuffer::Free(buf);
+    }
+
+    return err;
+}
+
+// =============================== Operations ==============================
+
+static WEAVE_ERROR RunNext(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    CircularTLVReader circularReader;
+    TLVReader * pReader;
+    uint32_t count = 0;
+
+    InitReader(aContext, reader, circularReader, pReader);
+
+    err = pReader->Next();
+    SuccessOrExit(err);
+
+    err = CountElements(*pReader, count);
+    SuccessOrExit(err);
+
+    VerifyOrExit(count == aContext.mCorpus->mNumElements, err = WEAVE_ERROR_INCORRECT_STATE);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR RunSkip(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    CircularTLVReader circularReader;
+    TLVReader * pReader;
+    TLVType outerContainer;
+
+    InitReader(aContext, reader, circularReader, pReader);
+
+    err = pReader->Next();
+    SuccessOrExit(err);
+
+    err = pReader->EnterContainer(outerContainer);
+    SuccessOrExit(err);
+
+    // Step over each child of the outermost container without looking inside it
+    while ((err = pReader->Next()) == WEAVE_NO_ERROR)
+    {
+        err = pReader->Skip();
+        SuccessOrExit(err);
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = pReader->ExitContainer(outerContainer);
+
+exit:
+    return err;
+}
+
+struct CopyContainerEncoder
+{
+    TLVReader * mReader;
+
+    WEAVE_ERROR operator()(TLVWriter & aWriter)
+    {
+        TLVReader reader;
+
+        reader.Init(*mReader);
+
+        return aWriter.CopyContainer(mReader->GetTag(), reader);
+    }
+};
+
+static WEAVE_ERROR RunCopyContainer(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    CopyContainerEncoder encoder;
+
+    // The source is always the flat corpus; the backend selects the destination.
+    reader.Init(aContext.mCorpus->mData, aContext.mCorpus->mDataLen);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    encoder.mReader = &reader;
+
+    err = WriteToBackend(aContext, encoder);
+
+exit:
+    return err;
+}
+
+struct PutEncoder
+{
+    TLVReader * mReader;
+
+    WEAVE_ERROR operator()(TLVWriter & aWriter)
+    {
+        TLVReader reader;
+
+        reader.Init(*mReader);
+
+        return PutElement(reader, aWriter);
+    }
+};
+
+static WEAVE_ERROR RunPut(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    PutEncoder encoder;
+
+    // The source is always the flat corpus; the backend selects the destination.
+    reader.Init(aContext.mCorpus->mData, aContext.mCorpus->mDataLen);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    encoder.mReader = &reader;
+
+    err = WriteToBackend(aContext, encoder);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR RunUpdate(BenchmarkContext & aContext)
+{
+    WEAVE_ERROR err;
+    TLVUpdater updater;
+    TLVType outerContainer;
+
+    // Each pass leaves the buffer as it found it
+    err = updater.Init(aContext.mOutput, aContext.mCorpus->mDataLen, sizeof(aContext.mOutput));
+    SuccessOrExit(err);
+
+    err = updater.Next();
+    SuccessOrExit(err);
+
+    err = updater.EnterContainer(outerContainer);
+    SuccessOrExit(err);
+
+    while ((err = updater.Next()) == WEAVE_NO_ERROR)
+    {
+        err = updater.Move();
+        SuccessOrExit(err);
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = updater.ExitContainer(outerContainer);
+    SuccessOrExit(err);
+
+    err = updater.Finalize();
+
+exit:
+    return err;
+}
+
+static const Operation sOperations[] =
+{
+    { "next",           RunNext,          { true, true,  true  } },
+    { "skip",           RunSkip,          { true, true,  true  } },
+    { "copy-container", RunCopyContainer, { true, true,  true  } },
+    { "put",            RunPut,           { true, true,  true  } },
+    { "update-move",    RunUpdate,        { true, false, false } },
+};
+
+static const size_t kNumOperations = sizeof(sOperations) / sizeof(sOperations[0]);
+
+// =============================== Benchmark ===============================
+
+static WEAVE_ERROR PrepareCorpus(Corpus & aCorpus)
+{
+    WEAVE_ERROR err;
+    TLVWriter writer;
+    TLVReader reader;
+
+    writer.Init(aCorpus.mData, sizeof(aCorpus.mData));
+
+    err = aCorpus.mEncode(writer);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    aCorpus.mDataLen = writer.GetLengthWritten();
+    aCorpus.mNumElements = 0;
+
+    reader.Init(aCorpus.mData, aCorpus.mDataLen);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = CountElements(reader, aCorpus.mNumElements);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR RunBenchmark(BenchmarkContext & aContext, const Operation & aOperation)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const Corpus & corpus = *aContext.mCorpus;
+    uint64_t start, elapsed;
+    uint32_t iterations = 0;
+    double nsPerElement, megabytesPerSec;
+
+    // The updater works in place on the output buffer
+    memcpy(aContext.mOutput, corpus.mData, corpus.mDataLen);
+
+    // One untimed pass to warm up the caches and check the operation succeeds
+    err = aOperation.mRun(aContext);
+    SuccessOrExit(err);
+
+    start = Now();
+
+    do
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            err = aOperation.mRun(aContext);
+            SuccessOrExit(err);
+        }
+
+        iterations += 16;
+        elapsed = Now() - start;
+    } while (elapsed < static_cast<uint64_t>(gMinDurationMs) * 1000);
+
+    nsPerElement = (elapsed * 1000.0) / (static_cast<double>(iterations) * corpus.mNumElements);
+    megabytesPerSec = (static_cast<double>(iterations) * corpus.mDataLen) / elapsed;
+
+    printf("%-8s %-16s %-12s %10.1f %10.1f %10u\n", corpus.mName, aOperation.mName, sBackendNames[aContext.mBackend],
+           nsPerElement, megabytesPerSec, iterations);
+
+exit:
+    return err;
+}
+
+static OptionDef gToolOptionDefs[] =
+{
+    { "corpus",   kArgumentRequired, 'c' },
+    { "duration", kArgumentRequired, 'd' },
+    { NULL }
+};
+
+static const char *const gToolOptionHelp =
+    "  -c, --corpus <name>\n"
+    "       Only run the benchmarks over the named corpus: certs, notify, events or nested.\n"
+    "\n"
+    "  -d, --duration <ms>\n"
+    "       Minimum time to spend on each measurement. Defaults to 250 ms.\n"
+    "\n"
+    ;
+
+static OptionSet gToolOptions =
+{
+    HandleOption,
+    gToolOptionDefs,
+    "GENERAL OPTIONS",
+    gToolOptionHelp
+};
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT,
+    "Measures the throughput of the Weave TLV encoder and decoder.\n"
+    "\n"
+    "Times are reported per element of the corpus, including for operations that\n"
+    "do not visit every element, so the rows for a corpus compare directly.\n"
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gToolOptions,
+    &gHelpOptions,
+    NULL
+};
+
+static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg)
+{
+    switch (id)
+    {
+    case 'c':
+        gCorpusName = NULL;
+        for (size_t c = 0; c < kNumCorpora; c++)
+        {
+            if (strcmp(arg, sCorpora[c].mName) == 0)
+            {
+                gCorpusName = sCorpora[c].mName;
+            }
+        }
+        if (gCorpusName == NULL)
+        {
+            PrintArgError("%s: Unknown corpus: %s\n", progName, arg);
+            return false;
+        }
+        break;
+
+    case 'd':
+        if (!ParseInt(arg, gMinDurationMs) || gMinDurationMs == 0)
+        {
+            PrintArgError("%s: Invalid value specified for duration: %s\n", progName, arg);
+            return false;
+        }
+        break;
+
+    default:
+        PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", progName, name);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    BenchmarkContext * context = NULL;
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    tcpip_init(NULL, NULL);
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    context = new BenchmarkContext();
+    VerifyOrExit(context != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    printf("%-8s %-16s %-12s %10s %10s %10s\n", "corpus", "operation", "backend", "ns/elem", "MB/s", "iterations");
+
+    for (size_t c = 0; c < kNumCorpora; c++)
+    {
+        Corpus & corpus = sCorpora[c];
+
+        if (gCorpusName != NULL && strcmp(gCorpusName, corpus.mName) != 0)
+        {
+            continue;
+        }
+
+        err = PrepareCorpus(corpus);
+        SuccessOrExit(err);
+
+        printf("# %s: %u bytes, %u elements\n", corpus.mName, corpus.mDataLen, corpus.mNumElements);
+
+        for (size_t o = 0; o < kNumOperations; o++)
+        {
+            for (int b = 0; b < kBackend_NumBackends; b++)
+            {
+                if (!sOperations[o].mSupportsBackend[b])
+                {
+                    continue;
+                }
+
+                context->mCorpus = &corpus;
+                context->mBackend = static_cast<Backend>(b);
+
+                err = PrepareBackend(*context);
+                if (err == WEAVE_NO_ERROR)
+                {
+                    err = RunBenchmark(*context, sOperations[o]);
+                }
+
+                ReleaseBackend(*context);
+                SuccessOrExit(err);
+            }
+        }
+    }
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        fprintf(stderr, "%s: %s\n", TOOL_NAME, nl::ErrorStr(err));
+    }
+
+    delete context;
+
+    return (err == WEAVE_NO_ERROR) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,534 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the development
+ *      Bulk Data Transfer (BDX) profile messages and the memory-mapped
+ *      files that transfers can send from.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <SystemLayer/SystemConfig.h>
+#include <SystemLayer/SystemStats.h>
+
+#include <Weave/Profiles/bulk-data-transfer/Development/BulkDataTransfer.h>
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#include <lwip/tcpip.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+#include <nltest.h>
+
+using namespace nl::Weave;
+using namespace nl::Weave::Profiles;
+using namespace nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development);
+
+static const uint8_t kVersion = 1;
+
+static char sFileDesignator[] = "test-file-development.txt";
+
+/**
+ *  Packs a SendInit (or ReceiveInit) proposing the given modes and checks
+ *  that it parses back to the same message.
+ */
+static void CheckInitRoundTrip(nlTestSuite *inSuite, bool aSenderDrive, bool aReceiverDrive, bool aWindowed)
+{
+    WEAVE_ERROR             err;
+    System::PacketBuffer *  buffer = System::PacketBuffer::New();
+    ReferencedString        fileDesignator;
+    ReceiveInit             sent;
+    ReceiveInit             parsed;
+
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+
+    err = fileDesignator.init(static_cast<uint16_t>(strlen(sFileDesignator)), sFileDesignator);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = sent.init(kVersion, aSenderDrive, aReceiverDrive, false, 512, static_cast<uint32_t>(0),
+                    static_cast<uint32_t>(0), fileDesignator, static_cast<ReferencedTLVData *>(NULL));
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    sent.mWindowedModeSupported = aWindowed;
+
+    err = sent.pack(buffer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buffer->DataLength() == sent.packedLength());
+
+    // The windowed flag rides in the otherwise unused top bit of the
+    // proposed transfer control byte.
+    NL_TEST_ASSERT(inSuite, ((buffer->Start()[0] & kMode_Windowed) != 0) == aWindowed);
+
+    err = SendInit::parse(buffer, parsed);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsed == sent);
+    NL_TEST_ASSERT(inSuite, parsed.mWindowedModeSupported == aWindowed);
+    NL_TEST_ASSERT(inSuite, parsed.mSenderDriveSupported == aSenderDrive);
+    NL_TEST_ASSERT(inSuite, parsed.mReceiverDriveSupported == aReceiverDrive);
+    NL_TEST_ASSERT(inSuite, !parsed.mAsynchronousModeSupported);
+    NL_TEST_ASSERT(inSuite, parsed.mVersion == kVersion);
+
+    System::PacketBuffer::Free(buffer);
+}
+
+/**
+ *  Test packing and parsing a SendInit or ReceiveInit with and without
+ *  the windowed mode proposed.
+ */
+static void CheckInitWindowed(nlTestSuite *inSuite, void *inContext)
+{
+    CheckInitRoundTrip(inSuite, true, false, false);
+    CheckInitRoundTrip(inSuite, true, false, true);
+    CheckInitRoundTrip(inSuite, false, true, true);
+    CheckInitRoundTrip(inSuite, true, true, true);
+
+    NL_TEST_ASSERT(inSuite, System::Stats::GetResourcesInUse()[System::Stats::kSystemLayer_NumPacketBufs] == 0);
+}
+
+/**
+ *  Test packing and parsing a SendAccept that accepts, or does not
+ *  accept, the windowed mode, and that the flag does not leak into the
+ *  chosen transfer mode.
+ */
+static void CheckSendAcceptWindowed(nlTestSuite *inSuite, void *inContext)
+{
+    const uint8_t modes[] = { kMode_SenderDrive, kMode_ReceiverDrive };
+
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        for (int windowed = 0; windowed <= 1; windowed++)
+        {
+            WEAVE_ERROR             err;
+            System::PacketBuffer *  buffer = System::PacketBuffer::New();
+            SendAccept              sent;
+            SendAccept              parsed;
+
+            NL_TEST_ASSERT(inSuite, buffer != NULL);
+
+            err = sent.init(kVersion, modes[i], 256, NULL);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            sent.mWindowed = (windowed != 0);
+
+            err = sent.pack(buffer);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, buffer->DataLength() == sent.packedLength());
+            NL_TEST_ASSERT(inSuite, ((buffer->Start()[0] & kMode_Windowed) != 0) == sent.mWindowed);
+
+            err = SendAccept::parse(buffer, parsed);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, parsed == sent);
+            NL_TEST_ASSERT(inSuite, parsed.mWindowed == sent.mWindowed);
+            NL_TEST_ASSERT(inSuite, parsed.mTransferMode == modes[i]);
+            NL_TEST_ASSERT(inSuite, parsed.mVersion == kVersion);
+            NL_TEST_ASSERT(inSuite, parsed.mMaxBlockSize == 256);
+
+            System::PacketBuffer::Free(buffer);
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, System::Stats::GetResourcesInUse()[System::Stats::kSystemLayer_NumPacketBufs] == 0);
+}
+
+/**
+ *  Test packing and parsing a ReceiveAccept that accepts, or does not
+ *  accept, the windowed mode, with both narrow and wide lengths.
+ */
+static void CheckReceiveAcceptWindowed(nlTestSuite *inSuite, void *inContext)
+{
+    const uint8_t modes[] = { kMode_SenderDrive, kMode_ReceiverDrive };
+
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        for (int windowed = 0; windowed <= 1; windowed++)
+        {
+            for (int wide = 0; wide <= 1; wide++)
+            {
+                WEAVE_ERROR             err;
+                System::PacketBuffer *  buffer = System::PacketBuffer::New();
+                ReceiveAccept           sent;
+                ReceiveAccept           parsed;
+
+                NL_TEST_ASSERT(inSuite, buffer != NULL);
+
+                if (wide)
+                {
+                    err = sent.init(kVersion, modes[i], 128, static_cast<uint64_t>(0x100000000ULL), NULL);
+                }
+                else
+                {
+                    err = sent.init(kVersion, modes[i], 128, static_cast<uint32_t>(40000), NULL);
+                }
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+                sent.mWindowed = (windowed != 0);
+
+                err = sent.pack(buffer);
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, buffer->DataLength() == sent.packedLength());
+                NL_TEST_ASSERT(inSuite, ((buffer->Start()[0] & kMode_Windowed) != 0) == sent.mWindowed);
+
+                err = ReceiveAccept::parse(buffer, parsed);
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, parsed == sent);
+                NL_TEST_ASSERT(inSuite, parsed.mWindowed == sent.mWindowed);
+                NL_TEST_ASSERT(inSuite, parsed.mTransferMode == modes[i]);
+                NL_TEST_ASSERT(inSuite, parsed.mWideRange == sent.mWideRange);
+                NL_TEST_ASSERT(inSuite, parsed.mLength == sent.mLength);
+
+                System::PacketBuffer::Free(buffer);
+            }
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, System::Stats::GetResourcesInUse()[System::Stats::kSystemLayer_NumPacketBufs] == 0);
+}
+
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+#define TEST_FILE_LENGTH 1000
+
+/**
+ *  Writes TEST_FILE_LENGTH bytes counting up from aSeed to aPath, replacing
+ *  its contents in place if it exists, and stamps it with the given
+ *  modification time.
+ */
+static bool WriteTestFile(const char *aPath, uint8_t aSeed, time_t aSeconds, long aNanoseconds)
+{
+    uint8_t         data[TEST_FILE_LENGTH];
+    struct timespec times[2];
+    int             fd;
+    bool            ok;
+
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = static_cast<uint8_t>(aSeed + i);
+    }
+
+    fd = open(aPath, O_WRONLY | O_CREAT, 0600);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    ok = (write(fd, data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)));
+
+    times[0].tv_sec = times[1].tv_sec = aSeconds;
+    times[0].tv_nsec = times[1].tv_nsec = aNanoseconds;
+    ok = ok && (futimens(fd, times) == 0);
+
+    close(fd);
+
+    return ok;
+}
+
+static void MakeTestFilePath(char *aPath, size_t aSize, int aIndex)
+{
+    snprintf(aPath, aSize, "/tmp/TestBDX.%d.%d", static_cast<int>(getpid()), aIndex);
+}
+
+/**
+ *  Reads the next block of a transfer from its file source into aBlock.
+ */
+static WEAVE_ERROR GetFileBlock(BDXTransfer &aXfer, uint8_t *aBlock, uint64_t aRoom, uint64_t &aLength, bool &aIsLast)
+{
+    WEAVE_ERROR err;
+    uint8_t *   data = aBlock;
+
+    aLength = aRoom;
+    aIsLast = false;
+
+    err = aXfer.DispatchGetBlockHandler(&aLength, &data, &aIsLast);
+
+    if (err == WEAVE_NO_ERROR && data != aBlock)
+    {
+        memcpy(aBlock, data, static_cast<size_t>(aLength));
+    }
+
+    return err;
+}
+
+/**
+ *  Test that a file stays mapped in the pool and is shared by every
+ *  transfer that sends it, including after the last one finishes.
+ */
+static void CheckFileImageReuse(nlTestSuite *inSuite, void *inContext)
+{
+    char            path[64];
+    BdxFileImage *  first   = NULL;
+    BdxFileImage *  second  = NULL;
+    BdxFileImage *  third   = NULL;
+    WEAVE_ERROR     err;
+
+    MakeTestFilePath(path, sizeof(path), 0);
+    NL_TEST_ASSERT(inSuite, WriteTestFile(path, 0, 1500000000, 0));
+
+    err = BdxFileImage::Acquire(path, first);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, first != NULL && first->GetLength() == TEST_FILE_LENGTH);
+
+    err = BdxFileImage::Acquire(path, second);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, second == first);
+
+    first->Release();
+    second->Release();
+
+    err = BdxFileImage::Acquire(path, third);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, third == first);
+
+    third->Release();
+
+    BdxFileImage::UnmapIdle();
+    unlink(path);
+}
+
+/**
+ *  Test that a file modified in place, even within the same second, is
+ *  mapped afresh and fails the transfers sending it, while a file replaced
+ *  by a rename is mapped afresh and leaves them sending the old contents.
+ */
+static void CheckFileImageStale(nlTestSuite *inSuite, void *inContext)
+{
+    char            path[64];
+    char            newPath[64];
+    BDXTransfer     xfer;
+    BdxFileImage *  image   = NULL;
+    uint8_t         block[64];
+    uint64_t        length;
+    bool            isLast;
+    WEAVE_ERROR     err;
+
+    MakeTestFilePath(path, sizeof(path), 0);
+    MakeTestFilePath(newPath, sizeof(newPath), 1);
+
+    xfer.Reset();
+    xfer.mMaxBlockSize = sizeof(block);
+
+    // Rewritten in place
+    NL_TEST_ASSERT(inSuite, WriteTestFile(path, 0, 1500000000, 100));
+
+    err = xfer.SetFileSource(path, 0, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = GetFileBlock(xfer, block, sizeof(block), length, isLast);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, length == sizeof(block) && block[1] == 1);
+
+    NL_TEST_ASSERT(inSuite, WriteTestFile(path, 0x80, 1500000000, 200));
+
+    err = BdxFileImage::Acquire(path, image);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, image != NULL && image != xfer.mFileImage);
+    image->Release();
+
+    err = GetFileBlock(xfer, block, sizeof(block), length, isLast);
+    NL_TEST_ASSERT(inSuite, err == System::MapErrorPOSIX(ESTALE));
+
+    xfer.Shutdown();
+
+    // Replaced by a rename
+    err = xfer.SetFileSource(path, 0, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, WriteTestFile(newPath, 0x40, 1500000000, 300));
+    NL_TEST_ASSERT(inSuite, rename(newPath, path) == 0);
+
+    err = BdxFileImage::Acquire(path, image);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, image != NULL && image != xfer.mFileImage);
+    image->Release();
+
+    err = GetFileBlock(xfer, block, sizeof(block), length, isLast);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, length == sizeof(block) && block[1] == 0x81);
+
+    xfer.Shutdown();
+
+    BdxFileImage::UnmapIdle();
+    unlink(path);
+}
+
+/**
+ *  Test that the part of the file sent is clamped to its end, and that the
+ *  blocks respect both the room given and the maximum block size.
+ */
+static void CheckFileImageClamping(nlTestSuite *inSuite, void *inContext)
+{
+    char            path[64];
+    BDXTransfer     xfer;
+    uint8_t         block[256];
+    uint64_t        length;
+    uint64_t        offset;
+    bool            isLast;
+    WEAVE_ERROR     err;
+
+    MakeTestFilePath(path, sizeof(path), 0);
+    NL_TEST_ASSERT(inSuite, WriteTestFile(path, 0, 1500000000, 0));
+
+    xfer.Reset();
+
+    err = xfer.SetFileSource(path, 100, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, xfer.mStartOffset == 100 && xfer.mLength == TEST_FILE_LENGTH - 100);
+
+    err = xfer.SetFileSource(path, 0, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INCORRECT_STATE);
+    xfer.Shutdown();
+
+    err = xfer.SetFileSource(path, 100, 5000);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, xfer.mLength == TEST_FILE_LENGTH - 100);
+    xfer.Shutdown();
+
+    err = xfer.SetFileSource(path, TEST_FILE_LENGTH, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, xfer.mLength == 0);
+
+    err = GetFileBlock(xfer, block, sizeof(block), length, isLast);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, length == 0 && isLast);
+    xfer.Shutdown();
+
+    err = xfer.SetFileSource(path, TEST_FILE_LENGTH + 1, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, xfer.mFileImage == NULL);
+
+    // Send bytes [200, 500) in blocks of at most 128 bytes, with less room
+    // than that for the second one.
+    err = xfer.SetFileSource(path, 200, 300);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    xfer.mMaxBlockSize = 128;
+
+    offset = 200;
+    isLast = false;
+
+    for (int i = 0; !isLast && i < 10; i++)
+    {
+        const uint64_t room = (i == 1) ? 50 : sizeof(block);
+
+        err = GetFileBlock(xfer, block, room, length, isLast);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, length <= room && length <= xfer.mMaxBlockSize);
+        NL_TEST_ASSERT(inSuite, length == ((i == 1) ? 50 : (500 - offset < 128 ? 500 - offset : 128)));
+
+        for (uint64_t j = 0; j < length; j++)
+        {
+            NL_TEST_ASSERT(inSuite, block[j] == static_cast<uint8_t>(offset + j));
+        }
+
+        offset += length;
+        NL_TEST_ASSERT(inSuite, isLast == (offset == 500));
+    }
+
+    NL_TEST_ASSERT(inSuite, offset == 500);
+
+    xfer.Shutdown();
+
+    BdxFileImage::UnmapIdle();
+    unlink(path);
+}
+
+/**
+ *  Test that the pool fails once every entry is held by a transfer, and
+ *  that a file no longer being sent gives up its entry.
+ */
+static void CheckFileImageExhaustion(nlTestSuite *inSuite, void *inContext)
+{
+    char            path[64];
+    BdxFileImage *  images[WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES];
+    BdxFileImage *  extra   = NULL;
+    WEAVE_ERROR     err;
+
+    for (int i = 0; i <= WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES; i++)
+    {
+        MakeTestFilePath(path, sizeof(path), i);
+        NL_TEST_ASSERT(inSuite, WriteTestFile(path, static_cast<uint8_t>(i), 1500000000, 0));
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES; i++)
+    {
+        MakeTestFilePath(path, sizeof(path), i);
+        err = BdxFileImage::Acquire(path, images[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    MakeTestFilePath(path, sizeof(path), WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES);
+    err = BdxFileImage::Acquire(path, extra);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(inSuite, extra == NULL);
+
+    images[0]->Release();
+
+    err = BdxFileImage::Acquire(path, extra);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, extra == images[0]);
+
+    extra->Release();
+
+    for (int i = 1; i < WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES; i++)
+    {
+        images[i]->Release();
+    }
+
+    BdxFileImage::UnmapIdle();
+
+    for (int i = 0; i <= WEAVE_CONFIG_BDX_MAX_NUM_FILE_IMAGES; i++)
+    {
+        MakeTestFilePath(path, sizeof(path), i);
+        unlink(path);
+    }
+}
+
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("send and receive init with windowed mode",   CheckInitWindowed),
+    NL_TEST_DEF("send accept with windowed mode",             CheckSendAcceptWindowed),
+    NL_TEST_DEF("receive accept with windowed mode",          CheckReceiveAcceptWindowed),
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    NL_TEST_DEF("file image reuse",                           CheckFileImageReuse),
+    NL_TEST_DEF("file image changed while mapped",            CheckFileImageStale),
+    NL_TEST_DEF("file image offset and length clamping",      CheckFileImageClamping),
+    NL_TEST_DEF("file image pool exhaustion",                 CheckFileImageExhaustion),
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    nlTestSuite theSuite = {
+        "weave-bdx",
+        &sTests[0]
+    };
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    tcpip_init(NULL, NULL);
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
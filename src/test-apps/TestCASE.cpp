@@ -318,6 +318,7 @@ public:
         mTestName = testName;
         mProposedConfig = mExpectedConfig = kCASEConfig_NotSpecified;
         mProposedCurve = mExpectedCurve = kWeaveCurveId_NotSpecified;
+        mEncryptionType = kWeaveEncryptionType_AES128CTRSHA1;
         mInitiatorAllowedConfigs = mResponderAllowedConfigs = kCASEAllowedConfig_Config1|kCASEAllowedConfig_Config2;
         mInitiatorAllowedCurves = mResponderAllowedCurves = kWeaveCurveSet_prime192v1|kWeaveCurveSet_secp160r1|kWeaveCurveSet_secp224r1|kWeaveCurveSet_prime256v1;
         mInitiatorRequestKeyConfirm = true;
@@ -339,6 +340,9 @@ public:
     uint32_t ProposedCurve() const { return mProposedCurve; }
     CASEEngineTest& ProposedCurve(uint32_t val) { mProposedCurve = val; return *this; }
 
+    uint8_t EncryptionType() const { return mEncryptionType; }
+    CASEEngineTest& EncryptionType(uint8_t val) { mEncryptionType = val; return *this; }
+
     uint32_t InitiatorAllowedConfigs() const { return mInitiatorAllowedConfigs; }
     CASEEngineTest& InitiatorAllowedConfigs(uint8_t val) { mInitiatorAllowedConfigs = val; return *this; }
 
@@ -431,6 +435,7 @@ private:
     const char *mTestName;
     uint32_t mProposedConfig;
     uint32_t mProposedCurve;
+    uint8_t mEncryptionType;
     uint8_t mInitiatorAllowedConfigs;
     uint8_t mInitiatorAllowedCurves;
     uint8_t mResponderAllowedConfigs;
@@ -494,7 +499,7 @@ void CASEEngineTest::Run() const
             initiatorEng.SetAlternateCurves(req);
             req.PerformKeyConfirm = InitiatorRequestKeyConfirm();
             req.SessionKeyId = sTestDefaultSessionKeyId;
-            req.EncryptionType = kWeaveEncryptionType_AES128CTRSHA1;
+            req.EncryptionType = EncryptionType();
 
             msgBuf = PacketBuffer::New();
             VerifyOrQuit(msgBuf != NULL, "PacketBuffer::New() failed");
@@ -710,11 +715,19 @@ void CASEEngineTest::Run() const
         err = responderEng.GetSessionKey(responderKey);
         SuccessOrQuit(err, "WeaveCASEEngine::GetSessionKey() failed");
 
-        VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.DataKey, responderKey->AES128CTRSHA1.DataKey, WeaveEncryptionKey_AES128CTRSHA1::DataKeySize) == 0,
-                     "Data key mismatch");
+        if (EncryptionType() == kWeaveEncryptionType_AES128GCM)
+        {
+            VerifyOrQuit(memcmp(initiatorKey->AES128GCM.DataKey, responderKey->AES128GCM.DataKey, WeaveEncryptionKey_AES128GCM::DataKeySize) == 0,
+                         "Data key mismatch");
+        }
+        else
+        {
+            VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.DataKey, responderKey->AES128CTRSHA1.DataKey, WeaveEncryptionKey_AES128CTRSHA1::DataKeySize) == 0,
+                         "Data key mismatch");
 
-        VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.IntegrityKey, responderKey->AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize) == 0,
-                     "Integrity key mismatch");
+            VerifyOrQuit(memcmp(initiatorKey->AES128CTRSHA1.IntegrityKey, responderKey->AES128CTRSHA1.IntegrityKey, WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize) == 0,
+                         "Integrity key mismatch");
+        }
 
         VerifyOrQuit(IsSuccessExpected(), "Test succeeded unexpectedly");
 
@@ -741,6 +754,17 @@ void CASEEngineTests_BasicTests()
     // Basic sanity test with standard parameters
     CASEEngineTest("Sanity test")
         .Run();
+
+    // Sanity test with AES-128-GCM message encryption
+    CASEEngineTest("AES-128-GCM session")
+        .EncryptionType(kWeaveEncryptionType_AES128GCM)
+        .Run();
+
+    // Unsupported encryption type
+    CASEEngineTest("Unsupported encryption type")
+        .EncryptionType(kWeaveEncryptionType_None)
+        .ExpectError("Initiator:GenerateBeginSessionRequest", WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE)
+        .Run();
 }
 
 void CASEEngineTests_EllipticCurveTests()
@@ -0,0 +1,299 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for
+ *      <tt>nl::Weave::CryptoWorkerPool</tt>, which runs time-consuming
+ *      cryptographic jobs off the Weave event thread and posts their
+ *      completions back to the system layer.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nltest.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveCryptoWorkerPool.h>
+
+#include "ToolCommon.h"
+
+enum
+{
+    kTestNumJobs            = 16,
+    kTestNumWorkers         = 3,
+    kTestTimeoutMs          = 10000,
+};
+
+struct TestJob
+{
+    CryptoJob Job;
+    uint32_t Input;
+    uint32_t Output;
+    WEAVE_ERROR Result;
+    uint32_t NumCompletions;
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    pthread_t RunThread;
+    bool CompletedOnEventThread;
+#endif
+};
+
+static TestJob sJobs[kTestNumJobs];
+static uint32_t sNumCompleted;
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+static pthread_t sEventThread;
+#endif
+
+static WEAVE_ERROR RunTestJob(CryptoJob *job)
+{
+    TestJob *testJob = static_cast<TestJob *>(job->AppState);
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    testJob->RunThread = pthread_self();
+#endif
+
+    // Stand-in for a public-key operation.
+    testJob->Output = testJob->Input;
+    for (int i = 0; i < 100000; i++)
+        testJob->Output = testJob->Output * 1664525 + 1013904223;
+
+    return (testJob->Input % 3 == 0) ? WEAVE_ERROR_INVALID_SIGNATURE : WEAVE_NO_ERROR;
+}
+
+static void HandleTestJobComplete(CryptoJob *job, WEAVE_ERROR result)
+{
+    TestJob *testJob = static_cast<TestJob *>(job->AppState);
+
+    testJob->Result = result;
+    testJob->NumCompletions++;
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    testJob->CompletedOnEventThread = pthread_equal(pthread_self(), sEventThread);
+#endif
+    sNumCompleted++;
+}
+
+static void PrepareJobs(void)
+{
+    memset(sJobs, 0, sizeof(sJobs));
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        sJobs[i].Job.Run = RunTestJob;
+        sJobs[i].Job.OnComplete = HandleTestJobComplete;
+        sJobs[i].Job.AppState = &sJobs[i];
+        sJobs[i].Input = i;
+    }
+    sNumCompleted = 0;
+}
+
+static void ServiceEventsUntil(uint32_t numCompleted, uint32_t timeoutMs)
+{
+    const uint64_t deadline = System::Layer::GetClock_MonotonicMS() + timeoutMs;
+
+    while (sNumCompleted < numCompleted && System::Layer::GetClock_MonotonicMS() < deadline)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceNetwork(sleepTime);
+    }
+}
+
+static void CheckJobResults(nlTestSuite *inSuite)
+{
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        uint32_t expected = i;
+        for (int j = 0; j < 100000; j++)
+            expected = expected * 1664525 + 1013904223;
+
+        NL_TEST_ASSERT(inSuite, sJobs[i].NumCompletions == 1);
+        NL_TEST_ASSERT(inSuite, sJobs[i].Output == expected);
+        NL_TEST_ASSERT(inSuite, sJobs[i].Result == ((i % 3 == 0) ? WEAVE_ERROR_INVALID_SIGNATURE : WEAVE_NO_ERROR));
+    }
+}
+
+/**
+ *  Check that a pool without workers runs each job and its completion within Submit().
+ */
+static void CheckInlineJobs(nlTestSuite *inSuite, void *inContext)
+{
+    CryptoWorkerPool pool;
+    WEAVE_ERROR err;
+
+    PrepareJobs();
+
+    err = pool.Submit(&sJobs[0].Job);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INCORRECT_STATE);
+
+    err = pool.Init(SystemLayer, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.NumWorkers() == 0);
+
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        err = pool.Submit(&sJobs[i].Job);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, sNumCompleted == i + 1);
+    }
+
+    CheckJobResults(inSuite);
+
+    pool.Shutdown();
+}
+
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+
+/**
+ *  Check that jobs run on worker threads and complete on the event thread.
+ */
+static void CheckWorkerJobs(nlTestSuite *inSuite, void *inContext)
+{
+    CryptoWorkerPool pool;
+    WEAVE_ERROR err;
+
+    PrepareJobs();
+    sEventThread = pthread_self();
+
+    err = pool.Init(SystemLayer, kTestNumWorkers);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.NumWorkers() == kTestNumWorkers);
+
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        err = pool.Submit(&sJobs[i].Job);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    ServiceEventsUntil(kTestNumJobs, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sNumCompleted == kTestNumJobs);
+
+    CheckJobResults(inSuite);
+
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        NL_TEST_ASSERT(inSuite, !pthread_equal(sJobs[i].RunThread, sEventThread));
+        NL_TEST_ASSERT(inSuite, sJobs[i].CompletedOnEventThread);
+    }
+
+    pool.Shutdown();
+}
+
+/**
+ *  Check that shutting the pool down suppresses outstanding completions, and that a
+ *  job object resubmitted after re-initialization completes exactly once.
+ */
+static void CheckShutdownDropsCompletions(nlTestSuite *inSuite, void *inContext)
+{
+    CryptoWorkerPool pool;
+    WEAVE_ERROR err;
+
+    PrepareJobs();
+    sEventThread = pthread_self();
+
+    err = pool.Init(SystemLayer, 1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (uint32_t i = 0; i < kTestNumJobs; i++)
+    {
+        err = pool.Submit(&sJobs[i].Job);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    pool.Shutdown();
+
+    err = pool.Submit(&sJobs[0].Job);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INCORRECT_STATE);
+
+    err = pool.Init(SystemLayer, 1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Resubmit the first job before any completion posted by the old workers has been serviced.
+    err = pool.Submit(&sJobs[0].Job);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    ServiceEventsUntil(1, kTestTimeoutMs);
+
+    // Give any stale completions a chance to be (wrongly) delivered.
+    ServiceEventsUntil(kTestNumJobs, 100);
+
+    NL_TEST_ASSERT(inSuite, sNumCompleted == 1);
+    NL_TEST_ASSERT(inSuite, sJobs[0].NumCompletions == 1);
+    NL_TEST_ASSERT(inSuite, sJobs[0].Result == WEAVE_ERROR_INVALID_SIGNATURE);
+
+    pool.Shutdown();
+}
+
+#endif // WEAVE_CRYPTO_WORKER_POOL_THREADS
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    ShutdownSystemLayer();
+
+    return SUCCESS;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("CryptoWorkerPool::InlineJobs",             CheckInlineJobs),
+#if WEAVE_CRYPTO_WORKER_POOL_THREADS
+    NL_TEST_DEF("CryptoWorkerPool::WorkerJobs",             CheckWorkerJobs),
+    NL_TEST_DEF("CryptoWorkerPool::ShutdownDropsCompletions", CheckShutdownDropsCompletions),
+#endif
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    nlTestSuite theSuite =
+    {
+        "weave-crypto-worker-pool",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, &theSuite);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -32,6 +32,7 @@
 
 #include <new>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -1193,6 +1194,34 @@ exit:
     return err;
 }
 
+// Fetch the Production events starting from inStart, and check that the
+// fetch runs through inLastEventID and that the first event returned is
+// the earliest one still logged at or after inStart.  The events are
+// expected to have been logged at inTestStart plus 10 ms per event ID.
+static void CheckFetchProductionSince(nlTestSuite *inSuite, event_id_t inStart, event_id_t inLastEventID, timestamp_t inTestStart)
+{
+    WEAVE_ERROR err;
+    nl::Weave::Profiles::DataManagement::LoggingManagement &logger = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    event_id_t firstEventID = logger.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production);
+    event_id_t event_id_read = inStart;
+    TLVReader testReader;
+    TLVWriter testWriter;
+    utc_timestamp_t testUtcTimestamp = 0;
+    timestamp_t testTimestamp = 0;
+    event_id_t testEventID = 0;
+
+    testWriter.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+    err = logger.FetchEventsSince(testWriter, nl::Weave::Profiles::DataManagement::Production, event_id_read);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, event_id_read == inLastEventID + 1);
+
+    testReader.Init(gLargeMemoryBackingStore, testWriter.GetLengthWritten());
+    err = ReadFirstEventHeader(testReader, testTimestamp, testUtcTimestamp, testEventID);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testEventID == (inStart < firstEventID ? firstEventID : inStart));
+    NL_TEST_ASSERT(inSuite, testTimestamp == inTestStart + testEventID * 10);
+}
+
 static void CheckFetchTimestamps(nlTestSuite *inSuite, void *inContext)
 {
     WEAVE_ERROR err;
@@ -1283,6 +1312,253 @@ static void CheckFetchTimestamps(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+static void CheckFetchFromCheckpoint(nlTestSuite *inSuite, void *inContext)
+{
+    TestLoggingContext *context = static_cast<TestLoggingContext *>(inContext);
+    event_id_t eid = 0, first_eid;
+    const int k_num_events = 200;
+    timestamp_t test_start;
+    int counter;
+    InitializeEventLogging(context);
+
+    test_start = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+    System::Layer::SetClock_RealTime(0);
+
+    // Interleave debug, info and production events so that production
+    // events are bumped between buffers and eventually dropped.
+    for (counter = 0; counter < k_num_events; counter++)
+    {
+        FastLogFreeform(nl::Weave::Profiles::DataManagement::Debug, test_start + counter * 10, "%u", counter);
+        FastLogFreeform(nl::Weave::Profiles::DataManagement::Info, test_start + counter * 10, "%u", counter);
+        eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, test_start + counter * 10, "%u", counter);
+        NL_TEST_ASSERT(inSuite, eid == static_cast<event_id_t>(counter));
+    }
+
+    first_eid = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().GetFirstEventID(nl::Weave::Profiles::DataManagement::Production);
+    NL_TEST_ASSERT(inSuite, first_eid > 0);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+    {
+        CircularEventBuffer *prodBuf = reinterpret_cast<CircularEventBuffer *>(&gProdEventBuffer[0]);
+        int numCheckpoints = 0;
+
+        for (counter = 0; counter < WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE; counter++)
+        {
+            if (prodBuf->mCheckpoints[counter].mBuffer != NULL && prodBuf->mCheckpoints[counter].mEventID >= first_eid)
+                numCheckpoints++;
+        }
+        NL_TEST_ASSERT(inSuite, numCheckpoints > 1);
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_CHECKPOINT_INDEX_SIZE
+
+    // Every starting point, including one that has already been
+    // dropped, must yield the right first event and timestamp.
+    for (event_id_t start = 0; start <= eid; start++)
+    {
+        CheckFetchProductionSince(inSuite, start, eid, test_start);
+    }
+
+    DestroyEventLogging(context);
+}
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+static WEAVE_ERROR FastStageFreeform(EventStagingRing *inRing, ImportanceType inImportance, timestamp_t inTimestamp, const char * inFormat, ...)
+{
+    DebugLogContext context;
+    nl::Weave::Profiles::DataManagement::EventOptions options;
+    WEAVE_ERROR err;
+    EventSchema schema = {
+        kWeaveProfile_NestDebug,
+        kNestDebug_StringLogEntryEvent,
+        inImportance,
+        1,
+        1
+    };
+
+    va_start(context.mArgs, inFormat);
+    context.mRegion = "";
+    context.mFmt = inFormat;
+
+    options = EventOptions(inTimestamp, NULL, 0, nl::Weave::Profiles::DataManagement::kImportanceType_Invalid, false);
+
+    err = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().StageEvent(inRing, schema, PlainTextWriter, &context, &options);
+
+    va_end(context.mArgs);
+
+    return err;
+}
+
+static void CheckStagedEvents(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    TestLoggingContext *context = static_cast<TestLoggingContext *>(inContext);
+    nl::Weave::Profiles::DataManagement::LoggingManagement &logger = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    EventStagingRing *ringA, *ringB;
+    event_id_t eid;
+    const int k_num_rounds = 100;
+    timestamp_t test_start;
+    int counter;
+    InitializeEventLogging(context);
+
+    test_start = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+
+    ringA = logger.AcquireStagingRing();
+    ringB = logger.AcquireStagingRing();
+    NL_TEST_ASSERT(inSuite, ringA != NULL && ringB != NULL && ringA != ringB);
+
+    eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, test_start, "%u", 0);
+    NL_TEST_ASSERT(inSuite, eid == 0);
+
+    // Staged events are not visible until drained, and are committed
+    // in staging order regardless of which ring holds them.  Enough
+    // rounds are run to wrap both rings several times.
+    for (counter = 0; counter < k_num_rounds; counter++)
+    {
+        timestamp_t base = test_start + (4 * counter + 1) * 10;
+
+        err = FastStageFreeform(ringA, nl::Weave::Profiles::DataManagement::Production, base, "%u", 4 * counter + 1);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = FastStageFreeform(ringB, nl::Weave::Profiles::DataManagement::Production, base + 10, "%u", 4 * counter + 2);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = FastStageFreeform(ringA, nl::Weave::Profiles::DataManagement::Production, base + 20, "%u", 4 * counter + 3);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, logger.GetLastEventID(nl::Weave::Profiles::DataManagement::Production) == eid);
+
+        if (counter % 2 == 0)
+        {
+            // A direct LogEvent commits everything staged before it.
+            eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, base + 30, "%u", 4 * counter + 4);
+        }
+        else
+        {
+            err = FastStageFreeform(ringB, nl::Weave::Profiles::DataManagement::Production, base + 30, "%u", 4 * counter + 4);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            logger.DrainStagedEvents();
+            eid = logger.GetLastEventID(nl::Weave::Profiles::DataManagement::Production);
+        }
+        NL_TEST_ASSERT(inSuite, eid == static_cast<event_id_t>(4 * counter + 4));
+    }
+
+    logger.ReleaseStagingRing(ringA);
+    logger.ReleaseStagingRing(ringB);
+
+    for (event_id_t start = logger.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production); start <= eid; start++)
+    {
+        CheckFetchProductionSince(inSuite, start, eid, test_start);
+    }
+
+    DestroyEventLogging(context);
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+static void CheckPersistentBuffers(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    TestLoggingContext *context = static_cast<TestLoggingContext *>(inContext);
+    nl::Weave::Profiles::DataManagement::LoggingManagement &logger = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    PersistentEventBuffer persistentBuffers[4];
+    size_t arraySizes[] = { sizeof(gDebugEventBuffer), sizeof(gInfoEventBuffer), sizeof(gProdEventBuffer), sizeof(gCritEventBuffer) };
+    void *arrays[4];
+    char path[64];
+    event_id_t eid = 0;
+    const int k_num_events = 50;
+    timestamp_t test_start;
+    int counter;
+
+    test_start = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+
+    // Run the logging subsystem four times over the same files: the
+    // second run must pick up where the first left off, and the third
+    // and fourth must discard the logs left inconsistent at the end of
+    // the runs before them.
+    for (int run = 0; run < 4; run++)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            snprintf(path, sizeof(path), "/tmp/TestEventLogging-%d-%u.log", static_cast<int>(getpid()), static_cast<unsigned>(i));
+            if (run == 0)
+            {
+                unlink(path);
+            }
+
+            err = persistentBuffers[i].Open(path, arraySizes[i]);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            arrays[i] = persistentBuffers[i].GetBuffer();
+        }
+
+        nl::Weave::Profiles::DataManagement::LoggingManagement::CreateLoggingManagement(context->mExchangeMgr, 4, &arraySizes[0], &arrays[0], NULL, NULL, NULL);
+        nl::Weave::Profiles::DataManagement::LoggingConfiguration::GetInstance().mGlobalImportance = nl::Weave::Profiles::DataManagement::Debug;
+
+        err = logger.AttachPersistentBuffers(persistentBuffers, 4);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        if ((run == 0) || (run == 2))
+        {
+            if (run == 2)
+            {
+                NL_TEST_ASSERT(inSuite, logger.GetLastEventID(nl::Weave::Profiles::DataManagement::Production) == 0);
+            }
+
+            for (counter = 0; counter < k_num_events; counter++)
+            {
+                eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, test_start + counter * 10, "%u", counter);
+                NL_TEST_ASSERT(inSuite, eid == static_cast<event_id_t>(counter));
+            }
+
+            if (run == 2)
+            {
+                memset(static_cast<uint8_t *>(arrays[0]) + sizeof(CircularEventBuffer), 0xff, arraySizes[0] - sizeof(CircularEventBuffer));
+            }
+        }
+        else if (run == 1)
+        {
+            NL_TEST_ASSERT(inSuite, logger.GetLastEventID(nl::Weave::Profiles::DataManagement::Production) == eid);
+
+            for (event_id_t start = logger.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production); start <= eid; start++)
+            {
+                CheckFetchProductionSince(inSuite, start, eid, test_start);
+            }
+
+            // New events follow on from the restored ones.
+            eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, test_start + k_num_events * 10, "%u", k_num_events);
+            NL_TEST_ASSERT(inSuite, eid == static_cast<event_id_t>(k_num_events));
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, logger.GetLastEventID(nl::Weave::Profiles::DataManagement::Production) == 0);
+            NL_TEST_ASSERT(inSuite, logger.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production) == 0);
+        }
+
+        // Shutting down writes out the events still within the persist
+        // interval.
+        DestroyEventLogging(context);
+
+        if (run == 1)
+        {
+            // Record one more Production event than the buffers hold.
+            const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const size_t headerLength = ((sizeof(PersistedEventBufferHeader) + pageSize - 1) / pageSize) * pageSize;
+            PersistedEventBufferHeader *header = reinterpret_cast<PersistedEventBufferHeader *>(static_cast<uint8_t *>(arrays[2]) - headerLength);
+
+            header->mState[header->mSequence & 1].mLastEventID++;
+            header->mState[header->mSequence & 1].mNextEventID++;
+        }
+
+        for (size_t i = 0; i < 4; i++)
+        {
+            persistentBuffers[i].Close();
+        }
+    }
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        snprintf(path, sizeof(path), "/tmp/TestEventLogging-%d-%u.log", static_cast<int>(getpid()), static_cast<unsigned>(i));
+        unlink(path);
+    }
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+
 WEAVE_ERROR WriteLargeEvent(nl::Weave::TLV::TLVWriter & writer, uint8_t inDataTag, void * anAppState)
 {
     WEAVE_ERROR err =  WEAVE_NO_ERROR;
@@ -3549,6 +3825,13 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Check Fetch Events", CheckFetchEvents),
     NL_TEST_DEF("Check Large Events", CheckLargeEvents),
     NL_TEST_DEF("Check Fetch Event Timestamps", CheckFetchTimestamps),
+    NL_TEST_DEF("Check Fetch From Checkpoint", CheckFetchFromCheckpoint),
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+    NL_TEST_DEF("Check Staged Events", CheckStagedEvents),
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_RINGS
+#if WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
+    NL_TEST_DEF("Check Persistent Buffers", CheckPersistentBuffers),
+#endif // WEAVE_CONFIG_EVENT_LOGGING_PERSISTENT_BUFFERS
     NL_TEST_DEF("Basic Deserialization Test", CheckBasicEventDeserialization),
     NL_TEST_DEF("Complex Deserialization Test", CheckComplexEventDeserialization),
     NL_TEST_DEF("Empty Array Deserialization Test", CheckEmptyArrayEventDeserialization),
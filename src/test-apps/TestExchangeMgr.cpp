@@ -0,0 +1,581 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the exchange context
+ *      pool and the message dispatch of <tt>nl::Weave::WeaveExchangeManager</tt>,
+ *      and for the session context pool of <tt>nl::Weave::WeaveSecurityManager</tt>.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nltest.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveEncoding.h>
+#include <SystemLayer/SystemTimer.h>
+
+#include "ToolCommon.h"
+
+using namespace nl::Weave::Encoding;
+
+enum
+{
+    kTestPoolSize           = 1000,     // Larger than WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS, so the pool comes from the heap.
+    kTestProfileId          = 0x235A1234,
+    kTestOtherProfileId     = 0x235A1235,
+    kTestMsgType            = 1,
+    kTestOtherMsgType       = 2,
+};
+
+static const uint64_t kTestPeerNodeIdBase = 0x18B4300000001000ULL;
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+// Retransmission timeouts, in milliseconds, of the messages sent by the retransmission tests.
+static const uint32_t kTestRetransTimeouts[] = { 40, 10, 30, 20 };
+
+enum
+{
+    kTestNumRetransMsgs     = sizeof(kTestRetransTimeouts) / sizeof(kTestRetransTimeouts[0]),
+    kTestDiscardPort        = 9,        // Nothing acknowledges messages sent here.
+};
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+struct TestContext
+{
+    nlTestSuite *Suite;
+    ExchangeContext *Contexts[kTestPoolSize];
+    uint32_t NumReceived[kTestPoolSize];
+    uintptr_t LastUnsolicitedHandler;
+    size_t NumSendErrors;
+    uintptr_t SendErrorOrder[kTestPoolSize];
+    uint64_t SendErrorTime[kTestPoolSize];
+};
+
+static TestContext sContext;
+
+static void HandleContextMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+        uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    uintptr_t i = (uintptr_t) ec->AppState;
+
+    NL_TEST_ASSERT(sContext.Suite, i < kTestPoolSize && sContext.Contexts[i] == ec);
+    if (i < kTestPoolSize)
+        sContext.NumReceived[i]++;
+
+    PacketBuffer::Free(payload);
+}
+
+static void HandleUnsolicitedMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+        uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    sContext.LastUnsolicitedHandler = (uintptr_t) ec->AppState;
+
+    PacketBuffer::Free(payload);
+    ec->Close();
+}
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+static void HandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt)
+{
+    NL_TEST_ASSERT(sContext.Suite, err == WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED);
+
+    if (sContext.NumSendErrors < kTestPoolSize)
+    {
+        sContext.SendErrorOrder[sContext.NumSendErrors] = (uintptr_t) msgCtxt;
+        sContext.SendErrorTime[sContext.NumSendErrors] = System::Timer::GetCurrentEpoch();
+    }
+    sContext.NumSendErrors++;
+}
+
+/**
+ *  Send a message that requests an acknowledgment to a peer that never sends one, on a new exchange.
+ */
+static WEAVE_ERROR SendUnacknowledgedMessage(uintptr_t index, uint32_t retransTimeout, uint8_t maxRetrans)
+{
+    WEAVE_ERROR err;
+    ExchangeContext *ec;
+    PacketBuffer *buf;
+    IPAddress peerAddr;
+
+    IPAddress::FromString("::1", peerAddr);
+
+    ec = ExchangeMgr.NewContext(kTestPeerNodeIdBase, peerAddr, kTestDiscardPort, INET_NULL_INTERFACEID, (void *) index);
+    VerifyOrExit(ec != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    ec->mWRMPConfig.mInitialRetransTimeout = retransTimeout;
+    ec->mWRMPConfig.mActiveRetransTimeout = retransTimeout;
+    ec->mWRMPConfig.mMaxRetrans = maxRetrans;
+    ec->OnSendError = HandleSendError;
+
+    buf = PacketBuffer::New();
+    if (buf == NULL)
+    {
+        ec->Close();
+        ExitNow(err = WEAVE_ERROR_NO_MEMORY);
+    }
+
+    err = ec->SendMessage(kTestProfileId, kTestMsgType, buf, ExchangeContext::kSendFlag_RequestAck, (void *) index);
+
+    sContext.Contexts[index] = ec;
+
+exit:
+    return err;
+}
+
+/**
+ *  Service the network until the given number of send errors has been reported, or a second has passed, then
+ *  close the exchanges.
+ */
+static void WaitForSendErrors(size_t numErrors)
+{
+    const uint64_t deadline = System::Timer::GetCurrentEpoch() + 1000;
+
+    while (sContext.NumSendErrors < numErrors && System::Timer::GetCurrentEpoch() < deadline)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000;
+        ServiceNetwork(sleepTime);
+    }
+
+    for (size_t i = 0; i < numErrors; i++)
+    {
+        if (sContext.Contexts[i] != NULL)
+        {
+            sContext.Contexts[i]->Close();
+            sContext.Contexts[i] = NULL;
+        }
+    }
+}
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+/**
+ *  Deliver a message to the exchange manager as the message layer would after receiving it over UDP.
+ */
+static void DeliverMessage(uint64_t srcNodeId, uint16_t exchangeId, bool fromInitiator, uint32_t profileId, uint8_t msgType)
+{
+    PacketBuffer *buf = PacketBuffer::New();
+    WeaveMessageInfo msgInfo;
+    IPPacketInfo pktInfo;
+    uint8_t *p;
+
+    NL_TEST_ASSERT(sContext.Suite, buf != NULL);
+    if (buf == NULL)
+        return;
+
+    p = buf->Start();
+    Write8(p, (kWeaveExchangeVersion_V1 << 4) | (fromInitiator ? kWeaveExchangeFlag_Initiator : 0));
+    Write8(p, msgType);
+    LittleEndian::Write16(p, exchangeId);
+    LittleEndian::Write32(p, profileId);
+    buf->SetDataLength(p - buf->Start());
+
+    pktInfo.Clear();
+    msgInfo.Clear();
+    msgInfo.MessageVersion = kWeaveMessageVersion_V1;
+    msgInfo.SourceNodeId = srcNodeId;
+    msgInfo.DestNodeId = FabricState.LocalNodeId;
+    msgInfo.EncryptionType = kWeaveEncryptionType_None;
+    msgInfo.InPacketInfo = &pktInfo;
+
+    MessageLayer.OnMessageReceived(&MessageLayer, &msgInfo, buf);
+}
+
+/**
+ *  Test that the pool holds exactly the number of contexts requested at initialization.
+ */
+static void CheckContextPoolSize(nlTestSuite *inSuite, void *inContext)
+{
+    ExchangeContext *ec;
+
+    for (int i = 0; i < kTestPoolSize; i++)
+    {
+        sContext.Contexts[i] = ExchangeMgr.NewContext(kTestPeerNodeIdBase + i, (void *) (uintptr_t) i);
+        NL_TEST_ASSERT(inSuite, sContext.Contexts[i] != NULL);
+    }
+
+    ec = ExchangeMgr.NewContext(kTestPeerNodeIdBase, NULL);
+    NL_TEST_ASSERT(inSuite, ec == NULL);
+
+    // A released context is available again.
+    sContext.Contexts[0]->Close();
+    ec = ExchangeMgr.NewContext(kTestPeerNodeIdBase, NULL);
+    NL_TEST_ASSERT(inSuite, ec == sContext.Contexts[0]);
+    ec->Close();
+
+    for (int i = 1; i < kTestPoolSize; i++)
+        sContext.Contexts[i]->Close();
+}
+
+/**
+ *  Test that responses are dispatched to the context that initiated the exchange, including after other contexts
+ *  have been removed from the exchange index.
+ */
+static void CheckDispatchToContext(nlTestSuite *inSuite, void *inContext)
+{
+    memset(sContext.NumReceived, 0, sizeof(sContext.NumReceived));
+
+    for (int i = 0; i < kTestPoolSize; i++)
+    {
+        // Give the contexts only a few peers, so that many of them share node ids.
+        sContext.Contexts[i] = ExchangeMgr.NewContext(kTestPeerNodeIdBase + (i % 7), (void *) (uintptr_t) i);
+        NL_TEST_ASSERT(inSuite, sContext.Contexts[i] != NULL);
+        if (sContext.Contexts[i] == NULL)
+            return;
+        sContext.Contexts[i]->OnMessageReceived = HandleContextMessage;
+    }
+
+    for (int i = 0; i < kTestPoolSize; i++)
+        DeliverMessage(kTestPeerNodeIdBase + (i % 7), sContext.Contexts[i]->ExchangeId, false, kTestProfileId, kTestMsgType);
+
+    for (int i = 0; i < kTestPoolSize; i++)
+        NL_TEST_ASSERT(inSuite, sContext.NumReceived[i] == 1);
+
+    // Messages from the wrong peer, or sent by an initiator, do not belong to the exchange.
+    DeliverMessage(kTestPeerNodeIdBase + 7, sContext.Contexts[0]->ExchangeId, false, kTestProfileId, kTestMsgType);
+    DeliverMessage(kTestPeerNodeIdBase, sContext.Contexts[0]->ExchangeId, true, kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.NumReceived[0] == 1);
+
+    // Close every third context and check that the others are still found.
+    for (int i = 0; i < kTestPoolSize; i += 3)
+    {
+        sContext.Contexts[i]->Close();
+        sContext.Contexts[i] = NULL;
+    }
+
+    for (int i = 0; i < kTestPoolSize; i++)
+    {
+        if (sContext.Contexts[i] != NULL)
+            DeliverMessage(kTestPeerNodeIdBase + (i % 7), sContext.Contexts[i]->ExchangeId, false, kTestProfileId, kTestMsgType);
+    }
+
+    for (int i = 0; i < kTestPoolSize; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sContext.NumReceived[i] == ((i % 3 == 0) ? 1 : 2));
+        if (sContext.Contexts[i] != NULL)
+            sContext.Contexts[i]->Close();
+    }
+}
+
+/**
+ *  Test that unsolicited messages are dispatched to the handler registered for their message type, or to the
+ *  handler for their whole profile.
+ */
+static void CheckDispatchUnsolicited(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(kTestProfileId, kTestMsgType, HandleUnsolicitedMessage, (void *) 1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(kTestProfileId, HandleUnsolicitedMessage, (void *) 2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(kTestOtherProfileId, kTestMsgType, HandleUnsolicitedMessage, (void *) 3);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 1, true, kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 1);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 2, true, kTestProfileId, kTestOtherMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 2);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 3, true, kTestOtherProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 3);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 4, true, kTestOtherProfileId, kTestOtherMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 0);
+
+    // Re-registering replaces the app state of the existing registration.
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(kTestProfileId, kTestMsgType, HandleUnsolicitedMessage, (void *) 4);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 5, true, kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 4);
+
+    // Once the message type handler is gone, the profile handler takes over.
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 6, true, kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 2);
+
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(kTestProfileId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(kTestOtherProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    sContext.LastUnsolicitedHandler = 0;
+    DeliverMessage(kTestPeerNodeIdBase, 7, true, kTestProfileId, kTestMsgType);
+    NL_TEST_ASSERT(inSuite, sContext.LastUnsolicitedHandler == 0);
+}
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+/**
+ *  Test that each unacknowledged message is retransmitted and given up on at its own deadline, to the millisecond
+ *  rather than on a shared timer tick.
+ */
+static void CheckRetransmitSchedule(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t start = System::Timer::GetCurrentEpoch();
+    WEAVE_ERROR err;
+
+    sContext.NumSendErrors = 0;
+    memset(sContext.Contexts, 0, sizeof(sContext.Contexts));
+
+    for (int i = 0; i < kTestNumRetransMsgs; i++)
+    {
+        err = SendUnacknowledgedMessage(i, kTestRetransTimeouts[i], 1);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    WaitForSendErrors(kTestNumRetransMsgs);
+    NL_TEST_ASSERT(inSuite, sContext.NumSendErrors == kTestNumRetransMsgs);
+
+    // Each message is sent, retransmitted once after its timeout, and given up on after another timeout, so the
+    // errors arrive in the order of the timeouts.
+    for (size_t i = 0; i < sContext.NumSendErrors && i < kTestNumRetransMsgs; i++)
+    {
+        const uintptr_t msg = sContext.SendErrorOrder[i];
+
+        NL_TEST_ASSERT(inSuite, msg < kTestNumRetransMsgs);
+        if (msg >= kTestNumRetransMsgs)
+            continue;
+
+        NL_TEST_ASSERT(inSuite, sContext.SendErrorTime[i] - start >= 2 * kTestRetransTimeouts[msg]);
+        if (i > 0)
+            NL_TEST_ASSERT(inSuite, kTestRetransTimeouts[sContext.SendErrorOrder[i - 1]] < kTestRetransTimeouts[msg]);
+    }
+}
+
+#if WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE > WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+/**
+ *  Test that the retransmission table grows beyond its initial size, and that every entry is still retransmitted
+ *  after the table has moved.
+ */
+static void CheckRetransTableGrowth(nlTestSuite *inSuite, void *inContext)
+{
+    const size_t numMsgs = 2 * WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE;
+    WEAVE_ERROR err;
+
+    sContext.NumSendErrors = 0;
+    memset(sContext.Contexts, 0, sizeof(sContext.Contexts));
+
+    for (size_t i = 0; i < numMsgs; i++)
+    {
+        err = SendUnacknowledgedMessage(i, 10 + (i % 5), 1);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    WaitForSendErrors(numMsgs);
+    NL_TEST_ASSERT(inSuite, sContext.NumSendErrors == numMsgs);
+}
+#endif // WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE > WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+
+#if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
+/**
+ *  Start an unsigned key export with a peer that never answers.
+ */
+static WEAVE_ERROR StartUnansweredKeyExport(uint64_t peerNodeId)
+{
+    IPAddress peerAddr;
+
+    IPAddress::FromString("::1", peerAddr);
+
+    return SecurityMgr.StartKeyExport(NULL, peerNodeId, peerAddr, kTestDiscardPort, WeaveKeyId::kClientRootKey, false,
+                                      NULL, NULL, NULL, NULL);
+}
+
+/**
+ *  Abandon all in-progress security manager interactions.
+ */
+static void ResetSecurityManager(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err;
+
+    SecurityMgr.Shutdown();
+    err = SecurityMgr.Init(ExchangeMgr, SystemLayer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, SecurityMgr.State == WeaveSecurityManager::kState_Idle);
+}
+
+/**
+ *  Test that the security manager runs interactions concurrently up to the overall
+ *  and per-peer limits.
+ */
+static void CheckSecurityManagerSessionLimits(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    ResetSecurityManager(inSuite);
+
+    // Fill the pool with interactions to distinct peers.
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        err = StartUnansweredKeyExport(kTestPeerNodeIdBase + i);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, SecurityMgr.State == WeaveSecurityManager::kState_KeyExportInProgress);
+
+    err = StartUnansweredKeyExport(kTestPeerNodeIdBase + WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+    ResetSecurityManager(inSuite);
+
+    // A single peer may only occupy its share of the pool.
+    for (size_t i = 0; i < WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER && i < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS; i++)
+    {
+        err = StartUnansweredKeyExport(kTestPeerNodeIdBase);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    err = StartUnansweredKeyExport(kTestPeerNodeIdBase);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+
+    if (WEAVE_CONFIG_SECURITY_MGR_MAX_SESSIONS_PER_PEER < WEAVE_CONFIG_SECURITY_MGR_MAX_CONCURRENT_SESSIONS)
+    {
+        err = StartUnansweredKeyExport(kTestPeerNodeIdBase + 1);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    ResetSecurityManager(inSuite);
+}
+#endif // WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+/**
+ *  Test the bounds on the runtime pool size.
+ */
+static void CheckInitArguments(nlTestSuite *inSuite, void *inContext)
+{
+    WeaveExchangeManager exchangeMgr;
+    WeaveMessageLayer::MessageReceiveFunct savedOnMessageReceived = MessageLayer.OnMessageReceived;
+    WeaveMessageLayer::AcceptErrorFunct savedOnAcceptError = MessageLayer.OnAcceptError;
+    WEAVE_ERROR err;
+
+    err = exchangeMgr.Init(&MessageLayer, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = exchangeMgr.Init(&MessageLayer, UINT16_MAX);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // Initializing another exchange manager re-targets the message layer; restore it afterwards.
+    err = exchangeMgr.Init(&MessageLayer, WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    exchangeMgr.Shutdown();
+
+    MessageLayer.ExchangeMgr = &ExchangeMgr;
+    MessageLayer.OnMessageReceived = savedOnMessageReceived;
+    MessageLayer.OnAcceptError = savedOnAcceptError;
+}
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    WEAVE_ERROR err;
+
+    sContext.Suite = static_cast<nlTestSuite *>(inContext);
+
+    err = nl::Weave::Platform::Security::InitSecureRandomDataSource(NULL, 64, NULL, 0);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, false);
+
+    err = ExchangeMgr.Init(&MessageLayer, kTestPoolSize);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    err = SecurityMgr.Init(ExchangeMgr, SystemLayer);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return SUCCESS;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("WeaveExchangeManager::ContextPoolSize",    CheckContextPoolSize),
+    NL_TEST_DEF("WeaveExchangeManager::DispatchToContext",  CheckDispatchToContext),
+    NL_TEST_DEF("WeaveExchangeManager::DispatchUnsolicited", CheckDispatchUnsolicited),
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    NL_TEST_DEF("WeaveExchangeManager::RetransmitSchedule", CheckRetransmitSchedule),
+#if WEAVE_CONFIG_WRMP_RETRANS_TABLE_MAX_SIZE > WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE
+    NL_TEST_DEF("WeaveExchangeManager::RetransTableGrowth", CheckRetransTableGrowth),
+#endif
+#if WEAVE_CONFIG_ENABLE_KEY_EXPORT_INITIATOR
+    NL_TEST_DEF("WeaveSecurityManager::SessionLimits",      CheckSecurityManagerSessionLimits),
+#endif
+#endif
+    NL_TEST_DEF("WeaveExchangeManager::InitArguments",      CheckInitArguments),
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    nlTestSuite theSuite =
+    {
+        "weave-exchange-mgr",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, &theSuite);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -425,6 +425,181 @@ static void TestInetEndPoint(nlTestSuite *inSuite, void *inContext)
     testTCPEP1->Shutdown();
 }
 
+// Test sending a burst of UDP messages over the loopback interface
+static unsigned int sNumUDPMessagesReceived = 0;
+
+static void HandleUDPMessageReceived(UDPEndPoint *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    if (msg->DataLength() == sizeof(sNumUDPMessagesReceived) &&
+        memcmp(msg->Start(), &sNumUDPMessagesReceived, sizeof(sNumUDPMessagesReceived)) == 0)
+    {
+        sNumUDPMessagesReceived++;
+    }
+
+    PacketBuffer::Free(msg);
+}
+
+static void TestInetUDPBurst(nlTestSuite *inSuite, void *inContext)
+{
+    enum { kNumMessages = 40, kPort = 3001, kMaxIterations = 100 };
+
+    UDPEndPoint *testUDPEP = NULL;
+    IPAddress addr = IPAddress::Any;
+    struct timeval sleepTime;
+    INET_ERROR err;
+
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 10000;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", addr));
+
+    err = Inet.NewUDPEndPoint(&testUDPEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = testUDPEP->Bind(kIPAddressType_IPv6, addr, kPort);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    testUDPEP->OnMessageReceived = HandleUDPMessageReceived;
+    err = testUDPEP->Listen();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    // Each message carries its sequence number, so that the receive handler can check the order of arrival.
+    sNumUDPMessagesReceived = 0;
+    for (unsigned int i = 0; i < kNumMessages; i++)
+    {
+        PacketBuffer *buf = PacketBuffer::New();
+
+        NL_TEST_ASSERT(inSuite, buf != NULL);
+        if (buf == NULL)
+            break;
+
+        memcpy(buf->Start(), &i, sizeof(i));
+        buf->SetDataLength(sizeof(i));
+
+        err = testUDPEP->SendTo(addr, kPort, buf);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    }
+
+    for (unsigned int i = 0; i < kMaxIterations && sNumUDPMessagesReceived < kNumMessages; i++)
+    {
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, sNumUDPMessagesReceived == kNumMessages);
+
+    testUDPEP->Free();
+}
+
+static TCPEndPoint *sTCPAcceptedEP = NULL;
+static bool sTCPConnectComplete = false;
+static uint32_t sNumTCPBytesReceived = 0;
+static bool sTCPDataInOrder = true;
+
+static void HandleTCPConnectComplete(TCPEndPoint *endPoint, INET_ERROR err)
+{
+    sTCPConnectComplete = (err == INET_NO_ERROR);
+}
+
+static void HandleTCPDataReceived(TCPEndPoint *endPoint, PacketBuffer *data)
+{
+    for (PacketBuffer *buf = data; buf != NULL; buf = buf->Next())
+    {
+        for (uint16_t i = 0; i < buf->DataLength(); i++, sNumTCPBytesReceived++)
+        {
+            if (buf->Start()[i] != static_cast<uint8_t>(sNumTCPBytesReceived % 251))
+                sTCPDataInOrder = false;
+        }
+
+        endPoint->AckReceive(buf->DataLength());
+    }
+
+    PacketBuffer::Free(data);
+}
+
+static void HandleTCPConnectionReceived(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint,
+        const IPAddress &peerAddr, uint16_t peerPort)
+{
+    sTCPAcceptedEP = conEndPoint;
+    conEndPoint->OnDataReceived = HandleTCPDataReceived;
+}
+
+// Test that a burst of buffers queued on a TCP connection arrives whole and in order
+static void TestInetTCPBurst(nlTestSuite *inSuite, void *inContext)
+{
+    enum { kNumBuffers = 8, kBufferLen = 512, kPort = 3002, kMaxIterations = 100 };
+
+    TCPEndPoint *testListenEP = NULL;
+    TCPEndPoint *testTCPEP = NULL;
+    IPAddress addr = IPAddress::Any;
+    struct timeval sleepTime;
+    uint32_t numBytesSent = 0;
+    INET_ERROR err;
+
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 10000;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", addr));
+
+    err = Inet.NewTCPEndPoint(&testListenEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = testListenEP->Bind(kIPAddressType_IPv6, addr, kPort, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    testListenEP->OnConnectionReceived = HandleTCPConnectionReceived;
+    err = testListenEP->Listen(1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = Inet.NewTCPEndPoint(&testTCPEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    testTCPEP->OnConnectComplete = HandleTCPConnectComplete;
+    err = testTCPEP->Connect(addr, kPort);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (unsigned int i = 0; i < kMaxIterations && !(sTCPConnectComplete && sTCPAcceptedEP != NULL); i++)
+    {
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, sTCPConnectComplete && sTCPAcceptedEP != NULL);
+
+    // Queue every buffer before pushing, so that they can go out together.
+    for (unsigned int i = 0; i < kNumBuffers && sTCPConnectComplete; i++)
+    {
+        PacketBuffer *buf = PacketBuffer::New(0);
+
+        NL_TEST_ASSERT(inSuite, buf != NULL);
+        if (buf == NULL)
+            break;
+
+        for (uint16_t j = 0; j < kBufferLen; j++, numBytesSent++)
+            buf->Start()[j] = static_cast<uint8_t>(numBytesSent % 251);
+        buf->SetDataLength(kBufferLen);
+
+        err = testTCPEP->Send(buf, i == kNumBuffers - 1);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    }
+
+    for (unsigned int i = 0; i < kMaxIterations && sNumTCPBytesReceived < numBytesSent; i++)
+    {
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, sNumTCPBytesReceived == kNumBuffers * kBufferLen);
+    NL_TEST_ASSERT(inSuite, sTCPDataInOrder);
+
+#if INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+    {
+        TCPEndPoint::SendStats stats;
+
+        testTCPEP->GetSendStats(stats);
+        NL_TEST_ASSERT(inSuite, stats.BytesSent == kNumBuffers * kBufferLen);
+        NL_TEST_ASSERT(inSuite, stats.SendCalls >= 1 && stats.SendCalls < kNumBuffers);
+    }
+#endif // INET_CONFIG_ENABLE_TCP_GATHERED_SEND
+
+    testTCPEP->Free();
+    if (sTCPAcceptedEP != NULL)
+        sTCPAcceptedEP->Free();
+    testListenEP->Free();
+}
+
 // Test the InetLayer resource limitation
 static void TestInetEndPointLimit(nlTestSuite *inSuite, void *inContext)
 {
@@ -436,24 +611,32 @@ static void TestInetEndPointLimit(nlTestSuite *inSuite, void *inContext)
     TCPEndPoint *testTCPEP = NULL;
     INET_ERROR err;
     char numTimersTest[WEAVE_SYSTEM_CONFIG_NUM_TIMERS + 1];
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    // Slab object pools grow beyond their configured sizes instead of running out.
+    const INET_ERROR kNoEndPointsErr = INET_NO_ERROR;
+    const INET_ERROR kNoTimersErr = WEAVE_SYSTEM_NO_ERROR;
+#else // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    const INET_ERROR kNoEndPointsErr = INET_ERROR_NO_ENDPOINTS;
+    const INET_ERROR kNoTimersErr = WEAVE_SYSTEM_ERROR_NO_MEMORY;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
 
     for (int i = 0; i < INET_CONFIG_NUM_RAW_ENDPOINTS + 1; i++)
         err = Inet.NewRawEndPoint(kIPVersion_6, kIPProtocol_ICMPv6, &testRawEP);
-    NL_TEST_ASSERT(inSuite, err == INET_ERROR_NO_ENDPOINTS);
+    NL_TEST_ASSERT(inSuite, err == kNoEndPointsErr);
 
     for (int i = 0; i < INET_CONFIG_NUM_UDP_ENDPOINTS + 1; i++)
         err = Inet.NewUDPEndPoint(&testUDPEP);
-    NL_TEST_ASSERT(inSuite, err == INET_ERROR_NO_ENDPOINTS);
+    NL_TEST_ASSERT(inSuite, err == kNoEndPointsErr);
 
 #if INET_CONFIG_ENABLE_TUN_ENDPOINT
     for (int i = 0; i < INET_CONFIG_NUM_TUN_ENDPOINTS + 1; i++)
         err = Inet.NewTunEndPoint(&testTunEP);
-    NL_TEST_ASSERT(inSuite, err == INET_ERROR_NO_ENDPOINTS);
+    NL_TEST_ASSERT(inSuite, err == kNoEndPointsErr);
 #endif
 
     for (int i = 0; i < INET_CONFIG_NUM_TCP_ENDPOINTS + 1; i++)
         err = Inet.NewTCPEndPoint(&testTCPEP);
-    NL_TEST_ASSERT(inSuite, err == INET_ERROR_NO_ENDPOINTS);
+    NL_TEST_ASSERT(inSuite, err == kNoEndPointsErr);
 
     // Verify same aComplete and aAppState args do not exhaust timer pool
     for (int i = 0; i < WEAVE_SYSTEM_CONFIG_NUM_TIMERS + 1; i++)
@@ -464,7 +647,7 @@ static void TestInetEndPointLimit(nlTestSuite *inSuite, void *inContext)
 
     for (int i = 0; i < WEAVE_SYSTEM_CONFIG_NUM_TIMERS + 1; i++)
         err = SystemLayer.StartTimer(10, HandleTimer, &numTimersTest[i]);
-    NL_TEST_ASSERT(inSuite, err == WEAVE_SYSTEM_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(inSuite, err == kNoTimersErr);
 
     ShutdownNetwork();
     ShutdownSystemLayer();
@@ -485,6 +668,8 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("InetEndPoint::TestInetError",       TestInetError),
     NL_TEST_DEF("InetEndPoint::TestInetInterface",   TestInetInterface),
     NL_TEST_DEF("InetEndPoint::TestInetEndPoint",    TestInetEndPoint),
+    NL_TEST_DEF("InetEndPoint::TestUDPBurst",        TestInetUDPBurst),
+    NL_TEST_DEF("InetEndPoint::TestTCPBurst",        TestInetTCPBurst),
     NL_TEST_DEF("InetEndPoint::TestEndPointLimit",   TestInetEndPointLimit),
     NL_TEST_SENTINEL()
 };
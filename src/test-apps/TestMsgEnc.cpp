@@ -34,6 +34,7 @@
 #include "ToolCommon.h"
 #include <Weave/Core/WeaveConfig.h>
 #include <Weave/Support/crypto/CTRMode.h>
+#include <Weave/Support/crypto/GCMMode.h>
 #include <Weave/Support/crypto/WeaveCrypto.h>
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -107,6 +108,16 @@ static const uint8_t sEncodedMsg_V2[] =
     0xD9, 0x27, 0x9D
 };
 
+static const uint8_t sEncodedMsg_V2_AES128GCM[] =
+{
+    0x20, 0x2B, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x30, 0xB4, 0x18, 0x78, 0x56,
+    0x34, 0x12, 0x00, 0x30, 0xB4, 0x18, 0x2A, 0x20, 0x12, 0x88, 0xAB, 0xCF, 0xEB, 0xA5, 0x6A, 0x4B,
+    0x9A, 0x5C, 0x70, 0x6F, 0x81, 0x85, 0x13, 0x9C, 0x6C, 0x35, 0x2D, 0x13, 0x97, 0xB2, 0xA4, 0x03,
+    0xDC, 0x4C, 0x5E, 0xAD, 0x04, 0xB2, 0x07, 0x3A, 0x82, 0x81, 0xB4, 0x1D, 0xE9, 0xD1, 0x71, 0xC3,
+    0x2C, 0x42, 0xA1, 0x46, 0x8B, 0x30, 0xF5, 0xC6, 0x9B, 0xED, 0x78, 0x0A, 0xA6, 0xCF, 0x0B, 0x98,
+    0xEF, 0x28, 0x52, 0x84, 0x8A, 0x9F, 0x52, 0xD3, 0xD3, 0xE2, 0x64, 0x7C, 0xA9, 0xBF, 0x77
+};
+
 // Test input vector format.
 struct TestContext {
     uint8_t        MsgVersion;
@@ -339,11 +350,315 @@ void WeaveMessageEncryption_Test1(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+void WeaveMessageEncryption_Test2(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveFabricState fabricState;
+    static WeaveMessageLayer messageLayer;
+    static WeaveMessageInfo msgInfo;
+
+    WEAVE_ERROR err;
+    PacketBuffer *msgBuf;
+    WeaveSessionKey *sessionKey;
+    uint64_t srcNodeId;
+    uint64_t destNodeId = 0x18B4300012345678;
+    uint32_t msgId = 3;
+    uint8_t encType = kWeaveEncryptionType_AES128GCM;
+    uint16_t sessionKeyId = sTestDefaultSessionKeyId;
+    uint8_t *p;
+
+    const char localAddrStr[] = "fd00:0:1:1:18B4:3000::2";
+    IPAddress localIPv6Addr;
+    NL_TEST_ASSERT(inSuite, ParseIPAddress(localAddrStr, localIPv6Addr));
+
+    // Initialize the FabricState object.
+    err = fabricState.Init();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    srcNodeId = localIPv6Addr.InterfaceId();
+    fabricState.LocalNodeId = srcNodeId;
+    fabricState.FabricId = localIPv6Addr.GlobalId();
+    fabricState.DefaultSubnet = localIPv6Addr.Subnet();
+
+    // Initialize message encryption session key.
+    WeaveEncryptionKey msgEncSessionKey;
+    WeaveAuthMode authMode = kWeaveAuthMode_CASE_Device;
+
+    memcpy(msgEncSessionKey.AES128GCM.DataKey, sMsgEncKey_DataKey, sizeof(sMsgEncKey_DataKey));
+
+    // Initialize session key with destination node id.
+    err = fabricState.AllocSessionKey(destNodeId, sessionKeyId, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    fabricState.SetSessionKey(sessionKey, encType, authMode, &msgEncSessionKey);
+
+    // Initialize the same session key with LocalNodeId as a destination node id.
+    err = fabricState.AllocSessionKey(srcNodeId, sessionKeyId, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    fabricState.SetSessionKey(sessionKey, encType, authMode, &msgEncSessionKey);
+
+    // Initialize the MessageLayer object.
+    messageLayer.FabricState = &fabricState;
+
+    // Run once with an intact message and once with a corrupted authentication tag.
+    for (int corruptTag = 0; corruptTag < 2; corruptTag++)
+    {
+        uint8_t localMsgBuf[sizeof(sEncodedMsg_V2_AES128GCM)];
+
+        // Allocate buffer.
+        msgBuf = PacketBuffer::New();
+        NL_TEST_ASSERT(inSuite, msgBuf != NULL);
+        if (msgBuf == NULL)
+            continue;
+
+        // Copy payload data.
+        memcpy(msgBuf->Start(), sMsgPayload, sizeof(sMsgPayload));
+        msgBuf->SetDataLength(sizeof(sMsgPayload));
+
+        // Initialize the Message info object.
+        msgInfo.Clear();
+        msgInfo.SourceNodeId = srcNodeId;
+        msgInfo.DestNodeId = destNodeId;
+        msgInfo.MessageId = msgId;
+        msgInfo.KeyId = sessionKeyId;
+        msgInfo.Flags = kWeaveMessageFlag_DestNodeId |
+                          kWeaveMessageFlag_SourceNodeId |
+                          kWeaveMessageFlag_MsgCounterSyncReq |
+                          kWeaveMessageFlag_ReuseMessageId;
+        msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+        msgInfo.EncryptionType = encType;
+
+        // =====================================================================================================
+        // Encode message using EncodeMessage() function.
+        // =====================================================================================================
+        err = messageLayer.EncodeMessage(&msgInfo, msgBuf, NULL, UINT16_MAX, 0);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+#if DEBUG_PRINT_ENABLE
+        printf("Encoded message generated by EncodeMessage():\n");
+        DumpMemoryCStyle(msgBuf->Start(), msgBuf->DataLength(), "    ", 16);
+#endif
+
+        // =====================================================================================================
+        // Manually encode message and compare against the result generated by EncodeMessage() function.
+        // =====================================================================================================
+        p = localMsgBuf;
+
+        // Write the header field.
+        uint16_t headerVal = ((uint16_t) (msgInfo.Flags & 0xF0F) << 0) |
+                             ((uint16_t) (msgInfo.EncryptionType & 0xF) << 4) |
+                             ((uint16_t) (msgInfo.MessageVersion & 0xF) << 12);
+        LittleEndian::Write16(p, headerVal);
+        LittleEndian::Write32(p, msgId);
+        LittleEndian::Write64(p, srcNodeId);
+        LittleEndian::Write64(p, destNodeId);
+        LittleEndian::Write16(p, sessionKeyId);
+
+        // Message header fields to authenticate.
+        uint8_t aad[2 * sizeof(uint64_t) + sizeof(uint16_t) + sizeof(uint32_t)];
+        uint8_t *p2 = aad;
+        Encoding::LittleEndian::Write64(p2, srcNodeId);
+        Encoding::LittleEndian::Write64(p2, destNodeId);
+        Encoding::LittleEndian::Write16(p2, headerVal & kMsgHeaderField_MessageHMACMask);
+        Encoding::LittleEndian::Write32(p2, msgId);
+
+        // Encrypt the message payload and append the authentication tag.
+        AES128GCMMode aes128GCM;
+        aes128GCM.SetKey(sMsgEncKey_DataKey);
+        aes128GCM.SetWeaveMessageIV(srcNodeId, msgId);
+        aes128GCM.AddAAD(aad, sizeof(aad));
+        aes128GCM.EncryptData(sMsgPayload, sizeof(sMsgPayload), p);
+        aes128GCM.GetTag(p + sizeof(sMsgPayload));
+
+        // Compare the result.
+        NL_TEST_ASSERT(inSuite, memcmp(msgBuf->Start(), localMsgBuf, sizeof(localMsgBuf)) == 0);
+
+        // Compare the result against the static value saved in this test.
+        NL_TEST_ASSERT(inSuite, msgBuf->DataLength() == sizeof(sEncodedMsg_V2_AES128GCM));
+        NL_TEST_ASSERT(inSuite, memcmp(msgBuf->Start(), sEncodedMsg_V2_AES128GCM, sizeof(sEncodedMsg_V2_AES128GCM)) == 0);
+
+        // =====================================================================================================
+        // Verify that DecodeMessage() generates original payload context, or rejects a corrupted message.
+        // =====================================================================================================
+        WeaveMessageLayerTestObject msgLayerTestObject;
+        uint8_t *payload;
+        uint16_t payloadLen;
+
+        if (corruptTag)
+            msgBuf->Start()[msgBuf->DataLength() - 1] ^= 0x01;
+
+        msgLayerTestObject.msgLayer = &messageLayer;
+        err = msgLayerTestObject.DecodeMessage(msgBuf, srcNodeId, NULL, &msgInfo, &payload, &payloadLen);
+
+        if (corruptTag)
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            // Compare the result of DecodeMessage() to the original Payload message data.
+            NL_TEST_ASSERT(inSuite, payloadLen == sizeof(sMsgPayload));
+            NL_TEST_ASSERT(inSuite, memcmp(payload, sMsgPayload, sizeof(sMsgPayload)) == 0);
+        }
+
+        // Release buffer.
+        PacketBuffer::Free(msgBuf);
+        msgBuf = NULL;
+    }
+}
+
+// Encode the test payload with the current session key, check the result against an expected encoding when one is
+// given, then decode it again and check that the original payload comes back.
+static void EncodeAndDecodeMessage(nlTestSuite *inSuite, WeaveMessageLayer &messageLayer, uint64_t srcNodeId, uint64_t destNodeId,
+                                   uint16_t sessionKeyId, uint8_t encType, const uint8_t *expectedMsg, uint16_t expectedMsgLen)
+{
+    WEAVE_ERROR err;
+    PacketBuffer *msgBuf;
+    WeaveMessageInfo msgInfo;
+    WeaveMessageLayerTestObject msgLayerTestObject;
+    uint8_t *payload;
+    uint16_t payloadLen;
+
+    msgBuf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, msgBuf != NULL);
+    if (msgBuf == NULL)
+        return;
+
+    memcpy(msgBuf->Start(), sMsgPayload, sizeof(sMsgPayload));
+    msgBuf->SetDataLength(sizeof(sMsgPayload));
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = srcNodeId;
+    msgInfo.DestNodeId = destNodeId;
+    msgInfo.MessageId = 3;
+    msgInfo.KeyId = sessionKeyId;
+    msgInfo.Flags = kWeaveMessageFlag_DestNodeId |
+                      kWeaveMessageFlag_SourceNodeId |
+                      kWeaveMessageFlag_MsgCounterSyncReq |
+                      kWeaveMessageFlag_ReuseMessageId;
+    msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+    msgInfo.EncryptionType = encType;
+
+    err = messageLayer.EncodeMessage(&msgInfo, msgBuf, NULL, UINT16_MAX, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    if (err == WEAVE_NO_ERROR)
+    {
+        if (expectedMsg != NULL)
+        {
+            NL_TEST_ASSERT(inSuite, msgBuf->DataLength() == expectedMsgLen);
+            NL_TEST_ASSERT(inSuite, memcmp(msgBuf->Start(), expectedMsg, expectedMsgLen) == 0);
+        }
+
+        msgLayerTestObject.msgLayer = &messageLayer;
+        err = msgLayerTestObject.DecodeMessage(msgBuf, srcNodeId, NULL, &msgInfo, &payload, &payloadLen);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        if (err == WEAVE_NO_ERROR)
+        {
+            NL_TEST_ASSERT(inSuite, payloadLen == sizeof(sMsgPayload));
+            NL_TEST_ASSERT(inSuite, memcmp(payload, sMsgPayload, sizeof(sMsgPayload)) == 0);
+        }
+    }
+
+    PacketBuffer::Free(msgBuf);
+}
+
+// Re-key the session keys used for sending to and receiving from the test peer.
+static void RekeySessionKeys(WeaveFabricState &fabricState, uint64_t srcNodeId, uint64_t destNodeId, uint16_t sessionKeyId,
+                             uint8_t encType, const WeaveEncryptionKey &encKey)
+{
+    WeaveSessionKey *sessionKey;
+
+    if (fabricState.FindSessionKey(sessionKeyId, destNodeId, false, sessionKey) == WEAVE_NO_ERROR)
+        fabricState.SetSessionKey(sessionKey, encType, kWeaveAuthMode_CASE_Device, &encKey);
+
+    if (fabricState.FindSessionKey(sessionKeyId, srcNodeId, false, sessionKey) == WEAVE_NO_ERROR)
+        fabricState.SetSessionKey(sessionKey, encType, kWeaveAuthMode_CASE_Device, &encKey);
+}
+
+/**
+ *  Check that messages are encoded and decoded with the right keys when a session key is re-keyed, possibly with
+ *  a different encryption type. With WEAVE_CONFIG_CACHE_MSG_ENC_KEY_SCHEDULES enabled, this verifies that the
+ *  cached key schedules follow each SetSessionKey().
+ */
+void WeaveMessageEncryption_Test3(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveFabricState fabricState;
+    static WeaveMessageLayer messageLayer;
+
+    WEAVE_ERROR err;
+    WeaveSessionKey *sessionKey;
+    uint64_t srcNodeId;
+    uint64_t destNodeId = 0x18B4300012345678;
+    uint16_t sessionKeyId = sTestDefaultSessionKeyId;
+    WeaveEncryptionKey otherKey;
+    WeaveEncryptionKey ctrKey;
+    WeaveEncryptionKey gcmKey;
+
+    const char localAddrStr[] = "fd00:0:1:1:18B4:3000::2";
+    IPAddress localIPv6Addr;
+    NL_TEST_ASSERT(inSuite, ParseIPAddress(localAddrStr, localIPv6Addr));
+
+    // Initialize the FabricState object.
+    err = fabricState.Init();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    srcNodeId = localIPv6Addr.InterfaceId();
+    fabricState.LocalNodeId = srcNodeId;
+    fabricState.FabricId = localIPv6Addr.GlobalId();
+    fabricState.DefaultSubnet = localIPv6Addr.Subnet();
+
+    // Initialize the key material: the test vector keys, and an unrelated key to start from.
+    memset(&otherKey, 0x5A, sizeof(otherKey));
+    memcpy(ctrKey.AES128CTRSHA1.DataKey, sMsgEncKey_DataKey, sizeof(sMsgEncKey_DataKey));
+    memcpy(ctrKey.AES128CTRSHA1.IntegrityKey, sMsgEncKey_IntegrityKey, sizeof(sMsgEncKey_IntegrityKey));
+    memcpy(gcmKey.AES128GCM.DataKey, sMsgEncKey_DataKey, sizeof(sMsgEncKey_DataKey));
+
+    // Allocate the session keys for both directions and key them with the unrelated key.
+    err = fabricState.AllocSessionKey(destNodeId, sessionKeyId, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = fabricState.AllocSessionKey(srcNodeId, sessionKeyId, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    RekeySessionKeys(fabricState, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1, otherKey);
+
+    // Initialize the MessageLayer object.
+    messageLayer.FabricState = &fabricState;
+
+    // The unrelated key must round trip, but cannot produce the test vector.
+    EncodeAndDecodeMessage(inSuite, messageLayer, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1,
+                           NULL, 0);
+
+    // Re-key with the test vector key and check the exact encoding.
+    RekeySessionKeys(fabricState, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1, ctrKey);
+    EncodeAndDecodeMessage(inSuite, messageLayer, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1,
+                           sEncodedMsg_V2, sizeof(sEncodedMsg_V2));
+
+    // Re-key the same session keys for AES-128-GCM.
+    RekeySessionKeys(fabricState, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128GCM, otherKey);
+    EncodeAndDecodeMessage(inSuite, messageLayer, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128GCM,
+                           NULL, 0);
+
+    RekeySessionKeys(fabricState, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128GCM, gcmKey);
+    EncodeAndDecodeMessage(inSuite, messageLayer, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128GCM,
+                           sEncodedMsg_V2_AES128GCM, sizeof(sEncodedMsg_V2_AES128GCM));
+
+    // And back to AES-128-CTR/HMAC-SHA-1, so that no stale integrity key state is left behind by GCM.
+    RekeySessionKeys(fabricState, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1, ctrKey);
+    EncodeAndDecodeMessage(inSuite, messageLayer, srcNodeId, destNodeId, sessionKeyId, kWeaveEncryptionType_AES128CTRSHA1,
+                           sEncodedMsg_V2, sizeof(sEncodedMsg_V2));
+}
 
 int main(int argc, char *argv[])
 {
     static const nlTest tests[] = {
         NL_TEST_DEF("WeaveMessageEncryption",           WeaveMessageEncryption_Test1),
+        NL_TEST_DEF("WeaveMessageEncryption_AES128GCM", WeaveMessageEncryption_Test2),
+        NL_TEST_DEF("WeaveMessageEncryption_Rekey",     WeaveMessageEncryption_Test3),
         NL_TEST_SENTINEL()
     };
 
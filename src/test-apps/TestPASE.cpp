@@ -45,6 +45,10 @@ void PASEEngineTests_BasicTests()
     //Fails
     PASEEngineTest("Sanity")
             .Run();
+
+    PASEEngineTest("Sanity AES-128-GCM")
+            .EncryptionType(kWeaveEncryptionType_AES128GCM)
+            .Run();
 }
 
 void PASEEngine_ConfigTest1()
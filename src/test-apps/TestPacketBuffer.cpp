@@ -1098,6 +1098,107 @@ static void CheckFreeHead(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+/**
+ *  Test PacketBuffer::SplitConsumed() function.
+ *
+ *  Description: Fill a buffer with a run of octets, consume a prefix of it and
+ *               split the consumed octets off into a new buffer.  Verify that
+ *               the new buffer holds exactly those octets, with no reserved or
+ *               available space, that the original buffer can no longer reach
+ *               them, and that the split-off data survives compacting and
+ *               freeing the original buffer.  Repeat on the split-off buffer.
+ *               Finally, verify that ensuring reserved space on a split-off
+ *               buffer gives it room around its data, as needed to reuse it
+ *               to send a message.
+ */
+static void CheckSplitConsumed(nlTestSuite *inSuite, void *inContext)
+{
+    const uint16_t kDataLen = 30;
+    const uint16_t kSplitLen = 10;
+    PacketBuffer *buffer = PacketBuffer::New(0);
+    PacketBuffer *view;
+    PacketBuffer *subView;
+    uint8_t *start;
+
+    NL_TEST_ASSERT(inSuite, buffer != NULL);
+    if (buffer == NULL)
+        return;
+
+    start = buffer->Start();
+    for (uint16_t i = 0; i < kDataLen; i++)
+        start[i] = static_cast<uint8_t>(i);
+    buffer->SetDataLength(kDataLen);
+
+    buffer->ConsumeHead(kSplitLen);
+    view = buffer->SplitConsumed(kSplitLen + 1);
+
+    NL_TEST_ASSERT(inSuite, view != NULL);
+    if (view == NULL)
+    {
+        PacketBuffer::Free(buffer);
+        return;
+    }
+
+    NL_TEST_ASSERT(inSuite, view->DataLength() == kSplitLen);
+    NL_TEST_ASSERT(inSuite, view->TotalLength() == kSplitLen);
+    NL_TEST_ASSERT(inSuite, view->ReservedSize() == 0);
+    NL_TEST_ASSERT(inSuite, view->AvailableDataLength() == 0);
+    NL_TEST_ASSERT(inSuite, view->Start()[0] == 0 && view->Start()[kSplitLen - 1] == kSplitLen - 1);
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP
+    NL_TEST_ASSERT(inSuite, view->Start() == start);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    NL_TEST_ASSERT(inSuite, buffer->Start() == start + kSplitLen);
+    NL_TEST_ASSERT(inSuite, buffer->DataLength() == kDataLen - kSplitLen);
+    NL_TEST_ASSERT(inSuite, buffer->ReservedSize() == 0);
+    buffer->SetStart(start);
+    NL_TEST_ASSERT(inSuite, buffer->Start() == start + kSplitLen);
+    NL_TEST_ASSERT(inSuite, buffer->DataLength() == kDataLen - kSplitLen);
+
+    // Compacting the original buffer must not disturb the split-off data.
+    buffer->ConsumeHead(5);
+    buffer->CompactHead();
+    NL_TEST_ASSERT(inSuite, buffer->Start() == start + kSplitLen);
+    NL_TEST_ASSERT(inSuite, buffer->Start()[0] == kSplitLen + 5);
+
+    // The split-off data must outlive the original buffer.
+    PacketBuffer::Free(buffer);
+    for (uint16_t i = 0; i < kSplitLen; i++)
+        NL_TEST_ASSERT(inSuite, view->Start()[i] == i);
+
+    // Adjusting the start of a split-off buffer stays within its own octets.
+    view->SetStart(view->Start() - 1);
+    NL_TEST_ASSERT(inSuite, view->DataLength() == kSplitLen);
+    view->ConsumeHead(4);
+    NL_TEST_ASSERT(inSuite, view->ReservedSize() == 4);
+
+    subView = view->SplitConsumed(4);
+    NL_TEST_ASSERT(inSuite, subView != NULL);
+    if (subView != NULL)
+    {
+        NL_TEST_ASSERT(inSuite, subView->DataLength() == 4);
+        NL_TEST_ASSERT(inSuite, subView->Start()[0] == 0 && subView->Start()[3] == 3);
+    }
+
+    NL_TEST_ASSERT(inSuite, view->ReservedSize() == 0);
+    NL_TEST_ASSERT(inSuite, view->MaxDataLength() == kSplitLen - 4);
+    NL_TEST_ASSERT(inSuite, view->Start()[0] == 4);
+
+    NL_TEST_ASSERT(inSuite, view->EnsureReservedSize(WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE));
+    NL_TEST_ASSERT(inSuite, view->ReservedSize() == WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE);
+    NL_TEST_ASSERT(inSuite, view->DataLength() == kSplitLen - 4);
+    NL_TEST_ASSERT(inSuite, view->AvailableDataLength() > 0);
+    for (uint16_t i = 0; i < kSplitLen - 4; i++)
+        NL_TEST_ASSERT(inSuite, view->Start()[i] == i + 4);
+
+    // The buffer split off it is unaffected.
+    if (subView != NULL)
+        NL_TEST_ASSERT(inSuite, subView->Start()[0] == 0 && subView->Start()[3] == 3);
+
+    PacketBuffer::Free(view);
+    PacketBuffer::Free(subView);
+}
+
 /**
  *  Test PacketBuffer::BuildFreeList() function.
  */
@@ -1112,6 +1213,7 @@ static void CheckBuildFreeList(nlTestSuite *inSuite, void *inContext)
  *   Test Suite. It lists all the test functions.
  */
 static const nlTest sTests[] = {
+    NL_TEST_DEF("PacketBuffer::SplitConsumed",                  CheckSplitConsumed),
     NL_TEST_DEF("PacketBuffer::NewWithAvailableSize&PacketBuffer::Free", CheckNewWithAvailableSizeAndFree),
     NL_TEST_DEF("PacketBuffer::Start",                          CheckStart),
     NL_TEST_DEF("PacketBuffer::SetStart",                       CheckSetStart),
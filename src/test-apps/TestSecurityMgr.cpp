@@ -0,0 +1,734 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for session establishment
+ *      through <tt>nl::Weave::WeaveSecurityManager</tt>, running CASE and
+ *      PASE between two Weave stacks in the same process.  When the
+ *      security manager runs its crypto jobs on worker threads, the suite
+ *      also checks sessions that time out, lose their connection or are
+ *      shut down while a job is outstanding.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <nltest.h>
+
+#include "ToolCommon.h"
+#include "TestGroupKeyStore.h"
+#include <Weave/Core/WeaveCryptoWorkerPool.h>
+#include <Weave/Profiles/security/WeaveSecurity.h>
+#include <Weave/Profiles/security/WeaveCASE.h>
+#include <Weave/Support/ASN1.h>
+#include <Weave/Support/NestCerts.h>
+
+using namespace nl::Weave::Profiles::Security;
+using namespace nl::Weave::ASN1;
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+enum
+{
+    kTestTimeoutMs          = 10000,
+    kTestSessionTimeoutMs   = 1000,
+    kTestShortHoldMs        = 200,
+
+    kInitiatorNodeId        = 0x18B4300000000001ULL,
+    kResponderNodeId        = 0x18B4300000000002ULL,
+};
+
+static const char *const kTestPairingCode = "TESTPW";
+
+struct TestNode
+{
+    System::Layer           SystemLayer;
+    InetLayer               Inet;
+    WeaveFabricState        FabricState;
+    WeaveMessageLayer       MessageLayer;
+    WeaveExchangeManager    ExchangeMgr;
+    WeaveSecurityManager    SecurityMgr;
+    TestGroupKeyStore       GroupKeyStore;
+};
+
+struct SessionResult
+{
+    bool                    Done;
+    WEAVE_ERROR             Error;
+};
+
+static TestNode sInitiator;
+static TestNode sResponder;
+static IPAddress sResponderAddr;
+static WeaveConnection *sInitiatorCon;
+static WeaveConnection *sResponderCon;
+static bool sConnectDone;
+static WEAVE_ERROR sConnectError;
+static bool sInitiatorConClosed;
+static SessionResult sResult;
+static uint32_t sNumResponderSessions;
+
+// Lets a test keep the initiator's BeginSessionResponse job running on its worker.
+static volatile bool sHoldCertValidation;
+static volatile bool sCertValidationHeld;
+static uint32_t sHoldMs;
+static pthread_t sCertValidationThread;
+
+extern WEAVE_ERROR MakeCertInfo(uint8_t *buf, uint16_t bufSize, uint16_t& certInfoLen,
+                                const uint8_t *entityCert, uint16_t entityCertLen,
+                                const uint8_t *intermediateCert, uint16_t intermediateCertLen);
+
+static WEAVE_ERROR LoadTestCertSet(WeaveCertificateSet& certSet, ValidationContext& validContext, uint8_t requiredKeyPurposes,
+                                   bool loadDeviceCA)
+{
+    WEAVE_ERROR err;
+    ASN1UniversalTime validTime;
+    WeaveCertificateData *cert;
+
+    certSet.Init(10, 1024);
+
+    err = certSet.LoadCert(nl::NestCerts::Development::Root::Cert, nl::NestCerts::Development::Root::CertLength, 0, cert);
+    SuccessOrExit(err);
+    cert->CertFlags |= kCertFlag_IsTrusted;
+
+    if (loadDeviceCA)
+    {
+        err = certSet.LoadCert(nl::NestCerts::Development::DeviceCA::Cert, nl::NestCerts::Development::DeviceCA::CertLength,
+                               kDecodeFlag_GenerateTBSHash, cert);
+        SuccessOrExit(err);
+    }
+
+    memset(&validContext, 0, sizeof(validContext));
+    validTime.Year = 2013;
+    validTime.Month = 11;
+    validTime.Day = 20;
+    validTime.Hour = validTime.Minute = validTime.Second = 0;
+    err = PackCertTime(validTime, validContext.EffectiveTime);
+    SuccessOrExit(err);
+
+    validContext.RequiredKeyUsages = kKeyUsageFlag_DigitalSignature;
+    validContext.RequiredKeyPurposes = requiredKeyPurposes;
+
+exit:
+    return err;
+}
+
+class InitiatorAuthDelegate : public WeaveCASEAuthDelegate
+{
+public:
+    virtual WEAVE_ERROR GetNodeCertInfo(bool isInitiator, uint8_t *buf, uint16_t bufSize, uint16_t& certInfoLen)
+    {
+        return MakeCertInfo(buf, bufSize, certInfoLen, TestDevice1_Cert, TestDevice1_CertLength, NULL, 0);
+    }
+
+    virtual WEAVE_ERROR GetNodePrivateKey(bool isInitiator, const uint8_t *& weavePrivKey, uint16_t& weavePrivKeyLen)
+    {
+        weavePrivKey = TestDevice1_PrivateKey;
+        weavePrivKeyLen = TestDevice1_PrivateKeyLength;
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR ReleaseNodePrivateKey(const uint8_t *weavePrivKey)
+    {
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR GetNodePayload(bool isInitiator, uint8_t *buf, uint16_t bufSize, uint16_t& payloadLen)
+    {
+        payloadLen = 0;
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR BeginCertValidation(bool isInitiator, WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        const uint64_t deadline = System::Layer::GetClock_MonotonicMS() + sHoldMs;
+
+        // Called while processing the responder's BeginSessionResponse.  Stay here until the test
+        // releases the job, or until the hold expires.
+        sCertValidationThread = pthread_self();
+        if (sHoldCertValidation)
+        {
+            sCertValidationHeld = true;
+            while (sHoldCertValidation && System::Layer::GetClock_MonotonicMS() < deadline)
+                usleep(1000);
+            sCertValidationHeld = false;
+        }
+
+        return LoadTestCertSet(certSet, validContext, kKeyPurposeFlag_ServerAuth, false);
+    }
+
+    virtual WEAVE_ERROR HandleCertValidationResult(bool isInitiator, WEAVE_ERROR& validRes, WeaveCertificateData *peerCert,
+            uint64_t peerNodeId, WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR EndCertValidation(WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        return WEAVE_NO_ERROR;
+    }
+};
+
+class ResponderAuthDelegate : public WeaveCASEAuthDelegate
+{
+public:
+    virtual WEAVE_ERROR GetNodeCertInfo(bool isInitiator, uint8_t *buf, uint16_t bufSize, uint16_t& certInfoLen)
+    {
+        return MakeCertInfo(buf, bufSize, certInfoLen,
+                TestDevice2_Cert, TestDevice2_CertLength,
+                nl::NestCerts::Development::DeviceCA::Cert, nl::NestCerts::Development::DeviceCA::CertLength);
+    }
+
+    virtual WEAVE_ERROR GetNodePrivateKey(bool isInitiator, const uint8_t *& weavePrivKey, uint16_t& weavePrivKeyLen)
+    {
+        weavePrivKey = TestDevice2_PrivateKey;
+        weavePrivKeyLen = TestDevice2_PrivateKeyLength;
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR ReleaseNodePrivateKey(const uint8_t *weavePrivKey)
+    {
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR GetNodePayload(bool isInitiator, uint8_t *buf, uint16_t bufSize, uint16_t& payloadLen)
+    {
+        payloadLen = 0;
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR BeginCertValidation(bool isInitiator, WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        return LoadTestCertSet(certSet, validContext, kKeyPurposeFlag_ClientAuth, true);
+    }
+
+    virtual WEAVE_ERROR HandleCertValidationResult(bool isInitiator, WEAVE_ERROR& validRes, WeaveCertificateData *peerCert,
+            uint64_t peerNodeId, WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        return WEAVE_NO_ERROR;
+    }
+
+    virtual WEAVE_ERROR EndCertValidation(WeaveCertificateSet& certSet, ValidationContext& validContext)
+    {
+        return WEAVE_NO_ERROR;
+    }
+};
+
+static InitiatorAuthDelegate sInitiatorAuthDelegate;
+static ResponderAuthDelegate sResponderAuthDelegate;
+
+static void HandleResponderConnectionReceived(WeaveMessageLayer *msgLayer, WeaveConnection *con)
+{
+    sResponderCon = con;
+}
+
+static void HandleResponderSessionEstablished(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState,
+        uint16_t sessionKeyId, uint64_t peerNodeId, uint8_t encType)
+{
+    sNumResponderSessions++;
+}
+
+static WEAVE_ERROR InitNode(TestNode &node, uint64_t nodeId, bool listen)
+{
+    WeaveMessageLayer::InitContext initContext;
+    WEAVE_ERROR err;
+
+    err = node.SystemLayer.Init(NULL);
+    SuccessOrExit(err);
+
+    err = node.Inet.Init(node.SystemLayer, NULL);
+    SuccessOrExit(err);
+
+    err = node.FabricState.Init(&node.GroupKeyStore);
+    SuccessOrExit(err);
+
+    node.FabricState.FabricId = kFabricIdDefaultForTest;
+    node.FabricState.LocalNodeId = nodeId;
+    node.FabricState.PairingCode = kTestPairingCode;
+
+    // Listen on the loopback address only, so as not to take connections meant for other tests.
+#if WEAVE_CONFIG_ENABLE_TARGETED_LISTEN
+    node.FabricState.ListenIPv6Addr = sResponderAddr;
+#endif
+
+    initContext.systemLayer = &node.SystemLayer;
+    initContext.inet = &node.Inet;
+    initContext.fabricState = &node.FabricState;
+    initContext.listenTCP = listen;
+    initContext.listenUDP = false;
+
+    err = node.MessageLayer.Init(&initContext);
+    SuccessOrExit(err);
+
+    err = node.ExchangeMgr.Init(&node.MessageLayer);
+    SuccessOrExit(err);
+
+    err = node.SecurityMgr.Init(node.ExchangeMgr, node.SystemLayer);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+static void ShutdownNode(TestNode &node)
+{
+    node.SecurityMgr.Shutdown();
+    node.ExchangeMgr.Shutdown();
+    node.MessageLayer.Shutdown();
+    node.FabricState.Shutdown();
+    node.Inet.Shutdown();
+    node.SystemLayer.Shutdown();
+}
+
+/**
+ *  Service the network and timer events of one node, as ServiceEvents() does for the stack of a tool.
+ */
+static void ServiceNode(TestNode &node, struct timeval sleepTime)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    struct epoll_event events[16];
+    int timeoutMS = sleepTime.tv_sec * 1000 + sleepTime.tv_usec / 1000;
+
+    node.SystemLayer.PrepareEPoll(timeoutMS);
+    node.Inet.PrepareEPoll(timeoutMS);
+
+    int numEvents = epoll_wait(node.SystemLayer.GetEPollFD(), events, sizeof(events) / sizeof(events[0]), timeoutMS);
+    if (numEvents < 0)
+        return;
+
+    node.SystemLayer.HandleEPollResult(numEvents, events);
+    node.Inet.HandleEPollResult();
+#else
+    fd_set readFDs, writeFDs, exceptFDs;
+    int numFDs = 0;
+
+    FD_ZERO(&readFDs);
+    FD_ZERO(&writeFDs);
+    FD_ZERO(&exceptFDs);
+
+    node.SystemLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+    node.Inet.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+
+    int selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &sleepTime);
+    if (selectRes < 0)
+        return;
+
+    node.SystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+    node.Inet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+}
+
+static bool ServiceNodesUntil(bool (*condition)(void), uint32_t timeoutMs)
+{
+    const uint64_t deadline = System::Layer::GetClock_MonotonicMS() + timeoutMs;
+
+    while (!condition() && System::Layer::GetClock_MonotonicMS() < deadline)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 5000;
+
+        ServiceNode(sInitiator, sleepTime);
+        ServiceNode(sResponder, sleepTime);
+    }
+
+    return condition();
+}
+
+static bool Never(void)
+{
+    return false;
+}
+
+static bool IsConnectDone(void)
+{
+    return sConnectDone;
+}
+
+static bool IsResponderConReceived(void)
+{
+    return sResponderCon != NULL;
+}
+
+static bool IsInitiatorConClosed(void)
+{
+    return sInitiatorConClosed;
+}
+
+static bool IsSessionDone(void)
+{
+    return sResult.Done;
+}
+
+static bool IsCertValidationHeld(void)
+{
+    return sCertValidationHeld;
+}
+
+static bool AreSecurityMgrsIdle(void)
+{
+    return sInitiator.SecurityMgr.State == WeaveSecurityManager::kState_Idle &&
+           sResponder.SecurityMgr.State == WeaveSecurityManager::kState_Idle;
+}
+
+static void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    sConnectDone = true;
+    sConnectError = conErr;
+}
+
+static void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    sInitiatorConClosed = true;
+}
+
+static void HandleSessionEstablished(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState,
+        uint16_t sessionKeyId, uint64_t peerNodeId, uint8_t encType)
+{
+    SessionResult *result = static_cast<SessionResult *>(reqState);
+
+    result->Done = true;
+    result->Error = WEAVE_NO_ERROR;
+}
+
+static void HandleSessionError(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState,
+        WEAVE_ERROR localErr, uint64_t peerNodeId, StatusReport *statusReport)
+{
+    SessionResult *result = static_cast<SessionResult *>(reqState);
+
+    result->Done = true;
+    result->Error = localErr;
+}
+
+/**
+ *  Open an unauthenticated connection from the initiator to the responder.
+ */
+static void Connect(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err;
+
+    sConnectDone = false;
+    sConnectError = WEAVE_NO_ERROR;
+    sInitiatorConClosed = false;
+    sResponderCon = NULL;
+    sResult.Done = false;
+    sResult.Error = WEAVE_NO_ERROR;
+    sNumResponderSessions = 0;
+
+    sInitiatorCon = sInitiator.MessageLayer.NewConnection();
+    NL_TEST_ASSERT(inSuite, sInitiatorCon != NULL);
+
+    sInitiatorCon->OnConnectionComplete = HandleConnectionComplete;
+    sInitiatorCon->OnConnectionClosed = HandleConnectionClosed;
+
+    err = sInitiatorCon->Connect(kResponderNodeId, kWeaveAuthMode_Unauthenticated, sResponderAddr, 0, INET_NULL_INTERFACEID);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    ServiceNodesUntil(IsConnectDone, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sConnectDone && sConnectError == WEAVE_NO_ERROR);
+
+    // Wait for the responder to accept the connection.
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(IsResponderConReceived, kTestTimeoutMs));
+}
+
+/**
+ *  Close both ends of the connection, and wait for any interaction still in progress to end.
+ */
+static void Disconnect(nlTestSuite *inSuite)
+{
+    if (sInitiatorCon != NULL)
+    {
+        sInitiatorCon->Close();
+        sInitiatorCon = NULL;
+    }
+
+    if (sResponderCon != NULL)
+    {
+        sResponderCon->Close();
+        sResponderCon = NULL;
+    }
+
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(AreSecurityMgrsIdle, kTestTimeoutMs));
+}
+
+static WEAVE_ERROR StartCASESession(void)
+{
+    return sInitiator.SecurityMgr.StartCASESession(sInitiatorCon, kResponderNodeId, sResponderAddr, WEAVE_PORT,
+                                                   kWeaveAuthMode_CASE_AnyCert, &sResult, HandleSessionEstablished,
+                                                   HandleSessionError, &sInitiatorAuthDelegate);
+}
+
+static void HoldCertValidation(uint32_t holdMs)
+{
+    sHoldMs = holdMs;
+    sHoldCertValidation = true;
+}
+
+static void ReleaseCertValidation(void)
+{
+    sHoldCertValidation = false;
+}
+
+/**
+ *  Check that a CASE session is established, with the public-key operations running on
+ *  crypto workers when the security manager has them.
+ */
+static void CheckCASESession(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Connect(inSuite);
+
+    err = StartCASESession();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    ServiceNodesUntil(IsSessionDone, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sResult.Done);
+    NL_TEST_ASSERT(inSuite, sResult.Error == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sNumResponderSessions == 1);
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    NL_TEST_ASSERT(inSuite, !pthread_equal(sCertValidationThread, pthread_self()));
+#endif
+
+    Disconnect(inSuite);
+}
+
+#if WEAVE_CONFIG_ENABLE_PASE_INITIATOR && WEAVE_CONFIG_ENABLE_PASE_RESPONDER
+
+/**
+ *  Check that a PASE session is established using the fabric state's pairing code.
+ */
+static void CheckPASESession(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Connect(inSuite);
+
+    err = sInitiator.SecurityMgr.StartPASESession(sInitiatorCon, kWeaveAuthMode_PASE_PairingCode, &sResult,
+                                                  HandleSessionEstablished, HandleSessionError, NULL, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    ServiceNodesUntil(IsSessionDone, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sResult.Done);
+    NL_TEST_ASSERT(inSuite, sResult.Error == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sNumResponderSessions == 1);
+
+    Disconnect(inSuite);
+}
+
+#endif // WEAVE_CONFIG_ENABLE_PASE_INITIATOR && WEAVE_CONFIG_ENABLE_PASE_RESPONDER
+
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+
+/**
+ *  Check that a session timeout that fires while a crypto job is outstanding is reported
+ *  once the job completes.
+ */
+static void CheckCASETimeoutWhileJobPending(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Connect(inSuite);
+
+    sInitiator.SecurityMgr.SessionEstablishTimeout = kTestSessionTimeoutMs;
+    HoldCertValidation(kTestTimeoutMs);
+
+    err = StartCASESession();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(IsCertValidationHeld, kTestTimeoutMs));
+
+    // Let the session timer fire while the job is held.
+    ServiceNodesUntil(Never, 2 * kTestSessionTimeoutMs);
+    NL_TEST_ASSERT(inSuite, !sResult.Done);
+
+    ReleaseCertValidation();
+
+    ServiceNodesUntil(IsSessionDone, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sResult.Done);
+    NL_TEST_ASSERT(inSuite, sResult.Error == WEAVE_ERROR_TIMEOUT);
+    NL_TEST_ASSERT(inSuite, sNumResponderSessions == 0);
+
+    sInitiator.SecurityMgr.SessionEstablishTimeout = WEAVE_CONFIG_DEFAULT_SECURITY_SESSION_ESTABLISHMENT_TIMEOUT;
+
+    Disconnect(inSuite);
+}
+
+/**
+ *  Check that the loss of the connection while a crypto job is outstanding is reported
+ *  once the job completes.
+ */
+static void CheckCASEConnectionClosedWhileJobPending(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Connect(inSuite);
+
+    HoldCertValidation(kTestTimeoutMs);
+
+    err = StartCASESession();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(IsCertValidationHeld, kTestTimeoutMs));
+
+    // Close the connection from the responder's end.
+    sResponderCon->Close();
+    sResponderCon = NULL;
+
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(IsInitiatorConClosed, kTestTimeoutMs));
+    NL_TEST_ASSERT(inSuite, !sResult.Done);
+
+    ReleaseCertValidation();
+
+    ServiceNodesUntil(IsSessionDone, kTestTimeoutMs);
+    NL_TEST_ASSERT(inSuite, sResult.Done);
+    NL_TEST_ASSERT(inSuite, sResult.Error == WEAVE_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY);
+
+    Disconnect(inSuite);
+}
+
+/**
+ *  Check that shutting the security manager down while a crypto job is outstanding abandons
+ *  the session without calling back, and that the security manager can be reinitialized.
+ */
+static void CheckCASEShutdownWhileJobPending(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Connect(inSuite);
+
+    // Shutdown() waits for the job, so the hold must end by itself.
+    HoldCertValidation(kTestShortHoldMs);
+
+    err = StartCASESession();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, ServiceNodesUntil(IsCertValidationHeld, kTestTimeoutMs));
+
+    sInitiator.SecurityMgr.Shutdown();
+    NL_TEST_ASSERT(inSuite, !sCertValidationHeld);
+
+    ReleaseCertValidation();
+
+    // Give the completion posted by the worker a chance to be (wrongly) delivered.
+    ServiceNodesUntil(Never, 100);
+    NL_TEST_ASSERT(inSuite, !sResult.Done);
+
+    err = sInitiator.SecurityMgr.Init(sInitiator.ExchangeMgr, sInitiator.SystemLayer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    Disconnect(inSuite);
+
+    // The reinitialized security manager establishes sessions as before.
+    CheckCASESession(inSuite, inContext);
+}
+
+#endif // WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    WEAVE_ERROR err;
+
+    err = nl::Weave::Platform::Security::InitSecureRandomDataSource(NULL, 64, NULL, 0);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    IPAddress::FromString("::1", sResponderAddr);
+
+    err = InitNode(sInitiator, kInitiatorNodeId, false);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    err = InitNode(sResponder, kResponderNodeId, true);
+    if (err != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    sResponder.MessageLayer.OnConnectionReceived = HandleResponderConnectionReceived;
+    sResponder.SecurityMgr.OnSessionEstablished = HandleResponderSessionEstablished;
+    sResponder.SecurityMgr.SetCASEAuthDelegate(&sResponderAuthDelegate);
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    ShutdownNode(sInitiator);
+    ShutdownNode(sResponder);
+
+    return SUCCESS;
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] =
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    NL_TEST_DEF("SecurityMgr::CASESession",                     CheckCASESession),
+#if WEAVE_CONFIG_ENABLE_PASE_INITIATOR && WEAVE_CONFIG_ENABLE_PASE_RESPONDER
+    NL_TEST_DEF("SecurityMgr::PASESession",                     CheckPASESession),
+#endif
+#if WEAVE_CONFIG_SECURITY_MGR_CRYPTO_WORKERS > 0
+    NL_TEST_DEF("SecurityMgr::CASETimeoutWhileJobPending",      CheckCASETimeoutWhileJobPending),
+    NL_TEST_DEF("SecurityMgr::CASEConnectionClosedWhileJobPending", CheckCASEConnectionClosedWhileJobPending),
+    NL_TEST_DEF("SecurityMgr::CASEShutdownWhileJobPending",     CheckCASEShutdownWhileJobPending),
+#endif
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    nlTestSuite theSuite =
+    {
+        "weave-security-manager",
+        &sTests[0],
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+        TestSetup,
+        TestTeardown
+#else
+        NULL,
+        NULL
+#endif
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, &theSuite);
+
+    return nlTestRunnerStats(&theSuite);
+}
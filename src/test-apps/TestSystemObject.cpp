@@ -72,6 +72,9 @@ public:
     static void CheckConcurrency(nlTestSuite* inSuite, void* aContext);
     static void CheckHighWatermark(nlTestSuite* inSuite, void* aContext);
     static void CheckHighWatermarkConcurrency(nlTestSuite* inSuite, void* aContext);
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    static void CheckSlabPool(nlTestSuite* inSuite, void* aContext);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
 
 private:
     enum { kPoolSize = 122 }; // a multiple of kNumThreads, less than WEAVE_SYS_STATS_COUNT_MAX
@@ -445,6 +448,103 @@ void TestObject::CheckHighWatermark(nlTestSuite* inSuite, void* aContext)
     lLayer.Shutdown();
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
+// Test slab pool growth, recycling and iteration
+
+void TestObject::CheckSlabPool(nlTestSuite* inSuite, void* aContext)
+{
+    enum { kFirstSlabSize = 4, kNumObjects = 20, kCapacity = 4 + 8 + 16 };
+
+    static SlabObjectPool<TestObject, kFirstSlabSize> sSlabPool;
+    TestContext&    lContext = *static_cast<TestContext*>(aContext);
+    Layer           lLayer;
+    TestObject*     lObjects[kNumObjects];
+    TestObject*     lObject;
+    unsigned int    i;
+    unsigned int    lCount;
+
+    lLayer.Init(lContext.mLayerContext);
+
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.Size() == 0);
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.GetFirst(lLayer) == NULL);
+
+    // Take more objects than fit in the first slab and check that the pool grows.
+
+    for (i = 0; i < kNumObjects; ++i)
+    {
+        lObjects[i] = sSlabPool.TryCreate(lLayer);
+
+        NL_TEST_ASSERT(lContext.mTestSuite, lObjects[i] != NULL);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObjects[i]->IsRetained(lLayer));
+        NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.Get(lLayer, i) == lObjects[i]);
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.Size() == kCapacity);
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.Get(lLayer, kNumObjects) == NULL);
+
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    {
+        nl::Weave::System::Stats::count_t lNumInUse;
+        nl::Weave::System::Stats::count_t lHighWatermark;
+
+        sSlabPool.GetStatistics(lNumInUse, lHighWatermark);
+        NL_TEST_ASSERT(lContext.mTestSuite, lNumInUse == kNumObjects);
+        NL_TEST_ASSERT(lContext.mTestSuite, lHighWatermark == kNumObjects);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+    // Release every other object and check that iteration only visits the rest.
+
+    for (i = 1; i < kNumObjects; i += 2)
+    {
+        lObjects[i]->Release();
+        NL_TEST_ASSERT(lContext.mTestSuite, !lObjects[i]->IsRetained(lLayer));
+    }
+
+    lCount = 0;
+    for (lObject = sSlabPool.GetFirst(lLayer); lObject != NULL; lObject = sSlabPool.GetNext(lLayer, lObject))
+    {
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject == lObjects[lCount * 2]);
+        ++lCount;
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, lCount == kNumObjects / 2);
+
+    // Take the released objects again and check that they are recycled without growing the pool.
+
+    for (i = 1; i < kNumObjects; i += 2)
+    {
+        unsigned int j;
+
+        lObject = sSlabPool.TryCreate(lLayer);
+        NL_TEST_ASSERT(lContext.mTestSuite, lObject != NULL);
+
+        for (j = 1; j < kNumObjects && lObjects[j] != lObject; j += 2)
+            continue;
+
+        NL_TEST_ASSERT(lContext.mTestSuite, j < kNumObjects);
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.Size() == kCapacity);
+
+    // Cleanup
+
+    lCount = 0;
+    for (lObject = sSlabPool.GetFirst(lLayer); lObject != NULL; lObject = sSlabPool.GetNext(lLayer, lObject))
+    {
+        lObject->Release();
+        NL_TEST_ASSERT(lContext.mTestSuite, !lObject->IsRetained(lLayer));
+        ++lCount;
+    }
+
+    NL_TEST_ASSERT(lContext.mTestSuite, lCount == kNumObjects);
+    NL_TEST_ASSERT(lContext.mTestSuite, sSlabPool.GetFirst(lLayer) == NULL);
+
+    lLayer.Shutdown();
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
 
 // Test Suite
 
@@ -457,6 +557,9 @@ const nlTest sTests[] = {
     NL_TEST_DEF("Concurrency", TestObject::CheckConcurrency),
     NL_TEST_DEF("HighWatermark", TestObject::CheckHighWatermark),
     NL_TEST_DEF("HighWatermarkConcurrency", TestObject::CheckHighWatermarkConcurrency),
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    NL_TEST_DEF("SlabPool", TestObject::CheckSlabPool),
+#endif // WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
     NL_TEST_SENTINEL()
 };
 
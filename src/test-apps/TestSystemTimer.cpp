@@ -29,6 +29,8 @@
 #endif
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -54,6 +56,9 @@
 using nl::ErrorStr;
 using namespace nl::Weave::System;
 
+// Time, in microseconds, spent blocked waiting for events; used to separate timer processing from idle time when benchmarking.
+static uint64_t sWaitTime;
+
 static void ServiceEvents(Layer& aLayer, ::timeval& aSleepTime)
 {
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
@@ -67,7 +72,9 @@ static void ServiceEvents(Layer& aLayer, ::timeval& aSleepTime)
     if (aLayer.State() == kLayerState_Initialized)
         aLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, aSleepTime);
 
+    const uint64_t waitStart = Layer::GetClock_MonotonicHiRes();
     int selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &aSleepTime);
+    sWaitTime += Layer::GetClock_MonotonicHiRes() - waitStart;
     if (selectRes < 0)
     {
         printf("select failed: %s\n", ErrorStr(MapErrorPOSIX(errno)));
@@ -105,6 +112,14 @@ struct TestContext {
 
 static struct TestContext sContext;
 
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+// The timer pool grows on demand, up to WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS slabs, each twice the size of the last.
+static const unsigned long kTimerPoolCapacity =
+    WEAVE_SYSTEM_CONFIG_NUM_TIMERS * ((1UL << WEAVE_SYSTEM_CONFIG_SLAB_OBJECT_POOL_MAX_SLABS) - 1);
+#else // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+static const unsigned long kTimerPoolCapacity = WEAVE_SYSTEM_CONFIG_NUM_TIMERS;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
 static volatile bool sOverflowTestDone;
 
 void HandleTimer0Failed(Layer* inetLayer, void* aState, Error aError)
@@ -157,6 +172,320 @@ static void CheckOverflow(nlTestSuite* inSuite, void* aContext)
 }
 
 
+// Timers that record when and in what order they fire.
+
+struct TimerProbe
+{
+    unsigned int mId;
+    uint32_t mDelay;
+    uint64_t mStartTime;
+    uint64_t mFireTime;
+    unsigned int mNumFired;
+    unsigned int mNumRearms;        // Times left for the completion handler to start the timer again.
+    TimerProbe* mVictim;            // Timer cancelled by the completion handler, if any.
+};
+
+static const unsigned int kMaxProbes = 8;
+
+static TimerProbe sProbes[kMaxProbes];
+static unsigned int sFiredOrder[kMaxProbes * 4];
+static unsigned int sNumFired;
+
+static void HandleProbeTimer(Layer* aLayer, void* aState, Error aError);
+
+static void ResetProbes(void)
+{
+    memset(sProbes, 0, sizeof(sProbes));
+    for (unsigned int i = 0; i < kMaxProbes; i++)
+        sProbes[i].mId = i;
+    sNumFired = 0;
+}
+
+static void StartProbe(Layer& aLayer, unsigned int aId, uint32_t aDelay)
+{
+    TimerProbe& lProbe = sProbes[aId];
+
+    lProbe.mDelay = aDelay;
+    lProbe.mStartTime = Layer::GetClock_MonotonicMS();
+    aLayer.StartTimer(aDelay, HandleProbeTimer, &lProbe);
+}
+
+static void HandleProbeTimer(Layer* aLayer, void* aState, Error aError)
+{
+    TimerProbe& lProbe = *static_cast<TimerProbe*>(aState);
+
+    lProbe.mFireTime = Layer::GetClock_MonotonicMS();
+    lProbe.mNumFired++;
+
+    if (sNumFired < sizeof(sFiredOrder) / sizeof(sFiredOrder[0]))
+        sFiredOrder[sNumFired] = lProbe.mId;
+    sNumFired++;
+
+    if (lProbe.mVictim != NULL)
+        aLayer->CancelTimer(HandleProbeTimer, lProbe.mVictim);
+
+    if (lProbe.mNumRearms > 0)
+    {
+        lProbe.mNumRearms--;
+        StartProbe(*aLayer, lProbe.mId, lProbe.mDelay);
+    }
+}
+
+/**
+ *  Service events until \c aNumFired probe timers have fired or \c aTimeout milliseconds have passed.
+ */
+static void ServiceProbes(Layer& aLayer, unsigned int aNumFired, uint32_t aTimeout)
+{
+    const uint64_t kDeadline = Layer::GetClock_MonotonicMS() + aTimeout;
+
+    while (sNumFired < aNumFired && Layer::GetClock_MonotonicMS() < kDeadline)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(aLayer, sleepTime);
+    }
+}
+
+static bool FiredOnTime(const TimerProbe& aProbe)
+{
+    return aProbe.mNumFired > 0 && aProbe.mFireTime >= aProbe.mStartTime + aProbe.mDelay;
+}
+
+/**
+ *  Timers with distinct delays fire in order of expiry, and none early.
+ */
+static void CheckOrdering(nlTestSuite* inSuite, void* aContext)
+{
+    static const uint32_t kDelays[] = { 80, 16, 48, 32, 64 };
+    static const unsigned int kExpectedOrder[] = { 1, 3, 2, 4, 0 };
+    const unsigned int kNumTimers = sizeof(kDelays) / sizeof(kDelays[0]);
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    for (unsigned int i = 0; i < kNumTimers; i++)
+        StartProbe(lSys, i, kDelays[i]);
+
+    ServiceProbes(lSys, kNumTimers, 1000);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == kNumTimers);
+    for (unsigned int i = 0; i < kNumTimers && i < sNumFired; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sFiredOrder[i] == kExpectedOrder[i]);
+        NL_TEST_ASSERT(inSuite, FiredOnTime(sProbes[i]));
+    }
+}
+
+/**
+ *  Timers expiring together, in the same tick of a timing wheel, each fire once and none early.
+ */
+static void CheckSameTick(nlTestSuite* inSuite, void* aContext)
+{
+    const unsigned int kNumTimers = kMaxProbes;
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    for (unsigned int i = 0; i < kNumTimers; i++)
+        StartProbe(lSys, i, 20 + (i % 2));
+
+    ServiceProbes(lSys, kNumTimers, 1000);
+
+    // Give any timer that would fire twice the chance to.
+    ServiceProbes(lSys, kNumTimers + 1, 50);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == kNumTimers);
+    for (unsigned int i = 0; i < kNumTimers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sProbes[i].mNumFired == 1);
+        NL_TEST_ASSERT(inSuite, FiredOnTime(sProbes[i]));
+    }
+}
+
+/**
+ *  A cancelled timer does not fire, including when it is cancelled by the completion handler of a timer expiring at the same
+ *  time.
+ */
+static void CheckCancel(nlTestSuite* inSuite, void* aContext)
+{
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    // Timer 0 is cancelled before it expires; timer 1 is left to fire.
+    StartProbe(lSys, 0, 20);
+    StartProbe(lSys, 1, 40);
+    lSys.CancelTimer(HandleProbeTimer, &sProbes[0]);
+
+    // Timers 2 and 3 expire together and each cancels the other, so exactly one of them fires.
+    sProbes[2].mVictim = &sProbes[3];
+    sProbes[3].mVictim = &sProbes[2];
+    StartProbe(lSys, 2, 30);
+    StartProbe(lSys, 3, 30);
+
+    ServiceProbes(lSys, 2, 1000);
+    ServiceProbes(lSys, 3, 100);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == 2);
+    NL_TEST_ASSERT(inSuite, sProbes[0].mNumFired == 0);
+    NL_TEST_ASSERT(inSuite, sProbes[1].mNumFired == 1 && FiredOnTime(sProbes[1]));
+    NL_TEST_ASSERT(inSuite, sProbes[2].mNumFired + sProbes[3].mNumFired == 1);
+}
+
+/**
+ *  Work scheduled with ScheduleWork() runs in the order in which it was scheduled, and CancelTimer() cancels it until it runs,
+ *  including from the handler of work scheduled before it.
+ */
+static void CheckCancelScheduledWork(nlTestSuite* inSuite, void* aContext)
+{
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    // Work 1 is cancelled before it runs, and work 0 cancels work 3 when it runs.
+    sProbes[0].mVictim = &sProbes[3];
+    for (unsigned int i = 0; i < 4; i++)
+        lSys.ScheduleWork(HandleProbeTimer, &sProbes[i]);
+    lSys.CancelTimer(HandleProbeTimer, &sProbes[1]);
+
+    ServiceProbes(lSys, 2, 1000);
+    ServiceProbes(lSys, 3, 100);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == 2);
+    NL_TEST_ASSERT(inSuite, sFiredOrder[0] == 0 && sFiredOrder[1] == 2);
+    NL_TEST_ASSERT(inSuite, sProbes[1].mNumFired == 0 && sProbes[3].mNumFired == 0);
+}
+
+/**
+ *  Starting a timer that is already armed replaces its expiry, whether sooner or later, and a completion handler may start its
+ *  own timer again.
+ */
+static void CheckRearm(nlTestSuite* inSuite, void* aContext)
+{
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    // Timer 0 is brought forward, timer 1 pushed back.
+    StartProbe(lSys, 0, 200);
+    StartProbe(lSys, 1, 20);
+    StartProbe(lSys, 0, 20);
+    StartProbe(lSys, 1, 60);
+
+    // Timer 2 starts itself again from its completion handler, twice.
+    sProbes[2].mNumRearms = 2;
+    StartProbe(lSys, 2, 16);
+
+    ServiceProbes(lSys, 5, 1000);
+
+    // Give timer 0 the chance to fire at its original expiry.
+    ServiceProbes(lSys, 6, 250);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == 5);
+    NL_TEST_ASSERT(inSuite, sProbes[0].mNumFired == 1 && FiredOnTime(sProbes[0]));
+    NL_TEST_ASSERT(inSuite, sProbes[0].mFireTime < sProbes[0].mStartTime + 200);
+    NL_TEST_ASSERT(inSuite, sProbes[1].mNumFired == 1 && FiredOnTime(sProbes[1]));
+    NL_TEST_ASSERT(inSuite, sProbes[2].mNumFired == 3 && FiredOnTime(sProbes[2]));
+}
+
+/**
+ *  A timer longer than one revolution of the timing wheel does not fire when the wheel first passes its slot, but on expiry.
+ */
+static void CheckLongTimeout(nlTestSuite* inSuite, void* aContext)
+{
+    const uint32_t kRevolution = WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_SIZE * WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS;
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+
+    ResetProbes();
+
+    // Timer 0 lands in the slot a few ticks ahead, one revolution early; timer 1 fires after the wheel has passed that slot.
+    StartProbe(lSys, 0, kRevolution + 2 * WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS);
+    StartProbe(lSys, 1, 6 * WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_RESOLUTION_MS);
+
+    ServiceProbes(lSys, 1, 1000);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == 1 && sProbes[1].mNumFired == 1);
+    NL_TEST_ASSERT(inSuite, sProbes[0].mNumFired == 0);
+
+    ServiceProbes(lSys, 2, kRevolution + 1000);
+
+    NL_TEST_ASSERT(inSuite, sNumFired == 2);
+    NL_TEST_ASSERT(inSuite, sProbes[0].mNumFired == 1 && FiredOnTime(sProbes[0]));
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+// Enough timers for the timer index to double several times, if the pool holds them.
+static const unsigned long kNumManyTimers = 4UL * WEAVE_SYSTEM_CONFIG_TIMER_INDEX_SIZE;
+#else // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+static const unsigned long kNumManyTimers = 4096;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+static void HandleManyTimer(Layer* aLayer, void* aState, Error aError)
+{
+    (*static_cast<uint8_t*>(aState))++;
+}
+
+/**
+ *  Timers stay individually restartable and cancellable while many are armed, including across growth of the timer index.
+ */
+static void CheckManyTimers(nlTestSuite* inSuite, void* aContext)
+{
+    const unsigned int lCount = static_cast<unsigned int>((kNumManyTimers < kTimerPoolCapacity) ? kNumManyTimers : kTimerPoolCapacity);
+    Layer& lSys = *static_cast<TestContext*>(aContext)->mLayer;
+    // The number of times each timer fired; its bytes also serve as the distinct application states of the timers.
+    uint8_t* lNumFired = static_cast<uint8_t*>(calloc(lCount, 1));
+    unsigned int lNumArmed;
+    unsigned int lTotalFired;
+    unsigned int lNumWrong;
+    const uint64_t lDeadline = Layer::GetClock_MonotonicMS() + 2000;
+
+    NL_TEST_ASSERT(inSuite, lNumFired != NULL);
+    if (lNumFired == NULL)
+        return;
+
+    for (lNumArmed = 0; lNumArmed < lCount; lNumArmed++)
+    {
+        if (lSys.StartTimer(60000, HandleManyTimer, &lNumFired[lNumArmed]) != WEAVE_SYSTEM_NO_ERROR)
+            break;
+    }
+
+    NL_TEST_ASSERT(inSuite, lNumArmed == lCount);
+
+    // Odd timers are cancelled; even ones are brought forward so that they fire.
+    for (unsigned int i = 0; i < lNumArmed; i++)
+    {
+        if (i % 2 != 0)
+            lSys.CancelTimer(HandleManyTimer, &lNumFired[i]);
+        else
+            lSys.StartTimer(10, HandleManyTimer, &lNumFired[i]);
+    }
+
+    do
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceEvents(lSys, sleepTime);
+
+        lTotalFired = 0;
+        for (unsigned int i = 0; i < lNumArmed; i++)
+            lTotalFired += lNumFired[i];
+    } while (lTotalFired < (lNumArmed + 1) / 2 && Layer::GetClock_MonotonicMS() < lDeadline);
+
+    lNumWrong = 0;
+    for (unsigned int i = 0; i < lNumArmed; i++)
+    {
+        if (lNumFired[i] != ((i % 2 == 0) ? 1 : 0))
+            lNumWrong++;
+    }
+
+    NL_TEST_ASSERT(inSuite, lNumWrong == 0);
+
+    free(lNumFired);
+}
+
+
 // Test Suite
 
 
@@ -165,6 +494,13 @@ static void CheckOverflow(nlTestSuite* inSuite, void* aContext)
  */
 static const nlTest sTests[] = {
     NL_TEST_DEF("Timer::TestOverflow",             CheckOverflow),
+    NL_TEST_DEF("Timer::TestOrdering",             CheckOrdering),
+    NL_TEST_DEF("Timer::TestSameTick",             CheckSameTick),
+    NL_TEST_DEF("Timer::TestCancel",               CheckCancel),
+    NL_TEST_DEF("Timer::TestCancelScheduledWork",  CheckCancelScheduledWork),
+    NL_TEST_DEF("Timer::TestRearm",                CheckRearm),
+    NL_TEST_DEF("Timer::TestLongTimeout",          CheckLongTimeout),
+    NL_TEST_DEF("Timer::TestManyTimers",           CheckManyTimers),
     NL_TEST_SENTINEL()
 };
 
@@ -221,8 +557,245 @@ static int TestTeardown(void* aContext)
     return (SUCCESS);
 }
 
+// Benchmark
+
+static unsigned int sNumBenchmarkTimersFired;
+
+static void HandleBenchmarkTimer(Layer* aLayer, void* aState, Error aError)
+{
+    sNumBenchmarkTimersFired++;
+}
+
+static void PrintRate(const char* aPhase, unsigned int aCount, uint64_t aMicroseconds)
+{
+    printf("  %-8s %8u timers in %8.3f ms: %10.0f timers/s\n", aPhase, aCount, aMicroseconds / 1000.0,
+           (aMicroseconds != 0) ? (aCount * 1000000.0) / aMicroseconds : 0.0);
+}
+
+// Number of operations measured in each phase of a benchmark, spread over as many rounds as the number of armed timers requires.
+static const unsigned int kBenchmarkOperations = 100000;
+
+// Largest factor by which the cost of starting, restarting or cancelling a timer may grow between the fewest and the most armed
+// timers benchmarked. Those operations take constant time, so only cache effects should make them slower with more timers.
+static const double kMaxCostGrowth = 8.0;
+
+// Cost, in nanoseconds per timer, of the phases of a benchmark that should not depend on the number of armed timers.
+struct BenchmarkCost
+{
+    unsigned int mCount;
+    double mStart;
+    double mRestart;
+    double mCancel;
+};
+
+static double CostPerTimer(unsigned int aCount, uint64_t aMicroseconds)
+{
+    return (aCount != 0) ? (aMicroseconds * 1000.0) / aCount : 0.0;
+}
+
+static bool CheckCostGrowth(const char* aPhase, const BenchmarkCost& aFewest, double aFewestCost, const BenchmarkCost& aMost,
+                            double aMostCost)
+{
+    const double growth = (aFewestCost > 0.0) ? aMostCost / aFewestCost : 0.0;
+    const bool ok = (growth <= kMaxCostGrowth);
+
+    printf("  %-8s %8.1f ns/timer with %u armed, %8.1f ns/timer with %u armed: x%.2f %s\n", aPhase, aFewestCost, aFewest.mCount,
+           aMostCost, aMost.mCount, growth, ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+/**
+ *  Measure the throughput of starting, restarting, cancelling and expiring \c aCount simultaneously armed timers.
+ *
+ *  The number of timers is limited to the capacity of the timer pool, which only exceeds WEAVE_SYSTEM_CONFIG_NUM_TIMERS with
+ *  WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS. Each phase is repeated until about #kBenchmarkOperations timers have been
+ *  handled, so that small pools still give a measurable time.
+ */
+static bool RunBenchmark(Layer& aLayer, unsigned int aCount, BenchmarkCost& aCost)
+{
+    // Each timer needs a distinct application state object; the bytes of this array serve as such.
+    uint8_t* states;
+    unsigned int numArmed = 0;
+    unsigned int numRounds;
+    unsigned int numExpireRounds;
+    uint32_t seed = 1;
+    uint64_t startTime = 0;
+    uint64_t restartTime = 0;
+    uint64_t cancelTime = 0;
+    uint64_t expireTime = 0;
+    uint64_t start;
+
+    if (aCount > kTimerPoolCapacity)
+    {
+        printf("%u timers requested, limited to the %lu of the timer pool\n", aCount, kTimerPoolCapacity);
+        aCount = static_cast<unsigned int>(kTimerPoolCapacity);
+    }
+
+    states = static_cast<uint8_t*>(malloc(aCount));
+    if (states == NULL)
+    {
+        printf("no memory for %u timers\n", aCount);
+        return false;
+    }
+
+    numRounds = (kBenchmarkOperations + aCount - 1) / aCount;
+
+    // Expiry takes real time; keep it to about one second.
+    numExpireRounds = (numRounds < 10) ? numRounds : 10;
+
+    printf("%u armed timers, %u rounds:\n", aCount, numRounds);
+
+    for (unsigned int round = 0; round < numRounds; round++)
+    {
+        // Start: arm timers with delays spread between one and two minutes so that none fire during the measurement.
+        start = Layer::GetClock_MonotonicHiRes();
+        for (numArmed = 0; numArmed < aCount; numArmed++)
+        {
+            seed = seed * 1103515245 + 12345;
+            if (aLayer.StartTimer(60000 + (seed >> 8) % 60000, HandleBenchmarkTimer, &states[numArmed]) != WEAVE_SYSTEM_NO_ERROR)
+                break;
+        }
+        startTime += Layer::GetClock_MonotonicHiRes() - start;
+
+        if (numArmed < aCount)
+        {
+            printf("  timer pool exhausted after %u timers\n", numArmed);
+            aCount = numArmed;
+        }
+
+        // Restart: re-arm every timer, as done when refreshing a liveness or retransmission timeout.
+        start = Layer::GetClock_MonotonicHiRes();
+        for (unsigned int i = 0; i < numArmed; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            aLayer.StartTimer(60000 + (seed >> 8) % 60000, HandleBenchmarkTimer, &states[i]);
+        }
+        restartTime += Layer::GetClock_MonotonicHiRes() - start;
+
+        // Cancel: disarm every timer.
+        start = Layer::GetClock_MonotonicHiRes();
+        for (unsigned int i = 0; i < numArmed; i++)
+        {
+            aLayer.CancelTimer(HandleBenchmarkTimer, &states[i]);
+        }
+        cancelTime += Layer::GetClock_MonotonicHiRes() - start;
+    }
+
+    PrintRate("start", numArmed * numRounds, startTime);
+    PrintRate("restart", numArmed * numRounds, restartTime);
+    PrintRate("cancel", numArmed * numRounds, cancelTime);
+
+    aCost.mCount = numArmed;
+    aCost.mStart = CostPerTimer(numArmed * numRounds, startTime);
+    aCost.mRestart = CostPerTimer(numArmed * numRounds, restartTime);
+    aCost.mCancel = CostPerTimer(numArmed * numRounds, cancelTime);
+
+    // Expire: arm the timers with delays spread over 100 ms and service events until all of them fire. Time spent blocked
+    // waiting for the next timer is excluded.
+    for (unsigned int round = 0; round < numExpireRounds; round++)
+    {
+        for (unsigned int i = 0; i < numArmed; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            aLayer.StartTimer((seed >> 8) % 100, HandleBenchmarkTimer, &states[i]);
+        }
+
+        sNumBenchmarkTimersFired = 0;
+        sWaitTime = 0;
+        start = Layer::GetClock_MonotonicHiRes();
+        while (sNumBenchmarkTimersFired < numArmed)
+        {
+            struct timeval sleepTime;
+            sleepTime.tv_sec = 0;
+            sleepTime.tv_usec = 1000; // 1 ms tick
+            ServiceEvents(aLayer, sleepTime);
+        }
+        expireTime += Layer::GetClock_MonotonicHiRes() - start - sWaitTime;
+    }
+
+    PrintRate("expire", numArmed * numExpireRounds, expireTime);
+
+    free(states);
+
+    return true;
+}
+
+static int RunBenchmarks(int argc, char *argv[])
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    // Server-scale numbers of timers, as the pool grows to hold them.
+    static const unsigned int kDefaultCounts[] = { 1000, 10000, 100000 };
+#else // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+    // A quarter, half and all of the timer pool.
+    static const unsigned int kDefaultCounts[] = {
+        (WEAVE_SYSTEM_CONFIG_NUM_TIMERS + 3) / 4, (WEAVE_SYSTEM_CONFIG_NUM_TIMERS + 1) / 2, WEAVE_SYSTEM_CONFIG_NUM_TIMERS
+    };
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SLAB_OBJECT_POOLS
+
+    BenchmarkCost cost;
+    BenchmarkCost fewest = { 0, 0.0, 0.0, 0.0 };
+    BenchmarkCost most = { 0, 0.0, 0.0, 0.0 };
+    bool ok = true;
+
+    TestSetup(&sContext);
+
+    for (int i = 0; i < ((argc == 0) ? static_cast<int>(sizeof(kDefaultCounts) / sizeof(kDefaultCounts[0])) : argc); i++)
+    {
+        unsigned long count = (argc == 0) ? kDefaultCounts[i] : 0;
+
+        if (argc != 0)
+        {
+            char* end;
+
+            count = strtoul(argv[i], &end, 0);
+            if (*argv[i] == '\0' || *end != '\0' || count == 0 || count > UINT32_MAX)
+            {
+                printf("invalid timer count: %s\n", argv[i]);
+                TestTeardown(&sContext);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (!RunBenchmark(*sContext.mLayer, static_cast<unsigned int>(count), cost))
+            continue;
+
+        if (fewest.mCount == 0 || cost.mCount < fewest.mCount)
+            fewest = cost;
+        if (cost.mCount > most.mCount)
+            most = cost;
+    }
+
+    TestTeardown(&sContext);
+
+    // Compare the cost per timer with the fewest and the most armed timers.
+    if (most.mCount > fewest.mCount)
+    {
+        printf("cost growth from %u to %u armed timers:\n", fewest.mCount, most.mCount);
+        ok = CheckCostGrowth("start", fewest, fewest.mStart, most, most.mStart) && ok;
+        ok = CheckCostGrowth("restart", fewest, fewest.mRestart, most, most.mRestart) && ok;
+        ok = CheckCostGrowth("cancel", fewest, fewest.mCancel, most, most.mCancel) && ok;
+    }
+
+#if !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+    // Without the timing wheel, timers are found by scanning the pool, so the cost is expected to grow.
+    ok = true;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_TIMER_WHEEL
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ *  Run the unit tests or, given "--benchmark [<count> ...]", measure timer throughput with each number of armed timers (a
+ *  quarter, half and all of WEAVE_SYSTEM_CONFIG_NUM_TIMERS by default, or 1000, 10000 and 100000 with slab object pools).
+ *  With the timing wheel, the benchmark fails if the cost of starting, restarting or cancelling a timer grows by more than
+ *  #kMaxCostGrowth between the fewest and the most armed timers.
+ */
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+        return RunBenchmarks(argc - 2, argv + 2);
+
     // Generate machine-readable, comma-separated value (CSV) output.
     nl_test_set_output_style(OUTPUT_CSV);
 
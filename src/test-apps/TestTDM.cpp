@@ -122,7 +122,14 @@ static void TestTdmStatic_SingleLevelMergeDeep(nlTestSuite *inSuite, void *inCon
 static void TestTdmStatic_DirtyStruct(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_DirtyLeafUnevenDepth(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_MergeHandleSetOverflow(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_DirtyStoreNoOverflow(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_MarkLeafHandleDirtyTwice(nlTestSuite *inSuite, void *inContext);
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+static void TestTdmStatic_CachedDataElement(nlTestSuite *inSuite, void *inContext);
+#endif
+#if WDM_PUBLISHER_ENABLE_VIEW
+static void TestTdmStatic_ChunkedView(nlTestSuite *inSuite, void *inContext);
+#endif
 
 static void TestTdmStatic_TestNullableLeaf(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_TestNullableStruct(nlTestSuite *inSuite, void *inContext);
@@ -179,7 +186,14 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test Tdm (Static schema): Dirty structure node containing leaf handles", TestTdmStatic_DirtyStruct),
     NL_TEST_DEF("Test Tdm (Static schema): Two dirty leaf handles at different depths", TestTdmStatic_DirtyLeafUnevenDepth),
     NL_TEST_DEF("Test Tdm (Static schema): Overflow of merge handles", TestTdmStatic_MergeHandleSetOverflow),
+    NL_TEST_DEF("Test Tdm (Static schema): More dirty handles than dirty store items", TestTdmStatic_DirtyStoreNoOverflow),
     NL_TEST_DEF("Test Tdm (Static schema): Mark same handle dirty twice", TestTdmStatic_MarkLeafHandleDirtyTwice),
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    NL_TEST_DEF("Test Tdm (Static schema): Data element encoded once per round", TestTdmStatic_CachedDataElement),
+#endif
+#if WDM_PUBLISHER_ENABLE_VIEW
+    NL_TEST_DEF("Test Tdm (Static schema): View response split into chunks", TestTdmStatic_ChunkedView),
+#endif
 
     NL_TEST_DEF("Test Tdm (Static schema): Nullable leaf data", TestTdmStatic_TestNullableLeaf),
     NL_TEST_DEF("Test Tdm (Static schema): Nullable struct", TestTdmStatic_TestNullableStruct),
@@ -697,7 +711,15 @@ public:
     void TestTdmStatic_DirtyStruct(nlTestSuite *inSuite);
     void TestTdmStatic_DirtyLeafUnevenDepth(nlTestSuite *inSuite);
     void TestTdmStatic_MergeHandleSetOverflow(nlTestSuite *inSuite);
+    void TestTdmStatic_DirtyStoreNoOverflow(nlTestSuite *inSuite);
     void TestTdmStatic_MarkLeafHandleDirtyTwice(nlTestSuite *inSuite);
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+    void TestTdmStatic_CachedDataElement(nlTestSuite *inSuite);
+#endif
+#if WDM_PUBLISHER_ENABLE_VIEW
+    void TestTdmStatic_ChunkedView(nlTestSuite *inSuite);
+    int BuildAndProcessView(ViewHandler & aHandler, const uint32_t aMaxPayloadSize, int & aNumChunks);
+#endif
 
     void TestTdmStatic_TestNullableLeaf(nlTestSuite *inSuite);
     void TestTdmStatic_TestNullableStruct(nlTestSuite *inSuite);
@@ -825,34 +847,25 @@ int TestTdm::Setup()
 
     mSinkCatalog.Add(3, &mTestBSink, testBSinkHandle);
 
-    traitInstance = mSubscriptionEngine.mTraitInfoPool;
-    mSubHandler->mTraitInstanceList = traitInstance;
-    mSubHandler->mNumTraitInstances++;
-    ++(SubscriptionEngine::GetInstance()->mNumTraitInfosInPool);
+    traitInstance = mSubscriptionEngine.AllocTraitInfo(mSubHandler);
 
     traitInstance->Init();
     traitInstance->mTraitDataHandle = testTdmSourceHandle;
     traitInstance->mRequestedVersion = 1;
 
-    traitInstance = mSubscriptionEngine.mTraitInfoPool + 1;
-    mSubHandler->mNumTraitInstances++;
-    ++(SubscriptionEngine::GetInstance()->mNumTraitInfosInPool);
+    traitInstance = mSubscriptionEngine.AllocTraitInfo(mSubHandler);
 
     traitInstance->Init();
     traitInstance->mTraitDataHandle = testTdmSourceHandle1;
     traitInstance->mRequestedVersion = 1;
 
-    traitInstance = mSubscriptionEngine.mTraitInfoPool + 2;
-    mSubHandler->mNumTraitInstances++;
-    ++(SubscriptionEngine::GetInstance()->mNumTraitInfosInPool);
+    traitInstance = mSubscriptionEngine.AllocTraitInfo(mSubHandler);
 
     traitInstance->Init();
     traitInstance->mTraitDataHandle = testMismatchedCSourceHandle;
     traitInstance->mRequestedVersion = 1;
 
-    traitInstance = mSubscriptionEngine.mTraitInfoPool + 3;
-    mSubHandler->mNumTraitInstances++;
-    ++(SubscriptionEngine::GetInstance()->mNumTraitInfosInPool);
+    traitInstance = mSubscriptionEngine.AllocTraitInfo(mSubHandler);
 
     traitInstance->Init();
     traitInstance->mTraitDataHandle = testBSourceHandle;
@@ -1134,6 +1147,225 @@ exit:
     NL_TEST_ASSERT(inSuite, testPass);
 }
 
+void TestTdm::TestTdmStatic_DirtyStoreNoOverflow(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+
+    Reset();
+
+    // Handles outside of dictionaries are tracked per data source, so marking more of them dirty than the dirty store can
+    // hold should not degrade to marking the root dirty.
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_A);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_B);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_C);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_D);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_E);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_F);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_G);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_H);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_I);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_J);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_K_Sb);
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_K_Sc);
+
+    VerifyOrExit(!mTestTdmSource.IsRootDirty(), );
+
+    err = BuildAndProcessNotify();
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 1 }, { TestHTrait::kPropertyHandle_B, 1 },
+                                                  { TestHTrait::kPropertyHandle_C, 1 }, { TestHTrait::kPropertyHandle_D, 1 },
+                                                  { TestHTrait::kPropertyHandle_E, 1 }, { TestHTrait::kPropertyHandle_F, 1 },
+                                                  { TestHTrait::kPropertyHandle_G, 1 }, { TestHTrait::kPropertyHandle_H, 1 },
+                                                  { TestHTrait::kPropertyHandle_I, 1 }, { TestHTrait::kPropertyHandle_J, 1 },
+                                                  { TestHTrait::kPropertyHandle_K_Sb, 1 }, { TestHTrait::kPropertyHandle_K_Sc, 1 } },
+                                                { },
+                                                { TestHTrait::kPropertyHandle_K_Sa, TestHTrait::kPropertyHandle_L });
+
+exit:
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+void TestTdm::TestTdmStatic_CachedDataElement(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+
+    Reset();
+
+    // Emulate an evaluation round of NotificationEngine::Run().
+    mNotificationEngine->ResetDataElementCache(true);
+
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 2);
+
+    err = BuildAndProcessNotify();
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 2 } },
+                                                { },
+                                                { } );
+    VerifyOrExit(testPass, );
+
+    testPass = false;
+    VerifyOrExit(mNotificationEngine->mNumCachedDataElements == 1, );
+
+    // A second notify for the same trait instance within the round copies the cached element rather than encoding a new one.
+    mTestTdmSource.SetDirty(TestHTrait::kPropertyHandle_A);
+
+    err = BuildAndProcessNotify();
+    SuccessOrExit(err);
+
+    VerifyOrExit(mNotificationEngine->mNumCachedDataElements == 1, );
+
+    testPass = true;
+
+exit:
+    mNotificationEngine->ResetDataElementCache(false);
+
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+
+#if WDM_PUBLISHER_ENABLE_VIEW
+int TestTdm::BuildAndProcessView(ViewHandler & aHandler, const uint32_t aMaxPayloadSize, int & aNumChunks)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *request = NULL;
+    PacketBuffer *buf = NULL;
+    TLVWriter writer;
+    TLVReader reader;
+    TLVType dummyType1, dummyType2;
+    SchemaVersionRange versionRange;
+    PathList::Builder pathList;
+    bool moreChunks = true;
+
+    aNumChunks = 0;
+
+    // View request for the whole of the first trait instance
+    request = PacketBuffer::New();
+    VerifyOrExit(request != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    writer.Init(request);
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, dummyType1);
+    SuccessOrExit(err);
+
+    err = pathList.Init(&writer, ViewRequest::kCsTag_PathList);
+    SuccessOrExit(err);
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Path, dummyType2);
+    SuccessOrExit(err);
+
+    err = mSourceCatalog.HandleToAddress(0, writer, versionRange);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(dummyType2);
+    SuccessOrExit(err);
+
+    err = pathList.EndOfPathList().GetError();
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(dummyType1);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    err = aHandler.Init(NULL, request);
+    request = NULL;
+    SuccessOrExit(err);
+
+    while (moreChunks)
+    {
+        buf = PacketBuffer::New();
+        VerifyOrExit(buf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        err = aHandler.BuildResponse(buf, aMaxPayloadSize, moreChunks);
+        SuccessOrExit(err);
+
+        VerifyOrExit(buf->DataLength() <= aMaxPayloadSize, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+        aNumChunks++;
+
+        reader.Init(buf);
+
+        err = reader.Next();
+        SuccessOrExit(err);
+
+        // Enter the struct
+        err = reader.EnterContainer(dummyType1);
+        SuccessOrExit(err);
+
+        // DataList
+        err = reader.Next();
+        SuccessOrExit(err);
+
+        VerifyOrExit(nl::Weave::TLV::kTLVType_Array == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+        err = reader.EnterContainer(dummyType2);
+        SuccessOrExit(err);
+
+        err = mSubClient->ProcessDataList(reader);
+        SuccessOrExit(err);
+
+        PacketBuffer::Free(buf);
+        buf = NULL;
+    }
+
+exit:
+    aHandler.Close();
+
+    if (request) {
+        PacketBuffer::Free(request);
+    }
+
+    if (buf) {
+        PacketBuffer::Free(buf);
+    }
+
+    return err;
+}
+
+void TestTdm::TestTdmStatic_ChunkedView(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    ViewHandler handler;
+    int numChunks;
+
+    Reset();
+
+    // The whole trait instance fits in one response.
+    err = BuildAndProcessView(handler, 1024, numChunks);
+    SuccessOrExit(err);
+
+    VerifyOrExit(numChunks == 1, );
+
+    Reset();
+
+    // A response too small for the whole trait instance is split into chunks, one data element per child property, that
+    // the client applies as a single change.
+    err = BuildAndProcessView(handler, 64, numChunks);
+    SuccessOrExit(err);
+
+    VerifyOrExit(numChunks > 1, );
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 1 }, { TestHTrait::kPropertyHandle_B, 1 },
+                                                  { TestHTrait::kPropertyHandle_C, 1 }, { TestHTrait::kPropertyHandle_D, 1 },
+                                                  { TestHTrait::kPropertyHandle_E, 1 }, { TestHTrait::kPropertyHandle_F, 1 },
+                                                  { TestHTrait::kPropertyHandle_G, 1 }, { TestHTrait::kPropertyHandle_H, 1 },
+                                                  { TestHTrait::kPropertyHandle_I, 1 }, { TestHTrait::kPropertyHandle_J, 1 },
+                                                  { TestHTrait::kPropertyHandle_K_Sb, 1 }, { TestHTrait::kPropertyHandle_K_Sc, 1 } },
+                                                { },
+                                                { TestHTrait::kPropertyHandle_K_Sa, TestHTrait::kPropertyHandle_L });
+
+exit:
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+#endif // WDM_PUBLISHER_ENABLE_VIEW
+
 void TestTdm::TestTdmStatic_MarkLeafHandleDirtyTwice(nlTestSuite *inSuite)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -2100,6 +2332,25 @@ static void TestTdmStatic_MergeHandleSetOverflow(nlTestSuite *inSuite, void *inC
     gTestTdm->TestTdmStatic_MergeHandleSetOverflow(inSuite);
 }
 
+static void TestTdmStatic_DirtyStoreNoOverflow(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_DirtyStoreNoOverflow(inSuite);
+}
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+static void TestTdmStatic_CachedDataElement(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_CachedDataElement(inSuite);
+}
+#endif
+
+#if WDM_PUBLISHER_ENABLE_VIEW
+static void TestTdmStatic_ChunkedView(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_ChunkedView(inSuite);
+}
+#endif
+
 static void TestTdmStatic_MarkLeafHandleDirtyTwice(nlTestSuite *inSuite, void *inContext)
 {
     gTestTdm->TestTdmStatic_MarkLeafHandleDirtyTwice(inSuite);
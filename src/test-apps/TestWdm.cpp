@@ -81,6 +81,9 @@ SubscriptionEngine * SubscriptionEngine::GetInstance()
 }
 
 static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, void *inContext);
+static void TestSubscriptionHandlerIndex(nlTestSuite *inSuite, void *inContext);
+static void TestSubscriptionHandlerIndex_IncomingRequest(nlTestSuite *inSuite, void *inContext);
+static void TestTraitInfoRuns(nlTestSuite *inSuite, void *inContext);
 
 // Test Suite
 
@@ -88,6 +91,9 @@ static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, voi
  *  Test Suite that lists all the test functions.
  */
 static const nlTest sTests[] = {
+    NL_TEST_DEF("Test Subscription Handler Index", TestSubscriptionHandlerIndex),
+    NL_TEST_DEF("Test Subscription Handler Index -- Incoming Request", TestSubscriptionHandlerIndex_IncomingRequest),
+    NL_TEST_DEF("Test Trait Instance Runs", TestTraitInfoRuns),
     NL_TEST_DEF("Test Counter Subscription -- Buffer Allocation Failure", TestCounterSubscription_BufferAllocFailure),
 
     NL_TEST_SENTINEL()
@@ -108,7 +114,11 @@ public:
     int BuildAndProcessNotify();
 
     void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite);
+    void TestSubscriptionHandlerIndex(nlTestSuite *inSuite);
+    void TestSubscriptionHandlerIndex_IncomingRequest(nlTestSuite *inSuite);
+    void TestTraitInfoRuns(nlTestSuite *inSuite);
     void SpoofPublisherSubscription();
+    int CountIndexEntries(uint64_t aSubscriptionId, const SubscriptionHandler *aHandler);
 
     static void ClientSubscriptionEventCallback(void * const aAppState,
                                         SubscriptionClient::EventID aEvent,
@@ -158,11 +168,39 @@ void TestWdm::SpoofPublisherSubscription()
 {
     mSubHandler->mRefCount = 1;
     mSubHandler->mLivenessTimeoutMsec = 2000;
+    mSubscriptionEngine.UnindexHandler(mSubHandler);
     mSubHandler->mSubscriptionId = 1;
+    mSubscriptionEngine.IndexHandler(mSubHandler);
     mPeerSubscriptionId = 1;
     mSubHandler->mCurrentState = SubscriptionHandler::kState_SubscriptionEstablished_Idle;
 }
 
+// Walks the index chain that aSubscriptionId hashes to and counts the links to aHandler, or returns -1 if the chain
+// does not terminate within the size of the pool.
+int TestWdm::CountIndexEntries(uint64_t aSubscriptionId, const SubscriptionHandler *aHandler)
+{
+    const uint16_t handlerId = static_cast<uint16_t>(aHandler - mSubscriptionEngine.mHandlers + 1);
+    uint16_t id = mSubscriptionEngine.mHandlers[SubscriptionEngine::GetIndexBucket(aSubscriptionId, mSubscriptionEngine.mNumHandlers)].mIndexHead;
+    int count = 0;
+
+    for (size_t steps = 0; id != 0; steps++)
+    {
+        if (steps >= mSubscriptionEngine.mNumHandlers)
+        {
+            return -1;
+        }
+
+        if (id == handlerId)
+        {
+            count++;
+        }
+
+        id = mSubscriptionEngine.mHandlers[id - 1].mIndexNext;
+    }
+
+    return count;
+}
+
 void
 TestWdm::BindingEventCallback(void * const apAppState, const nl::Weave::Binding::EventType aEventType,
                                             const nl::Weave::Binding::InEventParam & aInParam,
@@ -422,6 +460,181 @@ void TestWdm::TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite)
     NL_TEST_ASSERT(inSuite, mPublisherSubscriptionPresent == false);
 }
 
+void TestWdm::TestSubscriptionHandlerIndex(nlTestSuite *inSuite)
+{
+    const uint64_t peerNodeId = mSubHandler->mBinding->GetPeerNodeId();
+    SubscriptionHandler::TraitInstanceInfo traitInfos[4];
+    SubscriptionHandler handlers[4];
+
+    Reset();
+
+    SpoofPublisherSubscription();
+
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.FindHandler(peerNodeId, 1) == mSubHandler);
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.FindHandler(peerNodeId + 1, 1) == NULL);
+
+    // Re-key the handler, as happens when a handler is reused for a new subscription.
+    mSubscriptionEngine.UnindexHandler(mSubHandler);
+    mSubHandler->mSubscriptionId = 0x0123456789ABCDEFULL;
+    mSubscriptionEngine.IndexHandler(mSubHandler);
+
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.FindHandler(peerNodeId, 1) == NULL);
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.FindHandler(peerNodeId, 0x0123456789ABCDEFULL) == mSubHandler);
+
+    // The handler pool cannot be replaced while a handler is in use.
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.SetHandlerPool(handlers, 4, traitInfos, 4) == WEAVE_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.SetHandlerPool(handlers, 0, traitInfos, 4) == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    mSubscriptionEngine.UnindexHandler(mSubHandler);
+    mSubHandler->mSubscriptionId = 0;
+}
+
+void TestWdm::TestSubscriptionHandlerIndex_IncomingRequest(nlTestSuite *inSuite)
+{
+    const uint64_t peerNodeId = 0x18B4300000000042ULL;
+    const uint64_t subscriptionId = 5;
+    SubscriptionHandler *handler = NULL;
+    Binding *binding = NULL;
+    ExchangeContext *ec = NULL;
+    PacketBuffer *payload = NULL;
+    WeaveMessageInfo msgInfo;
+    TLVWriter writer;
+    SubscribeRequest::Builder request;
+    int indexEntries;
+    WEAVE_ERROR err;
+
+    Reset();
+
+    // A subscribe request without a subscription ID, so that the handler takes the one it is given. Its one path names
+    // a trait the publisher does not have, which the handler skips.
+    payload = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, payload != NULL);
+
+    writer.Init(payload);
+    err = request.Init(&writer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    {
+        PathList::Builder & pathList = request.CreatePathListBuilder();
+
+        pathList.CreatePathBuilder().ProfileID(0x1234).EndOfPath();
+        pathList.EndOfPathList();
+    }
+    request.EndOfRequest();
+    NL_TEST_ASSERT(inSuite, request.GetError() == WEAVE_NO_ERROR);
+
+    err = writer.Finalize();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = mSubscriptionEngine.NewSubscriptionHandler(&handler);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    binding = ExchangeMgr.NewBinding();
+    NL_TEST_ASSERT(inSuite, binding != NULL);
+    binding->BeginConfiguration().Transport_UDP().Target_NodeId(peerNodeId);
+
+    ec = ExchangeMgr.NewContext(peerNodeId);
+    NL_TEST_ASSERT(inSuite, ec != NULL);
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = peerNodeId;
+
+    // The handler takes its own reference to the binding. The publisher callback neither accepts nor rejects the
+    // parsed request, so the handler is left evaluating it.
+    handler->mAppState = gTestWdm;
+    handler->mEventCallback = PublisherEventCallback;
+    handler->InitWithIncomingRequest(binding, subscriptionId, ec, NULL, &msgInfo, payload);
+    binding->Release();
+
+    NL_TEST_ASSERT(inSuite, handler->mSubscriptionId == subscriptionId);
+
+    // The handler must be indexed exactly once, so that its chain terminates. A lookup of another ID in the same
+    // chain then walks past the handler and ends.
+    indexEntries = CountIndexEntries(subscriptionId, handler);
+    NL_TEST_ASSERT(inSuite, indexEntries == 1);
+
+    if (indexEntries == 1)
+    {
+        NL_TEST_ASSERT(inSuite, mSubscriptionEngine.FindHandler(peerNodeId, subscriptionId + mSubscriptionEngine.mNumHandlers) == NULL);
+    }
+
+    handler->AbortSubscription();
+
+    NL_TEST_ASSERT(inSuite, handler->IsFree());
+    NL_TEST_ASSERT(inSuite, CountIndexEntries(subscriptionId, handler) == 0);
+}
+
+void TestWdm::TestTraitInfoRuns(nlTestSuite *inSuite)
+{
+    SubscriptionHandler::TraitInstanceInfo * const savedPool = mSubscriptionEngine.mTraitInfoPool;
+    const uint32_t savedPoolSize = mSubscriptionEngine.mTraitInfoPoolSize;
+    SubscriptionHandler::TraitInstanceInfo traitInfos[8];
+    SubscriptionHandler handlers[3];
+    SubscriptionHandler::TraitInstanceInfo *traitInfo;
+
+    Reset();
+
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumTraitInfosInPool == 0);
+
+    mSubscriptionEngine.mTraitInfoPool = traitInfos;
+    mSubscriptionEngine.mTraitInfoPoolSize = 8;
+    mSubscriptionEngine.ResetTraitInfoPool();
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        handlers[i].InitAsFree();
+    }
+
+    // Handler 0 takes three trait instances, in a run that grows in place to four. Handlers 1 and 2 take two each
+    // after it, which fills the pool.
+    for (uint16_t i = 0; i < 7; i++)
+    {
+        SubscriptionHandler * const handler = &handlers[(i < 3) ? 0 : (i < 5) ? 1 : 2];
+
+        traitInfo = mSubscriptionEngine.AllocTraitInfo(handler);
+        NL_TEST_ASSERT(inSuite, traitInfo != NULL);
+        if (traitInfo != NULL)
+        {
+            traitInfo->mTraitDataHandle = i;
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, handlers[0].mTraitInstanceList == traitInfos && handlers[0].mNumTraitInstances == 3);
+    NL_TEST_ASSERT(inSuite, handlers[1].mTraitInstanceList == traitInfos + 4 && handlers[1].mNumTraitInstances == 2);
+    NL_TEST_ASSERT(inSuite, handlers[2].mTraitInstanceList == traitInfos + 6 && handlers[2].mNumTraitInstances == 2);
+
+    // Handler 1 cannot grow its run while the pool is full, and keeps the instances it has.
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.AllocTraitInfo(&handlers[1]) == NULL);
+    NL_TEST_ASSERT(inSuite, handlers[1].mTraitInstanceList == traitInfos + 4 && handlers[1].mNumTraitInstances == 2);
+
+    // Freeing handler 0 moves no other handler's instances. Its run is then reused when handler 1 grows.
+    mSubscriptionEngine.ReclaimTraitInfo(&handlers[0]);
+    NL_TEST_ASSERT(inSuite, handlers[2].mTraitInstanceList == traitInfos + 6);
+
+    traitInfo = mSubscriptionEngine.AllocTraitInfo(&handlers[1]);
+    NL_TEST_ASSERT(inSuite, traitInfo == traitInfos + 2);
+    NL_TEST_ASSERT(inSuite, handlers[1].mTraitInstanceList == traitInfos && handlers[1].mNumTraitInstances == 3);
+    NL_TEST_ASSERT(inSuite, traitInfos[0].mTraitDataHandle == 3 && traitInfos[1].mTraitDataHandle == 4);
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumTraitInfosInPool == 5);
+
+    // Handler 0 starts over with a single instance, split from the run handler 1 left behind.
+    traitInfo = mSubscriptionEngine.AllocTraitInfo(&handlers[0]);
+    NL_TEST_ASSERT(inSuite, traitInfo == traitInfos + 4);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        mSubscriptionEngine.ReclaimTraitInfo(&handlers[i]);
+        NL_TEST_ASSERT(inSuite, handlers[i].mTraitInstanceList == NULL && handlers[i].mNumTraitInstances == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumTraitInfosInPool == 0);
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mTraitInfoPoolTail == 0);
+
+    mSubscriptionEngine.mTraitInfoPool = savedPool;
+    mSubscriptionEngine.mTraitInfoPoolSize = savedPoolSize;
+    mSubscriptionEngine.ResetTraitInfoPool();
+}
+
 } // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
 }
 }
@@ -446,6 +659,21 @@ static int TestTeardown(void *inContext)
     return gTestWdm->Teardown();
 }
 
+static void TestSubscriptionHandlerIndex(nlTestSuite *inSuite, void *inContext)
+{
+    gTestWdm->TestSubscriptionHandlerIndex(inSuite);
+}
+
+static void TestSubscriptionHandlerIndex_IncomingRequest(nlTestSuite *inSuite, void *inContext)
+{
+    gTestWdm->TestSubscriptionHandlerIndex_IncomingRequest(inSuite);
+}
+
+static void TestTraitInfoRuns(nlTestSuite *inSuite, void *inContext)
+{
+    gTestWdm->TestTraitInfoRuns(inSuite);
+}
+
 static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, void *inContext)
 {
     gTestWdm->TestCounterSubscription_BufferAllocFailure(inSuite);
@@ -28,13 +28,22 @@
 #include <nltest.h>
 
 #include <Weave/Core/WeaveCore.h>
+#include <Weave/Profiles/security/WeaveDummyGroupKeyStore.h>
 
 #include "ToolCommon.h"
 
+using nl::Weave::Profiles::Security::AppKeys::DummyGroupKeyStore;
+
 static const uint64_t kTestNodeId = 0x18B43000002DCF71ULL;
 static const uint64_t kTestFabricId = 0xFEEDBEEFULL;
 static const uint16_t kDefaultSubnet = 0x01;
+static const uint64_t kTestPeerNodeIdBase = 0x18B4300000010000ULL;
+static const uint32_t kTestMsgId = 100;
 static WeaveFabricState sFabricState;
+static DummyGroupKeyStore sGroupKeyStore;
+
+// The fabric state whose tables are sized at run time by each test; too large for the stack.
+static WeaveFabricState sTableFabricState;
 
 /**
  * Test generating a ULA using the default subnet.
@@ -101,6 +110,162 @@ static void CheckSelectNodeAddressWithSubnet(nlTestSuite *inSuite, void *inConte
     }
 }
 
+/**
+ *  Receive an unencrypted UDP message with the given id from a peer, and return whether it was detected as a duplicate.
+ */
+static bool ReceiveUnencryptedMessage(WeaveFabricState& fabricState, uint64_t peerNodeId, uint32_t msgId)
+{
+    WeaveSessionState sessionState;
+
+    fabricState.GetSessionState(peerNodeId, WeaveKeyId::kNone, kWeaveEncryptionType_None, NULL, sessionState);
+
+    return sessionState.IsDuplicateMessage(msgId);
+}
+
+/**
+ *  Test that message counters are tracked for as many peers as the table was sized for at run time.
+ */
+static void CheckPeerStateTable(nlTestSuite *inSuite, void *inContext)
+{
+    const size_t numPeers = 4 * WEAVE_CONFIG_MAX_PEER_NODES;
+    WeaveFabricState &fabricState = sTableFabricState;
+    WEAVE_ERROR err;
+
+    err = fabricState.Init(&sGroupKeyStore, numPeers, WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (size_t i = 0; i < numPeers; i++)
+        NL_TEST_ASSERT(inSuite, !ReceiveUnencryptedMessage(fabricState, kTestPeerNodeIdBase + i, kTestMsgId));
+
+    // Every peer is still tracked, so every repeated message is a duplicate.
+    for (size_t i = 0; i < numPeers; i++)
+        NL_TEST_ASSERT(inSuite, ReceiveUnencryptedMessage(fabricState, kTestPeerNodeIdBase + i, kTestMsgId));
+
+    // A full table of new peers displaces all of the old ones.
+    for (size_t i = numPeers; i < 2 * numPeers; i++)
+        NL_TEST_ASSERT(inSuite, !ReceiveUnencryptedMessage(fabricState, kTestPeerNodeIdBase + i, kTestMsgId));
+
+    NL_TEST_ASSERT(inSuite, !ReceiveUnencryptedMessage(fabricState, kTestPeerNodeIdBase, kTestMsgId));
+
+    fabricState.Shutdown();
+}
+
+/**
+ *  Test that a full peer state table replaces a peer that has not been heard from recently.
+ */
+static void CheckPeerStateReplacement(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t peerA = kTestPeerNodeIdBase, peerB = peerA + 1, peerC = peerA + 2, peerD = peerA + 3;
+    const uint64_t peerE = peerA + 4, peerF = peerA + 5;
+    WeaveFabricState &fabricState = sTableFabricState;
+    WEAVE_ERROR err;
+
+    err = fabricState.Init(&sGroupKeyStore, 4, WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    ReceiveUnencryptedMessage(fabricState, peerA, kTestMsgId);
+    ReceiveUnencryptedMessage(fabricState, peerB, kTestMsgId);
+    ReceiveUnencryptedMessage(fabricState, peerC, kTestMsgId);
+    ReceiveUnencryptedMessage(fabricState, peerD, kTestMsgId);
+
+    // None of the peers was heard from again, so the first one is replaced.
+    ReceiveUnencryptedMessage(fabricState, peerE, kTestMsgId);
+
+    // Peer B is heard from again, so peer C is replaced in its stead.
+    NL_TEST_ASSERT(inSuite, ReceiveUnencryptedMessage(fabricState, peerB, kTestMsgId));
+    ReceiveUnencryptedMessage(fabricState, peerF, kTestMsgId);
+
+    NL_TEST_ASSERT(inSuite, ReceiveUnencryptedMessage(fabricState, peerB, kTestMsgId));
+    NL_TEST_ASSERT(inSuite, ReceiveUnencryptedMessage(fabricState, peerD, kTestMsgId));
+    NL_TEST_ASSERT(inSuite, !ReceiveUnencryptedMessage(fabricState, peerC, kTestMsgId));
+
+    fabricState.Shutdown();
+}
+
+/**
+ *  Test that session keys are found by key id and peer in a table sized at run time.
+ */
+static void CheckSessionKeyTable(nlTestSuite *inSuite, void *inContext)
+{
+    enum
+    {
+        kNumKeys = 8 * WEAVE_CONFIG_MAX_SESSION_KEYS
+    };
+    WeaveFabricState &fabricState = sTableFabricState;
+    WeaveSessionKey *keys[kNumKeys];
+    uint16_t keyIds[kNumKeys];
+    WeaveSessionKey *sessionKey;
+    WEAVE_ERROR err;
+
+    err = fabricState.Init(&sGroupKeyStore, WEAVE_CONFIG_MAX_PEER_NODES, kNumKeys);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (size_t i = 0; i < kNumKeys; i++)
+    {
+        err = fabricState.AllocSessionKey(kTestPeerNodeIdBase + (i / 2), WeaveKeyId::kNone, NULL, keys[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        keyIds[i] = keys[i]->MsgEncKey.KeyId;
+    }
+
+    err = fabricState.AllocSessionKey(kTestPeerNodeIdBase, WeaveKeyId::kNone, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_TOO_MANY_KEYS);
+
+    // Remove every other key, and check that the lookups of the remaining ones are unaffected.
+    for (size_t i = 0; i < kNumKeys; i += 2)
+        fabricState.RemoveSessionKey(keys[i]);
+
+    for (size_t i = 0; i < kNumKeys; i++)
+    {
+        err = fabricState.FindSessionKey(keyIds[i], kTestPeerNodeIdBase + (i / 2), false, sessionKey);
+        if (i % 2 == 0)
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+        else
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && sessionKey == keys[i]);
+
+        err = fabricState.FindSessionKey(keyIds[i], kTestPeerNodeIdBase + kNumKeys, false, sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+    }
+
+    // The freed keys can be allocated again, and an end node of a shared session finds the session's key.
+    for (size_t i = 0; i < kNumKeys; i += 2)
+    {
+        err = fabricState.AllocSessionKey(kTestPeerNodeIdBase + kNumKeys, WeaveKeyId::kNone, NULL, keys[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    keys[0]->SetSharedSession(true);
+    err = fabricState.AddSharedSessionEndNode(keys[0], kTestNodeId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = fabricState.FindSessionKey(keys[0]->MsgEncKey.KeyId, kTestNodeId, false, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && sessionKey == keys[0]);
+
+    fabricState.Shutdown();
+}
+
+/**
+ *  Test the bounds on the runtime table sizes.
+ */
+static void CheckInitArguments(nlTestSuite *inSuite, void *inContext)
+{
+    WeaveFabricState &fabricState = sTableFabricState;
+    WEAVE_ERROR err;
+
+    err = fabricState.Init(&sGroupKeyStore, 0, WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = fabricState.Init(&sGroupKeyStore, WEAVE_CONFIG_MAX_PEER_NODES, 0);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = fabricState.Init(&sGroupKeyStore, UINT16_MAX, WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = fabricState.Init(&sGroupKeyStore, WEAVE_CONFIG_MAX_PEER_NODES, WEAVE_CONFIG_MAX_SESSION_KEYS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    fabricState.Shutdown();
+}
+
 /**
  *  Set up the test suite.
  */
@@ -131,6 +296,10 @@ static const nlTest sTests[] =
     // more thorough collection of tests should be written.
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddress),
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddressWithSubnet),
+    NL_TEST_DEF("WeaveFabricState::PeerStateTable", CheckPeerStateTable),
+    NL_TEST_DEF("WeaveFabricState::PeerStateReplacement", CheckPeerStateReplacement),
+    NL_TEST_DEF("WeaveFabricState::SessionKeyTable", CheckSessionKeyTable),
+    NL_TEST_DEF("WeaveFabricState::InitArguments", CheckInitArguments),
     NL_TEST_SENTINEL()
 };
 
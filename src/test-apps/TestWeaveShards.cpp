@@ -0,0 +1,513 @@
+/*
+ *
+ *    Copyright (c) 2018 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a benchmark for sharded Weave message layers, where several
+ *      independent Weave stacks, each serviced by its own thread, share the Weave port
+ *      and incoming messages are steered to a shard by the node id of the sender.
+ *
+ *      Client threads send unsolicited, unencrypted Weave messages from a range of source
+ *      node ids to the Weave port on the loopback interface as fast as they can. Each
+ *      shard counts the messages its exchange manager delivers, and checks that they were
+ *      steered to it according to WeaveMessageLayer::GetShardForNode(). The number of
+ *      messages handled per second is reported for each shard count.
+ *
+ */
+
+#define __STDC_FORMAT_MACROS
+#define __STDC_LIMIT_MACROS
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "ToolCommon.h"
+#include "TestGroupKeyStore.h"
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#include <Weave/Support/CodeUtils.h>
+
+#define TOOL_NAME "TestWeaveShards"
+
+using namespace nl::Weave::Encoding;
+
+enum
+{
+    kMaxShards              = 16,
+    kMaxClients             = 16,
+    kPeersPerClient         = 256,
+
+    kTestProfileId          = 0x235A1236,
+    kTestMsgType            = 1,
+
+    kShardNodeId            = 0x18B4300000000001ULL,
+    kClientNodeIdBase       = 0x18B4300000010000ULL,
+};
+
+struct Shard
+{
+    System::Layer           SystemLayer;
+    InetLayer               Inet;
+    WeaveFabricState        FabricState;
+    WeaveMessageLayer       MessageLayer;
+    WeaveExchangeManager    ExchangeMgr;
+    TestGroupKeyStore       GroupKeyStore;
+    pthread_t               Thread;
+    uint8_t                 Index;
+    volatile uint32_t       NumReceived;
+    volatile uint32_t       NumMisrouted;
+};
+
+struct Client
+{
+    pthread_t               Thread;
+    uint8_t                 Index;
+    volatile uint32_t       NumSent;
+};
+
+static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg);
+static WEAVE_ERROR InitShard(Shard &shard, uint8_t shardIndex, uint8_t shardCount);
+static void ShutdownShard(Shard &shard);
+static void ServiceShard(Shard &shard, struct timeval sleepTime);
+static void *ShardMain(void *arg);
+static void *ClientMain(void *arg);
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+static uint16_t EncodeTestMessage(uint8_t *buf, uint64_t srcNodeId, uint32_t msgId, uint16_t exchangeId);
+#endif
+static void HandleTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+        uint32_t profileId, uint8_t msgType, PacketBuffer *payload);
+static bool RunConfiguration(uint8_t shardCount);
+
+static uint32_t sMaxShards = 0;
+static uint32_t sNumClients = 1;
+static uint32_t sDurationMs = 2000;
+static bool sBenchmark = false;
+static uint8_t sShardCount = 1;
+static volatile bool sDone = false;
+
+static OptionDef gToolOptionDefs[] =
+{
+    { "shards",             kArgumentRequired,  's' },
+    { "clients",            kArgumentRequired,  'c' },
+    { "duration",           kArgumentRequired,  'd' },
+    { "benchmark",          kNoArgument,        'b' },
+    { NULL }
+};
+
+static const char *gToolOptionHelp =
+    "  -s, --shards <num>\n"
+    "       Run the specified number of shards. With --benchmark, the largest number\n"
+    "       of shards to run. Defaults to the number of online processors.\n"
+    "\n"
+    "  -c, --clients <num>\n"
+    "       Send messages from the specified number of client threads. Defaults to 1.\n"
+    "\n"
+    "  -d, --duration <ms>\n"
+    "       Send messages for the specified number of milliseconds in each run.\n"
+    "       Defaults to 2000.\n"
+    "\n"
+    "  -b, --benchmark\n"
+    "       Run with 1, 2, 4, ... shards, up to the number given by --shards, and\n"
+    "       report how the message rate scales with the number of shards.\n"
+    "\n";
+
+static OptionSet gToolOptions =
+{
+    HandleOption,
+    gToolOptionDefs,
+    "GENERAL OPTIONS",
+    gToolOptionHelp
+};
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gToolOptions,
+    &gHelpOptions,
+    NULL
+};
+
+int main(int argc, char *argv[])
+{
+    bool succeeded = true;
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (sMaxShards == 0)
+    {
+        long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+
+        sMaxShards = (numCPUs < 1) ? 1 : (numCPUs > kMaxShards) ? kMaxShards : numCPUs;
+    }
+
+#if !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    printf("%s: sharded message layers require the sockets configuration\n", TOOL_NAME);
+    exit(EXIT_FAILURE);
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+    InitToolCommon();
+
+    nl::Weave::Logging::SetLogFilter(nl::Weave::Logging::kLogCategory_Error);
+
+    printf("%8s %12s %12s %12s %12s\n", "shards", "sent", "received", "misrouted", "msgs/s");
+
+    if (sBenchmark)
+    {
+        for (uint32_t shardCount = 1; succeeded && shardCount <= sMaxShards; shardCount *= 2)
+            succeeded = RunConfiguration(shardCount);
+    }
+    else
+    {
+        succeeded = RunConfiguration(sMaxShards);
+    }
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool RunConfiguration(uint8_t shardCount)
+{
+    Shard *shards[kMaxShards];
+    Client clients[kMaxClients];
+    uint32_t numSent = 0;
+    uint32_t numReceived = 0;
+    uint32_t numMisrouted = 0;
+    uint64_t startTimeMs;
+    uint64_t elapsedMs;
+    uint8_t numShards;
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    memset(shards, 0, sizeof(shards));
+    sShardCount = shardCount;
+    sDone = false;
+
+    // The steering must not depend on the order in which the shards join the groups of the Weave port, so they are
+    // initialized in the reverse order of their indices, and one of them is then reinitialized, which makes the system
+    // renumber the members of the groups.
+    for (numShards = 0; numShards < shardCount; numShards++)
+    {
+        uint8_t shardIndex = shardCount - numShards - 1;
+
+        shards[shardIndex] = new Shard();
+
+        err = InitShard(*shards[shardIndex], shardIndex, shardCount);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("Shard %u initialization failed: %s\n", shardIndex, ErrorStr(err));
+            delete shards[shardIndex];
+            shards[shardIndex] = NULL;
+            goto exit;
+        }
+    }
+
+    if (shardCount > 1)
+    {
+        uint8_t shardIndex = shardCount / 2;
+
+        ShutdownShard(*shards[shardIndex]);
+
+        err = InitShard(*shards[shardIndex], shardIndex, shardCount);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("Shard %u reinitialization failed: %s\n", shardIndex, ErrorStr(err));
+            delete shards[shardIndex];
+            shards[shardIndex] = NULL;
+            goto exit;
+        }
+    }
+
+    for (uint8_t i = 0; i < shardCount; i++)
+        pthread_create(&shards[i]->Thread, NULL, ShardMain, shards[i]);
+
+    startTimeMs = NowMs();
+
+    for (uint32_t i = 0; i < sNumClients; i++)
+    {
+        clients[i].Index = i;
+        clients[i].NumSent = 0;
+        pthread_create(&clients[i].Thread, NULL, ClientMain, &clients[i]);
+    }
+
+    usleep(sDurationMs * 1000);
+
+    sDone = true;
+
+    for (uint32_t i = 0; i < sNumClients; i++)
+    {
+        pthread_join(clients[i].Thread, NULL);
+        numSent += clients[i].NumSent;
+    }
+
+    for (uint8_t i = 0; i < shardCount; i++)
+    {
+        pthread_join(shards[i]->Thread, NULL);
+        numReceived += shards[i]->NumReceived;
+        numMisrouted += shards[i]->NumMisrouted;
+    }
+
+    elapsedMs = NowMs() - startTimeMs;
+
+    printf("%8u %12" PRIu32 " %12" PRIu32 " %12" PRIu32 " %12" PRIu64 "\n", shardCount, numSent, numReceived, numMisrouted,
+           (elapsedMs > 0) ? (uint64_t) numReceived * 1000 / elapsedMs : 0);
+
+exit:
+    for (uint8_t i = 0; i < shardCount; i++)
+    {
+        if (shards[i] != NULL)
+        {
+            ShutdownShard(*shards[i]);
+            delete shards[i];
+        }
+    }
+
+    return (err == WEAVE_NO_ERROR && numReceived > 0 && numMisrouted == 0);
+}
+
+WEAVE_ERROR InitShard(Shard &shard, uint8_t shardIndex, uint8_t shardCount)
+{
+    WeaveMessageLayer::InitContext initContext;
+    WEAVE_ERROR err;
+
+    shard.Index = shardIndex;
+    shard.NumReceived = 0;
+    shard.NumMisrouted = 0;
+
+    err = shard.SystemLayer.Init(NULL);
+    SuccessOrExit(err);
+
+    err = shard.Inet.Init(shard.SystemLayer, NULL);
+    SuccessOrExit(err);
+
+    err = shard.FabricState.Init(&shard.GroupKeyStore);
+    SuccessOrExit(err);
+
+    shard.FabricState.FabricId = kFabricIdDefaultForTest;
+    shard.FabricState.LocalNodeId = kShardNodeId;
+
+    initContext.systemLayer = &shard.SystemLayer;
+    initContext.inet = &shard.Inet;
+    initContext.fabricState = &shard.FabricState;
+    initContext.listenTCP = false;
+    initContext.listenUDP = true;
+    initContext.shardIndex = shardIndex;
+    initContext.shardCount = shardCount;
+
+    err = shard.MessageLayer.Init(&initContext);
+    SuccessOrExit(err);
+
+    err = shard.ExchangeMgr.Init(&shard.MessageLayer);
+    SuccessOrExit(err);
+
+    err = shard.ExchangeMgr.RegisterUnsolicitedMessageHandler(kTestProfileId, kTestMsgType, HandleTestMessage, true, &shard);
+    SuccessOrExit(err);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        ShutdownShard(shard);
+
+    return err;
+}
+
+void ShutdownShard(Shard &shard)
+{
+    shard.ExchangeMgr.Shutdown();
+    shard.MessageLayer.Shutdown();
+    shard.FabricState.Shutdown();
+    shard.Inet.Shutdown();
+    shard.SystemLayer.Shutdown();
+}
+
+void *ShardMain(void *arg)
+{
+    Shard *shard = static_cast<Shard *>(arg);
+    struct timeval sleepTime;
+
+    while (!sDone)
+    {
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceShard(*shard, sleepTime);
+    }
+
+    return NULL;
+}
+
+/**
+ *  Service the network and timer events of one shard, as ServiceEvents() does for the stack of a tool.
+ */
+void ServiceShard(Shard &shard, struct timeval sleepTime)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    struct epoll_event events[64];
+    int timeoutMS = sleepTime.tv_sec * 1000 + sleepTime.tv_usec / 1000;
+
+    shard.SystemLayer.PrepareEPoll(timeoutMS);
+    shard.Inet.PrepareEPoll(timeoutMS);
+
+    int numEvents = epoll_wait(shard.SystemLayer.GetEPollFD(), events, sizeof(events) / sizeof(events[0]), timeoutMS);
+    if (numEvents < 0)
+        return;
+
+    shard.SystemLayer.HandleEPollResult(numEvents, events);
+    shard.Inet.HandleEPollResult();
+#elif WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    fd_set readFDs, writeFDs, exceptFDs;
+    int numFDs = 0;
+
+    FD_ZERO(&readFDs);
+    FD_ZERO(&writeFDs);
+    FD_ZERO(&exceptFDs);
+
+    shard.SystemLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+    shard.Inet.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+
+    int selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &sleepTime);
+    if (selectRes < 0)
+        return;
+
+    shard.SystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+    shard.Inet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+}
+
+void HandleTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+        uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    Shard *shard = static_cast<Shard *>(ec->AppState);
+
+    shard->NumReceived++;
+
+    if (WeaveMessageLayer::GetShardForNode(msgInfo->SourceNodeId, sShardCount) != shard->Index)
+        shard->NumMisrouted++;
+
+    PacketBuffer::Free(payload);
+    ec->Close();
+}
+
+void *ClientMain(void *arg)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    Client *client = static_cast<Client *>(arg);
+    struct sockaddr_in6 destAddr;
+    uint8_t msg[64];
+    uint32_t msgId = 0;
+    int sock;
+
+    sock = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        printf("Client %u socket() failed: %s\n", client->Index, ErrorStr(System::MapErrorPOSIX(errno)));
+        return NULL;
+    }
+
+    memset(&destAddr, 0, sizeof(destAddr));
+    destAddr.sin6_family = AF_INET6;
+    destAddr.sin6_addr = in6addr_loopback;
+    destAddr.sin6_port = htons(WEAVE_PORT);
+
+    while (!sDone)
+    {
+        uint64_t srcNodeId = kClientNodeIdBase + client->Index * kPeersPerClient + (msgId % kPeersPerClient);
+        uint16_t msgLen = EncodeTestMessage(msg, srcNodeId, msgId, (uint16_t) msgId);
+
+        if (sendto(sock, msg, msgLen, 0, (struct sockaddr *) &destAddr, sizeof(destAddr)) == msgLen)
+            client->NumSent++;
+
+        msgId++;
+    }
+
+    close(sock);
+#else
+    IgnoreUnusedVariable(arg);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+    return NULL;
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  Encode an unencrypted Weave message that initiates an exchange of the test profile and carries the node id of the
+ *  sender, as WeaveMessageLayer::EncodeMessage() and ExchangeContext::SendMessage() would.
+ */
+uint16_t EncodeTestMessage(uint8_t *buf, uint64_t srcNodeId, uint32_t msgId, uint16_t exchangeId)
+{
+    uint8_t *p = buf;
+
+    LittleEndian::Write16(p, (kWeaveMessageVersion_V1 << kMsgHeaderField_MessageVersionShift) | kWeaveHeaderFlag_SourceNodeId);
+    LittleEndian::Write32(p, msgId);
+    LittleEndian::Write64(p, srcNodeId);
+
+    Write8(p, (kWeaveExchangeVersion_V1 << 4) | kWeaveExchangeFlag_Initiator);
+    Write8(p, kTestMsgType);
+    LittleEndian::Write16(p, exchangeId);
+    LittleEndian::Write32(p, kTestProfileId);
+
+    return p - buf;
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg)
+{
+    switch (id)
+    {
+    case 's':
+        if (!ParseInt(arg, sMaxShards) || sMaxShards < 1 || sMaxShards > kMaxShards)
+        {
+            PrintArgError("%s: Invalid value specified for number of shards: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'c':
+        if (!ParseInt(arg, sNumClients) || sNumClients < 1 || sNumClients > kMaxClients)
+        {
+            PrintArgError("%s: Invalid value specified for number of clients: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'd':
+        if (!ParseInt(arg, sDurationMs) || sDurationMs < 1)
+        {
+            PrintArgError("%s: Invalid value specified for duration: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'b':
+        sBenchmark = true;
+        break;
+    default:
+        PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", progName, name);
+        return false;
+    }
+
+    return true;
+}
@@ -94,6 +94,13 @@ nl::Ble::Platform::BlueZ::BluezBlePlatformDelegate *getBluezPlatformDelegate()
 #include <sys/select.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+
+// The maximum number of epoll events retrieved by each pass through the event loop.
+enum { kMaxEPollEvents = 64 };
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 static sys_mbox* sLwIPEventQueue = NULL;
@@ -923,7 +930,24 @@ void ServiceEvents(::timeval& aSleepTime)
             printed = true;
         }
     }
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    struct epoll_event events[kMaxEPollEvents];
+    int timeoutMS = aSleepTime.tv_sec * 1000 + aSleepTime.tv_usec / 1000;
+
+    if (SystemLayer.State() == System::kLayerState_Initialized)
+        SystemLayer.PrepareEPoll(timeoutMS);
+
+    if (Inet.State == InetLayer::kState_Initialized)
+        Inet.PrepareEPoll(timeoutMS);
+
+    int numEvents = epoll_wait(SystemLayer.GetEPollFD(), events, kMaxEPollEvents, timeoutMS);
+    if (numEvents < 0)
+    {
+        if (errno != EINTR)
+            printf("epoll_wait failed: %s\n", ErrorStr(System::MapErrorPOSIX(errno)));
+        return;
+    }
+#elif WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     fd_set readFDs, writeFDs, exceptFDs;
     int numFDs = 0;
 
@@ -955,7 +979,11 @@ void ServiceEvents(::timeval& aSleepTime)
         static uint32_t sRemainingSystemLayerEventDelay = 0;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+        SystemLayer.HandleEPollResult(numEvents, events);
+
+#elif WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
         SystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
 
@@ -992,7 +1020,11 @@ void ServiceEvents(::timeval& aSleepTime)
         static uint32_t sRemainingInetLayerEventDelay = 0;
 #endif // INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES && WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+        Inet.HandleEPollResult();
+
+#elif WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
         Inet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
 
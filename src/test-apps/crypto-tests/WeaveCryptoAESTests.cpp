@@ -28,6 +28,7 @@
 
 #include <Weave/Support/crypto/AESBlockCipher.h>
 #include <Weave/Support/crypto/CTRMode.h>
+#include <Weave/Support/crypto/GCMMode.h>
 
 #include "WeaveCryptoTests.h"
 
@@ -185,6 +186,63 @@ static void Check_AES128CTRMode_Test4(nlTestSuite *inSuite, void *inContext)
     aes128CTR.Reset();
 }
 
+static void Check_AES128CTRMode_Test5(nlTestSuite *inSuite, void *inContext)
+{
+    // A message spanning many blocks, with a block counter that carries across bytes part way through. The expected
+    // ciphertext is computed one block at a time with EncryptBlock().
+    static uint8_t key[]                = { 0x7E, 0x24, 0x06, 0x78, 0x17, 0xFA, 0xE0, 0xD7, 0x43, 0xD6, 0xCE, 0x1F, 0x32, 0x53, 0x91, 0x63 };
+    static uint8_t ctr[]                = { 0x00, 0x6C, 0xB6, 0xDB, 0xC0, 0x54, 0x3B, 0x59, 0xDA, 0x48, 0xD9, 0x0B, 0x00, 0x00, 0xFF, 0xF5 };
+    static const size_t chunkSizes[]    = { 1, 5, 16, 17, 100, 128, 1500 };
+    enum { kMessageLength = 1500 };
+
+    AES128BlockCipherEnc aes128BlockEnc;
+    uint8_t plainText[kMessageLength];
+    uint8_t expectedCipherText[kMessageLength];
+    uint8_t cipherText[kMessageLength];
+    uint8_t counter[sizeof(ctr)];
+
+    for (size_t i = 0; i < kMessageLength; i++)
+        plainText[i] = (uint8_t) (i * 7);
+
+    aes128BlockEnc.SetKey(key);
+    memcpy(counter, ctr, sizeof(counter));
+    for (size_t blockStart = 0; blockStart < kMessageLength; blockStart += AES128BlockCipherEnc::kBlockLength)
+    {
+        uint8_t encryptedCounter[AES128BlockCipherEnc::kBlockLength];
+
+        aes128BlockEnc.EncryptBlock(counter, encryptedCounter);
+        for (size_t i = 0; i < AES128BlockCipherEnc::kBlockLength && blockStart + i < kMessageLength; i++)
+            expectedCipherText[blockStart + i] = plainText[blockStart + i] ^ encryptedCounter[i];
+
+        for (int i = sizeof(counter) - 1; i >= 0 && ++counter[i] == 0; i--)
+            ;
+    }
+
+    for (size_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); c++)
+    {
+        AES128CTRMode aes128CTR;
+
+        aes128CTR.SetKey(key);
+        aes128CTR.SetCounter(ctr);
+
+        memcpy(cipherText, plainText, sizeof(cipherText));
+
+        // Encrypt in place, as the message layer does.
+        for (size_t chunkStart = 0; chunkStart < kMessageLength; chunkStart += chunkSizes[c])
+        {
+            uint16_t inLen = kMessageLength - chunkStart;
+            if (inLen > chunkSizes[c])
+                inLen = chunkSizes[c];
+            aes128CTR.EncryptData(cipherText + chunkStart, inLen, cipherText + chunkStart);
+        }
+
+        // Invalid ciphertext generated by AES128CTRMode::EncryptData()
+        NL_TEST_ASSERT(inSuite, memcmp(cipherText, expectedCipherText, kMessageLength) == 0);
+
+        aes128CTR.Reset();
+    }
+}
+
 bool AES256CTRMode_DoTest(const uint8_t *key, const uint8_t *ctr, const uint8_t *plainText, size_t plainTextLen, const uint8_t *expectedCipherText)
 {
     uint8_t cipherText[TEXT_BUFFER_LENGHT] = { 0 };
@@ -287,6 +345,102 @@ static void Check_AES256CTRMode_Test3(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, res == true);
 }
 
+bool AES128GCMMode_DoTest(const uint8_t *key, const uint8_t *iv, const uint8_t *aad, size_t aadLen, const uint8_t *plainText, size_t plainTextLen,
+                          const uint8_t *expectedCipherText, const uint8_t *expectedTag)
+{
+    uint8_t cipherText[TEXT_BUFFER_LENGHT] = { 0 };
+    uint8_t decryptedPlainText[TEXT_BUFFER_LENGHT] = { 0 };
+    uint8_t tag[AES128GCMMode::kTagLength];
+    bool res = true;
+    AES128GCMMode aes128GCM;
+
+    aes128GCM.SetKey(key);
+
+    // Feed the AAD and the data in chunks of every size, reusing the same object for each message.
+    for (size_t chunkSize = 1; chunkSize <= plainTextLen || chunkSize <= aadLen; chunkSize++)
+    {
+        aes128GCM.SetIV(iv);
+
+        for (size_t chunkStart = 0; chunkStart < aadLen; chunkStart += chunkSize)
+        {
+            uint16_t inLen = aadLen - chunkStart;
+            if (inLen > chunkSize)
+                inLen = chunkSize;
+            aes128GCM.AddAAD(aad + chunkStart, inLen);
+        }
+
+        for (size_t chunkStart = 0; chunkStart < plainTextLen; chunkStart += chunkSize)
+        {
+            uint16_t inLen = plainTextLen - chunkStart;
+            if (inLen > chunkSize)
+                inLen = chunkSize;
+            aes128GCM.EncryptData(plainText + chunkStart, inLen, cipherText + chunkStart);
+        }
+
+        aes128GCM.GetTag(tag);
+
+        if (memcmp(cipherText, expectedCipherText, plainTextLen) != 0 || memcmp(tag, expectedTag, sizeof(tag)) != 0)
+        {
+            res = false;
+            break;
+        }
+    }
+
+    aes128GCM.SetIV(iv);
+    aes128GCM.AddAAD(aad, aadLen);
+    aes128GCM.DecryptData(cipherText, plainTextLen, decryptedPlainText);
+    aes128GCM.GetTag(tag);
+
+    if (memcmp(decryptedPlainText, plainText, plainTextLen) != 0 || memcmp(tag, expectedTag, sizeof(tag)) != 0)
+        res = false;
+
+    aes128GCM.Reset();
+
+    return res;
+}
+
+static void Check_AES128GCMMode_Test1(nlTestSuite *inSuite, void *inContext)
+{
+    bool res;
+
+    // This is Test Case 2 from the GCM specification (McGrew and Viega).
+    static uint8_t key[]                = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    static uint8_t iv[]                 = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    static uint8_t plainText[]          = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    static uint8_t expectedCipherText[] = { 0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92, 0xF3, 0x28, 0xC2, 0xB9, 0x71, 0xB2, 0xFE, 0x78 };
+    static uint8_t expectedTag[]        = { 0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD, 0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF };
+
+    res = AES128GCMMode_DoTest(key, iv, NULL, 0, plainText, sizeof(plainText), expectedCipherText, expectedTag);
+
+    // Invalid ciphertext or tag generated by AES128GCMMode
+    NL_TEST_ASSERT(inSuite, res == true);
+}
+
+static void Check_AES128GCMMode_Test2(nlTestSuite *inSuite, void *inContext)
+{
+    bool res;
+
+    // This is Test Case 4 from the GCM specification (McGrew and Viega).
+    static uint8_t key[]                = { 0xFE, 0xFF, 0xE9, 0x92, 0x86, 0x65, 0x73, 0x1C, 0x6D, 0x6A, 0x8F, 0x94, 0x67, 0x30, 0x83, 0x08 };
+    static uint8_t iv[]                 = { 0xCA, 0xFE, 0xBA, 0xBE, 0xFA, 0xCE, 0xDB, 0xAD, 0xDE, 0xCA, 0xF8, 0x88 };
+    static uint8_t aad[]                = { 0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED, 0xFA, 0xCE, 0xDE, 0xAD, 0xBE, 0xEF,
+                                            0xAB, 0xAD, 0xDA, 0xD2 };
+    static uint8_t plainText[]          = { 0xD9, 0x31, 0x32, 0x25, 0xF8, 0x84, 0x06, 0xE5, 0xA5, 0x59, 0x09, 0xC5, 0xAF, 0xF5, 0x26, 0x9A,
+                                            0x86, 0xA7, 0xA9, 0x53, 0x15, 0x34, 0xF7, 0xDA, 0x2E, 0x4C, 0x30, 0x3D, 0x8A, 0x31, 0x8A, 0x72,
+                                            0x1C, 0x3C, 0x0C, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2F, 0xCF, 0x0E, 0x24, 0x49, 0xA6, 0xB5, 0x25,
+                                            0xB1, 0x6A, 0xED, 0xF5, 0xAA, 0x0D, 0xE6, 0x57, 0xBA, 0x63, 0x7B, 0x39 };
+    static uint8_t expectedCipherText[] = { 0x42, 0x83, 0x1E, 0xC2, 0x21, 0x77, 0x74, 0x24, 0x4B, 0x72, 0x21, 0xB7, 0x84, 0xD0, 0xD4, 0x9C,
+                                            0xE3, 0xAA, 0x21, 0x2F, 0x2C, 0x02, 0xA4, 0xE0, 0x35, 0xC1, 0x7E, 0x23, 0x29, 0xAC, 0xA1, 0x2E,
+                                            0x21, 0xD5, 0x14, 0xB2, 0x54, 0x66, 0x93, 0x1C, 0x7D, 0x8F, 0x6A, 0x5A, 0xAC, 0x84, 0xAA, 0x05,
+                                            0x1B, 0xA3, 0x0B, 0x39, 0x6A, 0x0A, 0xAC, 0x97, 0x3D, 0x58, 0xE0, 0x91 };
+    static uint8_t expectedTag[]        = { 0x5B, 0xC9, 0x4F, 0xBC, 0x32, 0x21, 0xA5, 0xDB, 0x94, 0xFA, 0xE9, 0x5A, 0xE7, 0x12, 0x1A, 0x47 };
+
+    res = AES128GCMMode_DoTest(key, iv, aad, sizeof(aad), plainText, sizeof(plainText), expectedCipherText, expectedTag);
+
+    // Invalid ciphertext or tag generated by AES128GCMMode
+    NL_TEST_ASSERT(inSuite, res == true);
+}
+
 bool AES128BlockCipher_DoTest(const uint8_t *key, const uint8_t *plainText, const uint8_t *expectedCipherText)
 {
     uint8_t cipherText[AES128BlockCipherEnc::kBlockLength];
@@ -370,6 +524,49 @@ bool AES256BlockCipher_DoTest(const uint8_t *key, const uint8_t *plainText, cons
     return true;
 }
 
+template <class BlockCipherEnc>
+bool BlockCipherEncryptBlocks_DoTest(const uint8_t *key)
+{
+    enum { kMaxBlocks = 20 };
+
+    BlockCipherEnc blockEnc;
+    uint8_t plainText[kMaxBlocks * BlockCipherEnc::kBlockLength];
+    uint8_t expectedCipherText[sizeof(plainText)];
+    uint8_t cipherText[sizeof(plainText)];
+
+    for (size_t i = 0; i < sizeof(plainText); i++)
+        plainText[i] = (uint8_t) (i * 13);
+
+    blockEnc.SetKey(key);
+
+    for (size_t i = 0; i < kMaxBlocks; i++)
+        blockEnc.EncryptBlock(plainText + i * BlockCipherEnc::kBlockLength, expectedCipherText + i * BlockCipherEnc::kBlockLength);
+
+    // Cover runs of blocks shorter than, equal to and longer than the number of blocks an implementation keeps in flight.
+    for (size_t numBlocks = 1; numBlocks <= kMaxBlocks; numBlocks++)
+    {
+        memset(cipherText, 0, sizeof(cipherText));
+        blockEnc.EncryptBlocks(plainText, cipherText, numBlocks);
+        if (memcmp(cipherText, expectedCipherText, numBlocks * BlockCipherEnc::kBlockLength) != 0)
+            return false;
+
+        memcpy(cipherText, plainText, sizeof(cipherText));
+        blockEnc.EncryptBlocks(cipherText, cipherText, numBlocks);
+        if (memcmp(cipherText, expectedCipherText, numBlocks * BlockCipherEnc::kBlockLength) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+static void Check_AES128BlockCipher_Test2(nlTestSuite *inSuite, void *inContext)
+{
+    static uint8_t key[]                = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+
+    // Invalid ciphertext generated by AES128BlockCipherEnc::EncryptBlocks()
+    NL_TEST_ASSERT(inSuite, BlockCipherEncryptBlocks_DoTest<AES128BlockCipherEnc>(key) == true);
+}
+
 static void Check_AES256BlockCipher_Test1(nlTestSuite *inSuite, void *inContext)
 {
     bool res;
@@ -402,16 +599,29 @@ static void Check_AES256BlockCipher_Test1(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, res == true);
 }
 
+static void Check_AES256BlockCipher_Test2(nlTestSuite *inSuite, void *inContext)
+{
+    static uint8_t key[]                = { 0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4 };
+
+    // Invalid ciphertext generated by AES256BlockCipherEnc::EncryptBlocks()
+    NL_TEST_ASSERT(inSuite, BlockCipherEncryptBlocks_DoTest<AES256BlockCipherEnc>(key) == true);
+}
+
 static const nlTest sTests[] = {
     NL_TEST_DEF("AES128CTRMode Test1",        Check_AES128CTRMode_Test1),
     NL_TEST_DEF("AES128CTRMode Test2",        Check_AES128CTRMode_Test2),
     NL_TEST_DEF("AES128CTRMode Test3",        Check_AES128CTRMode_Test3),
     NL_TEST_DEF("AES128CTRMode Test4",        Check_AES128CTRMode_Test4),
+    NL_TEST_DEF("AES128CTRMode Test5",        Check_AES128CTRMode_Test5),
     NL_TEST_DEF("AES256CTRMode Test1",        Check_AES256CTRMode_Test1),
     NL_TEST_DEF("AES256CTRMode Test2",        Check_AES256CTRMode_Test2),
     NL_TEST_DEF("AES256CTRMode Test3",        Check_AES256CTRMode_Test3),
+    NL_TEST_DEF("AES128GCMMode Test1",        Check_AES128GCMMode_Test1),
+    NL_TEST_DEF("AES128GCMMode Test2",        Check_AES128GCMMode_Test2),
     NL_TEST_DEF("AES128BlockCipher Test1",    Check_AES128BlockCipher_Test1),
+    NL_TEST_DEF("AES128BlockCipher Test2",    Check_AES128BlockCipher_Test2),
     NL_TEST_DEF("AES256BlockCipher Test1",    Check_AES256BlockCipher_Test1),
+    NL_TEST_DEF("AES256BlockCipher Test2",    Check_AES256BlockCipher_Test2),
     NL_TEST_SENTINEL()
 };
 
@@ -73,9 +73,47 @@ static void Check_HMACSHA1_Test2(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, memcmp(digest, ExpectedDigest, HMACSHA1::kDigestLength) == 0);
 }
 
+static void Check_HMACSHA1_Test3(nlTestSuite *inSuite, void *inContext)
+{
+    HMACSHA1 hmac;
+    HMACSHA1::PrecomputedKey precomputedKey;
+    uint8_t digest[HMACSHA1::kDigestLength];
+
+    // Key larger than the block size, from RFC 2202 test case 6.
+    uint8_t Key[80];
+    static uint8_t Data[] = "Test Using Larger Than Block-Size Key - Hash Key First";
+    static uint8_t ExpectedDigest[] = { 0xaa, 0x4a, 0xe5, 0xe1, 0x52, 0x72, 0xd0, 0x0e, 0x95, 0x70, 0x56, 0x37, 0xce, 0x8a, 0x3b, 0x55, 0xed, 0x40, 0x21, 0x12 };
+
+    memset(Key, 0xaa, sizeof(Key));
+
+    precomputedKey.Set(Key, sizeof(Key));
+
+    // The precomputed key must produce the same digest as the raw key, and remain usable for further messages.
+    for (int i = 0; i < 2; i++)
+    {
+        memset(digest, 0, sizeof(digest));
+
+        hmac.Begin(precomputedKey);
+        hmac.AddData(Data, 10);
+        hmac.AddData(Data + 10, sizeof(Data) - 1 - 10);
+        hmac.Finish(digest);
+
+        // Invalid digest returned by HMACSHA1::Finish() with a precomputed key
+        NL_TEST_ASSERT(inSuite, memcmp(digest, ExpectedDigest, HMACSHA1::kDigestLength) == 0);
+    }
+
+    // A raw key must still work after a precomputed one.
+    hmac.Begin(Key, sizeof(Key));
+    hmac.AddData(Data, sizeof(Data) - 1);
+    hmac.Finish(digest);
+
+    NL_TEST_ASSERT(inSuite, memcmp(digest, ExpectedDigest, HMACSHA1::kDigestLength) == 0);
+}
+
 static const nlTest sTests[] = {
     NL_TEST_DEF("HMACSHA1 Test1",          Check_HMACSHA1_Test1),
     NL_TEST_DEF("HMACSHA1 Test2",          Check_HMACSHA1_Test2),
+    NL_TEST_DEF("HMACSHA1 Test3",          Check_HMACSHA1_Test3),
     NL_TEST_SENTINEL()
 };
 
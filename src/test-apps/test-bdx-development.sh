@@ -18,80 +18,99 @@
 #    limitations under the License.
 #
 
-# Set this value to 1 if you configured weave-bdx-common.cpp to use curl for downloading
-# the requested URI when handling a ReceiveInit
-use_curl_to_download_requested_file=0
+# Uploads and downloads a file between the development BDX client and
+# server on the loopback interface, over TCP and UDP, in both the
+# stop-and-wait and the windowed modes.  The windowed UDP cases also
+# drop some of the client's incoming messages, so that the receiver has
+# to buffer blocks that arrive out of order and ask for the missing
+# ones, and the sender has to retransmit them.
 
-if [ -z ${srcdir}]; then
+if [ -z "${srcdir}" ]; then
     srcdir=`pwd`
 fi
-if [ -z ${builddir}]; then
+if [ -z "${builddir}" ]; then
     builddir="$srcdir"
 fi
 
-client_program="${builddir}/weave-bdx-client"
-server_program="${builddir}/weave-bdx-server"
+client_program="${builddir}/weave-bdx-client-development"
+server_program="${builddir}/weave-bdx-server-development"
+
+# The client and server both bind the Weave port, so they need addresses
+# of their own.
+server_addr="127.0.0.1"
+client_addr="127.0.0.2"
+
+# A small block size turns the test file into enough blocks to fill the
+# window several times over.
+block_size=32
 
 test_file_name="test-file-development.txt"
 test_file="${srcdir}/${test_file_name}"
-rcvd_dir="/tmp"
-sent_file="${rcvd_dir}/${test_file_name}"
-rcvd_file="${rcvd_dir}/${test_file_name}.2"
+work_dir="/tmp/test-bdx-development.$$"
+server_rcvd_dir="${work_dir}/server"
+server_temp_dir="${work_dir}/temp"
+client_rcvd_dir="${work_dir}/client"
 
-# Proactively remove the received files and set up the directory
-mkdir -p /tmp
-rm $sent_file 2> /dev/null
-rm $rcvd_file 2> /dev/null
+mkdir -p ${server_rcvd_dir} ${server_temp_dir} ${client_rcvd_dir}
 
 # Start up the server in the background, suppressing its output for readability
-server_cmd="${server_program} 127.0.0.1"
+server_cmd="${server_program} -a ${server_addr} -R ${server_rcvd_dir}/ -T ${server_temp_dir}/"
 echo $server_cmd
-${server_cmd} & >/dev/null
+${server_cmd} > /dev/null 2>&1 &
+server_pid=$!
 sleep 1 # give server a chance to start
 
-# send the file from the client
-client_send_cmd="${client_program} 1@127.0.0.1 -o ${test_file_name} --upload"
-echo $client_send_cmd
-${client_send_cmd} 
-echo "Client finished running"
-echo ""
-
-# check if the file was sent correctly from client
-diff $test_file $sent_file > /dev/null
-result=${?}
-if [ ${result} -eq 0 ]; then
-    echo "Client sent file successfully!"
-else
-    echo "Client failed file send, error code=${result}"
-    # kill server
-    kill -9 $!
-    exit ${result}
-fi
-echo ""
-sleep 1
-
-# If the test was successful, run the client in the other direction and verify
-if [ $use_curl_to_download_requested_file -eq 1 ]; then
-client_recv_cmd="${client_program} 1@127.0.0.1 -o file://${sent_file}"
-else
-client_recv_cmd="${client_program} 1@127.0.0.1 -o ${sent_file}"
-fi
+result=0
 
-echo $client_recv_cmd
-${client_recv_cmd} 
-echo "Client finished running"
-echo ""
-
-# check if the file was sent correctly from client
-diff $test_file $rcvd_file > /dev/null
-result=${?}
-if [ ${result} -eq 0 ]; then
-    echo "Client received file successfully!"
-else
-    echo "Client failed file receive, error code=${result}"
-fi
+# run_case <description> <received file> <client args...>
+run_case()
+{
+    description="$1"
+    rcvd_file="$2"
+    shift 2
+
+    rm -f ${rcvd_file}
+
+    client_cmd="${client_program} -a ${client_addr} -b ${block_size} $* 1@${server_addr}"
+    echo $client_cmd
+    ${client_cmd} > /dev/null 2>&1
+
+    # check if the file was transferred correctly
+    if cmp -s ${test_file} ${rcvd_file}; then
+        echo "${description}: passed"
+    else
+        echo "${description}: FAILED"
+        result=1
+    fi
+    echo ""
+}
+
+upload_file="${server_rcvd_dir}/${test_file_name}"
+download_file="${client_rcvd_dir}/${test_file_name}"
+download_args="-r file://${test_file} -R ${client_rcvd_dir}/"
+upload_args="-p -r ${test_file}"
+
+run_case "TCP upload" ${upload_file} -t ${upload_args}
+run_case "TCP download" ${download_file} -t ${download_args}
+run_case "UDP upload" ${upload_file} -u ${upload_args}
+run_case "UDP download" ${download_file} -u ${download_args}
+run_case "Windowed TCP upload" ${upload_file} -t -w ${upload_args}
+run_case "Windowed TCP download" ${download_file} -t -w ${download_args}
+run_case "Windowed UDP upload" ${upload_file} -u -w ${upload_args}
+run_case "Windowed UDP download" ${download_file} -u -w ${download_args}
+
+# Drop a block acknowledgement, so the sender has to retransmit
+run_case "Windowed UDP upload, lost acknowledgement" ${upload_file} \
+    -u -w --faults Weave_DropIncomingUDPMsg_f1_s5 ${upload_args}
+
+# Drop one and then two blocks in the middle of the window, so the blocks
+# after them arrive ahead of time and the missing ones have to be requested
+run_case "Windowed UDP download, lost block" ${download_file} \
+    -u -w --faults Weave_DropIncomingUDPMsg_f1_s5 ${download_args}
+run_case "Windowed UDP download, lost blocks" ${download_file} \
+    -u -w --faults Weave_DropIncomingUDPMsg_f2_s6 ${download_args}
 
 # kill server
-kill -9 $!
+kill -9 ${server_pid}
+rm -rf ${work_dir}
 exit ${result}
-
@@ -86,6 +86,7 @@ uint64_t FileLength = BDX_CLIENT_DEFAULT_FILE_LENGTH;
 uint64_t MaxBlockSize = BDX_CLIENT_DEFAULT_MAX_BLOCK_SIZE;
 bool Upload = false; // download by default
 bool UseTCP = true;
+bool Windowed = false;
 const char *DestIPAddrStr = NULL;
 const char *RequestedFileName = NULL;
 const char *ReceivedFileLocation = NULL;
@@ -112,6 +113,7 @@ static OptionDef gToolOptionDefs[] =
     { "upload",         kNoArgument,       'p' },
     { "tcp",            kNoArgument,       't' },
     { "udp",            kNoArgument,       'u' },
+    { "windowed",       kNoArgument,       'w' },
     { "pretest",        kNoArgument,       'T' },
     { NULL }
 };
@@ -147,6 +149,9 @@ static const char *gToolOptionHelp =
     "  -u, --udp\n"
     "       Use UDP to send BDX Requests.\n"
     "\n"
+    "  -w, --windowed\n"
+    "       Propose a windowed transfer that keeps several blocks in flight.\n"
+    "\n"
     "  -T, --pretest\n"
     "       Perform initial unit tests.\n"
     "\n"
@@ -465,6 +470,7 @@ void StartUDPUpload()
     xfer->mMaxBlockSize = MaxBlockSize;
     xfer->mStartOffset = StartOffset;
     xfer->mLength = FileLength;
+    xfer->mIsWindowed = Windowed;
 
     if (err == WEAVE_NO_ERROR)
     {
@@ -531,6 +537,7 @@ void StartUDPDownload()
     xfer->mMaxBlockSize = MaxBlockSize;
     xfer->mStartOffset = StartOffset;
     xfer->mLength = FileLength;
+    xfer->mIsWindowed = Windowed;
 
     err = BDXClient.InitBdxReceive(*xfer, true, false, false, NULL);
 
@@ -593,6 +600,9 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case 'u':
         UseTCP = false;
         break;
+    case 'w':
+        Windowed = true;
+        break;
     case 'D':
         DestIPAddrStr = arg;
         break;
@@ -722,6 +732,8 @@ void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
 
             if (err == WEAVE_NO_ERROR)
             {
+                xfer->mIsWindowed = Windowed;
+
                 // In the test-app, we need to make sure we only send the file name
                 // in the mFileDesignator.
                 WeaveLogDetail(BDX, "%s", refRequestedFileName.theString);
@@ -761,6 +773,7 @@ void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
 
             if (err == WEAVE_NO_ERROR)
             {
+                xfer->mIsWindowed = Windowed;
                 err = BDXClient.InitBdxReceive(*xfer, true, false, false, NULL);
             }
 #endif // WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT
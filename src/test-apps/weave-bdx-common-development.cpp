@@ -311,7 +311,11 @@ uint16_t BdxReceiveInitHandler(BDXTransfer *aXfer, ReceiveInit *aReceiveInit)
 {
     uint16_t err = kStatus_NoError;
     int retval = 0;
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    WEAVE_ERROR werr = WEAVE_NO_ERROR;
+#else
     long fileSize = 0;
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
     BdxAppState *mAppState;
     char *fileDesignator = NULL;
 #if !defined(HAVE_CURL_CURL_H) || !defined(HAVE_CURL_EASY_H)
@@ -368,6 +372,16 @@ uint16_t BdxReceiveInitHandler(BDXTransfer *aXfer, ReceiveInit *aReceiveInit)
 
     aXfer->mAppState = mAppState;
 
+#if WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
+    // Send the file straight out of a memory mapping shared with any other
+    // transfer of the same file, rather than reading it block by block
+    // through BdxGetBlockHandler.  This also sets the transfer's length.
+    werr = aXfer->SetFileSource(fileDesignator, aReceiveInit->mStartOffset, aReceiveInit->mLength);
+    VerifyOrExit(werr != WEAVE_ERROR_INVALID_ARGUMENT, err = kStatus_StartOffsetNotSupported);
+    VerifyOrExit(werr == WEAVE_NO_ERROR,
+                 err = kStatus_UnknownFile;
+                 WeaveLogError(BDX, "Error mapping file %s: %s", fileDesignator, ErrorStr(werr)));
+#else // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
     // The client already handles Setting transfer mode, max block size, and start sending
     // We just need to open the file and allocate a buffer for reading blocks
     targetFile = fopen(fileDesignator, "r");
@@ -400,6 +414,7 @@ uint16_t BdxReceiveInitHandler(BDXTransfer *aXfer, ReceiveInit *aReceiveInit)
     //TODO: shouldn't be using dynamic memory allocation, but how to do that with dynamically negotiated maxBlockSize???
     //perhaps just go ahead and allocate our maximum size since we know the transfer won't go above that?
     mAppState->mBuffer = (uint8_t *)malloc(aReceiveInit->mMaxBlockSize);
+#endif // WEAVE_CONFIG_BDX_FILE_SOURCE_SUPPORT
 
     // All seems good, so accept the transfer and set the handlers
     aXfer->mIsAccepted = true;